@@ -19,6 +19,7 @@
 #include "types/fieldmoduleid.h"
 #include "types/fieldsmoothingid.h"
 #include "types/nodeid.h"
+#include "types/nodesetid.h"
 
 #include "cmlibs/zinc/zincsharedobject.h"
 
@@ -211,6 +212,64 @@ ZINC_API cmzn_element_id cmzn_field_evaluate_mesh_location(cmzn_field_id field,
 ZINC_API int cmzn_field_evaluate_real(cmzn_field_id field, cmzn_fieldcache_id cache,
 	int number_of_values, double *values);
 
+/**
+ * Evaluate real field values at many locations in a single element, in one
+ * call. Equivalent to setting each mesh location in the cache and evaluating
+ * the field there, but without repeated call overheads, and with basis
+ * functions kept per point index so repeated batches over other elements
+ * with the same chart coordinates avoid recalculating them. Real finite
+ * element fields get the element parameters once and evaluate all locations
+ * directly into values. Constant, identity, component, concatenate, arithmetic
+ * (add, multiply, divide, power, scale, offset, clamp, log, sqrt, exp, abs),
+ * coordinate transformation, magnitude and dot product fields evaluate their
+ * source fields for all locations and combine them; other fields are
+ * evaluated at each location in turn.
+ * On return the cache is set to the last location evaluated.
+ *
+ * @param field  The field to evaluate.
+ * @param cache  Store of time and intermediate field values. Location in it
+ * is overwritten.
+ * @param element  The element to evaluate in. Must be from the same region as
+ * field.
+ * @param number_of_points  The number of locations to evaluate at, >= 0.
+ * @param number_of_chart_coordinates  Size of chart_coordinates array. Checked
+ * that it equals or exceeds number_of_points * element dimension.
+ * @param chart_coordinates  Array of element local 'xi' coordinates for
+ * each location in turn, each with element dimension values.
+ * @param number_of_values  Size of values array. Checked that it equals or
+ * exceeds number_of_points * number of components of field.
+ * @param values  Array of real values to evaluate into, with all components
+ * for each location in turn.
+ * @return  Status CMZN_OK on success, any other value on failure including if
+ * field is not defined at any of the locations.
+ */
+ZINC_API int cmzn_field_evaluate_real_mesh_locations(cmzn_field_id field,
+	cmzn_fieldcache_id cache, cmzn_element_id element, int number_of_points,
+	int number_of_chart_coordinates, const double *chart_coordinates,
+	int number_of_values, double *values);
+
+/**
+ * Evaluate real field values at all nodes in a nodeset or nodeset group, in
+ * one call. Nodes are evaluated in order of increasing identifier, the same
+ * order as for a node iterator.
+ * On return the cache is set to the last node evaluated.
+ *
+ * @param field  The field to evaluate.
+ * @param cache  Store of time and intermediate field values. Location in it
+ * is overwritten.
+ * @param nodeset  The nodeset or nodeset group to evaluate at all nodes of.
+ * Must be from the same region as field.
+ * @param number_of_values  Size of values array. Checked that it equals or
+ * exceeds size of nodeset * number of components of field.
+ * @param values  Array of real values to evaluate into, with all components
+ * for each node in turn.
+ * @return  Status CMZN_OK on success, any other value on failure including if
+ * field is not defined at any of the nodes.
+ */
+ZINC_API int cmzn_field_evaluate_real_nodeset(cmzn_field_id field,
+	cmzn_fieldcache_id cache, cmzn_nodeset_id nodeset,
+	int number_of_values, double *values);
+
 /**
  * Evaluate field as string at location specified in cache. Numerical valued
  * fields are written to a string with comma separated components.
@@ -49,6 +49,7 @@ class Fieldparameters;
 class Fieldmodule;
 class Fieldrange;
 class Fieldsmoothing;
+class Nodeset;
 
 class Field
 {
@@ -292,6 +293,13 @@ public:
 
 	inline int evaluateReal(const Fieldcache& cache, int valuesCount, double *valuesOut) const;
 
+	inline int evaluateRealMeshLocations(const Fieldcache& cache, const Element& element,
+		int pointsCount, int coordinatesCount, const double *coordinatesIn,
+		int valuesCount, double *valuesOut) const;
+
+	inline int evaluateRealNodeset(const Fieldcache& cache, const Nodeset& nodeset,
+		int valuesCount, double *valuesOut) const;
+
 	inline char *evaluateString(const Fieldcache& cache) const;
 
 	inline int evaluateDerivative(const Differentialoperator& differentialOperator,
@@ -143,6 +143,21 @@ inline int Field::evaluateReal(const Fieldcache& cache, int valuesCount, double
 	return cmzn_field_evaluate_real(id, cache.getId(), valuesCount, valuesOut);
 }
 
+inline int Field::evaluateRealMeshLocations(const Fieldcache& cache, const Element& element,
+	int pointsCount, int coordinatesCount, const double *coordinatesIn,
+	int valuesCount, double *valuesOut) const
+{
+	return cmzn_field_evaluate_real_mesh_locations(id, cache.getId(), element.getId(),
+		pointsCount, coordinatesCount, coordinatesIn, valuesCount, valuesOut);
+}
+
+inline int Field::evaluateRealNodeset(const Fieldcache& cache, const Nodeset& nodeset,
+	int valuesCount, double *valuesOut) const
+{
+	return cmzn_field_evaluate_real_nodeset(id, cache.getId(), nodeset.getId(),
+		valuesCount, valuesOut);
+}
+
 inline char *Field::evaluateString(const Fieldcache& cache) const
 {
 	return cmzn_field_evaluate_string(id, cache.getId());
@@ -148,6 +148,64 @@ ZINC_API int cmzn_field_finite_element_set_node_parameters(
 ZINC_API bool cmzn_field_finite_element_has_parameters_at_location(
 	cmzn_field_finite_element_id finite_element_field, cmzn_fieldcache_id cache);
 
+/**
+ * Get the maximum number of element evaluations of the finite element field
+ * cached per mesh and time in the field cache.
+ * @see cmzn_field_finite_element_set_element_evaluation_cache_capacity
+ *
+ * @param finite_element_field  The finite element field, with real components.
+ * @param cache  The field cache to query.
+ * @return  The capacity, or 0 if invalid arguments.
+ */
+ZINC_API int cmzn_field_finite_element_get_element_evaluation_cache_capacity(
+	cmzn_field_finite_element_id finite_element_field, cmzn_fieldcache_id cache);
+
+/**
+ * Set the maximum number of element evaluations of the finite element field
+ * cached per mesh and time in the field cache. An element evaluation holds
+ * the element parameters and basis for evaluating the field in an element.
+ * When the cache is full, the least recently used element evaluation is
+ * discarded. The setting is shared with field caches made internally from
+ * this cache, e.g. for evaluating integrals. Default capacity is 1000.
+ *
+ * @param finite_element_field  The finite element field, with real components.
+ * @param cache  The field cache to set capacity in.
+ * @param capacity  The maximum number of cached element evaluations, > 0.
+ * @return  Result OK on success, otherwise ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_field_finite_element_set_element_evaluation_cache_capacity(
+	cmzn_field_finite_element_id finite_element_field, cmzn_fieldcache_id cache,
+	int capacity);
+
+/**
+ * Get usage statistics for the element evaluation cache of the finite element
+ * field in the field cache, accumulated since it was created or statistics
+ * were last reset. A hit is counted each time an existing element evaluation
+ * is reused, and a miss each time one is calculated.
+ * @see cmzn_field_finite_element_set_element_evaluation_cache_capacity
+ *
+ * @param finite_element_field  The finite element field, with real components.
+ * @param cache  The field cache to query.
+ * @param hit_count_out  Address to return number of hits in.
+ * @param miss_count_out  Address to return number of misses in.
+ * @return  Result OK on success, otherwise ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_field_finite_element_get_element_evaluation_cache_statistics(
+	cmzn_field_finite_element_id finite_element_field, cmzn_fieldcache_id cache,
+	int *hit_count_out, int *miss_count_out);
+
+/**
+ * Reset hit and miss counts for the element evaluation cache of the finite
+ * element field in the field cache to zero.
+ * @see cmzn_field_finite_element_get_element_evaluation_cache_statistics
+ *
+ * @param finite_element_field  The finite element field, with real components.
+ * @param cache  The field cache to reset statistics in.
+ * @return  Result OK on success, otherwise ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_field_finite_element_reset_element_evaluation_cache_statistics(
+	cmzn_field_finite_element_id finite_element_field, cmzn_fieldcache_id cache);
+
 /**
  * Creates a field producing a value on 1-D line elements with as many
  * components as the source field, which gives the discontinuity of that field
@@ -58,6 +58,27 @@ public:
 	{
 		return cmzn_field_finite_element_has_parameters_at_location(this->getDerivedId(), cache.getId());
 	}
+
+	int getElementEvaluationCacheCapacity(const Fieldcache& cache) const
+	{
+		return cmzn_field_finite_element_get_element_evaluation_cache_capacity(this->getDerivedId(), cache.getId());
+	}
+
+	int setElementEvaluationCacheCapacity(const Fieldcache& cache, int capacity)
+	{
+		return cmzn_field_finite_element_set_element_evaluation_cache_capacity(this->getDerivedId(), cache.getId(), capacity);
+	}
+
+	int getElementEvaluationCacheStatistics(const Fieldcache& cache, int *hitCountOut, int *missCountOut) const
+	{
+		return cmzn_field_finite_element_get_element_evaluation_cache_statistics(this->getDerivedId(),
+			cache.getId(), hitCountOut, missCountOut);
+	}
+
+	int resetElementEvaluationCacheStatistics(const Fieldcache& cache)
+	{
+		return cmzn_field_finite_element_reset_element_evaluation_cache_statistics(this->getDerivedId(), cache.getId());
+	}
 };
 
 class FieldEdgeDiscontinuity : public Field
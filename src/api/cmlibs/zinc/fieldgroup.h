@@ -209,6 +209,40 @@ ZINC_API enum cmzn_field_group_subelement_handling_mode
 ZINC_API int cmzn_field_group_set_subelement_handling_mode(cmzn_field_group_id group,
 	enum cmzn_field_group_subelement_handling_mode mode);
 
+/**
+ * Get the number of threads conditional fields are evaluated with when
+ * adding, removing or retaining elements or nodes conditionally in this
+ * group's mesh and nodeset groups.
+ * @see cmzn_field_group_set_conditional_threads_count
+ *
+ * @param group  Handle to group field to query.
+ * @return  Number of threads >= 1, 0 if using all hardware threads, or -1 if
+ * invalid group.
+ */
+ZINC_API int cmzn_field_group_get_conditional_threads_count(cmzn_field_group_id group);
+
+/**
+ * Set the number of threads to evaluate conditional fields with when adding,
+ * removing or retaining elements or nodes conditionally in this group's mesh
+ * and nodeset groups. Conditional fields which are groups are always combined
+ * directly without evaluation. Otherwise the conditional is evaluated over
+ * chunks of elements or nodes, collecting those matching into a temporary
+ * group which is merged into this group once, with subelements added or
+ * removed once for all. With more than 1 thread, chunks are shared between
+ * threads each with their own working field cache. Only use multiple threads
+ * if every field the conditional depends on is safe to evaluate concurrently,
+ * and nothing in the region is modified during the operation.
+ * This is a runtime setting and is not inherited by subregion groups.
+ * Default is 1 i.e. serial evaluation.
+ *
+ * @param group  Handle to group field to modify.
+ * @param threads_count  Number of threads >= 1, or 0 to use all hardware
+ * threads.
+ * @return  Result OK on success, otherwise ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_field_group_set_conditional_threads_count(cmzn_field_group_id group,
+	int threads_count);
+
 /**
  * Create a group field for the specified subregion, include it in the
  * specified group and return a handle to the newly created sub-group field.
@@ -115,6 +115,16 @@ public:
 			static_cast<cmzn_field_group_subelement_handling_mode>(mode));
 	}
 
+	int getConditionalThreadsCount() const
+	{
+		return cmzn_field_group_get_conditional_threads_count(getDerivedId());
+	}
+
+	int setConditionalThreadsCount(int threadsCount)
+	{
+		return cmzn_field_group_set_conditional_threads_count(getDerivedId(), threadsCount);
+	}
+
 	FieldGroup createSubregionFieldGroup(const Region& region)
 	{
 		return FieldGroup(cmzn_field_group_create_subregion_field_group(
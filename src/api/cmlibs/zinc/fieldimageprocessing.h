@@ -629,6 +629,61 @@ ZINC_C_INLINE cmzn_field_id cmzn_field_imagefilter_histogram_base_cast(
 ZINC_API int cmzn_field_imagefilter_histogram_destroy(
 		cmzn_field_imagefilter_histogram_id *imagefilter_histogram_address);
 
+/**
+ * Get the size of square tiles the output of an image filter field is
+ * computed in.
+ *
+ * @param field  Handle to any image filter field.
+ * @return  The tile size in pixels, or 0 if the whole image is computed at
+ * once or field is not an image filter.
+ */
+ZINC_API int cmzn_field_imagefilter_get_tile_size(cmzn_field_id field);
+
+/**
+ * Set the size of square tiles the output of an image filter field is
+ * computed in. When evaluated, only the tile containing the location is
+ * computed, from input covering the tile plus the filter's margin, so
+ * memory use scales with the tile size rather than the image size and only
+ * tiles which are evaluated are computed. Output values equal those from
+ * filtering the whole image. Only supported by filters whose output at each
+ * pixel depends on a bounded neighbourhood: binary dilate, binary erode,
+ * binary threshold, discrete gaussian, mean, sigmoid and threshold. Tiled
+ * filters are evaluated from their source fields at each pixel of the tile
+ * input rather than from a whole source image.
+ *
+ * @param field  Handle to an image filter field.
+ * @param tileSize  The tile size in pixels, or 0 to compute the whole image
+ * at once (the default).
+ * @return  Status CMZN_OK on success, CMZN_ERROR_ARGUMENT if invalid size,
+ * not an image filter field or the filter's output cannot be computed in
+ * tiles.
+ */
+ZINC_API int cmzn_field_imagefilter_set_tile_size(cmzn_field_id field,
+	int tileSize);
+
+/**
+ * Get the limit on memory used to cache computed output tiles of an image
+ * filter field.
+ *
+ * @param field  Handle to any image filter field.
+ * @return  The memory limit in megabytes, or 0 if not an image filter field.
+ */
+ZINC_API int cmzn_field_imagefilter_get_tile_cache_memory_limit(
+	cmzn_field_id field);
+
+/**
+ * Set the limit on memory used to cache computed output tiles of an image
+ * filter field. When exceeded, the least recently used tiles are discarded
+ * and computed again if needed; the last tile evaluated is always kept.
+ * Default is 256 megabytes.
+ *
+ * @param field  Handle to an image filter field.
+ * @param megabytes  The memory limit in megabytes, non-negative.
+ * @return  Status CMZN_OK on success, otherwise CMZN_ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_field_imagefilter_set_tile_cache_memory_limit(
+	cmzn_field_id field, int megabytes);
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,11 +18,47 @@ namespace CMLibs
 namespace Zinc
 {
 
-class FieldImagefilterBinaryDilate : public Field
+/**
+ * Base class of image filter fields, for settings common to all filters.
+ */
+class FieldImagefilter : public Field
+{
+protected:
+	explicit FieldImagefilter(cmzn_field_id field_id) : Field(field_id)
+	{	}
+
+public:
+
+	FieldImagefilter() : Field(0)
+	{	}
+
+	int getTileSize() const
+	{
+		return cmzn_field_imagefilter_get_tile_size(id);
+	}
+
+	int setTileSize(int tileSize)
+	{
+		return cmzn_field_imagefilter_set_tile_size(id, tileSize);
+	}
+
+	int getTileCacheMemoryLimit() const
+	{
+		return cmzn_field_imagefilter_get_tile_cache_memory_limit(id);
+	}
+
+	int setTileCacheMemoryLimit(int megabytes)
+	{
+		return cmzn_field_imagefilter_set_tile_cache_memory_limit(id, megabytes);
+	}
+
+};
+
+class FieldImagefilterBinaryDilate : public FieldImagefilter
 {
 
 private:
-	explicit FieldImagefilterBinaryDilate(cmzn_field_id field_id) : Field(field_id)
+	explicit FieldImagefilterBinaryDilate(cmzn_field_id field_id) : FieldImagefilter(field_id)
 	{	}
 
 	friend FieldImagefilterBinaryDilate
@@ -31,16 +67,16 @@ private:
 
 public:
 
-	FieldImagefilterBinaryDilate() : Field(0)
+	FieldImagefilterBinaryDilate() : FieldImagefilter(0)
 	{	}
 
 };
 
-class FieldImagefilterBinaryErode : public Field
+class FieldImagefilterBinaryErode : public FieldImagefilter
 {
 
 private:
-	explicit FieldImagefilterBinaryErode(cmzn_field_id field_id) : Field(field_id)
+	explicit FieldImagefilterBinaryErode(cmzn_field_id field_id) : FieldImagefilter(field_id)
 	{	}
 
 	friend FieldImagefilterBinaryErode
@@ -49,21 +85,21 @@ private:
 
 public:
 
-	FieldImagefilterBinaryErode() : Field(0)
+	FieldImagefilterBinaryErode() : FieldImagefilter(0)
 	{	}
 
 };
 
-class FieldImagefilterBinaryThreshold : public Field
+class FieldImagefilterBinaryThreshold : public FieldImagefilter
 {
 public:
 
-	FieldImagefilterBinaryThreshold() : Field(0)
+	FieldImagefilterBinaryThreshold() : FieldImagefilter(0)
 	{	}
 
 	// takes ownership of C handle, responsibility for destroying it
 	explicit FieldImagefilterBinaryThreshold(cmzn_field_imagefilter_binary_threshold_id field_imagefilter_binary_threshold_id) :
-		Field(reinterpret_cast<cmzn_field_id>(field_imagefilter_binary_threshold_id))
+		FieldImagefilter(reinterpret_cast<cmzn_field_id>(field_imagefilter_binary_threshold_id))
 	{	}
 
 	double getLowerThreshold() const
@@ -94,11 +130,11 @@ public:
 
 };
 
-class FieldImagefilterCannyEdgeDetection : public Field
+class FieldImagefilterCannyEdgeDetection : public FieldImagefilter
 {
 
 private:
-	explicit FieldImagefilterCannyEdgeDetection(cmzn_field_id field_id) : Field(field_id)
+	explicit FieldImagefilterCannyEdgeDetection(cmzn_field_id field_id) : FieldImagefilter(field_id)
 	{	}
 
 	friend FieldImagefilterCannyEdgeDetection
@@ -107,17 +143,17 @@ private:
 
 public:
 
-	FieldImagefilterCannyEdgeDetection() : Field(0)
+	FieldImagefilterCannyEdgeDetection() : FieldImagefilter(0)
 	{	}
 
 };
 
-class FieldImagefilterConnectedThreshold : public Field
+class FieldImagefilterConnectedThreshold : public FieldImagefilter
 {
 
 private:
 	// takes ownership of C handle, responsibility for destroying it
-	explicit FieldImagefilterConnectedThreshold(cmzn_field_id field_id) : Field(field_id)
+	explicit FieldImagefilterConnectedThreshold(cmzn_field_id field_id) : FieldImagefilter(field_id)
 	{	}
 
 	friend FieldImagefilterConnectedThreshold
@@ -127,17 +163,17 @@ private:
 
 public:
 
-	FieldImagefilterConnectedThreshold() : Field(0)
+	FieldImagefilterConnectedThreshold() : FieldImagefilter(0)
 	{	}
 
 };
 
-class FieldImagefilterCurvatureAnisotropicDiffusion : public Field
+class FieldImagefilterCurvatureAnisotropicDiffusion : public FieldImagefilter
 {
 
 private:
 	// takes ownership of C handle, responsibility for destroying it
-	explicit FieldImagefilterCurvatureAnisotropicDiffusion(cmzn_field_id field_id) : Field(field_id)
+	explicit FieldImagefilterCurvatureAnisotropicDiffusion(cmzn_field_id field_id) : FieldImagefilter(field_id)
 	{	}
 
 	friend FieldImagefilterCurvatureAnisotropicDiffusion
@@ -146,21 +182,21 @@ private:
 
 public:
 
-	FieldImagefilterCurvatureAnisotropicDiffusion() : Field(0)
+	FieldImagefilterCurvatureAnisotropicDiffusion() : FieldImagefilter(0)
 	{	}
 
 };
 
-class FieldImagefilterDiscreteGaussian : public Field
+class FieldImagefilterDiscreteGaussian : public FieldImagefilter
 {
 public:
 
-	FieldImagefilterDiscreteGaussian() : Field(0)
+	FieldImagefilterDiscreteGaussian() : FieldImagefilter(0)
 	{	}
 
 	// takes ownership of C handle, responsibility for destroying it
 	explicit FieldImagefilterDiscreteGaussian(cmzn_field_imagefilter_discrete_gaussian_id field_imagefilter_discrete_gaussian_id) :
-		Field(reinterpret_cast<cmzn_field_id>(field_imagefilter_discrete_gaussian_id))
+		FieldImagefilter(reinterpret_cast<cmzn_field_id>(field_imagefilter_discrete_gaussian_id))
 	{	}
 
 	double getVariance() const
@@ -191,16 +227,16 @@ public:
 
 };
 
-class FieldImagefilterHistogram : public Field
+class FieldImagefilterHistogram : public FieldImagefilter
 {
 public:
 
-	FieldImagefilterHistogram() : Field(0)
+	FieldImagefilterHistogram() : FieldImagefilter(0)
 	{	}
 
 	// takes ownership of C handle, responsibility for destroying it
 	explicit FieldImagefilterHistogram(cmzn_field_imagefilter_histogram_id field_imagefilter_histogram_id) :
-		Field(reinterpret_cast<cmzn_field_id>(field_imagefilter_histogram_id))
+		FieldImagefilter(reinterpret_cast<cmzn_field_id>(field_imagefilter_histogram_id))
 	{	}
 
 	int getComputeMinimumValues(int valuesCount, double *valuesOut) const
@@ -260,12 +296,12 @@ public:
 
 };
 
-class FieldImagefilterGradientMagnitudeRecursiveGaussian : public Field
+class FieldImagefilterGradientMagnitudeRecursiveGaussian : public FieldImagefilter
 {
 
 private:
 	// takes ownership of C handle, responsibility for destroying it
-	explicit FieldImagefilterGradientMagnitudeRecursiveGaussian(cmzn_field_id field_id) : Field(field_id)
+	explicit FieldImagefilterGradientMagnitudeRecursiveGaussian(cmzn_field_id field_id) : FieldImagefilter(field_id)
 	{	}
 
 	friend FieldImagefilterGradientMagnitudeRecursiveGaussian
@@ -274,17 +310,17 @@ private:
 
 public:
 
-	FieldImagefilterGradientMagnitudeRecursiveGaussian() : Field(0)
+	FieldImagefilterGradientMagnitudeRecursiveGaussian() : FieldImagefilter(0)
 	{	}
 
 };
 
-class FieldImagefilterRescaleIntensity : public Field
+class FieldImagefilterRescaleIntensity : public FieldImagefilter
 {
 
 private:
 	// takes ownership of C handle, responsibility for destroying it
-	explicit FieldImagefilterRescaleIntensity(cmzn_field_id field_id) : Field(field_id)
+	explicit FieldImagefilterRescaleIntensity(cmzn_field_id field_id) : FieldImagefilter(field_id)
 	{	}
 
 	friend FieldImagefilterRescaleIntensity
@@ -293,18 +329,18 @@ private:
 
 public:
 
-	FieldImagefilterRescaleIntensity() : Field(0)
+	FieldImagefilterRescaleIntensity() : FieldImagefilter(0)
 	{	}
 
 };
 
 
-class FieldImagefilterMean : public Field
+class FieldImagefilterMean : public FieldImagefilter
 {
 
 private:
 	// takes ownership of C handle, responsibility for destroying it
-	explicit FieldImagefilterMean(cmzn_field_id field_id) : Field(field_id)
+	explicit FieldImagefilterMean(cmzn_field_id field_id) : FieldImagefilter(field_id)
 	{	}
 
 	friend FieldImagefilterMean
@@ -313,17 +349,17 @@ private:
 
 public:
 
-	FieldImagefilterMean() : Field(0)
+	FieldImagefilterMean() : FieldImagefilter(0)
 	{	}
 
 };
 
-class FieldImagefilterSigmoid : public Field
+class FieldImagefilterSigmoid : public FieldImagefilter
 {
 
 private:
 	// takes ownership of C handle, responsibility for destroying it
-	explicit FieldImagefilterSigmoid(cmzn_field_id field_id) : Field(field_id)
+	explicit FieldImagefilterSigmoid(cmzn_field_id field_id) : FieldImagefilter(field_id)
 	{	}
 
 	friend FieldImagefilterSigmoid
@@ -332,22 +368,22 @@ private:
 
 public:
 
-	FieldImagefilterSigmoid() : Field(0)
+	FieldImagefilterSigmoid() : FieldImagefilter(0)
 	{	}
 
 };
 
 
-class FieldImagefilterThreshold : public Field
+class FieldImagefilterThreshold : public FieldImagefilter
 {
 public:
 
-	FieldImagefilterThreshold() : Field(0)
+	FieldImagefilterThreshold() : FieldImagefilter(0)
 	{	}
 
 	// takes ownership of C handle, responsibility for destroying it
 	explicit FieldImagefilterThreshold(cmzn_field_imagefilter_threshold_id field_imagefilter_threshold_id) :
-		Field(reinterpret_cast<cmzn_field_id>(field_imagefilter_threshold_id))
+		FieldImagefilter(reinterpret_cast<cmzn_field_id>(field_imagefilter_threshold_id))
 	{	}
 
 	enum Condition
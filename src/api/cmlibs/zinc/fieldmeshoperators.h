@@ -184,6 +184,37 @@ ZINC_API int cmzn_field_mesh_integral_set_element_quadrature_rule(
 	cmzn_field_mesh_integral_id mesh_integral_field,
 	enum cmzn_element_quadrature_rule quadrature_rule);
 
+/**
+ * Get the number of threads the mesh integral is evaluated with.
+ * @see cmzn_field_mesh_integral_set_threads_count
+ *
+ * @param mesh_integral_field  Handle to mesh integral field to query.
+ * @return  Number of threads >= 1, 0 if using all hardware threads, or -1 if
+ * invalid field.
+ */
+ZINC_API int cmzn_field_mesh_integral_get_threads_count(
+	cmzn_field_mesh_integral_id mesh_integral_field);
+
+/**
+ * Set the number of threads to evaluate the mesh integral with. With more
+ * than 1 thread, the integral over the whole mesh is evaluated in chunks of
+ * elements, and its derivatives in an element in chunks of quadrature points,
+ * shared between threads each with their own working field cache. Chunk sums
+ * are added in a fixed order so results are the same for any number of
+ * threads above 1, but may differ from serial evaluation by round-off.
+ * Integrands depending on argument fields are always evaluated serially.
+ * The mesh and fields must not be modified during evaluation.
+ * This is a runtime setting and is not part of the field definition.
+ * Default is 1 i.e. serial evaluation.
+ *
+ * @param mesh_integral_field  Handle to mesh integral field to modify.
+ * @param threads_count  Number of threads >= 1, or 0 to use all hardware
+ * threads.
+ * @return  Result OK on success, otherwise ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_field_mesh_integral_set_threads_count(
+	cmzn_field_mesh_integral_id mesh_integral_field, int threads_count);
+
 /**
  * Creates a specialisation of the mesh integral field that integrates the
  * squares of the components of the integrand field. Note that the 
@@ -69,6 +69,16 @@ public:
 		return cmzn_field_mesh_integral_set_element_quadrature_rule(getDerivedId(),
 			static_cast<cmzn_element_quadrature_rule>(quadratureRule));
 	}
+
+	int getThreadsCount() const
+	{
+		return cmzn_field_mesh_integral_get_threads_count(getDerivedId());
+	}
+
+	int setThreadsCount(int threadsCount)
+	{
+		return cmzn_field_mesh_integral_set_threads_count(getDerivedId(), threadsCount);
+	}
 };
 
 /**
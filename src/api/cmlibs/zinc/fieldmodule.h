@@ -86,6 +86,9 @@ ZINC_API cmzn_field_id cmzn_fieldmodule_find_field_by_name(
 /**
  * Creates a field cache for storing a known location and field values and
  * derivatives at that location. Required to evaluate and assign field values.
+ * A field cache must only be used by one thread at a time; threads evaluating
+ * a frozen region concurrently must each create their own field cache.
+ * @see cmzn_region_set_frozen
  *
  * @param fieldmodule  The field module to create a field cache for.
  * @return  Handle to new field cache, or NULL/invalid handle on failure.
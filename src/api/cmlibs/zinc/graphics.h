@@ -708,6 +708,32 @@ ZINC_API int cmzn_graphics_contours_set_range_isovalues(
 	cmzn_graphics_contours_id contours, int number_of_isovalues,
 	double first_isovalue, double last_isovalue);
 
+/**
+ * Query whether iso-surface vertices are welded across elements.
+ * @see cmzn_graphics_contours_set_weld_vertices
+ *
+ * @param contours  The contours graphics to query.
+ * @return  True if vertices are welded, otherwise false.
+ */
+ZINC_API bool cmzn_graphics_contours_is_weld_vertices(
+	cmzn_graphics_contours_id contours);
+
+/**
+ * Set whether to weld vertices of iso-surfaces in 3-D elements lying within
+ * a tolerance of 2.0E-6 times the extent of the iso-surfaces to a vertex in
+ * another element, closing cracks where iso-surfaces cross element boundaries.
+ * Welded vertices share smooth normals averaged over all triangles around
+ * them, so shading also differs from unwelded iso-surfaces. Welding is
+ * repeated over all elements after every build including partial rebuilds, so
+ * adds to the cost of rebuilding large contours. Off by default.
+ *
+ * @param contours  The contours graphics to modify.
+ * @param weld_vertices  True to weld vertices, false to not weld.
+ * @return  Status CMZN_OK on success, otherwise CMZN_ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_graphics_contours_set_weld_vertices(
+	cmzn_graphics_contours_id contours, bool weld_vertices);
+
 /**
  * If the graphics is of type lines then this function returns
  * the derived lines graphics handle.
@@ -1329,6 +1355,34 @@ ZINC_API int cmzn_graphicspointattributes_set_glyph_repeat_mode(
 	cmzn_graphicspointattributes_id point_attributes,
 	enum cmzn_glyph_repeat_mode glyph_repeat_mode);
 
+/**
+ * Query whether glyphs are drawn instanced.
+ * @see cmzn_graphicspointattributes_set_render_instanced
+ *
+ * @param point_attributes  The point attributes to query.
+ * @return  True if glyphs are drawn instanced, otherwise false.
+ */
+ZINC_API bool cmzn_graphicspointattributes_is_render_instanced(
+	cmzn_graphicspointattributes_id point_attributes);
+
+/**
+ * Set whether to draw all glyphs with one instanced draw call per glyph
+ * surface, using a vertex shader to transform and light each glyph. This is
+ * much faster for large numbers of glyphs but requires OpenGL 3.3, and is only
+ * used for glyphs made of surfaces without their own materials or labels, and
+ * with materials without shader programs or textures; otherwise glyphs are
+ * drawn individually. Results may differ slightly from individual drawing as
+ * lighting is evaluated by the shader. Picking and selection highlighting
+ * always draw glyphs individually. Off by default.
+ *
+ * @param point_attributes  The point attributes to modify.
+ * @param render_instanced  True to draw glyphs instanced, false to draw
+ * each glyph individually.
+ * @return  Status CMZN_OK on success, otherwise CMZN_ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_graphicspointattributes_set_render_instanced(
+	cmzn_graphicspointattributes_id point_attributes, bool render_instanced);
+
 /**
  * Gets the enumerated value identifying the current glyph used in the point
  * attributes.
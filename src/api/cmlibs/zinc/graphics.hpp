@@ -448,6 +448,16 @@ public:
 			numberOfValues, firstIsovalue, lastIsovalue);
 	}
 
+	bool isWeldVertices() const
+	{
+		return cmzn_graphics_contours_is_weld_vertices(this->getDerivedId());
+	}
+
+	int setWeldVertices(bool weldVertices)
+	{
+		return cmzn_graphics_contours_set_weld_vertices(this->getDerivedId(), weldVertices);
+	}
+
 };
 
 class GraphicsLines : public Graphics
@@ -809,6 +819,16 @@ public:
 			static_cast<cmzn_glyph_repeat_mode>(glyphRepeatMode));
 	}
 
+	bool isRenderInstanced() const
+	{
+		return cmzn_graphicspointattributes_is_render_instanced(id);
+	}
+
+	int setRenderInstanced(bool renderInstanced)
+	{
+		return cmzn_graphicspointattributes_set_render_instanced(id, renderInstanced);
+	}
+
 	Glyph::ShapeType getGlyphShapeType() const
 	{
 		return static_cast<Glyph::ShapeType>(cmzn_graphicspointattributes_get_glyph_shape_type(id));
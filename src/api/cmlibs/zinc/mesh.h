@@ -391,6 +391,21 @@ ZINC_API int cmzn_mesh_group_remove_element(cmzn_mesh_group_id mesh_group,
 ZINC_API int cmzn_mesh_group_remove_elements_conditional(cmzn_mesh_group_id mesh_group,
 	cmzn_field_id conditional_field);
 
+/**
+ * Remove all elements from the mesh group for which the conditional field is
+ * false i.e. zero valued in the element, leaving the intersection of the mesh
+ * group with the elements where it is true.
+ * Results are undefined if conditional field is not constant over element.
+ * Group and element_group conditional fields are intersected efficiently.
+ *
+ * @param mesh_group  Handle to the mesh group to remove elements from.
+ * @param conditional_field  Field which if zero in the element indicates it
+ * is to be removed.
+ * @return  Status CMZN_OK on success, any other value on failure.
+ */
+ZINC_API int cmzn_mesh_group_retain_elements_conditional(cmzn_mesh_group_id mesh_group,
+	cmzn_field_id conditional_field);
+
 /**
  * Returns a new handle to the mesh changes with reference count incremented.
  *
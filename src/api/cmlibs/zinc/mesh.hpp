@@ -217,6 +217,12 @@ public:
 			conditionalField.getId());
 	}
 
+	int retainElementsConditional(const Field& conditionalField)
+	{
+		return cmzn_mesh_group_retain_elements_conditional(this->getDerivedId(),
+			conditionalField.getId());
+	}
+
 };
 
 inline MeshGroup Mesh::castGroup()
@@ -318,6 +318,20 @@ ZINC_API int cmzn_nodeset_group_remove_node(cmzn_nodeset_group_id nodeset_group,
 ZINC_API int cmzn_nodeset_group_remove_nodes_conditional(
 	cmzn_nodeset_group_id nodeset_group, cmzn_field_id conditional_field);
 
+/**
+ * Remove all nodes from the nodeset group for which the conditional field is
+ * false i.e. zero valued in the node, leaving the intersection of the nodeset
+ * group with the nodes where it is true.
+ * Group and node_group conditional fields are intersected efficiently.
+ *
+ * @param nodeset_group  Handle to the nodeset group to remove nodes from.
+ * @param conditional_field  Field which if zero in the node indicates it
+ * is to be removed.
+ * @return  Status CMZN_OK on success, any other value on failure.
+ */
+ZINC_API int cmzn_nodeset_group_retain_nodes_conditional(
+	cmzn_nodeset_group_id nodeset_group, cmzn_field_id conditional_field);
+
 /**
  * Returns a new handle to the nodeset changes with reference count incremented.
  *
@@ -191,6 +191,12 @@ public:
 			this->getDerivedId(), conditionalField.getId());
 	}
 
+	int retainNodesConditional(const Field& conditionalField)
+	{
+		return cmzn_nodeset_group_retain_nodes_conditional(
+			this->getDerivedId(), conditionalField.getId());
+	}
+
 };
 
 inline NodesetGroup Nodeset::castGroup()
@@ -106,6 +106,34 @@ ZINC_API int cmzn_region_begin_hierarchical_change(cmzn_region_id region);
  */
 ZINC_API int cmzn_region_end_hierarchical_change(cmzn_region_id region);
 
+/**
+ * Query whether the region is frozen for concurrent read-only evaluation.
+ * @see cmzn_region_set_frozen
+ *
+ * @param region  The region to query.
+ * @return  Boolean true if region is frozen, otherwise false.
+ */
+ZINC_API bool cmzn_region_is_frozen(cmzn_region_id region);
+
+/**
+ * Set whether the region is frozen for concurrent read-only evaluation.
+ * While frozen, fields in the region may be evaluated from multiple threads
+ * provided each thread uses its own field cache created for the region, and
+ * no other objects are shared between threads without synchronisation.
+ * While frozen, attempts to assign field values, create fields, set field
+ * name, managed, coordinate system or type coordinate attributes, create,
+ * destroy or merge nodes and elements, or read into the region fail with
+ * CMZN_ERROR_IN_USE or a NULL/invalid handle. Other modifications are
+ * unsupported: they report an error and their changes are not notified.
+ * Client must not change frozen state while other threads are evaluating.
+ * Only applies to this region, not its child regions.
+ *
+ * @param region  The region to modify.
+ * @param frozen  True to freeze the region, false to unfreeze it.
+ * @return  Status CMZN_OK on success, otherwise CMZN_ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_region_set_frozen(cmzn_region_id region, bool frozen);
+
 /**
  * Get the owning context for the region.
  *
@@ -88,6 +88,16 @@ public:
 		return cmzn_region_end_hierarchical_change(id);
 	}
 
+	bool isFrozen() const
+	{
+		return cmzn_region_is_frozen(id);
+	}
+
+	int setFrozen(bool frozen)
+	{
+		return cmzn_region_set_frozen(id, frozen);
+	}
+
 	Region createChild(const char *name)
 	{
 		return Region(cmzn_region_create_child(id, name));
@@ -216,6 +216,43 @@ ZINC_API int cmzn_scene_end_change(cmzn_scene_id scene);
 ZINC_API cmzn_graphics_id cmzn_scene_find_graphics_by_name(cmzn_scene_id scene,
 	const char *name);
 
+/**
+ * Get the number of threads graphics objects in the scene are built with.
+ * @see cmzn_scene_set_build_threads_count
+ *
+ * @param scene  The scene to query.
+ * @return  Number of threads >= 1, 0 if using all hardware threads, or -1 if
+ * invalid scene.
+ */
+ZINC_API int cmzn_scene_get_build_threads_count(cmzn_scene_id scene);
+
+/**
+ * Set the number of threads to build graphics objects in the scene with.
+ * With more than 1 thread, changed graphics are shared between threads each
+ * with their own field cache, with the elements of lines, surfaces, contours
+ * and streamlines graphics converted concurrently. Points graphics and
+ * streamlines with Poisson sampling are converted one at a time as they share
+ * glyphs and random numbers. If only one graphics has changed, elements of
+ * large lines, surfaces, iso-surface contours and streamlines graphics, and
+ * seed nodes of streamlines, are instead split into chunks converted on all
+ * threads, with identical results.
+ * Threads are taken from a persistent pool shared with other threaded
+ * evaluations in the library.
+ * Finished graphics objects are only passed to the renderer once all graphics
+ * in the scene are built, and incremental builds are always serial.
+ * Fields and the region must not be modified while building graphics.
+ * Only applies to this scene, not to scenes of child regions.
+ * This is a runtime setting and is not serialised in the scene description.
+ * Default is 1 i.e. serial building.
+ *
+ * @param scene  The scene to modify.
+ * @param threads_count  Number of threads >= 1, or 0 to use all hardware
+ * threads.
+ * @return  Result OK on success, otherwise ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_scene_set_build_threads_count(cmzn_scene_id scene,
+	int threads_count);
+
 /**
  * Get the range of world coordinates spanned by graphics in the scene and its
  * sub-scenes, including application of scene transformation matrices.
@@ -154,6 +154,16 @@ public:
 		return Graphics(cmzn_scene_find_graphics_by_name(id, name));
 	}
 
+	int getBuildThreadsCount() const
+	{
+		return cmzn_scene_get_build_threads_count(id);
+	}
+
+	int setBuildThreadsCount(int threadsCount)
+	{
+		return cmzn_scene_set_build_threads_count(id, threadsCount);
+	}
+
 	int getCoordinatesRange(const Scenefilter& filter, double *minimumValuesOut3,
 		double *maximumValuesOut3) const
 	{
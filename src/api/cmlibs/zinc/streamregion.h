@@ -202,6 +202,60 @@ ZINC_API int cmzn_streaminformation_region_set_file_format(
 	cmzn_streaminformation_region_id streaminformation,
 	enum cmzn_streaminformation_region_file_format file_format);
 
+/**
+ * Get the number of threads used to read multiple resources.
+ * @see cmzn_streaminformation_region_set_threads_count
+ *
+ * @param streaminformation  The region stream information object.
+ * @return  The number of threads, 0 for hardware concurrency, or -1 if
+ * invalid argument.
+ */
+ZINC_API int cmzn_streaminformation_region_get_threads_count(
+	cmzn_streaminformation_region_id streaminformation);
+
+/**
+ * Set the number of threads used to read multiple resources. With more than
+ * one thread, EX format resources are parsed concurrently into separate
+ * temporary regions which are then merged in the order resources were added,
+ * before merging into the region as for serial reading. This requires each
+ * resource to be independent: it must not refer to fields, nodes or elements
+ * that are only defined in other resources, except that nodes referenced by
+ * elements and host elements of embedded locations are created as needed.
+ * FieldML resources are always read serially. Default 1 reads all resources
+ * serially into one temporary region.
+ *
+ * @param streaminformation  The region stream information object.
+ * @param threads_count  The number of threads to read with, at least 1, or 0
+ * to use hardware concurrency.
+ * @return  Status CMZN_OK on success, otherwise CMZN_ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_streaminformation_region_set_threads_count(
+	cmzn_streaminformation_region_id streaminformation, int threads_count);
+
+/**
+ * Get whether uncompressed file resources are read through a memory mapping.
+ * @see cmzn_streaminformation_region_set_memory_map_files
+ *
+ * @param streaminformation  The region stream information object.
+ * @return  True if memory mapping files, otherwise false.
+ */
+ZINC_API bool cmzn_streaminformation_region_is_memory_map_files(
+	cmzn_streaminformation_region_id streaminformation);
+
+/**
+ * Set whether uncompressed file resources are read through a memory mapping
+ * instead of buffered file input, which can be faster for large files.
+ * Files which cannot be mapped are read normally. Only use this if the files
+ * cannot be truncated or rewritten by another process while being read, as
+ * on some platforms this terminates the application. Default false.
+ *
+ * @param streaminformation  The region stream information object.
+ * @param value  True to memory map files, false to read them normally.
+ * @return  Status CMZN_OK on success, otherwise CMZN_ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_streaminformation_region_set_memory_map_files(
+	cmzn_streaminformation_region_id streaminformation, bool value);
+
 /**
  * Get the specified domain types for a stream resource in streaminformation.
  *
@@ -53,7 +53,8 @@ public:
 		FILE_FORMAT_INVALID = CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_INVALID,
 		FILE_FORMAT_AUTOMATIC = CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_AUTOMATIC,
 		FILE_FORMAT_EX = CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX,
-		FILE_FORMAT_FIELDML = CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_FIELDML
+		FILE_FORMAT_FIELDML = CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_FIELDML,
+		FILE_FORMAT_EX_BINARY = CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX_BINARY
 	};
 
 	enum RecursionMode
@@ -116,6 +117,26 @@ public:
 			static_cast<cmzn_streaminformation_region_file_format>(fileFormat));
 	}
 
+	int getThreadsCount() const
+	{
+		return cmzn_streaminformation_region_get_threads_count(getDerivedId());
+	}
+
+	int setThreadsCount(int threadsCount)
+	{
+		return cmzn_streaminformation_region_set_threads_count(getDerivedId(), threadsCount);
+	}
+
+	bool isMemoryMapFiles() const
+	{
+		return cmzn_streaminformation_region_is_memory_map_files(getDerivedId());
+	}
+
+	int setMemoryMapFiles(bool value)
+	{
+		return cmzn_streaminformation_region_set_memory_map_files(getDerivedId(), value);
+	}
+
 	Field::DomainTypes getResourceDomainTypes(const Streamresource& resource) const
 	{
 		return static_cast<Field::DomainTypes>(
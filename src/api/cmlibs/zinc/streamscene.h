@@ -13,6 +13,7 @@
 
 #include "types/sceneid.h"
 #include "types/scenefilterid.h"
+#include "types/sceneviewerid.h"
 #include "types/streamid.h"
 
 #include "cmlibs/zinc/zincsharedobject.h"
@@ -109,6 +110,31 @@ ZINC_API int cmzn_streaminformation_scene_set_scenefilter(
 	cmzn_streaminformation_scene_id streaminformation,
 	cmzn_scenefilter_id scenefilter);
 
+/**
+ * Return the scene viewer that is set for this streaminformation.
+ *
+ * @param streaminformation  The streaminformation_scene to get the scene
+ * viewer from.
+ * @return  Handle to scene viewer, or NULL/invalid handle if none or failed.
+ */
+ZINC_API cmzn_sceneviewer_id cmzn_streaminformation_scene_get_sceneviewer(
+	cmzn_streaminformation_scene_id streaminformation);
+
+/**
+ * Set the scene viewer whose current view chooses the level of detail of
+ * exported lines and surfaces graphics using a tessellation with a pixel
+ * error tolerance, as they are drawn in it. Without a scene viewer, the
+ * default, the finest level is exported. Scene transformations are not
+ * included in the view. Only applicable to THREEJS and binary glTF export.
+ *
+ * @param streaminformation  The streaminformation_scene to be modified.
+ * @param sceneviewer  The scene viewer to use, or NULL to clear.
+ * @return  Status CMZN_OK on success, any other value on failure.
+ */
+ZINC_API int cmzn_streaminformation_scene_set_sceneviewer(
+	cmzn_streaminformation_scene_id streaminformation,
+	cmzn_sceneviewer_id sceneviewer);
+
 /**
  * Get the currently set export format of streaminformation_scene.
  *
@@ -336,6 +362,30 @@ ZINC_API int cmzn_streaminformation_scene_set_output_is_inline(
 	cmzn_streaminformation_scene_id streaminformation,
 	int outputIsInline);
 
+/**
+ * Get the flag which specifies if vertex attributes should be quantised.
+ *
+ * @param streaminformation  The streaminformation_scene to query.
+ * @return  1 if vertex attributes are to be quantised, otherwise 0.
+ */
+ZINC_API int cmzn_streaminformation_scene_get_output_is_quantised(
+	cmzn_streaminformation_scene_id streaminformation);
+
+/**
+ * Set the flag which specifies if vertex attributes should be quantised.
+ * If set, positions are output as 16-bit and normals as 8-bit normalized
+ * integers using the KHR_mesh_quantization extension, and colours as 8-bit
+ * normalized integers. This option is only applicable to binary glTF export.
+ * The default value is 0.
+ *
+ * @param streaminformation  The streaminformation_scene to modify.
+ * @param outputIsQuantised  value to be assigned to the flag.
+ * @return  Status CMZN_OK on success, any other value on failure.
+ */
+ZINC_API int cmzn_streaminformation_scene_set_output_is_quantised(
+	cmzn_streaminformation_scene_id streaminformation,
+	int outputIsQuantised);
+
 
 #ifdef __cplusplus
 }
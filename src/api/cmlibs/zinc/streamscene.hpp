@@ -13,6 +13,7 @@
 #include "cmlibs/zinc/scene.hpp"
 #include "cmlibs/zinc/stream.hpp"
 #include "cmlibs/zinc/scenefilter.hpp"
+#include "cmlibs/zinc/sceneviewer.hpp"
 
 namespace CMLibs
 {
@@ -56,7 +57,8 @@ public:
 		IO_FORMAT_THREEJS = CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_THREEJS,
         IO_FORMAT_DESCRIPTION = CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_DESCRIPTION,
         IO_FORMAT_ASCII_STL = CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_ASCII_STL,
-        IO_FORMAT_WAVEFRONT = CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_WAVEFRONT
+        IO_FORMAT_WAVEFRONT = CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_WAVEFRONT,
+		IO_FORMAT_GLTF_BINARY = CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_GLTF_BINARY
 	};
 
 	Scenefilter getScenefilter() const
@@ -69,6 +71,16 @@ public:
 		return cmzn_streaminformation_scene_set_scenefilter(getDerivedId(), scenefilter.getId());
 	}
 
+	Sceneviewer getSceneviewer() const
+	{
+		return Sceneviewer(cmzn_streaminformation_scene_get_sceneviewer(getDerivedId()));
+	}
+
+	int setSceneviewer(const Sceneviewer& sceneviewer)
+	{
+		return cmzn_streaminformation_scene_set_sceneviewer(getDerivedId(), sceneviewer.getId());
+	}
+
 	IODataType getIODataType() const
 	{
 		return static_cast<IODataType>(cmzn_streaminformation_scene_get_io_data_type(getDerivedId()));
@@ -174,6 +186,16 @@ public:
 	{
 		return cmzn_streaminformation_scene_set_output_is_inline(getDerivedId(), outputIsInline);
 	}
+
+	int getOutputIsQuantised() const
+	{
+		return cmzn_streaminformation_scene_get_output_is_quantised(getDerivedId());
+	}
+
+	int setOutputIsQuantised(int outputIsQuantised)
+	{
+		return cmzn_streaminformation_scene_set_output_is_quantised(getDerivedId(), outputIsQuantised);
+	}
 };
 
 inline StreaminformationScene Streaminformation::castScene()
@@ -215,6 +215,36 @@ ZINC_API int cmzn_tessellation_get_circle_divisions(
 ZINC_API int cmzn_tessellation_set_circle_divisions(
     cmzn_tessellation_id tessellation, int circleDivisions);
 
+/**
+ * Gets the pixel error tolerance for adaptive level of detail tessellation.
+ * @see cmzn_tessellation_set_pixel_error_tolerance
+ *
+ * @param tessellation  The tessellation to query.
+ * @return  The pixel error tolerance, or 0 if tessellation is fixed or on
+ * error.
+ */
+ZINC_API double cmzn_tessellation_get_pixel_error_tolerance(
+    cmzn_tessellation_id tessellation);
+
+/**
+ * Sets the pixel error tolerance for adaptive level of detail tessellation.
+ * If positive, line and surface graphics using this tessellation choose
+ * divisions for each element from the curvature of the coordinate field, so
+ * that the chordal error of each level of detail is uniform over the mesh.
+ * Surface elements sharing an edge divide it equally so there are no cracks,
+ * which needs line faces to be defined; without them divisions are chosen
+ * per element. The finest level uses the refined divisions; several coarser levels are
+ * cached with the graphics, and when drawn the coarsest level whose projected
+ * error is within this many pixels is rendered. The minimum divisions are
+ * respected at all levels. Set to 0 (the default) for fixed divisions.
+ *
+ * @param tessellation  The tessellation to modify.
+ * @param pixelErrorTolerance  Maximum screen error in pixels, >= 0.
+ * @return  Status CMZN_OK on success, otherwise CMZN_ERROR_ARGUMENT.
+ */
+ZINC_API int cmzn_tessellation_set_pixel_error_tolerance(
+    cmzn_tessellation_id tessellation, double pixelErrorTolerance);
+
 /**
  * Get managed status of tessellation in its owning tessellation module.
  * @see cmzn_tessellation_set_managed
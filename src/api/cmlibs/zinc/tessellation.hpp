@@ -104,6 +104,16 @@ public:
 		return cmzn_tessellation_set_circle_divisions(id, circleDivisions);
 	}
 
+	double getPixelErrorTolerance() const
+	{
+		return cmzn_tessellation_get_pixel_error_tolerance(id);
+	}
+
+	int setPixelErrorTolerance(double pixelErrorTolerance)
+	{
+		return cmzn_tessellation_set_pixel_error_tolerance(id, pixelErrorTolerance);
+	}
+
 	char *getName() const
 	{
 		return cmzn_tessellation_get_name(id);
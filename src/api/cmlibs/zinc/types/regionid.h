@@ -89,8 +89,13 @@ enum cmzn_streaminformation_region_file_format
 	 * .ex* -> EX format; .fieldml -> FieldML */
 	CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX = 2,
 	/*!< Zinc/Cmgui EX format */
-	CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_FIELDML = 3
+	CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_FIELDML = 3,
 	/*!< Latest supported FieldML format */
+	CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX_BINARY = 4
+	/*!< EX format with node and element values, element nodes and scale
+	 * factors written as little endian binary blocks for fast writing and
+	 * reading. Binary EX files are read by the EX format reader, and are
+	 * never chosen automatically on write. */
 };
 
 enum cmzn_streaminformation_region_recursion_mode
@@ -61,8 +61,13 @@ enum cmzn_streaminformation_scene_io_format
 	/*!< Import/export scene configurations into the scene */
     CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_ASCII_STL = 3,
     /*!< Export scene into STL text file.*/
-    CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_WAVEFRONT = 4
+    CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_WAVEFRONT = 4,
     /*!< Export scene into wavefront file.*/
+	CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_GLTF_BINARY = 5
+	/*!< Export scene into a single binary glTF 2.0 (GLB) file. Surfaces, lines
+	 * and point glyphs are exported; time steps are output as morph targets.
+	 * Points graphics with glyph shapes other than POINT are not exported;
+	 * use THREEJS format to export glyphs. */
 };
 
 #endif
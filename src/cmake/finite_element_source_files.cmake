@@ -30,6 +30,7 @@ SET( FINITE_ELEMENT_CORE_SRCS
   ${CMAKE_CURRENT_SOURCE_DIR}/finite_element/node_field_template.cpp )
 SET( FINITE_ELEMENT_CORE_HDRS
   ${CMAKE_CURRENT_SOURCE_DIR}/finite_element/element_field_template.hpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/finite_element/element_node_sequence_map.hpp
   ${CMAKE_CURRENT_SOURCE_DIR}/finite_element/export_finite_element.h
   ${CMAKE_CURRENT_SOURCE_DIR}/finite_element/finite_element.h
   ${CMAKE_CURRENT_SOURCE_DIR}/finite_element/finite_element_basis.hpp
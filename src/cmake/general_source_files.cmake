@@ -27,6 +27,7 @@ SET( GENERAL_SRCS
   ${CMAKE_CURRENT_SOURCE_DIR}/general/mystring.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/general/octree.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/general/statistics.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/general/thread_pool.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/general/time.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/general/value.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/jsoncpp/jsoncpp.cpp
@@ -74,6 +75,7 @@ SET( GENERAL_HDRS
   ${CMAKE_CURRENT_SOURCE_DIR}/general/refhandle.hpp
   ${CMAKE_CURRENT_SOURCE_DIR}/general/simple_list.h
   ${CMAKE_CURRENT_SOURCE_DIR}/general/statistics.h
+  ${CMAKE_CURRENT_SOURCE_DIR}/general/thread_pool.hpp
   ${CMAKE_CURRENT_SOURCE_DIR}/general/time.h
   ${CMAKE_CURRENT_SOURCE_DIR}/general/value.h
   ${CMAKE_CURRENT_SOURCE_DIR}/jsoncpp/json.h
@@ -26,6 +26,7 @@ SET( GRAPHICS_SRCS
   ${CMAKE_CURRENT_SOURCE_DIR}/graphics/complex.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/graphics/element_point_ranges.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/graphics/environment_map.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/graphics/gltf_export.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/graphics/glyph.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/graphics/glyph_axes.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/graphics/glyph_circular.cpp
@@ -77,6 +78,7 @@ SET( GRAPHICS_HDRS
   ${CMAKE_CURRENT_SOURCE_DIR}/graphics/complex.h
   ${CMAKE_CURRENT_SOURCE_DIR}/graphics/element_point_ranges.h
   ${CMAKE_CURRENT_SOURCE_DIR}/graphics/environment_map.h
+  ${CMAKE_CURRENT_SOURCE_DIR}/graphics/gltf_export.hpp
   ${CMAKE_CURRENT_SOURCE_DIR}/graphics/glyph.hpp
   ${CMAKE_CURRENT_SOURCE_DIR}/graphics/glyph_axes.hpp
   ${CMAKE_CURRENT_SOURCE_DIR}/graphics/glyph_circular.hpp
@@ -125,6 +127,8 @@ IF( ${GRAPHICS_API} MATCHES OPENGL_GRAPHICS )
     ${CMAKE_CURRENT_SOURCE_DIR}/graphics/font.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/graphics/graphics_library.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/graphics/graphics_object.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/graphics/graphics_object_lod.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/graphics/graphics_object_pick_tree.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/graphics/light.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/graphics/render.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/graphics/render_gl.cpp
@@ -134,6 +138,8 @@ IF( ${GRAPHICS_API} MATCHES OPENGL_GRAPHICS )
 	SET( GRAPHICS_HDRS ${GRAPHICS_HDRS}
     ${CMAKE_CURRENT_SOURCE_DIR}/graphics/font.h
     ${CMAKE_CURRENT_SOURCE_DIR}/graphics/graphics_library.h
+    ${CMAKE_CURRENT_SOURCE_DIR}/graphics/graphics_object_lod.hpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/graphics/graphics_object_pick_tree.hpp
     ${CMAKE_CURRENT_SOURCE_DIR}/graphics/light.hpp
     ${CMAKE_CURRENT_SOURCE_DIR}/graphics/render.hpp
     ${CMAKE_CURRENT_SOURCE_DIR}/graphics/render_gl.h
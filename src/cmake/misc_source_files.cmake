@@ -68,6 +68,7 @@ SET( LICENSE_HDRS ${CMAKE_CURRENT_SOURCE_DIR}/license.h )
 SET( MESH_SRCS
   ${CMAKE_CURRENT_SOURCE_DIR}/mesh/cmiss_element_private.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/mesh/cmiss_node_private.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/mesh/group_conditional.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/mesh/mesh.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/mesh/mesh_group.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/mesh/nodeset.cpp
@@ -75,6 +76,7 @@ SET( MESH_SRCS
 SET( MESH_HDRS
   ${CMAKE_CURRENT_SOURCE_DIR}/mesh/cmiss_node_private.hpp
   ${CMAKE_CURRENT_SOURCE_DIR}/mesh/cmiss_element_private.hpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/mesh/group_conditional.hpp
   ${CMAKE_CURRENT_SOURCE_DIR}/mesh/mesh.hpp
   ${CMAKE_CURRENT_SOURCE_DIR}/mesh/mesh_group.hpp
   ${CMAKE_CURRENT_SOURCE_DIR}/mesh/nodeset.hpp
@@ -140,6 +140,7 @@ like the number of components.
 #include "general/mystring.h"
 #include "general/value.h"
 #include "general/message.h"
+#include "mesh/nodeset.hpp"
 #include "general/enumerator_conversion.hpp"
 #include <typeinfo>
 
@@ -244,14 +245,14 @@ void cmzn_field::deaccess(cmzn_field*& field_ref)
 	{
 		cmzn_field* field = field_ref;
 		field_ref = nullptr; // clear client's pointer ASAP in case manager message sent below
-		--(field->access_count);
-		if (field->access_count <= 0)
+		const int accessCount = --(field->access_count);
+		if (accessCount <= 0)
 		{
 			delete field;
 		}
 		else if ((0 == (field->attribute_flags & COMPUTED_FIELD_ATTRIBUTE_IS_MANAGED_BIT)) &&
-			(field->manager) && ((1 == field->access_count) ||
-			((2 == field->access_count) &&
+			(field->manager) && ((1 == accessCount) ||
+			((2 == accessCount) &&
 				(MANAGER_CHANGE_NONE(cmzn_field) != field->manager_change_status))) &&
 			field->core->not_in_use())
 		{
@@ -544,6 +545,8 @@ cmzn_field *Computed_field_create_generic(
 	{
 		int return_code = 1;
 		cmzn_region *region = cmzn_fieldmodule_get_region_internal(fieldmodule);
+		if (!region->checkModifiable("Computed_field_create_generic"))
+			return_code = 0;
 		for (int i = 0; i < number_of_source_fields; i++)
 		{
 			if (NULL != source_fields[i])
@@ -1346,6 +1349,29 @@ int Computed_field_core::getDerivativeTreeOrder(const FieldDerivative& fieldDeri
 	return order;
 }
 
+int Computed_field_core::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	const int dimension = element->getDimension();
+	const int componentsCount = this->field->number_of_components;
+	const FE_value *pointXi = xi;
+	FE_value *pointValues = values;
+	for (int p = 0; p < pointsCount; ++p)
+	{
+		// indexed location keeps basis functions evaluated at xi for next batch
+		cache.setIndexedMeshLocation(static_cast<unsigned int>(p), element, pointXi);
+		const FieldValueCache *valueCache = this->field->evaluate(cache);
+		if (!valueCache)
+			return 0;
+		const FE_value *sourceValues = RealFieldValueCache::cast(valueCache)->values;
+		for (int i = 0; i < componentsCount; ++i)
+			pointValues[i] = sourceValues[i];
+		pointXi += dimension;
+		pointValues += componentsCount;
+	}
+	return 1;
+}
+
 int Computed_field_has_string_value_type(struct cmzn_field *field,
 	void *dummy_void)
 {
@@ -1420,6 +1446,8 @@ int cmzn_field_assign_mesh_location(cmzn_field_id field,
 		(number_of_chart_coordinates >= get_FE_element_dimension(element)) &&
 		(CMZN_FIELD_VALUE_TYPE_MESH_LOCATION == cmzn_field_get_value_type(field)))
 	{
+		if ((!cache->assignInCacheOnly()) && (!field->getRegion()->checkModifiable("cmzn_field_assign_mesh_location")))
+			return CMZN_ERROR_IN_USE;
 		MeshLocationFieldValueCache *valueCache = MeshLocationFieldValueCache::cast(field->getValueCache(*cache));
 		valueCache->setMeshLocation(element, chart_coordinates);
 		enum FieldAssignmentResult result = field->assign(*cache, *valueCache);
@@ -1436,6 +1464,8 @@ int cmzn_field_assign_real(cmzn_field_id field, cmzn_fieldcache_id cache,
 	if (cmzn_fieldcache_check(field, cache) && field->isNumerical() &&
 		(number_of_values >= field->number_of_components) && values)
 	{
+		if ((!cache->assignInCacheOnly()) && (!field->getRegion()->checkModifiable("cmzn_field_assign_real")))
+			return CMZN_ERROR_IN_USE;
 		RealFieldValueCache *valueCache = RealFieldValueCache::cast(field->getValueCache(*cache));
 		valueCache->setValues(values);
 		enum FieldAssignmentResult result = field->assign(*cache, *valueCache);
@@ -1452,6 +1482,8 @@ int cmzn_field_assign_string(cmzn_field_id field, cmzn_fieldcache_id cache,
 	if (cmzn_fieldcache_check(field, cache) && string_value &&
 		(CMZN_FIELD_VALUE_TYPE_STRING == cmzn_field_get_value_type(field)))
 	{
+		if ((!cache->assignInCacheOnly()) && (!field->getRegion()->checkModifiable("cmzn_field_assign_string")))
+			return CMZN_ERROR_IN_USE;
 		StringFieldValueCache *valueCache = StringFieldValueCache::cast(field->getValueCache(*cache));
 		valueCache->setString(string_value);
 		enum FieldAssignmentResult result = field->assign(*cache, *valueCache);
@@ -1552,6 +1584,81 @@ int cmzn_field_evaluate_real(cmzn_field_id field, cmzn_fieldcache_id cache,
 	return CMZN_ERROR_ARGUMENT;
 }
 
+int cmzn_field_evaluate_real_mesh_locations(cmzn_field_id field,
+	cmzn_fieldcache_id cache, cmzn_element_id element, int number_of_points,
+	int number_of_chart_coordinates, const double *chart_coordinates,
+	int number_of_values, double *values)
+{
+	if (!(cmzn_fieldcache_check(field, cache) && (element) && (number_of_points >= 0) &&
+		field->core->has_numerical_components()))
+	{
+		return CMZN_ERROR_ARGUMENT;
+	}
+	const FE_mesh *feMesh = element->getMesh();
+	if ((!feMesh) || (feMesh->getRegion() != cache->getRegion()))
+	{
+		display_message(ERROR_MESSAGE, "Field evaluateRealMeshLocations.  Element is not from field region");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	const int dimension = element->getDimension();
+	const int componentsCount = field->number_of_components;
+	if ((0 < number_of_points) && (!((chart_coordinates) && (values) &&
+		(number_of_chart_coordinates >= number_of_points*dimension) &&
+		(number_of_values >= number_of_points*componentsCount))))
+	{
+		return CMZN_ERROR_ARGUMENT;
+	}
+	if (0 == number_of_points)
+	{
+		return CMZN_OK;
+	}
+	if (!field->core->evaluateRealMeshLocations(*cache, element, number_of_points, chart_coordinates, values))
+	{
+		return CMZN_ERROR_GENERAL;
+	}
+	return CMZN_OK;
+}
+
+int cmzn_field_evaluate_real_nodeset(cmzn_field_id field,
+	cmzn_fieldcache_id cache, cmzn_nodeset_id nodeset,
+	int number_of_values, double *values)
+{
+	if (!(cmzn_fieldcache_check(field, cache) && (nodeset) &&
+		(nodeset->getRegion() == cache->getRegion()) &&
+		field->core->has_numerical_components()))
+	{
+		return CMZN_ERROR_ARGUMENT;
+	}
+	const int componentsCount = field->number_of_components;
+	const int nodesCount = nodeset->getSize();
+	if ((0 < nodesCount) && (!((values) && (number_of_values >= nodesCount*componentsCount))))
+	{
+		return CMZN_ERROR_ARGUMENT;
+	}
+	int result = CMZN_OK;
+	double *nodeValues = values;
+	cmzn_nodeiterator *iterator = nodeset->createNodeiterator();
+	cmzn_node *node;
+	while ((node = iterator->nextNode()))
+	{
+		cache->setNode(node);
+		const FieldValueCache *valueCache = field->evaluate(*cache);
+		if (!valueCache)
+		{
+			result = CMZN_ERROR_GENERAL;
+			break;
+		}
+		const FE_value *sourceValues = RealFieldValueCache::cast(valueCache)->values;
+		for (int i = 0; i < componentsCount; ++i)
+		{
+			nodeValues[i] = sourceValues[i];
+		}
+		nodeValues += componentsCount;
+	}
+	cmzn::Deaccess(iterator);
+	return result;
+}
+
 /** Internal function only. Evaluate real field values with all first derivatives w.r.t. xi.
  * @deprecated
  * Try to remove its use as soon as possible.
@@ -2373,7 +2480,7 @@ Writes the properties of the <field> to the command window.
 			display_message(INFORMATION_MESSAGE,"\n");
 		}
 		display_message(INFORMATION_MESSAGE,"  (access count = %d)\n",
-			field->access_count);
+			static_cast<int>(field->access_count));
 	}
 	else
 	{
@@ -2652,10 +2759,22 @@ bool cmzn_field_is_managed(cmzn_field_id field)
 	return 0;
 }
 
+/**
+ * Check field's region may be modified, reporting an error if it is frozen.
+ * @return  True if field is not in a frozen region, otherwise false.
+ */
+static bool cmzn_field_check_modifiable(cmzn_field_id field, const char *location)
+{
+	cmzn_region *region = (field->manager) ? field->getRegion() : nullptr;
+	return (!region) || region->checkModifiable(location);
+}
+
 int cmzn_field_set_managed(cmzn_field_id field, bool value)
 {
 	if (field)
 	{
+		if (!cmzn_field_check_modifiable(field, "cmzn_field_set_managed"))
+			return CMZN_ERROR_IN_USE;
 		bool old_value = cmzn_field_is_managed(field);
 		if (value)
 		{
@@ -2691,6 +2810,8 @@ int cmzn_field_set_component_name(cmzn_field_id field,
 	if (field && (0 < component_number) &&
 		(component_number <= field->number_of_components) && name)
 	{
+		if (!cmzn_field_check_modifiable(field, "cmzn_field_set_component_name"))
+			return CMZN_ERROR_IN_USE;
 		return field->core->setComponentName(component_number, name);
 	}
 	return CMZN_ERROR_ARGUMENT;
@@ -2709,6 +2830,8 @@ int cmzn_field_set_coordinate_system_focus(cmzn_field_id field, double focus)
 {
 	if (field)
 	{
+		if (!cmzn_field_check_modifiable(field, "cmzn_field_set_coordinate_system_focus"))
+			return CMZN_ERROR_IN_USE;
 		return field->setCoordinateSystemFocus(static_cast<FE_value>(focus));
 	}
 	return CMZN_ERROR_ARGUMENT;
@@ -2729,6 +2852,8 @@ int cmzn_field_set_coordinate_system_type(cmzn_field_id field,
 {
 	if (field)
 	{
+		if (!cmzn_field_check_modifiable(field, "cmzn_field_set_coordinate_system_type"))
+			return CMZN_ERROR_IN_USE;
 		return field->setCoordinateSystemType(coordinate_system_type);
 	}
 	return CMZN_ERROR_ARGUMENT;
@@ -2747,6 +2872,8 @@ int cmzn_field_set_name(cmzn_field_id field, const char *name)
 {
 	if (field)
 	{
+		if (!cmzn_field_check_modifiable(field, "cmzn_field_set_name"))
+			return CMZN_ERROR_IN_USE;
 		return field->setName(name);
 	}
 	return CMZN_ERROR_ARGUMENT;
@@ -2780,6 +2907,8 @@ int cmzn_field_set_type_coordinate(cmzn_field_id field, bool value)
 {
 	if (field)
 	{
+		if (!cmzn_field_check_modifiable(field, "cmzn_field_set_type_coordinate"))
+			return CMZN_ERROR_IN_USE;
 		const bool oldValue = field->core->isTypeCoordinate();
 		if (value == oldValue)
 			return CMZN_OK;
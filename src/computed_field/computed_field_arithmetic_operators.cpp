@@ -12,6 +12,7 @@ Implements a number of basic component wise operators on computed fields.
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 #include <math.h>
+#include <vector>
 #include "computed_field/computed_field.h"
 #include "computed_field/computed_field_private.hpp"
 #include "computed_field/field_cache.hpp"
@@ -62,6 +63,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	int list();
@@ -83,6 +87,20 @@ int Computed_field_power::evaluate(cmzn_fieldcache& cache, FieldValueCache& inVa
 	return 0;
 }
 
+int Computed_field_power::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	if (!this->evaluateSourceRealMeshLocations(0, cache, element, pointsCount, xi, values))
+		return 0;
+	const int valuesCount = pointsCount*field->number_of_components;
+	std::vector<FE_value> source2Values(valuesCount);
+	if (!this->evaluateSourceRealMeshLocations(1, cache, element, pointsCount, xi, source2Values.data()))
+		return 0;
+	for (int v = 0; v < valuesCount; ++v)
+		values[v] = pow(values[v], source2Values[v]);
+	return 1;
+}
+
 int Computed_field_power::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	if (fieldDerivative.getTotalOrder() > 1)
@@ -298,6 +316,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	virtual int getDerivativeTreeOrder(const FieldDerivative& fieldDerivative)
@@ -326,6 +347,20 @@ int Computed_field_multiply_components::evaluate(cmzn_fieldcache& cache, FieldVa
 	return 0;
 }
 
+int Computed_field_multiply_components::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	if (!this->evaluateSourceRealMeshLocations(0, cache, element, pointsCount, xi, values))
+		return 0;
+	const int valuesCount = pointsCount*field->number_of_components;
+	std::vector<FE_value> source2Values(valuesCount);
+	if (!this->evaluateSourceRealMeshLocations(1, cache, element, pointsCount, xi, source2Values.data()))
+		return 0;
+	for (int v = 0; v < valuesCount; ++v)
+		values[v] = values[v] * source2Values[v];
+	return 1;
+}
+
 int Computed_field_multiply_components::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	cmzn_field *sourceField1 = this->getSourceField(0);
@@ -628,6 +663,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	int list();
@@ -649,6 +687,20 @@ int Computed_field_divide_components::evaluate(cmzn_fieldcache& cache, FieldValu
 	return 0;
 }
 
+int Computed_field_divide_components::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	if (!this->evaluateSourceRealMeshLocations(0, cache, element, pointsCount, xi, values))
+		return 0;
+	const int valuesCount = pointsCount*field->number_of_components;
+	std::vector<FE_value> source2Values(valuesCount);
+	if (!this->evaluateSourceRealMeshLocations(1, cache, element, pointsCount, xi, source2Values.data()))
+		return 0;
+	for (int v = 0; v < valuesCount; ++v)
+		values[v] = values[v] / source2Values[v];
+	return 1;
+}
+
 int Computed_field_divide_components::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	if (fieldDerivative.getTotalOrder() > 1)
@@ -866,6 +918,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	virtual int getDerivativeTreeOrder(const FieldDerivative& fieldDerivative)
@@ -902,6 +957,21 @@ int Computed_field_add::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValu
 	return 0;
 }
 
+int Computed_field_add::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	if (!this->evaluateSourceRealMeshLocations(0, cache, element, pointsCount, xi, values))
+		return 0;
+	const int valuesCount = pointsCount*field->number_of_components;
+	std::vector<FE_value> source2Values(valuesCount);
+	if (!this->evaluateSourceRealMeshLocations(1, cache, element, pointsCount, xi, source2Values.data()))
+		return 0;
+	for (int v = 0; v < valuesCount; ++v)
+		values[v] = field->source_values[0] * values[v] +
+			field->source_values[1] * source2Values[v];
+	return 1;
+}
+
 int Computed_field_add::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	const DerivativeValueCache *source1DerivativeCache = getSourceField(0)->evaluateDerivative(cache, fieldDerivative);
@@ -1147,6 +1217,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	virtual int getDerivativeTreeOrder(const FieldDerivative& fieldDerivative)
@@ -1174,6 +1247,22 @@ int Computed_field_scale::evaluate(cmzn_fieldcache& cache, FieldValueCache& inVa
 	return 0;
 }
 
+int Computed_field_scale::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	if (!this->evaluateSourceRealMeshLocations(0, cache, element, pointsCount, xi, values))
+		return 0;
+	const int componentsCount = field->number_of_components;
+	FE_value *pointValues = values;
+	for (int p = 0; p < pointsCount; ++p)
+	{
+		for (int i = 0; i < componentsCount; ++i)
+			pointValues[i] = field->source_values[i]*pointValues[i];
+		pointValues += componentsCount;
+	}
+	return 1;
+}
+
 int Computed_field_scale::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	const DerivativeValueCache *sourceDerivativeCache = getSourceField(0)->evaluateDerivative(cache, fieldDerivative);
@@ -1388,6 +1477,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	int list();
@@ -1411,6 +1503,22 @@ int Computed_field_clamp_maximum::evaluate(cmzn_fieldcache& cache, FieldValueCac
 	return 0;
 }
 
+int Computed_field_clamp_maximum::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	if (!this->evaluateSourceRealMeshLocations(0, cache, element, pointsCount, xi, values))
+		return 0;
+	const int componentsCount = field->number_of_components;
+	FE_value *pointValues = values;
+	for (int p = 0; p < pointsCount; ++p)
+	{
+		for (int i = 0; i < componentsCount; ++i)
+			pointValues[i] = (pointValues[i] < field->source_values[i]) ? pointValues[i] : field->source_values[i];
+		pointValues += componentsCount;
+	}
+	return 1;
+}
+
 int Computed_field_clamp_maximum::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	const RealFieldValueCache *sourceCache = RealFieldValueCache::cast(getSourceField(0)->evaluate(cache));
@@ -1646,6 +1754,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	int list();
@@ -1668,6 +1779,22 @@ int Computed_field_clamp_minimum::evaluate(cmzn_fieldcache& cache, FieldValueCac
 	return 0;
 }
 
+int Computed_field_clamp_minimum::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	if (!this->evaluateSourceRealMeshLocations(0, cache, element, pointsCount, xi, values))
+		return 0;
+	const int componentsCount = field->number_of_components;
+	FE_value *pointValues = values;
+	for (int p = 0; p < pointsCount; ++p)
+	{
+		for (int i = 0; i < componentsCount; ++i)
+			pointValues[i] = (pointValues[i] > field->source_values[i]) ? pointValues[i] : field->source_values[i];
+		pointValues += componentsCount;
+	}
+	return 1;
+}
+
 int Computed_field_clamp_minimum::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	const RealFieldValueCache *sourceCache = RealFieldValueCache::cast(getSourceField(0)->evaluate(cache));
@@ -1910,6 +2037,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	virtual int getDerivativeTreeOrder(const FieldDerivative& fieldDerivative)
@@ -1937,6 +2067,22 @@ int Computed_field_offset::evaluate(cmzn_fieldcache& cache, FieldValueCache& inV
 	return 0;
 }
 
+int Computed_field_offset::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	if (!this->evaluateSourceRealMeshLocations(0, cache, element, pointsCount, xi, values))
+		return 0;
+	const int componentsCount = field->number_of_components;
+	FE_value *pointValues = values;
+	for (int p = 0; p < pointsCount; ++p)
+	{
+		for (int i = 0; i < componentsCount; ++i)
+			pointValues[i] = pointValues[i] + field->source_values[i];
+		pointValues += componentsCount;
+	}
+	return 1;
+}
+
 int Computed_field_offset::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	const DerivativeValueCache *sourceDerivativeCache = getSourceField(0)->evaluateDerivative(cache, fieldDerivative);
@@ -2398,6 +2544,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	int list();
@@ -2418,6 +2567,17 @@ int Computed_field_log::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValu
 	return 0;
 }
 
+int Computed_field_log::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	if (!this->evaluateSourceRealMeshLocations(0, cache, element, pointsCount, xi, values))
+		return 0;
+	const int valuesCount = pointsCount*field->number_of_components;
+	for (int v = 0; v < valuesCount; ++v)
+		values[v] = log(values[v]);
+	return 1;
+}
+
 int Computed_field_log::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	if (fieldDerivative.getTotalOrder() > 1)
@@ -2602,6 +2762,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	int list();
@@ -2622,6 +2785,17 @@ int Computed_field_sqrt::evaluate(cmzn_fieldcache& cache, FieldValueCache& inVal
 	return 0;
 }
 
+int Computed_field_sqrt::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	if (!this->evaluateSourceRealMeshLocations(0, cache, element, pointsCount, xi, values))
+		return 0;
+	const int valuesCount = pointsCount*field->number_of_components;
+	for (int v = 0; v < valuesCount; ++v)
+		values[v] = sqrt(values[v]);
+	return 1;
+}
+
 int Computed_field_sqrt::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	if (fieldDerivative.getTotalOrder() > 1)
@@ -2806,6 +2980,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	int list();
@@ -2826,6 +3003,17 @@ int Computed_field_exp::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValu
 	return 0;
 }
 
+int Computed_field_exp::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	if (!this->evaluateSourceRealMeshLocations(0, cache, element, pointsCount, xi, values))
+		return 0;
+	const int valuesCount = pointsCount*field->number_of_components;
+	for (int v = 0; v < valuesCount; ++v)
+		values[v] = exp(values[v]);
+	return 1;
+}
+
 int Computed_field_exp::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	if (fieldDerivative.getTotalOrder() > 1)
@@ -3010,6 +3198,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	int list();
@@ -3030,6 +3221,17 @@ int Computed_field_abs::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValu
 	return 0;
 }
 
+int Computed_field_abs::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	if (!this->evaluateSourceRealMeshLocations(0, cache, element, pointsCount, xi, values))
+		return 0;
+	const int valuesCount = pointsCount*field->number_of_components;
+	for (int v = 0; v < valuesCount; ++v)
+		values[v] = fabs(values[v]);
+	return 1;
+}
+
 int Computed_field_abs::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	const RealFieldValueCache *sourceCache = RealFieldValueCache::cast(getSourceField(0)->evaluate(cache));
@@ -126,6 +126,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	virtual int getDerivativeTreeOrder(const FieldDerivative& fieldDerivative)
@@ -241,6 +244,47 @@ int Computed_field_composite::evaluate(cmzn_fieldcache& cache, FieldValueCache&
 	return 1;
 }
 
+/** Evaluates each source field once for all locations, then gathers
+ * components for each location in turn. */
+int Computed_field_composite::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	const int sourceFieldsCount = this->field->number_of_source_fields;
+	if (0 == sourceFieldsCount)
+	{
+		// constant: still leave cache at last location
+		const FE_value *lastXi = xi + (pointsCount - 1)*element->getDimension();
+		cache.setIndexedMeshLocation(static_cast<unsigned int>(pointsCount - 1), element, lastXi);
+	}
+	std::vector<std::vector<FE_value> > sourceFieldValues(sourceFieldsCount);
+	for (int s = 0; s < sourceFieldsCount; ++s)
+	{
+		sourceFieldValues[s].resize(pointsCount*this->getSourceField(s)->number_of_components);
+		if (!this->evaluateSourceRealMeshLocations(s, cache, element, pointsCount, xi, sourceFieldValues[s].data()))
+			return 0;
+	}
+	const int componentsCount = this->field->number_of_components;
+	FE_value *targetValue = values;
+	for (int p = 0; p < pointsCount; ++p)
+	{
+		for (int c = 0; c < componentsCount; ++c)
+		{
+			const int sourceFieldNumber = this->source_field_numbers[c];
+			if (0 <= sourceFieldNumber)
+			{
+				const int sourceComponentsCount = this->getSourceField(sourceFieldNumber)->number_of_components;
+				*targetValue = sourceFieldValues[sourceFieldNumber][p*sourceComponentsCount + source_value_numbers[c]];
+			}
+			else
+			{
+				*targetValue = this->field->source_values[source_value_numbers[c]];
+			}
+			++targetValue;
+		}
+	}
+	return 1;
+}
+
 int Computed_field_composite::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	DerivativeValueCache *derivativeCache = inValueCache.getDerivativeValueCache(fieldDerivative);
@@ -12,6 +12,7 @@ DESCRIPTION :
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 #include <stdio.h>
 #include <math.h>
+#include <vector>
 #include "computed_field/computed_field.h"
 #include "computed_field/computed_field_private.hpp"
 #include "computed_field/computed_field_coordinate.h"
@@ -63,6 +64,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	int list();
@@ -90,6 +94,32 @@ int Computed_field_coordinate_transformation::evaluate(cmzn_fieldcache& cache, F
 	return 0;
 }
 
+int Computed_field_coordinate_transformation::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	cmzn_field_id sourceField = getSourceField(0);
+	const int sourceComponentCount = sourceField->number_of_components;
+	std::vector<FE_value> sourceValues(pointsCount*sourceComponentCount);
+	if (!this->evaluateSourceRealMeshLocations(0, cache, element, pointsCount, xi, sourceValues.data()))
+		return 0;
+	const int componentCount = field->number_of_components;
+	const FE_value *pointSourceValues = sourceValues.data();
+	FE_value *pointValues = values;
+	for (int p = 0; p < pointsCount; ++p)
+	{
+		if (!convert_Coordinate_system(&(sourceField->coordinate_system),
+			sourceComponentCount, pointSourceValues,
+			&(field->coordinate_system), componentCount, pointValues,
+			/*jacobian*/nullptr))
+		{
+			return 0;
+		}
+		pointSourceValues += sourceComponentCount;
+		pointValues += componentCount;
+	}
+	return 1;
+}
+
 int Computed_field_coordinate_transformation::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	if (fieldDerivative.getTotalOrder() > 1)
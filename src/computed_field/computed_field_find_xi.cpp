@@ -15,6 +15,7 @@ lookup of the element.
 
 #include <cstdio>
 #include <cmath>
+#include <limits>
 
 #include "general/debug.h"
 #include "general/matrix_vector.h"
@@ -422,8 +423,51 @@ int Computed_field_find_element_xi(struct Computed_field *field,
 						}
 					}
 				}
-				/* Now try every element */
-				if (!*element_address)
+				/* Now try every element, using hierarchy of element ranges if evaluated
+				 * and no unnotified changes to search mesh membership */
+				if ((!*element_address) && (meshFieldRanges) && (!meshFieldRanges->getRangesTree().isEmpty())
+					&& (!searchMesh->hasMembershipChanges()))
+				{
+					FE_mesh *feMesh = searchMesh->getFeMesh();
+					// copy of values is used as values may be in field cache
+					FeMeshFieldRangesTree::Search search(meshFieldRanges->getRangesTree(), *meshFieldRanges, find_element_xi_data.values);
+					// no initial limit for find nearest; closest ranges are tried first
+					FE_value searchTolerance = (tolerance >= 0.0) ? tolerance : std::numeric_limits<FE_value>::max();
+					DsLabelIndex elementIndex;
+					while (0 <= (elementIndex = search.next(searchTolerance)))
+					{
+						element = feMesh->getElement(elementIndex);
+						if ((element) && (element != findElementXiCache->element) && searchMesh->containsElement(element))
+						{
+							if (Computed_field_iterative_element_conditional(element, &find_element_xi_data))
+							{
+								*element_address = element;
+								break;
+							}
+							else if (find_element_xi_data.nearest_element == element)
+							{
+								searchTolerance = tolerance = sqrt(find_element_xi_data.nearest_element_distance_squared);
+							}
+						}
+					}
+					// try elements without ranges e.g. field not evaluable over whole element
+					if (!*element_address)
+					{
+						for (const DsLabelIndex unrangedElementIndex : meshFieldRanges->getUnrangedElementIndexes())
+						{
+							element = feMesh->getElement(unrangedElementIndex);
+							if ((element) && (element != findElementXiCache->element) && searchMesh->containsElement(element))
+							{
+								if (Computed_field_iterative_element_conditional(element, &find_element_xi_data))
+								{
+									*element_address = element;
+									break;
+								}
+							}
+						}
+					}
+				}
+				else if (!*element_address)
 				{
 					cmzn_elementiterator *iterator = searchMesh->createElementiterator();
 					while (0 != (element = cmzn_elementiterator_next_non_access(iterator)))
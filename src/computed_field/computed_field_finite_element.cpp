@@ -10,8 +10,8 @@
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include <cassert>
+#include <climits>
 #include <cmath>
-#include <map>
 #include "cmlibs/zinc/fieldmodule.h"
 #include "cmlibs/zinc/fieldfiniteelement.h"
 #include "cmlibs/zinc/mesh.h"
@@ -32,6 +32,7 @@
 #include "finite_element/finite_element_region.h"
 #include "finite_element/finite_element_region_private.h"
 #include "finite_element/finite_element_time.h"
+#include "general/block_array.hpp"
 #include "general/debug.h"
 #include "general/enumerator_private.hpp"
 #include "general/mystring.h"
@@ -59,17 +60,178 @@ Module types
 
 namespace {
 
-typedef std::map<cmzn_element *, FE_element_field_evaluation *> FE_element_field_evaluation_map;
-
 const int maxCachedTimes = 3;
 
+// default maximum number of element field evaluations cached per mesh and time
+const int defaultElementFieldEvaluationCapacity = 1000;
+
+/**
+ * Least-recently-used cache of FE_element_field_evaluation for elements of a
+ * single mesh, addressed by element index.
+ */
+class MeshElementFieldEvaluationCache
+{
+	struct Entry
+	{
+		FE_element_field_evaluation *elementFieldEvaluation;  // accessed
+		DsLabelIndex elementIndex;
+		int moreRecent;  // slot of next more recently used entry, or -1 if most recent
+		int lessRecent;  // slot of next less recently used entry, or -1 if least recent
+	};
+
+	const FE_mesh *feMesh;  // not accessed
+	block_array<DsLabelIndex, int> elementSlots;  // map element index -> slot in entries, or -1 if none
+	std::vector<Entry> entries;
+	int mostRecent;  // slot of most recently used entry, or -1 if empty
+	int leastRecent;  // slot of least recently used entry, or -1 if empty
+
+	void unlink(int slot)
+	{
+		Entry& entry = this->entries[slot];
+		if (entry.moreRecent >= 0)
+			this->entries[entry.moreRecent].lessRecent = entry.lessRecent;
+		else
+			this->mostRecent = entry.lessRecent;
+		if (entry.lessRecent >= 0)
+			this->entries[entry.lessRecent].moreRecent = entry.moreRecent;
+		else
+			this->leastRecent = entry.moreRecent;
+	}
+
+	void linkMostRecent(int slot)
+	{
+		Entry& entry = this->entries[slot];
+		entry.moreRecent = -1;
+		entry.lessRecent = this->mostRecent;
+		if (this->mostRecent >= 0)
+			this->entries[this->mostRecent].moreRecent = slot;
+		else
+			this->leastRecent = slot;
+		this->mostRecent = slot;
+	}
+
+public:
+
+	MeshElementFieldEvaluationCache(const FE_mesh *feMeshIn) :
+		feMesh(feMeshIn),
+		elementSlots(CMZN_BLOCK_ARRAY_DEFAULT_BLOCK_SIZE_BYTES/sizeof(int), /*allocInitValue*/-1),
+		mostRecent(-1),
+		leastRecent(-1)
+	{
+	}
+
+	~MeshElementFieldEvaluationCache()
+	{
+		this->clear();
+	}
+
+	void clear()
+	{
+		for (std::vector<Entry>::iterator iter = this->entries.begin(); iter != this->entries.end(); ++iter)
+		{
+			FE_element_field_evaluation::deaccess(iter->elementFieldEvaluation);
+		}
+		this->entries.clear();
+		this->elementSlots.clear();
+		this->mostRecent = -1;
+		this->leastRecent = -1;
+	}
+
+	const FE_mesh *getFeMesh() const
+	{
+		return this->feMesh;
+	}
+
+	int getSize() const
+	{
+		return static_cast<int>(this->entries.size());
+	}
+
+	/** @return  Non-accessed evaluation for element index, made most recently used, or nullptr if none. */
+	FE_element_field_evaluation *find(DsLabelIndex elementIndex)
+	{
+		const int slot = this->elementSlots.getValue(elementIndex);
+		if (slot < 0)
+		{
+			return nullptr;
+		}
+		if (slot != this->mostRecent)
+		{
+			this->unlink(slot);
+			this->linkMostRecent(slot);
+		}
+		return this->entries[slot].elementFieldEvaluation;
+	}
+
+	/** Add evaluation for element index not already in cache, taking ownership
+	 * of its access count. Evicts least recently used entries to stay within capacity. */
+	void add(DsLabelIndex elementIndex, FE_element_field_evaluation *elementFieldEvaluation, int capacity)
+	{
+		while ((0 < this->getSize()) && (capacity <= this->getSize()))
+		{
+			this->remove(this->entries[this->leastRecent].elementIndex);
+		}
+		const int slot = this->getSize();
+		const Entry entry = { elementFieldEvaluation, elementIndex, -1, -1 };
+		this->entries.push_back(entry);
+		this->elementSlots.setValue(elementIndex, slot);
+		this->linkMostRecent(slot);
+	}
+
+	/** Remove and deaccess evaluation for element index, if any */
+	void remove(DsLabelIndex elementIndex)
+	{
+		const int slot = this->elementSlots.getValue(elementIndex);
+		if (slot < 0)
+		{
+			return;
+		}
+		this->unlink(slot);
+		FE_element_field_evaluation::deaccess(this->entries[slot].elementFieldEvaluation);
+		this->elementSlots.setValue(elementIndex, -1);
+		// keep entries contiguous by moving last entry into freed slot
+		const int lastSlot = this->getSize() - 1;
+		if (slot != lastSlot)
+		{
+			this->entries[slot] = this->entries[lastSlot];
+			Entry& entry = this->entries[slot];
+			if (entry.moreRecent >= 0)
+				this->entries[entry.moreRecent].lessRecent = slot;
+			else
+				this->mostRecent = slot;
+			if (entry.lessRecent >= 0)
+				this->entries[entry.lessRecent].moreRecent = slot;
+			else
+				this->leastRecent = slot;
+			this->elementSlots.setValue(entry.elementIndex, slot);
+		}
+		this->entries.pop_back();
+	}
+
+};
+
 class TimeElementFieldEvaluationMap
 {
 	FE_field *feField;
 	FE_value time;
-	FE_element_field_evaluation_map elementFieldEvaluationMap;
+	std::vector<MeshElementFieldEvaluationCache *> meshCaches;  // one per mesh evaluated on
 	FE_element_field_evaluation *elementFieldEvaluation;  // evalution object for latest element
 
+	MeshElementFieldEvaluationCache *getMeshCache(const FE_mesh *feMesh)
+	{
+		for (std::vector<MeshElementFieldEvaluationCache *>::iterator iter = this->meshCaches.begin();
+			iter != this->meshCaches.end(); ++iter)
+		{
+			if ((*iter)->getFeMesh() == feMesh)
+			{
+				return *iter;
+			}
+		}
+		MeshElementFieldEvaluationCache *meshCache = new MeshElementFieldEvaluationCache(feMesh);
+		this->meshCaches.push_back(meshCache);
+		return meshCache;
+	}
+
 public:
 
 	TimeElementFieldEvaluationMap(FE_field *feFieldIn, FE_value timeIn) :
@@ -82,16 +244,20 @@ public:
 	~TimeElementFieldEvaluationMap()
 	{
 		this->clear();
+		for (std::vector<MeshElementFieldEvaluationCache *>::iterator iter = this->meshCaches.begin();
+			iter != this->meshCaches.end(); ++iter)
+		{
+			delete *iter;
+		}
 	}
 
 	void clear()
 	{
-		for (FE_element_field_evaluation_map::iterator iter = this->elementFieldEvaluationMap.begin();
-			iter != this->elementFieldEvaluationMap.end(); ++iter)
+		for (std::vector<MeshElementFieldEvaluationCache *>::iterator iter = this->meshCaches.begin();
+			iter != this->meshCaches.end(); ++iter)
 		{
-			FE_element_field_evaluation::deaccess(iter->second);
+			(*iter)->clear();
 		}
-		this->elementFieldEvaluationMap.clear();
 		// Following was a pointer to an object just destroyed, so must clear
 		this->elementFieldEvaluation = nullptr;
 	}
@@ -105,59 +271,72 @@ public:
 	 * element at time, inherited from optional topLevelElement. Uses existing
 	 * values in cache if nothing changed. Caller must have ensured time match
 	 * with this object and that arguments are valid.
+	 * @param capacity  Maximum number of evaluations to cache per mesh.
+	 * @param hit  Set to true if existing evaluation was used, false if calculated.
 	 * @return  Non-accessed FE_element_field_evaluation* or nullptr if failed.
 	 */
 	FE_element_field_evaluation *getElementFieldEvaluation(
-		cmzn_element *element, cmzn_element *topLevelElement)
+		cmzn_element *element, cmzn_element *topLevelElement, int capacity, bool& hit)
 	{
 		// can't trust cached element field values if between manager begin/end change
 		// and this field has been modified.
 		const bool fieldChanged = FE_field_has_cached_changes(this->feField);
+		hit = true;
 		// ensure we have FE_element_field_evaluation calculated for element
 		// with derivatives_calculated if requested
 		if ((!this->elementFieldEvaluation) || fieldChanged ||
 			(!this->elementFieldEvaluation->isForElement(element, topLevelElement)))
 		{
+			const DsLabelIndex elementIndex = element->getIndex();
+			const FE_mesh *feMesh = element->getMesh();
+			if ((elementIndex < 0) || (!feMesh))
+			{
+				// element has been destroyed
+				hit = false;
+				this->elementFieldEvaluation = nullptr;
+				return nullptr;
+			}
+			MeshElementFieldEvaluationCache *meshCache = this->getMeshCache(feMesh);
 			bool needUpdate = false;
 			bool addToCache = false;
-			FE_element_field_evaluation_map::iterator iter = this->elementFieldEvaluationMap.find(element);
-			if (iter == this->elementFieldEvaluationMap.end())
+			this->elementFieldEvaluation = meshCache->find(elementIndex);
+			if (!this->elementFieldEvaluation)
 			{
+				hit = false;
 				this->elementFieldEvaluation = FE_element_field_evaluation::create();
+				if (!this->elementFieldEvaluation)
+				{
+					return nullptr;
+				}
 				addToCache = true;
 				needUpdate = true;
 			}
-			else
+			else if (fieldChanged || (!this->elementFieldEvaluation->isForElement(element, topLevelElement)))
 			{
-				this->elementFieldEvaluation = iter->second;
-				if (fieldChanged || (!this->elementFieldEvaluation->isForElement(element, topLevelElement)))
-				{
-					this->elementFieldEvaluation->clear();
-					needUpdate = true;
-				}
+				// also handles a different element now having this index
+				this->elementFieldEvaluation->clear();
+				needUpdate = true;
 			}
-			if ((this->elementFieldEvaluation) && needUpdate)
+			if (needUpdate)
 			{
+				hit = false;
 				if (this->elementFieldEvaluation->calculate_values(this->feField, element, this->time, topLevelElement))
 				{
 					if (addToCache)
 					{
-						// Set a cache size limit, clearing is a simple way to only cache for recent elements
-						if (1000 < this->elementFieldEvaluationMap.size())
-						{
-							FE_element_field_evaluation* tmpElementFieldEvaluation = this->elementFieldEvaluation;
-							this->clear();
-							this->elementFieldEvaluation = tmpElementFieldEvaluation;
-						}
-						this->elementFieldEvaluationMap[element] = this->elementFieldEvaluation;
+						meshCache->add(elementIndex, this->elementFieldEvaluation, capacity);
 					}
 				}
 				else
 				{
-					FE_element_field_evaluation::deaccess(this->elementFieldEvaluation);
-					if (!addToCache)
+					if (addToCache)
+					{
+						FE_element_field_evaluation::deaccess(this->elementFieldEvaluation);
+					}
+					else
 					{
-						this->elementFieldEvaluationMap.erase(iter);
+						meshCache->remove(elementIndex);
+						this->elementFieldEvaluation = nullptr;
 					}
 				}
 			}
@@ -173,10 +352,16 @@ class FE_element_field_evaluation_cache
 {
 	FE_field *feField;
 	std::vector<TimeElementFieldEvaluationMap*> timeElementFieldEvaluationMaps;
+	int capacity;  // maximum number of element field evaluations cached per mesh and time
+	size_t hitCount;  // number of element field evaluations found in cache
+	size_t missCount;  // number of element field evaluations calculated
 	int access_count;
 
 	FE_element_field_evaluation_cache(FE_field *feFieldIn) :
 		feField(feFieldIn),
+		capacity(defaultElementFieldEvaluationCapacity),
+		hitCount(0),
+		missCount(0),
 		access_count(1)
 	{
 	}
@@ -219,6 +404,34 @@ public:
 		this->timeElementFieldEvaluationMaps.clear();
 	}
 
+	int getCapacity() const
+	{
+		return this->capacity;
+	}
+
+	/** Set maximum number of element field evaluations cached per mesh and
+	 * time. Existing caches are reduced to this size on next addition. */
+	void setCapacity(int capacityIn)
+	{
+		this->capacity = capacityIn;
+	}
+
+	size_t getHitCount() const
+	{
+		return this->hitCount;
+	}
+
+	size_t getMissCount() const
+	{
+		return this->missCount;
+	}
+
+	void resetStatistics()
+	{
+		this->hitCount = 0;
+		this->missCount = 0;
+	}
+
 	TimeElementFieldEvaluationMap *getTimeElementFieldEvaluationMap(FE_value time)
 	{
 		TimeElementFieldEvaluationMap *timeElementFieldEvaluationMap;
@@ -263,7 +476,14 @@ public:
 	{
 		const FE_value useTime = this->feField->isTimeDependent() ? time : 0.0;
 		TimeElementFieldEvaluationMap *timeElementFieldEvaluationMap = this->getTimeElementFieldEvaluationMap(useTime);
-		return timeElementFieldEvaluationMap->getElementFieldEvaluation(element, topLevelElement);
+		bool hit;
+		FE_element_field_evaluation *elementFieldEvaluation =
+			timeElementFieldEvaluationMap->getElementFieldEvaluation(element, topLevelElement, this->capacity, hit);
+		if (hit)
+			++this->hitCount;
+		else
+			++this->missCount;
+		return elementFieldEvaluation;
 	}
 
 };
@@ -473,6 +693,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	virtual int getDerivativeTreeOrder(const FieldDerivative& fieldDerivative)
@@ -985,6 +1208,47 @@ int Computed_field_finite_element::evaluate(cmzn_fieldcache& cache, FieldValueCa
 	return return_code;
 }
 
+/** Gets the element field evaluation once for all locations, then evaluates
+ * directly into values with basis functions kept in indexed cache locations. */
+int Computed_field_finite_element::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	if (this->fe_field->getValueType() != FE_VALUE_VALUE)
+		return Computed_field_core::evaluateRealMeshLocations(cache, element, pointsCount, xi, values);
+	// set first location so cache handles any region modifications
+	cache.setIndexedMeshLocation(0, element, xi);
+	FiniteElementRealFieldValueCache& feValueCache = FiniteElementRealFieldValueCache::cast(*(this->field->getValueCache(cache)));
+	FE_element_field_evaluation *elementFieldEvaluation =
+		feValueCache.element_field_evaluation_cache->getElementFieldEvaluation(element, cache.getTime(), /*topLevelElement*/nullptr);
+	if (!elementFieldEvaluation)
+		return 0;
+	const int dimension = element->getDimension();
+	const int componentsCount = this->field->number_of_components;
+	const FE_value *pointXi = xi;
+	FE_value *pointValues = values;
+	int return_code = 1;
+	for (int p = 0; p < pointsCount; ++p)
+	{
+		const Field_location_element_xi *location = (p == 0) ? cache.get_location_element_xi() :
+			cache.prepareIndexedMeshLocation(static_cast<unsigned int>(p), element, pointXi);
+		if (!elementFieldEvaluation->evaluate_real(/*component_number*/-1, pointXi, location->get_basis_function_evaluation(),
+			/*mesh_derivative_order*/0, /*parameter_derivative_order*/0, pointValues))
+		{
+			return_code = 0;
+			break;
+		}
+		pointXi += dimension;
+		pointValues += componentsCount;
+	}
+	if (pointsCount > 1)
+	{
+		// make last location current, invalidating field values at first location
+		const FE_value *lastXi = xi + (pointsCount - 1)*dimension;
+		cache.setIndexedMeshLocation(static_cast<unsigned int>(pointsCount - 1), element, lastXi);
+	}
+	return return_code;
+}
+
 int Computed_field_finite_element::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	const Field_location_element_xi* meshLocation = cache.get_location_element_xi();
@@ -5018,3 +5282,83 @@ FE_element_field_evaluation *cmzn_field_get_cache_FE_element_field_evaluation(cm
 	const FE_value time = element_xi_location->get_time();
 	return feValueCache->element_field_evaluation_cache->getElementFieldEvaluation(element, time, top_level_element);
 }
+
+namespace {
+
+/** @return  Element field evaluation cache for real finite element field in
+ * fieldcache, or nullptr if invalid arguments. */
+FE_element_field_evaluation_cache *cmzn_field_finite_element_get_element_evaluation_cache(
+	cmzn_field_finite_element_id finite_element_field, cmzn_fieldcache_id cache)
+{
+	if ((finite_element_field) && (cache) &&
+		(cmzn_field_finite_element_core_cast(finite_element_field)->fe_field->getValueType() == FE_VALUE_VALUE))
+	{
+		cmzn_field *field = cmzn_field_finite_element_base_cast(finite_element_field);
+		FiniteElementRealFieldValueCache *feValueCache = FiniteElementRealFieldValueCache::cast(field->getValueCache(*cache));
+		if (feValueCache)
+			return feValueCache->element_field_evaluation_cache;
+	}
+	return nullptr;
+}
+
+inline int clampCountToInt(size_t count)
+{
+	return (count < static_cast<size_t>(INT_MAX)) ? static_cast<int>(count) : INT_MAX;
+}
+
+}
+
+int cmzn_field_finite_element_get_element_evaluation_cache_capacity(
+	cmzn_field_finite_element_id finite_element_field, cmzn_fieldcache_id cache)
+{
+	FE_element_field_evaluation_cache *evaluationCache =
+		cmzn_field_finite_element_get_element_evaluation_cache(finite_element_field, cache);
+	if (evaluationCache)
+		return evaluationCache->getCapacity();
+	display_message(ERROR_MESSAGE, "FieldFiniteElement getElementEvaluationCacheCapacity.  Invalid arguments");
+	return 0;
+}
+
+int cmzn_field_finite_element_set_element_evaluation_cache_capacity(
+	cmzn_field_finite_element_id finite_element_field, cmzn_fieldcache_id cache, int capacity)
+{
+	FE_element_field_evaluation_cache *evaluationCache =
+		cmzn_field_finite_element_get_element_evaluation_cache(finite_element_field, cache);
+	if ((evaluationCache) && (capacity > 0))
+	{
+		evaluationCache->setCapacity(capacity);
+		return CMZN_OK;
+	}
+	display_message(ERROR_MESSAGE, "FieldFiniteElement setElementEvaluationCacheCapacity.  Invalid arguments");
+	return CMZN_ERROR_ARGUMENT;
+}
+
+int cmzn_field_finite_element_get_element_evaluation_cache_statistics(
+	cmzn_field_finite_element_id finite_element_field, cmzn_fieldcache_id cache,
+	int *hit_count_out, int *miss_count_out)
+{
+	FE_element_field_evaluation_cache *evaluationCache =
+		cmzn_field_finite_element_get_element_evaluation_cache(finite_element_field, cache);
+	if ((evaluationCache) && (hit_count_out) && (miss_count_out))
+	{
+		*hit_count_out = clampCountToInt(evaluationCache->getHitCount());
+		*miss_count_out = clampCountToInt(evaluationCache->getMissCount());
+		return CMZN_OK;
+	}
+	display_message(ERROR_MESSAGE, "FieldFiniteElement getElementEvaluationCacheStatistics.  Invalid arguments");
+	return CMZN_ERROR_ARGUMENT;
+}
+
+int cmzn_field_finite_element_reset_element_evaluation_cache_statistics(
+	cmzn_field_finite_element_id finite_element_field, cmzn_fieldcache_id cache)
+{
+	FE_element_field_evaluation_cache *evaluationCache =
+		cmzn_field_finite_element_get_element_evaluation_cache(finite_element_field, cache);
+	if (evaluationCache)
+	{
+		evaluationCache->resetStatistics();
+		return CMZN_OK;
+	}
+	display_message(ERROR_MESSAGE, "FieldFiniteElement resetElementEvaluationCacheStatistics.  Invalid arguments");
+	return CMZN_ERROR_ARGUMENT;
+}
@@ -38,6 +38,7 @@ Computed_field_group::Computed_field_group(cmzn_region *region)
 	: Computed_field_group_base()
 	, containsAllLocal(false)
 	, subelementHandlingMode(CMZN_FIELD_GROUP_SUBELEMENT_HANDLING_MODE_NONE)
+	, conditionalThreadsCount(1)
 	, nodesetGroups{}
 	, meshGroups{}
 	, child_region_group_map()
@@ -1104,6 +1105,21 @@ int cmzn_field_group_set_subelement_handling_mode(cmzn_field_group_id group,
 	return CMZN_ERROR_ARGUMENT;
 }
 
+int cmzn_field_group_get_conditional_threads_count(cmzn_field_group_id group)
+{
+	if (group)
+		return cmzn_field_group_core_cast(group)->getConditionalThreadsCount();
+	return -1;
+}
+
+int cmzn_field_group_set_conditional_threads_count(cmzn_field_group_id group,
+	int threads_count)
+{
+	if (group)
+		return cmzn_field_group_core_cast(group)->setConditionalThreadsCount(threads_count);
+	return CMZN_ERROR_ARGUMENT;
+}
+
 cmzn_field_group_id cmzn_field_group_get_first_non_empty_subregion_field_group(
 	cmzn_field_group_id group)
 {
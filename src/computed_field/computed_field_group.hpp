@@ -92,6 +92,7 @@ private:
 	cmzn_field_hierarchical_group_change_detail change_detail;
 	bool containsAllLocal;
 	cmzn_field_group_subelement_handling_mode subelementHandlingMode;
+	int conditionalThreadsCount;  // runtime setting, not copied
 	cmzn_nodeset_group* nodesetGroups[2];  // 0 == nodes, 1 == datapoints
 	cmzn_mesh_group* meshGroups[MAXIMUM_ELEMENT_XI_DIMENSIONS];
 	Region_field_map child_region_group_map;  // map to accessed FieldGroup in child regions
@@ -241,6 +242,21 @@ public:
 
 	int setSubelementHandlingMode(cmzn_field_group_subelement_handling_mode mode);
 
+	int getConditionalThreadsCount() const
+	{
+		return this->conditionalThreadsCount;
+	}
+
+	/** @param threadsCountIn  Number of threads >= 1, or 0 for all hardware threads.
+	 * @return  Result OK on success, otherwise ERROR_ARGUMENT. */
+	int setConditionalThreadsCount(int threadsCountIn)
+	{
+		if (threadsCountIn < 0)
+			return CMZN_ERROR_ARGUMENT;
+		this->conditionalThreadsCount = threadsCountIn;
+		return CMZN_OK;
+	}
+
 private:
 
 	Computed_field_core* copy()
@@ -1104,6 +1104,63 @@ int Computed_field_is_image_type(struct Computed_field *field,
 	return (return_code);
 } /* Computed_field_has_string_value_type */
 
+int Computed_field_image_get_texel_centre_values(struct Computed_field *field,
+	struct Computed_field *location_field, int dimension, const int *sizes,
+	const int *region_start, const int *region_sizes, double *values)
+{
+	Computed_field_image *core;
+	if (!((field) && (core = dynamic_cast<Computed_field_image*>(field->core)) &&
+		(0 < dimension) && (dimension <= 3) && (sizes) && (values)))
+		return 0;
+	Computed_field *texture_coordinate_field = field->source_fields[0];
+	if (location_field)
+	{
+		if (texture_coordinate_field != location_field)
+			return 0;
+	}
+	else if (!Computed_field_is_type_xi_coordinates(texture_coordinate_field, nullptr))
+		return 0;
+	Texture *texture = core->get_texture();
+	int texture_dimension = 0;
+	if ((!texture) || (!Texture_get_dimension(texture, &texture_dimension)) ||
+		(texture_dimension != dimension) ||
+		(Texture_get_number_of_components(texture) != field->number_of_components))
+		return 0;
+	// texture coordinates at pixel centres must map exactly to texel centres
+	int original_sizes[3], stored_sizes[3];
+	ZnReal physical_sizes[3];
+	if (!(Texture_get_original_size(texture, &original_sizes[0], &original_sizes[1], &original_sizes[2]) &&
+		Texture_get_size(texture, &stored_sizes[0], &stored_sizes[1], &stored_sizes[2]) &&
+		Texture_get_physical_size(texture, &physical_sizes[0], &physical_sizes[1], &physical_sizes[2])))
+		return 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		const int size = (i < dimension) ? sizes[i] : 1;
+		if ((original_sizes[i] != size) || (stored_sizes[i] != size) ||
+			((i < dimension) && (physical_sizes[i] != 1.0)))
+			return 0;
+	}
+	int start[3] = { 0, 0, 0 };
+	int counts[3] = { 1, 1, 1 };
+	for (int i = 0; i < dimension; ++i)
+	{
+		start[i] = (region_start) ? region_start[i] : 0;
+		counts[i] = (region_sizes) ? region_sizes[i] : sizes[i];
+	}
+	if (!Texture_get_texel_values(texture, start, counts, values))
+		return 0;
+	if ((core->minimum != 0.0) || (core->maximum != 1.0))
+	{
+		const double minimum = core->minimum;
+		const double range = core->maximum - core->minimum;
+		const size_t values_count = static_cast<size_t>(field->number_of_components)*
+			counts[0]*counts[1]*counts[2];
+		for (size_t i = 0; i < values_count; ++i)
+			values[i] = minimum + values[i]*range;
+	}
+	return 1;
+}
+
 int cmzn_field_image_set_texture(cmzn_field_image_id image_field,
 		struct Texture *texture)
 {
@@ -47,6 +47,24 @@ texture fields which reference <texture>.
 int Computed_field_is_image_type(struct Computed_field *field,
 	void *dummy_void);
 
+/**
+ * Get the values of an image field at the centres of a region of its texels
+ * without sampling the texture at each one. Only possible if the texture
+ * coordinate field of the image is the location field, or the xi coordinates
+ * field if none, and texel centres are at texture coordinates
+ * (i + 0.5)/size, i.e. texture sizes equal sizes and physical sizes are 1.
+ * @param location_field  Field texture coordinates are set on, or NULL if
+ * they are element xi.
+ * @param region_start, region_sizes  Optional first texel index and number
+ * of texels in each dimension of region, or NULL for all texels.
+ * @param values  Array to receive values for each texel in region, x index
+ * varying fastest, with number of components of field for each texel.
+ * @return  1 if values obtained, 0 if field must be evaluated at each pixel.
+ */
+int Computed_field_image_get_texel_centre_values(struct Computed_field *field,
+	struct Computed_field *location_field, int dimension, const int *sizes,
+	const int *region_start, const int *region_sizes, double *values);
+
 int cmzn_field_image_set_texture(cmzn_field_image_id image_field,
 		struct Texture *texture);
 
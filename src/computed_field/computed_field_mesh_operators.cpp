@@ -8,8 +8,11 @@
 * This Source Code Form is subject to the terms of the Mozilla Public
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <vector>
 #include "computed_field/computed_field_private.hpp"
 #include "computed_field/computed_field_mesh_operators.hpp"
 #include "computed_field/field_module.hpp"
@@ -23,6 +26,7 @@
 #include "general/debug.h"
 #include "general/mystring.h"
 #include "general/message.h"
+#include "general/thread_pool.hpp"
 #include "finite_element/finite_element_mesh.hpp"
 #include "finite_element/finite_element_region.h"
 
@@ -33,6 +37,10 @@ class MeshIntegralRealFieldValueCache : public RealFieldValueCache
 {
 public:
 	IntegrationPointsCache integrationCache;
+	// independent field cache and integration points cache for each worker
+	// thread in threaded evaluation, created on demand
+	std::vector<cmzn_fieldcache *> workerCaches;
+	std::vector<IntegrationPointsCache *> workerIntegrationCaches;
 
 	MeshIntegralRealFieldValueCache(int componentCountIn, cmzn_element_quadrature_rule quadratureRuleIn,
 		int numbersOfPointsCountIn, const int *numbersOfPointsIn) :
@@ -41,6 +49,36 @@ public:
 	{
 	}
 
+	virtual ~MeshIntegralRealFieldValueCache()
+	{
+		for (size_t w = 0; w < this->workerCaches.size(); ++w)
+		{
+			cmzn_fieldcache::deaccess(this->workerCaches[w]);
+			delete this->workerIntegrationCaches[w];
+		}
+	}
+
+	/** Ensure there are at least workersCount worker caches, all set to the
+	 * supplied quadrature. Not thread safe: call before starting workers.
+	 * @return  True on success, false if failed to create caches. */
+	bool prepareWorkers(int workersCount, cmzn_region *region, cmzn_element_quadrature_rule quadratureRule,
+		int numbersOfPointsCount, const int *numbersOfPoints)
+	{
+		while (static_cast<int>(this->workerCaches.size()) < workersCount)
+		{
+			// no parent cache so finite element evaluation caches are not shared between workers
+			cmzn_fieldcache *workerCache = cmzn_fieldcache::create(region);
+			if (!workerCache)
+				return false;
+			this->workerCaches.push_back(workerCache);
+			this->workerIntegrationCaches.push_back(new IntegrationPointsCache(
+				quadratureRule, numbersOfPointsCount, numbersOfPoints));
+		}
+		for (int w = 0; w < workersCount; ++w)
+			this->workerIntegrationCaches[w]->setQuadrature(quadratureRule, numbersOfPointsCount, numbersOfPoints);
+		return true;
+	}
+
 	static MeshIntegralRealFieldValueCache* cast(FieldValueCache* valueCache)
 	{
 		return FIELD_VALUE_CACHE_CAST<MeshIntegralRealFieldValueCache*>(valueCache);
@@ -62,12 +100,14 @@ protected:
 	cmzn_mesh_id mesh;
 	cmzn_element_quadrature_rule quadratureRule;
 	std::vector<int> numbersOfPoints;
+	int threadsCount;  // number of threads to evaluate with, or 0 to use all hardware threads
 
 public:
 	Computed_field_mesh_integral(cmzn_mesh_id meshIn) :
 		Computed_field_core(),
 		mesh(cmzn_mesh_access(meshIn)),
-		quadratureRule(CMZN_ELEMENT_QUADRATURE_RULE_GAUSSIAN)
+		quadratureRule(CMZN_ELEMENT_QUADRATURE_RULE_GAUSSIAN),
+		threadsCount(1)
 	{
 		numbersOfPoints.push_back(1);
 	}
@@ -207,6 +247,23 @@ public:
 		return CMZN_ERROR_ARGUMENT;
 	}
 
+	int getThreadsCount() const
+	{
+		return this->threadsCount;
+	}
+
+	/** Set number of threads to evaluate with. Not a change to the field
+	 * definition, so no change notification is sent.
+	 * @param threadsCountIn  Number of threads >= 1, or 0 to use all hardware threads.
+	 * @return  Result OK on success, ERROR_ARGUMENT if invalid count. */
+	int setThreadsCount(int threadsCountIn)
+	{
+		if (threadsCountIn < 0)
+			return CMZN_ERROR_ARGUMENT;
+		this->threadsCount = threadsCountIn;
+		return CMZN_OK;
+	}
+
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
@@ -229,6 +286,27 @@ protected:
 	/** @param element_xi_location  If set, evaluate only at the supplied element */
 	template <class ProcessTerm> int evaluateTerms(ProcessTerm &processTerm,
 		MeshIntegralRealFieldValueCache &valueCache, const Field_location_element_xi *element_xi_location);
+
+	/** @return  Number of threads to use in threaded evaluation, or 1 if
+	 * evaluation must be serial. */
+	int getEvaluationThreadsCount() const;
+
+	/** Evaluate sum of integral terms with multiple threads from the shared
+	 * thread pool, each with its own field cache and integration points cache. Work is divided into chunks
+	 * independent of the number of threads, each summed into its own buffer,
+	 * then chunk sums are added in order so results are deterministic.
+	 * SumTerm is constructed with arguments (meshIntegral, parentCache,
+	 * workingCache, values, termArgs...) and must zero its values.
+	 * @param element_xi_location  If set, integrate over the supplied element
+	 * only, with chunks over its integration points, otherwise integrate over
+	 * the whole mesh with chunks of elements.
+	 * @param valuesCount  Number of values summed.
+	 * @param values  Array of valuesCount values to receive sums.
+	 * @return  1 on success, 0 on failure. */
+	template <class SumTerm, typename... TermArgs> int evaluateSumTermsThreaded(
+		cmzn_fieldcache& parentCache, MeshIntegralRealFieldValueCache& valueCache,
+		const Field_location_element_xi *element_xi_location, int threadsCountIn,
+		int valuesCount, FE_value *values, TermArgs&... termArgs);
 };
 
 template <class ProcessTerm> int Computed_field_mesh_integral::evaluateTerms(ProcessTerm &processTerm,
@@ -283,11 +361,12 @@ protected:
 	unsigned int point_index;  // point index within element
 
 public:
-	IntegralTermBase(Computed_field_mesh_integral& meshIntegralIn, cmzn_fieldcache& parentCache, MeshIntegralRealFieldValueCache& valueCache) :
+	/** @param workingCache  Cache to evaluate integrand and coordinates in at time of parentCache */
+	IntegralTermBase(Computed_field_mesh_integral& meshIntegralIn, cmzn_fieldcache& parentCache, cmzn_fieldcache& workingCache) :
 		meshIntegral(meshIntegralIn),
 		dimension(cmzn_mesh_get_dimension(meshIntegral.getMesh())),
 		componentCount(meshIntegralIn.getField()->number_of_components),
-		cache(*(valueCache.getExtraCache())),
+		cache(workingCache),
 		integrandField(meshIntegral.getSourceField(0)),
 		coordinateField(meshIntegral.getSourceField(1)),
 		coordinatesCount(coordinateField->number_of_components),
@@ -364,15 +443,165 @@ public:
 	}
 };
 
+/** Wrapper passing on only integration points with index in range
+ * [pointsBegin, pointsEnd) in each element to the wrapped term */
+template <class ProcessTerm> class IntegralTermPointRange
+{
+	ProcessTerm& term;
+	const int pointsBegin;
+	const int pointsEnd;
+	int pointIndex;
+
+public:
+	IntegralTermPointRange(ProcessTerm& termIn, int pointsBeginIn, int pointsEndIn) :
+		term(termIn),
+		pointsBegin(pointsBeginIn),
+		pointsEnd(pointsEndIn),
+		pointIndex(0)
+	{
+	}
+
+	void setElement(cmzn_element *elementIn)
+	{
+		this->term.setElement(elementIn);
+		this->pointIndex = 0;
+	}
+
+	inline bool operator()(FE_value *xi, FE_value weight)
+	{
+		const int index = (this->pointIndex)++;
+		if (index < this->pointsBegin)
+			return true;
+		if (index >= this->pointsEnd)
+			return false;  // stop iterating
+		return this->term(xi, weight);
+	}
+
+	static inline bool invoke(void *termVoid, FE_value *xi, FE_value weight)
+	{
+		return (*(reinterpret_cast<IntegralTermPointRange<ProcessTerm>*>(termVoid)))(xi, weight);
+	}
+};
+
+// Number of elements per chunk of work in threaded mesh integration
+const size_t meshIntegralElementsPerChunk = 16;
+// Number of integration points per chunk of work in threaded single element integration
+const int meshIntegralPointsPerChunk = 8;
+
+int Computed_field_mesh_integral::getEvaluationThreadsCount() const
+{
+	int evaluationThreadsCount = ThreadPool::resolveThreadsCount(this->threadsCount);
+	// argument fields are bound in parent caches which are not visible to worker caches
+	if ((evaluationThreadsCount > 1) &&
+		(this->getSourceField(0)->dependsOnArgument() || this->getSourceField(1)->dependsOnArgument()))
+		evaluationThreadsCount = 1;
+	return evaluationThreadsCount;
+}
+
+template <class SumTerm, typename... TermArgs> int Computed_field_mesh_integral::evaluateSumTermsThreaded(
+	cmzn_fieldcache& parentCache, MeshIntegralRealFieldValueCache& valueCache,
+	const Field_location_element_xi *element_xi_location, int threadsCountIn,
+	int valuesCount, FE_value *values, TermArgs&... termArgs)
+{
+	// elements and integration point range in each chunk of work
+	struct Chunk
+	{
+		size_t elementsBegin, elementsEnd;
+		int pointsBegin, pointsEnd;
+	};
+	std::vector<cmzn_element *> elements;  // not accessed; mesh must not change while evaluating
+	std::vector<Chunk> chunks;
+	if (element_xi_location)
+	{
+		cmzn_element *element = element_xi_location->get_element();
+		if (this->getMesh()->containsElement(element))
+		{
+			valueCache.integrationCache.setQuadrature(this->quadratureRule,
+				static_cast<int>(this->numbersOfPoints.size()), this->numbersOfPoints.data());
+			IntegrationShapePoints *shapePoints = valueCache.integrationCache.getPoints(element);
+			if (!shapePoints)
+				return 0;
+			elements.push_back(element);
+			const int pointsCount = shapePoints->getNumPoints();
+			for (int p = 0; p < pointsCount; p += meshIntegralPointsPerChunk)
+				chunks.push_back({ 0, 1, p, std::min(p + meshIntegralPointsPerChunk, pointsCount) });
+		}
+	}
+	else
+	{
+		cmzn_elementiterator *iterator = cmzn_mesh_create_elementiterator(this->mesh);
+		cmzn_element *element;
+		while ((element = iterator->nextElement()))
+			elements.push_back(element);
+		cmzn_elementiterator_destroy(&iterator);
+		const size_t elementsCount = elements.size();
+		for (size_t e = 0; e < elementsCount; e += meshIntegralElementsPerChunk)
+			chunks.push_back({ e, std::min(e + meshIntegralElementsPerChunk, elementsCount), 0, std::numeric_limits<int>::max() });
+	}
+	const size_t chunksCount = chunks.size();
+	if (chunksCount == 0)
+	{
+		for (int i = 0; i < valuesCount; ++i)
+			values[i] = 0.0;
+		return 1;
+	}
+	const int workersCount = static_cast<int>(std::min(static_cast<size_t>(threadsCountIn), chunksCount));
+	if (!valueCache.prepareWorkers(workersCount, parentCache.getRegion(), this->quadratureRule,
+		static_cast<int>(this->numbersOfPoints.size()), this->numbersOfPoints.data()))
+	{
+		display_message(ERROR_MESSAGE, "FieldMeshIntegral evaluate.  Failed to create worker caches");
+		return 0;
+	}
+	std::vector<FE_value> chunkValues(chunksCount*valuesCount);
+	// sum chunk c into its own values with worker caches
+	auto evaluateChunk = [&](int workerIndex, size_t c)
+	{
+		const Chunk& chunk = chunks[c];
+		SumTerm term(*this, parentCache, *(valueCache.workerCaches[workerIndex]),
+			chunkValues.data() + c*valuesCount, termArgs...);
+		IntegralTermPointRange<SumTerm> rangeTerm(term, chunk.pointsBegin, chunk.pointsEnd);
+		IntegrationPointsCache& workerIntegrationCache = *(valueCache.workerIntegrationCaches[workerIndex]);
+		for (size_t e = chunk.elementsBegin; e < chunk.elementsEnd; ++e)
+		{
+			IntegrationShapePoints *shapePoints = workerIntegrationCache.getPoints(elements[e]);
+			if (!shapePoints)
+				return false;
+			rangeTerm.setElement(elements[e]);
+			shapePoints->forEachPoint(rangeTerm);
+		}
+		return true;
+	};
+	// evaluate first chunk in this thread so objects created on demand on first
+	// evaluation (field derivatives etc.) exist before workers start
+	if (!evaluateChunk(0, 0))
+		return 0;
+	// pool threads persist between evaluations; any worker shares out remaining chunks
+	if (!ThreadPool::getShared().executeChunks(workersCount, chunksCount - 1,
+		[&](int workerIndex, size_t c) { return evaluateChunk(workerIndex, c + 1); }))
+		return 0;
+	// add chunk sums in order for result independent of threads count
+	const FE_value *chunkValue = chunkValues.data();
+	for (int i = 0; i < valuesCount; ++i)
+		values[i] = chunkValue[i];
+	for (size_t c = 1; c < chunksCount; ++c)
+	{
+		chunkValue += valuesCount;
+		for (int i = 0; i < valuesCount; ++i)
+			values[i] += chunkValue[i];
+	}
+	return 1;
+}
+
 class IntegralTermSum : public IntegralTermBase
 {
 	FE_value *values;
 
 public:
+	/** @param valuesIn  Array of componentCount values to sum into; zeroed here */
 	IntegralTermSum(Computed_field_mesh_integral& meshIntegralIn,
-			cmzn_fieldcache& parentCache, MeshIntegralRealFieldValueCache& valueCache) :
-		IntegralTermBase(meshIntegralIn, parentCache, valueCache),
-		values(valueCache.values)
+			cmzn_fieldcache& parentCache, cmzn_fieldcache& workingCache, FE_value *valuesIn) :
+		IntegralTermBase(meshIntegralIn, parentCache, workingCache),
+		values(valuesIn)
 	{
 		for (int i = 0; i < componentCount; i++)
 			values[i] = 0;
@@ -400,24 +629,36 @@ public:
 int Computed_field_mesh_integral::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache)
 {
 	MeshIntegralRealFieldValueCache& valueCache = MeshIntegralRealFieldValueCache::cast(inValueCache);
-	IntegralTermSum sumTerms(*this, cache, valueCache);
-	return this->evaluateTerms(sumTerms, valueCache, cache.get_location_element_xi());
+	const Field_location_element_xi *element_xi_location = cache.get_location_element_xi();
+	if (!element_xi_location)
+	{
+		const int evaluationThreadsCount = this->getEvaluationThreadsCount();
+		if (evaluationThreadsCount > 1)
+			return this->evaluateSumTermsThreaded<IntegralTermSum>(cache, valueCache, element_xi_location,
+				evaluationThreadsCount, this->field->number_of_components, valueCache.values);
+	}
+	IntegralTermSum sumTerms(*this, cache, *(valueCache.getExtraCache()), valueCache.values);
+	return this->evaluateTerms(sumTerms, valueCache, element_xi_location);
 }
 
 class IntegralTermSumDerivatives : public IntegralTermBase
 {
+	FE_value *derivatives;
 	const FieldDerivative& fieldDerivative;
-	DerivativeValueCache *derivativeValueCache;
+	const int valueCount;
 
 public:
+	/** @param derivativesIn  Array of derivatives to sum into, size valueCountIn; zeroed here */
 	IntegralTermSumDerivatives(Computed_field_mesh_integral& meshIntegralIn,
-		cmzn_fieldcache& parentCache, MeshIntegralRealFieldValueCache& valueCache,
-		const FieldDerivative& fieldDerivativeIn, DerivativeValueCache *derivativeValueCacheIn) :
-		IntegralTermBase(meshIntegralIn, parentCache, valueCache),
+		cmzn_fieldcache& parentCache, cmzn_fieldcache& workingCache, FE_value *derivativesIn,
+		const FieldDerivative& fieldDerivativeIn, int valueCountIn) :
+		IntegralTermBase(meshIntegralIn, parentCache, workingCache),
+		derivatives(derivativesIn),
 		fieldDerivative(fieldDerivativeIn),
-		derivativeValueCache(derivativeValueCacheIn)
+		valueCount(valueCountIn)
 	{
-		this->derivativeValueCache->zeroValues();
+		for (int i = 0; i < this->valueCount; ++i)
+			this->derivatives[i] = 0.0;
 	}
 
 	inline bool operator()(FE_value *xi, FE_value weight)
@@ -428,10 +669,8 @@ public:
 			return false;
 		const FE_value *integrandDerivatives = integrandDerivativeValueCache->values;
 		const FE_value weight_dLAV = weight*dLAV;
-		FE_value *derivatives = this->derivativeValueCache->values;
-		const int valueCount = this->derivativeValueCache->getValueCount();
-		for (int i = 0; i < valueCount; ++i)
-			derivatives[i] += integrandDerivatives[i]*weight_dLAV;
+		for (int i = 0; i < this->valueCount; ++i)
+			this->derivatives[i] += integrandDerivatives[i]*weight_dLAV;
 		return true;
 	}
 
@@ -452,7 +691,13 @@ int Computed_field_mesh_integral::evaluateDerivative(cmzn_fieldcache& cache, Rea
 	if (coordinateOrder > 0)
 		return this->evaluateDerivativeFiniteDifference(cache, inValueCache, fieldDerivative);
 	DerivativeValueCache *derivativeValueCache = inValueCache.getDerivativeValueCache(fieldDerivative);
-	IntegralTermSumDerivatives sumDerivatives(*this, cache, valueCache, fieldDerivative, derivativeValueCache);
+	const int valueCount = derivativeValueCache->getValueCount();
+	const int evaluationThreadsCount = this->getEvaluationThreadsCount();
+	if (evaluationThreadsCount > 1)
+		return this->evaluateSumTermsThreaded<IntegralTermSumDerivatives>(cache, valueCache, element_xi_location,
+			evaluationThreadsCount, valueCount, derivativeValueCache->values, fieldDerivative, valueCount);
+	IntegralTermSumDerivatives sumDerivatives(*this, cache, *(valueCache.getExtraCache()),
+		derivativeValueCache->values, fieldDerivative, valueCount);
 	return this->evaluateTerms(sumDerivatives, valueCache, element_xi_location);
 }
 
@@ -613,9 +858,9 @@ class IntegralTermAppendSquares : public IntegralTermBase
 
 public:
 	IntegralTermAppendSquares(Computed_field_mesh_integral& meshIntegralIn,
-			cmzn_fieldcache& parentCache, MeshIntegralRealFieldValueCache& valueCache,
+			cmzn_fieldcache& parentCache, cmzn_fieldcache& workingCache,
 			int termValuesCountIn, FE_value *termValuesIn) :
-		IntegralTermBase(meshIntegralIn, parentCache, valueCache),
+		IntegralTermBase(meshIntegralIn, parentCache, workingCache),
 		remainingValuesCount(termValuesCountIn),
 		termValues(termValuesIn)
 	{
@@ -653,7 +898,7 @@ int Computed_field_mesh_integral_squares::evaluate_sum_square_terms(
 	cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, int number_of_values, FE_value *values)
 {
 	MeshIntegralRealFieldValueCache& valueCache = MeshIntegralRealFieldValueCache::cast(inValueCache);
-	IntegralTermAppendSquares appendSquares(*this, cache, valueCache, number_of_values, values);
+	IntegralTermAppendSquares appendSquares(*this, cache, *(valueCache.getExtraCache()), number_of_values, values);
 	int result = this->evaluateTerms(appendSquares, valueCache, /*location_element_xi*/nullptr);  // always integrate over whole mesh
 	if (result && (appendSquares.getRemainingValuesCount() != 0))
 	{
@@ -670,10 +915,11 @@ class IntegralTermSumSquares : public IntegralTermBase
 	FE_value *values;
 
 public:
+	/** @param valuesIn  Array of componentCount values to sum into; zeroed here */
 	IntegralTermSumSquares(Computed_field_mesh_integral& meshIntegralIn,
-			cmzn_fieldcache& parentCache, MeshIntegralRealFieldValueCache& valueCache) :
-		IntegralTermBase(meshIntegralIn, parentCache, valueCache),
-		values(valueCache.values)
+			cmzn_fieldcache& parentCache, cmzn_fieldcache& workingCache, FE_value *valuesIn) :
+		IntegralTermBase(meshIntegralIn, parentCache, workingCache),
+		values(valuesIn)
 	{
 		for (int i = 0; i < componentCount; i++)
 			values[i] = 0;
@@ -701,8 +947,16 @@ public:
 int Computed_field_mesh_integral_squares::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache)
 {
 	MeshIntegralRealFieldValueCache& valueCache = MeshIntegralRealFieldValueCache::cast(inValueCache);
-	IntegralTermSumSquares sumSquares(*this, cache, valueCache);
-	return this->evaluateTerms(sumSquares, valueCache, cache.get_location_element_xi());
+	const Field_location_element_xi *element_xi_location = cache.get_location_element_xi();
+	if (!element_xi_location)
+	{
+		const int evaluationThreadsCount = this->getEvaluationThreadsCount();
+		if (evaluationThreadsCount > 1)
+			return this->evaluateSumTermsThreaded<IntegralTermSumSquares>(cache, valueCache, element_xi_location,
+				evaluationThreadsCount, this->field->number_of_components, valueCache.values);
+	}
+	IntegralTermSumSquares sumSquares(*this, cache, *(valueCache.getExtraCache()), valueCache.values);
+	return this->evaluateTerms(sumSquares, valueCache, element_xi_location);
 }
 
 } // namespace
@@ -826,6 +1080,28 @@ int cmzn_field_mesh_integral_set_element_quadrature_rule(
 	return CMZN_ERROR_ARGUMENT;
 }
 
+int cmzn_field_mesh_integral_get_threads_count(
+	cmzn_field_mesh_integral_id mesh_integral_field)
+{
+	if (mesh_integral_field)
+	{
+		Computed_field_mesh_integral *mesh_integral_core = Computed_field_mesh_integral_core_cast(mesh_integral_field);
+		return mesh_integral_core->getThreadsCount();
+	}
+	return -1;
+}
+
+int cmzn_field_mesh_integral_set_threads_count(
+	cmzn_field_mesh_integral_id mesh_integral_field, int threads_count)
+{
+	if (mesh_integral_field)
+	{
+		Computed_field_mesh_integral *mesh_integral_core = Computed_field_mesh_integral_core_cast(mesh_integral_field);
+		return mesh_integral_core->setThreadsCount(threads_count);
+	}
+	return CMZN_ERROR_ARGUMENT;
+}
+
 cmzn_field_id cmzn_fieldmodule_create_field_mesh_integral_squares(
 	cmzn_fieldmodule_id fieldmodule, cmzn_field_id integrand_field,
 	cmzn_field_id coordinate_field, cmzn_mesh_id mesh)
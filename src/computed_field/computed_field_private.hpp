@@ -29,6 +29,7 @@ Types used only internally to computed fields.
 #include "general/debug.h"
 #include "general/manager_private.h"
 #include "region/cmiss_region.hpp"
+#include <atomic>
 
 /**
  * Base class of type-specific field change details.
@@ -166,6 +167,27 @@ public:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& valueCache) = 0;
 
+	/** Evaluate real field values at many chart locations in one element, in
+	 * order, leaving the cache at the last location. Default implementation
+	 * sets each indexed mesh location in the cache and evaluates the field
+	 * there. Override to evaluate all locations together.
+	 * Caller must ensure field is real-valued and arguments are valid.
+	 * @param pointsCount  Number of locations, > 0.
+	 * @param xi  Chart coordinates for each location in turn.
+	 * @param values  Array to receive all components for each location in turn.
+	 * @return  1 on success, 0 if field not defined at any location. */
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
+	/** Evaluate real source field at many chart locations in one element, for
+	 * use by overrides of evaluateRealMeshLocations. Not bounds checked!
+	 * @param index  Index from 0 to number_of_source_fields - 1
+	 * @param sourceValues  Array to receive all source field components for
+	 * each location in turn.
+	 * @return  1 on success, 0 if source field not defined at any location. */
+	inline int evaluateSourceRealMeshLocations(int index, cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *sourceValues) const;
+
 	/** Override for real-valued fields, or return zero for non-numeric fields */
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative) = 0;
 
@@ -407,7 +429,8 @@ struct cmzn_field
 	/** bit flag attributes. @see Computed_field_attribute_flags. */
 	int attribute_flags;
 
-	int access_count;
+	// atomic as fields may be accessed by concurrent evaluations
+	std::atomic_int access_count;
 
 protected:
 
@@ -762,6 +785,12 @@ inline cmzn_field_id Computed_field_core::getSourceField(int index) const
 	return field->source_fields[index];
 }
 
+inline int Computed_field_core::evaluateSourceRealMeshLocations(int index, cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *sourceValues) const
+{
+	return field->source_fields[index]->core->evaluateRealMeshLocations(cache, element, pointsCount, xi, sourceValues);
+}
+
 /* Only to be used from FIND_BY_IDENTIFIER_IN_INDEXED_LIST_STL function
  * Creates a pseudo object with name identifier suitable for finding
  * objects by identifier with cmzn_set.
@@ -989,31 +1018,32 @@ inline void Computed_field_core::setChanged()
 
 inline void cmzn_field::setChanged()
 {
-	if ((this->manager) && (this->manager->owner))
+	// change is not recorded if refused because region is frozen
+	if ((this->manager) && (this->manager->owner) &&
+		(CMZN_OK == this->manager->owner->setFieldModify()))
 	{
-		this->manager->owner->setFieldModify();
 		MANAGED_OBJECT_CHANGE(cmzn_field)(this, MANAGER_CHANGE_OBJECT_NOT_IDENTIFIER(cmzn_field));
 	}
 }
 
 inline void cmzn_field::setChangedPrivate(MANAGER_CHANGE(cmzn_field) change)
 {
-	if ((this->manager) && (this->manager->owner))
+	if ((this->manager) && (this->manager->owner) &&
+		(CMZN_OK == this->manager->owner->setFieldModify()))
 	{
 		if (this->manager_change_status == MANAGER_CHANGE_NONE(cmzn_field))
 		{
 			ADD_OBJECT_TO_LIST(cmzn_field)(this, this->manager->changed_object_list);
 		}
-		this->manager->owner->setFieldModify();
 		this->manager_change_status |= change;
 	}
 }
 
 inline void cmzn_field::setChangedRelated()
 {
-	if ((this->manager) && (this->manager->owner))
+	if ((this->manager) && (this->manager->owner) &&
+		(CMZN_OK == this->manager->owner->setFieldModify()))
 	{
-		this->manager->owner->setFieldModify();
 		MANAGED_OBJECT_CHANGE(cmzn_field)(this, MANAGER_CHANGE_PARTIAL_RESULT(cmzn_field));
 	}
 }
@@ -9,6 +9,7 @@
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 #include <math.h>
+#include <vector>
 #include "cmlibs/zinc/fieldvectoroperators.h"
 #include "computed_field/computed_field.h"
 #include "computed_field/computed_field_private.hpp"
@@ -594,6 +595,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	virtual int getDerivativeTreeOrder(const FieldDerivative& fieldDerivative)
@@ -625,6 +629,29 @@ int Computed_field_dot_product::evaluate(cmzn_fieldcache& cache, FieldValueCache
 	return 0;
 }
 
+int Computed_field_dot_product::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	const int vectorComponentCount = this->getSourceField(0)->number_of_components;
+	std::vector<FE_value> source1Values(pointsCount*vectorComponentCount);
+	std::vector<FE_value> source2Values(pointsCount*vectorComponentCount);
+	if ((!this->evaluateSourceRealMeshLocations(0, cache, element, pointsCount, xi, source1Values.data())) ||
+		(!this->evaluateSourceRealMeshLocations(1, cache, element, pointsCount, xi, source2Values.data())))
+		return 0;
+	const FE_value *pointSource1Values = source1Values.data();
+	const FE_value *pointSource2Values = source2Values.data();
+	for (int p = 0; p < pointsCount; ++p)
+	{
+		FE_value sum = 0.0;
+		for (int i = 0; i < vectorComponentCount; ++i)
+			sum += pointSource1Values[i]*pointSource2Values[i];
+		values[p] = sum;
+		pointSource1Values += vectorComponentCount;
+		pointSource2Values += vectorComponentCount;
+	}
+	return 1;
+}
+
 int Computed_field_dot_product::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	cmzn_field *sourceField1 = this->getSourceField(0);
@@ -917,6 +944,9 @@ private:
 
 	virtual int evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache);
 
+	virtual int evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+		int pointsCount, const FE_value *xi, FE_value *values);
+
 	virtual int evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative);
 
 	int list();
@@ -944,6 +974,25 @@ int Computed_field_magnitude::evaluate(cmzn_fieldcache& cache, FieldValueCache&
 	return 0;
 }
 
+int Computed_field_magnitude::evaluateRealMeshLocations(cmzn_fieldcache& cache, cmzn_element *element,
+	int pointsCount, const FE_value *xi, FE_value *values)
+{
+	const int vectorComponentCount = getSourceField(0)->number_of_components;
+	std::vector<FE_value> sourceValues(pointsCount*vectorComponentCount);
+	if (!this->evaluateSourceRealMeshLocations(0, cache, element, pointsCount, xi, sourceValues.data()))
+		return 0;
+	const FE_value *pointSourceValues = sourceValues.data();
+	for (int p = 0; p < pointsCount; ++p)
+	{
+		FE_value mag = 0.0;
+		for (int i = 0; i < vectorComponentCount; ++i)
+			mag += pointSourceValues[i]*pointSourceValues[i];
+		values[p] = sqrt(mag);
+		pointSourceValues += vectorComponentCount;
+	}
+	return 1;
+}
+
 int Computed_field_magnitude::evaluateDerivative(cmzn_fieldcache& cache, RealFieldValueCache& inValueCache, const FieldDerivative& fieldDerivative)
 {
 	if (fieldDerivative.getTotalOrder() > 1)
@@ -157,8 +157,7 @@ void cmzn_fieldcache::deaccess(cmzn_fieldcache*& fieldcache)
 {
 	if (fieldcache)
 	{
-		--(fieldcache->access_count);
-		if (fieldcache->access_count <= 0)
+		if (--(fieldcache->access_count) <= 0)
 		{
 			delete fieldcache;
 		}
@@ -215,6 +214,15 @@ int cmzn_fieldcache::setIndexedMeshLocation(unsigned int index,
 {
 	if (!(element && chart_coordinates))
 		return CMZN_ERROR_ARGUMENT;
+	this->location = this->prepareIndexedMeshLocation(index, element, chart_coordinates, top_level_element);
+	this->locationChanged();
+	return CMZN_OK;
+}
+
+Field_location_element_xi *cmzn_fieldcache::prepareIndexedMeshLocation(unsigned int index,
+	cmzn_element *element, const double *chart_coordinates,
+	cmzn_element *top_level_element)
+{
 	Field_location_element_xi *element_xi_location;
 	const FE_value time = this->location->get_time();
 	if (index < this->number_of_indexed_location_element_xi)
@@ -245,9 +253,7 @@ int cmzn_fieldcache::setIndexedMeshLocation(unsigned int index,
 	}
 	element_xi_location->set_element_xi(element, chart_coordinates, top_level_element);
 	element_xi_location->set_time(time);
-	this->location = element_xi_location;
-	this->locationChanged();
-	return CMZN_OK;
+	return element_xi_location;
 }
 
 int cmzn_fieldcache::setFieldReal(cmzn_field *field, int numberOfValues, const double *values)
@@ -20,6 +20,7 @@
 #include "general/debug.h"
 #include "region/cmiss_region.hpp"
 #include "computed_field/field_location.hpp"
+#include <atomic>
 #include <map>
 #include <vector>
 
@@ -279,7 +280,7 @@ typedef std::map<cmzn_region*, cmzn_fieldcache*> RegionFieldcacheMap;
 struct cmzn_fieldcache
 {
 private:
-	cmzn_region *region;  // accessed: not thread safe. Means region is guaranteed to exist.
+	cmzn_region *region;  // accessed: means region is guaranteed to exist. Region access count is atomic so caches can be created by concurrent threads
 	int locationCounter; // incremented whenever domain location changes
 	int modifyCounter; // set to match region when location changes; if region value changes, cache is invalid
 	Field_location_element_xi location_element_xi;
@@ -295,7 +296,7 @@ private:
 	cmzn_fieldcache *sharedWorkingCache;  // optional working cache shared by fields evaluating at the same time value
 	RegionFieldcacheMap sharedExternalWorkingCacheMap;
 	std::list<cmzn_fieldrange *> fieldranges;  // list of field ranges owned by this field cache
-	int access_count;
+	std::atomic_int access_count;
 
 	/** @param parentCacheIn  Optional parent cache this is the sharedWorkingCache of */
 	cmzn_fieldcache(cmzn_region *regionIn, cmzn_fieldcache *parentCacheIn);
@@ -477,6 +478,17 @@ public:
 	int setIndexedMeshLocation(unsigned int index, cmzn_element *element, const double *chart_coordinates,
 		cmzn_element *top_level_element = 0);
 
+	/** Set element and chart coordinates of the indexed mesh location without
+	 * making it the current location, for batch evaluation reusing its basis
+	 * functions. Caller must set a location afterwards before evaluating fields.
+	 * Client must ensure arguments are valid.
+	 * @param index  Index of location starting at 0. Indexes beyond the maximum
+	 * stored share a single location.
+	 * @param topLevelElement  Optional top-level element to inherit fields from
+	 * @return  The location at index. */
+	Field_location_element_xi *prepareIndexedMeshLocation(unsigned int index, cmzn_element *element,
+		const double *chart_coordinates, cmzn_element *top_level_element = 0);
+
 	int setNode(cmzn_node *node)
 	{
 		this->location_node.set_node(node);
@@ -102,8 +102,7 @@ int FieldDerivative::deaccess(FieldDerivative* &field_derivative)
 {
 	if (!field_derivative)
 		return CMZN_ERROR_ARGUMENT;
-	--(field_derivative->access_count);
-	if (field_derivative->access_count <= 0)
+	if (--(field_derivative->access_count) <= 0)
 		delete field_derivative;
 	field_derivative = 0;
 	return CMZN_OK;
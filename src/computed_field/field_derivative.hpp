@@ -16,6 +16,7 @@
 #define __FIELD_DERIVATIVE_HPP__
 
 #include "cmlibs/zinc/types/regionid.h"
+#include <atomic>
 
 class FE_mesh;
 struct cmzn_fieldparameters;
@@ -33,7 +34,7 @@ private:
 	const int meshOrder;  // order of derivatives w.r.t. mesh chart
 	cmzn_fieldparameters *fieldparameters;  // non-accessed as managed by it
 	const int parameterOrder; // order of derivatives w.r.t. field parameters
-	int access_count;
+	std::atomic_int access_count;
 
 	/**
 	 * Note that if mesh and fieldparameters defined, mesh derivative is applied first,
@@ -101,6 +101,9 @@ FieldDerivative *cmzn_fieldparameters::getFieldDerivativeMixed(FE_mesh *mesh, in
 		display_message(ERROR_MESSAGE, "Fieldparameters getFieldDerivativeMixed:  Invalid arguments");
 		return nullptr;
 	}
+	// may be called by concurrent evaluations of a frozen region
+	const std::unique_lock<std::recursive_mutex> lock =
+		cmzn_region::lockSharedObjects(FE_region_get_cmzn_region(mesh->get_FE_region()));
 	const int meshIndex = mesh->getDimension() - 1;
 	if (!this->meshes[meshIndex])
 		this->meshes[meshIndex] = cmzn::Access(mesh);  // so mesh exists while this holds mesh derivatives for it
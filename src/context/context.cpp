@@ -76,6 +76,7 @@ cmzn_context *cmzn_context::create(const char *name)
 cmzn_region *cmzn_context::createRegion()
 {
 	// all regions within context share element shapes and bases
+	const std::lock_guard<std::recursive_mutex> lock(this->regionsMutex);
 	cmzn_region *region = cmzn_region::create(this);
 	if (region)
 		this->allRegions.push_back(region);
@@ -84,6 +85,7 @@ cmzn_region *cmzn_context::createRegion()
 
 void cmzn_context::removeRegion(cmzn_region *region)
 {
+	const std::lock_guard<std::recursive_mutex> lock(this->regionsMutex);
 	std::list<cmzn_region*>::iterator iter = std::find(this->allRegions.begin(), this->allRegions.end(), region);
 	if (iter != this->allRegions.end())
 	{
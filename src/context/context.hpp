@@ -13,6 +13,7 @@
 #define CONTEXT_H
 
 #include <list>
+#include <mutex>
 #include "cmlibs/zinc/context.h"
 #include "cmlibs/zinc/status.h"
 #include "general/message_log.hpp"
@@ -35,6 +36,8 @@ private:
 	struct IO_stream_package *io_stream_package;
 	cmzn_timekeepermodule *timekeepermodule;
 	std::list<cmzn_region *> allRegions; // list of all regions created for context, not accessed
+	// guards creating and removing regions, which may be done by concurrent region reads
+	std::recursive_mutex regionsMutex;
 	cmzn_graphics_module *graphics_module;
 	int access_count;
 
@@ -284,6 +284,7 @@ DsLabelIterator *DsLabels::createLabelIterator(const bool_array<DsLabelIndex> *c
 	DsLabelIterator *iterator = new DsLabelIterator();
 	if (iterator)
 	{
+		std::lock_guard<std::mutex> lock(this->activeIteratorsMutex);
 		iterator->labels = this;
 		iterator->iter = (this->contiguous) ? 0 : new DsLabelIdentifierToIndexMap::ext_iterator(&this->identifierToIndexMap);
 		iterator->condition = condition;
@@ -301,12 +302,16 @@ void DsLabels::removeLabelIterator(DsLabelIterator *iterator) const
 {
 	if (iterator)
 	{
+		std::lock_guard<std::mutex> lock(this->activeIteratorsMutex);
 		if (iterator->previous)
 			iterator->previous->next = iterator->next;
 		else
 			this->activeIterators = iterator->next;
 		if (iterator->next)
 			iterator->next->previous = iterator->previous;
+		// identifier map iterator is also registered with the map
+		delete iterator->iter;
+		iterator->iter = 0;
 		// Following not necessary since only called from ~DsLabelIterator:
 		//iterator->invalidate();
 	}
@@ -314,6 +319,7 @@ void DsLabels::removeLabelIterator(DsLabelIterator *iterator) const
 
 void DsLabels::invalidateLabelIterators()
 {
+	std::lock_guard<std::mutex> lock(this->activeIteratorsMutex);
 	DsLabelIterator *iterator = this->activeIterators;
 	DsLabelIterator *nextIterator;
 	while (iterator)
@@ -327,6 +333,7 @@ void DsLabels::invalidateLabelIterators()
 
 void DsLabels::invalidateLabelIteratorsWithCondition(bool_array<DsLabelIndex> *condition)
 {
+	std::lock_guard<std::mutex> lock(this->activeIteratorsMutex);
 	DsLabelIterator *iterator = this->activeIterators;
 	while (iterator)
 	{
@@ -13,6 +13,7 @@
 #if !defined (CMZN_DATASTORE_LABELS_HPP)
 #define CMZN_DATASTORE_LABELS_HPP
 
+#include <mutex>
 #include <string>
 #include <vector>
 #include "general/block_array.hpp"
@@ -75,6 +76,8 @@ class DsLabels : public cmzn::RefCounted
 	// linked-lists of active iterators, to invalidate when labels set changes
 	// including eventually when defragmenting memory
 	mutable DsLabelIterator *activeIterators;
+	// lock for activeIterators so iterators can be created on multiple threads
+	mutable std::mutex activeIteratorsMutex;
 
 public:
 
@@ -55,15 +55,18 @@ int DsLabelsGroup::addGroup(const DsLabelsGroup& otherGroup)
 	{
 		return CMZN_ERROR_ARGUMENT;
 	}
-	// could be made much faster by getting bool_array to do bitwise OR on raw unsigned ints, but must maintain labelsCount
-	DsLabelIndex index = -1;  // So first increment gives 0 == first valid index
-	while (otherGroup.incrementIndex(index))
+	DsLabelIndex addedCount = 0;
+	const bool success = this->values.unionArray(otherGroup.values, addedCount);
+	if (addedCount > 0)
 	{
-		const int result = this->setIndex(index, true);
-		if ((result != CMZN_OK) && (result != CMZN_ERROR_ALREADY_EXISTS))
-		{
-			return result;
-		}
+		this->labelsCount += addedCount;
+		if (otherGroup.indexLimit > this->indexLimit)
+			this->indexLimit = otherGroup.indexLimit;
+	}
+	if (!success)
+	{
+		display_message(ERROR_MESSAGE, "DsLabelsGroup::addGroup.  Failed to add indexes");
+		return CMZN_ERROR_MEMORY;
 	}
 	return CMZN_OK;
 }
@@ -74,12 +77,21 @@ int DsLabelsGroup::removeGroup(const DsLabelsGroup& otherGroup)
 	{
 		return CMZN_ERROR_ARGUMENT;
 	}
-	// could be made much faster by getting bool_array to do bitwise AND COMPLEMENT on raw unsigned ints, but must maintain labelsCount
-	DsLabelIndex index = -1;  // So first increment gives 0 == first valid index
-	while (otherGroup.incrementIndex(index))
+	DsLabelIndex removedCount = 0;
+	this->values.subtractArray(otherGroup.values, removedCount);
+	this->labelsCount -= removedCount;
+	return CMZN_OK;
+}
+
+int DsLabelsGroup::intersectGroup(const DsLabelsGroup& otherGroup)
+{
+	if (otherGroup.labels != this->labels)
 	{
-		this->setIndex(index, false);
+		return CMZN_ERROR_ARGUMENT;
 	}
+	DsLabelIndex removedCount = 0;
+	this->values.intersectArray(otherGroup.values, removedCount);
+	this->labelsCount -= removedCount;
 	return CMZN_OK;
 }
 
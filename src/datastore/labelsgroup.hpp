@@ -86,6 +86,7 @@ public:
 	}
 
 	/** Add all indexes from other labels group to this.
+	 * Operates on 32 indexes at a time.
 	 * @param otherGroup  Other group for same underlying labels.
 	 * @return  Result OK on success, ERROR_ARGUMENT if other group is not for same
 	 * labels, ERROR_MEMORY if failed to add. */
@@ -97,6 +98,23 @@ public:
 	 * labels. */
 	int removeGroup(const DsLabelsGroup& otherGroup);
 
+	/** Remove indexes from group which are not in otherGroup.
+	 * @param otherGroup  Other group for same underlying labels.
+	 * @return  Result OK on success, ERROR_ARGUMENT if other group is not for same
+	 * labels. */
+	int intersectGroup(const DsLabelsGroup& otherGroup);
+
+	/** Count indexes in both this and otherGroup, 32 indexes at a time.
+	 * @param otherGroup  Other group for same underlying labels.
+	 * @return  Number of indexes in both groups, or 0 if other group is not for
+	 * same labels. */
+	DsLabelIndex getIntersectionSize(const DsLabelsGroup& otherGroup) const
+	{
+		if (otherGroup.labels != this->labels)
+			return 0;
+		return this->values.getIntersectionTrueCount(otherGroup.values);
+	}
+
 	/**
 	 * Set whether index is in the group.
 	 * Be careful that index is for this group's labels.
@@ -401,6 +401,7 @@ void GraphicsJsonIO::ioPointAttributesEntries(Json::Value &graphicsSettings)
 				attributesSettings["GlyphRepeatMode"] = enumString;
 				DEALLOCATE(enumString);
 			}
+			attributesSettings["RenderInstanced"] = pointAttributes.isRenderInstanced();
 			CMLibs::Zinc::Field field = pointAttributes.getLabelField();
 			if (field.isValid())
 			{
@@ -481,6 +482,8 @@ void GraphicsJsonIO::ioPointAttributesEntries(Json::Value &graphicsSettings)
 			if (attributesSettings["GlyphRepeatMode"].isString())
 				pointAttributes.setGlyphRepeatMode(CMLibs::Zinc::Glyph::RepeatModeEnumFromString(
 					attributesSettings["GlyphRepeatMode"].asCString()));
+			if (attributesSettings["RenderInstanced"].isBool())
+				pointAttributes.setRenderInstanced(attributesSettings["RenderInstanced"].asBool());
 			if (attributesSettings["LabelField"].isString())
 				pointAttributes.setLabelField(getFieldByName(graphics,
 					attributesSettings["LabelField"].asCString()));
@@ -623,6 +626,7 @@ void GraphicsJsonIO::ioContoursEntries(Json::Value &graphicsSettings)
 				num = contours.getRangeNumberOfIsovalues();
 				attributesSettings["RangeNumberOfIsovalues"] = num;
 			}
+			attributesSettings["WeldVertices"] = contours.isWeldVertices();
 			graphicsSettings["Contours"] = attributesSettings;
 		}
 		else if (graphicsSettings["Contours"].isObject())
@@ -654,6 +658,8 @@ void GraphicsJsonIO::ioContoursEntries(Json::Value &graphicsSettings)
 					attributesSettings["RangeFirstIsovalue"].asDouble(),
 					attributesSettings["RangeLastIsovalue"].asDouble());
 			}
+			if (attributesSettings["WeldVertices"].isBool())
+				contours.setWeldVertices(attributesSettings["WeldVertices"].asBool());
 		}
 	}
 }
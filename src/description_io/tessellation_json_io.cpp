@@ -39,6 +39,11 @@ void TessellationJsonIO::ioEntries(Json::Value &tessellationSettings)
 			tessellationSettings["RefinementFactors"].append(intValues[i]);
 		}
 		delete[] intValues;
+		const double pixelErrorTolerance = tessellation.getPixelErrorTolerance();
+		if (0.0 < pixelErrorTolerance)
+		{
+			tessellationSettings["PixelErrorTolerance"] = pixelErrorTolerance;
+		}
 	}
 	else
 	{
@@ -50,6 +55,10 @@ void TessellationJsonIO::ioEntries(Json::Value &tessellationSettings)
 		{
 			tessellation.setCircleDivisions(tessellationSettings["CircleDivisions"].asInt());
 		}
+		if (tessellationSettings["PixelErrorTolerance"].isNumeric())
+		{
+			tessellation.setPixelErrorTolerance(tessellationSettings["PixelErrorTolerance"].asDouble());
+		}
 		if (tessellationSettings["MinimumDivisions"].isArray())
 		{
 			int *intValues = new int[tessellationSettings["MinimumDivisions"].size()];
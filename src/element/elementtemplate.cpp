@@ -520,6 +520,8 @@ cmzn_element *cmzn_elementtemplate::createElement(int identifier)
 
 int cmzn_elementtemplate::mergeIntoElement(cmzn_element* element)
 {
+	if (!this->getFeMesh()->getRegion()->checkModifiable("cmzn_element_merge"))
+		return CMZN_ERROR_IN_USE;
 	if (this->validate())
 	{
 		this->beginChange();
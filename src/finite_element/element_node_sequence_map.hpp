@@ -0,0 +1,119 @@
+/**
+ * FILE : element_node_sequence_map.hpp
+ *
+ * Hash map from the nodes used by elements to the element, for matching
+ * faces shared by neighbouring elements.
+ */
+/* Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (ELEMENT_NODE_SEQUENCE_MAP_HPP)
+#define ELEMENT_NODE_SEQUENCE_MAP_HPP
+
+#include "datastore/labels.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Hash map from ascending sequences of node indexes used by the coordinate
+ * field on elements to the index of the element. Elements with the same
+ * nodes are treated as the same face or line. All sequences are stored
+ * contiguously in one array rather than allocated separately.
+ */
+class FE_element_node_sequence_map
+{
+	struct Sequence
+	{
+		size_t offset;  // start of sequence in nodeIndexes
+		int count;
+		size_t hash;
+	};
+
+	struct SequenceHash
+	{
+		size_t operator()(const Sequence& sequence) const
+		{
+			return sequence.hash;
+		}
+	};
+
+	struct SequenceEqual
+	{
+		const std::vector<DsLabelIndex> *nodeIndexes;
+
+		bool operator()(const Sequence& sequence1, const Sequence& sequence2) const
+		{
+			if ((sequence1.hash != sequence2.hash) || (sequence1.count != sequence2.count))
+				return false;
+			const DsLabelIndex *values = this->nodeIndexes->data();
+			return std::equal(values + sequence1.offset, values + sequence1.offset + sequence1.count,
+				values + sequence2.offset);
+		}
+	};
+
+	std::vector<DsLabelIndex> nodeIndexes;
+	std::unordered_map<Sequence, DsLabelIndex, SequenceHash, SequenceEqual> map;
+
+	/** Append sequence to storage. Caller must remove it if not kept. */
+	Sequence appendSequence(const DsLabelIndex *sequenceNodeIndexes, int count, size_t hash)
+	{
+		Sequence sequence = { this->nodeIndexes.size(), count, hash };
+		this->nodeIndexes.insert(this->nodeIndexes.end(), sequenceNodeIndexes, sequenceNodeIndexes + count);
+		return sequence;
+	}
+
+	FE_element_node_sequence_map(const FE_element_node_sequence_map&);  // not implemented
+	FE_element_node_sequence_map& operator=(const FE_element_node_sequence_map&);  // not implemented
+
+public:
+
+	FE_element_node_sequence_map() :
+		map(/*bucket_count*/64, SequenceHash(), SequenceEqual{ &this->nodeIndexes })
+	{
+	}
+
+	/** Hash ascending node indexes; same for any order of calculation. */
+	static size_t hashSequence(const DsLabelIndex *sequenceNodeIndexes, int count)
+	{
+		size_t hash = static_cast<size_t>(count);
+		for (int i = 0; i < count; ++i)
+			hash = (hash ^ static_cast<size_t>(sequenceNodeIndexes[i]))*static_cast<size_t>(1099511628211ULL);
+		return hash;
+	}
+
+	/** Reserve space for expected numbers of sequences and total nodes in them. */
+	void reserve(size_t sequencesCount, size_t nodesCount)
+	{
+		this->map.reserve(sequencesCount);
+		this->nodeIndexes.reserve(nodesCount);
+	}
+
+	/** @return  Index of element with node sequence, or DS_LABEL_INDEX_INVALID if none. */
+	DsLabelIndex find(const DsLabelIndex *sequenceNodeIndexes, int count, size_t hash)
+	{
+		const Sequence sequence = this->appendSequence(sequenceNodeIndexes, count, hash);
+		auto iter = this->map.find(sequence);
+		this->nodeIndexes.resize(sequence.offset);
+		return (iter != this->map.end()) ? iter->second : DS_LABEL_INDEX_INVALID;
+	}
+
+	/** Add node sequence for element if not already in map.
+	 * @return  True if added, false if an element with the sequence is already
+	 * in the map. */
+	bool add(const DsLabelIndex *sequenceNodeIndexes, int count, size_t hash, DsLabelIndex elementIndex)
+	{
+		const Sequence sequence = this->appendSequence(sequenceNodeIndexes, count, hash);
+		if (this->map.emplace(sequence, elementIndex).second)
+			return true;
+		this->nodeIndexes.resize(sequence.offset);
+		return false;
+	}
+
+};
+
+#endif /* !defined (ELEMENT_NODE_SEQUENCE_MAP_HPP) */
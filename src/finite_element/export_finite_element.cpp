@@ -26,6 +26,7 @@
 #include "general/compare.h"
 #include "general/debug.h"
 #include "general/enumerator_private.hpp"
+#include "general/io_stream.h"
 #include "general/list.h"
 #include "general/indexed_list_private.h"
 #include "general/message.h"
@@ -36,6 +37,9 @@
 #include "mesh/nodeset.hpp"
 #include "mesh/nodeset_group.hpp"
 #include "region/cmiss_region_write_info.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -271,6 +275,39 @@ public:
 	}
 };
 
+/**
+ * Write values as a little endian binary value block followed by a new line.
+ * @see IO_STREAM_BINARY_BLOCK_MARKER for block format.
+ * @param StoredType  Type of values in block: double or int32_t.
+ * @param typeCode  Block type IO_STREAM_BINARY_BLOCK_REAL/INT.
+ */
+template <typename StoredType, typename ValueType>
+void write_binary_block(std::ostream& outStream, char typeCode, int count, const ValueType *values)
+{
+	const uint16_t probe = 1;
+	const bool littleEndian = (1 == *reinterpret_cast<const unsigned char *>(&probe));
+	const uint32_t blockCount = static_cast<uint32_t>(count);
+	std::vector<unsigned char> bytes(6 + count*sizeof(StoredType));
+	bytes[0] = static_cast<unsigned char>(IO_STREAM_BINARY_BLOCK_MARKER);
+	bytes[1] = static_cast<unsigned char>(typeCode);
+	for (int b = 0; b < 4; ++b)
+	{
+		bytes[2 + b] = static_cast<unsigned char>((blockCount >> (8*b)) & 0xff);
+	}
+	unsigned char *valueBytes = bytes.data() + 6;
+	for (int i = 0; i < count; ++i, valueBytes += sizeof(StoredType))
+	{
+		const StoredType value = static_cast<StoredType>(values[i]);
+		memcpy(valueBytes, &value, sizeof(StoredType));
+		if (!littleEndian)
+		{
+			std::reverse(valueBytes, valueBytes + sizeof(StoredType));
+		}
+	}
+	outStream.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+	outStream << "\n";
+}
+
 /** Add field to vector, but ensure indexer fields added before any fields they index */
 int FE_field_add_to_vector_indexer_priority(struct FE_field *field, void *field_vector_void)
 {
@@ -449,6 +486,7 @@ class EXWriter
 	std::vector<int> fieldNamesCounters;  // number of times a named field is written
 	FE_write_criterion writeCriterion;
 	cmzn_streaminformation_region_recursion_mode recursionMode;
+	bool binaryValues;  // if true, write arrays of numbers as binary value blocks
 
 	cmzn_region *region;  // not accessed
 	FE_region *feRegion;
@@ -489,6 +527,8 @@ public:
 	 *   limit output to nodes or objects with any or all listed fields defined.
 	 * @param recursionModeIn  Controls whether sub-regions and sub-groups are
 	 *   recursively written.
+	 * @param binaryValuesIn  If true, write node and element values, element
+	 *   nodes and scale factors as binary value blocks, otherwise as text.
 	 */
 	EXWriter(ostream *outStreamIn, cmzn_region *rootRegionIn,
 			const char *groupNameIn, bool singleTimeSetIn, FE_value singleTimeIn,
@@ -496,7 +536,8 @@ public:
 			FE_write_fields_mode writeFieldsModeIn,
 			int fieldNamesCountIn, const char * const *fieldNamesIn,
 			FE_write_criterion writeCriterionIn,
-			cmzn_streaminformation_region_recursion_mode recursionModeIn) :
+			cmzn_streaminformation_region_recursion_mode recursionModeIn,
+			bool binaryValuesIn) :
 		outStream(outStreamIn),
 		rootRegion(rootRegionIn->access()),
 		groupName((groupNameIn) ? duplicate_string(groupNameIn) : nullptr),
@@ -508,6 +549,7 @@ public:
 		fieldNamesCounters(fieldNamesCountIn, 0),
 		writeCriterion(writeCriterionIn),
 		recursionMode(recursionModeIn),
+		binaryValues(binaryValuesIn),
 		region(nullptr),
 		feRegion(nullptr),
 		fieldmodule(nullptr),
@@ -1434,6 +1476,11 @@ bool EXWriter::writeElementFieldComponentValues(cmzn_element *element,
 			display_message(ERROR_MESSAGE, "EXWriter::writeElementFieldComponentValues.  Missing real values");
 			return false;
 		}
+		if (this->binaryValues)
+		{
+			write_binary_block<double>(*this->outStream, IO_STREAM_BINARY_BLOCK_REAL, valueCount, values);
+			break;
+		}
 		char tmpString[100];
 		for (int v = 0; v < valueCount; ++v)
 		{
@@ -1456,6 +1503,11 @@ bool EXWriter::writeElementFieldComponentValues(cmzn_element *element,
 			display_message(ERROR_MESSAGE, "EXWriter::writeElementFieldComponentValues.  Missing int values");
 			return false;
 		}
+		if (this->binaryValues)
+		{
+			write_binary_block<int32_t>(*this->outStream, IO_STREAM_BINARY_BLOCK_INT, valueCount, values);
+			break;
+		}
 		for (int v = 0; v < valueCount; ++v)
 		{
 			(*this->outStream) << " " << values[v];
@@ -1565,6 +1617,7 @@ bool EXWriter::writeElement(cmzn_element *element)
 	{
 		FE_nodeset *nodeset = this->feMesh->getNodeset();
 		(*this->outStream) << " Nodes:\n";
+		std::vector<DsLabelIdentifier> nodeIdentifiers;
 		int index = 0;
 		const FE_element_field_template *eft;
 		while (0 != (eft = this->elementTemplate->headerElementNodePacking.getFirstEftAtIndex(index)))
@@ -1572,23 +1625,25 @@ bool EXWriter::writeElement(cmzn_element *element)
 			const FE_mesh_element_field_template_data *meshEftData = this->feMesh->getElementfieldtemplateData(eft);
 			const int nodeCount = eft->getNumberOfLocalNodes();
 			const DsLabelIndex *nodeIndexes = meshEftData->getElementNodeIndexes(element->getIndex());
-			if (nodeIndexes)
+			for (int n = 0; n < nodeCount; ++n)
 			{
-				for (int n = 0; n < nodeCount; ++n)
-				{
-					(*this->outStream) << " " << nodeset->getNodeIdentifier(nodeIndexes[n]);
-				}
+				nodeIdentifiers.push_back((nodeIndexes) ? nodeset->getNodeIdentifier(nodeIndexes[n]) : -1);
 			}
-			else
+			++index;
+		}
+		const int nodeIdentifiersCount = static_cast<int>(nodeIdentifiers.size());
+		if (this->binaryValues)
+		{
+			write_binary_block<int32_t>(*this->outStream, IO_STREAM_BINARY_BLOCK_INT, nodeIdentifiersCount, nodeIdentifiers.data());
+		}
+		else
+		{
+			for (int n = 0; n < nodeIdentifiersCount; ++n)
 			{
-				for (int n = 0; n < nodeCount; ++n)
-				{
-					(*this->outStream) << " -1";
-				}
+				(*this->outStream) << " " << nodeIdentifiers[n];
 			}
-			++index;
+			(*this->outStream) << "\n";
 		}
-		(*this->outStream) << "\n";
 	}
 
 	// Scale factors: if any scale factor sets being output
@@ -1608,6 +1663,19 @@ bool EXWriter::writeElement(cmzn_element *element)
 			{
 				display_message(WARNING_MESSAGE, "EXWriter::writeElement.  Missing scale factors for element %d", element->getIdentifier());
 			}
+			if (this->binaryValues)
+			{
+				std::vector<FE_value> scaleFactors(scaleFactorCount, 0.0);
+				if (scaleFactorIndexes)
+				{
+					for (int s = 0; s < scaleFactorCount; ++s)
+					{
+						scaleFactors[s] = this->feMesh->getScaleFactor(scaleFactorIndexes[s]);
+					}
+				}
+				write_binary_block<double>(*this->outStream, IO_STREAM_BINARY_BLOCK_REAL, scaleFactorCount, scaleFactors.data());
+				continue;
+			}
 			for (int s = 0; s < scaleFactorCount; ++s)
 			{
 				++scaleFactorNumber;
@@ -1977,6 +2045,14 @@ bool EXWriter::writeNodeFieldValues(cmzn_node *node, FE_field *field)
 						get_FE_field_name(field), c + 1, node->getIdentifier());
 					return false;
 				}
+				if (this->binaryValues)
+				{
+					if (valuesCount)
+					{
+						write_binary_block<double>(*this->outStream, IO_STREAM_BINARY_BLOCK_REAL, valuesCount, values);
+					}
+					continue;
+				}
 				for (int v = 0; v < valuesCount; ++v)
 				{
 					sprintf(tmpString, "%" FE_VALUE_STRING, values[v]);
@@ -2012,6 +2088,14 @@ bool EXWriter::writeNodeFieldValues(cmzn_node *node, FE_field *field)
 						get_FE_field_name(field), c + 1, node->getIdentifier());
 					return false;
 				}
+				if (this->binaryValues)
+				{
+					if (valuesCount)
+					{
+						write_binary_block<int32_t>(*this->outStream, IO_STREAM_BINARY_BLOCK_INT, valuesCount, values);
+					}
+					continue;
+				}
 				for (int v = 0; v < valuesCount; ++v)
 				{
 					(*this->outStream) << " " << values[v];
@@ -2527,6 +2611,8 @@ DEFINE_DEFAULT_ENUMERATOR_FUNCTIONS(FE_write_recursion)
  *   limit output to nodes or objects with any or all listed fields defined.
  * @param recursionMode  Controls whether sub-regions and sub-groups are
  *   recursively written.
+ * @param binaryValues  If true, write node and element values, element nodes
+ *   and scale factors as binary value blocks. Stream must be binary.
  */
 int write_exregion_to_stream(ostream *outStream,
 	struct cmzn_region *rootRegion,
@@ -2536,7 +2622,8 @@ int write_exregion_to_stream(ostream *outStream,
 	FE_write_fields_mode writeFieldsMode,
 	int fieldNamesCount, const char * const *fieldNames,
 	FE_write_criterion writeCriterion,
-	cmzn_streaminformation_region_recursion_mode recursionMode)
+	cmzn_streaminformation_region_recursion_mode recursionMode,
+	bool binaryValues)
 {
 	int return_code = 1;
 	if (outStream && rootRegion && region &&
@@ -2545,7 +2632,7 @@ int write_exregion_to_stream(ostream *outStream,
 	{
 		EXWriter exWriter(outStream, rootRegion, groupName, timeSet, time,
 			writeDomainTypes, writeFieldsMode, fieldNamesCount, fieldNames,
-			writeCriterion, recursionMode);
+			writeCriterion, recursionMode, binaryValues);
 		return_code = exWriter.write(region);
 	}
 	else
@@ -2566,18 +2653,19 @@ int write_exregion_file_of_name(
 	FE_write_fields_mode writeFieldsMode,
 	int fieldNamesCount, const char * const *fieldNames,
 	FE_write_criterion writeCriterion,
-	cmzn_streaminformation_region_recursion_mode recursionMode)
+	cmzn_streaminformation_region_recursion_mode recursionMode,
+	bool binaryValues)
 {
 	int return_code = 1;
 	if (fileName)
 	{
 		ofstream fileStream;
-		fileStream.open(fileName, ios::out);
+		fileStream.open(fileName, (binaryValues) ? (ios::out | ios::binary) : ios::out);
 		if (fileStream.is_open())
 		{
 			return_code = write_exregion_to_stream(&fileStream, rootRegion, region, groupName,
 				timeSet, time, writeDomainTypes, writeFieldsMode, fieldNamesCount, fieldNames,
-				writeCriterion, recursionMode);
+				writeCriterion, recursionMode, binaryValues);
 			fileStream.close();
 		}
 		else
@@ -2606,20 +2694,33 @@ int write_exregion_file_to_memory_block(
 	FE_write_fields_mode writeFieldsMode,
 	int fieldNamesCount, const char * const *fieldNames,
 	FE_write_criterion writeCriterion,
-	cmzn_streaminformation_region_recursion_mode recursionMode)
+	cmzn_streaminformation_region_recursion_mode recursionMode,
+	bool binaryValues)
 {
 	int return_code = 1;
 	if (memoryBlock)
 	{
-		ostringstream stringStream;
+		ostringstream stringStream((binaryValues) ? (ios::out | ios::binary) : ios::out);
 		if (stringStream)
 		{
 			return_code = write_exregion_to_stream(&stringStream, rootRegion, region, groupName,
 				timeSet, time, writeDomainTypes, writeFieldsMode, fieldNamesCount, fieldNames,
-				writeCriterion, recursionMode);
+				writeCriterion, recursionMode, binaryValues);
 			string sstring = stringStream.str();
-			*memoryBlockLength = static_cast<unsigned int>(sstring.size());
-			*memoryBlock = duplicate_string(sstring.c_str());
+			// copy full length as binary values may contain null characters
+			char *memoryString = nullptr;
+			if (ALLOCATE(memoryString, char, sstring.size() + 1))
+			{
+				memcpy(memoryString, sstring.c_str(), sstring.size() + 1);
+				*memoryBlockLength = static_cast<unsigned int>(sstring.size());
+			}
+			else
+			{
+				display_message(ERROR_MESSAGE,
+					"write_exregion_file_to_memory_block.  Could not allocate memory block");
+				return_code = 0;
+			}
+			*memoryBlock = memoryString;
 		}
 		else
 		{
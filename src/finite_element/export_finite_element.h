@@ -78,6 +78,9 @@ PROTOTYPE_ENUMERATOR_FUNCTIONS(FE_write_recursion);
  * a time sequence. Values at that time are interpolated from time sequence or
  * clamped to first/last value if outside its range. Non time-varying fields
  * are written without a time sequence.
+ * @param binaryValues  If true, write node and element values, element nodes
+ * and scale factors as little endian binary value blocks, as read back by the
+ * EX reader; file is opened in binary mode.
  * @see write_exregion_to_stream.
  */
 int write_exregion_file_of_name(
@@ -89,7 +92,8 @@ int write_exregion_file_of_name(
 	FE_write_fields_mode writeFieldsMode,
 	int fieldNamesCount, const char * const *fieldNames,
 	FE_write_criterion writeCriterion,
-	cmzn_streaminformation_region_recursion_mode recursionMode);
+	cmzn_streaminformation_region_recursion_mode recursionMode,
+	bool binaryValues = false);
 
 int write_exregion_file_to_memory_block(
 	void **memoryBlock, unsigned int *memoryBlockLength,
@@ -100,6 +104,7 @@ int write_exregion_file_to_memory_block(
 	FE_write_fields_mode writeFieldsMode,
 	int fieldNamesCount, const char * const *fieldNames,
 	FE_write_criterion writeCriterion,
-	cmzn_streaminformation_region_recursion_mode recursionMode);
+	cmzn_streaminformation_region_recursion_mode recursionMode,
+	bool binaryValues = false);
 
 #endif /* !defined (EXPORT_FINITE_ELEMENT_H) */
@@ -9,6 +9,7 @@
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdlib>
@@ -49,45 +50,6 @@ FULL_DECLARE_INDEXED_LIST_TYPE(FE_node_field);
 
 FULL_DECLARE_LIST_TYPE(FE_node_field_info);
 
-/**
- * @see struct FE_element_type_node_sequence.
- */
-struct FE_element_type_node_sequence_identifier
-{
-	/* node_numbers must be ordered from lowest to highest to work! */
-	int *node_numbers,number_of_nodes;
-};
-
-struct FE_element_type_node_sequence
-/*******************************************************************************
-LAST MODIFIED : 30 April 1999
-
-DESCRIPTION :
-Structure for storing an element with its identifier being its cm_type and the
-number and list - in ascending order - of the nodes referred to by the default
-coordinate field of the element. Indexed lists, indexed using function
-compare_FE_element_type_node_sequence_identifier ensure that recalling a line or
-face with the same nodes is extremely rapid. FE_mesh
-uses them to find faces and lines for elements without them, if they exist.
-
-???RC Can only match faces correctly for coordinate fields with standard node
-to element maps and no versions. A grid-based coordinate field would fail
-utterly since it has no nodes. A possible future solution for all cases is to
-match the geometry exactly either by using the FE_element_field_evaluation
-(coefficients of the monomial basis functions), although there is a problem with
-xi-directions not matching up, or actual centre positions of the face being a
-trivial rejection, narrowing down to a single face or list of faces to compare
-against.
-==============================================================================*/
-{
-	struct FE_element_type_node_sequence_identifier identifier;
-	struct FE_element *element;
-	int dimension; // can be different from element dimension if created with face number
-	int access_count;
-}; /* struct FE_element_line_face_node_sequence */
-
-FULL_DECLARE_INDEXED_LIST_TYPE(FE_element_type_node_sequence);
-
 struct FE_node_field_iterator_and_data
 {
 	FE_node_field_iterator_function *iterator;
@@ -1035,268 +997,6 @@ is known to be the only object using this field info.
 	return (return_code);
 } /* FE_node_field_info_add_node_field */
 
-/**
- * Compare functions for listing struct FE_element_type_node_sequence in order:
- * - number_of_nodes changing slowest;
- * - node numbers in numerical order (nodes must be in ascending order).
- * Returns values like strcmp:
- * -1 = identifier 1 < identifier 2
- * 0 = identifier 1 = identifier 2
- * 1 = identifier 1 > identifier 2
- */
-static int compare_FE_element_type_node_sequence_identifier(
-	FE_element_type_node_sequence_identifier &identifier1,
-	FE_element_type_node_sequence_identifier &identifier2)
-{
-	/* 1. compare number_of_nodes */
-	int number_of_nodes = identifier1.number_of_nodes;
-	if (number_of_nodes < identifier2.number_of_nodes)
-	{
-		return -1;
-	}
-	else if (number_of_nodes > identifier2.number_of_nodes)
-	{
-		return 1;
-	}
-	else
-	{
-		/* 2. compare node_numbers - assumed in ascending order */
-		for (int i = 0; i < number_of_nodes; ++i)
-		{
-			if (identifier1.node_numbers[i] < identifier2.node_numbers[i])
-			{
-				return -1;
-			}
-			else if (identifier1.node_numbers[i] > identifier2.node_numbers[i])
-			{
-				return 1;
-			}
-		}
-	}
-	return 0;
-}
-
-struct FE_element_type_node_sequence *CREATE(FE_element_type_node_sequence)(
-	int &result, struct FE_element *element, int face_number)
-{
-	result = CMZN_OK;
-	int i,node_number,*node_numbers,number_of_nodes,placed,j,k;
-	struct FE_element_type_node_sequence *element_type_node_sequence;
-	struct FE_node **nodes_in_element;
-
-	if (element)
-	{
-		/* get list of nodes used by default coordinate field in element/face */
-		result = calculate_FE_element_field_nodes(element, face_number,
-			(struct FE_field *)NULL, &number_of_nodes, &nodes_in_element,
-			/*top_level_element*/(struct FE_element *)NULL);
-		if ((CMZN_OK == result) && (0 < number_of_nodes))
-		{
-			if (ALLOCATE(element_type_node_sequence, struct FE_element_type_node_sequence, 1) &&
-				ALLOCATE(node_numbers, int, number_of_nodes))
-			{
-				element_type_node_sequence->identifier.number_of_nodes = number_of_nodes;
-				element_type_node_sequence->identifier.node_numbers = node_numbers;
-				element_type_node_sequence->element=ACCESS(FE_element)(element);
-				element_type_node_sequence->dimension = element->getDimension();
-				if (face_number >= 0)
-					--(element_type_node_sequence->dimension);
-				element_type_node_sequence->access_count=0;
-				/* put the nodes in the identifier in ascending order */
-				for (i=0;element_type_node_sequence&&(i<number_of_nodes);i++)
-				{
-					node_number=(nodes_in_element[i])->getIdentifier();
-					node_numbers[i]=node_number;
-					/* SAB Reenabled the matching of differently ordered faces as
-						detecting the continuity correctly is more important than the
-						problems with lines matching to different nodes when
-						inheriting from different parents.
-						OLDCOMMENT
-						We do not want to sort these node numbers as the order of the nodes
-						determines which ordering the faces are in and if these do not match
-						we will get the lines matched to different pairs of the nodes. */
-					placed=0;
-					for (j=0;(!placed)&&(j<i);j++)
-					{
-						if (node_number<node_numbers[j])
-						{
-							/* make space for the new number */
-							for (k=i;j<k;k--)
-							{
-								node_numbers[k]=node_numbers[k-1];
-							}
-							node_numbers[j]=node_number;
-							placed=1;
-						}
-					}
-					if (!placed)
-					{
-						node_numbers[i]=node_number;
-					}
-				}
-#if defined (DEBUG_CODE)
-				/*???debug*/
-				printf("FE_element_type_node_sequence  %d-D element %d has nodes: ",
-					element->getDimension(), element->getIdentifier());
-				for (i=0;i<number_of_nodes;i++)
-				{
-					printf(" %d",node_numbers[i]);
-				}
-				printf("\n");
-#endif /* defined (DEBUG_CODE) */
-			}
-			else
-			{
-				display_message(ERROR_MESSAGE,
-					"CREATE(FE_element_type_node_sequence).  Not enough memory");
-				DEALLOCATE(element_type_node_sequence);
-			}
-			for (i=0;i<number_of_nodes;i++)
-			{
-				cmzn_node::deaccess(nodes_in_element[i]);
-			}
-			DEALLOCATE(nodes_in_element);
-		}
-		else
-		{
-			if (CMZN_ERROR_NOT_FOUND != result)
-			{
-				display_message(ERROR_MESSAGE, "CREATE(FE_element_type_node_sequence).  Failed to get nodes in element");
-			}
-			element_type_node_sequence=(struct FE_element_type_node_sequence *)NULL;
-		}
-	}
-	else
-	{
-		display_message(ERROR_MESSAGE,
-			"CREATE(FE_element_type_node_sequence).  Invalid argument(s)");
-		element_type_node_sequence=(struct FE_element_type_node_sequence *)NULL;
-		result = CMZN_ERROR_ARGUMENT;
-	}
-	return (element_type_node_sequence);
-}
-
-int DESTROY(FE_element_type_node_sequence)(
-	struct FE_element_type_node_sequence **element_type_node_sequence_address)
-/*******************************************************************************
-LAST MODIFIED : 13 February 2003
-
-DESCRIPTION :
-Cleans up memory used by the FE_element_type_node_sequence.
-==============================================================================*/
-{
-	int return_code;
-	struct FE_element_type_node_sequence *element_type_node_sequence;
-
-	ENTER(DESTROY(FE_element_type_node_sequence));
-	if (element_type_node_sequence_address&&
-		(element_type_node_sequence= *element_type_node_sequence_address))
-	{
-		if (0==element_type_node_sequence->access_count)
-		{
-			/* must deaccess element */
-			DEACCESS(FE_element)(&(element_type_node_sequence->element));
-			DEALLOCATE(element_type_node_sequence->identifier.node_numbers);
-			DEALLOCATE(*element_type_node_sequence_address);
-			return_code=1;
-		}
-		else
-		{
-			display_message(ERROR_MESSAGE,
-				"DESTROY(FE_element_type_node_sequence).  Non-zero access count of %d",
-				element_type_node_sequence->access_count);
-			*element_type_node_sequence_address=
-				(struct FE_element_type_node_sequence *)NULL;
-			return_code=0;
-		}
-	}
-	else
-	{
-		display_message(ERROR_MESSAGE,
-			"DESTROY(FE_element_type_node_sequence).  Invalid argument(s)");
-		return_code=0;
-	}
-	LEAVE;
-
-	return (return_code);
-} /* DESTROY(FE_element_type_node_sequence) */
-
-DECLARE_OBJECT_FUNCTIONS(FE_element_type_node_sequence)
-
-DECLARE_INDEXED_LIST_MODULE_FUNCTIONS(FE_element_type_node_sequence, \
-	identifier, FE_element_type_node_sequence_identifier&, \
-	compare_FE_element_type_node_sequence_identifier)
-
-DECLARE_INDEXED_LIST_FUNCTIONS(FE_element_type_node_sequence)
-
-DECLARE_FIND_BY_IDENTIFIER_IN_INDEXED_LIST_FUNCTION( \
-	FE_element_type_node_sequence,identifier, \
-	FE_element_type_node_sequence_identifier&, \
-	compare_FE_element_type_node_sequence_identifier)
-
-int FE_element_type_node_sequence_is_collapsed(
-	struct FE_element_type_node_sequence *element_type_node_sequence)
-/*******************************************************************************
-LAST MODIFIED : 13 February 2003
-
-DESCRIPTION :
-Returns true if the <element_type_node_sequence> represents an element that
-has collapsed, ie, is a face with <= 2 unique nodes, or a line with 1 unique
-node.
-???RC Note that repeated nodes in the face/line are not put in the node_numbers
-array twice, facilitating the simple logic in this function. If they were, then
-this function would have to be modified extensively.
-==============================================================================*/
-{
-	int return_code;
-
-	ENTER(FE_element_type_node_sequence_is_collapsed);
-	if (element_type_node_sequence)
-	{
-		return_code=((2 == element_type_node_sequence->dimension)&&
-			(2 >= element_type_node_sequence->identifier.number_of_nodes))||
-			((1 == element_type_node_sequence->dimension)&&
-				(1 == element_type_node_sequence->identifier.number_of_nodes));
-	}
-	else
-	{
-		display_message(ERROR_MESSAGE,
-			"FE_element_type_node_sequence_is_collapsed.  Invalid argument(s)");
-		return_code=0;
-	}
-	LEAVE;
-
-	return (return_code);
-} /* FE_element_type_node_sequence_is_collapsed */
-
-struct FE_element *FE_element_type_node_sequence_get_FE_element(
-	struct FE_element_type_node_sequence *element_type_node_sequence)
-{
-	if (element_type_node_sequence)
-		return element_type_node_sequence->element;
-	return 0;
-}
-
-void FE_element_type_node_sequence_set_FE_element(
-	struct FE_element_type_node_sequence *element_type_node_sequence,
-	struct FE_element *element)
-{
-	if (element_type_node_sequence)
-		REACCESS(FE_element)(&element_type_node_sequence->element, element);
-}
-
-FE_element_type_node_sequence *FE_element_type_node_sequence_list_find_match(
-	struct LIST(FE_element_type_node_sequence) *element_type_node_sequence_list,
-	FE_element_type_node_sequence *element_type_node_sequence)
-{
-	if (element_type_node_sequence_list && element_type_node_sequence)
-	{
-		return FIND_BY_IDENTIFIER_IN_LIST(FE_element_type_node_sequence, identifier)(
-			element_type_node_sequence->identifier, element_type_node_sequence_list);
-	}
-	return 0;
-}
-
 /** Increases the values count by the number of values for node field */
 static int count_nodal_values(struct FE_node_field *node_field,
 	void *values_count_void)
@@ -4757,7 +4457,7 @@ int list_FE_node(struct FE_node *node)
 #if defined (DEBUG_CODE)
 		/*???debug*/
 		display_message(INFORMATION_MESSAGE,"  access count = %d\n",
-			node->access_count);
+			node->getAccessCount());
 #endif /* defined (DEBUG_CODE) */
 	}
 	else
@@ -5012,18 +4712,19 @@ int adjacent_FE_element(struct FE_element *element,
 	return return_code;
 }
 
-int calculate_FE_element_field_nodes(struct FE_element *element,
-	int face_number, struct FE_field *field,
-	int *number_of_element_field_nodes_address,
-	struct FE_node ***element_field_nodes_array_address,
-	struct FE_element *top_level_element)
+/**
+ * Get indexes of unique nodes used by field on element or its face, in the
+ * order of calculate_FE_element_field_nodes. Does not access nodes so it is
+ * safe to call from multiple threads while the region is not being modified.
+ * @param nodeset  Set to the nodeset the node indexes are for.
+ * @param nodeIndexes  Cleared then filled with node indexes.
+ * @see calculate_FE_element_field_nodes
+ */
+static int calculate_FE_element_field_node_indexes(struct FE_element *element,
+	int face_number, struct FE_field *field, const FE_nodeset *&nodeset,
+	std::vector<DsLabelIndex>& nodeIndexes, struct FE_element *top_level_element)
 {
-	if (!((element) && (number_of_element_field_nodes_address) &&
-		(element_field_nodes_array_address)))
-	{
-		display_message(ERROR_MESSAGE, "calculate_FE_element_field_nodes.  Invalid argument(s)");
-		return CMZN_ERROR_ARGUMENT;
-	}
+	nodeIndexes.clear();
 	if (!field)
 	{
 		field = FE_element_get_default_coordinate_field(top_level_element ? top_level_element : element);
@@ -5061,7 +4762,7 @@ int calculate_FE_element_field_nodes(struct FE_element *element,
 		display_message(ERROR_MESSAGE, "calculate_FE_element_field_nodes.  Invalid element");
 		return CMZN_ERROR_NOT_FOUND;
 	}
-	const FE_nodeset *nodeset = mesh->getNodeset();
+	nodeset = mesh->getNodeset();
 	if (!nodeset)
 	{
 		display_message(ERROR_MESSAGE, "calculate_FE_element_field_nodes.  No nodeset, invalid mesh");
@@ -5070,11 +4771,9 @@ int calculate_FE_element_field_nodes(struct FE_element *element,
 
 	int return_code = CMZN_OK;
 	FE_value *blending_matrix, *combined_blending_matrix, *transformation;
-	int i, *inherited_basis_arguments, j, k,
+	int i, *inherited_basis_arguments, j,
 		number_of_inherited_values, number_of_blended_values;
 
-	int number_of_element_field_nodes = 0;
-	struct FE_node **element_field_nodes_array = 0;
 	int elementDimension = element->getDimension();
 	if (face_number >= 0)
 		--elementDimension;
@@ -5179,37 +4878,10 @@ int calculate_FE_element_field_nodes(struct FE_element *element,
 						{
 							add = true;
 						}
-						if (add)
+						if ((add) && (nodeset->getNode(*element_value)) &&
+							(std::find(nodeIndexes.begin(), nodeIndexes.end(), *element_value) == nodeIndexes.end()))
 						{
-							struct FE_node *node = nodeset->getNode(*element_value);
-							if (node)
-							{
-								k = 0;
-								while ((k<number_of_element_field_nodes)&&
-									(node != element_field_nodes_array[k]))
-								{
-									k++;
-								}
-								if (k>=number_of_element_field_nodes)
-								{
-									struct FE_node **temp_element_field_nodes_array;
-									if (REALLOCATE(temp_element_field_nodes_array,
-										element_field_nodes_array, struct FE_node *,
-										number_of_element_field_nodes+1))
-									{
-										element_field_nodes_array = temp_element_field_nodes_array;
-										element_field_nodes_array[number_of_element_field_nodes] = node->access();
-										number_of_element_field_nodes++;
-									}
-									else
-									{
-										display_message(ERROR_MESSAGE,
-											"calculate_FE_element_field_nodes.  "
-											"Could not REALLOCATE element_field_nodes_array");
-										return_code = CMZN_ERROR_MEMORY;
-									}
-								}
-							}
+							nodeIndexes.push_back(*element_value);
 						}
 						element_value++;
 						i--;
@@ -5227,31 +4899,62 @@ int calculate_FE_element_field_nodes(struct FE_element *element,
 		}
 	}
     delete previous_element_values;
-	if (CMZN_OK == return_code)
+	if (CMZN_OK != return_code)
+		nodeIndexes.clear();
+	else if (nodeIndexes.empty())
+		return_code = CMZN_ERROR_NOT_FOUND;
+	return (return_code);
+}
+
+int calculate_FE_element_field_nodes(struct FE_element *element,
+	int face_number, struct FE_field *field,
+	int *number_of_element_field_nodes_address,
+	struct FE_node ***element_field_nodes_array_address,
+	struct FE_element *top_level_element)
+{
+	if (!((element) && (number_of_element_field_nodes_address) &&
+		(element_field_nodes_array_address)))
 	{
-		*number_of_element_field_nodes_address=number_of_element_field_nodes;
-		if (number_of_element_field_nodes)
-		{
-			*element_field_nodes_array_address = element_field_nodes_array;
-		}
-		else
-		{
-			DEALLOCATE(element_field_nodes_array);
-			*element_field_nodes_array_address = 0;
-			return_code = CMZN_ERROR_NOT_FOUND;
-		}
+		display_message(ERROR_MESSAGE, "calculate_FE_element_field_nodes.  Invalid argument(s)");
+		return CMZN_ERROR_ARGUMENT;
 	}
-	else
+	*number_of_element_field_nodes_address = 0;
+	*element_field_nodes_array_address = 0;
+	const FE_nodeset *nodeset = 0;
+	std::vector<DsLabelIndex> nodeIndexes;
+	int return_code = calculate_FE_element_field_node_indexes(element, face_number, field,
+		nodeset, nodeIndexes, top_level_element);
+	if (CMZN_OK != return_code)
+		return return_code;
+	const int number_of_element_field_nodes = static_cast<int>(nodeIndexes.size());
+	struct FE_node **element_field_nodes_array;
+	if (!ALLOCATE(element_field_nodes_array, struct FE_node *, number_of_element_field_nodes))
 	{
-		*number_of_element_field_nodes_address = 0;
-		*element_field_nodes_array_address = 0;
-		for (i=0;i<number_of_element_field_nodes;i++)
-		{
-			cmzn_node::deaccess(element_field_nodes_array[i]);
-		}
-		DEALLOCATE(element_field_nodes_array);
+		display_message(ERROR_MESSAGE,
+			"calculate_FE_element_field_nodes.  Could not allocate element_field_nodes_array");
+		return CMZN_ERROR_MEMORY;
 	}
-	return (return_code);
+	for (int n = 0; n < number_of_element_field_nodes; ++n)
+		element_field_nodes_array[n] = nodeset->getNode(nodeIndexes[n])->access();
+	*number_of_element_field_nodes_address = number_of_element_field_nodes;
+	*element_field_nodes_array_address = element_field_nodes_array;
+	return CMZN_OK;
+}
+
+int FE_element_get_field_node_index_sequence(struct FE_element *element,
+	int face_number, std::vector<DsLabelIndex>& nodeIndexes)
+{
+	if (!element)
+	{
+		display_message(ERROR_MESSAGE, "FE_element_get_field_node_index_sequence.  Invalid argument(s)");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	const FE_nodeset *nodeset = 0;
+	const int return_code = calculate_FE_element_field_node_indexes(element, face_number,
+		/*field*/nullptr, nodeset, nodeIndexes, /*top_level_element*/nullptr);
+	if (CMZN_OK == return_code)
+		std::sort(nodeIndexes.begin(), nodeIndexes.end());
+	return return_code;
 }
 
 bool equivalent_FE_field_in_elements(struct FE_field *field,
@@ -15,6 +15,7 @@
 #include <cstdio>
 #include <cmath>
 #include <cstring>
+#include <utility>
 #include <vector>
 #include "cmlibs/zinc/zincconfigure.h"
 #include "finite_element/finite_element_basis.hpp"
@@ -3063,22 +3064,26 @@ PROTOTYPE_MANAGER_COPY_WITHOUT_IDENTIFIER_FUNCTION(FE_basis,type)
 	{
 		// since basis is completely defined by its type,
 		// just recreate source and swap contents with destination
-		FE_basis *tmpBasis;
-		ALLOCATE(tmpBasis, FE_basis, 1);
+		// keeping manager and access count of destination
 		FE_basis *copyBasis = CREATE(FE_basis)(source->type);
-		if (tmpBasis && copyBasis)
+		if (copyBasis)
 		{
-			*tmpBasis = *destination;
-			*destination = *copyBasis;
-			*copyBasis = *tmpBasis;
+			std::swap(destination->type, copyBasis->type);
+			std::swap(destination->number_of_basis_functions, copyBasis->number_of_basis_functions);
+			std::swap(destination->blending_matrix, copyBasis->blending_matrix);
+			std::swap(destination->blending_matrix_column_size, copyBasis->blending_matrix_column_size);
+			std::swap(destination->number_of_standard_basis_functions, copyBasis->number_of_standard_basis_functions);
+			std::swap(destination->arguments, copyBasis->arguments);
+			std::swap(destination->standard_basis, copyBasis->standard_basis);
+			std::swap(destination->parameterNodes, copyBasis->parameterNodes);
+			std::swap(destination->parameterDerivatives, copyBasis->parameterDerivatives);
+			DESTROY(FE_basis)(&copyBasis);
 		}
 		else
 		{
 			display_message(ERROR_MESSAGE, "MANAGER_COPY_WITHOUT_IDENTIFIER(FE_basis,type).  Could not allocate temporaries");
 			return_code = 0;
 		}
-		DESTROY(FE_basis)(&copyBasis);
-		DEALLOCATE(tmpBasis);
 	}
 	else
 	{
@@ -18,6 +18,7 @@
 #include "general/manager.h"
 #include "general/object.h"
 #include "general/value.h"
+#include <atomic>
 
 /*
 Global types
@@ -117,8 +118,9 @@ public:
 	int manager_change_status;
 
 	// the number of structures that point to this basis.  The basis cannot be
-	// destroyed while this is greater than 0
-	int access_count;
+	// destroyed while this is greater than 0. Atomic as bases are shared by
+	// regions read concurrently
+	std::atomic_int access_count;
 
 public:
 
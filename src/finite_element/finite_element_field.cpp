@@ -138,7 +138,7 @@ FE_field::~FE_field()
 {
 	if (0 != this->access_count)
 	{
-		display_message(ERROR_MESSAGE, "~FE_field.  Non-zero access_count (%d)", this->access_count);
+		display_message(ERROR_MESSAGE, "~FE_field.  Non-zero access_count (%d)", static_cast<int>(this->access_count));
 		return;
 	}
 	if (this->element_xi_host_mesh)
@@ -470,7 +470,7 @@ FE_field_parameters *FE_field::get_FE_field_parameters()
 void FE_field::list() const
 {
 	display_message(INFORMATION_MESSAGE, "field : %s\n", this->name);
-	display_message(INFORMATION_MESSAGE, "  access count = %d\n", this->access_count);
+	display_message(INFORMATION_MESSAGE, "  access count = %d\n", static_cast<int>(this->access_count));
 	display_message(INFORMATION_MESSAGE, "  type = %s",
 		ENUMERATOR_STRING(CM_field_type)(this->cm_field_type));
 	display_message(INFORMATION_MESSAGE, "  coordinate system = %s",
@@ -18,6 +18,7 @@
 #include "general/geometry.h"
 #include "general/value.h"
 #include "general/list.h"
+#include <atomic>
 
 /*
 Global types
@@ -117,8 +118,9 @@ private:
 	/* the number of computed fields wrapping this FE_field */
 	int number_of_wrappers;
 	/* the number of structures that point to this field.  The field cannot be
-		destroyed while this is greater than 0 */
-	int access_count;
+		destroyed while this is greater than 0. Atomic so field can be accessed by
+		concurrent evaluations in multiple threads */
+	std::atomic_int access_count;
 
 protected:
 
@@ -151,8 +153,7 @@ public:
 	{
 		if (field)
 		{
-			--(field->access_count);
-			if (field->access_count <= 0)
+			if (--(field->access_count) <= 0)
 				delete field;
 			field = nullptr;
 		}
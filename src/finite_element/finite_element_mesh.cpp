@@ -13,16 +13,20 @@
 #include "computed_field/field_derivative.hpp"
 #include "computed_field/computed_field_private.hpp"
 #include "computed_field/fieldparametersprivate.hpp"
+#include "finite_element/element_node_sequence_map.hpp"
 #include "finite_element/finite_element.h"
 #include "finite_element/finite_element_mesh.hpp"
 #include "finite_element/finite_element_mesh_field_ranges.hpp"
 #include "finite_element/finite_element_nodeset.hpp"
+#include "finite_element/finite_element_private.h"
 #include "finite_element/finite_element_region_private.h"
 #include "general/object.h"
 #include "general/debug.h"
 #include "general/message.h"
 #include "general/mystring.h"
+#include "general/thread_pool.hpp"
 #include <algorithm>
+#include <unordered_set>
 
 /*
 Module types
@@ -314,7 +318,7 @@ cmzn_element::~cmzn_element()
 	if (0 != this->access_count)
 	{
 		display_message(ERROR_MESSAGE, "~cmzn_element.  Element destroyed with non-zero access count %d. Dimension %d Index %d",
-			this->access_count, this->mesh ? this->mesh->getDimension() : -1, this->index);
+			static_cast<int>(this->access_count), this->mesh ? this->mesh->getDimension() : -1, this->index);
 	}
 }
 
@@ -1326,7 +1330,7 @@ FE_mesh::FE_mesh(FE_region *fe_regionIn, int dimensionIn) :
 	lastMergedElementTemplate(0),
 	parentMesh(0),
 	faceMesh(0),
-	element_type_node_sequence_list(0),
+	elementNodeSequenceMap(nullptr),
 	definingFaces(false),
 	activeElementIterators(0)
 {
@@ -1357,6 +1361,7 @@ FE_mesh::~FE_mesh()
 
 	// must remove change log here to avoid messages during cleanup
 	cmzn::Deaccess(this->changeLog);
+	delete this->elementNodeSequenceMap;
 
 	// detach objects holding non-accessed pointers to this mesh
 	cmzn_elementiterator *elementIterator = this->activeElementIterators;
@@ -2798,7 +2803,7 @@ DsLabelIndex FE_mesh::getElementFirstNeighbour(DsLabelIndex elementIndex, int fa
 	DsLabelIndex faceIndex;
 	if ((this->faceMesh) && (elementShapeFaces = this->getElementShapeFaces(elementIndex)) &&
 		(faces = elementShapeFaces->getElementFaces(elementIndex)) &&
-		(0 < faceNumber) && (faceNumber < elementShapeFaces->getFaceCount()) &&
+		(0 <= faceNumber) && (faceNumber < elementShapeFaces->getFaceCount()) &&
 		(0 <= (faceIndex = faces[faceNumber])))
 	{
 		const DsLabelIndex *parents;
@@ -2825,84 +2830,196 @@ DsLabelIndex FE_mesh::getElementFirstNeighbour(DsLabelIndex elementIndex, int fa
 	return DS_LABEL_INDEX_INVALID;
 }
 
+namespace {
+
+// Number of elements whose faces are defined together by FE_mesh::define_faces
+const size_t defineFacesElementsPerBatch = 16384;
+
+// Number of node sequences calculated per chunk of work
+const size_t nodeSequencesPerChunk = 256;
+
+// Minimum number of chunks of node sequences per worker thread. Fewer
+// sequences than this many chunks are calculated serially, as small meshes
+// and EX reads defining faces a few elements at a time gain nothing from threads
+const size_t nodeSequenceChunksPerWorker = 16;
+
+/** Element or face of element to calculate the node index sequence for */
+struct FE_element_node_sequence
+{
+	cmzn_element *element;  // not accessed
+	int faceNumber;  // or -1 for the element itself
+	int result;
+	int nodesCount;
+	size_t offset;  // start of node indexes in chunk storage
+	size_t hash;
+};
+
+/**
+ * Calculates node index sequences for many elements or faces of elements,
+ * sharing chunks of them between threads. Results are stored in the order
+ * added so faces are matched and created in the same order as if calculated
+ * one at a time.
+ */
+class FE_element_node_sequences
+{
+	std::vector<FE_element_node_sequence> sequences;
+	std::vector<std::vector<DsLabelIndex> > chunkNodeIndexes;
+
+	void calculateChunk(size_t chunk)
+	{
+		std::vector<DsLabelIndex>& nodeIndexes = this->chunkNodeIndexes[chunk];
+		nodeIndexes.clear();
+		std::vector<DsLabelIndex> sequenceNodeIndexes;
+		const size_t sequencesEnd = std::min((chunk + 1)*nodeSequencesPerChunk, this->sequences.size());
+		for (size_t s = chunk*nodeSequencesPerChunk; s < sequencesEnd; ++s)
+		{
+			FE_element_node_sequence& sequence = this->sequences[s];
+			sequence.result = FE_element_get_field_node_index_sequence(sequence.element,
+				sequence.faceNumber, sequenceNodeIndexes);
+			sequence.nodesCount = static_cast<int>(sequenceNodeIndexes.size());
+			sequence.offset = nodeIndexes.size();
+			sequence.hash = FE_element_node_sequence_map::hashSequence(sequenceNodeIndexes.data(), sequence.nodesCount);
+			nodeIndexes.insert(nodeIndexes.end(), sequenceNodeIndexes.begin(), sequenceNodeIndexes.end());
+		}
+	}
+
+public:
+
+	void clear()
+	{
+		this->sequences.clear();
+	}
+
+	size_t size() const
+	{
+		return this->sequences.size();
+	}
+
+	void add(cmzn_element *element, int faceNumber)
+	{
+		FE_element_node_sequence sequence = { element, faceNumber, CMZN_OK, 0, 0, 0 };
+		this->sequences.push_back(sequence);
+	}
+
+	const FE_element_node_sequence& get(size_t s) const
+	{
+		return this->sequences[s];
+	}
+
+	const DsLabelIndex *getNodeIndexes(size_t s) const
+	{
+		return this->chunkNodeIndexes[s/nodeSequencesPerChunk].data() + this->sequences[s].offset;
+	}
+
+	/**
+	 * Calculate all sequences added since clear. Large batches are shared
+	 * between hardware threads from the shared thread pool, with at least
+	 * nodeSequenceChunksPerWorker chunks per worker; smaller batches are
+	 * calculated serially on the calling thread. Calculation only reads the
+	 * coordinate field's element maps, element shapes and parent/face maps,
+	 * and does not access nodes. This is safe as define faces only modifies the
+	 * mesh after all sequences in the batch are calculated, and the caller
+	 * must not modify the region from other threads while defining faces.
+	 * Messages are displayed on the calling thread in order.
+	 */
+	void calculate()
+	{
+		const size_t chunksCount = (this->sequences.size() + nodeSequencesPerChunk - 1)/nodeSequencesPerChunk;
+		if (this->chunkNodeIndexes.size() < chunksCount)
+			this->chunkNodeIndexes.resize(chunksCount);
+		const size_t maximumWorkersCount = chunksCount/nodeSequenceChunksPerWorker;
+		int workersCount = ThreadPool::resolveThreadsCount(0);
+		if (static_cast<size_t>(workersCount) > maximumWorkersCount)
+			workersCount = static_cast<int>(maximumWorkersCount);
+		if (workersCount < 2)
+		{
+			for (size_t c = 0; c < chunksCount; ++c)
+				this->calculateChunk(c);
+			return;
+		}
+		ThreadPool::getShared().executeChunks(workersCount, chunksCount,
+			[this](int, size_t c)
+			{
+				this->calculateChunk(c);
+				return true;
+			});
+	}
+
+};
+
+}
+
 /**
  * Find or create an element in this mesh that can be used on face number of
- * the parent element. The face is added to the parent.
+ * the parent element, given the node index sequence for the face. The face is
+ * added to the parent.
  * The new face element is added to this mesh, but without adding faces.
  * Must be between calls to begin_define_faces/end_define_faces.
  * Can only match faces correctly for coordinate fields with standard node
  * to element maps and no versions.
- * The element type node sequence list is updated with any new face.
+ * The element node sequence map is updated with any new face.
  *
  * @param parentIndex  Index of parent element in parentMesh, to find or create
  * face for.
  * @param faceNumber  Face number on parent, starting at 0.
+ * @param nodeIndexes  Unique node indexes used by face, in ascending order.
+ * @param nodesCount  Number of node indexes, > 0.
+ * @param hash  Hash of node indexes from FE_element_node_sequence_map.
  * @param faceIndex  On successful return, set to new faceIndex or
  * DS_LABEL_INDEX_INVALID if no face needed (for collapsed element face).
- * @return  Index of new face or DS_LABEL_INDEX_INVALID if failed.
- * @return  Result OK on success, ERROR_NOT_FOUND if no nodes available
- * for defining faces, otherwise any other error.
+ * @return  Result OK on success, otherwise any other error.
  */
-int FE_mesh::findOrCreateFace(DsLabelIndex parentIndex, int faceNumber, DsLabelIndex& faceIndex)
+int FE_mesh::findOrCreateFaceWithNodes(DsLabelIndex parentIndex, int faceNumber,
+	const DsLabelIndex *nodeIndexes, int nodesCount, size_t hash, DsLabelIndex& faceIndex)
 {
 	faceIndex = DS_LABEL_INDEX_INVALID;
-	cmzn_element *parentElement = this->parentMesh->getElement(parentIndex);
-	int return_code = CMZN_OK;
-	FE_element_type_node_sequence *element_type_node_sequence =
-		CREATE(FE_element_type_node_sequence)(return_code, parentElement, faceNumber);
-	if (!element_type_node_sequence)
+	// faces with 2 or fewer unique nodes, or lines with 1 node are collapsed
+	if (((2 == this->dimension) && (2 >= nodesCount)) || ((1 == this->dimension) && (1 == nodesCount)))
+		return CMZN_OK;
+	const DsLabelIndex existingFaceIndex = this->elementNodeSequenceMap->find(nodeIndexes, nodesCount, hash);
+	if (existingFaceIndex >= 0)
 	{
-		return return_code;
+		faceIndex = existingFaceIndex;
+		return this->parentMesh->setElementFace(parentIndex, faceNumber, faceIndex);
 	}
-
-	ACCESS(FE_element_type_node_sequence)(element_type_node_sequence);
-	if (!FE_element_type_node_sequence_is_collapsed(element_type_node_sequence))
+	FE_element_shape *parentShape = this->parentMesh->getElementShape(parentIndex);
+	FE_element_shape *faceShape = get_FE_element_shape_of_face(parentShape, faceNumber, this->fe_region);
+	if (!faceShape)
+		return CMZN_ERROR_GENERAL;
+	cmzn_element *face = this->get_or_create_FE_element_with_identifier(/*identifier*/-1, faceShape);
+	if (!face)
+		return CMZN_ERROR_GENERAL;
+	faceIndex = face->getIndex();
+	int return_code = this->parentMesh->setElementFace(parentIndex, faceNumber, faceIndex);
+	if (CMZN_OK == return_code)
 	{
-		FE_element_type_node_sequence *existing_element_type_node_sequence =
-			FE_element_type_node_sequence_list_find_match(
-			this->element_type_node_sequence_list, element_type_node_sequence);
-		if (existing_element_type_node_sequence)
-		{
-			cmzn_element *face = FE_element_type_node_sequence_get_FE_element(existing_element_type_node_sequence);
-			if (!face)
-				return_code = CMZN_ERROR_GENERAL;
-			else
-			{
-				faceIndex = face->getIndex();
-				return_code = this->parentMesh->setElementFace(parentIndex, faceNumber, faceIndex);
-			}
-		}
-		else
-		{
-			FE_element_shape *parentShape = this->parentMesh->getElementShape(parentIndex);
-			FE_element_shape *faceShape = get_FE_element_shape_of_face(parentShape, faceNumber, this->fe_region);
-			if (!faceShape)
-				return_code = CMZN_ERROR_GENERAL;
-			else
-			{
-				cmzn_element *face = this->get_or_create_FE_element_with_identifier(/*identifier*/-1, faceShape);
-				if (!face)
-					return_code = CMZN_ERROR_GENERAL;
-				else
-				{
-					FE_element_type_node_sequence_set_FE_element(element_type_node_sequence, face);
-					faceIndex = face->getIndex();
-					return_code = this->parentMesh->setElementFace(parentIndex, faceNumber, faceIndex);
-					if (CMZN_OK == return_code)
-					{
-						if (!ADD_OBJECT_TO_LIST(FE_element_type_node_sequence)(
-								element_type_node_sequence, this->element_type_node_sequence_list))
-							return_code = CMZN_ERROR_GENERAL;
-					}
-					cmzn_element::deaccess(face);
-				}
-			}
-		}
+		if (!this->elementNodeSequenceMap->add(nodeIndexes, nodesCount, hash, faceIndex))
+			return_code = CMZN_ERROR_GENERAL;
 	}
-	DEACCESS(FE_element_type_node_sequence)(&element_type_node_sequence);
+	cmzn_element::deaccess(face);
 	return return_code;
 }
 
+/**
+ * Find or create an element in this mesh that can be used on face number of
+ * the parent element. The face is added to the parent.
+ * @see findOrCreateFaceWithNodes
+ * @return  Result OK on success, ERROR_NOT_FOUND if no nodes available
+ * for defining faces, otherwise any other error.
+ */
+int FE_mesh::findOrCreateFace(DsLabelIndex parentIndex, int faceNumber, DsLabelIndex& faceIndex)
+{
+	faceIndex = DS_LABEL_INDEX_INVALID;
+	cmzn_element *parentElement = this->parentMesh->getElement(parentIndex);
+	std::vector<DsLabelIndex> nodeIndexes;
+	const int return_code = FE_element_get_field_node_index_sequence(parentElement, faceNumber, nodeIndexes);
+	if (CMZN_OK != return_code)
+		return return_code;
+	const int nodesCount = static_cast<int>(nodeIndexes.size());
+	return this->findOrCreateFaceWithNodes(parentIndex, faceNumber, nodeIndexes.data(), nodesCount,
+		FE_element_node_sequence_map::hashSequence(nodeIndexes.data(), nodesCount), faceIndex);
+}
+
 /**
  * Recursively define faces for element, creating and adding them to face
  * mesh if they don't already exist.
@@ -2975,73 +3092,191 @@ int FE_mesh::defineElementFaces(DsLabelIndex elementIndex)
 }
 
 /**
- * Creates a list of FE_element_type_node_sequence, and
+ * Define faces for elements in order, then recursively for their faces,
+ * creating and adding them to face mesh if they don't already exist.
+ * Node sequences for faces not yet defined are calculated in parallel, then
+ * faces are found or created in the same order as calling defineElementFaces
+ * for each element so identifiers of new faces and lines are unchanged.
+ * Call between begin/end_define_faces and begin/end_change.
+ * @param elementIndexes  Unique indexes of elements in this mesh.
+ * @param successCount  Incremented for each element whose faces are defined.
+ * @param notFoundCount  Incremented for each element with faces which could
+ * not be defined because nodes were not found.
+ * @return  CMZN_OK on success, otherwise any error code.
+ */
+int FE_mesh::defineElementsFaces(const std::vector<DsLabelIndex>& elementIndexes,
+	int& successCount, int& notFoundCount)
+{
+	if (!(this->faceMesh && this->definingFaces))
+		return CMZN_ERROR_ARGUMENT;
+	FE_element_node_sequences sequences;
+	for (size_t e = 0; e < elementIndexes.size(); ++e)
+	{
+		const DsLabelIndex elementIndex = elementIndexes[e];
+		ElementShapeFaces *elementShapeFaces = this->getElementShapeFaces(elementIndex);
+		if (!elementShapeFaces)
+		{
+			display_message(ERROR_MESSAGE, "FE_mesh::defineElementsFaces.  Missing ElementShapeFaces");
+			return CMZN_ERROR_ARGUMENT;
+		}
+		const int faceCount = elementShapeFaces->getFaceCount();
+		if (0 == faceCount)
+			continue;
+		const DsLabelIndex *faces = elementShapeFaces->getOrCreateElementFaces(elementIndex);
+		if (!faces)
+			return CMZN_ERROR_GENERAL;
+		cmzn_element *element = this->getElement(elementIndex);
+		for (int faceNumber = 0; faceNumber < faceCount; ++faceNumber)
+			if (faces[faceNumber] < 0)
+				sequences.add(element, faceNumber);
+	}
+	sequences.calculate();
+	int return_code = CMZN_OK;
+	size_t s = 0;
+	// existing and new faces in order of first use, to define their faces in the same order
+	std::vector<DsLabelIndex> faceIndexes;
+	std::unordered_set<DsLabelIndex> faceIndexesSet;
+	for (size_t e = 0; e < elementIndexes.size(); ++e)
+	{
+		const DsLabelIndex elementIndex = elementIndexes[e];
+		ElementShapeFaces *elementShapeFaces = this->getElementShapeFaces(elementIndex);
+		const int faceCount = elementShapeFaces->getFaceCount();
+		if (0 == faceCount)
+			continue;
+		DsLabelIndex *faces = elementShapeFaces->getElementFaces(elementIndex);
+		int newFaceCount = 0;
+		bool notFound = false;
+		for (int faceNumber = 0; faceNumber < faceCount; ++faceNumber)
+		{
+			DsLabelIndex faceIndex = faces[faceNumber];
+			if (faceIndex < 0)
+			{
+				if ((s >= sequences.size()) || (sequences.get(s).faceNumber != faceNumber))
+				{
+					return_code = CMZN_ERROR_GENERAL;
+					break;
+				}
+				const FE_element_node_sequence& sequence = sequences.get(s);
+				return_code = sequence.result;
+				if (CMZN_OK == return_code)
+					return_code = this->faceMesh->findOrCreateFaceWithNodes(elementIndex, faceNumber,
+						sequences.getNodeIndexes(s), sequence.nodesCount, sequence.hash, faceIndex);
+				++s;
+				if (CMZN_OK != return_code)
+				{
+					if (CMZN_ERROR_NOT_FOUND == return_code)
+					{
+						notFound = true;
+						return_code = CMZN_OK;
+						continue;
+					}
+					break;
+				}
+				if (faceIndex >= 0)
+					++newFaceCount;
+			}
+			if ((this->dimension > 2) && (DS_LABEL_INDEX_INVALID != faceIndex) &&
+				(faceIndexesSet.insert(faceIndex).second))
+				faceIndexes.push_back(faceIndex);
+		}
+		if (newFaceCount)
+		{
+			this->changeLog->setIndexChange(elementIndex, DS_LABEL_CHANGE_TYPE_DEFINITION);
+			if (fe_region)
+			{
+				this->fe_region->FE_field_all_change(CHANGE_LOG_RELATED_OBJECT_CHANGED(FE_field));
+				fe_region->update();
+			}
+		}
+		if (CMZN_OK != return_code)
+		{
+			display_message(ERROR_MESSAGE, "FE_mesh::defineElementsFaces.  Failed");
+			return return_code;
+		}
+		if (notFound)
+			++notFoundCount;
+		else
+			++successCount;
+	}
+	if (!faceIndexes.empty())
+	{
+		// recursively add faces of faces, whether existing or new
+		return_code = this->faceMesh->defineElementsFaces(faceIndexes, successCount, notFoundCount);
+	}
+	return (return_code);
+}
+
+/**
+ * Creates the map of element node sequences, and
  * if mesh dimension < MAXIMUM_ELEMENT_XI_DIMENSIONS fills it with sequences
  * for this element. Fails if any two faces have the same shape and nodes.
  */
 int FE_mesh::begin_define_faces()
 {
-	if (this->element_type_node_sequence_list)
+	if (this->elementNodeSequenceMap)
 	{
 		display_message(ERROR_MESSAGE, "FE_mesh::begin_define_faces.  Already defining faces");
 		return CMZN_ERROR_ALREADY_EXISTS;
 	}
-	this->element_type_node_sequence_list = CREATE(LIST(FE_element_type_node_sequence))();
-	if (!this->element_type_node_sequence_list)
-	{
-		display_message(ERROR_MESSAGE, "FE_mesh::begin_define_faces.  Could not create node sequence list");
-		return CMZN_ERROR_MEMORY;
-	}
+	this->elementNodeSequenceMap = new FE_element_node_sequence_map();
 	this->definingFaces = true;
-	int return_code = CMZN_OK;
 	if (this->dimension < MAXIMUM_ELEMENT_XI_DIMENSIONS)
 	{
-		cmzn_elementiterator_id iter = this->createElementiterator();
-		cmzn_element_id element = 0;
-		FE_element_type_node_sequence *element_type_node_sequence;
-		while (0 != (element = cmzn_elementiterator_next_non_access(iter)))
+		const DsLabelIndex elementsCount = this->getSize();
+		this->elementNodeSequenceMap->reserve(elementsCount, elementsCount*(1 << this->dimension));
+		DsLabelIterator *iter = this->labels.createLabelIterator();
+		if (!iter)
+			return CMZN_ERROR_MEMORY;
+		FE_element_node_sequences sequences;
+		DsLabelIndex elementIndex = iter->nextIndex();
+		while (DS_LABEL_INDEX_INVALID != elementIndex)
 		{
-			element_type_node_sequence = CREATE(FE_element_type_node_sequence)(return_code, element);
-			if (!element_type_node_sequence)
+			sequences.clear();
+			while ((DS_LABEL_INDEX_INVALID != elementIndex) && (sequences.size() < defineFacesElementsPerBatch))
 			{
-				if (CMZN_ERROR_NOT_FOUND == return_code)
-				{
-					return_code = CMZN_OK;
-					continue;
-				}
-				display_message(ERROR_MESSAGE, "FE_mesh::begin_define_faces.  "
-					"Could not create FE_element_type_node_sequence for %d-D element %d",
-					this->dimension, get_FE_element_identifier(element));
-				break;
+				sequences.add(this->getElement(elementIndex), /*faceNumber*/-1);
+				elementIndex = iter->nextIndex();
 			}
-			if (!ADD_OBJECT_TO_LIST(FE_element_type_node_sequence)(
-				element_type_node_sequence, this->element_type_node_sequence_list))
+			sequences.calculate();
+			for (size_t s = 0; s < sequences.size(); ++s)
 			{
-				display_message(WARNING_MESSAGE, "FE_mesh::begin_define_faces.  "
-					"Could not add FE_element_type_node_sequence for %d-D element %d.",
-					this->dimension, get_FE_element_identifier(element));
-				FE_element_type_node_sequence *existing_element_type_node_sequence =
-					FE_element_type_node_sequence_list_find_match(
-						this->element_type_node_sequence_list, element_type_node_sequence);
-				if (existing_element_type_node_sequence)
+				const FE_element_node_sequence& sequence = sequences.get(s);
+				if (CMZN_OK != sequence.result)
 				{
+					if (CMZN_ERROR_NOT_FOUND == sequence.result)
+						continue;
+					display_message(ERROR_MESSAGE, "FE_mesh::begin_define_faces.  "
+						"Could not get node sequence for %d-D element %d",
+						this->dimension, sequence.element->getIdentifier());
+					cmzn::Deaccess(iter);
+					return sequence.result;
+				}
+				const DsLabelIndex *nodeIndexes = sequences.getNodeIndexes(s);
+				const DsLabelIndex sequenceElementIndex = sequence.element->getIndex();
+				if (!this->elementNodeSequenceMap->add(nodeIndexes, sequence.nodesCount, sequence.hash, sequenceElementIndex))
+				{
+					display_message(WARNING_MESSAGE, "FE_mesh::begin_define_faces.  "
+						"Could not add node sequence for %d-D element %d.",
+						this->dimension, sequence.element->getIdentifier());
+					const DsLabelIndex existingElementIndex = this->elementNodeSequenceMap->find(nodeIndexes, sequence.nodesCount, sequence.hash);
 					display_message(WARNING_MESSAGE,
 						"Reason: Existing %d-D element %d uses same node list, and will be used for face matching.",
-						this->dimension, get_FE_element_identifier(
-							FE_element_type_node_sequence_get_FE_element(existing_element_type_node_sequence)));
+						this->dimension, this->getElementIdentifier(existingElementIndex));
 				}
-				DESTROY(FE_element_type_node_sequence)(&element_type_node_sequence);
 			}
 		}
-		cmzn_elementiterator_destroy(&iter);
+		cmzn::Deaccess(iter);
 	}
-	return return_code;
+	return CMZN_OK;
 }
 
 void FE_mesh::end_define_faces()
 {
-	if (this->element_type_node_sequence_list)
-		DESTROY(LIST(FE_element_type_node_sequence))(&this->element_type_node_sequence_list);
+	if (this->elementNodeSequenceMap)
+	{
+		delete this->elementNodeSequenceMap;
+		this->elementNodeSequenceMap = nullptr;
+	}
 	else
 		display_message(ERROR_MESSAGE, "FE_mesh::end_define_faces.  Wasn't defining faces");
 	this->definingFaces = false;
@@ -3050,6 +3285,8 @@ void FE_mesh::end_define_faces()
 /**
  * Ensures faces of elements in mesh exist in face mesh.
  * Recursively does same for faces in face mesh.
+ * Elements are processed in batches with node sequences for their faces
+ * calculated in parallel.
  * Call between begin/end_define_faces and begin/end_change.
  */
 int FE_mesh::define_faces()
@@ -3058,26 +3295,25 @@ int FE_mesh::define_faces()
 	if (!iter)
 		return CMZN_ERROR_GENERAL;
 	int return_code = CMZN_OK;
-	DsLabelIndex elementIndex;
+	std::vector<DsLabelIndex> elementIndexes;
+	elementIndexes.reserve(defineFacesElementsPerBatch);
 	int successCount = 0;
-	while ((elementIndex = iter->nextIndex()) != DS_LABEL_INDEX_INVALID)
+	int notFoundCount = 0;
+	DsLabelIndex elementIndex = iter->nextIndex();
+	while ((CMZN_OK == return_code) && (DS_LABEL_INDEX_INVALID != elementIndex))
 	{
-		const int result = this->defineElementFaces(elementIndex);
-		if (result != CMZN_OK)
+		elementIndexes.clear();
+		while ((DS_LABEL_INDEX_INVALID != elementIndex) && (elementIndexes.size() < defineFacesElementsPerBatch))
 		{
-			return_code = result;
-			if (result == CMZN_ERROR_NOT_FOUND)
-			{
-				continue;
-			}
-			break;
+			elementIndexes.push_back(elementIndex);
+			elementIndex = iter->nextIndex();
 		}
-		++successCount;
+		return_code = this->defineElementsFaces(elementIndexes, successCount, notFoundCount);
 	}
 	cmzn::Deaccess(iter);
-	if ((return_code == CMZN_ERROR_NOT_FOUND) && successCount)
+	if ((CMZN_OK == return_code) && (notFoundCount))
 	{
-		return_code = CMZN_WARNING_PART_DONE;
+		return_code = (successCount) ? CMZN_WARNING_PART_DONE : CMZN_ERROR_NOT_FOUND;
 	}
 	return return_code;
 }
@@ -3337,6 +3573,8 @@ FieldDerivative *FE_mesh::getHigherFieldDerivative(const FieldDerivative& fieldD
 
 FeMeshFieldRangesCache *FE_mesh::getFeMeshFieldRangesCache(cmzn_field *field)
 {
+	const std::unique_lock<std::recursive_mutex> lock =
+		cmzn_region::lockSharedObjects(FE_region_get_cmzn_region(this->fe_region));
 	std::map<cmzn_field *, FeMeshFieldRangesCache *>::iterator iter = this->meshFieldRangesCaches.find(field);
 	if (iter != this->meshFieldRangesCaches.end())
 	{
@@ -3351,6 +3589,8 @@ void FE_mesh::removeMeshFieldRangesCache(FeMeshFieldRangesCache *meshFieldRanges
 {
 	if (meshFieldRangesCache->getFeMesh() == this)
 	{
+		const std::unique_lock<std::recursive_mutex> lock =
+			cmzn_region::lockSharedObjects(FE_region_get_cmzn_region(this->fe_region));
 		this->meshFieldRangesCaches.erase(meshFieldRangesCache->getField());
 	}
 	else
@@ -25,6 +25,7 @@
 #include "general/block_array.hpp"
 #include "general/list.h"
 #include <algorithm>
+#include <atomic>
 #include <list>
 #include <map>
 #include <set>
@@ -32,6 +33,8 @@
 
 struct FE_field;
 
+class FE_element_node_sequence_map;
+
 class FE_mesh;
 
 class FE_mesh_field_template;
@@ -210,7 +213,8 @@ private:
 	// index into mesh labels, maps to unique identifier
 	DsLabelIndex index;
 	// the number of references held to this element; destroyed once reduces to 0
-	int access_count;
+	// atomic so elements can be accessed by concurrent evaluations in multiple threads
+	std::atomic_int access_count;
 
 	cmzn_element(FE_mesh *meshIn, DsLabelIndex indexIn) :
 		mesh(meshIn),
@@ -842,9 +846,8 @@ private:
 	FE_nodeset *nodeset; // not accessed
 
 	/* information for defining faces */
-	/* existence of element_type_node_sequence_list can tell us whether faces
-		 are being defined */
-	struct LIST(FE_element_type_node_sequence) *element_type_node_sequence_list;
+	// map from node index sequences to elements, exists only while defining faces
+	FE_element_node_sequence_map *elementNodeSequenceMap;
 	bool definingFaces;
 
 	FieldDerivative *fieldDerivatives[MAXIMUM_MESH_DERIVATIVE_ORDER];
@@ -866,6 +869,12 @@ private:
 
 	int findOrCreateFace(DsLabelIndex parentIndex, int faceNumber, DsLabelIndex& faceIndex);
 
+	int findOrCreateFaceWithNodes(DsLabelIndex parentIndex, int faceNumber,
+		const DsLabelIndex *nodeIndexes, int nodesCount, size_t hash, DsLabelIndex& faceIndex);
+
+	int defineElementsFaces(const std::vector<DsLabelIndex>& elementIndexes,
+		int& successCount, int& notFoundCount);
+
 	void cleanupElementPrivate(DsLabelIndex elementIndex);
 
 	void beginDestroyElements();
@@ -20,8 +20,163 @@
 #include "region/cmiss_region.hpp"
 #include "mesh/mesh.hpp"
 #include "mesh/mesh_group.hpp"
+#include <algorithm>
 #include <vector>
 
+namespace {
+
+/** Maximum number of elements in a leaf node of FeMeshFieldRangesTree */
+const int FE_MESH_FIELD_RANGES_TREE_LEAF_SIZE = 8;
+
+}
+
+void FeMeshFieldRangesTree::buildNode(int nodeIndex, const FeMeshFieldRanges& meshFieldRanges,
+	std::vector<FE_value>& centres)
+{
+	const int first = this->nodes[nodeIndex].first;
+	const int count = this->nodes[nodeIndex].count;
+	// get node range enclosing all its elements
+	FE_value *minimums = this->nodeRanges.data() + static_cast<size_t>(nodeIndex)*2*this->componentsCount;
+	FE_value *maximums = minimums + this->componentsCount;
+	for (int e = first; e < first + count; ++e)
+	{
+		const FE_value *elementRanges = meshFieldRanges.getElementFieldRange(this->elementIndexes[e])->ranges;
+		for (int c = 0; c < this->componentsCount; ++c)
+		{
+			if ((e == first) || (elementRanges[c] < minimums[c]))
+			{
+				minimums[c] = elementRanges[c];
+			}
+			if ((e == first) || (elementRanges[c + this->componentsCount] > maximums[c]))
+			{
+				maximums[c] = elementRanges[c + this->componentsCount];
+			}
+		}
+	}
+	if (count <= FE_MESH_FIELD_RANGES_TREE_LEAF_SIZE)
+	{
+		return;
+	}
+	// split at median centre on component with greatest range
+	int splitComponent = 0;
+	FE_value maxRange = -1.0;
+	for (int c = 0; c < this->componentsCount; ++c)
+	{
+		if ((maximums[c] - minimums[c]) > maxRange)
+		{
+			maxRange = maximums[c] - minimums[c];
+			splitComponent = c;
+		}
+	}
+	for (int e = first; e < first + count; ++e)
+	{
+		const FE_value *elementRanges = meshFieldRanges.getElementFieldRange(this->elementIndexes[e])->ranges;
+		centres[this->elementIndexes[e]] = elementRanges[splitComponent] + elementRanges[splitComponent + this->componentsCount];
+	}
+	const int half = count / 2;
+	std::nth_element(this->elementIndexes.begin() + first, this->elementIndexes.begin() + first + half,
+		this->elementIndexes.begin() + first + count,
+		[&centres](DsLabelIndex a, DsLabelIndex b) { return centres[a] < centres[b]; });
+	const int child = static_cast<int>(this->nodes.size());
+	this->nodes[nodeIndex].child = child;
+	const Node firstChild = { first, half, -1 };
+	const Node secondChild = { first + half, count - half, -1 };
+	this->nodes.push_back(firstChild);
+	this->nodes.push_back(secondChild);
+	this->nodeRanges.resize(this->nodes.size()*2*this->componentsCount);
+	// note vectors may have been reallocated
+	this->buildNode(child, meshFieldRanges, centres);
+	this->buildNode(child + 1, meshFieldRanges, centres);
+}
+
+void FeMeshFieldRangesTree::build(int componentsCountIn, const FeMeshFieldRanges& meshFieldRanges,
+	std::vector<DsLabelIndex>& elementIndexesIn)
+{
+	this->clear();
+	if (elementIndexesIn.empty())
+	{
+		return;
+	}
+	this->componentsCount = componentsCountIn;
+	this->elementIndexes.swap(elementIndexesIn);
+	const int elementsCount = static_cast<int>(this->elementIndexes.size());
+	// binary tree with small leaves has fewer than this many nodes:
+	const size_t nodesCountEstimate = 4*(elementsCount/FE_MESH_FIELD_RANGES_TREE_LEAF_SIZE + 1);
+	this->nodes.reserve(nodesCountEstimate);
+	this->nodeRanges.reserve(nodesCountEstimate*2*this->componentsCount);
+	const Node root = { 0, elementsCount, -1 };
+	this->nodes.push_back(root);
+	this->nodeRanges.resize(2*this->componentsCount);
+	// temporary storage for element centres, indexed by element index
+	DsLabelIndex maxElementIndex = *std::max_element(this->elementIndexes.begin(), this->elementIndexes.end());
+	std::vector<FE_value> centres(maxElementIndex + 1);
+	this->buildNode(0, meshFieldRanges, centres);
+}
+
+FeMeshFieldRangesTree::Search::Search(const FeMeshFieldRangesTree& treeIn,
+		const FeMeshFieldRanges& meshFieldRangesIn, const FE_value *valuesIn) :
+	tree(treeIn),
+	meshFieldRanges(meshFieldRangesIn),
+	values(valuesIn)
+{
+	if (!tree.isEmpty())
+	{
+		this->queue.push(Entry(getDistanceToRange(tree.componentsCount, tree.nodeRanges.data(), this->values), 0));
+	}
+}
+
+DsLabelIndex FeMeshFieldRangesTree::Search::next(FE_value tolerance)
+{
+	const int componentsCount = this->tree.componentsCount;
+	while (!this->queue.empty())
+	{
+		const Entry entry = this->queue.top();
+		if (entry.first > tolerance)
+		{
+			// all remaining are further away, and tolerance cannot increase
+			this->queue = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> >();
+			break;
+		}
+		this->queue.pop();
+		if (entry.second < 0)
+		{
+			return this->tree.elementIndexes[-1 - entry.second];
+		}
+		const Node& node = this->tree.nodes[entry.second];
+		if (node.child >= 0)
+		{
+			for (int n = node.child; n <= node.child + 1; ++n)
+			{
+				const FE_value distance = getDistanceToRange(componentsCount,
+					this->tree.nodeRanges.data() + static_cast<size_t>(n)*2*componentsCount, this->values);
+				if (distance <= tolerance)
+				{
+					this->queue.push(Entry(distance, n));
+				}
+			}
+		}
+		else
+		{
+			for (int e = node.first; e < node.first + node.count; ++e)
+			{
+				// elements destroyed since tree was built have no range
+				const FeElementFieldRange *elementFieldRange =
+					this->meshFieldRanges.getElementFieldRange(this->tree.elementIndexes[e]);
+				if (elementFieldRange)
+				{
+					const FE_value distance = getDistanceToRange(componentsCount, elementFieldRange->ranges, this->values);
+					if (distance <= tolerance)
+					{
+						this->queue.push(Entry(distance, -1 - e));
+					}
+				}
+			}
+		}
+	}
+	return DS_LABEL_INDEX_INVALID;
+}
+
+
 
 FeMeshFieldRanges::FeMeshFieldRanges(FeMeshFieldRangesCache* meshFieldRangesCacheIn, cmzn_mesh_group* meshGroupIn) :
 	meshFieldRangesCache(meshFieldRangesCacheIn),
@@ -69,6 +224,8 @@ void FeMeshFieldRanges::clearRanges()
 	this->elementFieldRanges.clear();
 	delete this->totalRange;
 	this->totalRange = nullptr;
+	this->rangesTree.clear();
+	this->unrangedElementIndexes.clear();
 	this->tolerance = 0.0;
 	this->evaluated = false;
 }
@@ -148,8 +305,11 @@ void FeMeshFieldRangesCache::deaccess(FeMeshFieldRangesCache*& meshFieldRangesCa
 {
 	if (meshFieldRangesCache)
 	{
-		--(meshFieldRangesCache->access_count);
-		if (meshFieldRangesCache->access_count <= 0)
+		// lock as mesh may be finding this cache for a concurrent evaluation
+		FE_mesh *feMesh = meshFieldRangesCache->feMesh;
+		const std::unique_lock<std::recursive_mutex> lock = cmzn_region::lockSharedObjects(
+			(feMesh) ? FE_region_get_cmzn_region(feMesh->get_FE_region()) : nullptr);
+		if (--(meshFieldRangesCache->access_count) <= 0)
 		{
 			delete meshFieldRangesCache;
 		}
@@ -188,6 +348,8 @@ void FeMeshFieldRangesCache::evaluateMeshFieldRanges(cmzn_fieldcache& fieldcache
 	double *maximums = values.data() + componentsCount;
 
 	FeElementFieldRange *totalRange = nullptr;
+	std::vector<DsLabelIndex> rangedElementIndexes;
+	std::vector<DsLabelIndex> unrangedElementIndexes;
 	cmzn_mesh_group *meshGroup = meshFieldRanges->getMeshGroup();
 	const DsLabelsGroup* labelsGroup = (meshGroup) ? meshGroup->getLabelsGroup() : nullptr;
 	cmzn_elementiterator *elemIter = this->feMesh->createElementiterator(labelsGroup);
@@ -220,11 +382,17 @@ void FeMeshFieldRangesCache::evaluateMeshFieldRanges(cmzn_fieldcache& fieldcache
 			{
 				meshFieldRanges->setElementFieldRange(elementIndex, elementFieldRange);
 			}
+			rangedElementIndexes.push_back(elementIndex);
+		}
+		else
+		{
+			unrangedElementIndexes.push_back(elementIndex);
 		}
 	}
     cmzn_elementiterator_destroy(&elemIter);
 	cmzn_fieldrange::deaccess(fieldrange);
 	meshFieldRanges->setTotalRange(componentsCount, totalRange);
+	meshFieldRanges->setElementIndexes(componentsCount, rangedElementIndexes, unrangedElementIndexes);
 	meshFieldRanges->setEvaluated();
 }
 
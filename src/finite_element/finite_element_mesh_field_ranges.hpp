@@ -21,6 +21,8 @@
 #include <map>
 #include <atomic>
 #include <mutex>
+#include <queue>
+#include <vector>
 
 
 class FE_mesh;
@@ -113,6 +115,115 @@ public:
 
 };
 
+class FeMeshFieldRanges;
+
+/**
+ * Bounding volume hierarchy over element field ranges, for quickly finding
+ * elements whose ranges are within a tolerance of field values.
+ * Built once when ranges are evaluated; destroyed elements are skipped by
+ * the search as their ranges are cleared from the owning FeMeshFieldRanges.
+ */
+class FeMeshFieldRangesTree
+{
+public:
+	class Search;
+
+private:
+	struct Node
+	{
+		int first;  // index of first element in elementIndexes
+		int count;  // number of elements under node
+		int child;  // index of first of 2 consecutive child nodes, or -1 if leaf
+	};
+
+	int componentsCount;
+	std::vector<Node> nodes;
+	std::vector<FE_value> nodeRanges;  // minimums then maximums for each node
+	std::vector<DsLabelIndex> elementIndexes;  // ordered so each node covers a contiguous range
+
+	void buildNode(int nodeIndex, const FeMeshFieldRanges& meshFieldRanges,
+		std::vector<FE_value>& centres);
+
+public:
+
+	FeMeshFieldRangesTree() :
+		componentsCount(0)
+	{
+	}
+
+	/** Build tree over supplied elements, all of which must have ranges.
+	 * @param elementIndexesIn  Indexes of elements to build tree for. Swapped
+	 * into tree; vector is left empty. */
+	void build(int componentsCountIn, const FeMeshFieldRanges& meshFieldRanges,
+		std::vector<DsLabelIndex>& elementIndexesIn);
+
+	void clear()
+	{
+		this->componentsCount = 0;
+		this->nodes.clear();
+		this->nodeRanges.clear();
+		this->elementIndexes.clear();
+	}
+
+	bool isEmpty() const
+	{
+		return this->nodes.empty();
+	}
+
+	/**
+	 * @return  Maximum over all components of distance of values outside range,
+	 * or 0.0 if values are within range. Range is minimums then maximums.
+	 */
+	static FE_value getDistanceToRange(int componentsCount, const FE_value *ranges, const FE_value *values)
+	{
+		const FE_value *maximums = ranges + componentsCount;
+		FE_value distance = 0.0;
+		for (int i = 0; i < componentsCount; ++i)
+		{
+			if (values[i] < ranges[i])
+			{
+				if ((ranges[i] - values[i]) > distance)
+				{
+					distance = ranges[i] - values[i];
+				}
+			}
+			else if (values[i] > maximums[i])
+			{
+				if ((values[i] - maximums[i]) > distance)
+				{
+					distance = values[i] - maximums[i];
+				}
+			}
+		}
+		return distance;
+	}
+
+	/**
+	 * Iterates over elements in order of increasing distance of their ranges
+	 * from values, measured as maximum distance outside range of any component.
+	 */
+	class Search
+	{
+		typedef std::pair<FE_value, int> Entry;  // distance, node index or -1 - element position
+		const FeMeshFieldRangesTree& tree;
+		const FeMeshFieldRanges& meshFieldRanges;
+		const FE_value *values;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+
+	public:
+		/** @param valuesIn  Values to search for; must persist for lifetime of search. */
+		Search(const FeMeshFieldRangesTree& treeIn, const FeMeshFieldRanges& meshFieldRangesIn,
+			const FE_value *valuesIn);
+
+		/**
+		 * Get next element with range within tolerance of values.
+		 * Tolerance must not be increased over successive calls.
+		 * @return  Element index or DS_LABEL_INDEX_INVALID if no more in tolerance.
+		 */
+		DsLabelIndex next(FE_value tolerance);
+	};
+
+};
 
 /**
  * Ranges of elements for field on mesh for a particular group or the whole mesh.
@@ -125,6 +236,8 @@ class FeMeshFieldRanges
 	// Note: owns and frees FeElementFieldRange objects only if no fieldElementGroup
 	block_array<DsLabelIndex, const FeElementFieldRange *> elementFieldRanges;
 	FeElementFieldRange *totalRange;  // total range of whole mesh, if valid
+	FeMeshFieldRangesTree rangesTree;  // hierarchy of element ranges, built on evaluation
+	std::vector<DsLabelIndex> unrangedElementIndexes;  // elements in mesh for which range could not be evaluated
 	FE_value tolerance;  // a fraction of the totalRange to cover approximation in each element
 	bool evaluated;  // true if ranges have been evaluate (but client must check field has not been modified)
 	std::atomic_int access_count;
@@ -179,6 +292,26 @@ public:
 		return this->elementFieldRanges.setValue(elementIndex, elementFieldRange);
 	}
 
+	/** @return  Hierarchy of element ranges; empty if not evaluated */
+	const FeMeshFieldRangesTree& getRangesTree() const
+	{
+		return this->rangesTree;
+	}
+
+	/** @return  Indexes of elements in mesh which have no range, at time of evaluation */
+	const std::vector<DsLabelIndex>& getUnrangedElementIndexes() const
+	{
+		return this->unrangedElementIndexes;
+	}
+
+	// only set by mutex-protected evaluate code
+	void setElementIndexes(int componentsCount, std::vector<DsLabelIndex>& rangedElementIndexes,
+		std::vector<DsLabelIndex>& unrangedElementIndexesIn)
+	{
+		this->rangesTree.build(componentsCount, *this, rangedElementIndexes);
+		this->unrangedElementIndexes.swap(unrangedElementIndexesIn);
+	}
+
 	/** @return  Optional mesh group the ranges are for */
 	cmzn_mesh_group* getMeshGroup() const
 	{
@@ -220,7 +353,7 @@ class FeMeshFieldRangesCache : public FE_domain_mapper
 	std::map<cmzn_mesh_group*, FeMeshFieldRanges*> groupRanges;  // ranges for particular mesh groups
 	// because cache is shared between threads, must lock evaluateMutex when evaluating ranges
 	std::mutex evaluateMutex;
-	int access_count;
+	std::atomic_int access_count;
 
 public:
 	FeMeshFieldRangesCache(FE_mesh *feMeshIn, cmzn_field *fieldIn);
@@ -109,7 +109,7 @@ cmzn_node::~cmzn_node()
 	if (0 != this->access_count)
 	{
 		display_message(ERROR_MESSAGE,
-			"cmzn_node::~cmzn_node.  Node has non-zero access count %d", this->access_count);
+			"cmzn_node::~cmzn_node.  Node has non-zero access count %d", static_cast<int>(this->access_count));
 	}
 	else if (DS_LABEL_IDENTIFIER_INVALID != this->index)
 	{
@@ -22,6 +22,7 @@
 #include "general/enumerator.h"
 #include "general/list.h"
 #include "general/value.h"
+#include <atomic>
 #include <list>
 
 class FE_nodeset;
@@ -154,8 +155,9 @@ public:
 	DsLabelIndex index;
 
 	/** the number of structures that point to this node.  The node cannot be
-	 * destroyed while this is greater than 0 */
-	int access_count;
+	 * destroyed while this is greater than 0. Atomic as nodes may be accessed
+	 * by concurrent evaluations */
+	std::atomic_int access_count;
 
 	/* the fields defined at the node */
 	struct FE_node_field_info *fields;
@@ -757,6 +757,11 @@ struct LIST(FE_element_shape) *FE_region_get_FE_element_shape_list(
 	return 0;
 }
 
+std::recursive_mutex &FE_region_get_bases_and_shapes_mutex(struct FE_region *fe_region)
+{
+	return fe_region->bases_and_shapes->getMutex();
+}
+
 struct FE_element *FE_region_get_top_level_FE_element_from_identifier(
 	struct FE_region *fe_region, int identifier)
 {
@@ -1104,7 +1109,10 @@ struct FE_basis *FE_region_get_FE_basis_matching_basis_type(
 	struct FE_region *fe_region, int *basis_type)
 {
 	if (fe_region && basis_type)
+	{
+		const std::lock_guard<std::recursive_mutex> lock(fe_region->bases_and_shapes->getMutex());
 		return make_FE_basis(basis_type, fe_region->bases_and_shapes->getBasisManager());
+	}
 	return 0;
 }
 
@@ -1126,6 +1134,7 @@ struct FE_basis *FE_region_get_constant_FE_basis_of_dimension(
 			++type;
 		}
 	}
+	const std::lock_guard<std::recursive_mutex> lock(fe_region->bases_and_shapes->getMutex());
 	return make_FE_basis(basisType, fe_region->bases_and_shapes->getBasisManager());
 }
 
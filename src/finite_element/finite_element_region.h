@@ -20,6 +20,7 @@ finite element fields defined on or interpolated over them.
 #include "general/change_log.h"
 #include "general/object.h"
 #include "region/cmiss_region.hpp"
+#include <mutex>
 
 /*
 Global types
@@ -337,6 +338,14 @@ struct LIST(FE_field) *FE_region_get_FE_field_list(struct FE_region *fe_region);
 struct LIST(FE_element_shape) *FE_region_get_FE_element_shape_list(
 	struct FE_region *fe_region);
 
+/**
+ * Returns the mutex to lock while finding or creating element bases and shapes,
+ * which are shared by all regions in the context. Regions may be read
+ * concurrently, so this must be held while using the basis manager or element
+ * shape list.
+ */
+std::recursive_mutex &FE_region_get_bases_and_shapes_mutex(struct FE_region *fe_region);
+
 /***************************************************************************//**
  * Returns the top-level element of the highest dimension with the supplied
  * identifier in fe_region, or NULL without error if none.
@@ -30,6 +30,8 @@ class FE_region_bases_and_shapes
 {
 	struct MANAGER(FE_basis) *basis_manager;
 	struct LIST(FE_element_shape) *element_shape_list;
+	// guards finding and creating bases and shapes from concurrent region reads
+	std::recursive_mutex mutex;
 	int access_count;
 
 	FE_region_bases_and_shapes();
@@ -66,6 +68,11 @@ public:
 	{
 		return this->element_shape_list;
 	}
+
+	std::recursive_mutex& getMutex()
+	{
+		return this->mutex;
+	}
 };
 
 struct FE_region
@@ -157,12 +164,13 @@ public:
 	 */
 	void updateRegion();
 
-	/** records change but does no update check; call FE_region::update if needed */
+	/** records change but does no update check; call FE_region::update if needed.
+	 * Change is not recorded if refused because region is frozen */
 	inline void FE_field_change(FE_field *fe_field, enum CHANGE_LOG_CHANGE(FE_field) change)
 	{
+		if ((this->cmiss_region) && (CMZN_OK != this->cmiss_region->setFieldModify()))
+			return;
 		CHANGE_LOG_OBJECT_CHANGE(FE_field)(this->fe_field_changes, fe_field, change);
-		if (this->cmiss_region)
-			this->cmiss_region->setFieldModify();
 	}
 
 	/** records related change to FE_field but does not call setFieldModify as expect to be
@@ -175,9 +183,9 @@ public:
 	/** record change to all fields in region */
 	inline void FE_field_all_change(enum CHANGE_LOG_CHANGE(FE_field) change)
 	{
+		if ((this->cmiss_region) && (CMZN_OK != this->cmiss_region->setFieldModify()))
+			return;
 		CHANGE_LOG_ALL_CHANGE(FE_field)(this->fe_field_changes, change);
-		if (this->cmiss_region)
-			this->cmiss_region->setFieldModify();
 	}
 
 	/** records change not specific to an FE_field, e.g. node identifier change */
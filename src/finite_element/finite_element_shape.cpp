@@ -9,7 +9,9 @@
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <atomic>
 #include <cmath>
+#include <mutex>
 #include "finite_element/finite_element_region.h"
 #include "finite_element/finite_element_shape.hpp"
 #include "general/debug.h"
@@ -125,8 +127,9 @@ coordinates from face coordinates.
 		The transformations are stored by row (ie. column number varying fastest) */
 	FE_value *face_to_element;
 	/* the number of structures that point to this shape.  The shape cannot be
-		destroyed while this is greater than 0 */
-	int access_count;
+		destroyed while this is greater than 0. Atomic as shapes are shared by
+		regions read concurrently */
+	std::atomic_int access_count;
 }; /* struct FE_element_shape */
 
 FULL_DECLARE_LIST_TYPE(FE_element_shape);
@@ -272,6 +275,10 @@ it is given a proper shape.
 /*printf("enter CREATE(FE_element_shape)\n");*/
 	if (dimension > 0)
 	{
+		// shapes are shared by all regions in context, which may be read concurrently
+		std::unique_lock<std::recursive_mutex> lock;
+		if (fe_region)
+			lock = std::unique_lock<std::recursive_mutex>(FE_region_get_bases_and_shapes_mutex(fe_region));
 		/* check if the shape already exists */
 		if (!(shape = find_FE_element_shape_in_list(dimension, type,
 			FE_region_get_FE_element_shape_list(fe_region))))
@@ -10,8 +10,11 @@ The functions for creating graphical objects from finite elements.
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 #include <limits.h>
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <string>
+#include <vector>
 #include "cmlibs/zinc/differentialoperator.h"
 #include "cmlibs/zinc/fieldcache.h"
 #include "cmlibs/zinc/mesh.h"
@@ -25,6 +28,7 @@ The functions for creating graphical objects from finite elements.
 #include "finite_element/finite_element_adjacent_elements.h"
 #include "finite_element/finite_element_discretization.h"
 #include "finite_element/finite_element_mesh.hpp"
+#include "finite_element/finite_element_nodeset.hpp"
 #include "finite_element/finite_element_region.h"
 #include "finite_element/finite_element_to_graphics_object.h"
 #include "finite_element/finite_element_to_iso_lines.h"
@@ -42,6 +46,7 @@ The functions for creating graphical objects from finite elements.
 #include "graphics/mcubes.h"
 #include "general/message.h"
 #include "graphics/graphics_object.hpp"
+#include "mesh/nodeset.hpp"
 
 /*
 Module types
@@ -887,6 +892,167 @@ struct GT_glyphset_vertex_buffers *Nodeset_create_vertex_array(
 	return glyphset;
 }
 
+int Nodeset_update_vertex_array(
+	cmzn_nodeset_id nodeset, cmzn_fieldcache_id field_cache,
+	struct GT_object *graphics_object,
+	int changedNodesCount, const DsLabelIndex *changedNodeIndexes,
+	cmzn_field* coordinate_field,
+	cmzn_field* data_field,
+	cmzn_field* orientation_scale_field,
+	cmzn_field* variable_scale_field,
+	cmzn_field* label_field,
+	cmzn_field* label_density_field,
+	cmzn_field* subgroup_field,
+	cmzn_field* selection_group_field,
+	struct GT_object *glyph,
+	const FE_value *base_size, const FE_value *offset, const FE_value *scale_factors,
+	enum cmzn_graphics_select_mode select_mode)
+{
+	Graphics_vertex_array *array = (graphics_object) ? GT_object_get_vertex_set(graphics_object) : 0;
+	if (!(nodeset && field_cache && array && coordinate_field && (0 < changedNodesCount) && changedNodeIndexes &&
+		(g_GLYPH_SET_VERTEX_BUFFERS == GT_object_get_type(graphics_object)) &&
+		(CMZN_GRAPHICS_SELECT_MODE_OFF != select_mode) && base_size && offset && scale_factors))
+		return 0;
+	// label bounds depend on glyph scale and are only evaluated with all points
+	if (glyph && Graphics_object_get_glyph_labels_function(glyph))
+		return 0;
+	// must have single glyph set with node names for all points
+	const unsigned int pointsCount = array->get_number_of_vertices(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_POSITION);
+	int *names = 0;
+	unsigned int *indexCounts = 0;
+	unsigned int valuesPerVertex = 0, namesCount = 0, objectsCount = 0;
+	if (!((0 < pointsCount) &&
+		array->get_integer_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_VERTEX_ID,
+			&names, &valuesPerVertex, &namesCount) && names && (namesCount == pointsCount) &&
+		array->get_unsigned_integer_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_COUNT,
+			&indexCounts, &valuesPerVertex, &objectsCount) && (1 == objectsCount) && (pointsCount == indexCounts[0])))
+		return 0;
+	const int n_data_components = (data_field) ? cmzn_field_get_number_of_components(data_field) : 0;
+	if ((0 < n_data_components) != (0 < array->get_number_of_vertices(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_DATA)))
+		return 0;
+
+	std::vector<DsLabelIndex> nodeIndexes(changedNodeIndexes, changedNodeIndexes + changedNodesCount);
+	std::sort(nodeIndexes.begin(), nodeIndexes.end());
+	nodeIndexes.erase(std::unique(nodeIndexes.begin(), nodeIndexes.end()), nodeIndexes.end());
+	// find existing points for changed nodes in one pass
+	std::vector<int> vertexLocations(nodeIndexes.size(), -1);
+	for (unsigned int v = 0; v < pointsCount; ++v)
+	{
+		std::vector<DsLabelIndex>::const_iterator iter = std::lower_bound(nodeIndexes.begin(), nodeIndexes.end(), names[v]);
+		if ((iter != nodeIndexes.end()) && (*iter == names[v]))
+			vertexLocations[iter - nodeIndexes.begin()] = static_cast<int>(v);
+	}
+
+	Triple point, axis1, axis2, axis3, scale, label_density;
+	std::vector<GLfloat> data(n_data_components);
+	std::vector<FE_value> data_values(n_data_components);
+	char *label = 0;
+	int name = 0;
+	Glyph_set_data glyph_set_data;
+	for (int i = 0; i < 3; i++)
+	{
+		glyph_set_data.base_size[i] = base_size[i];
+		glyph_set_data.offset[i] = offset[i];
+		glyph_set_data.scale_factors[i] = scale_factors[i];
+	}
+	glyph_set_data.coordinate_field = coordinate_field;
+	glyph_set_data.orientation_scale_field = orientation_scale_field;
+	glyph_set_data.variable_scale_field = variable_scale_field;
+	glyph_set_data.data_field = data_field;
+	glyph_set_data.n_data_components = n_data_components;
+	glyph_set_data.data_values = data_values.data();
+	glyph_set_data.label_field = label_field;
+	glyph_set_data.label_density_field = label_density_field;
+	glyph_set_data.subgroup_field = subgroup_field;
+	glyph_set_data.label_bounds_bit_pattern = 0;
+	glyph_set_data.label_bounds_components = 0;
+	glyph_set_data.label_bounds_dimension = 0;
+	glyph_set_data.label_bounds_field = 0;
+	glyph_set_data.label_bounds_values = 0;
+	glyph_set_data.label_bounds_vector = 0;
+	glyph_set_data.label_bounds = 0;
+	glyph_set_data.group_field = selection_group_field;
+	glyph_set_data.select_mode = select_mode;
+	FE_nodeset *feNodeset = nodeset->getFeNodeset();
+	int return_code = 1;
+	for (size_t n = 0; (n < nodeIndexes.size()) && return_code; ++n)
+	{
+		glyph_set_data.number_of_points = 0;
+		glyph_set_data.point = &point;
+		glyph_set_data.axis1 = &axis1;
+		glyph_set_data.axis2 = &axis2;
+		glyph_set_data.axis3 = &axis3;
+		glyph_set_data.scale = &scale;
+		glyph_set_data.data = data.data();
+		glyph_set_data.label = (label_field) ? &label : 0;
+		glyph_set_data.label_density = (label_density_field) ? &label_density : 0;
+		glyph_set_data.name = &name;
+		cmzn_node *node = feNodeset->getNode(nodeIndexes[n]);
+		if ((node) && nodeset->containsNode(node))
+		{
+			cmzn_fieldcache_set_node(field_cache, node);
+			glyph_set_data.graphics_name = nodeIndexes[n];
+			return_code = field_cache_location_to_glyph_point(field_cache, &glyph_set_data);
+		}
+		const int location = vertexLocations[n];
+		if (!(return_code && (0 < glyph_set_data.number_of_points)))
+		{
+			// removing points is not supported
+			if (location >= 0)
+				return_code = 0;
+		}
+		else if (location >= 0)
+		{
+			array->replace_float_vertex_buffer_at_position(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_POSITION, location, 3, 1, point);
+			array->replace_float_vertex_buffer_at_position(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_AXIS1, location, 3, 1, axis1);
+			array->replace_float_vertex_buffer_at_position(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_AXIS2, location, 3, 1, axis2);
+			array->replace_float_vertex_buffer_at_position(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_AXIS3, location, 3, 1, axis3);
+			array->replace_float_vertex_buffer_at_position(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_SCALE, location, 3, 1, scale);
+			if (label_density_field)
+				array->replace_float_vertex_buffer_at_position(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_LABEL_DENSITY, location, 3, 1, label_density);
+			if (label_field)
+			{
+				std::string *labels = 0;
+				unsigned int labelsCount = 0;
+				if (array->get_string_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_LABEL,
+					&labels, &valuesPerVertex, &labelsCount) && labels && (static_cast<unsigned int>(location) < labelsCount))
+					labels[location] = (label) ? label : "";
+				else
+					return_code = 0;
+			}
+			if (n_data_components)
+				array->replace_float_vertex_buffer_at_position(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_DATA, location, n_data_components, 1, data.data());
+		}
+		else
+		{
+			// append in the same order as fill_glyph_graphics_vertex_array
+			array->add_float_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_POSITION, 3, 1, point);
+			array->add_float_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_AXIS1, 3, 1, axis1);
+			array->add_float_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_AXIS2, 3, 1, axis2);
+			array->add_float_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_AXIS3, 3, 1, axis3);
+			array->add_float_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_SCALE, 3, 1, scale);
+			if (label_density_field)
+				array->add_float_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_LABEL_DENSITY, 3, 1, label_density);
+			if (label_field)
+			{
+				std::string labelString((label) ? label : "");
+				array->add_string_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_LABEL, 1, 1, &labelString);
+			}
+			array->add_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_VERTEX_ID, 1, 1, &name);
+			if (n_data_components)
+				array->add_float_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_DATA, n_data_components, 1, data.data());
+			// buffer may have moved
+			if (array->get_unsigned_integer_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_COUNT,
+				&indexCounts, &valuesPerVertex, &objectsCount) && (1 == objectsCount))
+				++(indexCounts[0]);
+			else
+				return_code = 0;
+		}
+		DEALLOCATE(label);
+	}
+	return return_code;
+}
+
 int FE_element_add_line_to_vertex_array(struct FE_element *element,
 	cmzn_fieldcache_id field_cache, struct Graphics_vertex_array *array,
 	cmzn_field* coordinate_field,
@@ -2449,15 +2615,10 @@ int FE_element_add_surface_to_vertex_array(struct FE_element *element,
 		}
 		if (replaceRequired)
 		{
-			unsigned int number_of_vertices = number_of_points;
 			int updated = 0;
 			array->replace_integer_vertex_buffer_at_position(
 				GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_UPDATE_REQUIRED,
 				vertex_location, 1, 1, &updated);
-			array->add_unsigned_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_PARTIAL_REDRAW,
-					1, 1, &vertex_start);
-			array->add_unsigned_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_PARTIAL_REDRAW_COUNT,
-					1, 1, &number_of_vertices);
 		}
 
 		delete[] floatData;
@@ -168,6 +168,37 @@ Notes:
 - the coordinate system of the variable_scale_field is ignored/not used.
 ==============================================================================*/
 
+/**
+ * Updates points for changed nodes in the glyph set vertex array previously
+ * created for the nodeset by Nodeset_create_vertex_array with the same
+ * arguments. Points for changed nodes already in the array are replaced in
+ * place and points for nodes not yet in the array are appended to it, so only
+ * the changed nodes are evaluated.
+ * Requires node names, i.e. select_mode is not OFF. Not supported for glyphs
+ * with label bounds.
+ * @param changedNodesCount  Number of changed node indexes.
+ * @param changedNodeIndexes  Indexes of changed nodes in the nodeset's labels,
+ * in any order and possibly repeated.
+ * @return  1 if points were updated, 0 if not possible including if the point
+ * for any node must be removed; the caller must then create all points again
+ * as the vertex array may have been partly modified.
+ */
+int Nodeset_update_vertex_array(
+	cmzn_nodeset_id nodeset, cmzn_fieldcache_id field_cache,
+	struct GT_object *graphics_object,
+	int changedNodesCount, const DsLabelIndex *changedNodeIndexes,
+	cmzn_field* coordinate_field,
+	cmzn_field* data_field,
+	cmzn_field* orientation_scale_field,
+	cmzn_field* variable_scale_field,
+	cmzn_field* label_field,
+	cmzn_field* label_density_field,
+	cmzn_field* subgroup_field,
+	cmzn_field* selection_group_field,
+	struct GT_object *glyph,
+	const FE_value *base_size, const FE_value *offset, const FE_value *scale_factors,
+	enum cmzn_graphics_select_mode select_mode);
+
 /***************************************************************************//**
  * Adds vertex values to the supplied vertex array to create a line representing
  * the 1-D finite element.
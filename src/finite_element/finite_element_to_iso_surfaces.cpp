@@ -8,8 +8,13 @@
 * This Source Code Form is subject to the terms of the Mozilla Public
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <list>
 #include <map>
+#include <unordered_map>
+#include <vector>
 #include "cmlibs/zinc/differentialoperator.h"
 #include "cmlibs/zinc/fieldcache.h"
 #include "cmlibs/zinc/mesh.h"
@@ -2025,6 +2030,19 @@ int Isosurface_builder::fill_graphics(struct Graphics_vertex_array *array)
 	return (return_code);
 }
 
+/** Welding tolerance relative to the largest extent or magnitude of iso-surface
+ * coordinates. Covers a few single precision rounding differences between
+ * crossings evaluated in neighbouring elements, while remaining far smaller
+ * than any tessellation. */
+const double ISO_SURFACE_WELD_TOLERANCE = 2.0E-6;
+
+/** Key of cell of welding tolerance size at integer location i, j, k >= -1 */
+inline uint64_t iso_weld_cell_key(int i, int j, int k)
+{
+	return ((static_cast<uint64_t>(i + 1) << 42) |
+		(static_cast<uint64_t>(j + 1) << 21) | static_cast<uint64_t>(k + 1));
+}
+
 } // anonymous namespace
 
 /*
@@ -2164,3 +2182,177 @@ int create_iso_surfaces_from_FE_element(struct FE_element *element,
 	return (return_code);
 } /* create_iso_surfaces_from_FE_element */
 
+
+int weld_iso_surface_vertices(struct Graphics_vertex_array *array)
+{
+	if (!array)
+	{
+		display_message(ERROR_MESSAGE, "weld_iso_surface_vertices.  Invalid argument(s)");
+		return 0;
+	}
+	GLfloat *positions = 0, *normals = 0;
+	unsigned int position_values_per_vertex = 0, vertex_count = 0,
+		normal_values_per_vertex = 0, normal_vertex_count = 0;
+	if ((!array->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_POSITION,
+			&positions, &position_values_per_vertex, &vertex_count)) ||
+		(0 == vertex_count) || (position_values_per_vertex < 3))
+	{
+		return 1;
+	}
+	if ((!array->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_NORMAL,
+			&normals, &normal_values_per_vertex, &normal_vertex_count)) ||
+		(normal_vertex_count != vertex_count) || (normal_values_per_vertex < 3))
+	{
+		normals = 0;
+	}
+	double minimums[3], maximums[3], scale = 0.0;
+	for (int c = 0; c < 3; ++c)
+	{
+		minimums[c] = maximums[c] = positions[c];
+	}
+	for (unsigned int v = 0; v < vertex_count; ++v)
+	{
+		const GLfloat *position = positions + v*position_values_per_vertex;
+		for (int c = 0; c < 3; ++c)
+		{
+			if (position[c] < minimums[c])
+				minimums[c] = position[c];
+			else if (position[c] > maximums[c])
+				maximums[c] = position[c];
+		}
+	}
+	for (int c = 0; c < 3; ++c)
+	{
+		scale = std::max(scale, std::max(maximums[c] - minimums[c],
+			std::max(std::fabs(minimums[c]), std::fabs(maximums[c]))));
+	}
+	const double tolerance = (0.0 < scale) ? ISO_SURFACE_WELD_TOLERANCE*scale : 1.0;
+	// only weld vertices of different elements so distinct vertices close
+	// together in one element are kept; coincident vertices are always shared
+	const unsigned int no_vertex = static_cast<unsigned int>(-1);
+	const unsigned int surface_count = array->get_number_of_vertices(
+		GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_START);
+	std::vector<unsigned int> vertex_surface(vertex_count, no_vertex);
+	for (unsigned int s = 0; s < surface_count; ++s)
+	{
+		unsigned int index_start = 0, index_count = 0;
+		array->get_unsigned_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_START,
+			s, 1, &index_start);
+		array->get_unsigned_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_COUNT,
+			s, 1, &index_count);
+		const unsigned int index_end = std::min(index_start + index_count, vertex_count);
+		for (unsigned int v = index_start; v < index_end; ++v)
+			vertex_surface[v] = s;
+	}
+	// first vertex of each position in the same tolerance cell is the
+	// representative vertex other vertices within tolerance are welded to
+	std::vector<unsigned int> weld_vertex(vertex_count), next_in_cell(vertex_count, no_vertex);
+	std::unordered_map<uint64_t, unsigned int> cell_first_vertex;
+	cell_first_vertex.reserve(vertex_count/3 + 1);
+	for (unsigned int v = 0; v < vertex_count; ++v)
+	{
+		const GLfloat *position = positions + v*position_values_per_vertex;
+		int cell[3];
+		for (int c = 0; c < 3; ++c)
+		{
+			cell[c] = static_cast<int>((position[c] - minimums[c]) / tolerance);
+		}
+		weld_vertex[v] = v;
+		for (int k = cell[2] - 1; (k <= cell[2] + 1) && (weld_vertex[v] == v); ++k)
+		{
+			for (int j = cell[1] - 1; (j <= cell[1] + 1) && (weld_vertex[v] == v); ++j)
+			{
+				for (int i = cell[0] - 1; (i <= cell[0] + 1) && (weld_vertex[v] == v); ++i)
+				{
+					std::unordered_map<uint64_t, unsigned int>::const_iterator iter =
+						cell_first_vertex.find(iso_weld_cell_key(i, j, k));
+					if (iter == cell_first_vertex.end())
+						continue;
+					for (unsigned int r = iter->second; r != no_vertex; r = next_in_cell[r])
+					{
+						const GLfloat *other_position = positions + r*position_values_per_vertex;
+						if ((vertex_surface[r] != vertex_surface[v]) ?
+							((std::fabs(position[0] - other_position[0]) <= tolerance) &&
+								(std::fabs(position[1] - other_position[1]) <= tolerance) &&
+								(std::fabs(position[2] - other_position[2]) <= tolerance)) :
+							((position[0] == other_position[0]) && (position[1] == other_position[1]) &&
+								(position[2] == other_position[2])))
+						{
+							weld_vertex[v] = r;
+							break;
+						}
+					}
+				}
+			}
+		}
+		if (weld_vertex[v] == v)
+		{
+			unsigned int& first_vertex = cell_first_vertex.insert(std::make_pair(
+				iso_weld_cell_key(cell[0], cell[1], cell[2]), no_vertex)).first->second;
+			next_in_cell[v] = first_vertex;
+			first_vertex = v;
+		}
+	}
+	// sum area-weighted facet normals of triangles around each welded vertex
+	std::vector<double> vertex_normals((normals) ? 3*vertex_count : 0, 0.0);
+	if (normals)
+	{
+		for (unsigned int s = 0; s < surface_count; ++s)
+		{
+			unsigned int index_start = 0, index_count = 0;
+			array->get_unsigned_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_START,
+				s, 1, &index_start);
+			array->get_unsigned_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_COUNT,
+				s, 1, &index_count);
+			const unsigned int index_end = std::min(index_start + index_count, vertex_count);
+			for (unsigned int t = index_start; (t + 2) < index_end; t += 3)
+			{
+				const unsigned int w[3] = { weld_vertex[t], weld_vertex[t + 1], weld_vertex[t + 2] };
+				const GLfloat *p1 = positions + w[0]*position_values_per_vertex;
+				const GLfloat *p2 = positions + w[1]*position_values_per_vertex;
+				const GLfloat *p3 = positions + w[2]*position_values_per_vertex;
+				FE_value axis1[3], axis2[3], facet_normal[3];
+				for (int c = 0; c < 3; ++c)
+				{
+					axis1[c] = p2[c] - p1[c];
+					axis2[c] = p3[c] - p1[c];
+				}
+				cross_product_FE_value_vector3(axis1, axis2, facet_normal);
+				for (int n = 0; n < 3; ++n)
+				{
+					double *vertex_normal = vertex_normals.data() + 3*w[n];
+					vertex_normal[0] += facet_normal[0];
+					vertex_normal[1] += facet_normal[1];
+					vertex_normal[2] += facet_normal[2];
+				}
+			}
+		}
+	}
+	for (unsigned int v = 0; v < vertex_count; ++v)
+	{
+		const unsigned int w = weld_vertex[v];
+		if (w != v)
+		{
+			GLfloat *position = positions + v*position_values_per_vertex;
+			const GLfloat *weld_position = positions + w*position_values_per_vertex;
+			for (unsigned int c = 0; c < position_values_per_vertex; ++c)
+			{
+				position[c] = weld_position[c];
+			}
+		}
+		if (normals)
+		{
+			const double *vertex_normal = vertex_normals.data() + 3*w;
+			const double length = std::sqrt(vertex_normal[0]*vertex_normal[0] +
+				vertex_normal[1]*vertex_normal[1] + vertex_normal[2]*vertex_normal[2]);
+			if (0.0 < length)
+			{
+				GLfloat *normal = normals + v*normal_values_per_vertex;
+				normal[0] = static_cast<GLfloat>(vertex_normal[0] / length);
+				normal[1] = static_cast<GLfloat>(vertex_normal[1] / length);
+				normal[2] = static_cast<GLfloat>(vertex_normal[2] / length);
+			}
+		}
+	}
+	return 1;
+}
@@ -48,4 +48,21 @@ int create_iso_surfaces_from_FE_element(struct FE_element *element,
 	struct Graphics_vertex_array *array,
 	int *number_in_xi, struct Iso_surface_specification *specification);
 
+/***************************************************************************//**
+ * Weld coincident vertices of iso-surface triangles in array so surfaces
+ * crossing element boundaries are watertight with smooth shading. Vertices
+ * within a small tolerance of an earlier vertex from another element are
+ * hashed to the same cell and take its position, and all are given the
+ * normalised sum of the area-weighted facet normals of triangles sharing the
+ * welded vertex. Vertices in the same element are only shared if coincident.
+ * Leaves the per-element triangle layout unchanged so selection, picking and
+ * partial rebuilds are unaffected; result is independent of how the array was
+ * built. Call after all elements have been converted, only for contours with
+ * vertex welding enabled.
+ *
+ * @param array  Vertex array of iso-surface triangles to weld.
+ * @return  1 on success, 0 on failure.
+ */
+int weld_iso_surface_vertices(struct Graphics_vertex_array *array);
+
 #endif /* !defined (FINITE_ELEMENT_TO_ISO_SURFACES_H) */
@@ -16,8 +16,11 @@ Functions for calculating streamlines in finite elements.
 #include <stdlib.h>
 #include <math.h>
 #include "computed_field/computed_field.h"
+#include "computed_field/computed_field_find_xi_private.hpp"
+#include "computed_field/computed_field_private.hpp"
 #include "computed_field/field_cache.hpp"
 #include "finite_element/finite_element_to_graphics_object.h"
+#include "finite_element/finite_element_mesh_field_ranges.hpp"
 #include "finite_element/finite_element_region.h"
 #include "finite_element/finite_element_to_streamlines.h"
 #include "general/debug.h"
@@ -27,6 +30,7 @@ Functions for calculating streamlines in finite elements.
 #include "graphics/graphics_object.h"
 #include "graphics/graphics_object.hpp"
 #include "general/message.h"
+#include "mesh/mesh.hpp"
 /* SAB Trying to hide the guts of GT_object and its primitives,
 	however the stream point stuff currently messes around in the guts
 	of a pointset. */
@@ -167,12 +171,71 @@ calculating the inverse of the Jacobian matrix <dxdxi> and multiplying.
 	return (return_code);
 } /* calculate_delta_xi */
 
+/**
+ * Find the element a streamline continues into after leaving element at xi
+ * through a face, by locating the coordinates a short distance further on in
+ * the stream direction.
+ * @param direction  Stream direction in coordinate space, any magnitude.
+ * @param step_length  Distance past the exit point to locate.
+ * @return  1 if found with element and xi changed, otherwise 0 and unchanged.
+ */
+static int locate_streamline_next_element(StreamlineElementLocator *element_locator,
+	cmzn_fieldcache_id field_cache, struct Computed_field *coordinate_field,
+	int vector_dimension, const FE_value *direction, FE_value step_length,
+	struct FE_element **element, FE_value *xi)
+{
+	FE_value coordinates[3] = { 0.0, 0.0, 0.0 };
+	if ((CMZN_OK != field_cache->setMeshLocation(*element, xi)) ||
+		(CMZN_OK != cmzn_field_evaluate_real(coordinate_field, field_cache, vector_dimension, coordinates)))
+	{
+		return 0;
+	}
+	FE_value magnitude = 0.0;
+	for (int i = 0; i < vector_dimension; ++i)
+	{
+		magnitude += direction[i]*direction[i];
+	}
+	magnitude = sqrt(magnitude);
+	if (!(0.0 < magnitude))
+	{
+		return 0;
+	}
+	for (int i = 0; i < vector_dimension; ++i)
+	{
+		coordinates[i] += step_length*direction[i]/magnitude;
+	}
+	FE_value new_xi[MAXIMUM_ELEMENT_XI_DIMENSIONS];
+	struct FE_element *new_element = element_locator->findElement(field_cache, coordinates, *element, new_xi);
+	if (!new_element)
+	{
+		return 0;
+	}
+	const int dimension = get_FE_element_dimension(new_element);
+	for (int i = 0; i < dimension; ++i)
+	{
+		xi[i] = new_xi[i];
+	}
+	*element = new_element;
+	return 1;
+}
+
+/**
+ * @return  True if element has a face defined for face_number. A streamline
+ * leaving through a face without an adjacent element then leaves the mesh,
+ * so there is no need to search for the element it continues into.
+ */
+static bool streamline_exit_face_is_defined(struct FE_element *element, int face_number)
+{
+	return 0 <= element->getMesh()->getElementFace(element->getIndex(), face_number);
+}
+
 static int update_adaptive_imp_euler(cmzn_fieldcache_id field_cache,
 	struct Computed_field *coordinate_field,
 	struct Computed_field *stream_vector_field,int reverse_track,
 	struct FE_element **element,FE_value *xi,
 	FE_value *point,FE_value *step_size,
-	FE_value *total_stepped, int *keep_tracking)
+	FE_value *total_stepped, int *keep_tracking,
+	StreamlineElementLocator *element_locator)
 /*******************************************************************************
 LAST MODIFIED : 23 June 2004
 
@@ -180,6 +243,8 @@ DESCRIPTION :
 Update the xi coordinates using the <stream_vector_field> with adaptive step
 size control and the improved euler method.  The function updates the <total_stepped>.
 If <reverse_track> is true, the reverse of vector field is tracked.
+If there is no adjacent element matching coordinates where the streamline leaves
+an element, the optional <element_locator> finds the element it continues into.
 ==============================================================================*/
 {
 	int element_dimension,face_number,i,initial_face_number,j,
@@ -526,8 +591,17 @@ If <reverse_track> is true, the reverse of vector field is tracked.
 					xiF, (FE_value *)NULL, &face_number, xi_face, /*permutation*/0);
 				if (face_number == -1)
 				{
-					/* There is no adjacent element */
-					*keep_tracking = 0;
+					/* There is no adjacent element; locate any element the stream
+						continues into across a mesh without faces. Don't search if the
+						face is defined as the streamline is leaving the mesh */
+					if (!((return_code) && (element_locator) &&
+						(!streamline_exit_face_is_defined(initial_element, initial_face_number)) &&
+						locate_streamline_next_element(element_locator, field_cache,
+							coordinate_field, vector_dimension, vector,
+							1.0E-3*coordinate_length, element, xiF)))
+					{
+						*keep_tracking = 0;
+					}
 				}
 				else
 				{
@@ -578,13 +652,20 @@ If <reverse_track> is true, the reverse of vector field is tracked.
 					}
 					if (coordinate_point_error > coordinate_tolerance)
 					{
-						display_message(ERROR_MESSAGE,"track_streamline_from_FE_element.  "
-							"Coordinates don't match after changing elements.");
-						*keep_tracking = 0;
 						*element = initial_element;
 						xiF[0]=xiD[0];
 						xiF[1]=xiD[1];
 						xiF[2]=xiD[2];
+						if (!((element_locator) &&
+							locate_streamline_next_element(element_locator, field_cache,
+								coordinate_field, vector_dimension, vector,
+								1.0E-3*coordinate_length, element, xiF)))
+						{
+							display_message(ERROR_MESSAGE,"track_streamline_from_FE_element.  "
+								"Coordinates don't match after changing elements.");
+							*keep_tracking = 0;
+						}
+						return_code = 1;
 					}
 				}
 			}
@@ -695,9 +776,9 @@ static int track_streamline_from_FE_element(struct FE_element **element,
 	FE_value *xi, cmzn_fieldcache_id field_cache, struct Computed_field *coordinate_field,
 	struct Computed_field *stream_vector_field,int reverse_track,
 	FE_value length, enum cmzn_graphics_streamlines_colour_data_type colour_data_type,
-	struct Computed_field *data_field,int *number_of_points,
-	Triple **stream_points,Triple **stream_vectors,Triple **stream_normals,
-	GLfloat **stream_data)
+	struct Computed_field *data_field, StreamlineElementLocator *element_locator,
+	int *number_of_points, Triple **stream_points, Triple **stream_vectors,
+	Triple **stream_normals, GLfloat **stream_data)
 /*******************************************************************************
 LAST MODIFIED : 23 June 2004
 
@@ -1210,7 +1291,7 @@ following way:
 							previous_element_A = *element;
 							return_code=update_adaptive_imp_euler(field_cache,coordinate_field,
 								stream_vector_field,reverse_track,element,xi,
-								coordinates,&step_size,&total_stepped,&keep_tracking);
+								coordinates,&step_size,&total_stepped,&keep_tracking,element_locator);
 							/* If we haven't gone anywhere and are changing back to the previous
 								element then we are stuck */
 							if (total_stepped == previous_total_stepped_B)
@@ -1354,12 +1435,86 @@ Global functions
 ----------------
 */
 
+StreamlineElementLocator::StreamlineElementLocator(cmzn_mesh *meshIn, cmzn_field *coordinateFieldIn) :
+	mesh(cmzn_mesh_access(meshIn)),
+	coordinateField(cmzn_field_access(coordinateFieldIn)),
+	meshFieldRangesCache(meshIn->getFeMesh()->getFeMeshFieldRangesCache(coordinateFieldIn)),
+	meshFieldRanges(this->meshFieldRangesCache->getMeshFieldRanges(meshIn))
+{
+}
+
+StreamlineElementLocator::~StreamlineElementLocator()
+{
+	FeMeshFieldRanges::deaccess(this->meshFieldRanges);
+	FeMeshFieldRangesCache::deaccess(this->meshFieldRangesCache);
+	cmzn_field_destroy(&this->coordinateField);
+	cmzn_mesh_destroy(&this->mesh);
+}
+
+cmzn_element *StreamlineElementLocator::findElement(cmzn_fieldcache_id fieldcache,
+	const FE_value *coordinates, cmzn_element *excludeElement, FE_value *xi)
+{
+	// mesh field ranges are invalid while coordinate field has unnotified result changes
+	if (this->coordinateField->isResultChanged())
+	{
+		return nullptr;
+	}
+	// evaluation is serialised by the cache so only the first thread to get here does it
+	if (!this->meshFieldRanges->isEvaluated())
+	{
+		this->meshFieldRangesCache->evaluateMeshFieldRanges(*fieldcache, this->meshFieldRanges);
+	}
+	const FeMeshFieldRangesTree& rangesTree = this->meshFieldRanges->getRangesTree();
+	if (rangesTree.isEmpty())
+	{
+		return nullptr;
+	}
+	// Not using Computed_field_find_element_xi as its cache accesses the search
+	// mesh, which is not thread safe. Elements without ranges are not searched.
+	const int componentsCount = this->coordinateField->getNumberOfComponents();
+	FE_value values[MAXIMUM_ELEMENT_XI_DIMENSIONS], workingValues[MAXIMUM_ELEMENT_XI_DIMENSIONS];
+	for (int i = 0; i < componentsCount; ++i)
+	{
+		values[i] = coordinates[i];
+	}
+	Computed_field_iterative_find_element_xi_data find_element_xi_data;
+	find_element_xi_data.field_cache = fieldcache;
+	find_element_xi_data.field = this->coordinateField;
+	find_element_xi_data.number_of_values = componentsCount;
+	find_element_xi_data.values = values;
+	find_element_xi_data.workingValues = workingValues;
+	find_element_xi_data.xi_tolerance = 1e-05;
+	find_element_xi_data.find_nearest_location = 0;
+	find_element_xi_data.nearest_element = nullptr;
+	find_element_xi_data.nearest_element_distance_squared = 0.0;
+	find_element_xi_data.start_with_data_xi = 0;
+	find_element_xi_data.time = fieldcache->getTime();
+	FE_mesh *feMesh = this->mesh->getFeMesh();
+	FeMeshFieldRangesTree::Search search(rangesTree, *this->meshFieldRanges, values);
+	DsLabelIndex elementIndex;
+	while (0 <= (elementIndex = search.next(this->meshFieldRanges->getTolerance())))
+	{
+		cmzn_element *element = feMesh->getElement(elementIndex);
+		if ((element) && (element != excludeElement) &&
+			Computed_field_iterative_element_conditional(element, &find_element_xi_data))
+		{
+			const int dimension = element->getDimension();
+			for (int i = 0; i < dimension; ++i)
+			{
+				xi[i] = find_element_xi_data.xi[i];
+			}
+			return element;
+		}
+	}
+	return nullptr;
+}
+
 int create_polyline_streamline_FE_element_vertex_array(
 	struct FE_element *element,FE_value *start_xi,
 	cmzn_fieldcache_id field_cache, struct Computed_field *coordinate_field,
 	struct Computed_field *stream_vector_field,int reverse_track,
 	FE_value length, enum cmzn_graphics_streamlines_colour_data_type colour_data_type,
-	struct Computed_field *data_field,
+	struct Computed_field *data_field, StreamlineElementLocator *element_locator,
 	struct Graphics_vertex_array *array)
 {
 	GLfloat *stream_data;
@@ -1386,7 +1541,7 @@ int create_polyline_streamline_FE_element_vertex_array(
 			/* track points and normals on streamline, and data if requested */
 			if (track_streamline_from_FE_element(&element,start_xi,
 				field_cache, coordinate_field,stream_vector_field,reverse_track,length,
-				colour_data_type,data_field,&number_of_stream_points,&stream_points,
+				colour_data_type,data_field,element_locator,&number_of_stream_points,&stream_points,
 					&stream_vectors,&stream_normals,&stream_data))
 			{
 				if (0<number_of_stream_points)
@@ -1442,7 +1597,7 @@ int create_surface_streamribbon_FE_element_vertex_array(
 	FE_value *line_base_size, FE_value *line_scale_factors,
 	struct Computed_field *line_orientation_scale_field,
 	enum cmzn_graphics_streamlines_colour_data_type colour_data_type, struct Computed_field *data_field,
-	struct Graphics_vertex_array *array)
+	StreamlineElementLocator *element_locator, struct Graphics_vertex_array *array)
 {
 	double cosw,magnitude,sinw;
 	GLfloat *stream_data,stream_datum= 0.0;
@@ -1479,7 +1634,7 @@ int create_surface_streamribbon_FE_element_vertex_array(
 			/* track points and normals on streamline, and data if requested */
 			if (track_streamline_from_FE_element(&element,start_xi,
 				field_cache, coordinate_field,stream_vector_field,reverse_track,length,
-				colour_data_type,data_field,&number_of_stream_points,&stream_points,
+				colour_data_type,data_field,element_locator,&number_of_stream_points,&stream_points,
 				&stream_vectors,&stream_normals,&stream_data))
 			{
 				if (0<number_of_stream_points)
@@ -25,6 +25,53 @@ Global types
 ----------------
 */
 
+class FeMeshFieldRanges;
+class FeMeshFieldRangesCache;
+
+/**
+ * Locates the element a streamline continues into after leaving an element
+ * through a face which is not defined, or where the adjacent element's
+ * coordinates don't match. Searches the mesh for the coordinates just
+ * past the exit point, visiting only elements whose cached coordinate
+ * ranges contain it. Face adjacency is always tried first, and a defined
+ * face without an adjacent element is a mesh boundary, so mesh ranges are
+ * only evaluated for meshes without faces or with non-conforming faces.
+ * Safe to share between threads tracking streamlines, each with its own
+ * field cache. Must be created and destroyed outside of threaded tracking.
+ */
+class StreamlineElementLocator
+{
+	cmzn_mesh *mesh;  // accessed
+	cmzn_field *coordinateField;  // accessed
+	FeMeshFieldRangesCache *meshFieldRangesCache;  // accessed
+	FeMeshFieldRanges *meshFieldRanges;  // accessed
+
+public:
+
+	/**
+	 * @param meshIn  Top-level mesh streamlines are tracked in.
+	 * @param coordinateFieldIn  Coordinate field streamlines are tracked with.
+	 */
+	StreamlineElementLocator(cmzn_mesh *meshIn, cmzn_field *coordinateFieldIn);
+
+	~StreamlineElementLocator();
+
+	/**
+	 * Find element in mesh containing coordinates, other than excludeElement.
+	 * Evaluates mesh coordinate ranges on first call.
+	 * @param fieldcache  Field cache to evaluate with. Location is changed.
+	 * @param coordinates  Coordinates to find, with as many components as
+	 * the coordinate field.
+	 * @param excludeElement  Element to ignore, usually the element the
+	 * streamline is leaving.
+	 * @param xi  On success, returns element chart location of coordinates.
+	 * @return  Non-accessed element or nullptr if not found.
+	 */
+	cmzn_element *findElement(cmzn_fieldcache_id fieldcache, const FE_value *coordinates,
+		cmzn_element *excludeElement, FE_value *xi);
+
+};
+
 struct Streampoint;
 /*******************************************************************************
 LAST MODIFIED : 11 November 1997
@@ -65,13 +112,15 @@ Global functions
  * stream vector is tracked, and the travel_scalar is made negative.
  * @param field_cache  cmzn_fieldcache for evaluating fields with. Time is
  * expected to have been set in the field_cache if needed.
+ * @param element_locator  Optional locator for continuing streamlines across
+ * faces without adjacent elements.
  */
 int create_polyline_streamline_FE_element_vertex_array(
 	struct FE_element *element,FE_value *start_xi,
 	cmzn_fieldcache_id field_cache, struct Computed_field *coordinate_field,
 	struct Computed_field *stream_vector_field,int reverse_track,
 	FE_value length, enum cmzn_graphics_streamlines_colour_data_type colour_data_type,
-	struct Computed_field *data_field,
+	struct Computed_field *data_field, StreamlineElementLocator *element_locator,
 	struct Graphics_vertex_array *array);
 
 /**
@@ -85,6 +134,8 @@ int create_polyline_streamline_FE_element_vertex_array(
  * @param line_base_size  width and thickness of line, use depends on shape.
  * @param line_scale_factors  Ignored. For future use.
  * @param line_orientation_scale_field  Ignored. For future use.
+ * @param element_locator  Optional locator for continuing streamlines across
+ * faces without adjacent elements.
  */
 int create_surface_streamribbon_FE_element_vertex_array(
 	struct FE_element *element,FE_value *start_xi,
@@ -94,7 +145,7 @@ int create_surface_streamribbon_FE_element_vertex_array(
 	FE_value *line_base_size, FE_value *line_scale_factors,
 	struct Computed_field *line_orientation_scale_field,
 	enum cmzn_graphics_streamlines_colour_data_type colour_data_type, struct Computed_field *data_field,
-	struct Graphics_vertex_array *array);
+	StreamlineElementLocator *element_locator, struct Graphics_vertex_array *array);
 
 int add_flow_particle(struct Streampoint **list,FE_value *xi,
 	struct FE_element *element,Triple **pointlist,int index,
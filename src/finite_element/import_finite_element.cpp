@@ -2449,6 +2449,7 @@ cmzn_node *EXReader::readNode()
 	// fill template node if node with identifier already exists (and merge below), otherwise new node
 	FE_node *node = existingNode ? this->nodeTemplate->feNodeTemplate->get_template_node() : returnNode;
 	const size_t fieldCount = this->nodeTemplate->headerFields.size();
+	IO_stream_begin_values(this->input_file);
 	for (size_t f = 0; (f < fieldCount) && result; ++f)
 	{
         FE_field *field = this->nodeTemplate->headerFields[f];
@@ -2531,15 +2532,15 @@ cmzn_node *EXReader::readNode()
                 {
                     const FE_node_field_template &nft = *(nodeField->getComponent(c));
                     const int valuesCount = nft.getTotalValuesCount();
+                    if (valuesCount != IO_stream_read_FE_values(this->input_file, valuesCount, values))
+                    {
+                        display_message(ERROR_MESSAGE, "EX Reader.  Error reading real value for field %s at node %d.  %s",
+                            get_FE_field_name(field), nodeIdentifier, this->getFileLocation());
+                        result = false;
+                        break;
+                    }
                     for (int k = 0; k < valuesCount; ++k)
                     {
-                        if (1 != IO_stream_scan(this->input_file, FE_VALUE_INPUT_STRING, &values[k]))
-                        {
-                            display_message(ERROR_MESSAGE, "EX Reader.  Error reading real value for field %s at node %d.  %s",
-                                get_FE_field_name(field), nodeIdentifier, this->getFileLocation());
-                            result = false;
-                            break;
-                        }
                         if (!std::isfinite(values[k]))
                         {
                             display_message(ERROR_MESSAGE, "EX Reader.  Infinity or NAN read for field %s at node %d.  %s",
@@ -2605,15 +2606,11 @@ cmzn_node *EXReader::readNode()
                 {
                     const FE_node_field_template &nft = *(nodeField->getComponent(c));
                     const int valuesCount = nft.getTotalValuesCount();
-                    for (int k = 0; k < valuesCount; ++k)
+                    if (valuesCount != IO_stream_read_ints(this->input_file, valuesCount, values))
                     {
-                        if (1 != IO_stream_scan(this->input_file, "%d", &(values[k])))
-                        {
-                            display_message(ERROR_MESSAGE, "EX Reader.  Error reading int value for field %s at node %d.  %s",
-                                get_FE_field_name(field), nodeIdentifier, this->getFileLocation());
-                            result = false;
-                            break;
-                        }
+                        display_message(ERROR_MESSAGE, "EX Reader.  Error reading int value for field %s at node %d.  %s",
+                            get_FE_field_name(field), nodeIdentifier, this->getFileLocation());
+                        result = false;
                     }
                     if (!result)
                     {
@@ -4511,13 +4508,13 @@ bool EXReader::readElementFieldComponentValues(DsLabelIndex elementIndex, FE_fie
 			display_message(ERROR_MESSAGE, "EXReader::readElementFieldComponentValues.  Failed to allocate values.  %s", this->getFileLocation());
 			return false;
 		}
+		if (valueCount != IO_stream_read_FE_values(this->input_file, valueCount, values))
+		{
+			display_message(ERROR_MESSAGE, "EX Reader.  Error reading element/grid FE_value value.  %s", this->getFileLocation());
+			return false;
+		}
 		for (int v = 0; v < valueCount; ++v)
 		{
-			if (1 != IO_stream_scan(this->input_file, FE_VALUE_INPUT_STRING, &(values[v])))
-			{
-				display_message(ERROR_MESSAGE, "EX Reader.  Error reading element/grid FE_value value.  %s", this->getFileLocation());
-				return false;
-			}
 			if (!std::isfinite(values[v]))
 			{
 				display_message(ERROR_MESSAGE, "EX Reader.  Infinity or NAN element value read for element.  %s", this->getFileLocation());
@@ -4534,13 +4531,10 @@ bool EXReader::readElementFieldComponentValues(DsLabelIndex elementIndex, FE_fie
 			display_message(ERROR_MESSAGE, "EXReader::readElementFieldComponentValues.  Failed to allocate values.  %s", this->getFileLocation());
 			return false;
 		}
-		for (int v = 0; v < valueCount; ++v)
+		if (valueCount != IO_stream_read_ints(this->input_file, valueCount, values))
 		{
-			if (1 != IO_stream_scan(this->input_file, "%d", &(values[v])))
-			{
-				display_message(ERROR_MESSAGE, "EX Reader.  Error reading element/grid int value.  %s", this->getFileLocation());
-				return false;
-			}
+			display_message(ERROR_MESSAGE, "EX Reader.  Error reading element/grid int value.  %s", this->getFileLocation());
+			return false;
 		}
 	} break;
 	default:
@@ -4702,6 +4696,7 @@ cmzn_element *EXReader::readElement()
 			cmzn_element::deaccess(element);
 			return 0;
 		}
+		IO_stream_begin_values(this->input_file);
 		for (size_t f = 0; f < fieldCount; ++f)
 		{
 			FE_field *field = this->elementTemplate->headerFields[f];
@@ -4731,15 +4726,17 @@ cmzn_element *EXReader::readElement()
 			cmzn_element::deaccess(element);
 			return 0;
 		}
+		IO_stream_begin_values(this->input_file);
+		std::vector<DsLabelIdentifier> nodeIdentifiers(nodeCount);
+		if (nodeCount != IO_stream_read_ints(this->input_file, nodeCount, nodeIdentifiers.data()))
+		{
+			display_message(ERROR_MESSAGE, "EX Reader.  Error reading node identifier.  %s", this->getFileLocation());
+			cmzn_element::deaccess(element);
+			return 0;
+		}
 		for (int n = 0; n < nodeCount; ++n)
 		{
-			DsLabelIdentifier nodeIdentifier;
-			if (1 != IO_stream_scan(this->input_file, "%d", &nodeIdentifier))
-			{
-				display_message(ERROR_MESSAGE, "EX Reader.  Error reading node identifier.  %s", this->getFileLocation());
-				cmzn_element::deaccess(element);
-				return 0;
-			}
+			const DsLabelIdentifier nodeIdentifier = nodeIdentifiers[n];
 			cmzn_node *node = 0;
 			if (nodeIdentifier >= 0)
 			{
@@ -4784,20 +4781,21 @@ cmzn_element *EXReader::readElement()
 			cmzn_element::deaccess(element);
 			return 0;
 		}
+		IO_stream_begin_values(this->input_file);
 		for (size_t ss = 0; ss < sfSetCount; ++ss)
 		{
 			ScaleFactorSet *sfSet = this->elementTemplate->scaleFactorSets[ss];
 			// read the values into the sfSet values cache
 			const int scaleFactorCount = sfSet->scaleFactorCount;
 			FE_value *scaleFactors = sfSet->values.data();
+			if (scaleFactorCount != IO_stream_read_FE_values(this->input_file, scaleFactorCount, scaleFactors))
+			{
+				display_message(ERROR_MESSAGE, "EX Reader.  Error reading scale factor.  %s", this->getFileLocation());
+				cmzn_element::deaccess(element);
+				return 0;
+			}
 			for (int sf = 0; sf < scaleFactorCount; ++sf)
 			{
-				if (1 != IO_stream_scan(this->input_file, FE_VALUE_INPUT_STRING, &scaleFactors[sf]))
-				{
-					display_message(ERROR_MESSAGE, "EX Reader.  Error reading scale factor.  %s", this->getFileLocation());
-					cmzn_element::deaccess(element);
-					return 0;
-				}
 				if (!std::isfinite(scaleFactors[sf]))
 				{
 					display_message(ERROR_MESSAGE, "EX Reader.  Infinity or NAN scale factor.  %s", this->getFileLocation());
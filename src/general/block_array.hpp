@@ -477,6 +477,151 @@ public:
 		return false;
 	}
 
+	/** @return  Number of bits set in value. */
+	static IndexType countBits(unsigned int value)
+	{
+		value = value - ((value >> 1) & 0x55555555);
+		value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+		return static_cast<IndexType>((((value + (value >> 4)) & 0x0F0F0F0F)*0x01010101) >> 24);
+	}
+
+	/**
+	 * Count values which are true in both this and other array, 32 values at
+	 * a time. Neither array is modified.
+	 * @param other  Bool array with the same block length.
+	 * @return  Number of values true in both arrays, or 0 if block lengths differ.
+	 */
+	IndexType getIntersectionTrueCount(const bool_array& other) const
+	{
+		IndexType trueCount = 0;
+		if (other.blockLength != this->blockLength)
+			return trueCount;
+		const IndexType blockLimit = (this->blockCount < other.blockCount) ? this->blockCount : other.blockCount;
+		for (IndexType blockIndex = 0; blockIndex < blockLimit; ++blockIndex)
+		{
+			const unsigned int *block = this->blocks[blockIndex];
+			const unsigned int *otherBlock = other.blocks[blockIndex];
+			if ((!block) || (!otherBlock))
+				continue;
+			for (IndexType i = 0; i < this->blockLength; ++i)
+			{
+				const unsigned int common = block[i] & otherBlock[i];
+				if (common)
+					trueCount += countBits(common);
+			}
+		}
+		return trueCount;
+	}
+
+	/**
+	 * Set values which are true in other array to true, 32 values at a time.
+	 * @param other  Bool array with the same block length.
+	 * @param changedCount  Incremented by number of values changed to true.
+	 * @return  True on success, false if block lengths differ or failed to
+	 * allocate a block; changedCount is still valid on failure.
+	 */
+	bool unionArray(const bool_array& other, IndexType& changedCount)
+	{
+		if (other.blockLength != this->blockLength)
+			return false;
+		for (IndexType blockIndex = 0; blockIndex < other.blockCount; ++blockIndex)
+		{
+			const unsigned int *otherBlock = other.blocks[blockIndex];
+			if (!otherBlock)
+				continue;
+			unsigned int *block = (blockIndex < this->blockCount) ? this->blocks[blockIndex] : 0;
+			for (IndexType i = 0; i < this->blockLength; ++i)
+			{
+				if (!otherBlock[i])
+					continue;
+				if (!block)
+				{
+					// only allocate blocks with values to add
+					block = this->getOrCreateBlock(blockIndex);
+					if (!block)
+						return false;
+				}
+				const unsigned int added = otherBlock[i] & ~block[i];
+				if (added)
+				{
+					changedCount += countBits(added);
+					block[i] |= added;
+				}
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Set values which are false in other array to false, 32 values at a time.
+	 * Blocks with no counterpart in other array are freed.
+	 * @param other  Bool array with the same block length.
+	 * @param changedCount  Incremented by number of values changed to false.
+	 * @return  True on success, false if block lengths differ.
+	 */
+	bool intersectArray(const bool_array& other, IndexType& changedCount)
+	{
+		if (other.blockLength != this->blockLength)
+			return false;
+		for (IndexType blockIndex = 0; blockIndex < this->blockCount; ++blockIndex)
+		{
+			unsigned int *block = this->blocks[blockIndex];
+			if (!block)
+				continue;
+			const unsigned int *otherBlock = (blockIndex < other.blockCount) ? other.blocks[blockIndex] : 0;
+			if (otherBlock)
+			{
+				for (IndexType i = 0; i < this->blockLength; ++i)
+				{
+					const unsigned int removed = block[i] & ~otherBlock[i];
+					if (removed)
+					{
+						changedCount += countBits(removed);
+						block[i] &= otherBlock[i];
+					}
+				}
+			}
+			else
+			{
+				for (IndexType i = 0; i < this->blockLength; ++i)
+					if (block[i])
+						changedCount += countBits(block[i]);
+				this->destroyBlock(blockIndex);
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Set values which are true in other array to false, 32 values at a time.
+	 * @param other  Bool array with the same block length.
+	 * @param changedCount  Incremented by number of values changed to false.
+	 * @return  True on success, false if block lengths differ.
+	 */
+	bool subtractArray(const bool_array& other, IndexType& changedCount)
+	{
+		if (other.blockLength != this->blockLength)
+			return false;
+		const IndexType blockLimit = (this->blockCount < other.blockCount) ? this->blockCount : other.blockCount;
+		for (IndexType blockIndex = 0; blockIndex < blockLimit; ++blockIndex)
+		{
+			unsigned int *block = this->blocks[blockIndex];
+			const unsigned int *otherBlock = other.blocks[blockIndex];
+			if ((!block) || (!otherBlock))
+				continue;
+			for (IndexType i = 0; i < this->blockLength; ++i)
+			{
+				const unsigned int removed = block[i] & otherBlock[i];
+				if (removed)
+				{
+					changedCount += countBits(removed);
+					block[i] &= ~removed;
+				}
+			}
+		}
+		return true;
+	}
+
 	/**
 	 * @param lastTrueIndex  Updated to equal or next lower index with true value.  
 	 * @return  true if found, false if none.
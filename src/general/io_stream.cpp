@@ -25,6 +25,19 @@ streams.
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <vector>
+#if defined (WIN32_SYSTEM)
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#elif defined (UNIX)
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif /* defined (UNIX) */
 #define HAVE_ZLIB
 #include <zlib.h>
 #define HAVE_BZLIB
@@ -79,7 +92,7 @@ DESCRIPTION :
 {
 	const char *name;
 	const void *memory_ptr;
-	int data_length;
+	size_t data_length;
 	int access_count;
 }; /* struct IO_memory_block */
 
@@ -95,6 +108,8 @@ DESCRIPTION :
 ==============================================================================*/
 {
 	struct LIST(IO_memory_block) *memory_block_list;
+	/* if set, uncompressed files are read through a memory mapping */
+	bool memory_map_files;
 }; /* struct IO_stream_package */
 
 struct IO_stream
@@ -139,7 +154,10 @@ DESCRIPTION :
 
 	/* IO_STREAM_MEMORY_TYPE */
 	struct IO_memory_block *memory_block;
-	int memory_block_index;
+	size_t memory_block_index;
+	/* memory mapped file read as IO_STREAM_MEMORY_TYPE, owned by stream */
+	void *mapped_file_data;
+	size_t mapped_file_length;
 
 #if defined (HAVE_BZLIB)
 	/* IO_STREAM_BZ2_MEMORY_TYPE */
@@ -147,6 +165,11 @@ DESCRIPTION :
 	int last_bz2_return;
 #endif /* defined (HAVE_BZLIB) */
 
+	/* set by IO_stream_begin_values so the next values read check for a
+	 * binary value block; once one is found, all later reads check */
+	bool check_binary_values;
+	bool binary_values;
+
 }; /* struct IO_stream */
 
 
@@ -156,7 +179,7 @@ Global functions
 */
 
 struct IO_memory_block *CREATE(IO_memory_block)(const char *name,
-	const void *memory_ptr, const int data_length)
+	const void *memory_ptr, const size_t data_length)
 /*******************************************************************************
 LAST MODIFIED : 23 August 2004
 
@@ -242,6 +265,7 @@ DESCRIPTION :
 	if (ALLOCATE(io_stream_package, struct IO_stream_package, 1))
 	{
 		io_stream_package->memory_block_list = CREATE(LIST(IO_memory_block))();
+		io_stream_package->memory_map_files = false;
 	}
 	else
 	{
@@ -255,6 +279,18 @@ DESCRIPTION :
 	return (io_stream_package);
 } /* CREATE(IO_stream_package) */
 
+int IO_stream_package_set_memory_map_files(struct IO_stream_package *stream_class,
+	bool memory_map_files)
+{
+	if (stream_class)
+	{
+		stream_class->memory_map_files = memory_map_files;
+		return 1;
+	}
+	display_message(ERROR_MESSAGE, "IO_stream_package_set_memory_map_files.  Invalid argument(s)");
+	return 0;
+}
+
 int IO_stream_package_define_memory_block(struct IO_stream_package *stream_class,
 	const char *block_name, const void *memory_block, const int memory_block_length)
 /*******************************************************************************
@@ -408,6 +444,76 @@ along to imagemagick.
 	return (return_code);
 } /* IO_stream_uri_is_native_imagemagick */
 
+/**
+ * Map whole file into memory for reading.
+ * @param filename  Name of file to map.
+ * @param length  On success, set to length of file.
+ * @return  Address of mapped data, or nullptr if file is empty, cannot be
+ * mapped or mapping is not supported on this platform.
+ */
+static void *IO_stream_map_file(const char *filename, size_t *length)
+{
+	void *data = nullptr;
+#if defined (WIN32_SYSTEM)
+	HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		LARGE_INTEGER size;
+		if (GetFileSizeEx(file, &size) && (size.QuadPart > 0) &&
+			(static_cast<unsigned long long>(size.QuadPart) <= SIZE_MAX))
+		{
+			HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (mapping)
+			{
+				// view remains valid after handles are closed
+				data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				if (data)
+					*length = static_cast<size_t>(size.QuadPart);
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+	}
+#elif defined (UNIX)
+	const int fd = open(filename, O_RDONLY);
+	if (fd >= 0)
+	{
+		struct stat file_stat;
+		if ((0 == fstat(fd, &file_stat)) && S_ISREG(file_stat.st_mode) && (file_stat.st_size > 0))
+		{
+			data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data == MAP_FAILED)
+				data = nullptr;
+			else
+			{
+				*length = static_cast<size_t>(file_stat.st_size);
+				madvise(data, *length, MADV_SEQUENTIAL);
+			}
+		}
+		// mapping remains valid after file is closed
+		close(fd);
+	}
+#else
+	USE_PARAMETER(filename);
+	USE_PARAMETER(length);
+#endif /* defined (UNIX) */
+	return data;
+}
+
+static void IO_stream_unmap_file(void *data, size_t length)
+{
+#if defined (WIN32_SYSTEM)
+	USE_PARAMETER(length);
+	UnmapViewOfFile(data);
+#elif defined (UNIX)
+	munmap(data, length);
+#else
+	USE_PARAMETER(data);
+	USE_PARAMETER(length);
+#endif /* defined (UNIX) */
+}
+
 struct IO_stream *CREATE(IO_stream)(struct IO_stream_package *stream_class)
 /*******************************************************************************
 LAST MODIFIED : 23 March 2007
@@ -457,12 +563,17 @@ DESCRIPTION :
 			/* IO_STREAM_MEMORY_TYPE */
 			io_stream->memory_block = (struct IO_memory_block *)NULL;
 			io_stream->memory_block_index = 0;
+			io_stream->mapped_file_data = nullptr;
+			io_stream->mapped_file_length = 0;
 
 #if defined (HAVE_BZLIB)
 			/* IO_STREAM_BZ2_MEMORY_TYPE */
 			io_stream->bz2_memory_stream = (bz_stream *)NULL;
 			io_stream->last_bz2_return = BZ_OK;
 #endif /* defined (HAVE_BZLIB) */
+
+			io_stream->check_binary_values = true;
+			io_stream->binary_values = false;
 		}
 		else
 		{
@@ -495,6 +606,8 @@ int IO_stream_open_for_read_compression_specified(struct IO_stream *stream, cons
 	return_code = 0;
 	if (stream && stream_uri)
 	{
+		stream->check_binary_values = true;
+		stream->binary_values = false;
 		if (!strncmp("memory:", stream_uri, 7))
 		{
 			stream->memory_block = FIND_BY_IDENTIFIER_IN_LIST(IO_memory_block,name)(stream_uri + 7,
@@ -608,11 +721,42 @@ int IO_stream_open_for_read_compression_specified(struct IO_stream *stream, cons
 					else
 #endif /* defined (HAVE_BZLIB) */
 					{
-						stream->file_handle = fopen(filename, "r");
-						if (NULL != stream->file_handle)
+						// optionally read uncompressed files through a memory mapping to
+						// avoid stdio overheads; fall back to stdio if it cannot be mapped
+						size_t mapped_length = 0;
+						void *mapped_data = (stream->stream_class->memory_map_files) ?
+							IO_stream_map_file(filename, &mapped_length) : nullptr;
+						if (mapped_data)
 						{
-							stream->type = IO_STREAM_FILE_TYPE;
-							return_code = 1;
+							stream->memory_block = CREATE(IO_memory_block)(filename, mapped_data, mapped_length);
+							if (stream->memory_block)
+							{
+								ACCESS(IO_memory_block)(stream->memory_block);
+								stream->memory_block_index = 0;
+								stream->mapped_file_data = mapped_data;
+								stream->mapped_file_length = mapped_length;
+								stream->type = IO_STREAM_MEMORY_TYPE;
+								stream->buffer_chunk_size = 131072;
+								stream->buffer_chunks = 10;
+#if defined IO_STREAM_SPEED_UP_SSCANF
+								stream->buffer_lookahead = 100;
+#endif /* defined IO_STREAM_SPEED_UP_SSCANF */
+								return_code = 1;
+							}
+							else
+							{
+								IO_stream_unmap_file(mapped_data, mapped_length);
+							}
+						}
+						if (!return_code)
+						{
+							// binary mode as EX files may contain binary value blocks
+							stream->file_handle = fopen(filename, "rb");
+							if (NULL != stream->file_handle)
+							{
+								stream->type = IO_STREAM_FILE_TYPE;
+								return_code = 1;
+							}
 						}
 					}
 			}
@@ -652,6 +796,8 @@ DESCRIPTION :
 	return_code = 0;
 	if (stream && stream_uri)
 	{
+		stream->check_binary_values = true;
+		stream->binary_values = false;
 		if (!strncmp("memory:", stream_uri, 7))
 		{
 			stream->memory_block = FIND_BY_IDENTIFIER_IN_LIST(IO_memory_block,name)(stream_uri + 7,
@@ -921,7 +1067,7 @@ DESCRIPTION :
 						}
 						else
 						{
-							copy_size = stream->memory_block->data_length - stream->memory_block_index;
+							copy_size = static_cast<int>(stream->memory_block->data_length - stream->memory_block_index);
 						}
 						if (copy_size)
 						{
@@ -1391,6 +1537,418 @@ int IO_stream_peekc(struct IO_stream *stream)
 }
 
 
+namespace {
+
+/* powers of 10 exactly representable as double */
+const double exact_powers_of_10[23] =
+{
+	1.0E0, 1.0E1, 1.0E2, 1.0E3, 1.0E4, 1.0E5, 1.0E6, 1.0E7, 1.0E8, 1.0E9, 1.0E10,
+	1.0E11, 1.0E12, 1.0E13, 1.0E14, 1.0E15, 1.0E16, 1.0E17, 1.0E18, 1.0E19, 1.0E20,
+	1.0E21, 1.0E22
+};
+
+inline bool is_digit(char c)
+{
+	return (c >= '0') && (c <= '9');
+}
+
+/**
+ * Parse real number from null terminated string, equivalent to strtod
+ * without leading white space. Decimal numbers whose significant digits are
+ * exactly representable (up to 2^53, covering the 16 digits written by the
+ * EX writer) and with exponents within the range of exact powers of 10 are
+ * converted with a single correctly rounded multiply or divide; all other
+ * numbers are converted by strtod.
+ * @param string  Start of number.
+ * @param value  On success, set to the number value.
+ * @return  Pointer to character after number, or nullptr if no number.
+ */
+const char *parse_double(const char *string, double& value)
+{
+	const char *c = string;
+	bool negative = false;
+	if ((*c == '-') || (*c == '+'))
+	{
+		negative = (*c == '-');
+		++c;
+	}
+	uint64_t mantissa = 0;
+	int digits = 0;  // significant digits in mantissa
+	int exponent = 0;
+	bool hasDigits = false;
+	bool exact = true;
+	while (*c == '0')
+	{
+		hasDigits = true;
+		++c;
+	}
+	while (is_digit(*c))
+	{
+		if (digits < 19)
+		{
+			mantissa = mantissa*10 + static_cast<uint64_t>(*c - '0');
+			++digits;
+		}
+		else
+		{
+			exact = false;
+		}
+		hasDigits = true;
+		++c;
+	}
+	if (*c == '.')
+	{
+		++c;
+		if (digits == 0)
+		{
+			while (*c == '0')
+			{
+				--exponent;
+				hasDigits = true;
+				++c;
+			}
+		}
+		while (is_digit(*c))
+		{
+			if (digits < 19)
+			{
+				mantissa = mantissa*10 + static_cast<uint64_t>(*c - '0');
+				++digits;
+				--exponent;
+			}
+			else
+			{
+				exact = false;
+			}
+			hasDigits = true;
+			++c;
+		}
+	}
+	if (hasDigits && ((*c == 'e') || (*c == 'E')))
+	{
+		const char *e = c + 1;
+		bool negativeExponent = false;
+		if ((*e == '-') || (*e == '+'))
+		{
+			negativeExponent = (*e == '-');
+			++e;
+		}
+		if (is_digit(*e))
+		{
+			int exponentValue = 0;
+			while (is_digit(*e))
+			{
+				if (exponentValue < 100000)
+				{
+					exponentValue = exponentValue*10 + (*e - '0');
+				}
+				++e;
+			}
+			exponent += (negativeExponent) ? -exponentValue : exponentValue;
+			c = e;
+		}
+		else
+		{
+			exact = false;
+		}
+	}
+	// hexadecimal, infinity and nan are left to strtod
+	if (hasDigits && exact && (mantissa <= (static_cast<uint64_t>(1) << 53)) && (!isalpha(static_cast<unsigned char>(*c))) && (exponent >= -22) && (exponent <= 22))
+	{
+		double result = static_cast<double>(mantissa);
+		if (exponent < 0)
+		{
+			result /= exact_powers_of_10[-exponent];
+		}
+		else if (exponent > 0)
+		{
+			result *= exact_powers_of_10[exponent];
+		}
+		value = (negative) ? -result : result;
+		return c;
+	}
+	char *end = nullptr;
+	value = strtod(string, &end);
+	return (end == string) ? nullptr : end;
+}
+
+/**
+ * Parse integer from null terminated string, equivalent to strtol with
+ * base 10 without leading white space, clamped to int range.
+ * @param string  Start of number.
+ * @param value  On success, set to the number value.
+ * @return  Pointer to character after number, or nullptr if no number.
+ */
+const char *parse_int(const char *string, int& value)
+{
+	const char *c = string;
+	bool negative = false;
+	if ((*c == '-') || (*c == '+'))
+	{
+		negative = (*c == '-');
+		++c;
+	}
+	if (!is_digit(*c))
+	{
+		return nullptr;
+	}
+	int64_t result = 0;
+	while (is_digit(*c))
+	{
+		if (result <= INT32_MAX)
+		{
+			result = result*10 + (*c - '0');
+		}
+		++c;
+	}
+	if (negative)
+	{
+		result = -result;
+	}
+	value = (result > INT32_MAX) ? INT32_MAX : ((result < INT32_MIN) ? INT32_MIN : static_cast<int>(result));
+	return c;
+}
+
+/** @return  True if integers and reals are stored little endian on this host */
+inline bool host_is_little_endian()
+{
+	const uint16_t probe = 1;
+	return 1 == *reinterpret_cast<const unsigned char *>(&probe);
+}
+
+/** Read count values of StoredType from stream and convert from little endian.
+ * @return  True on success, false if truncated. */
+template <typename StoredType>
+bool IO_stream_read_little_endian(struct IO_stream *stream, int count, StoredType *values)
+{
+	if (count != IO_stream_fread(stream, values, sizeof(StoredType), count))
+	{
+		return false;
+	}
+	if (!host_is_little_endian())
+	{
+		unsigned char *bytes = reinterpret_cast<unsigned char *>(values);
+		for (int i = 0; i < count; ++i, bytes += sizeof(StoredType))
+		{
+			std::reverse(bytes, bytes + sizeof(StoredType));
+		}
+	}
+	return true;
+}
+
+/**
+ * If values are to be checked for a binary block, skip white space and, if
+ * a binary value block follows, read its values. After the first binary
+ * block, all later values are checked.
+ * @param StoredType  Type of values in block: double or int32_t.
+ * @param typeCode  Expected block type IO_STREAM_BINARY_BLOCK_REAL/INT.
+ * @param count  Expected number of values in block, must be positive.
+ * @return  1 if block read, 0 if no binary block follows, -1 if block is of
+ * the wrong type or size or is truncated.
+ */
+template <typename StoredType, typename ValueType>
+int IO_stream_read_binary_block(struct IO_stream *stream, char typeCode,
+	int count, ValueType *values)
+{
+	if (!((stream->check_binary_values) || (stream->binary_values)))
+	{
+		return 0;
+	}
+	stream->check_binary_values = false;
+	int c;
+	while (((c = IO_stream_peekc(stream)) >= 0) && isspace(c))
+	{
+		IO_stream_getc(stream);
+	}
+	if (c != IO_STREAM_BINARY_BLOCK_MARKER)
+	{
+		return 0;
+	}
+	stream->binary_values = true;
+	IO_stream_getc(stream);
+	unsigned char header[5];
+	if (5 != IO_stream_fread(stream, header, 1, 5))
+	{
+		display_message(ERROR_MESSAGE, "IO_stream_read_binary_block.  Truncated block header.");
+		return -1;
+	}
+	const uint32_t blockCount = static_cast<uint32_t>(header[1]) | (static_cast<uint32_t>(header[2]) << 8) |
+		(static_cast<uint32_t>(header[3]) << 16) | (static_cast<uint32_t>(header[4]) << 24);
+	if ((static_cast<char>(header[0]) != typeCode) || (blockCount != static_cast<uint32_t>(count)))
+	{
+		display_message(ERROR_MESSAGE, "IO_stream_read_binary_block.  "
+			"Expected block of %d values of type '%c', found %u values of type '%c'.",
+			count, typeCode, blockCount, static_cast<char>(header[0]));
+		return -1;
+	}
+	bool result;
+	if (sizeof(StoredType) == sizeof(ValueType))
+	{
+		result = IO_stream_read_little_endian(stream, count, reinterpret_cast<StoredType *>(values));
+	}
+	else
+	{
+		std::vector<StoredType> storedValues(count);
+		result = IO_stream_read_little_endian(stream, count, storedValues.data());
+		std::copy(storedValues.begin(), storedValues.end(), values);
+	}
+	if (!result)
+	{
+		display_message(ERROR_MESSAGE, "IO_stream_read_binary_block.  Truncated block values.");
+		return -1;
+	}
+	return 1;
+}
+
+/**
+ * Read numbers separated by white space directly from the internal buffer
+ * of a buffered stream.
+ * @param parse  Function to parse a number from the buffer.
+ * @return  Number of values read.
+ */
+template <typename ValueType, typename ParseType>
+int IO_stream_read_buffered_numbers(struct IO_stream *stream, int count,
+	ValueType *values, const char *(*parse)(const char *, ParseType&))
+{
+	int i = 0;
+	while (i < count)
+	{
+		/* skip white space, refilling buffer until a non-space character or end */
+		const char *c;
+		while (true)
+		{
+			if (!IO_stream_read_to_internal_buffer(stream))
+			{
+				return i;
+			}
+			c = stream->buffer + stream->buffer_index;
+			while (isspace(static_cast<unsigned char>(*c)))
+			{
+				++c;
+			}
+			stream->buffer_index = static_cast<int>(c - stream->buffer);
+			if ((*c != '\0') || (stream->buffer_index < stream->buffer_valid_index))
+			{
+				break;
+			}
+			/* at end of buffer: refill and stop if at end of stream */
+			if ((!IO_stream_read_to_internal_buffer(stream)) ||
+				(stream->buffer_index >= stream->buffer_valid_index))
+			{
+				return i;
+			}
+		}
+		/* ensure number is not split across the end of the buffer */
+		if (!IO_stream_read_to_internal_buffer(stream))
+		{
+			return i;
+		}
+		c = stream->buffer + stream->buffer_index;
+		ParseType value;
+		const char *end = parse(c, value);
+		if (!end)
+		{
+			break;
+		}
+		values[i] = static_cast<ValueType>(value);
+		stream->buffer_index = static_cast<int>(end - stream->buffer);
+		++i;
+	}
+	return i;
+}
+
+}
+
+void IO_stream_begin_values(struct IO_stream *stream)
+{
+	if (stream)
+	{
+		stream->check_binary_values = true;
+	}
+}
+
+int IO_stream_read_FE_values(struct IO_stream *stream, int count, FE_value *values)
+{
+	if (!((stream) && (count >= 0) && ((values) || (count == 0))))
+	{
+		display_message(ERROR_MESSAGE, "IO_stream_read_FE_values.  Invalid arguments.");
+		return 0;
+	}
+	if (count == 0)
+	{
+		return 0;
+	}
+	const int binaryResult = IO_stream_read_binary_block<double>(stream, IO_STREAM_BINARY_BLOCK_REAL, count, values);
+	if (binaryResult != 0)
+	{
+		return (binaryResult > 0) ? count : 0;
+	}
+	switch (stream->type)
+	{
+#if defined (IO_STREAM_SPEED_UP_SSCANF)
+		case IO_STREAM_MEMORY_TYPE:
+#endif /* defined (IO_STREAM_SPEED_UP_SSCANF) */
+		case IO_STREAM_GZIP_FILE_TYPE:
+		case IO_STREAM_GZIP_MEMORY_TYPE:
+		case IO_STREAM_BZ2_FILE_TYPE:
+		case IO_STREAM_BZ2_MEMORY_TYPE:
+		{
+			return IO_stream_read_buffered_numbers(stream, count, values, parse_double);
+		} break;
+		default:
+		{
+			int i = 0;
+			while ((i < count) && (1 == IO_stream_scan(stream, FE_VALUE_INPUT_STRING, &(values[i]))))
+			{
+				++i;
+			}
+			return i;
+		} break;
+	}
+	return 0;
+}
+
+int IO_stream_read_ints(struct IO_stream *stream, int count, int *values)
+{
+	if (!((stream) && (count >= 0) && ((values) || (count == 0))))
+	{
+		display_message(ERROR_MESSAGE, "IO_stream_read_ints.  Invalid arguments.");
+		return 0;
+	}
+	if (count == 0)
+	{
+		return 0;
+	}
+	const int binaryResult = IO_stream_read_binary_block<int32_t>(stream, IO_STREAM_BINARY_BLOCK_INT, count, values);
+	if (binaryResult != 0)
+	{
+		return (binaryResult > 0) ? count : 0;
+	}
+	switch (stream->type)
+	{
+#if defined (IO_STREAM_SPEED_UP_SSCANF)
+		case IO_STREAM_MEMORY_TYPE:
+#endif /* defined (IO_STREAM_SPEED_UP_SSCANF) */
+		case IO_STREAM_GZIP_FILE_TYPE:
+		case IO_STREAM_GZIP_MEMORY_TYPE:
+		case IO_STREAM_BZ2_FILE_TYPE:
+		case IO_STREAM_BZ2_MEMORY_TYPE:
+		{
+			return IO_stream_read_buffered_numbers(stream, count, values, parse_int);
+		} break;
+		default:
+		{
+			int i = 0;
+			while ((i < count) && (1 == IO_stream_scan(stream, "%d", &(values[i]))))
+			{
+				++i;
+			}
+			return i;
+		} break;
+	}
+	return 0;
+}
+
 int IO_stream_fread(struct IO_stream *stream, void *ptr, size_t size, size_t nmemb)
 /*******************************************************************************
 LAST MODIFIED : 28 March 2007
@@ -1642,6 +2200,30 @@ suitable for use in diagnostic messages.
 					sprintf(string, "%s line %d", stream->uri, line_number);
 				}
 			} break;
+#if defined (IO_STREAM_SPEED_UP_SSCANF)
+			case IO_STREAM_MEMORY_TYPE:
+			{
+				/* memory block index is ahead of location by unread buffer contents */
+				const size_t position = stream->memory_block_index -
+					static_cast<size_t>(stream->buffer_valid_index - stream->buffer_index);
+				if (position > 0)
+				{
+					const char *memory_data = static_cast<const char *>(stream->memory_block->memory_ptr);
+					line_number = 1;
+					for (size_t i = 0; i < position - 1; ++i)
+					{
+						if ('\n' == memory_data[i])
+						{
+							line_number++;
+						}
+					}
+				}
+				if (ALLOCATE(string, char, strlen(stream->uri) + 30))
+				{
+					sprintf(string, "%s line %d", stream->uri, line_number);
+				}
+			} break;
+#endif /* defined (IO_STREAM_SPEED_UP_SSCANF) */
 			default:
 			{
 				display_message(ERROR_MESSAGE,
@@ -1789,7 +2371,7 @@ DESCRIPTION :
 			case IO_STREAM_MEMORY_TYPE:
 			{
 				*stream_data = stream->memory_block->memory_ptr;
-				*stream_data_length = stream->memory_block->data_length;
+				*stream_data_length = static_cast<int>(stream->memory_block->data_length);
 			} break;
 			default:
 			{
@@ -1910,11 +2492,11 @@ Implements the stdio function fseek on stream where possible.
 					} break;
 					case SEEK_CUR:
 					{
-						location = stream->memory_block_index + offset;
+						location = static_cast<long>(stream->memory_block_index) + offset;
 					} break;
 					case SEEK_END:
 					{
-						location = stream->memory_block->data_length + offset;
+						location = static_cast<long>(stream->memory_block->data_length) + offset;
 					} break;
 					default:
 					{
@@ -1925,9 +2507,9 @@ Implements the stdio function fseek on stream where possible.
 				}
 				if (return_code)
 				{
-					if ((location >= 0) && (location < stream->memory_block->data_length))
+					if ((location >= 0) && (static_cast<size_t>(location) < stream->memory_block->data_length))
 					{
-						stream->memory_block_index = location;
+						stream->memory_block_index = static_cast<size_t>(location);
 						stream->buffer_valid_index = 0;
 						stream->buffer_index = 0;
 					}
@@ -2013,6 +2595,12 @@ DESCRIPTION :
 				{
 					DEACCESS(IO_memory_block)(&stream->memory_block);
 				}
+				if (stream->mapped_file_data)
+				{
+					IO_stream_unmap_file(stream->mapped_file_data, stream->mapped_file_length);
+					stream->mapped_file_data = nullptr;
+					stream->mapped_file_length = 0;
+				}
 				stream->type = IO_STREAM_UNKNOWN_TYPE;
 				return_code = 1;
 			} break;
@@ -15,6 +15,7 @@ streams.
 #if !defined (IO_STREAM_H)
 #define IO_STREAM_H
 
+#include "cmlibs/zinc/zincconfigure.h"
 #include "general/object.h"
 #include "cmlibs/zinc/types/streamid.h"
 /*
@@ -26,6 +27,21 @@ struct IO_stream_package;
 
 struct IO_stream;
 
+/**
+ * Binary value blocks may replace runs of white space separated numbers in
+ * otherwise text streams, as written by the EX binary format. A block is:
+ * - IO_STREAM_BINARY_BLOCK_MARKER, which is not white space so text scans
+ *   skipping white space stop before it;
+ * - type character IO_STREAM_BINARY_BLOCK_REAL (64-bit IEEE double) or
+ *   IO_STREAM_BINARY_BLOCK_INT (32-bit signed integer);
+ * - number of values as a 32-bit unsigned integer;
+ * - the values.
+ * All binary numbers are little endian.
+ */
+#define IO_STREAM_BINARY_BLOCK_MARKER '\x1f'
+#define IO_STREAM_BINARY_BLOCK_REAL 'r'
+#define IO_STREAM_BINARY_BLOCK_INT 'i'
+
 /*
 Global functions
 ----------------
@@ -38,6 +54,17 @@ LAST MODIFIED : 4 August 2004
 DESCRIPTION :
 ==============================================================================*/
 
+/**
+ * Set whether uncompressed files subsequently opened for reading with streams
+ * from this package are read through a memory mapping rather than stdio.
+ * Default false. Memory mapping avoids stdio overheads for large files, but
+ * the file must not be truncated or rewritten while it is being read: on
+ * Unix, accessing pages beyond the new end of file raises SIGBUS.
+ * @return  1 on success, 0 if invalid argument.
+ */
+int IO_stream_package_set_memory_map_files(struct IO_stream_package *stream_class,
+	bool memory_map_files);
+
 int IO_stream_open_for_read_compression_specified(struct IO_stream *stream, const char *stream_uri,
 	enum cmzn_streaminformation_data_compression_type data_compression_type);
 
@@ -125,6 +152,45 @@ Equivalent to a standard C fgetc on the stream.
   * EOF if at end of stream or invalid stream. */
 int IO_stream_peekc(struct IO_stream *stream);
 
+/**
+ * Call at the start of a section of values which may be written as binary
+ * value blocks, e.g. the field values of a node. The next call to
+ * IO_stream_read_FE_values or IO_stream_read_ints checks for a binary value
+ * block; further calls only check once a binary value block has been read
+ * from the stream, so text values are parsed without looking ahead.
+ */
+void IO_stream_begin_values(struct IO_stream *stream);
+
+/**
+ * Read real values separated by white space from the stream. Equivalent to
+ * calling IO_stream_scan with FE_VALUE_INPUT_STRING for each value, but
+ * buffered streams are parsed directly from the internal buffer without
+ * scanf overheads. If checking for binary values as for
+ * IO_stream_begin_values, and the next non-white space character starts a
+ * binary value block, the values are copied from it instead; the block must
+ * have real type and exactly count values.
+ * @param count  Number of values to read.
+ * @param values  Array to receive count values.
+ * @return  Number of values read, less than count if a value could not be
+ * parsed or at end of stream.
+ */
+int IO_stream_read_FE_values(struct IO_stream *stream, int count, FE_value *values);
+
+/**
+ * Read integer values separated by white space from the stream. Equivalent
+ * to calling IO_stream_scan with "%d" for each value, but buffered streams
+ * are parsed directly from the internal buffer without scanf overheads.
+ * If checking for binary values as for IO_stream_begin_values, and the next
+ * non-white space character starts a binary value block, the values are
+ * copied from it instead; the block must have integer type and exactly
+ * count values.
+ * @param count  Number of values to read.
+ * @param values  Array to receive count values.
+ * @return  Number of values read, less than count if a value could not be
+ * parsed or at end of stream.
+ */
+int IO_stream_read_ints(struct IO_stream *stream, int count, int *values);
+
 int IO_stream_read_string(struct IO_stream *stream,const char *format,char **string_read);
 /******************************************************************************
 LAST MODIFIED : 23 August 2004
@@ -35,7 +35,11 @@ static Display_message_function
 static void	*display_message_data = (void *)NULL;
 
 #define MESSAGE_STRING_SIZE 1000
-static char message_string[MESSAGE_STRING_SIZE];
+// per-thread so messages may be formatted by concurrent threads
+static thread_local char message_string[MESSAGE_STRING_SIZE];
+
+// if set, messages displayed on this thread are captured instead
+static thread_local Display_message_capture *display_message_capture = nullptr;
 
 static bool display_message_on_console = false;
 
@@ -63,6 +67,28 @@ a message of the specified <message_type>.
 	return 1;
 } /* set_display_message_function */
 
+void Display_message_capture::begin()
+{
+	this->enclosing = display_message_capture;
+	display_message_capture = this;
+}
+
+void Display_message_capture::end()
+{
+	if (display_message_capture == this)
+	{
+		display_message_capture = this->enclosing;
+		this->enclosing = nullptr;
+	}
+}
+
+void Display_message_capture::display()
+{
+	for (size_t i = 0; i < this->messages.size(); ++i)
+		display_message_string(this->messages[i].first, this->messages[i].second.c_str());
+	this->messages.clear();
+}
+
 int display_message_string(enum Message_type message_type,
 	const char *the_string)
 {
@@ -71,6 +97,12 @@ int display_message_string(enum Message_type message_type,
 	if (!the_string)
 		return 0;
 
+	if (display_message_capture)
+	{
+		display_message_capture->add(message_type, the_string);
+		return 1;
+	}
+
 	if (display_any_message_function)
 	{
 		return_code=(*display_any_message_function)(the_string,	message_type,
@@ -15,6 +15,9 @@ Global types and function prototypes for displaying messages.
 #define MESSAGE_H
 
 #include "cmlibs/zinc/zincsharedobject.h"
+#include <string>
+#include <utility>
+#include <vector>
 
 /*
 Global types
@@ -39,6 +42,41 @@ The different message types.
 #endif
 
 typedef int (Display_message_function)(const char *,enum Message_type, void *);
+
+/**
+ * Collects messages displayed on a worker thread between begin() and end(),
+ * so they can be displayed later on the calling thread in a defined order.
+ * Avoids calling client message callbacks from worker threads.
+ * Captures may be nested on a thread; end() resumes any enclosing capture.
+ */
+class Display_message_capture
+{
+	std::vector<std::pair<enum Message_type, std::string> > messages;
+	Display_message_capture *enclosing;  // capture active on thread at begin()
+
+public:
+
+	Display_message_capture() :
+		enclosing(nullptr)
+	{
+	}
+
+	/** Start capturing messages displayed on the current thread. */
+	void begin();
+
+	/** Stop capturing messages on the current thread, resuming any capture
+	 * which was active when begin() was called. */
+	void end();
+
+	/** Only to be called by display_message_string. */
+	void add(enum Message_type message_type, const char *the_string)
+	{
+		this->messages.push_back(std::make_pair(message_type, std::string(the_string)));
+	}
+
+	/** Display captured messages in order on the current thread and clear them. */
+	void display();
+};
 /*******************************************************************************
 LAST MODIFIED : 11 June 1999
 
@@ -0,0 +1,146 @@
+/**
+ * FILE : thread_pool.cpp
+ *
+ * Persistent pool of worker threads for splitting evaluations over cores.
+ */
+/* Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "general/thread_pool.hpp"
+#include "general/message.h"
+#include <algorithm>
+#include <atomic>
+#include <system_error>
+
+namespace {
+
+// set in pool threads so nested jobs run serially instead of deadlocking
+thread_local bool inPoolThread = false;
+
+}
+
+ThreadPool::ThreadPool() :
+	work(nullptr),
+	workersCount(0),
+	nextWorkerIndex(0),
+	activeCount(0),
+	stopping(false)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+	this->workCondition.notify_all();
+	for (size_t t = 0; t < this->threads.size(); ++t)
+		this->threads[t].join();
+}
+
+ThreadPool& ThreadPool::getShared()
+{
+	// deliberately not destroyed: joining threads during static destruction or
+	// library unload can deadlock, and waiting threads end with the process
+	static ThreadPool *sharedPool = new ThreadPool();
+	return *sharedPool;
+}
+
+int ThreadPool::resolveThreadsCount(int threadsCount)
+{
+	if (threadsCount == 0)
+		threadsCount = static_cast<int>(std::thread::hardware_concurrency());
+	return (threadsCount < 1) ? 1 : threadsCount;
+}
+
+void ThreadPool::workerLoop()
+{
+	inPoolThread = true;
+	std::unique_lock<std::mutex> lock(this->mutex);
+	while (true)
+	{
+		this->workCondition.wait(lock, [this] {
+			return (this->stopping) || ((this->work) && (this->nextWorkerIndex < this->workersCount)); });
+		if (this->stopping)
+			return;
+		const int workerIndex = this->nextWorkerIndex++;
+		const std::function<void(int)> *currentWork = this->work;
+		++this->activeCount;
+		lock.unlock();
+		(*currentWork)(workerIndex);
+		lock.lock();
+		--this->activeCount;
+		if (this->activeCount == 0)
+			this->doneCondition.notify_all();
+	}
+}
+
+int ThreadPool::execute(int workersCountIn, const std::function<void(int)>& work)
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+	if ((workersCountIn <= 1) || (inPoolThread) || (this->work) || (this->stopping))
+	{
+		lock.unlock();
+		work(0);
+		return 1;
+	}
+	while (static_cast<int>(this->threads.size()) < (workersCountIn - 1))
+	{
+		try
+		{
+			this->threads.push_back(std::thread(&ThreadPool::workerLoop, this));
+		}
+		catch (const std::system_error&)
+		{
+			break;  // use threads already created
+		}
+	}
+	this->work = &work;
+	this->workersCount = std::min(workersCountIn, static_cast<int>(this->threads.size()) + 1);
+	this->nextWorkerIndex = 1;
+	lock.unlock();
+	this->workCondition.notify_all();
+	work(0);
+	lock.lock();
+	// stop further workers claiming the job as caller has finished its share
+	this->workersCount = this->nextWorkerIndex;
+	this->doneCondition.wait(lock, [this] { return this->activeCount == 0; });
+	const int usedCount = this->nextWorkerIndex;
+	this->work = nullptr;
+	return usedCount;
+}
+
+bool ThreadPool::executeChunks(int workersCountIn, size_t chunksCount,
+	const std::function<bool(int, size_t)>& processChunk)
+{
+	const int workersCount = (static_cast<size_t>(workersCountIn) < chunksCount) ?
+		workersCountIn : static_cast<int>(chunksCount);
+	if (workersCount <= 1)
+	{
+		for (size_t c = 0; c < chunksCount; ++c)
+			if (!processChunk(0, c))
+				return false;
+		return true;
+	}
+	std::vector<Display_message_capture> messages(chunksCount);
+	std::atomic<size_t> nextChunk(0);
+	std::atomic_bool failed(false);
+	this->execute(workersCount, [&](int workerIndex)
+	{
+		size_t c;
+		while ((!failed) && ((c = nextChunk++) < chunksCount))
+		{
+			messages[c].begin();
+			if (!processChunk(workerIndex, c))
+				failed = true;
+			messages[c].end();
+		}
+	});
+	for (size_t c = 0; c < chunksCount; ++c)
+		messages[c].display();
+	return !failed;
+}
@@ -0,0 +1,91 @@
+/**
+ * FILE : thread_pool.hpp
+ *
+ * Persistent pool of worker threads for splitting evaluations over cores.
+ */
+/* Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (THREAD_POOL_HPP)
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Pool of worker threads which are kept waiting between jobs so repeated
+ * evaluations do not pay for thread creation each time.
+ * Only one job runs at a time; a job requested while another is running, or
+ * from a pool thread, runs on the calling thread only.
+ */
+class ThreadPool
+{
+	std::mutex mutex;
+	std::condition_variable workCondition;
+	std::condition_variable doneCondition;
+	std::vector<std::thread> threads;
+	const std::function<void(int)> *work;  // current job, or nullptr if none
+	int workersCount;  // workers wanted by current job, including caller
+	int nextWorkerIndex;  // next worker index to claim for current job
+	int activeCount;  // number of pool threads running current job
+	bool stopping;
+
+	void workerLoop();
+
+public:
+
+	ThreadPool();
+
+	/** Stops and joins all pool threads. */
+	~ThreadPool();
+
+	/** @return  Pool shared by all evaluations. It is never destroyed so it is
+	 * safe to use during process exit. */
+	static ThreadPool& getShared();
+
+	/**
+	 * Get number of threads to use from a threads count setting.
+	 * @param threadsCount  Requested number of threads, or 0 for the number of
+	 * hardware threads.
+	 * @return  Number of threads to use, at least 1.
+	 */
+	static int resolveThreadsCount(int threadsCount);
+
+	/**
+	 * Run job with up to workersCountIn workers, the first being the calling
+	 * thread with worker index 0. Pool threads are created on demand. Fewer
+	 * workers may run, possibly only the caller, so work must be shared out
+	 * dynamically, e.g. from an atomic counter, so any one worker completes it.
+	 * Returns after all workers have finished.
+	 * @param workersCountIn  Maximum number of workers including caller.
+	 * @param work  Function called with worker index.
+	 * @return  Number of workers which ran the job, at least 1.
+	 */
+	int execute(int workersCountIn, const std::function<void(int)>& work);
+
+	/**
+	 * Process chunks of work with up to workersCountIn workers, each claiming
+	 * the next unprocessed chunk in order until all are done. With more than one
+	 * worker, messages displayed while processing each chunk are captured and
+	 * displayed on the calling thread in chunk order after all workers finish,
+	 * so client message callbacks are only called from the calling thread.
+	 * No further chunks are started once any chunk fails.
+	 * Worker state can be indexed by worker index: less than
+	 * min(workersCountIn, chunksCount), and 0 is always the calling thread.
+	 * @param workersCountIn  Maximum number of workers including caller.
+	 * @param chunksCount  Number of chunks to process.
+	 * @param processChunk  Function called with worker index and chunk index,
+	 * returning true on success, false on failure.
+	 * @return  True if all chunks were processed successfully, otherwise false.
+	 */
+	bool executeChunks(int workersCountIn, size_t chunksCount,
+		const std::function<bool(int, size_t)>& processChunk);
+};
+
+#endif /* !defined (THREAD_POOL_HPP) */
@@ -0,0 +1,755 @@
+/**
+ * @file gltf_export.cpp
+ *
+ * Class for exporting graphics objects to binary glTF 2.0 (GLB).
+ */
+/* Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include "cmlibs/zinc/material.h"
+#include "general/debug.h"
+#include "general/message.h"
+#include "graphics/gltf_export.hpp"
+#include "graphics/graphics_object.h"
+#include "graphics/graphics_object_private.hpp"
+#include "graphics/render_gl.h"
+
+namespace {
+
+/** glTF accessor component types */
+enum GltfComponentType
+{
+	GLTF_COMPONENT_TYPE_BYTE = 5120,
+	GLTF_COMPONENT_TYPE_UNSIGNED_BYTE = 5121,
+	GLTF_COMPONENT_TYPE_SHORT = 5122,
+	GLTF_COMPONENT_TYPE_UNSIGNED_SHORT = 5123,
+	GLTF_COMPONENT_TYPE_UNSIGNED_INT = 5125,
+	GLTF_COMPONENT_TYPE_FLOAT = 5126
+};
+
+/** glTF buffer view targets */
+enum GltfTarget
+{
+	GLTF_TARGET_NONE = 0,
+	GLTF_TARGET_ARRAY_BUFFER = 34962,
+	GLTF_TARGET_ELEMENT_ARRAY_BUFFER = 34963
+};
+
+/** glTF primitive modes */
+enum GltfMode
+{
+	GLTF_MODE_POINTS = 0,
+	GLTF_MODE_LINES = 1,
+	GLTF_MODE_TRIANGLES = 4
+};
+
+const char *gltfAccessorTypes[5] = { 0, "SCALAR", "VEC2", "VEC3", "VEC4" };
+
+/** Append unsigned 32-bit integer in little endian order as required by GLB */
+void appendUint32(std::string& output, uint32_t value)
+{
+	const char bytes[4] = {
+		static_cast<char>(value & 0xFF), static_cast<char>((value >> 8) & 0xFF),
+		static_cast<char>((value >> 16) & 0xFF), static_cast<char>((value >> 24) & 0xFF) };
+	output.append(bytes, 4);
+}
+
+/** Pad to 4 byte alignment with padding character */
+void padTo4Bytes(std::string& output, char padding)
+{
+	while (0 != (output.size() % 4))
+		output.push_back(padding);
+}
+
+template <typename IntegerType> IntegerType quantiseNormalized(float value)
+{
+	const float maximum = static_cast<float>(std::numeric_limits<IntegerType>::max());
+	float scaledValue = value*maximum;
+	if (std::numeric_limits<IntegerType>::is_signed)
+		scaledValue = std::max(-maximum, std::min(maximum, scaledValue));
+	else
+		scaledValue = std::max(0.0f, std::min(maximum, scaledValue));
+	return static_cast<IntegerType>(std::floor(scaledValue + 0.5f));
+}
+
+}
+
+Gltf_export::Gltf_export(int numberOfTimeStepsIn, double beginTimeIn, double endTimeIn,
+	cmzn_streaminformation_scene_io_data_type modeIn, bool quantisedIn) :
+	numberOfTimeSteps(numberOfTimeStepsIn),
+	beginTime(beginTimeIn),
+	endTime(endTimeIn),
+	mode(modeIn),
+	quantised(quantisedIn),
+	root(Json::objectValue)
+{
+	this->root["asset"]["version"] = "2.0";
+	this->root["asset"]["generator"] = "CMLibs Zinc";
+	this->root["scene"] = 0;
+	this->root["scenes"][0]["nodes"] = Json::arrayValue;
+}
+
+unsigned int Gltf_export::appendBufferView(const void *data, size_t byteLength,
+	unsigned int byteStride, int target)
+{
+	padTo4Bytes(this->binaryBuffer, '\0');
+	Json::Value bufferView;
+	bufferView["buffer"] = 0;
+	bufferView["byteOffset"] = static_cast<Json::UInt64>(this->binaryBuffer.size());
+	bufferView["byteLength"] = static_cast<Json::UInt64>(byteLength);
+	if (byteStride)
+		bufferView["byteStride"] = byteStride;
+	if (target != GLTF_TARGET_NONE)
+		bufferView["target"] = target;
+	this->binaryBuffer.append(static_cast<const char *>(data), byteLength);
+	Json::Value& bufferViews = this->root["bufferViews"];
+	bufferViews.append(bufferView);
+	return bufferViews.size() - 1;
+}
+
+unsigned int Gltf_export::appendAccessor(unsigned int bufferView, int componentType,
+	bool normalized, unsigned int count, const char *type,
+	const Json::Value& minimums, const Json::Value& maximums)
+{
+	Json::Value accessor;
+	accessor["bufferView"] = bufferView;
+	accessor["componentType"] = componentType;
+	if (normalized)
+		accessor["normalized"] = true;
+	accessor["count"] = count;
+	accessor["type"] = type;
+	if (!minimums.isNull())
+		accessor["min"] = minimums;
+	if (!maximums.isNull())
+		accessor["max"] = maximums;
+	Json::Value& accessors = this->root["accessors"];
+	accessors.append(accessor);
+	return accessors.size() - 1;
+}
+
+/** Append first components of each of count vertices with valuesPerVertex as
+ * float accessor. Values are copied directly when already packed. */
+unsigned int Gltf_export::appendFloatAccessor(const float *values, unsigned int valuesPerVertex,
+	unsigned int count, unsigned int components, int target, bool minMax)
+{
+	std::vector<float> packedValues;
+	const float *outputValues = values;
+	if (valuesPerVertex != components)
+	{
+		packedValues.assign(count*components, 0.0f);
+		const unsigned int copyComponents = std::min(components, valuesPerVertex);
+		for (unsigned int i = 0; i < count; ++i)
+			for (unsigned int c = 0; c < copyComponents; ++c)
+				packedValues[i*components + c] = values[i*valuesPerVertex + c];
+		outputValues = packedValues.data();
+	}
+	Json::Value minimums, maximums;
+	if (minMax)
+	{
+		std::vector<float> minimumValues(outputValues, outputValues + components);
+		std::vector<float> maximumValues(minimumValues);
+		for (unsigned int i = 1; i < count; ++i)
+		{
+			const float *value = outputValues + i*components;
+			for (unsigned int c = 0; c < components; ++c)
+			{
+				if (value[c] < minimumValues[c])
+					minimumValues[c] = value[c];
+				else if (value[c] > maximumValues[c])
+					maximumValues[c] = value[c];
+			}
+		}
+		for (unsigned int c = 0; c < components; ++c)
+		{
+			minimums.append(minimumValues[c]);
+			maximums.append(maximumValues[c]);
+		}
+	}
+	const unsigned int bufferView = this->appendBufferView(outputValues,
+		count*components*sizeof(float), 0, target);
+	return this->appendAccessor(bufferView, GLTF_COMPONENT_TYPE_FLOAT, false, count,
+		gltfAccessorTypes[components], minimums, maximums);
+}
+
+/** Append mesh positions as normalized shorts with KHR_mesh_quantization,
+ * setting the offset and scale applied by the mesh node to dequantise them. */
+unsigned int Gltf_export::appendQuantisedPositionAccessor(Mesh& mesh)
+{
+	const unsigned int count = mesh.vertexCount;
+	const float *positions = mesh.positions.data();
+	float minimums[3] = { positions[0], positions[1], positions[2] };
+	float maximums[3] = { positions[0], positions[1], positions[2] };
+	for (unsigned int i = 1; i < count; ++i)
+		for (int c = 0; c < 3; ++c)
+		{
+			minimums[c] = std::min(minimums[c], positions[i*3 + c]);
+			maximums[c] = std::max(maximums[c], positions[i*3 + c]);
+		}
+	for (int c = 0; c < 3; ++c)
+	{
+		mesh.positionOffset[c] = 0.5f*(minimums[c] + maximums[c]);
+		mesh.positionScale[c] = 0.5f*(maximums[c] - minimums[c]);
+		if (mesh.positionScale[c] <= 0.0f)
+			mesh.positionScale[c] = 1.0f;
+	}
+	// vertex attributes must be 4 byte aligned so pad each to 4 shorts
+	std::vector<int16_t> quantisedPositions(count*4, 0);
+	int16_t quantisedMinimums[3] = { 32767, 32767, 32767 };
+	int16_t quantisedMaximums[3] = { -32767, -32767, -32767 };
+	for (unsigned int i = 0; i < count; ++i)
+		for (int c = 0; c < 3; ++c)
+		{
+			const int16_t value = quantiseNormalized<int16_t>(
+				(positions[i*3 + c] - mesh.positionOffset[c]) / mesh.positionScale[c]);
+			quantisedPositions[i*4 + c] = value;
+			quantisedMinimums[c] = std::min(quantisedMinimums[c], value);
+			quantisedMaximums[c] = std::max(quantisedMaximums[c], value);
+		}
+	Json::Value minimumsJson, maximumsJson;
+	for (int c = 0; c < 3; ++c)
+	{
+		minimumsJson.append(quantisedMinimums[c]);
+		maximumsJson.append(quantisedMaximums[c]);
+	}
+	const unsigned int bufferView = this->appendBufferView(quantisedPositions.data(),
+		quantisedPositions.size()*sizeof(int16_t), 4*sizeof(int16_t), GLTF_TARGET_ARRAY_BUFFER);
+	return this->appendAccessor(bufferView, GLTF_COMPONENT_TYPE_SHORT, true, count,
+		"VEC3", minimumsJson, maximumsJson);
+}
+
+/** Append normals with 3 values per vertex, as normalized bytes if quantised */
+unsigned int Gltf_export::appendNormalAccessor(const float *values, unsigned int count)
+{
+	if (!this->quantised)
+		return this->appendFloatAccessor(values, 3, count, 3, GLTF_TARGET_ARRAY_BUFFER, false);
+	// vertex attributes must be 4 byte aligned so pad each to 4 bytes
+	std::vector<int8_t> quantisedNormals(count*4, 0);
+	for (unsigned int i = 0; i < count; ++i)
+		for (int c = 0; c < 3; ++c)
+			quantisedNormals[i*4 + c] = quantiseNormalized<int8_t>(values[i*3 + c]);
+	const unsigned int bufferView = this->appendBufferView(quantisedNormals.data(),
+		quantisedNormals.size(), 4, GLTF_TARGET_ARRAY_BUFFER);
+	return this->appendAccessor(bufferView, GLTF_COMPONENT_TYPE_BYTE, true, count, "VEC3");
+}
+
+/** Append RGBA colours with 4 values per vertex, as normalized unsigned bytes if quantised */
+unsigned int Gltf_export::appendColourAccessor(const float *values, unsigned int count)
+{
+	if (!this->quantised)
+		return this->appendFloatAccessor(values, 4, count, 4, GLTF_TARGET_ARRAY_BUFFER, false);
+	std::vector<uint8_t> quantisedColours(count*4);
+	for (unsigned int i = 0; i < count*4; ++i)
+		quantisedColours[i] = quantiseNormalized<uint8_t>(values[i]);
+	const unsigned int bufferView = this->appendBufferView(quantisedColours.data(),
+		quantisedColours.size(), 0, GLTF_TARGET_ARRAY_BUFFER);
+	return this->appendAccessor(bufferView, GLTF_COMPONENT_TYPE_UNSIGNED_BYTE, true, count, "VEC4");
+}
+
+/** Append indices as unsigned shorts if all vertices can be indexed by them,
+ * otherwise as unsigned ints. Maximum values are reserved for primitive restart. */
+unsigned int Gltf_export::appendIndexAccessor(const std::vector<unsigned int>& indices,
+	unsigned int vertexCount)
+{
+	const unsigned int count = static_cast<unsigned int>(indices.size());
+	unsigned int bufferView;
+	int componentType;
+	if (vertexCount < 65535)
+	{
+		std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+		bufferView = this->appendBufferView(shortIndices.data(), count*sizeof(uint16_t),
+			0, GLTF_TARGET_ELEMENT_ARRAY_BUFFER);
+		componentType = GLTF_COMPONENT_TYPE_UNSIGNED_SHORT;
+	}
+	else
+	{
+		bufferView = this->appendBufferView(indices.data(), count*sizeof(unsigned int),
+			0, GLTF_TARGET_ELEMENT_ARRAY_BUFFER);
+		componentType = GLTF_COMPONENT_TYPE_UNSIGNED_INT;
+	}
+	return this->appendAccessor(bufferView, componentType, false, count, "SCALAR");
+}
+
+/** Append metallic-roughness approximation to material, or get existing.
+ * @param vertexColours  If true, base colour is white so vertex colours are not modulated. */
+unsigned int Gltf_export::appendMaterial(cmzn_material_id material, bool vertexColours)
+{
+	const std::pair<cmzn_material_id, bool> key(material, vertexColours);
+	std::map<std::pair<cmzn_material_id, bool>, unsigned int>::iterator iter = this->materialIndexes.find(key);
+	if (iter != this->materialIndexes.end())
+		return iter->second;
+	Json::Value materialJson;
+	double diffuse[3] = { 1.0, 1.0, 1.0 };
+	double emission[3] = { 0.0, 0.0, 0.0 };
+	double alpha = 1.0, shininess = 0.0;
+	if (material)
+	{
+		char *name = cmzn_material_get_name(material);
+		if (name)
+		{
+			materialJson["name"] = name;
+			DEALLOCATE(name);
+		}
+		cmzn_material_get_attribute_real3(material, CMZN_MATERIAL_ATTRIBUTE_DIFFUSE, diffuse);
+		cmzn_material_get_attribute_real3(material, CMZN_MATERIAL_ATTRIBUTE_EMISSION, emission);
+		alpha = cmzn_material_get_attribute_real(material, CMZN_MATERIAL_ATTRIBUTE_ALPHA);
+		shininess = cmzn_material_get_attribute_real(material, CMZN_MATERIAL_ATTRIBUTE_SHININESS);
+	}
+	Json::Value& pbr = materialJson["pbrMetallicRoughness"];
+	for (int c = 0; c < 3; ++c)
+		pbr["baseColorFactor"].append(vertexColours ? 1.0 : diffuse[c]);
+	pbr["baseColorFactor"].append(alpha);
+	pbr["metallicFactor"] = 0.0;
+	pbr["roughnessFactor"] = std::max(0.0, std::min(1.0, 1.0 - shininess));
+	if ((emission[0] > 0.0) || (emission[1] > 0.0) || (emission[2] > 0.0))
+		for (int c = 0; c < 3; ++c)
+			materialJson["emissiveFactor"].append(emission[c]);
+	if (alpha < 1.0)
+		materialJson["alphaMode"] = "BLEND";
+	materialJson["doubleSided"] = true;
+	Json::Value& materials = this->root["materials"];
+	materials.append(materialJson);
+	const unsigned int materialIndex = materials.size() - 1;
+	this->materialIndexes[key] = materialIndex;
+	return materialIndex;
+}
+
+Gltf_export::Mesh *Gltf_export::findMesh(cmzn_graphics *graphics)
+{
+	for (std::vector<Mesh>::iterator iter = this->meshes.begin(); iter != this->meshes.end(); ++iter)
+		if (iter->graphics == graphics)
+			return &(*iter);
+	return 0;
+}
+
+int Gltf_export::exportGraphicsObject(cmzn_graphics *graphics, GT_object *object, int timeStep,
+	cmzn_material_id material, const char *name, const char *regionPath,
+	const char *groupName, bool morphVertices, bool morphColours, bool morphNormals)
+{
+	if (!((graphics) && (object) && (object->vertex_array)))
+	{
+		display_message(ERROR_MESSAGE, "Gltf_export::exportGraphicsObject.  Invalid argument(s)");
+		return 0;
+	}
+	Graphics_vertex_array *vertexArray = object->vertex_array;
+	const int buffer_binding = object->buffer_binding;
+	object->buffer_binding = 1;
+	GLfloat *positionBuffer = 0;
+	unsigned int positionValuesPerVertex = 0, positionVertexCount = 0;
+	vertexArray->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_POSITION,
+		&positionBuffer, &positionValuesPerVertex, &positionVertexCount);
+	if (!((positionBuffer) && (positionValuesPerVertex > 0) && (positionVertexCount > 0)))
+	{
+		object->buffer_binding = buffer_binding;
+		return 1;
+	}
+	if (timeStep > 0)
+	{
+		Mesh *mesh = this->findMesh(graphics);
+		if (mesh)
+			this->addMorphTarget(*mesh, object, timeStep, positionBuffer, positionValuesPerVertex, positionVertexCount);
+		object->buffer_binding = buffer_binding;
+		return 1;
+	}
+	int primitiveMode = GLTF_MODE_POINTS;
+	std::vector<unsigned int> indices;
+	const GT_object_type objectType = GT_object_get_type(object);
+	switch (objectType)
+	{
+	case g_SURFACE_VERTEX_BUFFERS:
+	{
+		primitiveMode = GLTF_MODE_TRIANGLES;
+		unsigned int *stripIndexBuffer = 0, *stripPointsBuffer = 0, *stripStartBuffer = 0;
+		unsigned int valuesPerVertex = 0, stripIndexCount = 0, stripsCount = 0, stripStartsCount = 0;
+		vertexArray->get_unsigned_integer_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_STRIP_INDEX_ARRAY,
+			&stripIndexBuffer, &valuesPerVertex, &stripIndexCount);
+		if (stripIndexBuffer)
+		{
+			vertexArray->get_unsigned_integer_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_NUMBER_OF_POINTS_FOR_STRIP,
+				&stripPointsBuffer, &valuesPerVertex, &stripsCount);
+			vertexArray->get_unsigned_integer_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_STRIP_INDEX_START,
+				&stripStartBuffer, &valuesPerVertex, &stripStartsCount);
+			unsigned int stripStart = 0;
+			for (unsigned int s = 0; (s < stripsCount) && stripPointsBuffer; ++s)
+			{
+				if (stripStartBuffer && (s < stripStartsCount))
+					stripStart = stripStartBuffer[s];
+				const unsigned int pointsCount = stripPointsBuffer[s];
+				const unsigned int *stripIndices = stripIndexBuffer + stripStart;
+				// alternate winding to keep triangles of strip facing the same way
+				for (unsigned int i = 0; i + 2 < pointsCount; ++i)
+				{
+					indices.push_back(stripIndices[(i % 2) ? i + 1 : i]);
+					indices.push_back(stripIndices[(i % 2) ? i : i + 1]);
+					indices.push_back(stripIndices[i + 2]);
+				}
+				stripStart += pointsCount;
+			}
+		}
+		else
+		{
+			// discontinuous triangles are not indexed
+			positionVertexCount -= positionVertexCount % 3;
+		}
+	} break;
+	case g_POLYLINE_VERTEX_BUFFERS:
+	{
+		primitiveMode = GLTF_MODE_LINES;
+		const GT_polyline_type polylineType = object->primitive_lists->gt_polyline_vertex_buffers->polyline_type;
+		const bool discontinuous = (g_PLAIN_DISCONTINUOUS == polylineType) || (g_NORMAL_DISCONTINUOUS == polylineType);
+		unsigned int *startBuffer = 0, *countBuffer = 0;
+		unsigned int valuesPerVertex = 0, linesCount = 0, countsCount = 0;
+		vertexArray->get_unsigned_integer_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_START,
+			&startBuffer, &valuesPerVertex, &linesCount);
+		vertexArray->get_unsigned_integer_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_COUNT,
+			&countBuffer, &valuesPerVertex, &countsCount);
+		for (unsigned int l = 0; (l < linesCount) && (l < countsCount); ++l)
+		{
+			const unsigned int indexStart = startBuffer[l];
+			const unsigned int indexCount = countBuffer[l];
+			for (unsigned int i = 0; i + 1 < indexCount; i += (discontinuous ? 2 : 1))
+			{
+				indices.push_back(indexStart + i);
+				indices.push_back(indexStart + i + 1);
+			}
+		}
+	} break;
+	case g_GLYPH_SET_VERTEX_BUFFERS:
+	case g_POINT_SET_VERTEX_BUFFERS:
+	{
+		primitiveMode = GLTF_MODE_POINTS;
+	} break;
+	default:
+	{
+		object->buffer_binding = buffer_binding;
+		return 1;
+	} break;
+	}
+	if ((0 == positionVertexCount) || ((GLTF_MODE_LINES == primitiveMode) && indices.empty()))
+	{
+		object->buffer_binding = buffer_binding;
+		return 1;
+	}
+
+	Mesh mesh;
+	mesh.graphics = graphics;
+	mesh.vertexCount = positionVertexCount;
+	const bool timeVarying = (this->numberOfTimeSteps > 1);
+	mesh.morphVertices = timeVarying && morphVertices;
+	mesh.morphColours = timeVarying && morphColours;
+	mesh.morphNormals = timeVarying && morphNormals;
+	for (int c = 0; c < 3; ++c)
+	{
+		mesh.positionOffset[c] = 0.0f;
+		mesh.positionScale[c] = 1.0f;
+	}
+	Json::Value primitive;
+	Json::Value& attributes = primitive["attributes"];
+	if (this->quantised || mesh.morphVertices)
+	{
+		mesh.positions.assign(positionVertexCount*3, 0.0f);
+		const unsigned int components = std::min(positionValuesPerVertex, 3u);
+		for (unsigned int i = 0; i < positionVertexCount; ++i)
+			for (unsigned int c = 0; c < components; ++c)
+				mesh.positions[i*3 + c] = positionBuffer[i*positionValuesPerVertex + c];
+	}
+	if (this->quantised)
+		attributes["POSITION"] = this->appendQuantisedPositionAccessor(mesh);
+	else
+		attributes["POSITION"] = this->appendFloatAccessor(positionBuffer, positionValuesPerVertex,
+			positionVertexCount, 3, GLTF_TARGET_ARRAY_BUFFER, /*minMax*/true);
+	if (!mesh.morphVertices)
+		mesh.positions.clear();
+
+	GLfloat *normalBuffer = 0;
+	unsigned int normalValuesPerVertex = 0, normalVertexCount = 0;
+	if ((GLTF_MODE_POINTS != primitiveMode) &&
+		vertexArray->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_NORMAL,
+			&normalBuffer, &normalValuesPerVertex, &normalVertexCount) &&
+		(normalBuffer) && (3 == normalValuesPerVertex) && (normalVertexCount >= positionVertexCount))
+	{
+		attributes["NORMAL"] = this->appendNormalAccessor(normalBuffer, positionVertexCount);
+		if (mesh.morphNormals)
+			mesh.normals.assign(normalBuffer, normalBuffer + 3*positionVertexCount);
+	}
+	else
+	{
+		mesh.morphNormals = false;
+	}
+
+	bool vertexColours = false;
+	if (CMZN_STREAMINFORMATION_SCENE_IO_DATA_TYPE_COLOUR == this->mode)
+	{
+		GLfloat *colourBuffer = 0;
+		unsigned int colourValuesPerVertex = 0, colourVertexCount = 0;
+		if (Graphics_object_create_colour_buffer_from_data(object,
+			&colourBuffer, &colourValuesPerVertex, &colourVertexCount) &&
+			(4 == colourValuesPerVertex) && (colourVertexCount >= positionVertexCount))
+		{
+			vertexColours = true;
+			attributes["COLOR_0"] = this->appendColourAccessor(colourBuffer, positionVertexCount);
+			if (mesh.morphColours)
+				mesh.colours.assign(colourBuffer, colourBuffer + 4*positionVertexCount);
+		}
+		if (colourBuffer)
+			DEALLOCATE(colourBuffer);
+	}
+	else if ((CMZN_STREAMINFORMATION_SCENE_IO_DATA_TYPE_PER_VERTEX_VALUE == this->mode) ||
+		(CMZN_STREAMINFORMATION_SCENE_IO_DATA_TYPE_PER_FACE_VALUE == this->mode))
+	{
+		// application-specific attribute; glTF has no per-face values
+		GLfloat *dataBuffer = 0;
+		unsigned int dataValuesPerVertex = 0, dataVertexCount = 0;
+		if (vertexArray->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_DATA,
+			&dataBuffer, &dataValuesPerVertex, &dataVertexCount) &&
+			(dataBuffer) && (dataValuesPerVertex > 0) && (dataVertexCount >= positionVertexCount))
+		{
+			attributes["_DATA"] = this->appendFloatAccessor(dataBuffer, dataValuesPerVertex,
+				positionVertexCount, std::min(dataValuesPerVertex, 4u), GLTF_TARGET_ARRAY_BUFFER, false);
+		}
+	}
+	if (!vertexColours)
+		mesh.morphColours = false;
+
+	GLfloat *textureCoordinateBuffer = 0;
+	unsigned int textureCoordinateValuesPerVertex = 0, textureCoordinateVertexCount = 0;
+	if ((GLTF_MODE_TRIANGLES == primitiveMode) &&
+		vertexArray->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_TEXTURE_COORDINATE_ZERO,
+			&textureCoordinateBuffer, &textureCoordinateValuesPerVertex, &textureCoordinateVertexCount) &&
+		(textureCoordinateBuffer) && (textureCoordinateValuesPerVertex > 0) &&
+		(textureCoordinateVertexCount >= positionVertexCount))
+	{
+		attributes["TEXCOORD_0"] = this->appendFloatAccessor(textureCoordinateBuffer,
+			textureCoordinateValuesPerVertex, positionVertexCount, 2, GLTF_TARGET_ARRAY_BUFFER, false);
+	}
+	object->buffer_binding = buffer_binding;
+
+	if (!indices.empty())
+		primitive["indices"] = this->appendIndexAccessor(indices, positionVertexCount);
+	primitive["mode"] = primitiveMode;
+	primitive["material"] = this->appendMaterial(material, vertexColours);
+
+	Json::Value meshJson;
+	if (name)
+		meshJson["name"] = name;
+	meshJson["primitives"].append(primitive);
+	Json::Value& meshesJson = this->root["meshes"];
+	meshesJson.append(meshJson);
+	mesh.meshIndex = meshesJson.size() - 1;
+
+	Json::Value node;
+	if (name)
+		node["name"] = name;
+	node["mesh"] = mesh.meshIndex;
+	if (this->quantised)
+	{
+		for (int c = 0; c < 3; ++c)
+		{
+			node["translation"].append(mesh.positionOffset[c]);
+			node["scale"].append(mesh.positionScale[c]);
+		}
+	}
+	if (regionPath)
+		node["extras"]["RegionPath"] = regionPath;
+	if (groupName)
+		node["extras"]["GroupName"] = groupName;
+	Json::Value& nodes = this->root["nodes"];
+	nodes.append(node);
+	mesh.nodeIndex = nodes.size() - 1;
+	this->root["scenes"][0]["nodes"].append(mesh.nodeIndex);
+
+	if (mesh.morphVertices || mesh.morphColours || mesh.morphNormals)
+		this->meshes.push_back(mesh);
+	return 1;
+}
+
+/** Add morph target with differences of object values at time step from the
+ * first time step, for the attributes mesh is morphing. */
+void Gltf_export::addMorphTarget(Mesh& mesh, GT_object *object, int timeStep,
+	const float *positions, unsigned int positionValuesPerVertex, unsigned int vertexCount)
+{
+	const unsigned int stepIndex = static_cast<unsigned int>(timeStep - 1);
+	if (mesh.timeStepTargets.size() <= stepIndex)
+		mesh.timeStepTargets.resize(stepIndex + 1, -1);
+	if (vertexCount < mesh.vertexCount)
+	{
+		display_message(WARNING_MESSAGE, "Gltf_export::addMorphTarget.  "
+			"Number of vertices changed at time step %d; morph target not exported", timeStep);
+		return;
+	}
+	const unsigned int count = mesh.vertexCount;
+	Json::Value target;
+	std::vector<float> differences;
+	if (mesh.morphVertices)
+	{
+		differences.assign(count*3, 0.0f);
+		const unsigned int components = std::min(positionValuesPerVertex, 3u);
+		float maximumScaledDifference = 0.0f;
+		for (unsigned int i = 0; i < count; ++i)
+			for (unsigned int c = 0; c < components; ++c)
+			{
+				const float difference = positions[i*positionValuesPerVertex + c] - mesh.positions[i*3 + c];
+				differences[i*3 + c] = difference;
+				maximumScaledDifference = std::max(maximumScaledDifference,
+					std::fabs(difference / mesh.positionScale[c]));
+			}
+		if (this->quantised && (maximumScaledDifference <= 1.0f))
+		{
+			std::vector<int16_t> quantisedDifferences(count*4, 0);
+			int16_t minimums[3] = { 32767, 32767, 32767 };
+			int16_t maximums[3] = { -32767, -32767, -32767 };
+			for (unsigned int i = 0; i < count; ++i)
+				for (int c = 0; c < 3; ++c)
+				{
+					const int16_t value = quantiseNormalized<int16_t>(differences[i*3 + c] / mesh.positionScale[c]);
+					quantisedDifferences[i*4 + c] = value;
+					minimums[c] = std::min(minimums[c], value);
+					maximums[c] = std::max(maximums[c], value);
+				}
+			Json::Value minimumsJson, maximumsJson;
+			for (int c = 0; c < 3; ++c)
+			{
+				minimumsJson.append(minimums[c]);
+				maximumsJson.append(maximums[c]);
+			}
+			const unsigned int bufferView = this->appendBufferView(quantisedDifferences.data(),
+				quantisedDifferences.size()*sizeof(int16_t), 4*sizeof(int16_t), GLTF_TARGET_ARRAY_BUFFER);
+			target["POSITION"] = this->appendAccessor(bufferView, GLTF_COMPONENT_TYPE_SHORT, true,
+				count, "VEC3", minimumsJson, maximumsJson);
+		}
+		else
+		{
+			// differences in quantised space exceed normalized range: use floats
+			// divided by the node scale which is applied to the morphed positions
+			if (this->quantised)
+				for (unsigned int i = 0; i < count; ++i)
+					for (int c = 0; c < 3; ++c)
+						differences[i*3 + c] /= mesh.positionScale[c];
+			target["POSITION"] = this->appendFloatAccessor(differences.data(), 3, count, 3,
+				GLTF_TARGET_ARRAY_BUFFER, /*minMax*/true);
+		}
+	}
+	if (mesh.morphNormals)
+	{
+		GLfloat *normalBuffer = 0;
+		unsigned int normalValuesPerVertex = 0, normalVertexCount = 0;
+		if (object->vertex_array->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_NORMAL,
+			&normalBuffer, &normalValuesPerVertex, &normalVertexCount) &&
+			(normalBuffer) && (3 == normalValuesPerVertex) && (normalVertexCount >= count))
+		{
+			differences.resize(count*3);
+			for (unsigned int i = 0; i < count*3; ++i)
+				differences[i] = normalBuffer[i] - mesh.normals[i];
+			target["NORMAL"] = this->appendFloatAccessor(differences.data(), 3, count, 3,
+				GLTF_TARGET_ARRAY_BUFFER, false);
+		}
+	}
+	if (mesh.morphColours)
+	{
+		GLfloat *colourBuffer = 0;
+		unsigned int colourValuesPerVertex = 0, colourVertexCount = 0;
+		if (Graphics_object_create_colour_buffer_from_data(object,
+			&colourBuffer, &colourValuesPerVertex, &colourVertexCount) &&
+			(4 == colourValuesPerVertex) && (colourVertexCount >= count))
+		{
+			differences.resize(count*4);
+			for (unsigned int i = 0; i < count*4; ++i)
+				differences[i] = colourBuffer[i] - mesh.colours[i];
+			target["COLOR_0"] = this->appendFloatAccessor(differences.data(), 4, count, 4,
+				GLTF_TARGET_ARRAY_BUFFER, false);
+		}
+		if (colourBuffer)
+			DEALLOCATE(colourBuffer);
+	}
+	if (target.isNull())
+		return;
+	Json::Value& meshJson = this->root["meshes"][mesh.meshIndex];
+	Json::Value& targets = meshJson["primitives"][0]["targets"];
+	targets.append(target);
+	meshJson["weights"].append(0.0);
+	mesh.timeStepTargets[stepIndex] = static_cast<int>(targets.size() - 1);
+}
+
+/** Append animation of morph target weights for meshes with targets, with
+ * each time step showing its target at full weight, linearly interpolated. */
+void Gltf_export::appendAnimation()
+{
+	if (this->numberOfTimeSteps < 2)
+		return;
+	const unsigned int keyframesCount = static_cast<unsigned int>(this->numberOfTimeSteps);
+	const double increment = (this->endTime - this->beginTime) / static_cast<double>(keyframesCount - 1);
+	Json::Value animation;
+	int inputAccessor = -1;
+	for (std::vector<Mesh>::iterator iter = this->meshes.begin(); iter != this->meshes.end(); ++iter)
+	{
+		Mesh& mesh = *iter;
+		const Json::Value& meshJson = this->root["meshes"][mesh.meshIndex];
+		const unsigned int targetsCount = meshJson["weights"].size();
+		if (0 == targetsCount)
+			continue;
+		if (inputAccessor < 0)
+		{
+			std::vector<float> times(keyframesCount);
+			for (unsigned int k = 0; k < keyframesCount; ++k)
+				times[k] = static_cast<float>(this->beginTime + k*increment);
+			inputAccessor = static_cast<int>(this->appendFloatAccessor(times.data(), 1,
+				keyframesCount, 1, GLTF_TARGET_NONE, /*minMax*/true));
+		}
+		std::vector<float> weights(keyframesCount*targetsCount, 0.0f);
+		for (unsigned int k = 1; k < keyframesCount; ++k)
+			if ((k - 1 < mesh.timeStepTargets.size()) && (mesh.timeStepTargets[k - 1] >= 0))
+				weights[k*targetsCount + mesh.timeStepTargets[k - 1]] = 1.0f;
+		Json::Value sampler;
+		sampler["input"] = inputAccessor;
+		sampler["output"] = this->appendFloatAccessor(weights.data(), 1,
+			keyframesCount*targetsCount, 1, GLTF_TARGET_NONE, false);
+		sampler["interpolation"] = "LINEAR";
+		Json::Value& samplers = animation["samplers"];
+		samplers.append(sampler);
+		Json::Value channel;
+		channel["sampler"] = samplers.size() - 1;
+		channel["target"]["node"] = mesh.nodeIndex;
+		channel["target"]["path"] = "weights";
+		animation["channels"].append(channel);
+	}
+	if (inputAccessor >= 0)
+		this->root["animations"].append(animation);
+}
+
+std::string Gltf_export::getGlb()
+{
+	this->appendAnimation();
+	padTo4Bytes(this->binaryBuffer, '\0');
+	if (!this->binaryBuffer.empty())
+		this->root["buffers"][0]["byteLength"] = static_cast<Json::UInt64>(this->binaryBuffer.size());
+	if (this->quantised)
+	{
+		this->root["extensionsUsed"].append("KHR_mesh_quantization");
+		this->root["extensionsRequired"].append("KHR_mesh_quantization");
+	}
+	std::string jsonChunk = Json::FastWriter().write(this->root);
+	padTo4Bytes(jsonChunk, ' ');
+	std::string glb;
+	const size_t totalLength = 12 + 8 + jsonChunk.size() +
+		(this->binaryBuffer.empty() ? 0 : 8 + this->binaryBuffer.size());
+	glb.reserve(totalLength);
+	appendUint32(glb, 0x46546C67);  // "glTF"
+	appendUint32(glb, 2);
+	appendUint32(glb, static_cast<uint32_t>(totalLength));
+	appendUint32(glb, static_cast<uint32_t>(jsonChunk.size()));
+	appendUint32(glb, 0x4E4F534A);  // "JSON"
+	glb += jsonChunk;
+	if (!this->binaryBuffer.empty())
+	{
+		appendUint32(glb, static_cast<uint32_t>(this->binaryBuffer.size()));
+		appendUint32(glb, 0x004E4942);  // "BIN"
+		glb += this->binaryBuffer;
+	}
+	return glb;
+}
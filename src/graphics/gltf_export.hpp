@@ -0,0 +1,115 @@
+/**
+ * @file gltf_export.hpp
+ *
+ * Class for exporting graphics objects to binary glTF 2.0 (GLB).
+ */
+/* Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (GLTF_EXPORT_HPP)
+#define GLTF_EXPORT_HPP
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "jsoncpp/json.h"
+#include "cmlibs/zinc/types/graphicsid.h"
+#include "cmlibs/zinc/types/materialid.h"
+#include "cmlibs/zinc/types/sceneid.h"
+
+struct GT_object;
+
+/**
+ * Accumulates meshes for graphics objects into a single glTF 2.0 document
+ * with one binary buffer, output as a GLB. Vertex attributes are copied as raw
+ * typed arrays from the graphics vertex arrays, optionally quantised with
+ * KHR_mesh_quantization. Later time steps are added as morph targets holding
+ * the differences from the first time step, animated by mesh weights.
+ * Glyph sets are output as points at glyph positions; glyph shapes are not
+ * exported.
+ */
+class Gltf_export
+{
+	/** Mesh for one graphics, retaining first time step values for morph differences */
+	struct Mesh
+	{
+		cmzn_graphics *graphics;  // not accessed
+		unsigned int meshIndex, nodeIndex;
+		unsigned int vertexCount;
+		bool morphVertices, morphColours, morphNormals;
+		// offset and scale of quantised positions per component
+		float positionOffset[3], positionScale[3];
+		std::vector<float> positions, normals, colours;
+		// index of morph target for each time step after the first, or -1 if none
+		std::vector<int> timeStepTargets;
+	};
+
+	int numberOfTimeSteps;
+	double beginTime, endTime;
+	cmzn_streaminformation_scene_io_data_type mode;
+	bool quantised;
+	Json::Value root;
+	std::string binaryBuffer;
+	std::vector<Mesh> meshes;
+	// index of glTF material for each zinc material, with or without vertex colours
+	std::map<std::pair<cmzn_material_id, bool>, unsigned int> materialIndexes;
+
+	unsigned int appendBufferView(const void *data, size_t byteLength,
+		unsigned int byteStride, int target);
+
+	unsigned int appendAccessor(unsigned int bufferView, int componentType,
+		bool normalized, unsigned int count, const char *type,
+		const Json::Value& minimums = Json::Value(), const Json::Value& maximums = Json::Value());
+
+	unsigned int appendFloatAccessor(const float *values, unsigned int valuesPerVertex,
+		unsigned int count, unsigned int components, int target, bool minMax);
+
+	unsigned int appendQuantisedPositionAccessor(Mesh& mesh);
+
+	unsigned int appendNormalAccessor(const float *values, unsigned int count);
+
+	unsigned int appendColourAccessor(const float *values, unsigned int count);
+
+	unsigned int appendIndexAccessor(const std::vector<unsigned int>& indices,
+		unsigned int vertexCount);
+
+	unsigned int appendMaterial(cmzn_material_id material, bool vertexColours);
+
+	Mesh *findMesh(cmzn_graphics *graphics);
+
+	void addMorphTarget(Mesh& mesh, GT_object *object, int timeStep,
+		const float *positions, unsigned int positionValuesPerVertex, unsigned int vertexCount);
+
+	void appendAnimation();
+
+public:
+
+	Gltf_export(int numberOfTimeStepsIn, double beginTimeIn, double endTimeIn,
+		cmzn_streaminformation_scene_io_data_type modeIn, bool quantisedIn);
+
+	/**
+	 * Add mesh for surfaces, lines or points in graphics object at first time
+	 * step, or morph target for later time steps.
+	 * @param graphics  Owner of object, used to match meshes over time steps.
+	 * @param name  Name of node for graphics.
+	 * @param regionPath  Optional region path added to node extras.
+	 * @param groupName  Optional subgroup name added to node extras.
+	 * @param morphVertices, morphColours, morphNormals  Flags for whether to
+	 * output morph targets for these attributes; only read at first time step.
+	 * @return  1 on success including if nothing to export, 0 on failure.
+	 */
+	int exportGraphicsObject(cmzn_graphics *graphics, GT_object *object, int timeStep,
+		cmzn_material_id material, const char *name, const char *regionPath,
+		const char *groupName, bool morphVertices, bool morphColours, bool morphNormals);
+
+	/** Complete animation and buffers, then serialise. Call once after all
+	 * time steps have been exported.
+	 * @return  Complete GLB file contents. */
+	std::string getGlb();
+};
+
+#endif /* !defined (GLTF_EXPORT_HPP) */
@@ -9,7 +9,9 @@
 * This Source Code Form is subject to the terms of the Mozilla Public
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "cmlibs/zinc/zincconfigure.h"
 
@@ -33,6 +35,7 @@
 #include "general/multi_range.h"
 #include "general/mystring.h"
 #include "general/object.h"
+#include "general/thread_pool.hpp"
 #include "computed_field/computed_field.h"
 #include "computed_field/computed_field_finite_element.h"
 #include "computed_field/computed_field_group.hpp"
@@ -42,6 +45,7 @@
 #include "computed_field/field_module.hpp"
 #include "finite_element/finite_element.h"
 #include "finite_element/finite_element_discretization.h"
+#include "finite_element/finite_element_nodeset.hpp"
 #include "finite_element/finite_element_region.h"
 #include "finite_element/finite_element_to_graphics_object.h"
 #include "finite_element/finite_element_to_iso_lines.h"
@@ -52,6 +56,7 @@
 #include "graphics/glyph.hpp"
 #include "graphics/graphics_object.h"
 #include "graphics/graphics_object.hpp"
+#include "graphics/graphics_object_lod.hpp"
 #include "graphics/scene.hpp"
 #include "graphics/graphics.hpp"
 #include "graphics/graphics_module.hpp"
@@ -192,8 +197,10 @@ cmzn_graphics::cmzn_graphics(enum cmzn_graphics_type graphicsTypeIn) :
 	first_isovalue(0.0),
 	last_isovalue(0.0),
 	decimation_threshold(0.0),
+	weld_vertices(false),
 	glyph(nullptr),
 	glyph_repeat_mode(CMZN_GLYPH_REPEAT_MODE_NONE),
+	render_instanced(false),
 	point_orientation_scale_field(nullptr),
 	signed_scale_field(nullptr),
 	label_field(nullptr),
@@ -385,6 +392,7 @@ void cmzn_graphics::setChange(cmzn_graphics_change change)
 		this->graphics_changed = 1;
 		if (this->graphics_object)
 			DEACCESS(GT_object)(&(this->graphics_object));
+		this->changedNodeIndexes.clear();
 		break;
 	}
 	this->incrementalBuildIndex = DS_LABEL_INDEX_INVALID;
@@ -530,6 +538,102 @@ bool cmzn_element_is_on_subgroup_boundary(cmzn_element *element, cmzn_field *sub
 	return parentsInGroup == 1;
 }
 
+/**
+ * Get the chordal error of the coordinate field along each xi direction of a
+ * 1-D or 2-D element: the distance of the point at mid-xi from the midpoint of
+ * the chord joining its ends. Taken along the middle line of square elements
+ * and the xi = 0 edge of simplex elements.
+ * @param chordErrors  Array of size element dimension to receive errors.
+ * @return  1 on success, 0 if coordinates could not be evaluated.
+ */
+static int cmzn_element_get_chord_errors(cmzn_element *element,
+	cmzn_fieldcache *field_cache, cmzn_field *coordinate_field, FE_value *chordErrors)
+{
+	const int dimension = get_FE_element_dimension(element);
+	const int componentsCount = cmzn_field_get_number_of_components(coordinate_field);
+	if ((dimension < 1) || (2 < dimension) || (componentsCount < 1) || (3 < componentsCount))
+		return 0;
+	FE_value otherXi = 0.5;
+	if (2 == dimension)
+	{
+		enum FE_element_shape_type shape_type;
+		FE_element_shape *element_shape = get_FE_element_shape(element);
+		if ((element_shape) && get_FE_element_shape_xi_shape_type(element_shape, /*xi_number*/0, &shape_type) &&
+			(SIMPLEX_SHAPE == shape_type))
+			otherXi = 0.0;
+	}
+	for (int d = 0; d < dimension; ++d)
+	{
+		FE_value coordinates[3][3];
+		for (int p = 0; p < 3; ++p)
+		{
+			FE_value xi[MAXIMUM_ELEMENT_XI_DIMENSIONS] = { otherXi, otherXi, 0.0 };
+			xi[d] = 0.5*p;
+			if ((CMZN_OK != field_cache->setMeshLocation(element, xi)) ||
+				(CMZN_OK != cmzn_field_evaluate_real(coordinate_field, field_cache, componentsCount, coordinates[p])))
+				return 0;
+		}
+		FE_value sumSquares = 0.0;
+		for (int c = 0; c < componentsCount; ++c)
+		{
+			const FE_value difference = coordinates[1][c] - 0.5*(coordinates[0][c] + coordinates[2][c]);
+			sumSquares += difference*difference;
+		}
+		chordErrors[d] = sqrt(sumSquares);
+	}
+	return 1;
+}
+
+/**
+ * Reduce divisions of a lines or surfaces element for an adaptive level of
+ * detail. Each xi direction gets the fewest divisions for which its chordal
+ * error, which falls with the square of the number of divisions, is within
+ * the level's geometric error, but no fewer than the minimum divisions.
+ * Divisions are unchanged if the chordal errors cannot be evaluated.
+ * Surface elements use the divisions in lodNumberInXi if set.
+ * @param number_in_xi  On entry the fully refined divisions; on exit the
+ * divisions for the level of detail.
+ */
+static void cmzn_element_get_lod_number_in_xi(cmzn_element *element,
+	cmzn_graphics_to_graphics_object_data *graphics_to_object_data,
+	struct FE_field *native_discretization_field, int *number_in_xi)
+{
+	const int *lodNumberInXi = graphics_to_object_data->lodNumberInXi;
+	if ((lodNumberInXi) && (2 == get_FE_element_dimension(element)))
+	{
+		// use divisions matched across shared edges
+		const int *elementNumberInXi = lodNumberInXi + 2*get_FE_element_index(element);
+		if (0 < elementNumberInXi[0])
+		{
+			for (int d = 0; d < 2; ++d)
+				if (elementNumberInXi[d] < number_in_xi[d])
+					number_in_xi[d] = elementNumberInXi[d];
+			return;
+		}
+	}
+	FE_value chordErrors[2];
+	if (!cmzn_element_get_chord_errors(element, graphics_to_object_data->field_cache,
+		graphics_to_object_data->rc_coordinate_field, chordErrors))
+		return;
+	int top_level_minimum_number_in_xi[MAXIMUM_ELEMENT_XI_DIMENSIONS];
+	for (int dim = 0; dim < MAXIMUM_ELEMENT_XI_DIMENSIONS; dim++)
+		top_level_minimum_number_in_xi[dim] = graphics_to_object_data->top_level_minimum_number_in_xi[dim];
+	struct FE_element *top_level_element = 0;
+	int minimum_number_in_xi[MAXIMUM_ELEMENT_XI_DIMENSIONS];
+	if (!get_FE_element_discretization(element, graphics_to_object_data->graphics->face,
+		native_discretization_field, top_level_minimum_number_in_xi, &top_level_element, minimum_number_in_xi))
+		return;
+	const int dimension = get_FE_element_dimension(element);
+	for (int d = 0; d < dimension; ++d)
+	{
+		int divisions = static_cast<int>(ceil(sqrt(chordErrors[d]/graphics_to_object_data->lodGeometricError)));
+		if (divisions < minimum_number_in_xi[d])
+			divisions = minimum_number_in_xi[d];
+		if (divisions < number_in_xi[d])
+			number_in_xi[d] = divisions;
+	}
+}
+
 /**
  * Converts a finite element into a graphics object with the supplied graphics.
  * @param element  The cmzn_element.
@@ -648,6 +752,15 @@ static int cmzn_element_to_graphics_object(cmzn_element *element,
 			graphics->face, native_discretization_field, top_level_number_in_xi,
 			&top_level_element, number_in_xi))
 		{
+			if ((0.0 < graphics_to_object_data->lodGeometricError) &&
+				((CMZN_GRAPHICS_TYPE_LINES == graphics->graphics_type) ||
+					(CMZN_GRAPHICS_TYPE_SURFACES == graphics->graphics_type)))
+			{
+				cmzn_element_get_lod_number_in_xi(element, graphics_to_object_data,
+					native_discretization_field, number_in_xi);
+			}
+			Graphics_vertex_array *vertexArray = (graphics_to_object_data->vertexArray) ?
+				graphics_to_object_data->vertexArray : GT_object_get_vertex_set(graphics->graphics_object);
 			switch (graphics->graphics_type)
 			{
 				case CMZN_GRAPHICS_TYPE_LINES:
@@ -655,8 +768,7 @@ static int cmzn_element_to_graphics_object(cmzn_element *element,
 					if (CMZN_GRAPHICSLINEATTRIBUTES_SHAPE_TYPE_LINE == graphics->line_shape)
 					{
 						return_code = FE_element_add_line_to_vertex_array(
-							element, graphics_to_object_data->field_cache,
-							GT_object_get_vertex_set(graphics->graphics_object),
+							element, graphics_to_object_data->field_cache, vertexArray,
 							graphics_to_object_data->rc_coordinate_field,
 							graphics_to_object_data->number_of_data_values,
 							graphics->data_field,
@@ -666,8 +778,7 @@ static int cmzn_element_to_graphics_object(cmzn_element *element,
 					else
 					{
 						return_code = FE_element_add_cylinder_to_vertex_array(
-							element, graphics_to_object_data->field_cache,
-							GT_object_get_vertex_set(graphics->graphics_object),
+							element, graphics_to_object_data->field_cache, vertexArray,
 							graphics_to_object_data->master_mesh,
 							graphics_to_object_data->rc_coordinate_field,
 							graphics->data_field,
@@ -684,8 +795,7 @@ static int cmzn_element_to_graphics_object(cmzn_element *element,
 				{
 					return_code = FE_element_add_surface_to_vertex_array(
 						element, graphics_to_object_data->field_cache,
-						graphics_to_object_data->master_mesh,
-						GT_object_get_vertex_set(graphics->graphics_object),
+						graphics_to_object_data->master_mesh, vertexArray,
 						graphics_to_object_data->rc_coordinate_field,
 						graphics->texture_coordinate_field,
 						graphics->data_field,
@@ -702,8 +812,7 @@ static int cmzn_element_to_graphics_object(cmzn_element *element,
 							{
 								return_code = create_iso_surfaces_from_FE_element(element,
 									graphics_to_object_data->field_cache,
-									graphics_to_object_data->master_mesh,
-									GT_object_get_vertex_set(graphics->graphics_object),
+									graphics_to_object_data->master_mesh, vertexArray,
 									number_in_xi, graphics_to_object_data->iso_surface_specification);
 							}
 						} break;
@@ -833,7 +942,7 @@ static int cmzn_element_to_graphics_object(cmzn_element *element,
 										static_cast<int>(graphics->streamlines_track_direction == CMZN_GRAPHICS_STREAMLINES_TRACK_DIRECTION_REVERSE),
 										graphics->streamline_length,
 										graphics->streamlines_colour_data_type, graphics->data_field,
-										GT_object_get_vertex_set(graphics->graphics_object));
+										graphics_to_object_data->streamlineElementLocator, vertexArray);
 								}
 							} break;
 						case CMZN_GRAPHICSLINEATTRIBUTES_SHAPE_TYPE_RIBBON:
@@ -855,7 +964,7 @@ static int cmzn_element_to_graphics_object(cmzn_element *element,
 										graphics->line_base_size, graphics->line_scale_factors,
 										graphics->line_orientation_scale_field,
 										graphics->streamlines_colour_data_type, graphics->data_field,
-										GT_object_get_vertex_set(graphics->graphics_object));
+										graphics_to_object_data->streamlineElementLocator, vertexArray);
 								}
 							} break;
 						case CMZN_GRAPHICSLINEATTRIBUTES_SHAPE_TYPE_INVALID:
@@ -899,84 +1008,81 @@ static int cmzn_element_to_graphics_object(cmzn_element *element,
 	return (return_code);
 } /* cmzn_element_to_graphics_object */
 
+/** Streamline seed location evaluated from seed node mesh location field */
+struct cmzn_streamline_seed
+{
+	cmzn_element *element;  // accessed
+	FE_value xi[MAXIMUM_ELEMENT_XI_DIMENSIONS];
+};
+
 /***************************************************************************//**
- * Creates a streamline seeded from the location given by the
- * seed_node_mesh_location_field at the node.
- * @param node  The node to seed streamline from.
+ * Creates a streamline seeded from the element location evaluated from the
+ * seed_node_mesh_location_field at a node. Safe to call on multiple threads
+ * with separate field caches and vertex arrays.
+ * @param seed  The location to seed streamline from.
  * @param graphics_to_object_data  All other data including graphics.
  * @return  1 if successfully added streamline
  */
-static int cmzn_node_to_streamline(struct FE_node *node,
+static int cmzn_streamline_seed_to_graphics(cmzn_streamline_seed *seed,
 	struct cmzn_graphics_to_graphics_object_data *graphics_to_object_data)
 {
 	int return_code = 1;
-
-	ENTER(node_to_streamline);
 	struct cmzn_graphics *graphics = 0;
-	if (node && graphics_to_object_data &&
+	if (seed && graphics_to_object_data &&
 		(NULL != (graphics = graphics_to_object_data->graphics)) &&
 		graphics->graphics_object)
 	{
-		cmzn_fieldcache_set_node(graphics_to_object_data->field_cache, node);
+		Graphics_vertex_array *vertexArray = (graphics_to_object_data->vertexArray) ?
+			graphics_to_object_data->vertexArray : GT_object_get_vertex_set(graphics->graphics_object);
+		/* use local copy of xi since tracking function updates it */
 		FE_value xi[MAXIMUM_ELEMENT_XI_DIMENSIONS];
-		cmzn_element_id element = cmzn_field_evaluate_mesh_location(
-			graphics->seed_node_mesh_location_field, graphics_to_object_data->field_cache,
-			MAXIMUM_ELEMENT_XI_DIMENSIONS, xi);
-		if (element)
+		for (int i = 0; i < MAXIMUM_ELEMENT_XI_DIMENSIONS; ++i)
+			xi[i] = seed->xi[i];
+		switch (graphics->line_shape)
 		{
-			switch (graphics->line_shape)
+		case CMZN_GRAPHICSLINEATTRIBUTES_SHAPE_TYPE_LINE:
 			{
-			case CMZN_GRAPHICSLINEATTRIBUTES_SHAPE_TYPE_LINE:
-				{
-					return_code = create_polyline_streamline_FE_element_vertex_array(element,
-							xi, graphics_to_object_data->field_cache,
-							graphics_to_object_data->rc_coordinate_field,
-							graphics_to_object_data->wrapper_stream_vector_field,
-							static_cast<int>(graphics->streamlines_track_direction == CMZN_GRAPHICS_STREAMLINES_TRACK_DIRECTION_REVERSE),
-							graphics->streamline_length,
-							graphics->streamlines_colour_data_type, graphics->data_field,
-							GT_object_get_vertex_set(graphics->graphics_object));
-				} break;
-			case CMZN_GRAPHICSLINEATTRIBUTES_SHAPE_TYPE_RIBBON:
-			case CMZN_GRAPHICSLINEATTRIBUTES_SHAPE_TYPE_CIRCLE_EXTRUSION:
-			case CMZN_GRAPHICSLINEATTRIBUTES_SHAPE_TYPE_SQUARE_EXTRUSION:
-				{
-					return_code = create_surface_streamribbon_FE_element_vertex_array(element,
+				return_code = create_polyline_streamline_FE_element_vertex_array(seed->element,
 						xi, graphics_to_object_data->field_cache,
 						graphics_to_object_data->rc_coordinate_field,
 						graphics_to_object_data->wrapper_stream_vector_field,
 						static_cast<int>(graphics->streamlines_track_direction == CMZN_GRAPHICS_STREAMLINES_TRACK_DIRECTION_REVERSE),
 						graphics->streamline_length,
-						graphics->line_shape, cmzn_tessellation_get_circle_divisions(graphics->tessellation),
-						graphics->line_base_size, graphics->line_scale_factors,
-						graphics->line_orientation_scale_field,
 						graphics->streamlines_colour_data_type, graphics->data_field,
-						GT_object_get_vertex_set(graphics->graphics_object));
-				} break;
-			case CMZN_GRAPHICSLINEATTRIBUTES_SHAPE_TYPE_INVALID:
-				{
-					display_message(ERROR_MESSAGE,
-						"cmzn_node_to_streamline.  Unknown streamline type");
-					return_code=0;
-				} break;
-			}
-			cmzn_element_destroy(&element);
-		}
-		else
-		{
-			return_code=1;
+						graphics_to_object_data->streamlineElementLocator, vertexArray);
+			} break;
+		case CMZN_GRAPHICSLINEATTRIBUTES_SHAPE_TYPE_RIBBON:
+		case CMZN_GRAPHICSLINEATTRIBUTES_SHAPE_TYPE_CIRCLE_EXTRUSION:
+		case CMZN_GRAPHICSLINEATTRIBUTES_SHAPE_TYPE_SQUARE_EXTRUSION:
+			{
+				return_code = create_surface_streamribbon_FE_element_vertex_array(seed->element,
+					xi, graphics_to_object_data->field_cache,
+					graphics_to_object_data->rc_coordinate_field,
+					graphics_to_object_data->wrapper_stream_vector_field,
+					static_cast<int>(graphics->streamlines_track_direction == CMZN_GRAPHICS_STREAMLINES_TRACK_DIRECTION_REVERSE),
+					graphics->streamline_length,
+					graphics->line_shape, cmzn_tessellation_get_circle_divisions(graphics->tessellation),
+					graphics->line_base_size, graphics->line_scale_factors,
+					graphics->line_orientation_scale_field,
+					graphics->streamlines_colour_data_type, graphics->data_field,
+					graphics_to_object_data->streamlineElementLocator, vertexArray);
+			} break;
+		case CMZN_GRAPHICSLINEATTRIBUTES_SHAPE_TYPE_INVALID:
+			{
+				display_message(ERROR_MESSAGE,
+					"cmzn_streamline_seed_to_graphics.  Unknown streamline type");
+				return_code=0;
+			} break;
 		}
 	}
 	else
 	{
 		display_message(ERROR_MESSAGE,
-			"cmzn_node_to_streamline.  Invalid argument(s)");
+			"cmzn_streamline_seed_to_graphics.  Invalid argument(s)");
 		return_code=0;
 	}
-	LEAVE;
-
 	return (return_code);
-} /* node_to_streamline */
+}
 
 int cmzn_graphics_add_to_list(struct cmzn_graphics *graphics,
 	int position,struct LIST(cmzn_graphics) *list_of_graphics)
@@ -1536,6 +1642,7 @@ int cmzn_graphics_update_graphics_object_trivial(struct cmzn_graphics *graphics)
 		{
 			cmzn_graphics_update_graphics_object_trivial_glyph(graphics);
 			set_GT_object_glyph_repeat_mode(graphics->graphics_object, graphics->glyph_repeat_mode);
+			set_GT_object_glyph_render_instanced(graphics->graphics_object, graphics->render_instanced);
 			Triple base_size, scale_factors, offset, label_offset;
 			for (int i = 0; i < 3; ++i)
 			{
@@ -2355,6 +2462,7 @@ int cmzn_graphics_to_point_vertex_buffer(struct cmzn_graphics *graphics,
 			glyph_base_size, glyph_scale_factors, glyph_offset, graphics->font,
 			glyph_label_offset, graphics->label_text,
 			/*label_bounds_dimension*/0, /*label_bounds_components*/0);
+		GT_glyphset_vertex_buffers_set_render_instanced(glyphset, graphics->render_instanced);
 		if (0 == fill_glyph_graphics_vertex_array(
 			GT_object_get_vertex_set(graphics->graphics_object), /*vertex_location*/-1,
 			1, point_list,	axis1_list, axis2_list, axis3_list, scale_list,
@@ -2713,35 +2821,544 @@ static char *cmzn_graphics_get_graphics_object_name(cmzn_graphics *graphics, con
 	return graphics_object_name;
 }
 
+/** Unlocks the mutex, if any, for the lifetime of this object. */
+class MutexUnlock
+{
+	std::mutex *mutex;
+
+public:
+	MutexUnlock(std::mutex *mutexIn) :
+		mutex(mutexIn)
+	{
+		if (this->mutex)
+			this->mutex->unlock();
+	}
+
+	~MutexUnlock()
+	{
+		if (this->mutex)
+			this->mutex->lock();
+	}
+};
+
+/** Number of elements converted into each separate vertex array when
+ * converting elements with multiple threads. */
+const size_t GRAPHICS_ELEMENTS_CHUNK_SIZE = 256;
+
+/** Number of streamlines traced into each separate vertex array when tracing
+ * with multiple threads. Smaller than for elements as each streamline may
+ * pass through many elements. */
+const size_t GRAPHICS_STREAMLINES_CHUNK_SIZE = 16;
+
+/**
+ * Convert objects to graphics with multiple threads from the shared pool.
+ * Objects are split into fixed chunks in order, each converted into its own
+ * vertex array by the next free worker, each with its own field cache. Chunk
+ * arrays are appended to the vertexArray in the data, or the graphics
+ * object's vertex set if not set, in order with offset indexes, giving the
+ * same result as serial conversion.
+ * Only call for a full build where the destination array has no primitives.
+ * @param convertFunction  Function converting one object, adding primitives
+ * to the vertexArray in the data.
+ * @param threadsCount  Maximum number of threads to use, > 1.
+ * @return  1 on success, 0 on failure.
+ */
+template <class Object> static int cmzn_graphics_convert_threaded(
+	std::vector<Object *>& objects, size_t chunkSize,
+	int (*convertFunction)(Object *, cmzn_graphics_to_graphics_object_data *),
+	cmzn_graphics_to_graphics_object_data *graphics_to_object_data, int threadsCount)
+{
+	const size_t objectsCount = objects.size();
+	const size_t chunksCount = (objectsCount + chunkSize - 1)/chunkSize;
+	const int workersCount = (static_cast<size_t>(threadsCount) < chunksCount) ?
+		threadsCount : static_cast<int>(chunksCount);
+	std::vector<cmzn_graphics_to_graphics_object_data> workerData(workersCount, *graphics_to_object_data);
+	for (int w = 0; w < workersCount; ++w)
+		workerData[w].buildMutex = nullptr;  // caller has unlocked build
+	for (int w = 1; w < workersCount; ++w)
+	{
+		workerData[w].field_cache = cmzn_fieldmodule_create_fieldcache(graphics_to_object_data->field_module);
+		cmzn_fieldcache_set_time(workerData[w].field_cache, graphics_to_object_data->time);
+	}
+	std::vector<Graphics_vertex_array *> chunkArrays(chunksCount, nullptr);
+	const bool success = ThreadPool::getShared().executeChunks(workersCount, chunksCount,
+		[&](int workerIndex, size_t c)
+		{
+			cmzn_graphics_to_graphics_object_data *data = &workerData[workerIndex];
+			chunkArrays[c] = new Graphics_vertex_array(GRAPHICS_VERTEX_ARRAY_TYPE_FLOAT_SEPARATE_DRAW_ARRAYS);
+			data->vertexArray = chunkArrays[c];
+			bool chunkSuccess = true;
+			const size_t objectsEnd = std::min((c + 1)*chunkSize, objectsCount);
+			for (size_t o = c*chunkSize; o < objectsEnd; ++o)
+				if (!(convertFunction)(objects[o], data))
+				{
+					chunkSuccess = false;
+					break;
+				}
+			data->vertexArray = nullptr;
+			return chunkSuccess;
+		});
+	for (int w = 1; w < workersCount; ++w)
+		cmzn_fieldcache_destroy(&workerData[w].field_cache);
+	int return_code = (success) ? 1 : 0;
+	Graphics_vertex_array *vertexArray = (graphics_to_object_data->vertexArray) ?
+		graphics_to_object_data->vertexArray : GT_object_get_vertex_set(graphics_to_object_data->graphics->graphics_object);
+	for (size_t c = 0; c < chunksCount; ++c)
+	{
+		if (chunkArrays[c])
+		{
+			if (return_code && !vertexArray->append(*(chunkArrays[c])))
+				return_code = 0;
+			delete chunkArrays[c];
+		}
+	}
+	return return_code;
+}
+
+/**
+ * Convert elements of mesh to lines, surfaces, iso-surface contours or
+ * streamlines graphics with multiple threads.
+ * @see cmzn_graphics_convert_threaded
+ */
+static int cmzn_mesh_to_graphics_threaded(cmzn_mesh_id mesh,
+	cmzn_graphics_to_graphics_object_data *graphics_to_object_data, int threadsCount)
+{
+	std::vector<cmzn_element *> elements;
+	elements.reserve(cmzn_mesh_get_size(mesh));
+	cmzn_elementiterator_id iterator = cmzn_mesh_create_elementiterator(mesh);
+	if (!iterator)
+		return 0;
+	cmzn_element *element;
+	while (0 != (element = cmzn_elementiterator_next_non_access(iterator)))
+		elements.push_back(element);
+	cmzn_elementiterator_destroy(&iterator);
+	// streamlines are much more expensive per element
+	const size_t chunkSize = (graphics_to_object_data->graphics->graphics_type == CMZN_GRAPHICS_TYPE_STREAMLINES) ?
+		GRAPHICS_STREAMLINES_CHUNK_SIZE : GRAPHICS_ELEMENTS_CHUNK_SIZE;
+	return cmzn_graphics_convert_threaded(elements, chunkSize, cmzn_element_to_graphics_object,
+		graphics_to_object_data, threadsCount);
+}
+
+/**
+ * Trace streamlines from seed locations at nodes of the graphics' seed
+ * nodeset, on multiple threads if permitted. Seed locations are evaluated
+ * serially as the seed node mesh location field may be a find mesh location
+ * field, whose search is not thread safe.
+ * @return  1 on success, 0 on failure.
+ */
+static int cmzn_nodeset_seeds_to_streamlines(cmzn_nodeset_id nodeset,
+	cmzn_graphics_to_graphics_object_data *graphics_to_object_data)
+{
+	cmzn_graphics *graphics = graphics_to_object_data->graphics;
+	cmzn_nodeiterator_id iterator = cmzn_nodeset_create_nodeiterator(nodeset);
+	if (!iterator)
+		return 0;
+	std::vector<cmzn_streamline_seed> seeds;
+	cmzn_node_id node = 0;
+	while (0 != (node = cmzn_nodeiterator_next_non_access(iterator)))
+	{
+		cmzn_fieldcache_set_node(graphics_to_object_data->field_cache, node);
+		cmzn_streamline_seed seed;
+		seed.element = cmzn_field_evaluate_mesh_location(
+			graphics->seed_node_mesh_location_field, graphics_to_object_data->field_cache,
+			MAXIMUM_ELEMENT_XI_DIMENSIONS, seed.xi);
+		if (seed.element)
+			seeds.push_back(seed);
+	}
+	cmzn_nodeiterator_destroy(&iterator);
+	std::vector<cmzn_streamline_seed *> seedPointers(seeds.size());
+	for (size_t i = 0; i < seeds.size(); ++i)
+		seedPointers[i] = &seeds[i];
+	int return_code = 1;
+	if ((graphics_to_object_data->threadsCount > 1) && (seeds.size() > GRAPHICS_STREAMLINES_CHUNK_SIZE) &&
+		(0 == GT_object_get_vertex_set(graphics->graphics_object)->get_number_of_vertices(
+			GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_OBJECT_ID)))
+	{
+		MutexUnlock buildUnlock(graphics_to_object_data->buildMutex);
+		return_code = cmzn_graphics_convert_threaded(seedPointers, GRAPHICS_STREAMLINES_CHUNK_SIZE,
+			cmzn_streamline_seed_to_graphics, graphics_to_object_data, graphics_to_object_data->threadsCount);
+	}
+	else
+	{
+		MutexUnlock buildUnlock(graphics_to_object_data->buildMutex);
+		for (size_t i = 0; i < seedPointers.size(); ++i)
+			if (!cmzn_streamline_seed_to_graphics(seedPointers[i], graphics_to_object_data))
+			{
+				return_code = 0;
+				break;
+			}
+	}
+	for (size_t i = 0; i < seeds.size(); ++i)
+		cmzn_element_destroy(&seeds[i].element);
+	return return_code;
+}
+
 static int cmzn_mesh_to_graphics(cmzn_mesh_id mesh, cmzn_graphics_to_graphics_object_data *graphics_to_object_data)
 {
+	cmzn_graphics *graphics = graphics_to_object_data->graphics;
+	// convert elements on multiple threads for a full build of lines, surfaces,
+	// iso-surfaces or streamlines; each element's contours are independent until
+	// welded. Poisson sampled streamlines use random numbers so stay serial
+	const bool streamlines = (graphics->graphics_type == CMZN_GRAPHICS_TYPE_STREAMLINES) &&
+		(graphics->sampling_mode != CMZN_ELEMENT_POINT_SAMPLING_MODE_CELL_POISSON);
+	Graphics_vertex_array *vertexArray = (graphics_to_object_data->vertexArray) ?
+		graphics_to_object_data->vertexArray : GT_object_get_vertex_set(graphics->graphics_object);
+	if ((graphics_to_object_data->threadsCount > 1) &&
+		(!graphics_to_object_data->incrementalBuild) &&
+		((graphics->graphics_type == CMZN_GRAPHICS_TYPE_LINES) ||
+			(graphics->graphics_type == CMZN_GRAPHICS_TYPE_SURFACES) ||
+			((graphics->graphics_type == CMZN_GRAPHICS_TYPE_CONTOURS) &&
+				(graphics_to_object_data->iso_surface_specification)) || streamlines) &&
+		(static_cast<size_t>(cmzn_mesh_get_size(mesh)) >
+			((streamlines) ? GRAPHICS_STREAMLINES_CHUNK_SIZE : GRAPHICS_ELEMENTS_CHUNK_SIZE)) &&
+		(0 == vertexArray->get_number_of_vertices(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_OBJECT_ID)))
+	{
+		MutexUnlock buildUnlock(graphics_to_object_data->buildMutex);
+		return cmzn_mesh_to_graphics_threaded(mesh, graphics_to_object_data, graphics_to_object_data->threadsCount);
+	}
 	cmzn_elementiterator_id iterator = cmzn_mesh_create_elementiterator(mesh);
 	if (!iterator)
 		return 0;
 	int return_code = 1;
 	cmzn_element_id element = 0;
 	GraphicsIncrementalBuild *incrementalBuild = graphics_to_object_data->incrementalBuild;
-	cmzn_graphics *graphics = graphics_to_object_data->graphics;
 	if ((incrementalBuild) && (graphics->incrementalBuildIndex != DS_LABEL_INDEX_INVALID))
 		iterator->setIndex(graphics->incrementalBuildIndex);
-	while (0 != (element = cmzn_elementiterator_next_non_access(iterator)))
 	{
-		if (!cmzn_element_to_graphics_object(element, graphics_to_object_data))
+		// elements only add primitives to this graphics' own object for these
+		// types, so other graphics can build concurrently. Points may share
+		// glyphs and fonts, and Poisson sampling shares the random generator
+		const bool unlockBuild = (graphics->graphics_type == CMZN_GRAPHICS_TYPE_LINES) ||
+			(graphics->graphics_type == CMZN_GRAPHICS_TYPE_SURFACES) ||
+			(graphics->graphics_type == CMZN_GRAPHICS_TYPE_CONTOURS) || streamlines;
+		MutexUnlock buildUnlock((unlockBuild) ? graphics_to_object_data->buildMutex : nullptr);
+		while (0 != (element = cmzn_elementiterator_next_non_access(iterator)))
 		{
-			return_code = 0;
-			break;
+			if (!cmzn_element_to_graphics_object(element, graphics_to_object_data))
+			{
+				return_code = 0;
+				break;
+			}
+			if ((incrementalBuild) && incrementalBuild->incrementDone())
+			{
+				graphics->incrementalBuildIndex = get_FE_element_index(element);
+				if (0 != (element = cmzn_elementiterator_next_non_access(iterator)))
+					incrementalBuild->setMoreWorkToDo();
+				break;
+			}
 		}
-		if ((incrementalBuild) && incrementalBuild->incrementDone())
+	}
+	cmzn_elementiterator_destroy(&iterator);
+	if ((incrementalBuild) && !incrementalBuild->isMoreWorkToDo())
+		graphics->incrementalBuildIndex = DS_LABEL_INDEX_INVALID;
+	return return_code;
+}
+
+/** Maximum number of coarser levels of detail built for adaptive tessellation */
+const int GRAPHICS_LOD_MAXIMUM_LEVELS = 4;
+
+/**
+ * Add an empty vertex buffer primitive for lines or surfaces graphics to a
+ * level of detail graphics object if it has none, otherwise reset its buffer
+ * binding for a partial rebuild.
+ * @return  1 on success, 0 on failure.
+ */
+static int cmzn_graphics_add_lod_primitive(cmzn_graphics *graphics, GT_object *graphics_object)
+{
+	if (GT_object_get_number_of_times(graphics_object) != 0)
+	{
+		GT_object_reset_buffer_binding(graphics_object);
+		return 1;
+	}
+	if ((CMZN_GRAPHICS_TYPE_LINES == graphics->graphics_type) &&
+		(CMZN_GRAPHICSLINEATTRIBUTES_SHAPE_TYPE_LINE == graphics->line_shape))
+	{
+		GT_polyline_vertex_buffers *lines =
+			CREATE(GT_polyline_vertex_buffers)(g_PLAIN, graphics->render_line_width);
+		if (GT_OBJECT_ADD(GT_polyline_vertex_buffers)(graphics_object, lines))
+			return 1;
+		DESTROY(GT_polyline_vertex_buffers)(&lines);
+		return 0;
+	}
+	GT_surface_vertex_buffers *surfaces =
+		CREATE(GT_surface_vertex_buffers)(g_SHADED_TEXMAP, graphics->render_polygon_mode);
+	if (GT_OBJECT_ADD(GT_surface_vertex_buffers)(graphics_object, surfaces))
+		return 1;
+	DESTROY(GT_surface_vertex_buffers)(&surfaces);
+	return 0;
+}
+
+/**
+ * Get divisions of each element of a 2-D mesh for surfaces at levels of
+ * detail, matched so elements sharing an edge divide it equally and surfaces
+ * have no cracks. Edges linked through opposite sides of square elements or
+ * all sides of triangles form classes, each taking the most divisions any of
+ * its elements needs along it for the level's geometric error.
+ * @param levelErrors  Geometric error of each level.
+ * @param levelsNumberInXi  On success, resized to number of levels, each with
+ * 2 divisions per element index, 0 for element indexes not in mesh.
+ * @return  True on success, false if any element lacks line faces, is not a
+ * square or triangle, or its divisions could not be determined.
+ */
+static bool cmzn_mesh_get_lod_surface_number_in_xi(cmzn_mesh *mesh,
+	cmzn_graphics_to_graphics_object_data *graphics_to_object_data,
+	const std::vector<FE_value>& levelErrors, std::vector<std::vector<int> >& levelsNumberInXi)
+{
+	FE_mesh *feMesh = mesh->getFeMesh();
+	FE_mesh *faceMesh = feMesh->getFaceMesh();
+	if ((2 != feMesh->getDimension()) || (!faceMesh))
+		return false;
+	cmzn_graphics *graphics = graphics_to_object_data->graphics;
+	struct FE_field *native_discretization_field = 0;
+	if (graphics->tessellation_field)
+		Computed_field_get_type_finite_element(graphics->tessellation_field, &native_discretization_field);
+	struct ElementDivisions
+	{
+		DsLabelIndex elementIndex;
+		DsLabelIndex edges[2];  // an edge along each xi direction
+		int numberInXi[MAXIMUM_ELEMENT_XI_DIMENSIONS], minimumNumberInXi[MAXIMUM_ELEMENT_XI_DIMENSIONS];
+		FE_value chordErrors[2];
+	};
+	std::vector<ElementDivisions> elementsDivisions;
+	// union-find parents of edges in classes needing equal divisions
+	std::vector<DsLabelIndex> edgeParents(faceMesh->getLabelsIndexSize());
+	for (size_t e = 0; e < edgeParents.size(); ++e)
+		edgeParents[e] = static_cast<DsLabelIndex>(e);
+	auto findClass = [&edgeParents](DsLabelIndex edge)
+	{
+		while (edgeParents[edge] != edge)
+		{
+			edgeParents[edge] = edgeParents[edgeParents[edge]];
+			edge = edgeParents[edge];
+		}
+		return edge;
+	};
+	auto joinClasses = [&edgeParents, &findClass](DsLabelIndex edge1, DsLabelIndex edge2)
+	{
+		const DsLabelIndex class1 = findClass(edge1);
+		const DsLabelIndex class2 = findClass(edge2);
+		if (class1 != class2)
+			edgeParents[class1] = class2;
+	};
+	bool result = true;
+	cmzn_elementiterator_id iterator = cmzn_mesh_create_elementiterator(mesh);
+	cmzn_element_id element = 0;
+	while ((result) && (0 != (element = cmzn_elementiterator_next_non_access(iterator))))
+	{
+		ElementDivisions divisions;
+		divisions.elementIndex = element->getIndex();
+		const cmzn_element_shape_type shapeType = feMesh->getElementShapeType(divisions.elementIndex);
+		const int edgesCount = (CMZN_ELEMENT_SHAPE_TYPE_SQUARE == shapeType) ? 4 :
+			(CMZN_ELEMENT_SHAPE_TYPE_TRIANGLE == shapeType) ? 3 : 0;
+		DsLabelIndex edges[4];
+		result = (0 < edgesCount);
+		for (int e = 0; (result) && (e < edgesCount); ++e)
 		{
-			graphics->incrementalBuildIndex = get_FE_element_index(element);
-			if (0 != (element = cmzn_elementiterator_next_non_access(iterator)))
-				incrementalBuild->setMoreWorkToDo();
+			edges[e] = feMesh->getElementFace(divisions.elementIndex, e);
+			result = (0 <= edges[e]);
+		}
+		if (!result)
 			break;
+		if (4 == edgesCount)
+		{
+			// edges 0 and 1 at xi1 = 0 and 1 lie along xi2; edges 2 and 3 along xi1
+			joinClasses(edges[0], edges[1]);
+			joinClasses(edges[2], edges[3]);
+			divisions.edges[0] = edges[2];
+			divisions.edges[1] = edges[0];
+		}
+		else
+		{
+			// triangles are divided equally along all edges
+			joinClasses(edges[0], edges[1]);
+			joinClasses(edges[0], edges[2]);
+			divisions.edges[0] = divisions.edges[1] = edges[0];
+		}
+		int top_level_number_in_xi[MAXIMUM_ELEMENT_XI_DIMENSIONS];
+		int top_level_minimum_number_in_xi[MAXIMUM_ELEMENT_XI_DIMENSIONS];
+		for (int dim = 0; dim < MAXIMUM_ELEMENT_XI_DIMENSIONS; dim++)
+		{
+			top_level_number_in_xi[dim] = graphics_to_object_data->top_level_number_in_xi[dim];
+			top_level_minimum_number_in_xi[dim] = graphics_to_object_data->top_level_minimum_number_in_xi[dim];
 		}
+		struct FE_element *top_level_element = 0;
+		result = get_FE_element_discretization(element, graphics->face, native_discretization_field,
+				top_level_number_in_xi, &top_level_element, divisions.numberInXi) &&
+			get_FE_element_discretization(element, graphics->face, native_discretization_field,
+				top_level_minimum_number_in_xi, &top_level_element, divisions.minimumNumberInXi) &&
+			cmzn_element_get_chord_errors(element, graphics_to_object_data->field_cache,
+				graphics_to_object_data->rc_coordinate_field, divisions.chordErrors);
+		elementsDivisions.push_back(divisions);
 	}
 	cmzn_elementiterator_destroy(&iterator);
-	if ((incrementalBuild) && !incrementalBuild->isMoreWorkToDo())
-		graphics->incrementalBuildIndex = DS_LABEL_INDEX_INVALID;
+	if (!result)
+		return false;
+	levelsNumberInXi.resize(levelErrors.size());
+	std::vector<int> classNumberInXi(edgeParents.size());
+	for (size_t l = 0; l < levelErrors.size(); ++l)
+	{
+		// divisions each element needs as in cmzn_element_get_lod_number_in_xi
+		std::fill(classNumberInXi.begin(), classNumberInXi.end(), 0);
+		for (size_t i = 0; i < elementsDivisions.size(); ++i)
+		{
+			const ElementDivisions& divisions = elementsDivisions[i];
+			for (int d = 0; d < 2; ++d)
+			{
+				int number = static_cast<int>(ceil(sqrt(divisions.chordErrors[d]/levelErrors[l])));
+				if (number < divisions.minimumNumberInXi[d])
+					number = divisions.minimumNumberInXi[d];
+				if (number > divisions.numberInXi[d])
+					number = divisions.numberInXi[d];
+				int& classNumber = classNumberInXi[findClass(divisions.edges[d])];
+				if (number > classNumber)
+					classNumber = number;
+			}
+		}
+		std::vector<int>& numberInXi = levelsNumberInXi[l];
+		numberInXi.assign(2*static_cast<size_t>(feMesh->getLabelsIndexSize()), 0);
+		for (size_t i = 0; i < elementsDivisions.size(); ++i)
+		{
+			const ElementDivisions& divisions = elementsDivisions[i];
+			for (int d = 0; d < 2; ++d)
+				numberInXi[2*divisions.elementIndex + d] = classNumberInXi[findClass(divisions.edges[d])];
+		}
+	}
+	return true;
+}
+
+/**
+ * Build coarser levels of detail for lines or surfaces graphics whose
+ * tessellation has a pixel error tolerance, once the graphics object is fully
+ * built. Level k has geometric error 4^k times the largest chordal error of
+ * the fully refined divisions, halving the divisions of the most curved
+ * element at each level. Surfaces elements sharing an edge divide it equally
+ * so levels have no cracks. Levels are kept for partial rebuilds which replace
+ * only changed elements. Clears levels of detail if not adaptive.
+ * @return  1 on success, 0 on failure.
+ */
+static int cmzn_graphics_build_lod(cmzn_graphics *graphics,
+	cmzn_graphics_to_graphics_object_data *graphics_to_object_data)
+{
+	GT_object *graphics_object = graphics->graphics_object;
+	const double pixelErrorTolerance = (graphics->tessellation) ?
+		cmzn_tessellation_get_pixel_error_tolerance(graphics->tessellation) : 0.0;
+	GraphicsObjectLod *lod = GT_object_get_lod(graphics_object);
+	if (lod)
+	{
+		// rebuild levels if tolerance changed or too many are invalid after partial rebuilds
+		bool rebuildLevels = (lod->getPixelErrorTolerance() != pixelErrorTolerance);
+		for (int l = 0; (!rebuildLevels) && (l < lod->getNumberOfLevels()); ++l)
+		{
+			int primitivesCount = 0;
+			if (GT_object_get_number_of_invalid_primitives(lod->getLevelObject(l), &primitivesCount)*2 > primitivesCount)
+				rebuildLevels = true;
+		}
+		if (rebuildLevels)
+		{
+			GT_object_set_lod(graphics_object, nullptr);
+			lod = nullptr;
+		}
+	}
+	cmzn_mesh_id iteration_mesh = graphics_to_object_data->iteration_mesh;
+	if ((!(0.0 < pixelErrorTolerance)) || (!iteration_mesh) ||
+		(0 == GT_object_get_number_of_times(graphics_object)))
+		return 1;
+	GraphicsIncrementalBuild *incrementalBuild = graphics_to_object_data->incrementalBuild;
+	if ((incrementalBuild) && incrementalBuild->isMoreWorkToDo())
+		return 1;  // build levels when finest level is complete
+	cmzn_tessellation_get_minimum_divisions(graphics->tessellation,
+		MAXIMUM_ELEMENT_XI_DIMENSIONS, graphics_to_object_data->top_level_minimum_number_in_xi);
+	// surfaces elements get matching divisions along shared edges to avoid
+	// cracks, falling back to divisions chosen per element
+	const bool matchSurfaceEdges = (CMZN_GRAPHICS_TYPE_SURFACES == graphics->graphics_type);
+	std::vector<std::vector<int> > levelsNumberInXi;
+	auto getLevelsNumberInXi = [&]()
+	{
+		std::vector<FE_value> levelErrors(lod->getNumberOfLevels());
+		for (int l = 0; l < lod->getNumberOfLevels(); ++l)
+			levelErrors[l] = lod->getLevelGeometricError(l);
+		MutexUnlock buildUnlock(graphics_to_object_data->buildMutex);
+		if (!cmzn_mesh_get_lod_surface_number_in_xi(iteration_mesh, graphics_to_object_data,
+				levelErrors, levelsNumberInXi))
+			levelsNumberInXi.assign(levelErrors.size(), std::vector<int>());
+	};
+	if ((lod) && (matchSurfaceEdges))
+	{
+		// partial rebuilds only replace changed elements so rebuild levels if
+		// divisions of any other element change
+		getLevelsNumberInXi();
+		for (int l = 0; l < lod->getNumberOfLevels(); ++l)
+			if (lod->getLevelNumberInXi(l) != levelsNumberInXi[l])
+			{
+				GT_object_set_lod(graphics_object, nullptr);
+				lod = nullptr;
+				break;
+			}
+	}
+	if (!lod)
+	{
+		int maximumDivisions = 1;
+		for (int dim = 0; dim < MAXIMUM_ELEMENT_XI_DIMENSIONS; ++dim)
+			if (graphics_to_object_data->top_level_number_in_xi[dim] > maximumDivisions)
+				maximumDivisions = graphics_to_object_data->top_level_number_in_xi[dim];
+		FE_value maximumChordError = 0.0;
+		{
+			MutexUnlock buildUnlock(graphics_to_object_data->buildMutex);
+			cmzn_elementiterator_id iterator = cmzn_mesh_create_elementiterator(iteration_mesh);
+			cmzn_element_id element = 0;
+			while (0 != (element = cmzn_elementiterator_next_non_access(iterator)))
+			{
+				FE_value chordErrors[2];
+				if (cmzn_element_get_chord_errors(element, graphics_to_object_data->field_cache,
+					graphics_to_object_data->rc_coordinate_field, chordErrors))
+				{
+					const int dimension = get_FE_element_dimension(element);
+					for (int d = 0; d < dimension; ++d)
+						if (chordErrors[d] > maximumChordError)
+							maximumChordError = chordErrors[d];
+				}
+			}
+			cmzn_elementiterator_destroy(&iterator);
+		}
+		// nothing to gain from levels of detail if not refined
+		if ((!(0.0 < maximumChordError)) || (maximumDivisions < 2))
+			return 1;
+		const FE_value finestError = maximumChordError/static_cast<FE_value>(maximumDivisions*maximumDivisions);
+		lod = new GraphicsObjectLod(pixelErrorTolerance);
+		for (int k = 1; (k <= GRAPHICS_LOD_MAXIMUM_LEVELS) && ((1 << (k - 1)) < maximumDivisions); ++k)
+			if (!lod->addLevel(graphics_object, finestError*static_cast<FE_value>(1 << (2*k))))
+			{
+				display_message(ERROR_MESSAGE, "cmzn_graphics_build_lod.  Failed to add level of detail");
+				delete lod;
+				return 0;
+			}
+		if (matchSurfaceEdges)
+			getLevelsNumberInXi();
+		GT_object_set_lod(graphics_object, lod);
+	}
+	int return_code = 1;
+	graphics_to_object_data->incrementalBuild = nullptr;
+	for (int l = 0; return_code && (l < lod->getNumberOfLevels()); ++l)
+	{
+		GT_object *levelObject = lod->getLevelObject(l);
+		return_code = cmzn_graphics_add_lod_primitive(graphics, levelObject);
+		if (return_code)
+		{
+			if (matchSurfaceEdges)
+				lod->swapLevelNumberInXi(l, levelsNumberInXi[l]);
+			const std::vector<int>& levelNumberInXi = lod->getLevelNumberInXi(l);
+			graphics_to_object_data->vertexArray = GT_object_get_vertex_set(levelObject);
+			graphics_to_object_data->lodGeometricError = lod->getLevelGeometricError(l);
+			graphics_to_object_data->lodNumberInXi = (levelNumberInXi.empty()) ? nullptr : levelNumberInXi.data();
+			return_code = cmzn_mesh_to_graphics(iteration_mesh, graphics_to_object_data);
+		}
+		GT_object_changed(levelObject);
+	}
+	graphics_to_object_data->vertexArray = nullptr;
+	graphics_to_object_data->lodGeometricError = 0.0;
+	graphics_to_object_data->lodNumberInXi = nullptr;
+	graphics_to_object_data->incrementalBuild = incrementalBuild;
+	lod->updateRange(graphics_object);
 	return return_code;
 }
 
@@ -2751,6 +3368,9 @@ int cmzn_graphics_to_graphics_object_no_check_on_filter(struct cmzn_graphics *gr
 	int return_code = 1;
 	if (graphics && graphics_to_object_data)
 	{
+		std::unique_lock<std::mutex> buildLock;
+		if (graphics_to_object_data->buildMutex)
+			buildLock = std::unique_lock<std::mutex>(*graphics_to_object_data->buildMutex);
 		GraphicsIncrementalBuild *incrementalBuild = graphics_to_object_data->incrementalBuild;
 		bool buildNow = (0 != graphics->graphics_changed);
 		if (buildNow)
@@ -2892,8 +3512,6 @@ int cmzn_graphics_to_graphics_object_no_check_on_filter(struct cmzn_graphics *gr
 							case CMZN_FIELD_DOMAIN_TYPE_NODES:
 							case CMZN_FIELD_DOMAIN_TYPE_DATAPOINTS:
 							{
-								// currently graphics for all nodes/datapoints are always rebuilt entirely
-								GT_object_clear_primitives(graphics->graphics_object);
 								cmzn_nodeset_id master_nodeset = cmzn_fieldmodule_find_nodeset_by_field_domain_type(
 									graphics_to_object_data->field_module, graphics->domain_type);
 								cmzn_nodeset_id iteration_nodeset = nullptr;
@@ -2915,7 +3533,30 @@ int cmzn_graphics_to_graphics_object_no_check_on_filter(struct cmzn_graphics *gr
 								{
 									iteration_nodeset = cmzn_nodeset_access(master_nodeset);
 								}
-								if (iteration_nodeset)
+								// partial rebuild updates points for changed nodes only, otherwise rebuild all
+								bool updated = false;
+								if ((iteration_nodeset) && (!graphics->changedNodeIndexes.empty()))
+								{
+									updated = (0 != Nodeset_update_vertex_array(
+										iteration_nodeset, graphics_to_object_data->field_cache,
+										graphics->graphics_object,
+										static_cast<int>(graphics->changedNodeIndexes.size()), graphics->changedNodeIndexes.data(),
+										graphics_to_object_data->rc_coordinate_field,
+										graphics->data_field,
+										graphics_to_object_data->wrapper_orientation_scale_field,
+										graphics->signed_scale_field,
+										graphics->label_field,
+										graphics->label_density_field,
+										(iteration_nodeset == master_nodeset) ? graphics->subgroup_field : nullptr,
+										cmzn_field_group_base_cast(graphics_to_object_data->selectionGroup),
+										graphics_to_object_data->glyph_gt_object,
+										graphics->point_base_size, graphics->point_offset, graphics->point_scale_factors,
+										graphics->select_mode));
+								}
+								graphics->changedNodeIndexes.clear();
+								if (!updated)
+									GT_object_clear_primitives(graphics->graphics_object);
+								if ((iteration_nodeset) && (!updated))
 								{
 									GT_glyphset_vertex_buffers *glyphset = Nodeset_create_vertex_array(
 										iteration_nodeset, graphics_to_object_data->field_cache,
@@ -2934,14 +3575,15 @@ int cmzn_graphics_to_graphics_object_no_check_on_filter(struct cmzn_graphics *gr
 										graphics->font,  graphics->label_offset,
 										graphics->label_text,
 										graphics->select_mode);
+									GT_glyphset_vertex_buffers_set_render_instanced(glyphset, graphics->render_instanced);
 									if (!GT_OBJECT_ADD(GT_glyphset_vertex_buffers)(
 											graphics->graphics_object, glyphset))
 									{
 										DESTROY(GT_glyphset_vertex_buffers)(&glyphset);
 										return_code = 0;
 									}
-									cmzn_nodeset_destroy(&iteration_nodeset);
 								}
+								cmzn_nodeset_destroy(&iteration_nodeset);
 								cmzn_nodeset_destroy(&master_nodeset);
 							} break;
 							case CMZN_FIELD_DOMAIN_TYPE_POINT:
@@ -2976,6 +3618,7 @@ int cmzn_graphics_to_graphics_object_no_check_on_filter(struct cmzn_graphics *gr
 										glyph_base_size, glyph_scale_factors, glyph_offset, graphics->font,
 										glyph_label_offset, graphics->label_text, /*label_bounds_dimension*/0,
 										/*label_bounds_components*/0);
+									GT_glyphset_vertex_buffers_set_render_instanced(glyphset, graphics->render_instanced);
 									return_code = cmzn_mesh_to_graphics(graphics_to_object_data->iteration_mesh, graphics_to_object_data);
 								}
 							} break;
@@ -3128,6 +3771,14 @@ int cmzn_graphics_to_graphics_object_no_check_on_filter(struct cmzn_graphics *gr
 									if (g_SURFACE_VERTEX_BUFFERS == GT_object_get_type(graphics->graphics_object))
 									{
 										Iso_surface_specification_destroy(&graphics_to_object_data->iso_surface_specification);
+										// weld once all elements are converted, not after each increment
+										if ((return_code) && (graphics->weld_vertices) &&
+											!((incrementalBuild) && incrementalBuild->isMoreWorkToDo()))
+										{
+											MutexUnlock buildUnlock(graphics_to_object_data->buildMutex);
+											return_code = weld_iso_surface_vertices(
+												GT_object_get_vertex_set(graphics->graphics_object));
+										}
 									}
 								}
 							}
@@ -3151,6 +3802,13 @@ int cmzn_graphics_to_graphics_object_no_check_on_filter(struct cmzn_graphics *gr
 							}
 							else
 								GT_object_reset_buffer_binding(graphics->graphics_object);
+							// locator continues streamlines across faces without adjacent elements
+							if ((graphics_to_object_data->master_mesh) &&
+								(1 < cmzn_mesh_get_dimension(graphics_to_object_data->master_mesh)))
+							{
+								graphics_to_object_data->streamlineElementLocator = new StreamlineElementLocator(
+									graphics_to_object_data->master_mesh, graphics_to_object_data->rc_coordinate_field);
+							}
 							if (graphics->seed_element)
 							{
 								return_code = cmzn_element_to_graphics_object(
@@ -3159,17 +3817,7 @@ int cmzn_graphics_to_graphics_object_no_check_on_filter(struct cmzn_graphics *gr
 							else if (graphics->seed_nodeset &&
 								graphics->seed_node_mesh_location_field)
 							{
-								cmzn_nodeiterator_id iterator = cmzn_nodeset_create_nodeiterator(graphics->seed_nodeset);
-								cmzn_node_id node = 0;
-								while (0 != (node = cmzn_nodeiterator_next_non_access(iterator)))
-								{
-									if (!cmzn_node_to_streamline(node, graphics_to_object_data))
-									{
-										return_code = 0;
-										break;
-									}
-								}
-								cmzn_nodeiterator_destroy(&iterator);
+								return_code = cmzn_nodeset_seeds_to_streamlines(graphics->seed_nodeset, graphics_to_object_data);
 							}
 							else
 							{
@@ -3178,12 +3826,19 @@ int cmzn_graphics_to_graphics_object_no_check_on_filter(struct cmzn_graphics *gr
 									return_code = cmzn_mesh_to_graphics(graphics_to_object_data->iteration_mesh, graphics_to_object_data);
 								}
 							}
+							delete graphics_to_object_data->streamlineElementLocator;
+							graphics_to_object_data->streamlineElementLocator = nullptr;
 						} break;
 						default:
 						{
 							return_code = 0;
 						} break;
 						} /* end of switch */
+						if (return_code && ((CMZN_GRAPHICS_TYPE_LINES == graphics->graphics_type) ||
+							(CMZN_GRAPHICS_TYPE_SURFACES == graphics->graphics_type)))
+						{
+							return_code = cmzn_graphics_build_lod(graphics, graphics_to_object_data);
+						}
 						cmzn_mesh_destroy(&graphics_to_object_data->iteration_mesh);
 						cmzn_mesh_destroy(&graphics_to_object_data->master_mesh);
 						if (return_code)
@@ -3459,6 +4114,46 @@ cmzn_field_change_flags cmzn_graphics_get_most_significant_field_change(
 	return change;
 }
 
+/**
+ * Add indexes of changed nodes to the graphics' list of points to update by a
+ * partial rebuild of node/data points graphics.
+ * Only possible if few nodes changed, the graphics object has existing points
+ * with node names to update, and no other changes e.g. to elements or the
+ * subgroup could affect which points are shown or what values they have.
+ * @return  True if added, false if all points must be rebuilt.
+ */
+bool cmzn_graphics_add_changed_node_indexes(cmzn_graphics *graphics,
+	cmzn_fieldmoduleevent *event, DsLabelsChangeLog *nodeChangeLog)
+{
+	if ((!graphics->graphics_object) || (CMZN_GRAPHICS_SELECT_MODE_OFF == graphics->select_mode) ||
+		(nodeChangeLog->isAllChange()))
+		return false;
+	if ((graphics->subgroup_field) &&
+		(CMZN_FIELD_CHANGE_FLAG_NONE != cmzn_fieldmoduleevent_get_field_change_flags(event, graphics->subgroup_field)))
+		return false;
+	FE_region_changes *feRegionChanges = event->getFeRegionChanges();
+	const cmzn_field_domain_type otherDomainType = (CMZN_FIELD_DOMAIN_TYPE_NODES == graphics->domain_type) ?
+		CMZN_FIELD_DOMAIN_TYPE_DATAPOINTS : CMZN_FIELD_DOMAIN_TYPE_NODES;
+	if (feRegionChanges->getNodeChangeLog(otherDomainType)->getChangeSummary() != DS_LABEL_CHANGE_TYPE_NONE)
+		return false;
+	for (int dimension = 1; dimension <= MAXIMUM_ELEMENT_XI_DIMENSIONS; ++dimension)
+	{
+		// ignore related changes which may have been propagated from node changes
+		if (feRegionChanges->getElementChangeLog(dimension)->getChangeSummary() & (~DS_LABEL_CHANGE_TYPE_RELATED))
+			return false;
+	}
+	FE_nodeset *feNodeset = FE_region_find_FE_nodeset_by_field_domain_type(
+		graphics->scene->region->get_FE_region(), graphics->domain_type);
+	if ((!feNodeset) || ((graphics->changedNodeIndexes.size() + nodeChangeLog->getChangeCount())*2 >
+		static_cast<size_t>(feNodeset->getSize())))
+		return false;
+	const DsLabelsGroup *changedNodes = nodeChangeLog->getLabelsGroup();
+	DsLabelIndex nodeIndex = DS_LABEL_INDEX_INVALID;
+	while (changedNodes->incrementIndex(nodeIndex))
+		graphics->changedNodeIndexes.push_back(nodeIndex);
+	return true;
+}
+
 } // namespace anonymous
 
 int cmzn_graphics_field_change(struct cmzn_graphics *graphics,
@@ -3483,20 +4178,35 @@ int cmzn_graphics_field_change(struct cmzn_graphics *graphics,
 	{
 		if (0 == domainDimension)
 		{
-			// node/data points: currently always rebuilt from scratch
-			if (fieldChange & CMZN_FIELD_CHANGE_FLAG_RESULT)
+			if (fieldChange & CMZN_FIELD_CHANGE_FLAG_FULL_RESULT)
 			{
 				graphics->setChange(CMZN_GRAPHICS_CHANGE_FULL_REBUILD);
 				return 1;
 			}
-			// rebuild all if identifiers changed, for correct picking and editing graphics object
 			DsLabelsChangeLog *nodeChangeLog = feRegionChanges->getNodeChangeLog(graphics->domain_type);
 			// Note we won't get a change log for CMZN_FIELD_DOMAIN_TYPE_POINT
-			if ((nodeChangeLog) && (nodeChangeLog->getChangeSummary() & DS_LABEL_CHANGE_TYPE_IDENTIFIER))
+			if (!nodeChangeLog)
+			{
+				if (fieldChange & CMZN_FIELD_CHANGE_FLAG_RESULT)
+					graphics->setChange(CMZN_GRAPHICS_CHANGE_FULL_REBUILD);
+				return 1;
+			}
+			// rebuild all if identifiers changed, for correct picking and editing graphics object
+			if (nodeChangeLog->getChangeSummary() & (DS_LABEL_CHANGE_TYPE_IDENTIFIER | DS_LABEL_CHANGE_TYPE_REMOVE))
 			{
 				graphics->setChange(CMZN_GRAPHICS_CHANGE_FULL_REBUILD);
 				return 1;
 			}
+			if ((fieldChange & CMZN_FIELD_CHANGE_FLAG_PARTIAL_RESULT) ||
+				(nodeChangeLog->getChangeSummary() & DS_LABEL_CHANGE_TYPE_ADD))
+			{
+				/* partial rebuild updating or appending points for few node changes */
+				if (cmzn_graphics_add_changed_node_indexes(graphics, change_data->event, nodeChangeLog))
+					graphics->setChange(CMZN_GRAPHICS_CHANGE_PARTIAL_REBUILD);
+				else
+					graphics->setChange(CMZN_GRAPHICS_CHANGE_FULL_REBUILD);
+				return 1;
+			}
 		}
 		else
 		{
@@ -3506,13 +4216,11 @@ int cmzn_graphics_field_change(struct cmzn_graphics *graphics,
 				return 1;
 			}
 			DsLabelsChangeLog *elementChangeLog = feRegionChanges->getElementChangeLog(domainDimension);
-			if (elementChangeLog->getChangeSummary() & DS_LABEL_CHANGE_TYPE_ADD)
-			{
-				// partial rebuild is buggy when new elements are added; workaround is to force full rebuild
-				graphics->setChange(CMZN_GRAPHICS_CHANGE_FULL_REBUILD);
-				return 1;
-			}
-			bool partialUpdate = (0 != (fieldChange & CMZN_FIELD_CHANGE_FLAG_PARTIAL_RESULT));
+			// elements added or removed need new primitives appended as added elements may
+			// reuse indexes of removed elements with different numbers of vertices
+			const bool elementsAddedOrRemoved = 0 != (elementChangeLog->getChangeSummary() &
+				(DS_LABEL_CHANGE_TYPE_ADD | DS_LABEL_CHANGE_TYPE_REMOVE));
+			bool partialUpdate = (0 != (fieldChange & CMZN_FIELD_CHANGE_FLAG_PARTIAL_RESULT)) || elementsAddedOrRemoved;
 			if (!partialUpdate)
 			{
 				// If element identifiers have changed, cmiss_number and derived fields are
@@ -3540,9 +4248,18 @@ int cmzn_graphics_field_change(struct cmzn_graphics *graphics,
 					graphics->setChange(CMZN_GRAPHICS_CHANGE_FULL_REBUILD);
 					return 1;
 				}
+				int primitivesCount = 0;
+				const int invalidPrimitivesCount = GT_object_get_number_of_invalid_primitives(
+					graphics->graphics_object, &primitivesCount);
+				if (invalidPrimitivesCount*2 > primitivesCount)
+				{
+					// compact primitives left behind by removed and replaced elements
+					graphics->setChange(CMZN_GRAPHICS_CHANGE_FULL_REBUILD);
+					return 1;
+				}
 				/* partial rebuild for few node/element field changes */
 				GT_object_invalidate_selected_primitives(graphics->graphics_object,
-					feRegionChanges->getElementChangeLog(domainDimension));
+					elementChangeLog, elementsAddedOrRemoved);
 				graphics->setChange(CMZN_GRAPHICS_CHANGE_PARTIAL_REBUILD);
 			}
 		}
@@ -3730,6 +4447,7 @@ int cmzn_graphics_copy_without_graphics_object(
 					source->first_isovalue, source->last_isovalue);
 			}
 			cmzn_graphics_contours_set_decimation_threshold(contours, source->decimation_threshold);
+			cmzn_graphics_contours_set_weld_vertices(contours, source->weld_vertices);
 			cmzn_graphics_contours_destroy(&contours);
 		}
 		else
@@ -3752,6 +4470,7 @@ int cmzn_graphics_copy_without_graphics_object(
 		{
 			cmzn_graphicspointattributes_set_glyph(point_attributes, reinterpret_cast<cmzn_glyph*>(source->glyph));
 			destination->glyph_repeat_mode = source->glyph_repeat_mode;
+			destination->render_instanced = source->render_instanced;
 			for (int i = 0; i < 3; i++)
 			{
 				destination->point_base_size[i] = source->point_base_size[i];
@@ -3840,6 +4559,7 @@ int cmzn_graphics_copy_without_graphics_object(
 		/* ensure destination graphics object is cleared */
 		REACCESS(GT_object)(&(destination->graphics_object),
 			(struct GT_object *)NULL);
+		destination->changedNodeIndexes.clear();
 		destination->graphics_changed = 1;
 		destination->selected_graphics_changed = 1;
 
@@ -3970,6 +4690,7 @@ int cmzn_graphics_same_non_trivial(cmzn_graphics *graphics,
 			return_code=(graphics->number_of_isovalues==
 				second_graphics->number_of_isovalues)&&
 				(graphics->decimation_threshold==second_graphics->decimation_threshold)&&
+				(graphics->weld_vertices==second_graphics->weld_vertices)&&
 				(graphics->isoscalar_field==second_graphics->isoscalar_field);
 			if (return_code)
 			{
@@ -4129,6 +4850,7 @@ int cmzn_graphics_match(struct cmzn_graphics *graphics1,
 			((CMZN_GRAPHICS_TYPE_POINTS != graphics1->graphics_type) || (
 				(graphics1->glyph == graphics2->glyph) &&
 				(graphics1->glyph_repeat_mode == graphics2->glyph_repeat_mode) &&
+				(graphics1->render_instanced == graphics2->render_instanced) &&
 				(graphics1->point_base_size[0] == graphics2->point_base_size[0]) &&
 				(graphics1->point_base_size[1] == graphics2->point_base_size[1]) &&
 				(graphics1->point_base_size[2] == graphics2->point_base_size[2]) &&
@@ -4348,6 +5070,7 @@ int cmzn_graphics_extract_graphics_object_from_list(
 				graphics->graphics_changed = matching_graphics->graphics_changed;
 				graphics->selected_graphics_changed =
 					matching_graphics->selected_graphics_changed;
+				graphics->changedNodeIndexes.swap(matching_graphics->changedNodeIndexes);
 				/* reset graphics_object and flags in matching_graphics */
 				matching_graphics->graphics_object = (struct GT_object *)NULL;
 				//matching_graphics->setChange(CMZN_GRAPHICS_CHANGE_FULL_REBUILD);
@@ -5382,6 +6105,33 @@ int cmzn_graphics_contours_set_decimation_threshold(
 	return CMZN_ERROR_ARGUMENT;
 }
 
+bool cmzn_graphics_contours_is_weld_vertices(
+	cmzn_graphics_contours_id contours)
+{
+	if (contours)
+	{
+		cmzn_graphics *graphics = reinterpret_cast<cmzn_graphics_id>(contours);
+		return graphics->weld_vertices;
+	}
+	return false;
+}
+
+int cmzn_graphics_contours_set_weld_vertices(
+	cmzn_graphics_contours_id contours, bool weld_vertices)
+{
+	if (contours)
+	{
+		cmzn_graphics *graphics = reinterpret_cast<cmzn_graphics_id>(contours);
+		if (weld_vertices != graphics->weld_vertices)
+		{
+			graphics->weld_vertices = weld_vertices;
+			graphics->setChange(CMZN_GRAPHICS_CHANGE_FULL_REBUILD);
+		}
+		return CMZN_OK;
+	}
+	return CMZN_ERROR_ARGUMENT;
+}
+
 cmzn_field_id cmzn_graphics_contours_get_isoscalar_field(
 	cmzn_graphics_contours_id contours)
 {
@@ -6139,6 +6889,34 @@ int cmzn_graphicspointattributes_set_glyph_repeat_mode(
 	return CMZN_ERROR_ARGUMENT;
 }
 
+bool cmzn_graphicspointattributes_is_render_instanced(
+	cmzn_graphicspointattributes_id point_attributes)
+{
+	cmzn_graphics *graphics = reinterpret_cast<cmzn_graphics *>(point_attributes);
+	if (graphics)
+	{
+		return graphics->render_instanced;
+	}
+	return false;
+}
+
+int cmzn_graphicspointattributes_set_render_instanced(
+	cmzn_graphicspointattributes_id point_attributes, bool render_instanced)
+{
+	cmzn_graphics *graphics = reinterpret_cast<cmzn_graphics *>(point_attributes);
+	if (graphics)
+	{
+		if (render_instanced != graphics->render_instanced)
+		{
+			graphics->render_instanced = render_instanced;
+			cmzn_graphics_update_graphics_object_trivial(graphics);
+			graphics->setChange(CMZN_GRAPHICS_CHANGE_RECOMPILE);
+		}
+		return CMZN_OK;
+	}
+	return CMZN_ERROR_ARGUMENT;
+}
+
 enum cmzn_glyph_shape_type cmzn_graphicspointattributes_get_glyph_shape_type(
 	cmzn_graphicspointattributes_id point_attributes)
 {
@@ -6537,6 +7315,24 @@ void cmzn_graphics_flag_glyph_has_changed(struct cmzn_graphics *graphics)
 	}
 }
 
+int cmzn_graphics_flag_for_compaction(
+	struct cmzn_graphics *graphics, void *dummy_void)
+{
+	USE_PARAMETER(dummy_void);
+	if (!graphics)
+	{
+		display_message(ERROR_MESSAGE,
+			"cmzn_graphics_flag_for_compaction.  Invalid argument(s)");
+		return 0;
+	}
+	if ((graphics->graphics_object) &&
+		(0 < GT_object_get_number_of_invalid_primitives(graphics->graphics_object, nullptr)))
+	{
+		graphics->setChange(CMZN_GRAPHICS_CHANGE_FULL_REBUILD);
+	}
+	return 1;
+}
+
 int cmzn_graphics_flag_for_full_rebuild(
 	struct cmzn_graphics *graphics,void *dummy_void)
 {
@@ -6666,7 +7462,14 @@ struct GT_object *cmzn_graphics_copy_graphics_object(struct cmzn_graphics *graph
 				for (int i = 0; i < MAXIMUM_ELEMENT_XI_DIMENSIONS; ++i)
 				{
 					graphics_to_object_data.top_level_number_in_xi[i] = 0;
+					graphics_to_object_data.top_level_minimum_number_in_xi[i] = 1;
 				}
+				graphics_to_object_data.buildMutex = nullptr;
+				graphics_to_object_data.threadsCount = 1;
+				graphics_to_object_data.vertexArray = nullptr;
+				graphics_to_object_data.streamlineElementLocator = nullptr;
+				graphics_to_object_data.lodGeometricError = 0.0;
+				graphics_to_object_data.lodNumberInXi = nullptr;
 				// graphics->scene must be valid to get field wrappers
 				cmzn_scene *tmpScene = copy_graphics->scene;
 				copy_graphics->scene = graphics->scene;
@@ -11,6 +11,8 @@
 #define CMZN_GRAPHICS_H
 
 #include <ctime>
+#include <mutex>
+#include <vector>
 #include "cmlibs/zinc/fieldgroup.h"
 #include "cmlibs/zinc/graphics.h"
 #include "cmlibs/zinc/types/scenefilterid.h"
@@ -29,6 +31,7 @@
 
 struct cmzn_graphicspointattributes;
 struct cmzn_graphicslineattributes;
+class StreamlineElementLocator;
 
 enum cmzn_graphics_change
 {
@@ -77,10 +80,12 @@ struct cmzn_graphics
 		first_isovalue to last_isovalue including these values for n>1 */
 	double *isovalues, first_isovalue, last_isovalue,
 		decimation_threshold;
+	bool weld_vertices;
 
 	/* point attributes */
 	cmzn_glyph *glyph;
 	enum cmzn_glyph_repeat_mode glyph_repeat_mode;
+	bool render_instanced;
 	FE_value point_offset[3];
 	FE_value point_base_size[3];
 	FE_value point_scale_factors[3];
@@ -138,6 +143,9 @@ struct cmzn_graphics
 	int graphics_changed;
 	/* for incremental build: last completed element index to start after (or before first if INVALID) */
 	DsLabelIndex incrementalBuildIndex;
+	/* for partial rebuild of node/data points: indexes of changed nodes to update
+	 * in the existing graphics object; if empty all points are rebuilt */
+	std::vector<DsLabelIndex> changedNodeIndexes;
 	/* flag indicating that selected graphics have changed */
 	int selected_graphics_changed;
 	/* flag indicating that this settings needs to be regenerated when time changes */
@@ -370,6 +378,25 @@ struct cmzn_graphics_to_graphics_object_data
 	/* additional values for passing to element_to_graphics_object */
 	struct cmzn_graphics *graphics;
 	int top_level_number_in_xi[MAXIMUM_ELEMENT_XI_DIMENSIONS];
+	/* if set, graphics are being built on multiple threads and this mutex must
+	 * be locked while using objects shared between graphics */
+	std::mutex *buildMutex;
+	/* maximum number of threads for converting elements of one graphics */
+	int threadsCount;
+	/* if set, lines, surfaces, contours and streamlines primitives are added
+	 * to this array instead of the vertex set of the graphics object */
+	struct Graphics_vertex_array *vertexArray;
+	/* if set, finds elements streamlines continue into across faces without
+	 * adjacent elements */
+	StreamlineElementLocator *streamlineElementLocator;
+	/* if positive, lines and surfaces elements are divided adaptively for a
+	 * level of detail with this maximum chordal error */
+	FE_value lodGeometricError;
+	/* if set, divisions of each 2-D element index for the level of detail, 2
+	 * per element, so surfaces have no cracks; 0 for elements not set */
+	const int *lodNumberInXi;
+	/* minimum divisions of top level elements for adaptive levels of detail */
+	int top_level_minimum_number_in_xi[MAXIMUM_ELEMENT_XI_DIMENSIONS];
 };
 
 struct cmzn_graphics_field_change_data
@@ -471,6 +498,17 @@ int cmzn_graphics_selects_cad_primitives(struct cmzn_graphics *graphics);
 int cmzn_graphics_to_graphics_object(
 	struct cmzn_graphics *graphics,void *graphics_to_object_data_void);
 
+/**
+ * Builds the graphics object for graphics if it has changed, without checking
+ * the scene filter. If graphics_to_object_data has a buildMutex, it is locked
+ * except while converting elements of lines, surfaces and contours, so
+ * graphics of the same scene can be built on different threads, each with its
+ * own graphics_to_object_data and field cache.
+ * @return  1 on success, 0 on failure.
+ */
+int cmzn_graphics_to_graphics_object_no_check_on_filter(struct cmzn_graphics *graphics,
+	cmzn_graphics_to_graphics_object_data *graphics_to_object_data);
+
 /***************************************************************************//**
  * If the settings visibility flag is set and it has a graphics_object, the
  * graphics_object is compiled.
@@ -731,6 +769,16 @@ int cmzn_graphics_remove_renderer_highlight_functor(struct cmzn_graphics *graphi
 int cmzn_graphics_flag_for_full_rebuild(
 	struct cmzn_graphics *graphics,void *dummy_void);
 
+/**
+ * List iterator flagging graphics for full rebuild if their graphics object
+ * holds primitives released by partial rebuilds, so they are compacted.
+ * Needed before export, as exporters write all primitives in vertex buffers.
+ * @param dummy_void  Unused.
+ * @return  1 on success, 0 if invalid graphics.
+ */
+int cmzn_graphics_flag_for_compaction(
+	struct cmzn_graphics *graphics, void *dummy_void);
+
 enum GT_object_type cmzn_graphics_get_graphics_object_type(struct cmzn_graphics *graphics);
 
 struct GT_object *cmzn_graphics_copy_graphics_object(struct cmzn_graphics *graphics);
@@ -1082,6 +1082,42 @@ appropriately.
 			}
 		}
 #endif /* GL_VERSION_3_0 */
+#if defined GL_VERSION_3_3
+		else if (!strcmp(extension_name, "GL_VERSION_3_3"))
+		{
+			if (GLEXTENSION_UNSURE != GLEXTENSIONFLAG(GL_VERSION_3_3))
+			{
+				return_code = GLEXTENSIONFLAG(GL_VERSION_3_3);
+			}
+			else
+			{
+				return_code = query_gl_version(3, 3);
+				if (GLEXTENSION_AVAILABLE == return_code)
+				{
+					if (!((GRAPHICS_LIBRARY_ASSIGN_HANDLE(glBindAttribLocation, PFNGLBINDATTRIBLOCATIONPROC)
+							Graphics_library_get_function_ptr("glBindAttribLocation")) &&
+						(GRAPHICS_LIBRARY_ASSIGN_HANDLE(glVertexAttribPointer, PFNGLVERTEXATTRIBPOINTERPROC)
+							Graphics_library_get_function_ptr("glVertexAttribPointer")) &&
+						(GRAPHICS_LIBRARY_ASSIGN_HANDLE(glEnableVertexAttribArray, PFNGLENABLEVERTEXATTRIBARRAYPROC)
+							Graphics_library_get_function_ptr("glEnableVertexAttribArray")) &&
+						(GRAPHICS_LIBRARY_ASSIGN_HANDLE(glDisableVertexAttribArray, PFNGLDISABLEVERTEXATTRIBARRAYPROC)
+							Graphics_library_get_function_ptr("glDisableVertexAttribArray")) &&
+						(GRAPHICS_LIBRARY_ASSIGN_HANDLE(glVertexAttribDivisor, PFNGLVERTEXATTRIBDIVISORPROC)
+							Graphics_library_get_function_ptr("glVertexAttribDivisor")) &&
+						(GRAPHICS_LIBRARY_ASSIGN_HANDLE(glDrawArraysInstanced, PFNGLDRAWARRAYSINSTANCEDPROC)
+							Graphics_library_get_function_ptr("glDrawArraysInstanced")) &&
+						(GRAPHICS_LIBRARY_ASSIGN_HANDLE(glDrawElementsInstanced, PFNGLDRAWELEMENTSINSTANCEDPROC)
+							Graphics_library_get_function_ptr("glDrawElementsInstanced")) &&
+						(GRAPHICS_LIBRARY_ASSIGN_HANDLE(glUniform1fv, PFNGLUNIFORM1FVPROC)
+							Graphics_library_get_function_ptr("glUniform1fv"))))
+					{
+						return_code = GLEXTENSION_UNAVAILABLE;
+					}
+				}
+				GLEXTENSIONFLAG(GL_VERSION_3_3) = return_code;
+			}
+		}
+#endif /* GL_VERSION_3_3 */
 #if defined GL_ARB_depth_texture
 		else if (!strcmp(extension_name, "GL_ARB_depth_texture"))
 		{
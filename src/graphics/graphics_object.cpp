@@ -43,6 +43,8 @@ gtObject/gtWindow management routines.
 #include "graphics/render_gl.h"
 #include "graphics/graphics_object.hpp"
 #include "graphics/graphics_object_highlight.hpp"
+#include "graphics/graphics_object_lod.hpp"
+#include "graphics/graphics_object_pick_tree.hpp"
 #include "graphics/graphics_object_private.hpp"
 
 /*
@@ -323,8 +325,16 @@ conditional_function. \
 	return (return_code); \
 } /* GT_OBJECT_REMOVE_PRIMITIVES_AT_TIME_NUMBER(primitive_type) */
 
+/**
+ * Mark primitives for object names changed in changeLog as requiring update.
+ * @param releaseChanged  If true, also stop finding the changed primitives by
+ * object name so rebuilt primitives are appended to the vertex array instead of
+ * overwriting the existing ones, which are left invalidated and not drawn. This
+ * is needed when changed objects may have been removed or replaced by different
+ * objects with the same index and thus a different number of vertices.
+ */
 static int GT_object_mark_vertex_array_primitives_changes(struct GT_object *object,
-	DsLabelsChangeLog *changeLog)
+	DsLabelsChangeLog *changeLog, bool releaseChanged)
 {
 	switch (object->object_type)
 	{
@@ -357,6 +367,8 @@ static int GT_object_mark_vertex_array_primitives_changes(struct GT_object *obje
 							object->vertex_array->replace_integer_vertex_buffer_at_position(
 								GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_OBJECT_ID, i, 1, 1,
 								&invalid_id);
+							if (releaseChanged)
+								object->vertex_array->release_fast_search_id(object_name);
 						}
 					}
 				}
@@ -879,6 +891,17 @@ int GT_glyphset_vertex_buffers_setup(GT_glyphset_vertex_buffers *glyphset,
 	return 0;
 }
 
+int GT_glyphset_vertex_buffers_set_render_instanced(GT_glyphset_vertex_buffers *glyphset,
+	bool render_instanced)
+{
+	if (glyphset)
+	{
+		glyphset->render_instanced = render_instanced;
+		return 1;
+	}
+	return 0;
+}
+
 /***************************************************************************//**
  * Creates the shared scene information for a GT_polyline_vertex_buffers.
  */
@@ -989,6 +1012,7 @@ GT_glyphset_vertex_buffers *CREATE(GT_glyphset_vertex_buffers)()
 		}
 		glyphset->label_bounds_dimension = 0;
 		glyphset->label_bounds_components = 0;
+		glyphset->render_instanced = false;
 	}
 	else
 	{
@@ -1122,6 +1146,15 @@ struct GT_object *CREATE(GT_object)(const char *name,enum GT_object_type object_
 				object->texture_coordinate0_vertex_buffer_object = 0;
 				object->tangent_vertex_buffer_object = 0;
 				object->index_vertex_buffer_object = 0;
+				object->position_vertex_buffer_size = 0;
+				object->colour_vertex_buffer_size = 0;
+				object->normal_vertex_buffer_size = 0;
+				object->texture_coordinate0_vertex_buffer_size = 0;
+				object->tangent_vertex_buffer_size = 0;
+				object->index_vertex_buffer_size = 0;
+				object->index_vertex_count = 0;
+				object->instance_vertex_buffer_object = 0;
+				object->instance_count = 0;
 				object->vertex_array_object = 0;
 				object->multipass_width = 0;
 				object->multipass_height = 0;
@@ -1130,6 +1163,8 @@ struct GT_object *CREATE(GT_object)(const char *name,enum GT_object_type object_
 				object->multipass_frame_buffer_texture = 0;
 #endif /* defined (OPENGL_API) */
 				object->compile_status = GRAPHICS_NOT_COMPILED;
+				object->pick_tree = 0;
+				object->lod = 0;
 				object->object_type=object_type;
 				if (default_material)
 				{
@@ -1261,6 +1296,10 @@ static int DESTROY(GT_object)(struct GT_object **object_ptr)
 			{
 				glDeleteBuffers(1, &object->index_vertex_buffer_object);
 			}
+			if (object->instance_vertex_buffer_object)
+			{
+				glDeleteBuffers(1, &object->instance_vertex_buffer_object);
+			}
 			if (object->multipass_vertex_buffer_object)
 			{
 				glDeleteBuffers(1, &object->multipass_vertex_buffer_object);
@@ -1284,6 +1323,8 @@ static int DESTROY(GT_object)(struct GT_object **object_ptr)
 			}
 #endif /* defined (GL_VERSION_3_0) */
 #endif /* defined (OPENGL_API) */
+			delete object->pick_tree;
+			delete object->lod;
 			/* DEACCESS ptrnext so that objects attached in linked-list may be
 				 destroyed. Note that this means they should have been accessed! */
 			if (object->nextobject)
@@ -1308,11 +1349,36 @@ DECLARE_OBJECT_FUNCTIONS(GT_object)
 
 DECLARE_DEFAULT_GET_OBJECT_NAME_FUNCTION(GT_object)
 
+/**
+ * Force colours calculated from data with the spectrum and material to be
+ * fully uploaded at the next compile, since only the vertices changed by a
+ * partial rebuild are otherwise uploaded.
+ */
+static void GT_object_invalidate_colour_vertex_buffer(struct GT_object *graphics_object)
+{
+#if defined (OPENGL_API)
+	graphics_object->colour_vertex_buffer_size = 0;
+#else
+	USE_PARAMETER(graphics_object);
+#endif /* defined (OPENGL_API) */
+}
+
 void GT_object_changed(struct GT_object *graphics_object)
 {
 	while (graphics_object)
 	{
 		graphics_object->compile_status = GRAPHICS_NOT_COMPILED;
+		if (graphics_object->pick_tree)
+		{
+			delete graphics_object->pick_tree;
+			graphics_object->pick_tree = 0;
+		}
+		if (graphics_object->lod)
+		{
+			const int levelsCount = graphics_object->lod->getNumberOfLevels();
+			for (int l = 0; l < levelsCount; ++l)
+				GT_object_changed(graphics_object->lod->getLevelObject(l));
+		}
 		graphics_object = graphics_object->nextobject;
 	}
 }
@@ -1353,6 +1419,7 @@ change to any material in use in the linked graphics objects.
 				{
 					/* need to rebuild display list when spectrum in use */
 					graphics_object->compile_status = GRAPHICS_NOT_COMPILED;
+					GT_object_invalidate_colour_vertex_buffer(graphics_object);
 				}
 				else if (((graphics_object->object_type == g_POLYLINE_VERTEX_BUFFERS) ||
 					(graphics_object->object_type == g_SURFACE_VERTEX_BUFFERS) ||
@@ -1371,6 +1438,13 @@ change to any material in use in the linked graphics objects.
 					}
 				}
 			}
+			if (graphics_object->lod)
+			{
+				const int levelsCount = graphics_object->lod->getNumberOfLevels();
+				for (int l = 0; l < levelsCount; ++l)
+					GT_object_Graphical_material_change(graphics_object->lod->getLevelObject(l),
+						changed_material_list);
+			}
 			graphics_object = graphics_object->nextobject;
 		}
 		return_code = 1;
@@ -1413,6 +1487,14 @@ change to any spectrum in use in the linked graphics objects.
 			{
 				/* need to rebuild display list when spectrum in use */
 				graphics_object->compile_status = GRAPHICS_NOT_COMPILED;
+				GT_object_invalidate_colour_vertex_buffer(graphics_object);
+			}
+			if (graphics_object->lod)
+			{
+				const int levelsCount = graphics_object->lod->getNumberOfLevels();
+				for (int l = 0; l < levelsCount; ++l)
+					GT_object_Spectrum_change(graphics_object->lod->getLevelObject(l),
+						changed_spectrum_list);
 			}
 			graphics_object = graphics_object->nextobject;
 		}
@@ -2142,7 +2224,7 @@ struct GT_glyphset_vertex_buffers *GT_object_get_GT_glyphset_vertex_buffers(
 }
 
 int GT_object_invalidate_selected_primitives(struct GT_object *graphics_object,
-	DsLabelsChangeLog *changeLog)
+	DsLabelsChangeLog *changeLog, bool releaseChanged)
 {
 	if (!(graphics_object && changeLog))
 		return 0;
@@ -2155,8 +2237,17 @@ int GT_object_invalidate_selected_primitives(struct GT_object *graphics_object,
 		case g_SURFACE_VERTEX_BUFFERS:
 		case g_GLYPH_SET_VERTEX_BUFFERS:
 			GT_object_destroy_primitives(graphics_object);
-			GT_object_mark_vertex_array_primitives_changes(graphics_object, changeLog);
+			GT_object_mark_vertex_array_primitives_changes(graphics_object, changeLog, releaseChanged);
 			GT_object_changed(graphics_object);
+			if (graphics_object->lod)
+			{
+				// always release changed primitives of levels of detail as adaptive
+				// divisions and hence vertex counts can change with the element
+				const int levelsCount = graphics_object->lod->getNumberOfLevels();
+				for (int l = 0; l < levelsCount; ++l)
+					GT_object_invalidate_selected_primitives(graphics_object->lod->getLevelObject(l),
+						changeLog, /*releaseChanged*/true);
+			}
 			return 1;
 			break;
 		default:
@@ -2166,6 +2257,30 @@ int GT_object_invalidate_selected_primitives(struct GT_object *graphics_object,
 	return 0;
 }
 
+int GT_object_get_number_of_invalid_primitives(struct GT_object *graphics_object,
+	int *primitivesCountOut)
+{
+	int invalidCount = 0;
+	if (primitivesCountOut)
+		*primitivesCountOut = 0;
+	if ((graphics_object) && (graphics_object->vertex_array))
+	{
+		int *objectIds = 0;
+		unsigned int valuesPerVertex = 0, objectsCount = 0;
+		if (graphics_object->vertex_array->get_integer_vertex_buffer(
+			GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_OBJECT_ID, &objectIds, &valuesPerVertex,
+			&objectsCount) && objectIds)
+		{
+			for (unsigned int i = 0; i < objectsCount; ++i)
+				if (objectIds[i] < 0)
+					++invalidCount;
+			if (primitivesCountOut)
+				*primitivesCountOut = static_cast<int>(objectsCount);
+		}
+	}
+	return invalidCount;
+}
+
 int GT_object_clear_primitives(struct GT_object *graphics_object)
 {
 	if (graphics_object)
@@ -2539,6 +2654,7 @@ Sets the default_material of a GT_object.
 		{
 			REACCESS(cmzn_material)(&(graphics_object->default_material),
 				material);
+			GT_object_invalidate_colour_vertex_buffer(graphics_object);
 			GT_object_changed(graphics_object);
 		}
 	  return_code=1;
@@ -2706,6 +2822,7 @@ int set_GT_object_Spectrum(struct GT_object *graphics_object,
 		if (spectrum != graphics_object->spectrum)
 		{
 			REACCESS(cmzn_spectrum)(&graphics_object->spectrum, spectrum);
+			GT_object_invalidate_colour_vertex_buffer(graphics_object);
 			GT_object_changed(graphics_object);
 		}
 		return_code=1;
@@ -2842,6 +2959,27 @@ int set_GT_object_glyph_repeat_mode(struct GT_object *graphics_object,
 	return (return_code);
 }
 
+int set_GT_object_glyph_render_instanced(struct GT_object *graphics_object,
+	bool render_instanced)
+{
+	int return_code = 0;
+	if (graphics_object)
+	{
+		if ((g_GLYPH_SET_VERTEX_BUFFERS == graphics_object->object_type) && graphics_object->primitive_lists)
+		{
+			// assume only one time
+			GT_glyphset_vertex_buffers *glyph_set = graphics_object->primitive_lists->gt_glyphset_vertex_buffers;
+			if (glyph_set && (glyph_set->render_instanced != render_instanced))
+			{
+				glyph_set->render_instanced = render_instanced;
+				GT_object_changed(graphics_object);
+			}
+		}
+		return_code = 1;
+	}
+	return (return_code);
+}
+
 int set_GT_object_glyph_base_size(struct GT_object *graphics_object,
 	Triple base_size)
 {
@@ -356,6 +356,13 @@ int GT_glyphset_vertex_buffers_setup(GT_glyphset_vertex_buffers *glyphset,
 	Triple label_offset, char *static_label_text[3],
 	int label_bounds_dimension, int label_bounds_components);
 
+/**
+ * Set whether glyphs in the glyph set are drawn instanced when possible.
+ * @return  1 on success, 0 if no glyphset.
+ */
+int GT_glyphset_vertex_buffers_set_render_instanced(GT_glyphset_vertex_buffers *glyphset,
+	bool render_instanced);
+
 /***************************************************************************//**
  * Creates the shared scene information for a GT_polyline_vertex_buffers.
  */
@@ -563,9 +570,23 @@ typedef int (GT_object_primitive_object_name_conditional_function) \
  * Mark primitives in the graphics object whose object name integer index
  * is marked as changed in the changeLog.
  * This means those objects' primitives must be rebuilt, but others are kept.
+ * @param releaseChanged  Set to true if objects may have been added or
+ * removed: rebuilt primitives are then appended rather than replacing the
+ * old primitives in place, which stay invalid and are not drawn.
  */
 int GT_object_invalidate_selected_primitives(struct GT_object *graphics_object,
-	DsLabelsChangeLog *changeLog);
+	DsLabelsChangeLog *changeLog, bool releaseChanged);
+
+/**
+ * Get the number of primitives in the vertex array of the graphics object
+ * which are invalid i.e. have a negative object name, as left by
+ * GT_object_invalidate_selected_primitives until rebuilt, or indefinitely
+ * when released.
+ * @param primitivesCountOut  Optional, on return the total number of
+ * primitives with object names.
+ */
+int GT_object_get_number_of_invalid_primitives(struct GT_object *graphics_object,
+	int *primitivesCountOut);
 
 /**
  * Clears all primitives and vertext arrays from graphics object.
@@ -760,6 +781,12 @@ int set_GT_object_glyph(struct GT_object *graphics_object,
 int set_GT_object_glyph_repeat_mode(struct GT_object *graphics_object,
 	enum cmzn_glyph_repeat_mode glyph_repeat_mode);
 
+/**
+ * Sets whether all glyph_sets in the GT_object are drawn instanced.
+ */
+int set_GT_object_glyph_render_instanced(struct GT_object *graphics_object,
+	bool render_instanced);
+
 /**
  * Sets the glyph base size for all glyph_sets in the GT_object.
  */
@@ -0,0 +1,153 @@
+/**
+ * @file graphics_object_lod.cpp
+ *
+ * Cached coarser levels of detail for a graphics object, selected by the
+ * renderer from their projected geometric error.
+ */
+/* Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <cmath>
+#include "graphics/graphics_object.h"
+#include "graphics/graphics_object_lod.hpp"
+#include "graphics/graphics_object_private.hpp"
+
+GraphicsObjectLod::GraphicsObjectLod(double pixelErrorToleranceIn) :
+	pixelErrorTolerance(pixelErrorToleranceIn),
+	rangeValid(false)
+{
+	for (int c = 0; c < 3; ++c)
+		this->minimums[c] = this->maximums[c] = 0.0;
+}
+
+GraphicsObjectLod::~GraphicsObjectLod()
+{
+	for (size_t l = 0; l < this->levels.size(); ++l)
+		DEACCESS(GT_object)(&(this->levels[l].object));
+}
+
+GT_object *GraphicsObjectLod::addLevel(GT_object *baseObject, double geometricError)
+{
+	if (!baseObject)
+		return 0;
+	GT_object *object = CREATE(GT_object)(baseObject->name, baseObject->object_type,
+		baseObject->default_material);
+	if (!object)
+		return 0;
+	Level level = { object, geometricError, std::vector<int>() };  // created with access count 1
+	this->levels.push_back(level);
+	return object;
+}
+
+void GraphicsObjectLod::updateRange(GT_object *baseObject)
+{
+	Graphics_object_range_struct range;
+	this->rangeValid = (0 != get_graphics_object_range(baseObject, (void *)&range)) && (!range.first);
+	for (int c = 0; c < 3; ++c)
+	{
+		this->minimums[c] = (this->rangeValid) ? range.minimum[c] : 0.0;
+		this->maximums[c] = (this->rangeValid) ? range.maximum[c] : 0.0;
+	}
+}
+
+void GraphicsObjectLod::updateLevelAttributes(GT_object *baseObject)
+{
+	for (size_t l = 0; l < this->levels.size(); ++l)
+	{
+		GT_object *object = this->levels[l].object;
+		set_GT_object_default_material(object, baseObject->default_material);
+		set_GT_object_secondary_material(object, baseObject->secondary_material);
+		set_GT_object_selected_material(object, baseObject->selected_material);
+		set_GT_object_Spectrum(object, baseObject->spectrum);
+		if (object->select_mode != baseObject->select_mode)
+			GT_object_set_select_mode(object, baseObject->select_mode);
+		if (object->render_line_width != baseObject->render_line_width)
+			set_GT_object_render_line_width(object, baseObject->render_line_width);
+		if (object->render_point_size != baseObject->render_point_size)
+			set_GT_object_render_point_size(object, baseObject->render_point_size);
+	}
+}
+
+GT_object *GraphicsObjectLod::selectLevel(GT_object *baseObject, const double *modelviewMatrix,
+	const double *projectionMatrix, double viewportWidth, double viewportHeight) const
+{
+	if ((this->levels.empty()) || (!this->rangeValid) || (!(0.0 < this->pixelErrorTolerance)))
+		return baseObject;
+	// largest scaling of model lengths into eye coordinates
+	double modelScale = 0.0;
+	for (int j = 0; j < 3; ++j)
+	{
+		const double *column = modelviewMatrix + 4*j;
+		const double scale = sqrt(column[0]*column[0] + column[1]*column[1] + column[2]*column[2]);
+		if (scale > modelScale)
+			modelScale = scale;
+	}
+	// pixels per unit eye length at unit depth for perspective, any depth for orthographic
+	double pixelsPerUnit = fabs(projectionMatrix[0])*0.5*viewportWidth;
+	const double pixelsPerUnitY = fabs(projectionMatrix[5])*0.5*viewportHeight;
+	if (pixelsPerUnitY > pixelsPerUnit)
+		pixelsPerUnit = pixelsPerUnitY;
+	pixelsPerUnit *= modelScale;
+	const bool perspective = (0.0 == projectionMatrix[15]);
+	if (perspective)
+	{
+		// depth of nearest corner of range in front of the eye
+		double nearestDepth = 0.0;
+		for (int corner = 0; corner < 8; ++corner)
+		{
+			const double x = (corner & 1) ? this->maximums[0] : this->minimums[0];
+			const double y = (corner & 2) ? this->maximums[1] : this->minimums[1];
+			const double z = (corner & 4) ? this->maximums[2] : this->minimums[2];
+			const double depth = -(modelviewMatrix[2]*x + modelviewMatrix[6]*y +
+				modelviewMatrix[10]*z + modelviewMatrix[14]);
+			if ((0 == corner) || (depth < nearestDepth))
+				nearestDepth = depth;
+		}
+		if (nearestDepth <= 0.0)
+			return baseObject;  // range extends to or behind the eye
+		pixelsPerUnit /= nearestDepth;
+	}
+	if (!(0.0 < pixelsPerUnit))
+		return baseObject;
+	const double allowedError = this->pixelErrorTolerance/pixelsPerUnit;
+	GT_object *object = baseObject;
+	for (size_t l = 0; l < this->levels.size(); ++l)
+	{
+		if (this->levels[l].geometricError > allowedError)
+			break;
+		object = this->levels[l].object;
+	}
+	return object;
+}
+
+int GT_object_set_lod(GT_object *graphics_object, GraphicsObjectLod *lod)
+{
+	if (!graphics_object)
+		return 0;
+	if (lod != graphics_object->lod)
+	{
+		delete graphics_object->lod;
+		graphics_object->lod = lod;
+	}
+	return 1;
+}
+
+GraphicsObjectLod *GT_object_get_lod(GT_object *graphics_object)
+{
+	if (graphics_object)
+		return graphics_object->lod;
+	return 0;
+}
+
+GT_object *GT_object_get_view_level(GT_object *graphics_object,
+	const GraphicsObjectLodView *view)
+{
+	GraphicsObjectLod *lod = GT_object_get_lod(graphics_object);
+	if ((!lod) || (!view))
+		return graphics_object;
+	return lod->selectLevel(graphics_object, view->modelviewMatrix, view->projectionMatrix,
+		view->viewportWidth, view->viewportHeight);
+}
@@ -0,0 +1,147 @@
+/**
+ * @file graphics_object_lod.hpp
+ *
+ * Cached coarser levels of detail for a graphics object, selected by the
+ * renderer from their projected geometric error.
+ */
+/* Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (GRAPHICS_OBJECT_LOD_HPP)
+#define GRAPHICS_OBJECT_LOD_HPP
+
+#include <vector>
+
+struct GT_object;
+
+/**
+ * View for choosing levels of detail outside OpenGL rendering, e.g. to export
+ * graphics as drawn in a scene viewer.
+ */
+struct GraphicsObjectLodView
+{
+	double modelviewMatrix[16], projectionMatrix[16];  // column-major OpenGL matrices
+	double viewportWidth, viewportHeight;  // in pixels
+};
+
+/**
+ * Coarser levels of detail for lines or surfaces graphics built with an
+ * adaptive tessellation. The owning GT_object is the finest level; each
+ * level here is a separate graphics object built from the same elements with
+ * divisions chosen so its maximum chordal error in model coordinates is the
+ * level's geometric error. When drawing, the coarsest level whose error
+ * projects to no more than the pixel error tolerance on screen is chosen, so
+ * switching levels needs no rebuild.
+ */
+class GraphicsObjectLod
+{
+	struct Level
+	{
+		GT_object *object;  // accessed
+		double geometricError;
+		// divisions of surface elements by 2-D element index, 2 per element, so
+		// shared edges match; empty if chosen per element
+		std::vector<int> numberInXi;
+	};
+
+	double pixelErrorTolerance;
+	// in order of increasing geometric error
+	std::vector<Level> levels;
+	// range of base graphics object coordinates, valid if rangeValid
+	bool rangeValid;
+	double minimums[3], maximums[3];
+
+public:
+
+	GraphicsObjectLod(double pixelErrorToleranceIn);
+
+	~GraphicsObjectLod();
+
+	double getPixelErrorTolerance() const
+	{
+		return this->pixelErrorTolerance;
+	}
+
+	int getNumberOfLevels() const
+	{
+		return static_cast<int>(this->levels.size());
+	}
+
+	/** @return  Non-accessed graphics object for level from 0 to number - 1 */
+	GT_object *getLevelObject(int level) const
+	{
+		return this->levels[level].object;
+	}
+
+	double getLevelGeometricError(int level) const
+	{
+		return this->levels[level].geometricError;
+	}
+
+	/** @return  Divisions of each 2-D element index for level, 2 per element,
+	 * or empty if divisions are chosen per element. */
+	const std::vector<int>& getLevelNumberInXi(int level) const
+	{
+		return this->levels[level].numberInXi;
+	}
+
+	/** Set divisions of 2-D elements for level, swapping with numberInXi. */
+	void swapLevelNumberInXi(int level, std::vector<int>& numberInXi)
+	{
+		this->levels[level].numberInXi.swap(numberInXi);
+	}
+
+	/**
+	 * Add a level with a new empty graphics object of the same type, name and
+	 * material as baseObject. Levels must be added in increasing error.
+	 * @return  Non-accessed graphics object for level, or 0 on failure.
+	 */
+	GT_object *addLevel(GT_object *baseObject, double geometricError);
+
+	/** Update range of coordinates from base object after it is built. */
+	void updateRange(GT_object *baseObject);
+
+	/**
+	 * Copy materials, spectrum, select mode and render sizes from the base
+	 * object to all levels. Levels are only marked as changed if different.
+	 */
+	void updateLevelAttributes(GT_object *baseObject);
+
+	/**
+	 * Choose the graphics object to draw for a view. The scale of the model is
+	 * taken from the nearest point of the base object's range, so all of it is
+	 * drawn within the pixel error tolerance.
+	 * @param modelviewMatrix, projectionMatrix  Column-major OpenGL matrices.
+	 * @param viewportWidth, viewportHeight  Size of viewport in pixels.
+	 * @return  Non-accessed base object or coarser level object.
+	 */
+	GT_object *selectLevel(GT_object *baseObject, const double *modelviewMatrix,
+		const double *projectionMatrix, double viewportWidth, double viewportHeight) const;
+};
+
+/**
+ * Set levels of detail for graphics object, taking ownership of lod and
+ * deleting any current levels of detail.
+ * @param lod  The new levels of detail, or 0 to clear.
+ * @return  1 on success, 0 if invalid graphics object.
+ */
+int GT_object_set_lod(GT_object *graphics_object, GraphicsObjectLod *lod);
+
+/**
+ * @return  Non-accessed levels of detail for graphics object, or 0 if none.
+ */
+GraphicsObjectLod *GT_object_get_lod(GT_object *graphics_object);
+
+/**
+ * Get the graphics object drawn for a view: the supplied object or the level
+ * of detail of it chosen for the view.
+ * @param view  The view, or 0 to always get the supplied, finest object.
+ * @return  Non-accessed graphics object.
+ */
+GT_object *GT_object_get_view_level(GT_object *graphics_object,
+	const GraphicsObjectLodView *view);
+
+#endif /* !defined (GRAPHICS_OBJECT_LOD_HPP) */
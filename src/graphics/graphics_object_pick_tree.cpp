@@ -0,0 +1,564 @@
+/**
+ * @file graphics_object_pick_tree.cpp
+ *
+ * Bounding volume hierarchy over the pickable primitives of a graphics object
+ * for picking without OpenGL selection.
+ */
+/* Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include "graphics/glyph.hpp"
+#include "graphics/graphics_object.h"
+#include "graphics/graphics_object_pick_tree.hpp"
+#include "graphics/graphics_object_private.hpp"
+#include "graphics/graphics_vertex_array.hpp"
+
+namespace {
+
+/** Maximum number of primitives in a leaf node */
+const unsigned int PICK_TREE_LEAF_SIZE = 4;
+
+/** Maximum number of vertices of clipped polygon: 4 + one per clip plane */
+const int PICK_TREE_MAXIMUM_CLIPPED_VERTICES = 10;
+
+/**
+ * Clip convex polygon in homogeneous coordinates against a single clip plane
+ * w + sign*v[axis] >= 0. Also handles 1 vertex points and 2 vertex lines,
+ * which are treated as closed polygons.
+ * @return  Number of vertices in clippedVertices.
+ */
+int clipPolygonToPlane(int verticesCount, const double (*vertices)[4],
+	int axis, double sign, double (*clippedVertices)[4])
+{
+	int clippedCount = 0;
+	const double *previous = vertices[verticesCount - 1];
+	double previousDistance = previous[3] + sign*previous[axis];
+	for (int v = 0; v < verticesCount; ++v)
+	{
+		const double *current = vertices[v];
+		const double currentDistance = current[3] + sign*current[axis];
+		if ((currentDistance >= 0.0) != (previousDistance >= 0.0))
+		{
+			const double t = previousDistance/(previousDistance - currentDistance);
+			for (int c = 0; c < 4; ++c)
+				clippedVertices[clippedCount][c] = previous[c] + t*(current[c] - previous[c]);
+			++clippedCount;
+		}
+		if (currentDistance >= 0.0)
+		{
+			for (int c = 0; c < 4; ++c)
+				clippedVertices[clippedCount][c] = current[c];
+			++clippedCount;
+		}
+		previous = current;
+		previousDistance = currentDistance;
+	}
+	return clippedCount;
+}
+
+}
+
+GraphicsObjectPickTree::GraphicsObjectPickTree(GT_object *graphicsObject) :
+	namesCount(0)
+{
+	Graphics_vertex_array *vertexArray = graphicsObject->vertex_array;
+	if (!((vertexArray) && (graphicsObject->primitive_lists)))
+		return;
+	// OpenGL renderer only loads names for objects which can be selected
+	const bool selectable = (CMZN_GRAPHICS_SELECT_MODE_OFF != graphicsObject->select_mode);
+	const unsigned int subobjectsCount = vertexArray->get_number_of_vertices(
+		GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_START);
+	GLfloat *positionBuffer = 0;
+	unsigned int positionValuesPerVertex = 0, positionVertexCount = 0;
+	vertexArray->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_POSITION,
+		&positionBuffer, &positionValuesPerVertex, &positionVertexCount);
+	switch (graphicsObject->object_type)
+	{
+	case g_GLYPH_SET_VERTEX_BUFFERS:
+	{
+		this->addGlyphset(graphicsObject);
+	} break;
+	case g_POINT_SET_VERTEX_BUFFERS:
+	{
+		// points are drawn without names
+		for (unsigned int i = 0; (i < positionVertexCount) && positionBuffer; ++i)
+			this->addPrimitive(1, positionBuffer + i*positionValuesPerVertex, 0, 0);
+	} break;
+	case g_POLYLINE_VERTEX_BUFFERS:
+	case g_SURFACE_VERTEX_BUFFERS:
+	{
+		if (!positionBuffer)
+			break;
+		if (selectable)
+			this->namesCount = 1;
+		bool discontinuous = false;
+		if (g_POLYLINE_VERTEX_BUFFERS == graphicsObject->object_type)
+		{
+			const GT_polyline_type polylineType = graphicsObject->primitive_lists->gt_polyline_vertex_buffers->polyline_type;
+			discontinuous = (g_PLAIN_DISCONTINUOUS == polylineType) || (g_NORMAL_DISCONTINUOUS == polylineType);
+		}
+		else
+		{
+			switch (graphicsObject->primitive_lists->gt_surface_vertex_buffers->surface_type)
+			{
+			case g_SH_DISCONTINUOUS:
+			case g_SH_DISCONTINUOUS_STRIP:
+			case g_SH_DISCONTINUOUS_TEXMAP:
+			case g_SH_DISCONTINUOUS_STRIP_TEXMAP:
+				discontinuous = true;
+				break;
+			default:
+				break;
+			}
+		}
+		for (unsigned int s = 0; s < subobjectsCount; ++s)
+		{
+			int objectName = 0;
+			if (!vertexArray->get_integer_attribute(
+				GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_OBJECT_ID, s, 1, &objectName))
+				objectName = 0;
+			// negative object names are not drawn
+			if (objectName < 0)
+				continue;
+			if (g_POLYLINE_VERTEX_BUFFERS == graphicsObject->object_type)
+			{
+				unsigned int indexStart = 0, indexCount = 0;
+				vertexArray->get_unsigned_integer_attribute(
+					GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_START, s, 1, &indexStart);
+				vertexArray->get_unsigned_integer_attribute(
+					GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_COUNT, s, 1, &indexCount);
+				this->addPolyline(positionBuffer, positionValuesPerVertex, indexStart, indexCount,
+					discontinuous, objectName);
+			}
+			else
+			{
+				this->addSurface(graphicsObject, s, positionBuffer, positionValuesPerVertex,
+					!discontinuous, objectName);
+			}
+		}
+	} break;
+	default:
+	{
+	} break;
+	}
+	const unsigned int primitivesCount = static_cast<unsigned int>(this->primitives.size());
+	if (0 == primitivesCount)
+		return;
+	std::vector<float> centroids(3*primitivesCount, 0.0f);
+	this->primitiveOrder.resize(primitivesCount);
+	for (unsigned int p = 0; p < primitivesCount; ++p)
+	{
+		this->primitiveOrder[p] = p;
+		const Primitive& primitive = this->primitives[p];
+		const float *vertex = this->coordinates.data() + primitive.coordinatesStart;
+		for (unsigned int v = 0; v < primitive.verticesCount; ++v)
+		{
+			for (int c = 0; c < 3; ++c)
+				centroids[3*p + c] += vertex[c];
+			vertex += 3;
+		}
+		for (int c = 0; c < 3; ++c)
+			centroids[3*p + c] /= static_cast<float>(primitive.verticesCount);
+	}
+	// binary tree has at most 2n - 1 nodes
+	this->nodes.reserve(2*primitivesCount);
+	this->nodes.resize(1);
+	this->buildNode(0, 0, primitivesCount, centroids);
+}
+
+void GraphicsObjectPickTree::addPrimitive(unsigned int verticesCount,
+	const float *vertexCoordinates, int objectName, int vertexName)
+{
+	Primitive primitive;
+	primitive.coordinatesStart = static_cast<unsigned int>(this->coordinates.size());
+	primitive.verticesCount = verticesCount;
+	primitive.objectName = objectName;
+	primitive.vertexName = vertexName;
+	this->coordinates.insert(this->coordinates.end(), vertexCoordinates, vertexCoordinates + 3*verticesCount);
+	this->primitives.push_back(primitive);
+}
+
+void GraphicsObjectPickTree::addPolyline(const float *positionBuffer,
+	unsigned int positionValuesPerVertex, unsigned int indexStart,
+	unsigned int indexCount, bool discontinuous, int objectName)
+{
+	float segment[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+	const unsigned int componentsCount = std::min(positionValuesPerVertex, 3u);
+	const unsigned int step = discontinuous ? 2 : 1;
+	for (unsigned int i = 0; i + 1 < indexCount; i += step)
+	{
+		const float *position = positionBuffer + (indexStart + i)*positionValuesPerVertex;
+		for (unsigned int c = 0; c < componentsCount; ++c)
+		{
+			segment[c] = position[c];
+			segment[3 + c] = position[positionValuesPerVertex + c];
+		}
+		this->addPrimitive(2, segment, objectName, 0);
+	}
+}
+
+void GraphicsObjectPickTree::addSurface(GT_object *graphicsObject,
+	unsigned int surfaceIndex, const float *positionBuffer,
+	unsigned int positionValuesPerVertex, bool triangleStrips, int objectName)
+{
+	Graphics_vertex_array *vertexArray = graphicsObject->vertex_array;
+	float triangle[9] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+	const unsigned int componentsCount = std::min(positionValuesPerVertex, 3u);
+	if (triangleStrips)
+	{
+		unsigned int *indexBuffer = 0, indexValuesPerVertex = 0, indexVertexCount = 0;
+		vertexArray->get_unsigned_integer_vertex_buffer(
+			GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_STRIP_INDEX_ARRAY,
+			&indexBuffer, &indexValuesPerVertex, &indexVertexCount);
+		if (!indexBuffer)
+			return;
+		unsigned int stripsCount = 0, stripStart = 0;
+		vertexArray->get_unsigned_integer_attribute(
+			GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_NUMBER_OF_STRIPS, surfaceIndex, 1, &stripsCount);
+		vertexArray->get_unsigned_integer_attribute(
+			GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_STRIP_START, surfaceIndex, 1, &stripStart);
+		for (unsigned int s = 0; s < stripsCount; ++s)
+		{
+			unsigned int pointsCount = 0, indexStart = 0;
+			vertexArray->get_unsigned_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_STRIP_INDEX_START,
+				stripStart + s, 1, &indexStart);
+			vertexArray->get_unsigned_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_NUMBER_OF_POINTS_FOR_STRIP,
+				stripStart + s, 1, &pointsCount);
+			const unsigned int *indices = indexBuffer + indexStart;
+			for (unsigned int i = 0; i + 2 < pointsCount; ++i)
+			{
+				for (int v = 0; v < 3; ++v)
+				{
+					const float *position = positionBuffer + indices[i + v]*positionValuesPerVertex;
+					for (unsigned int c = 0; c < componentsCount; ++c)
+						triangle[3*v + c] = position[c];
+				}
+				this->addPrimitive(3, triangle, objectName, 0);
+			}
+		}
+	}
+	else
+	{
+		unsigned int indexStart = 0, indexCount = 0;
+		vertexArray->get_unsigned_integer_attribute(
+			GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_START, surfaceIndex, 1, &indexStart);
+		vertexArray->get_unsigned_integer_attribute(
+			GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_COUNT, surfaceIndex, 1, &indexCount);
+		for (unsigned int i = 0; i + 2 < indexCount; i += 3)
+		{
+			for (int v = 0; v < 3; ++v)
+			{
+				const float *position = positionBuffer + (indexStart + i + v)*positionValuesPerVertex;
+				for (unsigned int c = 0; c < componentsCount; ++c)
+					triangle[3*v + c] = position[c];
+			}
+			this->addPrimitive(3, triangle, objectName, 0);
+		}
+	}
+}
+
+/**
+ * Add glyphs as points for point glyphs, otherwise as the triangles, line
+ * segments and points of the glyph graphics transformed by each glyph's
+ * position and axes, so only the drawn glyph shape is hit. Glyphs with no
+ * pickable primitives but a non-empty range, e.g. text only, are added as the
+ * 6 faces of their transformed bounding box.
+ */
+void GraphicsObjectPickTree::addGlyphset(GT_object *graphicsObject)
+{
+	Graphics_vertex_array *vertexArray = graphicsObject->vertex_array;
+	GT_glyphset_vertex_buffers *glyphSet = graphicsObject->primitive_lists->gt_glyphset_vertex_buffers;
+	GT_object *glyph = (glyphSet) ? glyphSet->glyph : 0;
+	if (!glyph)
+		return;
+	GLfloat *positionBuffer = 0, *axis1Buffer = 0, *axis2Buffer = 0, *axis3Buffer = 0, *scaleBuffer = 0;
+	int *namesBuffer = 0;
+	unsigned int positionValuesPerVertex = 0, positionVertexCount = 0,
+		axis1ValuesPerVertex = 0, axis1VertexCount = 0, axis2ValuesPerVertex = 0, axis2VertexCount = 0,
+		axis3ValuesPerVertex = 0, axis3VertexCount = 0, scaleValuesPerVertex = 0, scaleVertexCount = 0,
+		namesPerVertex = 0, namesCount = 0;
+	vertexArray->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_POSITION,
+		&positionBuffer, &positionValuesPerVertex, &positionVertexCount);
+	vertexArray->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_AXIS1,
+		&axis1Buffer, &axis1ValuesPerVertex, &axis1VertexCount);
+	vertexArray->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_AXIS2,
+		&axis2Buffer, &axis2ValuesPerVertex, &axis2VertexCount);
+	vertexArray->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_AXIS3,
+		&axis3Buffer, &axis3ValuesPerVertex, &axis3VertexCount);
+	vertexArray->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_SCALE,
+		&scaleBuffer, &scaleValuesPerVertex, &scaleVertexCount);
+	vertexArray->get_integer_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_VERTEX_ID,
+		&namesBuffer, &namesPerVertex, &namesCount);
+	if (!(positionBuffer && axis1Buffer && axis2Buffer && axis3Buffer && scaleBuffer))
+		return;
+	if (CMZN_GRAPHICS_SELECT_MODE_OFF != graphicsObject->select_mode)
+		this->namesCount = (namesBuffer) ? 2 : 1;
+	// get glyph primitives and range in its own coordinates from the cached pick
+	// trees of its items; point glyphs and empty glyphs are picked as points
+	std::vector<float> glyphCoordinates;
+	std::vector<unsigned int> glyphVerticesCounts;
+	Graphics_object_range_struct glyphRange;
+	if (CMZN_GLYPH_SHAPE_TYPE_POINT != GT_object_get_glyph_type(glyph))
+	{
+		for (GT_object *glyphItem = glyph; glyphItem; glyphItem = glyphItem->nextobject)
+		{
+			get_graphics_object_range(glyphItem, static_cast<void *>(&glyphRange));
+			const GraphicsObjectPickTree *glyphTree = GT_object_get_pick_tree(glyphItem);
+			if (!glyphTree)
+				continue;
+			for (size_t p = 0; p < glyphTree->primitives.size(); ++p)
+			{
+				const Primitive& primitive = glyphTree->primitives[p];
+				const float *vertex = glyphTree->coordinates.data() + primitive.coordinatesStart;
+				glyphCoordinates.insert(glyphCoordinates.end(), vertex, vertex + 3*primitive.verticesCount);
+				glyphVerticesCounts.push_back(primitive.verticesCount);
+			}
+		}
+	}
+	const bool glyphPoints = (0 != glyphRange.first);
+	const bool glyphBox = glyphVerticesCounts.empty();
+	const int glyphsCount = cmzn_glyph_repeat_mode_get_number_of_glyphs(glyphSet->glyph_repeat_mode);
+	const unsigned int subobjectsCount = vertexArray->get_number_of_vertices(
+		GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_START);
+	// vertices of box faces from corner numbers with bit 0 = axis1 maximum, etc.
+	static const int boxFaceCorners[6][4] =
+	{
+		{ 0, 2, 6, 4 }, { 1, 3, 7, 5 }, { 0, 1, 5, 4 }, { 2, 3, 7, 6 }, { 0, 1, 3, 2 }, { 4, 5, 7, 6 }
+	};
+	Triple point, axis1, axis2, axis3;
+	float corners[8][3], face[12], transformed[12];
+	for (unsigned int s = 0; s < subobjectsCount; ++s)
+	{
+		int objectName = 0;
+		vertexArray->get_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_OBJECT_ID, s, 1, &objectName);
+		unsigned int indexStart = 0, indexCount = 0;
+		vertexArray->get_unsigned_integer_attribute(
+			GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_START, s, 1, &indexStart);
+		vertexArray->get_unsigned_integer_attribute(
+			GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_COUNT, s, 1, &indexCount);
+		for (unsigned int i = indexStart; i < indexStart + indexCount; ++i)
+		{
+			const int vertexName = (namesBuffer) ? namesBuffer[i*namesPerVertex] : 0;
+			for (int glyphNumber = 0; glyphNumber < glyphsCount; ++glyphNumber)
+			{
+				resolve_glyph_axes(glyphSet->glyph_repeat_mode, glyphNumber,
+					glyphSet->base_size, glyphSet->scale_factors, glyphSet->offset,
+					positionBuffer + i*positionValuesPerVertex,
+					axis1Buffer + i*axis1ValuesPerVertex,
+					axis2Buffer + i*axis2ValuesPerVertex,
+					axis3Buffer + i*axis3ValuesPerVertex,
+					scaleBuffer + i*scaleValuesPerVertex,
+					point, axis1, axis2, axis3);
+				if (glyphPoints)
+				{
+					this->addPrimitive(1, point, objectName, vertexName);
+					continue;
+				}
+				if (!glyphBox)
+				{
+					const float *vertex = glyphCoordinates.data();
+					for (size_t p = 0; p < glyphVerticesCounts.size(); ++p)
+					{
+						const unsigned int verticesCount = glyphVerticesCounts[p];
+						for (unsigned int v = 0; v < verticesCount; ++v)
+						{
+							for (int c = 0; c < 3; ++c)
+								transformed[3*v + c] = point[c] + vertex[0]*axis1[c] + vertex[1]*axis2[c] + vertex[2]*axis3[c];
+							vertex += 3;
+						}
+						this->addPrimitive(verticesCount, transformed, objectName, vertexName);
+					}
+					continue;
+				}
+				for (int k = 0; k < 8; ++k)
+				{
+					const float x1 = (k & 1) ? glyphRange.maximum[0] : glyphRange.minimum[0];
+					const float x2 = (k & 2) ? glyphRange.maximum[1] : glyphRange.minimum[1];
+					const float x3 = (k & 4) ? glyphRange.maximum[2] : glyphRange.minimum[2];
+					for (int c = 0; c < 3; ++c)
+						corners[k][c] = point[c] + x1*axis1[c] + x2*axis2[c] + x3*axis3[c];
+				}
+				for (int f = 0; f < 6; ++f)
+				{
+					for (int v = 0; v < 4; ++v)
+						for (int c = 0; c < 3; ++c)
+							face[3*v + c] = corners[boxFaceCorners[f][v]][c];
+					this->addPrimitive(4, face, objectName, vertexName);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Set bounds of node for its primitives and split it into two children at
+ * the median centroid along the longest axis, until leaf size is reached.
+ */
+void GraphicsObjectPickTree::buildNode(unsigned int nodeIndex, unsigned int start,
+	unsigned int count, const std::vector<float>& centroids)
+{
+	Node node;
+	float centroidMinimums[3], centroidMaximums[3];
+	for (unsigned int i = start; i < start + count; ++i)
+	{
+		const unsigned int p = this->primitiveOrder[i];
+		const Primitive& primitive = this->primitives[p];
+		const float *vertex = this->coordinates.data() + primitive.coordinatesStart;
+		for (unsigned int v = 0; v < primitive.verticesCount; ++v)
+		{
+			for (int c = 0; c < 3; ++c)
+			{
+				if ((i == start) && (v == 0))
+					node.minimums[c] = node.maximums[c] = vertex[c];
+				else if (vertex[c] < node.minimums[c])
+					node.minimums[c] = vertex[c];
+				else if (vertex[c] > node.maximums[c])
+					node.maximums[c] = vertex[c];
+			}
+			vertex += 3;
+		}
+		for (int c = 0; c < 3; ++c)
+		{
+			const float centroid = centroids[3*p + c];
+			if (i == start)
+				centroidMinimums[c] = centroidMaximums[c] = centroid;
+			else if (centroid < centroidMinimums[c])
+				centroidMinimums[c] = centroid;
+			else if (centroid > centroidMaximums[c])
+				centroidMaximums[c] = centroid;
+		}
+	}
+	int axis = 0;
+	for (int c = 1; c < 3; ++c)
+	{
+		if ((centroidMaximums[c] - centroidMinimums[c]) > (centroidMaximums[axis] - centroidMinimums[axis]))
+			axis = c;
+	}
+	if ((count <= PICK_TREE_LEAF_SIZE) || (centroidMaximums[axis] <= centroidMinimums[axis]))
+	{
+		node.start = start;
+		node.count = count;
+		this->nodes[nodeIndex] = node;
+		return;
+	}
+	const unsigned int middle = start + count/2;
+	std::nth_element(this->primitiveOrder.begin() + start, this->primitiveOrder.begin() + middle,
+		this->primitiveOrder.begin() + start + count,
+		[&centroids, axis](unsigned int a, unsigned int b) { return centroids[3*a + axis] < centroids[3*b + axis]; });
+	const unsigned int childIndex = static_cast<unsigned int>(this->nodes.size());
+	node.start = childIndex;
+	node.count = 0;
+	this->nodes[nodeIndex] = node;
+	this->nodes.resize(childIndex + 2);
+	this->buildNode(childIndex, start, middle - start, centroids);
+	this->buildNode(childIndex + 1, middle, start + count - middle, centroids);
+}
+
+void GraphicsObjectPickTree::pick(const double *pickingMatrix, std::vector<Hit>& hits) const
+{
+	if (this->nodes.empty())
+		return;
+	// clip planes w + x >= 0, w - x >= 0, w + y >= 0 etc. in coordinates of graphics object
+	double planes[6][4];
+	for (int k = 0; k < 3; ++k)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			planes[2*k][j] = pickingMatrix[12 + j] + pickingMatrix[4*k + j];
+			planes[2*k + 1][j] = pickingMatrix[12 + j] - pickingMatrix[4*k + j];
+		}
+	}
+	// index of hit in hits for each distinct object name, vertex name
+	std::map<std::pair<int, int>, size_t> hitIndexes;
+	double clipVertices[2][PICK_TREE_MAXIMUM_CLIPPED_VERTICES][4];
+	std::vector<unsigned int> nodeStack(1, 0);
+	while (!nodeStack.empty())
+	{
+		const Node& node = this->nodes[nodeStack.back()];
+		nodeStack.pop_back();
+		// skip node if its box is entirely outside any clip plane
+		bool outside = false;
+		for (int k = 0; (k < 6) && !outside; ++k)
+		{
+			double maximumDistance = planes[k][3];
+			for (int c = 0; c < 3; ++c)
+				maximumDistance += planes[k][c]*((planes[k][c] > 0.0) ? node.maximums[c] : node.minimums[c]);
+			outside = (maximumDistance < 0.0);
+		}
+		if (outside)
+			continue;
+		if (0 == node.count)
+		{
+			nodeStack.push_back(node.start);
+			nodeStack.push_back(node.start + 1);
+			continue;
+		}
+		for (unsigned int i = node.start; i < node.start + node.count; ++i)
+		{
+			const Primitive& primitive = this->primitives[this->primitiveOrder[i]];
+			const float *vertex = this->coordinates.data() + primitive.coordinatesStart;
+			int verticesCount = static_cast<int>(primitive.verticesCount);
+			for (int v = 0; v < verticesCount; ++v)
+			{
+				for (int r = 0; r < 4; ++r)
+				{
+					const double *row = pickingMatrix + 4*r;
+					clipVertices[0][v][r] = row[0]*vertex[0] + row[1]*vertex[1] + row[2]*vertex[2] + row[3];
+				}
+				vertex += 3;
+			}
+			int current = 0;
+			for (int k = 0; (k < 6) && (0 < verticesCount); ++k)
+			{
+				verticesCount = clipPolygonToPlane(verticesCount, clipVertices[current],
+					k/2, (k % 2) ? -1.0 : 1.0, clipVertices[1 - current]);
+				current = 1 - current;
+			}
+			if (0 == verticesCount)
+				continue;
+			double nearDepth = 1.0, farDepth = 0.0;
+			for (int v = 0; v < verticesCount; ++v)
+			{
+				const double w = clipVertices[current][v][3];
+				const double depth = (w > 0.0) ? 0.5*(clipVertices[current][v][2]/w + 1.0) : 0.0;
+				if (depth < nearDepth)
+					nearDepth = depth;
+				if (depth > farDepth)
+					farDepth = depth;
+			}
+			const std::pair<int, int> names(
+				(0 < this->namesCount) ? primitive.objectName : 0,
+				(1 < this->namesCount) ? primitive.vertexName : 0);
+			std::map<std::pair<int, int>, size_t>::iterator iter = hitIndexes.find(names);
+			if (iter == hitIndexes.end())
+			{
+				hitIndexes[names] = hits.size();
+				Hit hit = { nearDepth, farDepth, names.first, names.second };
+				hits.push_back(hit);
+			}
+			else
+			{
+				Hit& hit = hits[iter->second];
+				if (nearDepth < hit.nearDepth)
+					hit.nearDepth = nearDepth;
+				if (farDepth > hit.farDepth)
+					hit.farDepth = farDepth;
+			}
+		}
+	}
+}
+
+const GraphicsObjectPickTree *GT_object_get_pick_tree(GT_object *graphics_object)
+{
+	if (!graphics_object)
+		return 0;
+	if (!graphics_object->pick_tree)
+		graphics_object->pick_tree = new GraphicsObjectPickTree(graphics_object);
+	return graphics_object->pick_tree;
+}
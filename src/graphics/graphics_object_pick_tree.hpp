@@ -0,0 +1,116 @@
+/**
+ * @file graphics_object_pick_tree.hpp
+ *
+ * Bounding volume hierarchy over the pickable primitives of a graphics object
+ * for picking without OpenGL selection.
+ */
+/* Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (GRAPHICS_OBJECT_PICK_TREE_HPP)
+#define GRAPHICS_OBJECT_PICK_TREE_HPP
+
+#include <vector>
+
+struct GT_object;
+
+/**
+ * Bounding volume hierarchy over the triangles, line segments and points of
+ * a single GT_object, including those of each glyph in a glyph set, each
+ * tagged with the picking names the OpenGL renderer loads for it: the object
+ * name (usually element index) and, for glyph sets, the vertex name (point
+ * number or node index).
+ * Built lazily from the vertex array and cached on the GT_object until it
+ * changes. Queries test primitives against the clip volume of a picking
+ * matrix, giving the same hits as OpenGL selection mode.
+ */
+class GraphicsObjectPickTree
+{
+public:
+
+	/** Picked primitives with the same names, merged as for OpenGL selection */
+	struct Hit
+	{
+		double nearDepth, farDepth;  // normalised window depth from 0 to 1
+		int objectName;
+		int vertexName;
+	};
+
+private:
+
+	struct Primitive
+	{
+		unsigned int coordinatesStart;  // index of first x in coordinates
+		unsigned int verticesCount;  // 1 = point, 2 = line, 3 or 4 = convex polygon
+		int objectName;
+		int vertexName;
+	};
+
+	struct Node
+	{
+		float minimums[3], maximums[3];
+		// leaf: first primitive in primitiveOrder; otherwise index of first child node
+		unsigned int start;
+		// number of primitives in leaf or 0 if not a leaf. Second child follows first
+		unsigned int count;
+	};
+
+	// number of names loaded for each primitive: 0 none, 1 object name, 2 object and vertex name
+	int namesCount;
+	std::vector<float> coordinates;
+	std::vector<Primitive> primitives;
+	std::vector<unsigned int> primitiveOrder;
+	std::vector<Node> nodes;
+
+	void addPrimitive(unsigned int verticesCount, const float *vertexCoordinates,
+		int objectName, int vertexName);
+
+	void addPolyline(const float *positionBuffer, unsigned int positionValuesPerVertex,
+		unsigned int indexStart, unsigned int indexCount, bool discontinuous, int objectName);
+
+	void addSurface(GT_object *graphicsObject, unsigned int surfaceIndex,
+		const float *positionBuffer, unsigned int positionValuesPerVertex, bool triangleStrips,
+		int objectName);
+
+	void addGlyphset(GT_object *graphicsObject);
+
+	void buildNode(unsigned int nodeIndex, unsigned int start, unsigned int count,
+		const std::vector<float>& centroids);
+
+public:
+
+	/** Build tree for pickable primitives in graphicsObject only, not any
+	 * graphics objects linked to it. */
+	GraphicsObjectPickTree(GT_object *graphicsObject);
+
+	int getNamesCount() const
+	{
+		return this->namesCount;
+	}
+
+	size_t getPrimitivesCount() const
+	{
+		return this->primitives.size();
+	}
+
+	/**
+	 * Find primitives intersecting the clip volume of the picking matrix.
+	 * @param pickingMatrix  Row-major 4x4 matrix transforming coordinates of
+	 * the graphics object to homogeneous normalised device coordinates, where
+	 * the picking volume is -w <= x, y, z <= w.
+	 * @param hits  Hits are appended to this vector, one per distinct name set.
+	 */
+	void pick(const double *pickingMatrix, std::vector<Hit>& hits) const;
+};
+
+/**
+ * Get the pick tree for graphics object, building it if not already cached.
+ * Cached tree is discarded by GT_object_changed.
+ * @return  Non-accessed pick tree, or 0 if invalid argument.
+ */
+const GraphicsObjectPickTree *GT_object_get_pick_tree(GT_object *graphics_object);
+
+#endif /* !defined (GRAPHICS_OBJECT_PICK_TREE_HPP) */
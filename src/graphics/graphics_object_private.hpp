@@ -83,6 +83,7 @@ struct GT_glyphset_vertex_buffers
 	char *static_label_text[3];
 	enum cmzn_glyph_repeat_mode glyph_repeat_mode;
 	int label_bounds_dimension, label_bounds_components;
+	bool render_instanced;  // draw glyphs with instanced draw calls if possible
 }; /* struct GT_polyline_vertex_buffers */
 
 struct GT_pointset_vertex_buffers
@@ -109,6 +110,9 @@ traversed from first to last, and additional primitives added at the end.
 	struct GT_pointset_vertex_buffers *gt_pointset_vertex_buffers;
 }; /* union GT_primitive_list */
 
+class GraphicsObjectLod;
+class GraphicsObjectPickTree;
+
 struct GT_object
 /*******************************************************************************
 LAST MODIFIED : 17 March 2003
@@ -165,6 +169,19 @@ Graphical object data structure.
 	GLuint tangent_vertex_buffer_object;
 	GLuint tangent_values_per_vertex;
 	GLuint index_vertex_buffer_object;
+	/* allocated sizes in bytes of the above vertex buffer objects, grown
+	 * geometrically so partial rebuilds can replace changed ranges in place */
+	GLsizeiptr position_vertex_buffer_size;
+	GLsizeiptr colour_vertex_buffer_size;
+	GLsizeiptr normal_vertex_buffer_size;
+	GLsizeiptr texture_coordinate0_vertex_buffer_size;
+	GLsizeiptr tangent_vertex_buffer_size;
+	GLsizeiptr index_vertex_buffer_size;
+	/* number of indices in index vertex buffer object */
+	GLuint index_vertex_count;
+	/* per-glyph transformation and colour for instanced drawing of glyph sets */
+	GLuint instance_vertex_buffer_object;
+	GLuint instance_count;
 	/* For multipass rendering we use some more vertex_buffers
 	 * a framebuffer and a texture. */
 	unsigned int multipass_width;
@@ -175,6 +192,10 @@ Graphical object data structure.
 #endif /* defined (OPENGL_API) */
 	/* enumeration indicates whether the graphics display list is up to date */
 	enum Graphics_compile_status compile_status;
+	/* cached tree of primitives for picking without OpenGL, cleared when changed */
+	GraphicsObjectPickTree *pick_tree;
+	/* optional coarser levels of detail owned by this object */
+	GraphicsObjectLod *lod;
 
 	/* Custom per compile code for graphics_objects used as glyphs. */
 	Graphics_object_glyph_labels_function glyph_labels_function;
@@ -6,6 +6,7 @@
 /**
  * C++ interfaces for graphics_vertex_array.cpp
  */
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <stdlib.h>
@@ -130,6 +131,7 @@ int DESTROY(Graphics_vertex_buffer)(
 
 typedef std::map<Graphics_vertex_array_attribute_type, Graphics_vertex_string_buffer*> String_buffer_map;
 typedef std::multimap<int , int> Fast_search_id_map;
+typedef std::vector<std::pair<unsigned int, unsigned int> > Vertex_range_vector;
 
 class Graphics_vertex_array_internal
 {
@@ -140,9 +142,18 @@ public:
 	/* fast search map for locating id for quick modification,
 	 * this is implemented as multimap for graphics type that have varying number of primitives */
 	Fast_search_id_map id_map;
+	/* ranges of vertices [first, end) with float attributes replaced since
+	 * changes were reset, sorted and merged only when needed */
+	Vertex_range_vector changed_ranges;
+	/* number of vertices when changes were reset; later ones are appended */
+	unsigned int unchanged_vertex_count;
+	/* set if all vertices must be treated as changed */
+	bool all_vertices_changed;
 
 	Graphics_vertex_array_internal(Graphics_vertex_array_type type)
-		: type(type)
+		: type(type),
+		unchanged_vertex_count(0),
+		all_vertices_changed(true)
 	{
 		buffer_list = CREATE(LIST(Graphics_vertex_buffer))();
 	}
@@ -164,10 +175,25 @@ public:
 		string_buffer_list.clear();
 	}
 
+	void add_changed_range(unsigned int first, unsigned int end)
+	{
+		if (!this->all_vertices_changed)
+		{
+			this->changed_ranges.push_back(std::make_pair(first, end));
+			// limit memory used by many small replacements
+			if (this->changed_ranges.size() >= 4096)
+				this->merge_changed_ranges();
+		}
+	}
+
+	void merge_changed_ranges();
+
 	int add_fast_search_id(int object_id);
 
 	int find_first_fast_search_id_location(int target_id);
 
+	int release_fast_search_id(int target_id);
+
 	int get_all_fast_search_id_locations(int target_id,
 		int *number_of_locations, int **locations);
 
@@ -231,6 +257,26 @@ Graphics_vertex_array::Graphics_vertex_array(Graphics_vertex_array_type type)
 	internal = new Graphics_vertex_array_internal(type);
 }
 
+/** Sort changed ranges and merge any which overlap or are adjacent */
+void Graphics_vertex_array_internal::merge_changed_ranges()
+{
+	if (this->changed_ranges.size() < 2)
+		return;
+	std::sort(this->changed_ranges.begin(), this->changed_ranges.end());
+	size_t merged = 0;
+	for (size_t i = 1; i < this->changed_ranges.size(); ++i)
+	{
+		if (this->changed_ranges[i].first <= this->changed_ranges[merged].second)
+		{
+			if (this->changed_ranges[i].second > this->changed_ranges[merged].second)
+				this->changed_ranges[merged].second = this->changed_ranges[i].second;
+		}
+		else
+			this->changed_ranges[++merged] = this->changed_ranges[i];
+	}
+	this->changed_ranges.resize(merged + 1);
+}
+
 int Graphics_vertex_array_internal::add_fast_search_id(int object_id)
 {
 	const int current_location = static_cast<int>(id_map.size());
@@ -250,6 +296,21 @@ int Graphics_vertex_array_internal::find_first_fast_search_id_location(int targe
 	return location;
 }
 
+int Graphics_vertex_array_internal::release_fast_search_id(int target_id)
+{
+	std::pair<Fast_search_id_map::iterator, Fast_search_id_map::iterator> range = id_map.equal_range(target_id);
+	if (range.first == range.second)
+		return 0;
+	// keep locations under an invalid id so later locations stay in step with the number of primitives
+	std::vector<int> locations;
+	for (Fast_search_id_map::iterator pos = range.first; pos != range.second; ++pos)
+		locations.push_back(pos->second);
+	id_map.erase(range.first, range.second);
+	for (size_t i = 0; i < locations.size(); ++i)
+		id_map.insert(std::make_pair(-1, locations[i]));
+	return 1;
+}
+
 int Graphics_vertex_array_internal::get_all_fast_search_id_locations(int target_id,
 	int *number_of_locations, int **locations)
 {
@@ -673,8 +734,11 @@ int Graphics_vertex_array::replace_float_vertex_buffer_at_position(
 	const unsigned int vertex_index,	const unsigned int values_per_vertex,
 	const unsigned int number_of_values, const GLfloat *values)
 {
-	return internal->replace_attribute(vertex_type,
+	const int return_code = internal->replace_attribute(vertex_type,
 		vertex_index, values_per_vertex, number_of_values, values);
+	if (return_code)
+		internal->add_changed_range(vertex_index, vertex_index + number_of_values);
+	return return_code;
 }
 
 int Graphics_vertex_array::add_unsigned_integer_attribute(
@@ -914,14 +978,135 @@ int Graphics_vertex_array::find_first_fast_search_id_location(
 	return internal->find_first_fast_search_id_location(target_id);
 }
 
+int Graphics_vertex_array::release_fast_search_id(int target_id)
+{
+	return internal->release_fast_search_id(target_id);
+}
+
 int Graphics_vertex_array::get_all_fast_search_id_locations(int target_id,
 	int *number_of_locations, int **locations)
 {
 	return internal->get_all_fast_search_id_locations(target_id, number_of_locations, locations);
 }
 
+int Graphics_vertex_array::append(Graphics_vertex_array& source)
+{
+	if ((source.internal->type != this->internal->type) || (&source == this))
+	{
+		display_message(ERROR_MESSAGE, "Graphics_vertex_array::append.  Invalid argument(s)");
+		return 0;
+	}
+	// offsets for index attributes are the buffer sizes before appending
+	const unsigned int vertexOffset = this->get_number_of_vertices(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_POSITION);
+	const unsigned int stripOffset = this->get_number_of_vertices(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_STRIP_INDEX_START);
+	const unsigned int stripIndexOffset = this->get_number_of_vertices(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_STRIP_INDEX_ARRAY);
+	const int idLocationOffset = static_cast<int>(this->internal->id_map.size());
+	int return_code = 1;
+	std::vector<unsigned int> offsetValues;
+	for (int t = GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_POSITION;
+		return_code && (t <= GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_LABEL); ++t)
+	{
+		const Graphics_vertex_array_attribute_type vertex_type = static_cast<Graphics_vertex_array_attribute_type>(t);
+		if (vertex_type == GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_LABEL)
+		{
+			Graphics_vertex_string_buffer *string_buffer = source.internal->get_string_buffer_for_attribute(vertex_type);
+			if ((string_buffer) && (string_buffer->vertex_count > 0))
+				return_code = this->internal->add_string_attribute(vertex_type, string_buffer->values_per_vertex,
+					string_buffer->vertex_count, string_buffer->strings_vectors.data());
+			continue;
+		}
+		Graphics_vertex_buffer *buffer = source.internal->get_vertex_buffer_for_attribute(vertex_type);
+		if ((!buffer) || (0 == buffer->vertex_count))
+			continue;
+		const unsigned int values_per_vertex = buffer->values_per_vertex;
+		const unsigned int number_of_values = buffer->vertex_count;
+		unsigned int offset = 0;
+		switch (vertex_type)
+		{
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_START:
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_STRIP_INDEX_ARRAY:
+			offset = vertexOffset;
+			break;
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_STRIP_START:
+			offset = stripOffset;
+			break;
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_STRIP_INDEX_START:
+			offset = stripIndexOffset;
+			break;
+		default:
+			break;
+		}
+		switch (vertex_type)
+		{
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_POSITION:
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_NORMAL:
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_COLOUR:
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_DATA:
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_TEXTURE_COORDINATE_ZERO:
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_TANGENT:
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_AXIS1:
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_AXIS2:
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_AXIS3:
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_SCALE:
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_LABEL_DENSITY:
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_LABEL_BOUND:
+		case GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_SCALE_OFFSET:
+			return_code = this->internal->add_attribute(vertex_type, values_per_vertex, number_of_values,
+				static_cast<const GLfloat *>(buffer->memory));
+			break;
+		default:
+			if (offset)
+			{
+				const unsigned int *values = static_cast<const unsigned int *>(buffer->memory);
+				offsetValues.resize(values_per_vertex*number_of_values);
+				for (size_t i = 0; i < offsetValues.size(); ++i)
+					offsetValues[i] = values[i] + offset;
+				return_code = this->internal->add_attribute(vertex_type, values_per_vertex, number_of_values,
+					offsetValues.data());
+			}
+			else
+				return_code = this->internal->add_attribute(vertex_type, values_per_vertex, number_of_values,
+					static_cast<const int *>(buffer->memory));
+			break;
+		}
+	}
+	for (Fast_search_id_map::const_iterator iter = source.internal->id_map.begin();
+		iter != source.internal->id_map.end(); ++iter)
+		this->internal->id_map.insert(std::make_pair(iter->first, iter->second + idLocationOffset));
+	return return_code;
+}
+
+int Graphics_vertex_array::get_changed_vertex_ranges(
+	std::vector<std::pair<unsigned int, unsigned int> >& ranges)
+{
+	ranges.clear();
+	const unsigned int vertex_count = this->get_number_of_vertices(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_POSITION);
+	if ((internal->all_vertices_changed) || (vertex_count < internal->unchanged_vertex_count))
+		return 0;
+	if (vertex_count > internal->unchanged_vertex_count)
+		internal->changed_ranges.push_back(std::make_pair(internal->unchanged_vertex_count, vertex_count));
+	internal->merge_changed_ranges();
+	for (Vertex_range_vector::const_iterator iter = internal->changed_ranges.begin();
+		iter != internal->changed_ranges.end(); ++iter)
+	{
+		const unsigned int end = (iter->second < vertex_count) ? iter->second : vertex_count;
+		if (iter->first < end)
+			ranges.push_back(std::make_pair(iter->first, end - iter->first));
+	}
+	return 1;
+}
+
+void Graphics_vertex_array::reset_changed_vertex_ranges()
+{
+	internal->changed_ranges.clear();
+	internal->unchanged_vertex_count = this->get_number_of_vertices(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_POSITION);
+	internal->all_vertices_changed = false;
+}
+
 int Graphics_vertex_array::clear_buffers()
 {
+	internal->all_vertices_changed = true;
+	internal->changed_ranges.clear();
 	internal->clear_string_buffer();
 	return FOR_EACH_OBJECT_IN_LIST(Graphics_vertex_buffer)(
 		Graphics_vertex_buffer_clear, NULL, internal->buffer_list);
@@ -932,7 +1117,11 @@ int Graphics_vertex_array::clear_specified_buffer(Graphics_vertex_array_attribut
 	Graphics_vertex_buffer *buffer = FIND_BY_IDENTIFIER_IN_LIST(Graphics_vertex_buffer,type)
 		 (vertex_type, internal->buffer_list);
 	if (buffer)
+	{
+		internal->all_vertices_changed = true;
+		internal->changed_ranges.clear();
 		return Graphics_vertex_buffer_clear(buffer, 0);
+	}
 	return 1;
 }
 
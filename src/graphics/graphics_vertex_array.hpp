@@ -11,6 +11,8 @@
 
 #include "graphics/graphics_object.h"
 #include <string>
+#include <utility>
+#include <vector>
 
 enum Graphics_vertex_array_shape_type
 {
@@ -90,9 +92,7 @@ enum Graphics_vertex_array_attribute_type
 	/** array for storing the index */
 	GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_STRIP_INDEX_ARRAY,
 	GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_UPDATE_REQUIRED,
-	GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_LABEL,
-	GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_PARTIAL_REDRAW,
-	GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_PARTIAL_REDRAW_COUNT
+	GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_LABEL
 	/* Complex types might be like this...
 	 * GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_VERTEX3_NORMAL3
 	 * and element_array indices might be supported with an DRAW_ELEMENTS set
@@ -303,6 +303,23 @@ public:
 	*/
 	int clear_buffers();
 
+	/**
+	 * Get ranges of vertices changed since reset_changed_vertex_ranges was last
+	 * called: those with float attributes replaced in place and any appended
+	 * since. Ranges are sorted with overlapping and adjacent ranges merged, so
+	 * only the changed parts of buffers need be sent to the graphics card.
+	 * @param ranges  On success, set to (first vertex, vertex count) pairs.
+	 * @return  1 on success, 0 if all vertices must be treated as changed,
+	 * e.g. if never reset or buffers have been cleared since.
+	 */
+	int get_changed_vertex_ranges(std::vector<std::pair<unsigned int, unsigned int> >& ranges);
+
+	/**
+	 * Record that all current vertices are unchanged, e.g. after they have
+	 * been sent to the graphics card.
+	 */
+	void reset_changed_vertex_ranges();
+
 	/*****************************************************************************//**
 	 * Resets the sizes of the specified buffers in the set.  Does not actually
 	 * release memory in the buffer as it is assumed likely that the same buffer
@@ -329,9 +346,28 @@ public:
 	 * with varying number of vertices per id e.g contour */
 	int get_all_fast_search_id_locations(int target_id, int *number_of_locations, int **locations);
 
+	/**
+	 * Stop finding primitives for target_id so primitives later added for it are
+	 * appended rather than replacing the existing ones, which are left in place.
+	 * @return  1 if any locations were found for target_id, otherwise 0.
+	 */
+	int release_fast_search_id(int target_id);
+
 	void fill_element_index(unsigned vertex_start, unsigned int number_of_xi1, unsigned int number_of_xi2,
 		enum Graphics_vertex_array_shape_type shape_type);
 
+	/**
+	 * Append all vertices, primitives and fast search ids from source array to
+	 * the end of this array. Attributes holding indexes into other buffers
+	 * are offset by the number of entries already in those buffers, so
+	 * primitives converted separately e.g. on different threads can be merged
+	 * in order, giving the same result as adding them all to this array.
+	 * Appended vertices are reported as changed.
+	 * @param source  Array of the same type to append from. Unmodified.
+	 * @return  1 on success, 0 on failure.
+	 */
+	int append(Graphics_vertex_array& source);
+
 };
 
 int fill_glyph_graphics_vertex_array(struct Graphics_vertex_array *array, int vertex_location,
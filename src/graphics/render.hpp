@@ -15,6 +15,7 @@ struct cmzn_scenefilter;
 #define Scene cmzn_scene // GRC temp
 struct cmzn_graphics;
 class GraphicsIncrementalBuild;
+struct GraphicsObjectLodView;
 struct cmzn_scene;
 struct GT_element_group;
 struct Texture;
@@ -211,7 +212,8 @@ public:
 	Render_graphics_compile_members() :
 		time(0.0),
 		region_path(NULL),
-		incrementalBuild(0)
+		incrementalBuild(0),
+		lodView(0)
 	{
 		for (int i = 0; i < 16; i++)
 		{
@@ -229,6 +231,9 @@ public:
 	 * somewhat responsive; invokes further redraw/build steps until complete.
 	 * If 0, full scene/graphics rebuild is performed. */
 	GraphicsIncrementalBuild *incrementalBuild;
+	/** if set, exporters output the levels of detail of graphics drawn in this
+	 * view, otherwise the finest level */
+	const GraphicsObjectLodView *lodView;
 	
 	virtual int Scene_compile(cmzn_scene *scene, cmzn_scenefilter *scenefilter);
 
@@ -277,6 +282,11 @@ public:
 	{
 		this->incrementalBuild = incrementalBuildIn;
 	}
+
+	void setLodView(const GraphicsObjectLodView *lodViewIn)
+	{
+		this->lodView = lodViewIn;
+	}
 };
 
 /***************************************************************************//**
@@ -12,6 +12,7 @@ GL rendering calls - API specific.
 #include <stdio.h>
 #include <math.h>
 #include <list>
+#include <vector>
 #include "cmlibs/zinc/zincconfigure.h"
 
 #include "general/mystring.h"
@@ -22,6 +23,7 @@ GL rendering calls - API specific.
 #include "graphics/glyph.hpp"
 #include "graphics/graphics.hpp"
 #include "graphics/graphics_object.h"
+#include "graphics/graphics_object_lod.hpp"
 #include "graphics/mcubes.h"
 #include "graphics/light.hpp"
 #include "graphics/spectrum.h"
@@ -34,6 +36,7 @@ GL rendering calls - API specific.
 #include "graphics/scene_coordinate_system.hpp"
 #include "graphics/spectrum.hpp"
 #include "graphics/texture.hpp"
+#include "graphics/gltf_export.hpp"
 #include "graphics/threejs_export.hpp"
 #include "graphics/webgl_export.hpp"
 #include "jsoncpp/json.h"
@@ -108,6 +111,36 @@ static int Graphics_object_render_opengl(GT_object *graphics_object,
 static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object,
 	Render_graphics_opengl *renderer);
 
+/**
+ * Get the graphics object to draw for the current OpenGL view: the supplied
+ * object or the coarsest of its levels of detail whose projected error is
+ * within the pixel error tolerance. Always the supplied object when picking.
+ */
+static GT_object *Graphics_object_get_view_level(GT_object *graphics_object,
+	Render_graphics_opengl *renderer)
+{
+	GraphicsObjectLod *lod = GT_object_get_lod(graphics_object);
+	if ((!lod) || (renderer->picking))
+		return graphics_object;
+	GLdouble modelviewMatrix[16], projectionMatrix[16];
+	glGetDoublev(GL_MODELVIEW_MATRIX, modelviewMatrix);
+	glGetDoublev(GL_PROJECTION_MATRIX, projectionMatrix);
+	return lod->selectLevel(graphics_object, modelviewMatrix, projectionMatrix,
+		renderer->viewport_width, renderer->viewport_height);
+}
+
+/**
+ * Update attributes of any levels of detail of graphics object from it.
+ * @return  Levels of detail to compile with the graphics object, or 0 if none.
+ */
+static GraphicsObjectLod *Graphics_object_update_lod(GT_object *graphics_object)
+{
+	GraphicsObjectLod *lod = GT_object_get_lod(graphics_object);
+	if (lod)
+		lod->updateLevelAttributes(graphics_object);
+	return lod;
+}
+
 /*==== Render_graphics_opengl method implementations ====*/
 
 int Render_graphics_opengl::Graphics_object_compile(GT_object *graphics_object)
@@ -117,8 +150,13 @@ int Render_graphics_opengl::Graphics_object_compile(GT_object *graphics_object)
 
 int Render_graphics_opengl::Graphics_compile(cmzn_graphics *graphics)
 {
-	return Graphics_object_compile_members_opengl(cmzn_graphics_get_graphics_object(
-		graphics), this);
+	GT_object *graphics_object = cmzn_graphics_get_graphics_object(graphics);
+	int return_code = Graphics_object_compile_members_opengl(graphics_object, this);
+	GraphicsObjectLod *lod = Graphics_object_update_lod(graphics_object);
+	if (lod)
+		for (int l = 0; return_code && (l < lod->getNumberOfLevels()); ++l)
+			return_code = Graphics_object_compile_members_opengl(lod->getLevelObject(l), this);
+	return return_code;
 }
 
 int Render_graphics_opengl::Material_compile(cmzn_material *material)
@@ -171,8 +209,8 @@ public:
 
 	  int Graphics_execute(cmzn_graphics *graphics)
 	  {
-		  GT_object *graphics_object = cmzn_graphics_get_graphics_object(
-			  graphics);
+		  GT_object *graphics_object = Graphics_object_get_view_level(
+			  cmzn_graphics_get_graphics_object(graphics), this);
 		  return Graphics_object_render_opengl(graphics_object, this,
 			  GRAPHICS_OBJECT_RENDERING_TYPE_GLBEGINEND);
 	  }
@@ -394,8 +432,8 @@ public:
 
 	  int Graphics_execute(cmzn_graphics *graphics)
 	  {
-		  GT_object *graphics_object = cmzn_graphics_get_graphics_object(
-			  graphics);
+		  GT_object *graphics_object = Graphics_object_get_view_level(
+			  cmzn_graphics_get_graphics_object(graphics), this);
 		  cmzn_graphics_set_renderer_highlight_functor(graphics, (void *)this);
 		  int return_code = Graphics_object_render_opengl(graphics_object, this,
 			  GRAPHICS_OBJECT_RENDERING_TYPE_CLIENT_VERTEX_ARRAYS);
@@ -441,8 +479,13 @@ public:
 		 */
 	  int Graphics_compile(cmzn_graphics *graphics)
 	  {
-		  return Graphics_object_compile(cmzn_graphics_get_graphics_object(
-			  graphics));
+		  GT_object *graphics_object = cmzn_graphics_get_graphics_object(graphics);
+		  int return_code = Graphics_object_compile(graphics_object);
+		  GraphicsObjectLod *lod = Graphics_object_update_lod(graphics_object);
+		  if (lod)
+			  for (int l = 0; return_code && (l < lod->getNumberOfLevels()); ++l)
+				  return_code = Graphics_object_compile(lod->getLevelObject(l));
+		  return return_code;
 	  }
 
 	  /**
@@ -456,8 +499,8 @@ public:
 
 	  int Graphics_execute(cmzn_graphics *graphics)
 	  {
-		  GT_object *graphics_object = cmzn_graphics_get_graphics_object(
-			  graphics);
+		  GT_object *graphics_object = Graphics_object_get_view_level(
+			  cmzn_graphics_get_graphics_object(graphics), this);
 		  cmzn_graphics_set_renderer_highlight_functor(graphics, (void *)this);
 		  int return_code = Graphics_object_render_opengl(graphics_object, this,
 			  GRAPHICS_OBJECT_RENDERING_TYPE_VERTEX_BUFFER_OBJECT);
@@ -488,6 +531,39 @@ Render_graphics_opengl *Render_graphics_opengl_create_vertex_buffer_object_rende
 	return new Render_graphics_opengl_vertex_buffer_object();
 }
 
+struct Glyph_instance_program
+{
+	GLuint program;
+	GLint light_enabled_location;
+	GLint use_colour_location;
+	bool failed;  // set if program failed to build so it is not tried again
+};
+
+Glyph_instance_program *Glyph_instance_program_create()
+{
+	Glyph_instance_program *glyph_instance_program = new Glyph_instance_program();
+	glyph_instance_program->program = 0;
+	glyph_instance_program->light_enabled_location = -1;
+	glyph_instance_program->use_colour_location = -1;
+	glyph_instance_program->failed = false;
+	return glyph_instance_program;
+}
+
+void Glyph_instance_program_destroy(Glyph_instance_program **glyph_instance_program_address)
+{
+	if ((glyph_instance_program_address) && (*glyph_instance_program_address))
+	{
+#if defined (GL_VERSION_2_0)
+		if ((*glyph_instance_program_address)->program)
+		{
+			glDeleteProgram((*glyph_instance_program_address)->program);
+		}
+#endif /* defined (GL_VERSION_2_0) */
+		delete *glyph_instance_program_address;
+		*glyph_instance_program_address = nullptr;
+	}
+}
+
 class Render_graphics_opengl_webgl : public Render_graphics_opengl_vertex_buffer_object
 {
 public:
@@ -759,6 +835,8 @@ public:
 
 	virtual int cmzn_scene_compile_members(cmzn_scene *scene)
 	{
+		// exported vertex buffers must not contain primitives released by partial rebuilds
+		cmzn_scene_flag_graphics_for_compaction(scene);
 		if (number_of_time_steps == 0)
 		{
 			cmzn_scene_compile_graphics(scene, this,/*force_rebuild*/0);
@@ -818,8 +896,8 @@ public:
 	int Graphics_export(cmzn_graphics *graphics)
 	{
 		int return_code = 0;
-		GT_object *graphics_object = cmzn_graphics_get_graphics_object(
-			graphics);
+		GT_object *graphics_object = GT_object_get_view_level(
+			cmzn_graphics_get_graphics_object(graphics), this->lodView);
 		Threejs_export_class *threejs_export = 0;
 		if (number_of_time_steps == 0 || current_time_frame == 0)
 		{
@@ -960,6 +1038,163 @@ Render_graphics_opengl *Render_graphics_opengl_create_threejs_renderer(
 		morphVertices, morphColours, morphNormals, numberOfFiles, file_names, isInline);
 }
 
+/**
+ * Renderer exporting surfaces, lines and point glyphs in the scene tree to a
+ * single binary glTF, with later time steps output as morph targets.
+ */
+class Render_graphics_opengl_gltf : public Render_graphics_opengl_vertex_buffer_object
+{
+public:
+
+	Gltf_export gltf_export;
+	double begin_time, end_time;
+	int number_of_time_steps, current_time_frame;
+	int morphVertices, morphColours, morphNormals;
+	std::string& outputString;
+
+	/** @param outputStringRef  Reference to string to fill with the GLB file contents */
+	Render_graphics_opengl_gltf(int number_of_time_steps_in, double begin_time_in,
+			double end_time_in, enum cmzn_streaminformation_scene_io_data_type mode_in,
+			int morphVerticesIn, int morphColoursIn, int morphNormalsIn, int quantisedIn,
+			std::string& outputStringRef) :
+		Render_graphics_opengl_vertex_buffer_object(),
+		// morph targets are only output if time varies
+		gltf_export((begin_time_in != end_time_in) ? number_of_time_steps_in : 1,
+			begin_time_in, end_time_in, mode_in, (0 != quantisedIn)),
+		begin_time(begin_time_in),
+		end_time(end_time_in),
+		number_of_time_steps(number_of_time_steps_in),
+		current_time_frame(0),
+		morphVertices(morphVerticesIn),
+		morphColours(morphColoursIn),
+		morphNormals(morphNormalsIn),
+		outputString(outputStringRef)
+	{
+	}
+
+	virtual int cmzn_scene_compile_members(cmzn_scene *scene)
+	{
+		// exported vertex buffers must not contain primitives released by partial rebuilds
+		cmzn_scene_flag_graphics_for_compaction(scene);
+		if (number_of_time_steps == 0)
+		{
+			cmzn_scene_compile_graphics(scene, this, /*force_rebuild*/0);
+			cmzn_scene_execute(scene);
+		}
+		else
+		{
+			const FE_value current_time = this->time;
+			if ((number_of_time_steps == 1) || (begin_time == end_time) ||
+				((morphVertices == 0) && (morphColours == 0) && (morphNormals == 0)))
+			{
+				this->time = begin_time;
+				cmzn_scene_compile_graphics(scene, this, /*force_rebuild*/1);
+				cmzn_scene_execute(scene);
+			}
+			else
+			{
+				int return_code = 1;
+				const double increment = (end_time - begin_time) / (double)(number_of_time_steps - 1);
+				for (int i = 0; (i < number_of_time_steps) && return_code; i++)
+				{
+					this->time = begin_time + i * increment;
+					cmzn_scene_compile_graphics(scene, this, /*force_rebuild*/1);
+					return_code = cmzn_scene_execute(scene);
+					current_time_frame++;
+				}
+			}
+			current_time_frame = 0;
+			// restore the scene back to its original time
+			this->time = current_time;
+			cmzn_scene_compile_graphics(scene, this, /*force_rebuild*/1);
+		}
+		return 1;
+	}
+
+	int Graphics_object_compile(GT_object *)
+	{
+		return true;
+	}
+
+	int Graphics_compile(cmzn_graphics *graphics)
+	{
+		return Graphics_object_compile(cmzn_graphics_get_graphics_object(graphics));
+	}
+
+	/** Export surfaces, lines and point glyph graphics. Points graphics with
+	 * other glyph shapes are not exported as glTF output has no glyph
+	 * instancing; use THREEJS export for glyphs. */
+	int Graphics_execute(cmzn_graphics *graphics)
+	{
+		GT_object *graphics_object = GT_object_get_view_level(
+			cmzn_graphics_get_graphics_object(graphics), this->lodView);
+		if (!graphics_object)
+			return 1;
+		const GT_object_type object_type = GT_object_get_type(graphics_object);
+		if (cmzn_graphics_get_type(graphics) == CMZN_GRAPHICS_TYPE_POINTS)
+		{
+			cmzn_graphicspointattributes_id pointAttr = cmzn_graphics_get_graphicspointattributes(graphics);
+			const bool pointGlyph = (cmzn_graphicspointattributes_get_glyph_shape_type(pointAttr) ==
+				CMZN_GLYPH_SHAPE_TYPE_POINT);
+			cmzn_graphicspointattributes_destroy(&pointAttr);
+			if (!pointGlyph)
+				return 1;
+		}
+		else if ((object_type != g_SURFACE_VERTEX_BUFFERS) && (object_type != g_POLYLINE_VERTEX_BUFFERS))
+		{
+			return 1;
+		}
+		const bool graphicsIsTimeDependent = graphics->coordinateFieldIsTimeDependent()
+			|| graphics->pointGlyphScalingIsTimeDependent()
+			|| graphics->isoscalarFieldIsTimeDependent()
+			|| graphics->subgroupFieldIsTimeDependent();
+		char *graphics_name = cmzn_graphics_get_name_internal(graphics);
+		char *group_name = 0;
+		cmzn_field_id groupField = cmzn_graphics_get_subgroup_field(graphics);
+		if (groupField)
+			group_name = cmzn_field_get_name(groupField);
+		cmzn_material_id material = cmzn_graphics_get_material(graphics);
+		const int return_code = gltf_export.exportGraphicsObject(graphics, graphics_object,
+			current_time_frame, material, graphics_name, this->region_path, group_name,
+			graphicsIsTimeDependent && (0 != morphVertices),
+			graphics->dataFieldIsTimeDependent() && (0 != morphColours),
+			graphicsIsTimeDependent && (0 != morphNormals));
+		cmzn_material_destroy(&material);
+		cmzn_field_destroy(&groupField);
+		if (group_name)
+			DEALLOCATE(group_name);
+		DEALLOCATE(graphics_name);
+		return return_code;
+	}
+
+	int cmzn_scene_execute_graphics(cmzn_scene *scene)
+	{
+		return cmzn_scene_graphics_render_opengl(scene, this);
+	}
+
+	int cmzn_scene_execute(cmzn_scene *scene)
+	{
+		return execute_scene_threejs_output(scene, this);
+	}
+
+	int Scene_tree_execute(cmzn_scene *)
+	{
+		this->outputString = gltf_export.getGlb();
+		return 1;
+	}
+
+}; /* class Render_graphics_opengl_gltf */
+
+Render_graphics_opengl *Render_graphics_opengl_create_gltf_renderer(
+	int number_of_time_steps, double begin_time, double end_time,
+	enum cmzn_streaminformation_scene_io_data_type mode,
+	int morphVertices, int morphColours, int morphNormals, int quantised,
+	std::string& outputStringRef)
+{
+	return new Render_graphics_opengl_gltf(number_of_time_steps, begin_time, end_time,
+		mode, morphVertices, morphColours, morphNormals, quantised, outputStringRef);
+}
+
 /**
  * An implementation of a render class that wraps another opengl renderer in
  * compile and then execute stages.
@@ -1021,16 +1256,11 @@ public:
 
 		  GT_object *graphics_object = cmzn_graphics_get_graphics_object(graphics);
 		  cmzn_graphics_set_renderer_highlight_functor(graphics, (void *)this);
-		  return_code = Render_immediate::Graphics_object_compile(graphics_object);
-		  if (return_code)
-		  {
-			  Callback_member_callback< GT_object*, Render_graphics_opengl_display_list,
-				  int (Render_graphics_opengl_display_list::*)(GT_object*) >
-				  execute_method(static_cast<Render_graphics_opengl_display_list*>(this),
-				  &Render_graphics_opengl_display_list::Graphics_object_execute_parent);
-			  return_code = ::Graphics_object_compile_opengl_display_list(graphics_object,
-				  &execute_method, this);
-		  }
+		  return_code = this->Graphics_object_compile(graphics_object);
+		  GraphicsObjectLod *lod = Graphics_object_update_lod(graphics_object);
+		  if (lod)
+			  for (int l = 0; return_code && (l < lod->getNumberOfLevels()); ++l)
+				  return_code = this->Graphics_object_compile(lod->getLevelObject(l));
 		  cmzn_graphics_remove_renderer_highlight_functor(graphics, (void *)this);
 		  return (return_code);
 	  }
@@ -1042,7 +1272,8 @@ public:
 
 	  int Graphics_execute(cmzn_graphics *graphics)
 	  {
-		  GT_object *graphics_object = cmzn_graphics_get_graphics_object(graphics);
+		  GT_object *graphics_object = Graphics_object_get_view_level(
+			  cmzn_graphics_get_graphics_object(graphics), this);
 		  return ::Graphics_object_execute_opengl_display_list(graphics_object, this);
 	  }
 
@@ -1687,9 +1918,215 @@ static int Graphics_object_generate_vertex_positions_from_secondary_material(GT_
 } /* Graphics_object_generate_vertex_positions_from_secondary_material */
 #endif /* defined (GL_VERSION_2_0) */
 
+#if defined (GL_VERSION_3_3)
+/* floats per glyph instance: position, 3 axes, RGBA colour */
+#define GLYPH_INSTANCE_VALUES_COUNT 16
+
+/**
+ * @return  True if glyph graphics object can be drawn instanced: all objects
+ * in its linked list must be static surfaces without their own material,
+ * per-vertex colours or glyph labels.
+ */
+static bool GT_object_glyph_can_be_instanced(GT_object *glyph)
+{
+	for (GT_object *item = glyph; item; item = item->nextobject)
+	{
+		if ((g_SURFACE_VERTEX_BUFFERS != item->object_type) || (!item->vertex_array) ||
+			(!item->primitive_lists) || (!item->primitive_lists->gt_surface_vertex_buffers) ||
+			item->default_material || item->secondary_material || item->glyph_labels_function ||
+			(1 < GT_object_get_number_of_times(item)) ||
+			(0 < item->vertex_array->get_number_of_vertices(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_DATA)))
+		{
+			return false;
+		}
+	}
+	return (0 != glyph);
+}
+
+/**
+ * @return  True if glyph set is coloured by its spectrum and data.
+ */
+static bool GT_object_glyphset_has_data_colours(GT_object *object)
+{
+	return (0 != get_GT_object_spectrum(object)) &&
+		(0 < object->vertex_array->get_number_of_vertices(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_DATA));
+}
+
+/**
+ * Compile the transformation and colour of every glyph in the glyph set into
+ * its instance vertex buffer object, for drawing each glyph surface with a
+ * single instanced draw call. Clears the instance buffer if the glyph set
+ * cannot be drawn instanced or instancing is not supported.
+ * Must be called with a current OpenGL context.
+ */
+static void Graphics_object_compile_opengl_glyphset_instances(GT_object *object)
+{
+	object->instance_count = 0;
+	GT_glyphset_vertex_buffers *glyph_set = object->primitive_lists->gt_glyphset_vertex_buffers;
+	const unsigned int nodeset_count = object->vertex_array->get_number_of_vertices(
+		GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_START);
+	GLfloat *position_buffer = 0, *axis1_buffer = 0, *axis2_buffer = 0, *axis3_buffer = 0,
+		*scale_buffer = 0, *data_buffer = 0, *label_bound_buffer = 0;
+	unsigned int position_values_per_vertex = 0, position_vertex_count = 0,
+		axis1_values_per_vertex = 0, axis1_vertex_count = 0, axis2_values_per_vertex = 0,
+		axis2_vertex_count = 0, axis3_values_per_vertex = 0, axis3_vertex_count = 0,
+		scale_values_per_vertex = 0, scale_vertex_count = 0, data_values_per_vertex = 0,
+		data_vertex_count = 0, label_bounds_per_vertex = 0, label_bounds_count = 0;
+	if (glyph_set->render_instanced && (0 < nodeset_count) &&
+		GT_object_glyph_can_be_instanced(glyph_set->glyph))
+	{
+		object->vertex_array->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_POSITION,
+			&position_buffer, &position_values_per_vertex, &position_vertex_count);
+		object->vertex_array->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_AXIS1,
+			&axis1_buffer, &axis1_values_per_vertex, &axis1_vertex_count);
+		object->vertex_array->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_AXIS2,
+			&axis2_buffer, &axis2_values_per_vertex, &axis2_vertex_count);
+		object->vertex_array->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_AXIS3,
+			&axis3_buffer, &axis3_values_per_vertex, &axis3_vertex_count);
+		object->vertex_array->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_SCALE,
+			&scale_buffer, &scale_values_per_vertex, &scale_vertex_count);
+		object->vertex_array->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_LABEL_BOUND,
+			&label_bound_buffer, &label_bounds_per_vertex, &label_bounds_count);
+	}
+	if (!(position_buffer && axis1_buffer && axis2_buffer && axis3_buffer && scale_buffer &&
+		(!label_bound_buffer) && Graphics_library_check_extension(GL_VERSION_3_3)))
+	{
+		if (object->instance_vertex_buffer_object)
+		{
+			glDeleteBuffers(1, &object->instance_vertex_buffer_object);
+			object->instance_vertex_buffer_object = 0;
+		}
+		return;
+	}
+	struct cmzn_spectrum *spectrum = 0;
+	if (GT_object_glyphset_has_data_colours(object))
+	{
+		spectrum = get_GT_object_spectrum(object);
+		object->vertex_array->get_float_vertex_buffer(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_DATA,
+			&data_buffer, &data_values_per_vertex, &data_vertex_count);
+	}
+	ZnReal base_rgba[4] = { 1.0, 1.0, 1.0, 1.0 };
+	cmzn_material *material = get_GT_object_default_material(object);
+	if (material)
+	{
+		Colour diffuse_colour;
+		MATERIAL_PRECISION alpha;
+		Graphical_material_get_diffuse(material, &diffuse_colour);
+		Graphical_material_get_alpha(material, &alpha);
+		base_rgba[0] = diffuse_colour.red;
+		base_rgba[1] = diffuse_colour.green;
+		base_rgba[2] = diffuse_colour.blue;
+		base_rgba[3] = alpha;
+	}
+	const int number_of_glyphs = cmzn_glyph_repeat_mode_get_number_of_glyphs(glyph_set->glyph_repeat_mode);
+	std::vector<GLfloat> instance_values;
+	instance_values.reserve(static_cast<size_t>(position_vertex_count)*number_of_glyphs*GLYPH_INSTANCE_VALUES_COUNT);
+	std::vector<FE_value> feData((data_buffer) ? data_values_per_vertex : 0);
+	Triple temp_point, temp_axis1, temp_axis2, temp_axis3;
+	for (unsigned int nodeset_index = 0; nodeset_index < nodeset_count; ++nodeset_index)
+	{
+		unsigned int index_start = 0, index_count = 0;
+		object->vertex_array->get_unsigned_integer_attribute(
+			GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_START, nodeset_index, 1, &index_start);
+		object->vertex_array->get_unsigned_integer_attribute(
+			GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_COUNT, nodeset_index, 1, &index_count);
+		for (unsigned int i = index_start; i < index_start + index_count; ++i)
+		{
+			ZnReal rgba[4] = { base_rgba[0], base_rgba[1], base_rgba[2], base_rgba[3] };
+			if (data_buffer)
+			{
+				const GLfloat *datum = data_buffer + data_values_per_vertex*i;
+				CAST_TO_FE_VALUE(feData.data(), datum, (int)data_values_per_vertex);
+				Spectrum_value_to_rgba(spectrum, data_values_per_vertex, feData.data(), rgba);
+			}
+			for (int glyph_number = 0; glyph_number < number_of_glyphs; ++glyph_number)
+			{
+				resolve_glyph_axes(glyph_set->glyph_repeat_mode, glyph_number,
+					glyph_set->base_size, glyph_set->scale_factors, glyph_set->offset,
+					position_buffer + position_values_per_vertex*i,
+					axis1_buffer + axis1_values_per_vertex*i,
+					axis2_buffer + axis2_values_per_vertex*i,
+					axis3_buffer + axis3_values_per_vertex*i,
+					scale_buffer + scale_values_per_vertex*i,
+					temp_point, temp_axis1, temp_axis2, temp_axis3);
+				instance_values.insert(instance_values.end(), temp_point, temp_point + 3);
+				instance_values.insert(instance_values.end(), temp_axis1, temp_axis1 + 3);
+				instance_values.insert(instance_values.end(), temp_axis2, temp_axis2 + 3);
+				instance_values.insert(instance_values.end(), temp_axis3, temp_axis3 + 3);
+				for (int c = 0; c < 4; ++c)
+					instance_values.push_back(static_cast<GLfloat>(rgba[c]));
+			}
+		}
+	}
+	if (data_buffer)
+	{
+		Spectrum_end_value_to_rgba(spectrum);
+	}
+	if (!object->instance_vertex_buffer_object)
+	{
+		glGenBuffers(1, &object->instance_vertex_buffer_object);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, object->instance_vertex_buffer_object);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat)*instance_values.size(),
+		instance_values.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	object->instance_count = static_cast<GLuint>(instance_values.size()/GLYPH_INSTANCE_VALUES_COUNT);
+}
+#endif /* defined (GL_VERSION_3_3) */
+
 /***************************************************************************//**
 																			 * Compile Graphics_vertex_array data into vertex buffer objects.
 																			 */
+/**
+ * Upload values to an OpenGL buffer object, generating it if needed. Storage
+ * is only reallocated if too small, growing geometrically, or over 4 times
+ * larger than needed; otherwise values are replaced in place and, if changed
+ * ranges are supplied, only those ranges are uploaded.
+ * @param bufferObject  Address of buffer object name; generated if 0.
+ * @param bufferSize  Address of allocated size of buffer object in bytes.
+ * Set to 0 to force reallocation and upload of all values.
+ * @param valuesSize  Size of values in bytes.
+ * @param changedRanges  Optional ranges of changed items as (first, count).
+ * @param itemSize  Size in bytes of each item in changed ranges.
+ */
+static void Graphics_object_upload_opengl_buffer(GLenum target,
+	GLuint *bufferObject, GLsizeiptr *bufferSize, const void *values,
+	GLsizeiptr valuesSize,
+	const std::vector<std::pair<unsigned int, unsigned int> > *changedRanges,
+	GLsizeiptr itemSize)
+{
+	if (!*bufferObject)
+	{
+		glGenBuffers(1, bufferObject);
+		*bufferSize = 0;
+	}
+	glBindBuffer(target, *bufferObject);
+	if ((valuesSize > *bufferSize) || (valuesSize < (*bufferSize / 4)))
+	{
+		GLsizeiptr allocateSize = valuesSize;
+		if ((*bufferSize > 0) && (valuesSize > *bufferSize) && (valuesSize < 2*(*bufferSize)))
+			allocateSize = 2*(*bufferSize);
+		glBufferData(target, allocateSize, /*data*/NULL, GL_STATIC_DRAW);
+		*bufferSize = allocateSize;
+		if (valuesSize > 0)
+			glBufferSubData(target, 0, valuesSize, values);
+	}
+	else if (changedRanges)
+	{
+		const char *bytes = static_cast<const char *>(values);
+		for (size_t i = 0; i < changedRanges->size(); ++i)
+		{
+			const GLintptr offset = itemSize*static_cast<GLintptr>((*changedRanges)[i].first);
+			const GLsizeiptr size = itemSize*static_cast<GLsizeiptr>((*changedRanges)[i].second);
+			glBufferSubData(target, offset, size, bytes + offset);
+		}
+	}
+	else if (valuesSize > 0)
+	{
+		glBufferSubData(target, 0, valuesSize, values);
+	}
+}
+
 static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object,
 	Render_graphics_opengl *renderer)
 {
@@ -1715,24 +2152,23 @@ static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object
 				}
 				if (glyph_set->font)
 					cmzn_font_compile(glyph_set->font);
+#if defined (GL_VERSION_3_3)
+				if (GRAPHICS_COMPILED != object->compile_status)
+				{
+					Graphics_object_compile_opengl_glyphset_instances(object);
+				}
+#endif /* defined (GL_VERSION_3_3) */
 			}
 		}  /* fall through */
 		case g_POLYLINE_VERTEX_BUFFERS:
 		case g_SURFACE_VERTEX_BUFFERS:
 		case g_POINT_SET_VERTEX_BUFFERS:
 			{
-				unsigned int *partialRedrawIndices = 0;
-				unsigned int partialRedrawIndicesPerVertex, partialRedrawIndicesCount;
-				unsigned int *redraw_count_buffer = 0;
-				unsigned int redrawPerVertex, redrawCount;
-				object->vertex_array->get_unsigned_integer_vertex_buffer(
-						GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_PARTIAL_REDRAW,
-						&partialRedrawIndices, &partialRedrawIndicesPerVertex,
-						&partialRedrawIndicesCount);
-				object->vertex_array->get_unsigned_integer_vertex_buffer(
-						GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_PARTIAL_REDRAW_COUNT,
-						&redraw_count_buffer, &redrawPerVertex,
-						&redrawCount);
+				/* after a partial rebuild only upload vertices changed since the last compile */
+				std::vector<std::pair<unsigned int, unsigned int> > changedRanges;
+				const std::vector<std::pair<unsigned int, unsigned int> > *changedVertexRanges =
+					(object->buffer_binding && object->vertex_array->get_changed_vertex_ranges(changedRanges)) ?
+					&changedRanges : 0;
 				GLfloat *position_vertex_buffer = NULL;
 				unsigned int position_values_per_vertex, position_vertex_count;
 				if (object->vertex_array->get_float_vertex_buffer(
@@ -1750,27 +2186,16 @@ static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object
 					{
 						/* Defer to lower in this function as we may want to use the contents of
 						* some of the other buffers in our first pass calculation.
+						* Multipass rendering resizes the buffer itself.
 						*/
+						object->position_vertex_buffer_size = 0;
 					}
 					else if (object->buffer_binding)
 					{
-						glBindBuffer(GL_ARRAY_BUFFER, object->position_vertex_buffer_object);
-						if (!partialRedrawIndices)
-							glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat)*
-									position_values_per_vertex*position_vertex_count,
-									position_vertex_buffer, GL_STATIC_DRAW);
-						else
-						{
-							GLintptr bytesStart = 0;
-							GLsizeiptr size = 0;
-							for (unsigned int i = 0; i < redrawCount; i++)
-							{
-								bytesStart = sizeof(GLfloat)*position_values_per_vertex*partialRedrawIndices[i];
-								size = sizeof(GLfloat)*position_values_per_vertex*redraw_count_buffer[i];
-								glBufferSubData(GL_ARRAY_BUFFER, bytesStart, size, &(position_vertex_buffer[partialRedrawIndices[i]*position_values_per_vertex]));
-							}
-	
-						}
+						Graphics_object_upload_opengl_buffer(GL_ARRAY_BUFFER,
+							&object->position_vertex_buffer_object, &object->position_vertex_buffer_size,
+							position_vertex_buffer, sizeof(GLfloat)*position_values_per_vertex*position_vertex_count,
+							changedVertexRanges, sizeof(GLfloat)*position_values_per_vertex);
 						object->position_values_per_vertex = position_values_per_vertex;
 					}
 				}
@@ -1780,6 +2205,7 @@ static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object
 					{
 						glDeleteBuffers(1, &object->position_vertex_buffer_object);
 						object->position_vertex_buffer_object = 0;
+						object->position_vertex_buffer_size = 0;
 					}
 				}
 				unsigned int colour_values_per_vertex, colour_vertex_count;
@@ -1791,18 +2217,22 @@ static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object
 					if ((object->buffer_binding || (object->compile_status == GRAPHICS_NOT_COMPILED)) &&
 							(colour_vertex_count == position_vertex_count))
 					{
-						if (!object->colour_vertex_buffer_object)
-						{
-							glGenBuffers(1, &object->colour_vertex_buffer_object);
-						}
-						glBindBuffer(GL_ARRAY_BUFFER, object->colour_vertex_buffer_object);
-						glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat)* /*need to be 4 */4 *colour_vertex_count,
-							colour_buffer, GL_STATIC_DRAW);
+						/* colours for all vertices change with spectrum or material,
+						 * which reset the buffer size to force a full upload */
+						Graphics_object_upload_opengl_buffer(GL_ARRAY_BUFFER,
+							&object->colour_vertex_buffer_object, &object->colour_vertex_buffer_size,
+							colour_buffer, sizeof(GLfloat)* /*need to be 4 */4 *colour_vertex_count,
+							changedVertexRanges, sizeof(GLfloat)*4);
 						object->colour_values_per_vertex = colour_values_per_vertex;
-						if (colour_buffer)
-						{
-							DEALLOCATE(colour_buffer);
-						}
+					}
+					else if (colour_vertex_count != position_vertex_count)
+					{
+						/* not uploaded so must be fully uploaded next time */
+						object->colour_vertex_buffer_size = 0;
+					}
+					if (colour_buffer)
+					{
+						DEALLOCATE(colour_buffer);
 					}
 				}
 				else
@@ -1815,6 +2245,7 @@ static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object
 					{
 						glDeleteBuffers(1, &object->colour_vertex_buffer_object);
 						object->colour_vertex_buffer_object = 0;
+						object->colour_vertex_buffer_size = 0;
 					}
 				}
 
@@ -1825,27 +2256,12 @@ static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object
 					&normal_buffer, &normal_values_per_vertex, &normal_vertex_count)
 					&& (3 == normal_values_per_vertex))
 				{
-					if (!object->normal_vertex_buffer_object)
-					{
-						glGenBuffers(1, &object->normal_vertex_buffer_object);
-					}
 					if (object->buffer_binding)
 					{
-						glBindBuffer(GL_ARRAY_BUFFER, object->normal_vertex_buffer_object);
-						if (!partialRedrawIndices)
-							glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat)*normal_values_per_vertex*normal_vertex_count,
-								normal_buffer, GL_STATIC_DRAW);
-						else
-						{
-							GLintptr bytesStart = 0;
-							GLsizeiptr size = 0;
-							for (unsigned int i = 0; i < redrawCount; i++)
-							{
-								bytesStart = sizeof(GLfloat)*normal_values_per_vertex*partialRedrawIndices[i];
-								size = sizeof(GLfloat)*normal_values_per_vertex*redraw_count_buffer[i];
-								glBufferSubData(GL_ARRAY_BUFFER, bytesStart, size, &(normal_buffer[partialRedrawIndices[i]*normal_values_per_vertex]));
-							}
-						}
+						Graphics_object_upload_opengl_buffer(GL_ARRAY_BUFFER,
+							&object->normal_vertex_buffer_object, &object->normal_vertex_buffer_size,
+							normal_buffer, sizeof(GLfloat)*normal_values_per_vertex*normal_vertex_count,
+							changedVertexRanges, sizeof(GLfloat)*normal_values_per_vertex);
 					}
 				}
 				else
@@ -1854,6 +2270,7 @@ static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object
 					{
 						glDeleteBuffers(1, &object->normal_vertex_buffer_object);
 						object->normal_vertex_buffer_object = 0;
+						object->normal_vertex_buffer_size = 0;
 					}
 				}
 
@@ -1866,28 +2283,13 @@ static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object
 					&texture_coordinate0_vertex_count)
 					&& (texture_coordinate0_vertex_count == position_vertex_count))
 				{
-					if (!object->texture_coordinate0_vertex_buffer_object)
-					{
-						glGenBuffers(1, &object->texture_coordinate0_vertex_buffer_object);
-					}
 					if (object->buffer_binding)
 					{
-						glBindBuffer(GL_ARRAY_BUFFER, object->texture_coordinate0_vertex_buffer_object);
-						if (!partialRedrawIndices)
-							glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat)*texture_coordinate0_values_per_vertex*texture_coordinate0_vertex_count,
-								texture_coordinate0_buffer, GL_STATIC_DRAW);
-						else
-						{
-							GLintptr bytesStart = 0;
-							GLsizeiptr size = 0;
-							for (unsigned int i = 0; i < redrawCount; i++)
-							{
-								bytesStart = sizeof(GLfloat)*texture_coordinate0_values_per_vertex*partialRedrawIndices[i];
-								size = sizeof(GLfloat)*texture_coordinate0_values_per_vertex*redraw_count_buffer[i];
-								glBufferSubData(GL_ARRAY_BUFFER, bytesStart, size,
-									&(texture_coordinate0_buffer[partialRedrawIndices[i]*texture_coordinate0_values_per_vertex]));
-							}
-						}
+						Graphics_object_upload_opengl_buffer(GL_ARRAY_BUFFER,
+							&object->texture_coordinate0_vertex_buffer_object, &object->texture_coordinate0_vertex_buffer_size,
+							texture_coordinate0_buffer,
+							sizeof(GLfloat)*texture_coordinate0_values_per_vertex*texture_coordinate0_vertex_count,
+							changedVertexRanges, sizeof(GLfloat)*texture_coordinate0_values_per_vertex);
 						object->texture_coordinate0_values_per_vertex = texture_coordinate0_values_per_vertex;
 					}
 				}
@@ -1897,6 +2299,7 @@ static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object
 					{
 						glDeleteBuffers(1, &object->texture_coordinate0_vertex_buffer_object);
 						object->texture_coordinate0_vertex_buffer_object = 0;
+						object->texture_coordinate0_vertex_buffer_size = 0;
 					}
 				}
 
@@ -1909,24 +2312,12 @@ static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object
 					&tangent_vertex_count) &&
 					(tangent_vertex_count == position_vertex_count))
 				{
-					if (!object->tangent_vertex_buffer_object)
+					if (object->buffer_binding || (!object->tangent_vertex_buffer_object))
 					{
-						glGenBuffers(1, &object->tangent_vertex_buffer_object);
-					}
-					glBindBuffer(GL_ARRAY_BUFFER, object->tangent_vertex_buffer_object);
-					if (!partialRedrawIndices)
-						glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat)*tangent_values_per_vertex*tangent_vertex_count,
-								tangent_buffer, GL_STATIC_DRAW);
-					else
-					{
-						GLintptr bytesStart = 0;
-						GLsizeiptr size = 0;
-						for (unsigned int i = 0; i < redrawCount; i++)
-						{
-							bytesStart = sizeof(GLfloat)*tangent_values_per_vertex*partialRedrawIndices[i];
-							size = sizeof(GLfloat)*tangent_values_per_vertex*redraw_count_buffer[i];
-							glBufferSubData(GL_ARRAY_BUFFER, bytesStart, size, &(tangent_buffer[partialRedrawIndices[i]*tangent_values_per_vertex]));
-						}
+						Graphics_object_upload_opengl_buffer(GL_ARRAY_BUFFER,
+							&object->tangent_vertex_buffer_object, &object->tangent_vertex_buffer_size,
+							tangent_buffer, sizeof(GLfloat)*tangent_values_per_vertex*tangent_vertex_count,
+							changedVertexRanges, sizeof(GLfloat)*tangent_values_per_vertex);
 					}
 					object->tangent_values_per_vertex = tangent_values_per_vertex;
 				}
@@ -1936,6 +2327,7 @@ static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object
 					{
 						glDeleteBuffers(1, &object->tangent_vertex_buffer_object);
 						object->tangent_vertex_buffer_object = 0;
+						object->tangent_vertex_buffer_size = 0;
 					}
 				}
 
@@ -1981,10 +2373,19 @@ static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object
 					}
 					else if (object->buffer_binding)
 					{
-						glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->index_vertex_buffer_object);
-						glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint)*
-							index_values_per_vertex*index_vertex_count,
-							index_vertex_buffer, GL_STATIC_DRAW);
+						/* indices of primitives replaced by a partial rebuild are
+						 * unchanged, so only upload those appended since */
+						const unsigned int indexCount = index_values_per_vertex*index_vertex_count;
+						const bool appendIndices = (0 != changedVertexRanges) && (object->index_vertex_count <= indexCount);
+						std::vector<std::pair<unsigned int, unsigned int> > appendedIndexRanges;
+						if (appendIndices && (object->index_vertex_count < indexCount))
+							appendedIndexRanges.push_back(std::make_pair(object->index_vertex_count,
+								indexCount - object->index_vertex_count));
+						Graphics_object_upload_opengl_buffer(GL_ELEMENT_ARRAY_BUFFER,
+							&object->index_vertex_buffer_object, &object->index_vertex_buffer_size,
+							index_vertex_buffer, sizeof(GLuint)*indexCount,
+							appendIndices ? &appendedIndexRanges : 0, sizeof(GLuint));
+						object->index_vertex_count = indexCount;
 					}
 				}
 				else
@@ -1993,6 +2394,8 @@ static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object
 					{
 						glDeleteBuffers(1, &object->index_vertex_buffer_object);
 						object->index_vertex_buffer_object = 0;
+						object->index_vertex_buffer_size = 0;
+						object->index_vertex_count = 0;
 					}
 				}
 			} break;
@@ -2007,10 +2410,8 @@ static int Graphics_object_compile_opengl_vertex_buffer_object(GT_object *object
 			Graphics_object_compile_opengl_vertex_buffer_object(temp_glyph, renderer);
 		}
 		object->buffer_binding = 0;
-		object->vertex_array->clear_specified_buffer(
-			GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_PARTIAL_REDRAW);
-		object->vertex_array->clear_specified_buffer(
-			GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_PARTIAL_REDRAW_COUNT);
+		if (object->vertex_array)
+			object->vertex_array->reset_changed_vertex_ranges();
 		object->compile_status = GRAPHICS_COMPILED;
 	}
 	else
@@ -2174,6 +2575,299 @@ static int Graphics_object_disable_opengl_vertex_buffer_object(GT_object *object
 	return (return_code);
 } /* Graphics_object_enable_opengl_client_vertex_arrays */
 
+#if defined (GL_VERSION_3_3)
+/* generic vertex attribute indexes for glyph instance values; 0 is avoided as
+ * it aliases the fixed function vertex position */
+#define GLYPH_INSTANCE_ATTRIBUTE_POSITION 1
+#define GLYPH_INSTANCE_ATTRIBUTE_AXIS1 2
+#define GLYPH_INSTANCE_ATTRIBUTE_AXIS2 3
+#define GLYPH_INSTANCE_ATTRIBUTE_AXIS3 4
+#define GLYPH_INSTANCE_ATTRIBUTE_COLOUR 5
+
+/* Vertex shader transforming glyph vertices and normals by per-instance axes
+ * and evaluating the fixed function lighting model for the enabled lights.
+ * Fragment processing remains fixed function. */
+static const char glyph_instance_vertex_shader_string[] =
+	"#version 120\n"
+	"attribute vec3 instancePosition;\n"
+	"attribute vec3 instanceAxis1;\n"
+	"attribute vec3 instanceAxis2;\n"
+	"attribute vec3 instanceAxis3;\n"
+	"attribute vec4 instanceColour;\n"
+	"uniform float lightEnabled[8];\n"
+	"uniform float useInstanceColour;\n"
+	"\n"
+	"vec4 lightColour(vec3 normal, vec3 eyePosition, vec4 ambient, vec4 diffuse)\n"
+	"{\n"
+	"	vec4 colour = gl_FrontMaterial.emission + gl_LightModel.ambient*ambient;\n"
+	"	for (int i = 0; i < 8; ++i)\n"
+	"	{\n"
+	"		if (lightEnabled[i] > 0.5)\n"
+	"		{\n"
+	"			vec3 lightDirection;\n"
+	"			float attenuation = 1.0;\n"
+	"			if (gl_LightSource[i].position.w == 0.0)\n"
+	"				lightDirection = normalize(gl_LightSource[i].position.xyz);\n"
+	"			else\n"
+	"			{\n"
+	"				lightDirection = gl_LightSource[i].position.xyz - eyePosition;\n"
+	"				float distance = length(lightDirection);\n"
+	"				lightDirection /= distance;\n"
+	"				attenuation = 1.0/(gl_LightSource[i].constantAttenuation + distance*\n"
+	"					(gl_LightSource[i].linearAttenuation + distance*gl_LightSource[i].quadraticAttenuation));\n"
+	"				if (gl_LightSource[i].spotCutoff <= 90.0)\n"
+	"				{\n"
+	"					float spotCos = dot(-lightDirection, normalize(gl_LightSource[i].spotDirection));\n"
+	"					attenuation *= (spotCos < gl_LightSource[i].spotCosCutoff) ? 0.0 :\n"
+	"						pow(spotCos, gl_LightSource[i].spotExponent);\n"
+	"				}\n"
+	"			}\n"
+	"			float diffuseFactor = max(dot(normal, lightDirection), 0.0);\n"
+	"			colour += attenuation*(gl_LightSource[i].ambient*ambient + diffuseFactor*gl_LightSource[i].diffuse*diffuse);\n"
+	"			if (diffuseFactor > 0.0)\n"
+	"			{\n"
+	"				float specularFactor = max(dot(normal, normalize(lightDirection + vec3(0.0, 0.0, 1.0))), 0.0);\n"
+	"				colour += attenuation*pow(specularFactor, gl_FrontMaterial.shininess)*\n"
+	"					gl_LightSource[i].specular*gl_FrontMaterial.specular;\n"
+	"			}\n"
+	"		}\n"
+	"	}\n"
+	"	colour.a = diffuse.a;\n"
+	"	return clamp(colour, 0.0, 1.0);\n"
+	"}\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	mat3 axes = mat3(instanceAxis1, instanceAxis2, instanceAxis3);\n"
+	"	vec4 position = vec4(instancePosition + axes*gl_Vertex.xyz, 1.0);\n"
+	"	vec4 eyePosition = gl_ModelViewMatrix*position;\n"
+	"	gl_Position = gl_ModelViewProjectionMatrix*position;\n"
+	"	gl_ClipVertex = eyePosition;\n"
+	"	// transform normal by cofactors = inverse transpose of axes times determinant\n"
+	"	vec3 cross23 = cross(instanceAxis2, instanceAxis3);\n"
+	"	vec3 normal = mat3(cross23, cross(instanceAxis3, instanceAxis1), cross(instanceAxis1, instanceAxis2))*gl_Normal;\n"
+	"	if (dot(instanceAxis1, cross23) < 0.0)\n"
+	"		normal = -normal;\n"
+	"	normal = normalize(gl_NormalMatrix*normal);\n"
+	"	vec4 ambient = mix(gl_FrontMaterial.ambient, instanceColour, useInstanceColour);\n"
+	"	vec4 diffuse = mix(gl_FrontMaterial.diffuse, instanceColour, useInstanceColour);\n"
+	"	gl_FrontColor = lightColour(normal, eyePosition.xyz, ambient, diffuse);\n"
+	"	gl_BackColor = lightColour(-normal, eyePosition.xyz, ambient, diffuse);\n"
+	"}\n";
+
+/**
+ * Create the instanced glyph shader program on first use in the current
+ * OpenGL context.
+ * @return  True if program is available, false if it failed to build.
+ */
+static bool Glyph_instance_program_build(Glyph_instance_program *glyph_instance_program)
+{
+	if (glyph_instance_program->program)
+		return true;
+	if (glyph_instance_program->failed)
+		return false;
+	glyph_instance_program->failed = true;
+	GLuint vertex_shader = glCreateShader(GL_VERTEX_SHADER);
+	const GLchar *vertex_shader_string = glyph_instance_vertex_shader_string;
+	glShaderSource(vertex_shader, 1, &vertex_shader_string, NULL);
+	glCompileShader(vertex_shader);
+	GLint compiled = 0;
+	glGetShaderiv(vertex_shader, GL_COMPILE_STATUS, &compiled);
+	if (!compiled)
+	{
+		int infologLength = 0;
+		glGetShaderiv(vertex_shader, GL_INFO_LOG_LENGTH, &infologLength);
+		if (infologLength > 0)
+		{
+			std::vector<char> infoLog(infologLength);
+			int charsWritten = 0;
+			glGetShaderInfoLog(vertex_shader, infologLength, &charsWritten, infoLog.data());
+			display_message(INFORMATION_MESSAGE, "Glyph instance vertex program info:\n%s\n", infoLog.data());
+		}
+		display_message(WARNING_MESSAGE, "Glyph_instance_program_build.  "
+			"Failed to compile vertex program. Glyphs will be drawn individually.");
+		glDeleteShader(vertex_shader);
+		return false;
+	}
+	GLuint program = glCreateProgram();
+	glAttachShader(program, vertex_shader);
+	glBindAttribLocation(program, GLYPH_INSTANCE_ATTRIBUTE_POSITION, "instancePosition");
+	glBindAttribLocation(program, GLYPH_INSTANCE_ATTRIBUTE_AXIS1, "instanceAxis1");
+	glBindAttribLocation(program, GLYPH_INSTANCE_ATTRIBUTE_AXIS2, "instanceAxis2");
+	glBindAttribLocation(program, GLYPH_INSTANCE_ATTRIBUTE_AXIS3, "instanceAxis3");
+	glBindAttribLocation(program, GLYPH_INSTANCE_ATTRIBUTE_COLOUR, "instanceColour");
+	glLinkProgram(program);
+	// shader is deleted with program
+	glDeleteShader(vertex_shader);
+	GLint linked = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	if (!linked)
+	{
+		display_message(WARNING_MESSAGE, "Glyph_instance_program_build.  "
+			"Failed to link program. Glyphs will be drawn individually.");
+		glDeleteProgram(program);
+		return false;
+	}
+	glyph_instance_program->light_enabled_location = glGetUniformLocation(program, "lightEnabled");
+	glyph_instance_program->use_colour_location = glGetUniformLocation(program, "useInstanceColour");
+	glyph_instance_program->program = program;
+	glyph_instance_program->failed = false;
+	return true;
+}
+
+/**
+ * Draw all primitives of a glyph surface once for each instance.
+ * Vertex buffer objects for surface must be enabled.
+ */
+static void draw_vertexBufferSurfaceInstanced(GT_object *surface, GLsizei instance_count)
+{
+	GT_surface_vertex_buffers *vb_surface = surface->primitive_lists->gt_surface_vertex_buffers;
+	struct Graphics_vertex_array *array = surface->vertex_array;
+	GLenum mode = GL_TRIANGLES;
+	if ((g_SHADED == vb_surface->surface_type) || (g_SHADED_TEXMAP == vb_surface->surface_type))
+	{
+		mode = GL_TRIANGLE_STRIP;
+	}
+	const bool wireframe_flag = (vb_surface->render_polygon_mode == CMZN_GRAPHICS_RENDER_POLYGON_MODE_WIREFRAME);
+	if (wireframe_flag)
+	{
+		glPushAttrib(GL_POLYGON_BIT);
+		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+	}
+	const unsigned int surface_count = array->get_number_of_vertices(
+		GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_START);
+	for (unsigned int surface_index = 0; surface_index < surface_count; ++surface_index)
+	{
+		int object_name = 0;
+		if ((array->get_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_OBJECT_ID,
+			surface_index, 1, &object_name)) && (object_name < 0))
+		{
+			continue;
+		}
+		if (GL_TRIANGLE_STRIP == mode)
+		{
+			if (!surface->index_vertex_buffer_object)
+				continue;
+			unsigned int number_of_strips = 0, strip_start = 0;
+			array->get_unsigned_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_NUMBER_OF_STRIPS,
+				surface_index, 1, &number_of_strips);
+			array->get_unsigned_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_STRIP_START,
+				surface_index, 1, &strip_start);
+			for (unsigned int i = 0; i < number_of_strips; ++i)
+			{
+				unsigned int points_per_strip = 0, index_start_for_strip = 0;
+				array->get_unsigned_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_STRIP_INDEX_START,
+					strip_start + i, 1, &index_start_for_strip);
+				array->get_unsigned_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_NUMBER_OF_POINTS_FOR_STRIP,
+					strip_start + i, 1, &points_per_strip);
+				glDrawElementsInstanced(mode, points_per_strip, GL_UNSIGNED_INT,
+					BUFFER_OFFSET(sizeof(GLuint)*index_start_for_strip), instance_count);
+			}
+		}
+		else
+		{
+			unsigned int index_start = 0, index_count = 0;
+			array->get_unsigned_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_START,
+				surface_index, 1, &index_start);
+			array->get_unsigned_integer_attribute(GRAPHICS_VERTEX_ARRAY_ATTRIBUTE_TYPE_ELEMENT_INDEX_COUNT,
+				surface_index, 1, &index_count);
+			glDrawArraysInstanced(mode, index_start, index_count, instance_count);
+		}
+	}
+	if (wireframe_flag)
+	{
+		glPopAttrib();
+	}
+}
+
+/**
+ * Draw all glyphs in glyph set with one instanced draw call per glyph surface
+ * strip, using the per-glyph transformations and colours compiled into its
+ * instance vertex buffer object. Labels are not drawn.
+ * Only valid for drawing all glyphs without picking or selection highlighting,
+ * and if the renderer has a glyph instance program for the current context.
+ * @param lighting_on  Current lighting state, updated if lighting is enabled.
+ * @return  True if glyphs were drawn, false if glyph set must be drawn by
+ * executing the glyph at each point.
+ */
+static bool draw_vertexBufferGlyphsetInstanced(GT_object *object, cmzn_material *material,
+	Render_graphics_opengl *renderer, bool &lighting_on)
+{
+	if ((!renderer->glyph_instance_program) ||
+		(0 == object->instance_count) || (!object->instance_vertex_buffer_object) ||
+		(material && (material->program || Graphical_material_get_texture(material))))
+	{
+		return false;
+	}
+	GT_object *glyph = object->primitive_lists->gt_glyphset_vertex_buffers->glyph;
+	if (!GT_object_glyph_can_be_instanced(glyph))
+	{
+		return false;
+	}
+	for (GT_object *item = glyph; item; item = item->nextobject)
+	{
+		if ((!item->position_vertex_buffer_object) || (!item->normal_vertex_buffer_object))
+		{
+			return false;
+		}
+	}
+	Glyph_instance_program *glyph_instance_program = renderer->glyph_instance_program;
+	if (!Glyph_instance_program_build(glyph_instance_program))
+	{
+		return false;
+	}
+	if (!lighting_on)
+	{
+		/* enable lighting for general glyphs */
+		glEnable(GL_LIGHTING);
+		lighting_on = true;
+	}
+	GLfloat light_enabled[MAXIMUM_NUMBER_OF_ACTIVE_LIGHTS];
+	for (int i = 0; i < MAXIMUM_NUMBER_OF_ACTIVE_LIGHTS; ++i)
+	{
+		light_enabled[i] = glIsEnabled(light_identifiers[i]) ? 1.0f : 0.0f;
+	}
+	GLboolean two_side = GL_FALSE;
+	glGetBooleanv(GL_LIGHT_MODEL_TWO_SIDE, &two_side);
+	glUseProgram(glyph_instance_program->program);
+	glUniform1fv(glyph_instance_program->light_enabled_location, MAXIMUM_NUMBER_OF_ACTIVE_LIGHTS, light_enabled);
+	glUniform1f(glyph_instance_program->use_colour_location,
+		GT_object_glyphset_has_data_colours(object) ? 1.0f : 0.0f);
+	if (two_side)
+	{
+		glEnable(GL_VERTEX_PROGRAM_TWO_SIDE);
+	}
+	const GLuint attributes[5] = { GLYPH_INSTANCE_ATTRIBUTE_POSITION, GLYPH_INSTANCE_ATTRIBUTE_AXIS1,
+		GLYPH_INSTANCE_ATTRIBUTE_AXIS2, GLYPH_INSTANCE_ATTRIBUTE_AXIS3, GLYPH_INSTANCE_ATTRIBUTE_COLOUR };
+	glBindBuffer(GL_ARRAY_BUFFER, object->instance_vertex_buffer_object);
+	for (int a = 0; a < 5; ++a)
+	{
+		glEnableVertexAttribArray(attributes[a]);
+		glVertexAttribPointer(attributes[a], (a < 4) ? 3 : 4, GL_FLOAT, GL_FALSE,
+			GLYPH_INSTANCE_VALUES_COUNT*sizeof(GLfloat), BUFFER_OFFSET(3*a*sizeof(GLfloat)));
+		glVertexAttribDivisor(attributes[a], 1);
+	}
+	for (GT_object *item = glyph; item; item = item->nextobject)
+	{
+		Graphics_object_enable_opengl_vertex_buffer_object(item, renderer);
+		draw_vertexBufferSurfaceInstanced(item, static_cast<GLsizei>(object->instance_count));
+		Graphics_object_disable_opengl_vertex_buffer_object(item, renderer);
+	}
+	for (int a = 0; a < 5; ++a)
+	{
+		glVertexAttribDivisor(attributes[a], 0);
+		glDisableVertexAttribArray(attributes[a]);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	if (two_side)
+	{
+		glDisable(GL_VERTEX_PROGRAM_TWO_SIDE);
+	}
+	glUseProgram(0);
+	return true;
+}
+#endif /* defined (GL_VERSION_3_3) */
+
 static int draw_vertexBufferPointset(gtObject *object,
 	cmzn_material *material, struct cmzn_spectrum *spectrum,
 	Render_graphics_opengl *renderer,
@@ -2401,6 +3095,14 @@ static int draw_vertexBufferGlyphset(gtObject *object,
 				{
 					render_data=spectrum_start_renderGL(spectrum,material,data_values_per_vertex);
 				}
+#if defined (GL_VERSION_3_3)
+				// draw all glyphs together where possible, leaving only labels to draw below
+				const bool glyphs_instanced = draw_all && (!renderer->picking) &&
+					(GRAPHICS_OBJECT_RENDERING_TYPE_VERTEX_BUFFER_OBJECT == rendering_type) &&
+					draw_vertexBufferGlyphsetInstanced(object, material, renderer, lighting_on);
+#else
+				const bool glyphs_instanced = false;
+#endif /* defined (GL_VERSION_3_3) */
 				// disable highlighting beneath glyph set level
 				renderer->push_highlight_functor();
 				for (nodeset_index = 0; nodeset_index < nodeset_count; nodeset_index++)
@@ -2616,7 +3318,7 @@ static int draw_vertexBufferGlyphset(gtObject *object,
 						{
 							name_selected=highlight_functor->query(object_name);
 						}
-						if (glyph)
+						if (glyph && !glyphs_instanced)
 						{
 							Graphics_object_glyph_labels_function glyph_labels_function =
 								Graphics_object_get_glyph_labels_function(glyph);
@@ -16,6 +16,7 @@
 #include "graphics/graphics_object_highlight.hpp"
 
 struct cmzn_graphics;
+struct Glyph_instance_program;
 
 class Render_graphics_opengl : public Render_graphics_compile_members
 {
@@ -40,6 +41,11 @@ public:
 	// use second pointer to save highlight_functor while it is disabled
 	GraphicsHighlightFunctor *highlight_functor, *saved_highlight_functor;
 
+	/** Shader program for drawing glyphs instanced in the current OpenGL
+	 * context, owned by the scene viewer. If not set, glyphs are always drawn
+	 * individually. */
+	Glyph_instance_program *glyph_instance_program;
+
 private:
 	// scale factor multiplying graphics render_line_width and render_point_size
 	// to get size in pixels. Set it so high resolution output has thick enough
@@ -67,6 +73,7 @@ public:
 		use_display_list(0),
 		highlight_functor(NULL),
 		saved_highlight_functor(NULL),
+		glyph_instance_program(nullptr),
 		point_unit_size_pixels(1.0),
 		next_light_no(0)
 	{
@@ -200,6 +207,18 @@ Render_graphics_opengl *Render_graphics_opengl_create_client_vertex_arrays_displ
  */
 Render_graphics_opengl *Render_graphics_opengl_create_vertex_buffer_object_renderer();
 
+/**
+ * Create store for the shader program drawing instanced glyphs in one OpenGL
+ * context. The program is built when first needed with the context current.
+ */
+Glyph_instance_program *Glyph_instance_program_create();
+
+/**
+ * Destroy the glyph instance program store and its shader program, if built.
+ * Must be called with its OpenGL context current.
+ */
+void Glyph_instance_program_destroy(Glyph_instance_program **glyph_instance_program_address);
+
 /***************************************************************************//**
  * Factory function to create a renderer that compiles objects into display lists
  * for rendering and uses vertex buffer objects when compiling primitives.
@@ -217,6 +236,20 @@ Render_graphics_opengl *Render_graphics_opengl_create_threejs_renderer(
 	int morphVertices, int morphColours, int morphNormals,
 	int numberOfFiles, char **file_names, int isInline);
 
+/**
+ * Factory function to create a renderer exporting the scene tree to binary glTF.
+ * @param quantised  If non-zero, output positions, normals and colours as
+ * normalized integers with KHR_mesh_quantization.
+ * @param outputStringRef  Reference to string to fill with the GLB file
+ * contents. Client must ensure this exists through the lifetime of the
+ * returned object.
+ */
+Render_graphics_opengl *Render_graphics_opengl_create_gltf_renderer(
+	int number_of_time_steps, double begin_time, double end_time,
+	enum cmzn_streaminformation_scene_io_data_type mode,
+	int morphVertices, int morphColours, int morphNormals, int quantised,
+	std::string& outputStringRef);
+
 /** Routine that uses the objects material and spectrum to convert
 * an array of data to corresponding colour data.
 */
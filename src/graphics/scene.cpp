@@ -10,6 +10,8 @@ FILE : scene.cpp
 
 #include <algorithm>
 #include <list>
+#include <mutex>
+#include <vector>
 #include <cstdlib>
 #include <cstdio>
 #include <cmath>
@@ -42,6 +44,7 @@ FILE : scene.cpp
 #include "general/matrix_vector.h"
 #include "general/message.h"
 #include "general/mystring.h"
+#include "general/thread_pool.hpp"
 #include "graphics/graphics.hpp"
 #include "graphics/graphics_module.hpp"
 #include "graphics/graphics_library.h"
@@ -178,6 +181,7 @@ cmzn_scene::cmzn_scene(cmzn_region *regionIn, cmzn_graphics_module *graphicsmodu
 	selectionChanged(false),
 	selectionnotifier_list(0),
 	editorCopy(false),
+	build_threads_count(1),
 	access_count(1)
 {
 }
@@ -1088,6 +1092,69 @@ int cmzn_scene_modify_graphics(struct cmzn_scene *scene,
 	return (return_code);
 }
 
+struct cmzn_scene_graphics_build_list_data
+{
+	cmzn_scenefilter *scenefilter;
+	std::vector<cmzn_graphics *> *graphicsList;
+};
+
+/**
+ * Adds graphics to the build list if it or its selection has changed and it is
+ * visible by the scene filter, if any.
+ * @param build_list_data_void  Pointer to cmzn_scene_graphics_build_list_data.
+ */
+static int cmzn_graphics_add_to_build_list(cmzn_graphics *graphics, void *build_list_data_void)
+{
+	cmzn_scene_graphics_build_list_data *build_list_data =
+		static_cast<cmzn_scene_graphics_build_list_data *>(build_list_data_void);
+	if (((graphics->graphics_changed) || (graphics->selected_graphics_changed)) &&
+		((!build_list_data->scenefilter) ||
+		cmzn_scenefilter_evaluate_graphics(build_list_data->scenefilter, graphics)))
+		build_list_data->graphicsList->push_back(graphics);
+	return 1;
+}
+
+/**
+ * Build graphics objects for the list of graphics from the same scene on
+ * multiple threads from the shared thread pool. Each worker has its own copy of
+ * the graphics to object data with its own field cache; objects shared between
+ * graphics are only used under a common lock. Messages are displayed in
+ * graphics order after all graphics are built, and the finished graphics
+ * objects are only compiled by the caller once all workers have finished.
+ * Elements of each graphics are converted serially by its worker.
+ * @param graphicsList  Changed, visible graphics to build.
+ * @param graphics_to_object_data  Template data for building; field cache is
+ * used by the calling thread.
+ * @param threadsCount  Maximum number of threads to use, > 1.
+ * @return  1 on success, 0 if any graphics failed to build.
+ */
+static int cmzn_scene_build_graphics_objects_threaded(std::vector<cmzn_graphics *>& graphicsList,
+	const cmzn_graphics_to_graphics_object_data& graphics_to_object_data, int threadsCount)
+{
+	const size_t graphicsCount = graphicsList.size();
+	const int workersCount = (static_cast<size_t>(threadsCount) < graphicsCount) ?
+		threadsCount : static_cast<int>(graphicsCount);
+	std::mutex buildMutex;
+	std::vector<cmzn_graphics_to_graphics_object_data> workerData(workersCount, graphics_to_object_data);
+	for (int w = 0; w < workersCount; ++w)
+	{
+		workerData[w].buildMutex = &buildMutex;
+		// nested pool jobs run serially, so don't try to share out elements
+		workerData[w].threadsCount = 1;
+		// calling thread uses the supplied field cache
+		if (w > 0)
+			workerData[w].field_cache = cmzn_fieldmodule_create_fieldcache(graphics_to_object_data.field_module);
+	}
+	const bool success = ThreadPool::getShared().executeChunks(workersCount, graphicsCount,
+		[&](int workerIndex, size_t g)
+		{
+			return 0 != cmzn_graphics_to_graphics_object_no_check_on_filter(graphicsList[g], &workerData[workerIndex]);
+		});
+	for (int w = 1; w < workersCount; ++w)
+		cmzn_fieldcache_destroy(&workerData[w].field_cache);
+	return (success) ? 1 : 0;
+}
+
 static int cmzn_scene_build_graphics_objects(
 	struct cmzn_scene *scene, Render_graphics_compile_members *renderer)
 {
@@ -1124,10 +1191,30 @@ static int cmzn_scene_build_graphics_objects(
 			for (int i = 0; i < MAXIMUM_ELEMENT_XI_DIMENSIONS; ++i)
 			{
 				graphics_to_object_data.top_level_number_in_xi[i] = 0;
+				graphics_to_object_data.top_level_minimum_number_in_xi[i] = 1;
 			}
-			return_code = FOR_EACH_OBJECT_IN_LIST(cmzn_graphics)(
-				cmzn_graphics_to_graphics_object, (void *) &graphics_to_object_data,
-				scene->list_of_graphics);
+			graphics_to_object_data.buildMutex = nullptr;
+			const int threadsCount = ThreadPool::resolveThreadsCount(scene->build_threads_count);
+			graphics_to_object_data.threadsCount = threadsCount;
+			graphics_to_object_data.vertexArray = nullptr;
+			graphics_to_object_data.streamlineElementLocator = nullptr;
+			graphics_to_object_data.lodGeometricError = 0.0;
+			graphics_to_object_data.lodNumberInXi = nullptr;
+			// get changed graphics to build, visible by scene filter
+			std::vector<cmzn_graphics *> buildGraphicsList;
+			if ((threadsCount > 1) && (!graphics_to_object_data.incrementalBuild))
+			{
+				cmzn_scene_graphics_build_list_data build_list_data = { graphics_to_object_data.scenefilter, &buildGraphicsList };
+				FOR_EACH_OBJECT_IN_LIST(cmzn_graphics)(cmzn_graphics_add_to_build_list,
+					(void *)&build_list_data, scene->list_of_graphics);
+			}
+			if (buildGraphicsList.size() > 1)
+				return_code = cmzn_scene_build_graphics_objects_threaded(buildGraphicsList,
+					graphics_to_object_data, threadsCount);
+			else
+				return_code = FOR_EACH_OBJECT_IN_LIST(cmzn_graphics)(
+					cmzn_graphics_to_graphics_object, (void *) &graphics_to_object_data,
+					scene->list_of_graphics);
 			cmzn_fieldcache_destroy(&graphics_to_object_data.field_cache);
 			cmzn_fieldmodule_end_change(graphics_to_object_data.field_module);
 			cmzn_fieldmodule_destroy(&graphics_to_object_data.field_module);
@@ -1399,6 +1486,19 @@ void cmzn_scene_font_change(struct cmzn_scene *scene,
 	}
 }
 
+int cmzn_scene_flag_graphics_for_compaction(cmzn_scene *scene)
+{
+	if (!scene)
+	{
+		display_message(ERROR_MESSAGE,
+			"cmzn_scene_flag_graphics_for_compaction.  Invalid argument(s)");
+		return CMZN_ERROR_ARGUMENT;
+	}
+	FOR_EACH_OBJECT_IN_LIST(cmzn_graphics)(
+		cmzn_graphics_flag_for_compaction, (void *)0, scene->list_of_graphics);
+	return CMZN_OK;
+}
+
 int cmzn_scene_compile_graphics(cmzn_scene *scene,
 	Render_graphics_compile_members *renderer, int force_rebuild)
 {
@@ -1653,6 +1753,23 @@ cmzn_graphics_id cmzn_scene_find_graphics_by_name(cmzn_scene_id scene,
 	return NULL;
 }
 
+int cmzn_scene_get_build_threads_count(cmzn_scene_id scene)
+{
+	if (scene)
+		return scene->build_threads_count;
+	return -1;
+}
+
+int cmzn_scene_set_build_threads_count(cmzn_scene_id scene, int threads_count)
+{
+	if ((scene) && (threads_count >= 0))
+	{
+		scene->build_threads_count = threads_count;
+		return CMZN_OK;
+	}
+	return CMZN_ERROR_ARGUMENT;
+}
+
 int cmzn_region_modify_scene(struct cmzn_region *region,
 	struct cmzn_graphics *graphics, int delete_flag, int position)
 {
@@ -3150,7 +3267,7 @@ PROTOTYPE_ENUMERATOR_STRING_FUNCTION(cmzn_streaminformation_scene_io_data_type)
 DEFINE_DEFAULT_ENUMERATOR_FUNCTIONS(cmzn_streaminformation_scene_io_data_type)
 
 int Scene_render_threejs(cmzn_scene_id scene,
-	cmzn_scenefilter_id scenefilter, const char *file_prefix,
+	cmzn_scenefilter_id scenefilter, const GraphicsObjectLodView *lodView, const char *file_prefix,
 	int number_of_time_steps, double begin_time, double end_time,
 	cmzn_streaminformation_scene_io_data_type export_mode,
 	int *number_of_entries, std::vector<std::string>& outputStringsRef,
@@ -3163,6 +3280,7 @@ int Scene_render_threejs(cmzn_scene_id scene,
 			file_prefix, number_of_time_steps, begin_time, end_time, export_mode, number_of_entries,
 			outputStringsRef, morphVertices, morphColours, morphNormals, numberOfFiles, file_names,
 			isInline);
+		renderer->setLodView(lodView);
 		renderer->Scene_compile(scene, scenefilter);
 		renderer->Scene_tree_execute(scene);
 		delete renderer;
@@ -3183,6 +3301,26 @@ int Scene_render_webgl(cmzn_scene_id scene,
 	return 1;
 }
 
+int Scene_render_gltf(cmzn_scene_id scene, cmzn_scenefilter_id scenefilter,
+	const GraphicsObjectLodView *lodView, int number_of_time_steps, double begin_time, double end_time,
+	cmzn_streaminformation_scene_io_data_type export_mode,
+	int morphVertices, int morphColours, int morphNormals, int quantised,
+	std::string& outputString)
+{
+	if (scene)
+	{
+		Render_graphics_opengl *renderer = Render_graphics_opengl_create_gltf_renderer(
+			number_of_time_steps, begin_time, end_time, export_mode,
+			morphVertices, morphColours, morphNormals, quantised, outputString);
+		renderer->setLodView(lodView);
+		renderer->Scene_compile(scene, scenefilter);
+		renderer->Scene_tree_execute(scene);
+		delete renderer;
+		return CMZN_OK;
+	}
+	return CMZN_ERROR_ARGUMENT;
+}
+
 struct Scene_get_number_of_graphics_data
 {
 	cmzn_scenefilter_id scenefilter;
@@ -26,6 +26,8 @@ FILE : scene.h
 #include "cmlibs/zinc/types/timenotifierid.h"
 #include "general/enumerator_private.hpp"
 
+struct GraphicsObjectLodView;
+
 typedef std::list<cmzn_selectionnotifier *> cmzn_selectionnotifier_list;
 
 typedef std::map<cmzn_field *, std::pair<cmzn_field *, int> > SceneCoordinateFieldWrapperMap;
@@ -70,6 +72,7 @@ struct cmzn_scene
 	bool selectionChanged;
 	cmzn_selectionnotifier_list *selectionnotifier_list;
 	bool editorCopy; // is this a temporary scene for Cmgui Scene editor?
+	int build_threads_count; // number of threads to build graphics objects with, 0 = all hardware threads
 	/* for accessing objects */
 	int access_count;
 
@@ -546,10 +549,12 @@ enum cmzn_streaminformation_scene_io_data_type
 char *cmzn_streaminformation_scene_io_data_type_enum_to_string(
 	enum cmzn_streaminformation_scene_io_data_type mode);
 
-/** @param outputStringsRef  Reference to vector of strings to fill with the output strings.
+/** @param lodView  If set, export levels of detail of graphics drawn in this
+ * view, otherwise the finest level.
+ * @param outputStringsRef  Reference to vector of strings to fill with the output strings.
  * Client must ensure this exists through the lifetime of the returned object. */
 int Scene_render_threejs(cmzn_scene_id scene,
-	cmzn_scenefilter_id scenefilter, const char *filename,
+	cmzn_scenefilter_id scenefilter, const GraphicsObjectLodView *lodView, const char *filename,
 	int number_of_time_steps, double begin_time, double end_time,
 	cmzn_streaminformation_scene_io_data_type export_mode,
 	int *number_of_entries, std::vector<std::string>& outputStringsRef,
@@ -559,6 +564,21 @@ int Scene_render_threejs(cmzn_scene_id scene,
 int Scene_render_webgl(cmzn_scene_id scene,
 	cmzn_scenefilter_id scenefilter, const char *name_prefix);
 
+/**
+ * Export scene tree to binary glTF 2.0.
+ * @param lodView  If set, export levels of detail of graphics drawn in this
+ * view, otherwise the finest level.
+ * @param quantised  If non-zero, output attributes as normalized integers
+ * with KHR_mesh_quantization.
+ * @param outputString  String to fill with GLB file contents.
+ * @return  Result OK on success, otherwise ERROR_ARGUMENT.
+ */
+int Scene_render_gltf(cmzn_scene_id scene, cmzn_scenefilter_id scenefilter,
+	const GraphicsObjectLodView *lodView, int number_of_time_steps, double begin_time, double end_time,
+	cmzn_streaminformation_scene_io_data_type export_mode,
+	int morphVertices, int morphColours, int morphNormals, int quantised,
+	std::string& outputString);
+
 int Scene_get_number_of_graphics_with_type_in_tree(
 	cmzn_scene_id scene, cmzn_scenefilter_id scenefilter, enum cmzn_graphics_type type);
 
@@ -583,6 +603,14 @@ int cmzn_scene_compile_scene(cmzn_scene *scene,
 int cmzn_scene_compile_graphics(cmzn_scene *scene,
 	Render_graphics_compile_members *renderer, int force_rebuild);
 
+/**
+ * Flag graphics in scene holding primitives released by partial rebuilds for
+ * full rebuild, so the next compile writes only valid primitives. Call before
+ * compiling for export.
+ * @return  CMZN_OK on success, otherwise CMZN_ERROR_ARGUMENT.
+ */
+int cmzn_scene_flag_graphics_for_compaction(cmzn_scene *scene);
+
 int execute_scene_exporter_output(struct cmzn_scene *scene,
 	Render_graphics_opengl *renderer);
 
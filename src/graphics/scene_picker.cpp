@@ -15,13 +15,15 @@
 #include "computed_field/computed_field_group.hpp"
 #include "finite_element/finite_element_region.h"
 #include "general/debug.h"
+#include "general/matrix_vector.h"
 #include "general/object.h"
+#include "graphics/graphics.hpp"
 #include "graphics/graphics_library.h"
+#include "graphics/graphics_object_pick_tree.hpp"
 #include "graphics/render_gl.h"
 #include "graphics/scene.hpp"
 #include "graphics/scene_picker.hpp"
 #include "graphics/scene_viewer.h"
-#include "graphics/scene.hpp"
 #include "interaction/interaction_volume.h"
 #include "mesh/nodeset.hpp"
 #include "mesh/nodeset_group.hpp"
@@ -72,6 +74,8 @@ void cmzn_scenepicker::updateViewerRectangle()
 		double viewport_bottom,viewport_height, viewport_left,viewport_width,
 			viewport_pixels_per_unit_x, viewport_pixels_per_unit_y;
 		int i, j, width, height;
+		// ensure matrices are for the current view, even if not yet rendered
+		Scene_viewer_update_transformation(scene_viewer);
 		for (i=0;i<4;i++)
 		{
 			for (j=0;j<4;j++)
@@ -115,16 +119,120 @@ int cmzn_scenepicker::getPickingVolumeCentre(double *coordinateValuesOut3)
 	return CMZN_ERROR_GENERAL;
 }
 
+void cmzn_scenepicker::addSceneHitRecords(cmzn_scene_id scene,
+	const double *worldPickingMatrix, std::vector<GLuint>& hitRecords)
+{
+	// local coordinates are transformed by scenes from top_scene down to this scene
+	double localPickingMatrix[16], transformationMatrix[16];
+	const int result = scene->getTotalTransformationMatrix(this->top_scene, transformationMatrix);
+	if (CMZN_OK == result)
+		multiply_matrix(4, 4, 4, const_cast<double *>(worldPickingMatrix), transformationMatrix, localPickingMatrix);
+	else if (CMZN_ERROR_NOT_FOUND == result)
+		std::copy(worldPickingMatrix, worldPickingMatrix + 16, localPickingMatrix);
+	else
+		return;
+	std::vector<GraphicsObjectPickTree::Hit> hits;
+	cmzn_graphics_id graphics = cmzn_scene_get_first_graphics(scene);
+	while (graphics)
+	{
+		GT_object *graphicsObject = graphics->graphics_object;
+		if ((graphicsObject) && ((0 == this->filter) ||
+			(cmzn_scenefilter_evaluate_graphics(this->filter, graphics))))
+		{
+			const double *pickingMatrix =
+				(CMZN_SCENECOORDINATESYSTEM_LOCAL == graphics->coordinate_system) ? localPickingMatrix :
+				(CMZN_SCENECOORDINATESYSTEM_WORLD == graphics->coordinate_system) ? worldPickingMatrix : 0;
+			// graphics in window-relative coordinates are not picked
+			if (pickingMatrix)
+			{
+				// names as loaded by OpenGL renderer: scene, graphics, number of linked
+				// graphics object if any, then names from the graphics object
+				const int linkedNamesCount = (GT_object_get_next_object(graphicsObject)) ? 1 : 0;
+				int objectNumber = 0;
+				for (GT_object *item = graphicsObject; item; item = GT_object_get_next_object(item), ++objectNumber)
+				{
+					const GraphicsObjectPickTree *pickTree = GT_object_get_pick_tree(item);
+					hits.clear();
+					pickTree->pick(pickingMatrix, hits);
+					const int namesCount = 2 + linkedNamesCount + pickTree->getNamesCount();
+					for (size_t h = 0; h < hits.size(); ++h)
+					{
+						const GraphicsObjectPickTree::Hit& hit = hits[h];
+						hitRecords.push_back(static_cast<GLuint>(namesCount));
+						// depths are scaled to integers from 0 to 2^32-1 as for OpenGL
+						hitRecords.push_back(static_cast<GLuint>(hit.nearDepth*4294967295.0));
+						hitRecords.push_back(static_cast<GLuint>(hit.farDepth*4294967295.0));
+						hitRecords.push_back(static_cast<GLuint>(scene->picking_name));
+						hitRecords.push_back(static_cast<GLuint>(graphics->position));
+						if (linkedNamesCount)
+							hitRecords.push_back(static_cast<GLuint>(objectNumber));
+						if (pickTree->getNamesCount() > 0)
+							hitRecords.push_back(static_cast<GLuint>(hit.objectName));
+						if (pickTree->getNamesCount() > 1)
+							hitRecords.push_back(static_cast<GLuint>(hit.vertexName));
+						++this->number_of_hits;
+					}
+				}
+			}
+		}
+		cmzn_graphics_id next_graphics = cmzn_scene_get_next_graphics(scene, graphics);
+		cmzn_graphics_destroy(&graphics);
+		graphics = next_graphics;
+	}
+	cmzn_region_id child_region = cmzn_region_get_first_child(scene->region);
+	while (child_region)
+	{
+		cmzn_scene_id child_scene = child_region->getScene();
+		if (child_scene)
+			this->addSceneHitRecords(child_scene, worldPickingMatrix, hitRecords);
+		cmzn_region_reaccess_next_sibling(&child_region);
+	}
+}
+
+int cmzn_scenepicker::pickObjectsWithoutOpenGL()
+{
+	// build any graphics not yet built; pick trees are cached with graphics objects
+	build_Scene(this->top_scene, this->filter);
+	double modelview_matrix[16], projection_matrix[16], picking_matrix[16];
+	Interaction_volume_get_modelview_matrix(this->interaction_volume, modelview_matrix);
+	Interaction_volume_get_projection_matrix(this->interaction_volume, projection_matrix);
+	multiply_matrix(4, 4, 4, projection_matrix, modelview_matrix, picking_matrix);
+	std::vector<GLuint> hitRecords;
+	this->number_of_hits = 0;
+	this->addSceneHitRecords(this->top_scene, picking_matrix, hitRecords);
+	this->select_buffer_size = static_cast<int>(hitRecords.size());
+	// always allocate select buffer so results are cached until reset
+	if (!ALLOCATE(this->select_buffer, GLuint, (0 < this->select_buffer_size) ? this->select_buffer_size : 1))
+	{
+		display_message(ERROR_MESSAGE, "Scenepicker pickObjects.  Failed to allocate hit records");
+		this->reset();
+		return CMZN_ERROR_MEMORY;
+	}
+	std::copy(hitRecords.begin(), hitRecords.end(), this->select_buffer);
+	return CMZN_OK;
+}
+
+/* With a current OpenGL context all graphics are picked with selection mode,
+ * exactly as drawn. Otherwise graphics in local and world coordinates are
+ * picked from trees of their primitives, and window-relative graphics are not
+ * picked. */
 int cmzn_scenepicker::pickObjects()
 {
-	double modelview_matrix[16],projection_matrix[16];
-	GLdouble opengl_modelview_matrix[16],opengl_projection_matrix[16];
-	int i, j, return_code = CMZN_ERROR_GENERAL;
 	updateViewerRectangle();
 	if (select_buffer != NULL)
 		return CMZN_OK;
-	if (!has_current_context())
+	if (!(top_scene && interaction_volume))
 		return CMZN_ERROR_GENERAL;
+	if (has_current_context())
+		return this->pickObjectsOpenGL();
+	return this->pickObjectsWithoutOpenGL();
+}
+
+int cmzn_scenepicker::pickObjectsOpenGL()
+{
+	double modelview_matrix[16],projection_matrix[16];
+	GLdouble opengl_modelview_matrix[16],opengl_projection_matrix[16];
+	int i, j, return_code = CMZN_ERROR_GENERAL;
 	if (top_scene&&interaction_volume)
 	{
 		Render_graphics_opengl *renderer = Render_graphics_opengl_create_glbeginend_renderer();
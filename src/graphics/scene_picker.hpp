@@ -8,6 +8,7 @@
 #define SCENE_PICKER_HPP
 
 #include <map>
+#include <vector>
 #include "cmlibs/zinc/scenepicker.h"
 #include "cmlibs/zinc/types/graphicsid.h"
 #include "cmlibs/zinc/types/scenefilterid.h"
@@ -42,6 +43,23 @@ private:
 
 	void updateViewerRectangle();
 
+	/** Append hit records for graphics in scene and its child scenes, in the
+	 * format of OpenGL selection buffer records, from the pick trees of their
+	 * graphics objects.
+	 * @param worldPickingMatrix  Row-major projection x modelview matrix of
+	 * interaction volume. Graphics in window-relative coordinate systems are
+	 * not picked. */
+	void addSceneHitRecords(cmzn_scene_id scene, const double *worldPickingMatrix,
+		std::vector<GLuint>& hitRecords);
+
+	/** Pick graphics in world and local coordinates by finding intersections
+	 * of their primitives with the interaction volume, without OpenGL. Used
+	 * when there is no current OpenGL context. */
+	int pickObjectsWithoutOpenGL();
+
+	/** Pick all graphics with OpenGL selection mode; requires current context. */
+	int pickObjectsOpenGL();
+
 	int pickObjects();
 
 	void reset();
@@ -48,6 +48,7 @@ November 97 Created from rendering part of Drawing.
 #include "general/message.h"
 #include "graphics/colour.h"
 #include "graphics/graphics_library.h"
+#include "graphics/graphics_object_lod.hpp"
 #include "graphics/light.hpp"
 #include "graphics/scene.hpp"
 #include "graphics/scenefilter.hpp"
@@ -784,6 +785,68 @@ DESCRIPTION :
 	return (return_code);
 } /* Scene_viewer_render_background_texture */
 
+/**
+ * Fill column-major matrix with parallel projection as for glOrtho.
+ */
+static void Scene_viewer_ortho_matrix(double left, double right, double bottom,
+	double top, double near_plane, double far_plane, double *matrix)
+{
+	for (int i = 0; i < 16; ++i)
+		matrix[i] = 0.0;
+	matrix[0] = 2.0/(right - left);
+	matrix[5] = 2.0/(top - bottom);
+	matrix[10] = -2.0/(far_plane - near_plane);
+	matrix[12] = -(right + left)/(right - left);
+	matrix[13] = -(top + bottom)/(top - bottom);
+	matrix[14] = -(far_plane + near_plane)/(far_plane - near_plane);
+	matrix[15] = 1.0;
+}
+
+/**
+ * Fill column-major matrix with perspective projection as for glFrustum.
+ */
+static void Scene_viewer_frustum_matrix(double left, double right, double bottom,
+	double top, double near_plane, double far_plane, double *matrix)
+{
+	for (int i = 0; i < 16; ++i)
+		matrix[i] = 0.0;
+	matrix[0] = 2.0*near_plane/(right - left);
+	matrix[5] = 2.0*near_plane/(top - bottom);
+	matrix[8] = (right + left)/(right - left);
+	matrix[9] = (top + bottom)/(top - bottom);
+	matrix[10] = -(far_plane + near_plane)/(far_plane - near_plane);
+	matrix[11] = -1.0;
+	matrix[14] = -2.0*far_plane*near_plane/(far_plane - near_plane);
+}
+
+/**
+ * Fill column-major matrix with viewing transformation as for gluLookAt.
+ */
+static void Scene_viewer_look_at_matrix(double eyex, double eyey, double eyez,
+	double lookatx, double lookaty, double lookatz, double upx, double upy,
+	double upz, double *matrix)
+{
+	double f[3] = { lookatx - eyex, lookaty - eyey, lookatz - eyez };
+	double up[3] = { upx, upy, upz };
+	double s[3], u[3];
+	normalize3(f);
+	cross_product3(f, up, s);
+	normalize3(s);
+	cross_product3(s, f, u);
+	const double eye[3] = { eyex, eyey, eyez };
+	for (int i = 0; i < 3; ++i)
+	{
+		matrix[i*4] = s[i];
+		matrix[i*4 + 1] = u[i];
+		matrix[i*4 + 2] = -f[i];
+		matrix[i*4 + 3] = 0.0;
+	}
+	matrix[12] = -(s[0]*eye[0] + s[1]*eye[1] + s[2]*eye[2]);
+	matrix[13] = -(u[0]*eye[0] + u[1]*eye[1] + u[2]*eye[2]);
+	matrix[14] = f[0]*eye[0] + f[1]*eye[1] + f[2]*eye[2];
+	matrix[15] = 1.0;
+}
+
 static int Scene_viewer_calculate_transformation(
 	struct Scene_viewer *scene_viewer, int viewport_width, int viewport_height)
 /*******************************************************************************
@@ -805,8 +868,8 @@ are made as large as can fit in the viewport size without a shape change.
 As a result, the projection_matrix in both relative and absolute viewport modes
 is not the projection that will fill the entire viewport/window - this function
 calculates the window_projection_matrix for this purpose.
-Note that this function makes changes to the OpenGL rendering matrices in some
-modes, so push/pop them if you want them preserved.
+Matrices are calculated without OpenGL so they are available for picking
+without a rendering context.
 ==============================================================================*/
 {
 	double dx,dy,dz,postmultiply_matrix[16],factor;
@@ -820,15 +883,14 @@ modes, so push/pop them if you want them preserved.
 		/* 1. calculate and store projection_matrix - no need in CUSTOM mode */
 		if (SCENE_VIEWER_CUSTOM != scene_viewer->projection_mode)
 		{
-			glMatrixMode(GL_PROJECTION);
-			glLoadIdentity();
 			switch (scene_viewer->projection_mode)
 			{
 				case SCENE_VIEWER_PARALLEL:
 				{
-					glOrtho(scene_viewer->left, scene_viewer->right,
+					Scene_viewer_ortho_matrix(scene_viewer->left, scene_viewer->right,
 						scene_viewer->bottom, scene_viewer->top,
-						scene_viewer->near_plane, scene_viewer->far_plane);
+						scene_viewer->near_plane, scene_viewer->far_plane,
+						scene_viewer->projection_matrix);
 				} break;
 				case SCENE_VIEWER_PERSPECTIVE:
 				{
@@ -838,17 +900,16 @@ modes, so push/pop them if you want them preserved.
 					dz = scene_viewer->eyez-scene_viewer->lookatz;
 					factor = scene_viewer->near_plane/sqrt(dx*dx+dy*dy+dz*dz);
 					/* perspective projection */
-
-					glFrustum(scene_viewer->left*factor, scene_viewer->right*factor,
+					Scene_viewer_frustum_matrix(scene_viewer->left*factor, scene_viewer->right*factor,
 						scene_viewer->bottom*factor, scene_viewer->top*factor,
-						scene_viewer->near_plane, scene_viewer->far_plane);
+						scene_viewer->near_plane, scene_viewer->far_plane,
+						scene_viewer->projection_matrix);
 				} break;
 				case SCENE_VIEWER_CUSTOM:
 				{
 					/* Do nothing */
 				} break;
 			}
-			glGetDoublev(GL_PROJECTION_MATRIX,scene_viewer->projection_matrix);
 		}
 
 		/* 2. calculate and store window_projection_matrix - all modes */
@@ -926,13 +987,11 @@ modes, so push/pop them if you want them preserved.
 		/* 3. Calculate and store modelview_matrix - no need in CUSTOM mode */
 		if (SCENE_VIEWER_CUSTOM != scene_viewer->projection_mode)
 		{
-			glMatrixMode(GL_MODELVIEW);
-			glLoadIdentity();
-			gluLookAt(scene_viewer->eyex,scene_viewer->eyey,
+			Scene_viewer_look_at_matrix(scene_viewer->eyex,scene_viewer->eyey,
 				scene_viewer->eyez,scene_viewer->lookatx,
 				scene_viewer->lookaty,scene_viewer->lookatz,
-				scene_viewer->upx,scene_viewer->upy,scene_viewer->upz);
-			glGetDoublev(GL_MODELVIEW_MATRIX,scene_viewer->modelview_matrix);
+				scene_viewer->upx,scene_viewer->upy,scene_viewer->upz,
+				scene_viewer->modelview_matrix);
 		}
 	}
 	else
@@ -946,6 +1005,35 @@ modes, so push/pop them if you want them preserved.
 	return (return_code);
 } /* Scene_viewer_calculate_transformation */
 
+int Scene_viewer_update_transformation(struct Scene_viewer *scene_viewer)
+{
+	if (!scene_viewer)
+		return CMZN_ERROR_ARGUMENT;
+	const int width = Graphics_buffer_get_width(scene_viewer->graphics_buffer);
+	const int height = Graphics_buffer_get_height(scene_viewer->graphics_buffer);
+	if ((width <= 0) || (height <= 0))
+		return CMZN_ERROR_GENERAL;
+	if (!Scene_viewer_calculate_transformation(scene_viewer, width, height))
+		return CMZN_ERROR_GENERAL;
+	return CMZN_OK;
+}
+
+int Scene_viewer_get_lod_view(struct Scene_viewer *scene_viewer, GraphicsObjectLodView& view)
+{
+	const int result = Scene_viewer_update_transformation(scene_viewer);
+	if (CMZN_OK != result)
+		return result;
+	// matrices are stored column-major as loaded into OpenGL
+	for (int i = 0; i < 16; ++i)
+	{
+		view.modelviewMatrix[i] = scene_viewer->modelview_matrix[i];
+		view.projectionMatrix[i] = scene_viewer->window_projection_matrix[i];
+	}
+	view.viewportWidth = static_cast<double>(Graphics_buffer_get_width(scene_viewer->graphics_buffer));
+	view.viewportHeight = static_cast<double>(Graphics_buffer_get_height(scene_viewer->graphics_buffer));
+	return CMZN_OK;
+}
+
 Render_graphics_opengl *Scene_viewer_rendering_data_get_renderer(
 	Scene_viewer_rendering_data *rendering_data)
 {
@@ -2047,6 +2135,11 @@ Scene_viewer_render_scene_in_viewport to access this function.
 			 */
 			rendering_data.renderer =
 				Render_graphics_opengl_create_vertex_buffer_object_renderer();
+			if (!scene_viewer->glyph_instance_program)
+			{
+				scene_viewer->glyph_instance_program = Glyph_instance_program_create();
+			}
+			rendering_data.renderer->glyph_instance_program = scene_viewer->glyph_instance_program;
 //#if defined (GL_VERSION_1_5)
 //			/* Check for GL_ARB_vertex_buffer_object includes whether OpenGL version is 1.1 or
 //			 * greater and we actually use the OpenGL 1.5 interface and just use this
@@ -3053,6 +3146,7 @@ struct Scene_viewer *CREATE(Scene_viewer)(struct Graphics_buffer *graphics_buffe
 				(scene_viewer->image_texture).scene_viewer = scene_viewer;
 				scene_viewer->order_independent_transparency_data =
 					(struct cmzn_sceneviewer_transparency_order_independent_data *)NULL;
+				scene_viewer->glyph_instance_program = nullptr;
 
 				/* set projection matrices to identity */
 				for (i=0;i<16;i++)
@@ -3180,6 +3274,10 @@ Closes the scene_viewer and disposes of the scene_viewer data structure.
 			order_independent_finalise(
 				&scene_viewer->order_independent_transparency_data);
 		}
+		if (scene_viewer->glyph_instance_program)
+		{
+			Glyph_instance_program_destroy(&scene_viewer->glyph_instance_program);
+		}
 		/* must destroy the widget */
 		DEACCESS(Graphics_buffer)(&scene_viewer->graphics_buffer);
 		if (scene_viewer->pixel_data)
@@ -35,6 +35,7 @@ translating and zooming with mouse button press and motion events.
 #include <list>
 
 struct Graphics_buffer;
+struct GraphicsObjectLodView;
 #define Graphics_buffer_input cmzn_sceneviewerinput
 #define Graphics_buffer_input_event_type cmzn_sceneviewerinput_event_type
 
@@ -415,6 +416,8 @@ struct cmzn_sceneviewer
 	/* Special persistent data for order independent transparency */
 	struct cmzn_sceneviewer_transparency_order_independent_data
 	   *order_independent_transparency_data;
+	/* Shader program for drawing glyphs instanced in this viewer's context */
+	struct Glyph_instance_program *glyph_instance_program;
 	/* The connection to the systems user interface system */
 	//-- struct User_interface *user_interface;
 #if defined (WIN32_SYSTEM)
@@ -1052,6 +1055,22 @@ DESCRIPTION :
 Returns the width and height of the Scene_viewers drawing area.
 ==============================================================================*/
 
+/**
+ * Recalculate the projection, window projection and modelview matrices for the
+ * current view and viewport size, without rendering or needing OpenGL.
+ * @return  CMZN_OK on success, CMZN_ERROR_GENERAL if viewport has no size,
+ * otherwise any other error code.
+ */
+int Scene_viewer_update_transformation(struct Scene_viewer *scene_viewer);
+
+/**
+ * Get the current view for choosing levels of detail of graphics as drawn in
+ * the scene viewer, without needing OpenGL.
+ * @return  CMZN_OK on success, CMZN_ERROR_GENERAL if viewport has no size,
+ * otherwise any other error code.
+ */
+int Scene_viewer_get_lod_view(struct Scene_viewer *scene_viewer, GraphicsObjectLodView& view);
+
 int Scene_viewer_get_window_projection_matrix(struct Scene_viewer *scene_viewer,
 	double window_projection_matrix[16]);
 /*******************************************************************************
@@ -270,6 +270,8 @@ struct cmzn_tessellation
 	int *minimum_divisions;
 	int refinement_factors_size;
 	int *refinement_factors;
+	// maximum screen error in pixels for adaptive level of detail, or 0 if fixed
+	double pixelErrorTolerance;
 	cmzn_tessellation_change_detail changeDetail;
 	bool is_managed_flag;
 	int access_count;
@@ -285,6 +287,7 @@ protected:
 		minimum_divisions(NULL),
 		refinement_factors_size(1),
 		refinement_factors(NULL),
+		pixelErrorTolerance(0.0),
 		is_managed_flag(false),
 		access_count(1)
 	{
@@ -323,6 +326,7 @@ public:
 		this->set_minimum_divisions(source.minimum_divisions_size, source.minimum_divisions);
 		this->set_refinement_factors(source.refinement_factors_size, source.refinement_factors);
 		this->setCircleDivisions(source.circleDivisions);
+		this->setPixelErrorTolerance(source.pixelErrorTolerance);
 		return *this;
 	}
 
@@ -351,6 +355,25 @@ public:
 		return (inCircleDivisions == this->circleDivisions) ? CMZN_OK : CMZN_ERROR_ARGUMENT;
 	}
 
+	double getPixelErrorTolerance() const
+	{
+		return this->pixelErrorTolerance;
+	}
+
+	int setPixelErrorTolerance(double inPixelErrorTolerance)
+	{
+		if (!(inPixelErrorTolerance >= 0.0))
+			return CMZN_ERROR_ARGUMENT;
+		if (inPixelErrorTolerance != this->pixelErrorTolerance)
+		{
+			this->pixelErrorTolerance = inPixelErrorTolerance;
+			this->changeDetail.setElementDivisionsChanged();
+			MANAGED_OBJECT_CHANGE(cmzn_tessellation)(this,
+				MANAGER_CHANGE_OBJECT_NOT_IDENTIFIER(cmzn_tessellation));
+		}
+		return CMZN_OK;
+	}
+
 	/** get minimum divisions for a particular dimension >= 0 */
 	inline int get_minimum_divisions_value(int dimension)
 	{
@@ -463,7 +486,12 @@ public:
 		{
 			display_message(INFORMATION_MESSAGE, "1");
 		}
-		display_message(INFORMATION_MESSAGE, "\" circle_divisions %d;\n", circleDivisions);
+		display_message(INFORMATION_MESSAGE, "\" circle_divisions %d", circleDivisions);
+		if (0.0 < pixelErrorTolerance)
+		{
+			display_message(INFORMATION_MESSAGE, " pixel_error_tolerance %g", pixelErrorTolerance);
+		}
+		display_message(INFORMATION_MESSAGE, ";\n");
 	}
 
 	inline cmzn_tessellation *access()
@@ -1115,6 +1143,22 @@ int cmzn_tessellation_set_circle_divisions(
 	return CMZN_ERROR_ARGUMENT;
 }
 
+double cmzn_tessellation_get_pixel_error_tolerance(
+	cmzn_tessellation_id tessellation)
+{
+	if (tessellation)
+		return tessellation->getPixelErrorTolerance();
+	return 0.0;
+}
+
+int cmzn_tessellation_set_pixel_error_tolerance(
+	cmzn_tessellation_id tessellation, double pixelErrorTolerance)
+{
+	if (tessellation)
+		return tessellation->setPixelErrorTolerance(pixelErrorTolerance);
+	return CMZN_ERROR_ARGUMENT;
+}
+
 int cmzn_tessellation_get_minimum_divisions(cmzn_tessellation_id tessellation,
 	int valuesCount, int *valuesOut)
 {
@@ -1226,7 +1270,8 @@ cmzn_tessellation_id cmzn_tessellationmodule_find_or_create_fixed_tessellation(
 			// don't want to use default_points tessellation
 			if (tempTessellation == default_points_tessellation)
 				continue;
-			bool match = (tempTessellation->circleDivisions == useCircleDivisions);
+			bool match = (tempTessellation->circleDivisions == useCircleDivisions) &&
+				(0.0 == tempTessellation->pixelErrorTolerance);
 			if (match)
 			{
 				int count = useElementDivisionsCount;
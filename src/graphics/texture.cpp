@@ -4972,6 +4972,73 @@ is constant from the half texel location to the edge.
 	return (return_code);
 } /* Texture_get_pixel_values */
 
+int Texture_get_texel_values(struct Texture *texture, const int *start,
+	const int *counts, double *values)
+{
+	if (!((texture) && (texture->image) && (values)))
+	{
+		display_message(ERROR_MESSAGE, "Texture_get_texel_values.  Invalid arguments");
+		return 0;
+	}
+	const int original_sizes[3] = { texture->original_width_texels,
+		texture->original_height_texels, texture->original_depth_texels };
+	int region_start[3] = { 0, 0, 0 };
+	int region_counts[3] = { original_sizes[0], original_sizes[1], original_sizes[2] };
+	if (start && counts)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			if ((start[i] < 0) || (counts[i] < 1) || (start[i] + counts[i] > original_sizes[i]))
+			{
+				display_message(ERROR_MESSAGE, "Texture_get_texel_values.  Region outside image");
+				return 0;
+			}
+			region_start[i] = start[i];
+			region_counts[i] = counts[i];
+		}
+	}
+	const int number_of_components =
+		Texture_storage_type_get_number_of_components(texture->storage);
+	const int number_of_bytes_per_component = texture->number_of_bytes_per_component;
+	const int bytes_per_pixel = number_of_components*number_of_bytes_per_component;
+	const long int row_width_bytes =
+		((long int)(texture->width_texels*bytes_per_pixel + 3)/4)*4;
+	const double component_max = (2 == number_of_bytes_per_component) ? 65535.0 : 255.0;
+	const int row_values_count = region_counts[0]*number_of_components;
+	double *value = values;
+	for (int z = region_start[2]; z < region_start[2] + region_counts[2]; ++z)
+	{
+		for (int y = region_start[1]; y < region_start[1] + region_counts[1]; ++y)
+		{
+			const unsigned char *pixel_ptr = texture->image +
+				((long int)z*texture->height_texels + y)*row_width_bytes +
+				(long int)region_start[0]*bytes_per_pixel;
+			if (2 == number_of_bytes_per_component)
+			{
+				for (int i = 0; i < row_values_count; ++i)
+				{
+#if (1234==BYTE_ORDER)
+					const unsigned short short_value =
+						(((unsigned short)(*(pixel_ptr + 1))) << 8) + (*pixel_ptr);
+#else /* (1234==BYTE_ORDER) */
+					const unsigned short short_value =
+						(((unsigned short)(*pixel_ptr)) << 8) + (*(pixel_ptr + 1));
+#endif /* (1234==BYTE_ORDER) */
+					value[i] = (double)short_value / component_max;
+					pixel_ptr += 2;
+				}
+			}
+			else
+			{
+				for (int i = 0; i < row_values_count; ++i)
+					value[i] = (double)pixel_ptr[i] / component_max;
+			}
+			value += row_values_count;
+		}
+	}
+	return 1;
+}
+
 const char *Texture_get_image_file_name(struct Texture *texture)
 /*******************************************************************************
 LAST MODIFIED : 8 February 2002
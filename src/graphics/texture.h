@@ -502,6 +502,20 @@ interpolated or not.  When closer than half a texel to a boundary the colour
 is constant from the half texel location to the edge. 
 ==============================================================================*/
 
+/**
+ * Get the values of texels in a region of the original image, scaled to the
+ * range [0,1] as for Texture_get_pixel_values sampled at texel centres.
+ * @param start, counts  Optional first texel index and number of texels in
+ * x, y and z of the region, or NULL for all of the original image.
+ * @param values  Array to receive number of components values for each texel,
+ * x index varying fastest, then y, then z; size at least number of components
+ * x number of texels in region.
+ * @return  1 on success, 0 if no image, region outside image or invalid
+ * arguments.
+ */
+int Texture_get_texel_values(struct Texture *texture, const int *start,
+	const int *counts, double *values);
+
 const char *Texture_get_image_file_name(struct Texture *texture);
 /*******************************************************************************
 LAST MODIFIED : 8 February 2002
@@ -45,6 +45,12 @@ public:
 	{
 	}
 
+	/* structuring element radius */
+	virtual int get_tile_margin()
+	{
+		return radius;
+	}
+
 private:
 	virtual void create_functor();
 
@@ -45,6 +45,12 @@ public:
 	{
 	};
 
+	/* derivative operator needs at most order pixels either side */
+	virtual int get_tile_margin()
+	{
+		return order;
+	}
+
 private:
 	virtual void create_functor();
 
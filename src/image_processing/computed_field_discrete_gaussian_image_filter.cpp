@@ -74,6 +74,12 @@ public:
 		return CMZN_OK;
 	}
 
+	/* kernel is truncated to maximum width */
+	virtual int get_tile_margin()
+	{
+		return maxKernelWidth;
+	}
+
 private:
 	virtual void create_functor();
 
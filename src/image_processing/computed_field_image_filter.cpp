@@ -13,11 +13,23 @@ Class used for wrapping itk filters
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 #include "cmlibs/zinc/fieldimageprocessing.h"
 #include "computed_field/computed_field.h"
+#include "computed_field/computed_field_image.h"
 #include "computed_field/computed_field_private.hpp"
+#include "computed_field/field_cache.hpp"
+#include "finite_element/finite_element_mesh.hpp"
 #include "image_processing/computed_field_image_filter.h"
 #include "general/debug.h"
 #include "general/mystring.h"
 #include "general/message.h"
+#include "general/thread_pool.hpp"
+#include "region/cmiss_region.hpp"
+
+namespace {
+
+// Number of pixels of source field input evaluated per chunk of work, in whole rows
+const int imageFilterPixelsPerChunk = 4096;
+
+}
 
 namespace CMZN {
 int computed_field_image_filter::evaluate(cmzn_fieldcache& cache, FieldValueCache& inValueCache)
@@ -26,4 +38,174 @@ int computed_field_image_filter::evaluate(cmzn_fieldcache& cache, FieldValueCach
 	return functor->update_and_evaluate_filter(cache, valueCache);
 }
 
+int computed_field_image_filter::get_location_pixel_index(cmzn_fieldcache& cache, int *index)
+{
+	const Field_location_element_xi *element_xi_location = cache.get_location_element_xi();
+	const Field_location_field_values *coordinate_location =
+		(element_xi_location) ? nullptr : cache.get_location_field_values();
+	const FE_value *xi = (element_xi_location) ? element_xi_location->get_xi() :
+		((coordinate_location) ? coordinate_location->get_values() : nullptr);
+	if ((!xi) || (!sizes))
+		return 0;
+	for (int i = 0; i < dimension; ++i)
+	{
+		if (xi[i] < 0.0)
+			index[i] = 0;
+		else if (xi[i] >= 1.0)
+			index[i] = sizes[i] - 1;
+		else
+			index[i] = (int)(xi[i]*(FE_value)sizes[i]);
+	}
+	return 1;
+}
+
+int computed_field_image_filter::evaluate_source_pixel_values(cmzn_fieldcache& cache,
+	const int *region_start, const int *region_sizes, const PixelValuesSetter& setSourceValues)
+{
+	const Field_location_element_xi *element_xi_location = cache.get_location_element_xi();
+	const Field_location_field_values *coordinate_location =
+		(element_xi_location) ? nullptr : cache.get_location_field_values();
+	if (!((element_xi_location) || (coordinate_location)) || (dimension < 1) || (dimension > 3) ||
+		(!sizes) || (!region_start) || (!region_sizes))
+		return 0;
+	cmzn_element *element = (element_xi_location) ? element_xi_location->get_element() : nullptr;
+	cmzn_field *reference_field = (coordinate_location) ? coordinate_location->get_field() : nullptr;
+	cmzn_field *sourceField = this->getSourceField(0);
+	const int sourceComponents = sourceField->number_of_components;
+	const int rowSize = region_sizes[0];
+	int rowsCount = 1;
+	for (int i = 1; i < dimension; ++i)
+		rowsCount *= region_sizes[i];
+	if ((!element) || (element->getDimension() >= dimension))
+	{
+		// image fields sampled at their texel centres are read directly from the
+		// texture a row at a time; only fails for the first row if not supported
+		std::vector<ZnReal> rowValues(static_cast<size_t>(rowSize)*sourceComponents);
+		int row_start[3] = { region_start[0], 0, 0 };
+		const int row_sizes[3] = { rowSize, 1, 1 };
+		int row = 0;
+		for (; row < rowsCount; ++row)
+		{
+			if (dimension > 1)
+				row_start[1] = region_start[1] + row % region_sizes[1];
+			if (dimension > 2)
+				row_start[2] = region_start[2] + row / region_sizes[1];
+			if (!Computed_field_image_get_texel_centre_values(sourceField, reference_field,
+				dimension, sizes, row_start, row_sizes, rowValues.data()))
+				break;
+			setSourceValues(static_cast<size_t>(row)*rowSize, rowSize, rowValues.data());
+		}
+		if (row == rowsCount)
+			return 1;
+		if (row > 0)
+			return 0;
+	}
+	cmzn_region *region = this->field->getRegion();
+	// fields are only safe to evaluate from multiple threads while region is frozen
+	const int threadsCount = (region->isFrozen()) ? ThreadPool::resolveThreadsCount(0) : 1;
+	const int rowsPerChunk = (rowSize < imageFilterPixelsPerChunk) ? (imageFilterPixelsPerChunk/rowSize) : 1;
+	const int chunksCount = (rowsCount + rowsPerChunk - 1)/rowsPerChunk;
+	const int workersCount = (threadsCount < chunksCount) ? threadsCount : chunksCount;
+	// work with private field caches to avoid stomping current location
+	std::vector<cmzn_fieldcache *> workerCaches(workersCount, nullptr);
+	int return_code = 1;
+	for (int w = 0; w < workersCount; ++w)
+	{
+		workerCaches[w] = cmzn_fieldcache::create(region);
+		if (!workerCaches[w])
+		{
+			return_code = 0;
+			break;
+		}
+		workerCaches[w]->setTime(cache.getTime());
+	}
+	// evaluate source field at centres of pixels in rows of chunk c
+	auto evaluateChunk = [&](int workerIndex, int c) -> int
+	{
+		cmzn_fieldcache& fieldcache = *(workerCaches[workerIndex]);
+		FE_value pixel_xi[3] = { 0.0, 0.0, 0.0 };
+		const int rowEnd = ((c + 1)*rowsPerChunk < rowsCount) ? (c + 1)*rowsPerChunk : rowsCount;
+		for (int row = c*rowsPerChunk; row < rowEnd; ++row)
+		{
+			if (dimension > 1)
+				pixel_xi[1] = ((ZnReal)(region_start[1] + row % region_sizes[1]) + 0.5)/(ZnReal)sizes[1];
+			if (dimension > 2)
+				pixel_xi[2] = ((ZnReal)(region_start[2] + row / region_sizes[1]) + 0.5)/(ZnReal)sizes[2];
+			const size_t rowPixelIndex = static_cast<size_t>(row)*rowSize;
+			for (int i = 0; i < rowSize; ++i)
+			{
+				pixel_xi[0] = ((ZnReal)(region_start[0] + i) + 0.5)/(ZnReal)sizes[0];
+				if (element)
+					fieldcache.setMeshLocation(element, pixel_xi);
+				else
+					fieldcache.setFieldReal(reference_field, dimension, pixel_xi);
+				const RealFieldValueCache *valueCache = RealFieldValueCache::cast(sourceField->evaluate(fieldcache));
+				if (!valueCache)
+					return 0;
+				setSourceValues(rowPixelIndex + i, 1, valueCache->values);
+			}
+		}
+		return 1;
+	};
+	if ((return_code) && (workersCount == 1))
+	{
+		for (int c = 0; (c < chunksCount) && (return_code); ++c)
+			return_code = evaluateChunk(0, c);
+	}
+	else if (return_code)
+	{
+		// evaluate first chunk in this thread so source images and other objects
+		// created on first evaluation exist before workers start
+		return_code = evaluateChunk(0, 0);
+		if ((return_code) && (!ThreadPool::getShared().executeChunks(workersCount,
+			static_cast<size_t>(chunksCount - 1), [&](int workerIndex, size_t c)
+			{
+				return 0 != evaluateChunk(workerIndex, static_cast<int>(c) + 1);
+			})))
+			return_code = 0;
+	}
+	for (int w = 0; w < workersCount; ++w)
+	{
+		if (workerCaches[w])
+			cmzn_fieldcache::deaccess(workerCaches[w]);
+	}
+	return return_code;
+}
+
 } // namespace CMZN
+
+int cmzn_field_imagefilter_get_tile_size(cmzn_field_id field)
+{
+	CMZN::computed_field_image_filter *image_filter = (field) ?
+		dynamic_cast<CMZN::computed_field_image_filter *>(field->core) : nullptr;
+	if (image_filter)
+		return image_filter->getTileSize();
+	return 0;
+}
+
+int cmzn_field_imagefilter_set_tile_size(cmzn_field_id field, int tileSize)
+{
+	CMZN::computed_field_image_filter *image_filter = (field) ?
+		dynamic_cast<CMZN::computed_field_image_filter *>(field->core) : nullptr;
+	if (image_filter)
+		return image_filter->setTileSize(tileSize);
+	return CMZN_ERROR_ARGUMENT;
+}
+
+int cmzn_field_imagefilter_get_tile_cache_memory_limit(cmzn_field_id field)
+{
+	CMZN::computed_field_image_filter *image_filter = (field) ?
+		dynamic_cast<CMZN::computed_field_image_filter *>(field->core) : nullptr;
+	if (image_filter)
+		return image_filter->getTileCacheMemoryLimit();
+	return 0;
+}
+
+int cmzn_field_imagefilter_set_tile_cache_memory_limit(cmzn_field_id field, int megabytes)
+{
+	CMZN::computed_field_image_filter *image_filter = (field) ?
+		dynamic_cast<CMZN::computed_field_image_filter *>(field->core) : nullptr;
+	if (image_filter)
+		return image_filter->setTileCacheMemoryLimit(megabytes);
+	return CMZN_ERROR_ARGUMENT;
+}
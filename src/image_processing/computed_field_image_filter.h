@@ -20,8 +20,14 @@
 #include "general/message.h"
 #include "itkImage.h"
 #include "itkVector.h"
+#include "itkImageRegionIterator.h"
 #include "itkImageRegionIteratorWithIndex.h"
 #include "itkImportImageFilter.h"
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #if defined (SGI)
 /* The IRIX compiler 7.3.1.3m does not seem to support templates of templates so
@@ -56,8 +62,23 @@ public:
 
 	computed_field_image_filter_Functor* functor;
 
-	computed_field_image_filter(Computed_field *source_field) : Computed_field_core()
+	// size of square tiles output is computed in, or 0 to compute whole image
+	int tile_size;
+	// limit on memory used by cached output tiles, in megabytes
+	int tile_cache_memory_limit;
+	// region of pixels to create input image for, whole image if sizes are 0
+	int input_region_start[3];
+	int input_region_sizes[3];
+
+	computed_field_image_filter(Computed_field *source_field) : Computed_field_core(),
+		tile_size(0),
+		tile_cache_memory_limit(256)
 	{
+		for (int i = 0; i < 3; ++i)
+		{
+			input_region_start[i] = 0;
+			input_region_sizes[i] = 0;
+		}
 		if (Computed_field_get_native_resolution(source_field,
 				&dimension, &sizes, &texture_coordinate_field))
 		{
@@ -120,6 +141,69 @@ public:
 		return this->evaluateDerivativeFiniteDifference(cache, inValueCache, fieldDerivative);
 	}
 
+	/**
+	 * Get the number of pixels around a tile of output which the filter needs
+	 * input from to give exactly the same output values in the tile as
+	 * filtering the whole image. Override for filters computed from a bounded
+	 * neighbourhood of each pixel.
+	 * @return  Margin in pixels, or -1 if output depends on the whole image so
+	 * it cannot be computed in tiles.
+	 */
+	virtual int get_tile_margin()
+	{
+		return -1;
+	}
+
+	int getTileSize() const
+	{
+		return this->tile_size;
+	}
+
+	/**
+	 * Set size of tiles output is computed and cached in, or 0 to compute the
+	 * whole image at once. Only for filters with a tile margin.
+	 * @return  CMZN_OK on success, CMZN_ERROR_ARGUMENT if invalid size or
+	 * filter output cannot be computed in tiles.
+	 */
+	int setTileSize(int tileSizeIn)
+	{
+		if ((tileSizeIn < 0) || ((tileSizeIn > 0) && (this->get_tile_margin() < 0)))
+			return CMZN_ERROR_ARGUMENT;
+		if (tileSizeIn != this->tile_size)
+		{
+			this->tile_size = tileSizeIn;
+			this->clear_cache();
+		}
+		return CMZN_OK;
+	}
+
+	int getTileCacheMemoryLimit() const
+	{
+		return this->tile_cache_memory_limit;
+	}
+
+	/**
+	 * Set limit on memory used by cached output tiles, in megabytes. Least
+	 * recently used tiles are discarded when exceeded; the tile last
+	 * evaluated is always kept.
+	 * @return  CMZN_OK on success, CMZN_ERROR_ARGUMENT if negative.
+	 */
+	int setTileCacheMemoryLimit(int megabytes)
+	{
+		if (megabytes < 0)
+			return CMZN_ERROR_ARGUMENT;
+		this->tile_cache_memory_limit = megabytes;
+		return CMZN_OK;
+	}
+
+	/**
+	 * Get the index of the pixel containing the element xi or field values
+	 * location in cache, clamped to the image.
+	 * @param index  Array to receive dimension pixel indexes.
+	 * @return  1 on success, 0 if no valid location.
+	 */
+	int get_location_pixel_index(cmzn_fieldcache& cache, int *index);
+
 protected:
 
 	int clear_cache()
@@ -151,6 +235,27 @@ protected:
 #endif /* !defined (DONOTUSE_TEMPLATETEMPLATES) */
 
 public:
+	/** Receives source values for pixelsCount consecutive pixels of a region
+	 * from firstPixelIndex, with all components of each pixel together. */
+	typedef std::function<void(size_t firstPixelIndex, size_t pixelsCount, const ZnReal *values)>
+		PixelValuesSetter;
+
+	/**
+	 * Get values of the source field at the centres of a region of pixels of
+	 * the image at its native resolution, for the element or field values
+	 * location in cache. Image fields are read directly from their texture
+	 * where possible. Other fields are evaluated in chunks of rows, shared
+	 * between threads if the region is frozen.
+	 * @param region_start, region_sizes  First pixel index and number of
+	 * pixels in each dimension of region.
+	 * @param setSourceValues  Called with source field values for consecutive
+	 * pixels in region, x index varying fastest, to store them directly in the
+	 * image. Called from multiple threads for different pixels.
+	 * @return  1 on success, 0 on failure.
+	 */
+	int evaluate_source_pixel_values(cmzn_fieldcache& cache,
+		const int *region_start, const int *region_sizes, const PixelValuesSetter& setSourceValues);
+
 	template <class ImageType >
 	int create_input_image(cmzn_fieldcache& cache,
 		typename ImageType::Pointer &inputImage,
@@ -818,41 +923,15 @@ DESCRIPTION :
 Evaluate the templated version of this filter
 ==============================================================================*/
 {
-	const Field_location_element_xi* element_xi_location;
-	const Field_location_field_values* coordinate_location = 0;
-	const FE_value* xi = NULL;
-
-	if ((element_xi_location = cache.get_location_element_xi()))
-	{
-		xi = element_xi_location->get_xi();
-	}
-	else if ((coordinate_location = cache.get_location_field_values()))
-	{
-		xi = coordinate_location->get_values();
-	}
-
-	if (xi && outputImage)
+	int pixel_index[3];
+	if (outputImage && (dimension > 0) && get_location_pixel_index(cache, pixel_index))
 	{
 		typename ImageType::IndexType index;
 		for (int i = 0 ; i < dimension ; i++)
 		{
-			if (xi[i] < 0.0)
-			{
-				index[i] = 0;
-			}
-			else if (xi[i] >= 1.0)
-			{
-				index[i] = sizes[i] - 1;
-			}
-			else
-			{
-				index[i] = (long int)(xi[i] * (FE_value)sizes[i]);
-			}
-		}
-		if (dimension > 0)
-		{
-			assign_field_values( valueCache, outputImage->GetPixel( index ) );
+			index[i] = pixel_index[i];
 		}
+		assign_field_values( valueCache, outputImage->GetPixel( index ) );
 		return 1;
 	}
 	return 0;
@@ -862,15 +941,116 @@ template < class ImageType >
 class computed_field_image_filter_FunctorTmpl :
 	public computed_field_image_filter_Functor
 {
+	struct Tile
+	{
+		size_t number;  // tile index in x varying fastest
+		typename ImageType::Pointer image;  // pixels of tile only
+		size_t memory;
+	};
+
+	typedef std::list<Tile> TileList;
+
+	// cached output tiles, most recently used first
+	TileList tiles;
+	std::unordered_map<size_t, typename TileList::iterator> tileMap;
+	size_t tilesMemory;
+	// serialises filter updates if evaluated from multiple threads
+	std::mutex mutex;
+
 protected:
 	typename ImageType::Pointer outputImage;
 
 	computed_field_image_filter* image_filter;
 
+	/**
+	 * Evaluate output at location from the tile containing it, computing the
+	 * filter over only the tile and its margin if not cached. Input for that
+	 * region alone is created and the filter output outside the tile is
+	 * discarded.
+	 */
+	int evaluate_tile(cmzn_fieldcache& cache, RealFieldValueCache& valueCache, int margin)
+	{
+		const int dimension = image_filter->dimension;
+		const int *sizes = image_filter->sizes;
+		const int tile_size = image_filter->tile_size;
+		int pixel_index[3];
+		if (!image_filter->get_location_pixel_index(cache, pixel_index))
+			return 0;
+		size_t number = 0;
+		int tile_start[3], tile_sizes[3];
+		for (int i = dimension - 1; 0 <= i; --i)
+		{
+			const int tiles_count = (sizes[i] + tile_size - 1)/tile_size;
+			const int tile_index = pixel_index[i]/tile_size;
+			number = number*tiles_count + tile_index;
+			tile_start[i] = tile_index*tile_size;
+			tile_sizes[i] = (tile_start[i] + tile_size <= sizes[i]) ? tile_size : sizes[i] - tile_start[i];
+		}
+		auto iter = this->tileMap.find(number);
+		if (iter != this->tileMap.end())
+		{
+			this->tiles.splice(this->tiles.begin(), this->tiles, iter->second);
+			return image_filter->evaluate_output_image(cache, valueCache,
+				this->tiles.front().image, static_cast<ImageType*>(NULL));
+		}
+		typename ImageType::RegionType tileRegion;
+		for (int i = 0; i < dimension; i++)
+		{
+			const int start = (tile_start[i] > margin) ? tile_start[i] - margin : 0;
+			const int end = (tile_start[i] + tile_sizes[i] + margin < sizes[i]) ?
+				tile_start[i] + tile_sizes[i] + margin : sizes[i];
+			image_filter->input_region_start[i] = start;
+			image_filter->input_region_sizes[i] = end - start;
+			tileRegion.SetIndex(i, tile_start[i]);
+			tileRegion.SetSize(i, tile_sizes[i]);
+		}
+		this->outputImage = NULL;
+		int return_code = set_filter(cache);
+		for (int i = 0; i < 3; i++)
+		{
+			image_filter->input_region_start[i] = 0;
+			image_filter->input_region_sizes[i] = 0;
+		}
+		typename ImageType::Pointer tileImage = this->outputImage;
+		this->outputImage = NULL;
+		if (!(return_code && tileImage))
+			return 0;
+		if (tileImage->GetBufferedRegion() != tileRegion)
+		{
+			// keep only the pixels of the tile
+			typename ImageType::Pointer regionImage = tileImage;
+			tileImage = ImageType::New();
+			tileImage->SetRegions(tileRegion);
+			tileImage->Allocate();
+			itk::ImageRegionConstIterator<ImageType> inputIterator(regionImage, tileRegion);
+			itk::ImageRegionIterator<ImageType> outputIterator(tileImage, tileRegion);
+			for (; !inputIterator.IsAtEnd(); ++inputIterator, ++outputIterator)
+			{
+				outputIterator.Set(inputIterator.Get());
+			}
+		}
+		Tile tile = { number, tileImage,
+			static_cast<size_t>(tileRegion.GetNumberOfPixels())*sizeof(typename ImageType::PixelType) };
+		this->tiles.push_front(tile);
+		this->tileMap[number] = this->tiles.begin();
+		this->tilesMemory += tile.memory;
+		const size_t memoryLimit = static_cast<size_t>(image_filter->tile_cache_memory_limit)*1048576;
+		while ((this->tilesMemory > memoryLimit) && (this->tiles.size() > 1))
+		{
+			const Tile& oldTile = this->tiles.back();
+			this->tilesMemory -= oldTile.memory;
+			this->tileMap.erase(oldTile.number);
+			this->tiles.pop_back();
+		}
+		return image_filter->evaluate_output_image(cache, valueCache,
+			this->tiles.front().image, static_cast<ImageType*>(NULL));
+	}
+
 public:
 
 	computed_field_image_filter_FunctorTmpl(
 		computed_field_image_filter* image_filter) :
+		tilesMemory(0),
 		image_filter(image_filter)
 	{
 		outputImage = NULL;
@@ -882,11 +1062,18 @@ LAST MODIFIED : 12 September 2006
 
 DESCRIPTION :
 Updates the outputImage if required and then evaluates the outputImage at the 
-location.
+location. If the filter has a tile size, only the output tile containing the
+location is computed and cached.
 ==============================================================================*/
 	{
 		int return_code;
-		if (!outputImage)
+		std::lock_guard<std::mutex> lock(this->mutex);
+		const int margin = (image_filter->tile_size > 0) ? image_filter->get_tile_margin() : -1;
+		if (0 <= margin)
+		{
+			return_code = evaluate_tile(cache, valueCache, margin);
+		}
+		else if (!outputImage)
 		{
 			if ( (return_code = set_filter(cache) ) )
 			{
@@ -907,9 +1094,14 @@ location.
 	int clear_cache()
 	{
 		outputImage = NULL;
+		this->tiles.clear();
+		this->tileMap.clear();
+		this->tilesMemory = 0;
 		return (1);
 	}
 
+	/** @return  Output image for whole image, or NULL if not computed or
+	 * output is computed in tiles. */
 	typename ImageType::Pointer get_output_image()
 	{
 		return (outputImage);
@@ -975,10 +1167,20 @@ for subsequent operations.
 		{
 			return_code = 1;
 			cmzn_field_id sourceField = getSourceField(0);
-			// If the input contains an ImageFilter of the correct type then use that as
-			// the input field
-			if ((input_field_image_filter = dynamic_cast<computed_field_image_filter *>
+			// region of image to create input for: all or part of a tile's input
+			const bool wholeImage = (input_region_sizes[0] == 0);
+			int region_start[3], region_sizes[3];
+			for (i = 0 ; i < dimension ; i++)
+			{
+				region_start[i] = (wholeImage) ? 0 : input_region_start[i];
+				region_sizes[i] = (wholeImage) ? sizes[i] : input_region_sizes[i];
+			}
+			// If the input contains an ImageFilter of the correct type computing its
+			// whole image then use that as the input field
+			if (wholeImage
+					&& (input_field_image_filter = dynamic_cast<computed_field_image_filter *>
 					(field->source_fields[0]->core))
+					&& (input_field_image_filter->tile_size == 0)
 					&& (input_field_image_functor = dynamic_cast<computed_field_image_filter_FunctorTmpl<ImageType>*>
 					(input_field_image_filter->functor)))
 			{
@@ -995,12 +1197,12 @@ for subsequent operations.
 				typename ImageType::IndexType start;
 				for (i = 0 ; i < dimension ; i++)
 				{
-					start[i] = 0; // first index on X
+					start[i] = region_start[i]; // first index on X
 				}
 				typename ImageType::SizeType size;
 				for (i = 0 ; i < dimension ; i++)
 				{
-					size[i] = sizes[i];
+					size[i] = region_sizes[i];
 				}
 				typename ImageType::RegionType region;
 				if (dimension > 0)
@@ -1011,216 +1213,29 @@ for subsequent operations.
 			
 				inputImage->SetRegions(region);
 				inputImage->Allocate();
-			
-				FE_value pixel_xi[3];
-				
-				for (i = 0 ; i < 3 ; i++)
-				{
-					pixel_xi[i] = 0.0;
-				}
-
-				// work with a private field cache to avoid stomping current location
-				cmzn_fieldmodule_id field_module = cmzn_field_get_fieldmodule(field);
-				cmzn_fieldcache_id field_cache = cmzn_fieldmodule_create_fieldcache(field_module);
-				field_cache->setTime(cache.getTime());
-				if(element_xi_location)
-				{
-					cmzn_element* element = element_xi_location->get_element();
-
-					itk::ImageRegionIteratorWithIndex< ImageType >
-						generateInput( inputImage, region );
-					for ( generateInput.GoToBegin(); !generateInput.IsAtEnd();
-						++generateInput)
-					{
-						typename ImageType::IndexType idx = generateInput.GetIndex();
-				
-						/* Find element xi for idx, assuming xi field for now. */
-						for (i = 0 ; i < dimension ; i++)
-						{
-							pixel_xi[i] = ((ZnReal)idx[i] + 0.5) / (ZnReal)sizes[i];
-						}
-
-						field_cache->setMeshLocation(element, pixel_xi);
-						const RealFieldValueCache *valueCache = RealFieldValueCache::cast(sourceField->evaluate(*field_cache));
-						if (valueCache)
-						{
-							generateInput.Set( valueCache->values[0] );
-						}
-						else
-						{
-							return_code = 0;
-							break;
-						}
-					}
-				}
-				else if (coordinate_location)
-				{
-					cmzn_field* reference_field = coordinate_location->get_field();
-					//FE_value time = coordinate_location->get_time();
-					itk::ImageRegionIteratorWithIndex< ImageType >
-						generateInput( inputImage, region );
-					//Field_location_field_values pixel_location(reference_field, 
-					//	dimension, pixel_xi, time);
-
-					for ( generateInput.GoToBegin(); !generateInput.IsAtEnd(); ++generateInput)
-					{
-						typename ImageType::IndexType idx = generateInput.GetIndex();
-				
-						/* Find element xi for idx, assuming xi field for now. */
-						for (i = 0 ; i < dimension ; i++)
-						{
-							pixel_xi[i] = ((ZnReal)idx[i] + 0.5) / (ZnReal)sizes[i];
-						}
-
-						field_cache->setFieldReal(reference_field, dimension, pixel_xi);
-						const RealFieldValueCache *valueCache = RealFieldValueCache::cast(sourceField->evaluate(*field_cache));
-						if (valueCache)
-						{
-							generateInput.Set( valueCache->values[0] );
-						}
-						else
-						{
-							return_code = 0;
-							break;
-						}
-					}
-				}
-				cmzn_fieldcache_destroy(&field_cache);
-				cmzn_fieldmodule_destroy(&field_module);
-#if defined (NEW_CODE)
-				typedef itk::ImportImageFilter<
-				   typename ImageType::PixelType, ImageType::ImageDimension >
-					ImportFilterType;
-				typename ImportFilterType::Pointer importFilter = 
-					ImportFilterType::New();
-
-				printf("ImportImageFilter %d\n", ImageType::ImageDimension); 
-
-				typename ImportFilterType::IndexType start;
-				for (i = 0 ; i < dimension ; i++)
-				{
-					start[i] = 0; // first index on X
-				}
-				typename ImportFilterType::SizeType size;
-				for (i = 0 ; i < dimension ; i++)
-				{
-					size[i] = sizes[i];
-				}
-				typename ImportFilterType::RegionType region;
-				region.SetSize( size );
-				region.SetIndex( start );
-			
-				importFilter->SetRegion(region);
-
-				unsigned int totalSize = sizes[0];
-				for (i = 1 ; i < dimension ; i++)
-				{
-					totalSize *= sizes[i];
-				}
-				typename ImageType::PixelType * localBuffer =
-					new typename ImageType::PixelType[ totalSize ];
-			
-				ZnReal pixel_xi[3];
-				
-				for (i = 0 ; i < dimension ; i++)
-				{
-					pixel_xi[i] = 0.5 / (ZnReal)sizes[i];
-				}
-				for ( ; i < 3 ; i++)
-				{
-					pixel_xi[i] = 0.0;
-				}
-
-				typename ImageType::IndexType idx;
-				for (i = 0 ; i < dimension ; i++)
-				{
-					idx[i] = 0;
-				}
 
-				if(element_xi_location)
+				// fill image buffer directly, x index varying fastest
+				// pixels use up to 4 components; single component source values are repeated
+				const int sourceComponents = sourceField->number_of_components;
+				typename ImageType::PixelType *pixels = inputImage->GetBufferPointer();
+				auto setSourcePixelValues = [this, pixels, sourceComponents](
+					size_t firstPixelIndex, size_t pixelsCount, const ZnReal *values)
 				{
-					unsigned int count = 0;
-					FE_element* element = element_xi_location->get_element();
-					FE_value time = element_xi_location->get_time();
-					typename ImageType::PixelType *buffer_ptr = localBuffer;
-
-					/* Find element xi for idx, assuming xi field for now. */
-					for (i = 0 ; i < dimension ; i++)
-					{
-						pixel_xi[i] = ((ZnReal)idx[i] + 0.5) / (ZnReal)sizes[i];
-					}
-					Field_location_element_xi pixel_location(element, pixel_xi);
-					pixel_location.set_time(time);
-					while (count < totalSize)
+					ZnReal pixelValues[4];
+					for (size_t p = firstPixelIndex; p < firstPixelIndex + pixelsCount; p++)
 					{
-						pixel_location.set_element_xi(element, pixel_xi);
-						
-						Computed_field_evaluate_cache_at_location(
-							field->source_fields[0], &pixel_location);
-				
-						setPixelValues( *buffer_ptr, 
-							field->source_fields[0]->values );
-
-						buffer_ptr++;
-						count++;
-						idx[0]++;
-						pixel_xi[0] = ((ZnReal)idx[0] + 0.5) / (ZnReal)sizes[0];
-						for (i = 1 ; (i < dimension) && (idx[i-1] >= sizes[i-1]) ; i++)
+						for (int k = 0 ; k < 4 ; k++)
 						{
-							idx[i-1] = 0;
-							pixel_xi[i-1] = ((ZnReal)idx[i-1] + 0.5) / (ZnReal)sizes[i-1];
-							idx[i]++;
-							pixel_xi[i] = ((ZnReal)idx[i] + 0.5) / (ZnReal)sizes[i];
+							pixelValues[k] = (k < sourceComponents) ? values[k] : values[0];
 						}
+						this->setPixelValues( pixels[p], pixelValues );
+						values += sourceComponents;
 					}
-				}
-				else if (coordinate_location)
+				};
+				if (!evaluate_source_pixel_values(cache, region_start, region_sizes, setSourcePixelValues))
 				{
-					unsigned int count = 0;
-					Computed_field* reference_field = 
-						coordinate_location->get_reference_field();
-					FE_value time = coordinate_location->get_time();
-					Field_location_field_values pixel_location(reference_field, 
-						dimension, pixel_xi, time);
-					typename ImageType::PixelType *buffer_ptr = localBuffer;
-
-					/* Find element xi for idx, assuming xi field for now. */
-					for (i = 0 ; i < dimension ; i++)
-					{
-						pixel_xi[i] = ((ZnReal)idx[i] + 0.5) / (ZnReal)sizes[i];
-					}
-					while (count < totalSize)
-					{
-						pixel_location.set_values(dimension, pixel_xi);
-
-						Computed_field_evaluate_cache_at_location(
-							field->source_fields[0], &pixel_location);
-				
-						setPixelValues( *buffer_ptr, 
-							field->source_fields[0]->values );
-
-						buffer_ptr++;
-						count++;
-						idx[0]++;
-						pixel_xi[0] = ((ZnReal)idx[0] + 0.5) / (ZnReal)sizes[0];
-						for (i = 1 ; (i < dimension) && (idx[i-1] >= sizes[i-1]) ; i++)
-						{
-							idx[i-1] = 0;
-							pixel_xi[i-1] = ((ZnReal)idx[i-1] + 0.5) / (ZnReal)sizes[i-1];
-							idx[i]++;
-							pixel_xi[i] = ((ZnReal)idx[i] + 0.5) / (ZnReal)sizes[i];
-						}
-					}
-
+					return_code = 0;
 				}
-
-				importFilter->SetImportPointer( localBuffer, totalSize,
-					/*importImageFilterWillOwnTheBuffer*/true );
-				importFilter->Update();
-
-				inputImage = importFilter->GetOutput();
-#endif // defined (NEW_CODE)
-
 			}
 		}
 		else
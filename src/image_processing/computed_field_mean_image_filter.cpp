@@ -47,6 +47,20 @@ public:
 		}
 	};
 
+	/* neighbourhood of largest radius */
+	virtual int get_tile_margin()
+	{
+		int margin = 0;
+		for (int i = 0; i < dimension; i++)
+		{
+			if (radius_sizes[i] > margin)
+			{
+				margin = radius_sizes[i];
+			}
+		}
+		return margin;
+	}
+
 private:
 	virtual void create_functor();
 
@@ -46,6 +46,12 @@ public:
 	{
 	};
 
+	/* pixel values only depend on same pixel of source */
+	virtual int get_tile_margin()
+	{
+		return 0;
+	}
+
 private:
 	virtual void create_functor();
 
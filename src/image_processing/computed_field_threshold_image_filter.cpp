@@ -154,6 +154,12 @@ namespace {
 			return CMZN_OK;
 		}
 
+		/* pixel values only depend on same pixel of source */
+		virtual int get_tile_margin()
+		{
+			return 0;
+		}
+
 	private:
 		virtual void create_functor();
 
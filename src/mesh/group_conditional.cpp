@@ -0,0 +1,187 @@
+/**
+ * FILE : group_conditional.cpp
+ *
+ * Batch evaluation of conditional fields over meshes and nodesets for
+ * populating mesh and nodeset groups.
+ */
+/* Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#include <atomic>
+#include <vector>
+#include "computed_field/computed_field.h"
+#include "computed_field/computed_field_private.hpp"
+#include "computed_field/field_cache.hpp"
+#include "finite_element/finite_element_mesh.hpp"
+#include "finite_element/finite_element_nodeset.hpp"
+#include "general/message.h"
+#include "general/thread_pool.hpp"
+#include "mesh/group_conditional.hpp"
+
+namespace {
+
+// Number of label indexes evaluated per chunk of work
+const DsLabelIndex conditionalIndexesPerChunk = 1024;
+
+/** Sets element location in field cache from index */
+class MeshIndexLocation
+{
+	FE_mesh *feMesh;
+
+public:
+	MeshIndexLocation(FE_mesh *feMeshIn) :
+		feMesh(feMeshIn)
+	{
+	}
+
+	/** @return  True if location set, false if no element at index */
+	bool operator()(cmzn_fieldcache& fieldcache, DsLabelIndex index) const
+	{
+		cmzn_element *element = this->feMesh->getElement(index);
+		if (!element)
+			return false;
+		fieldcache.setElement(element);
+		return true;
+	}
+};
+
+/** Sets node location in field cache from index */
+class NodesetIndexLocation
+{
+	FE_nodeset *feNodeset;
+
+public:
+	NodesetIndexLocation(FE_nodeset *feNodesetIn) :
+		feNodeset(feNodesetIn)
+	{
+	}
+
+	/** @return  True if location set, false if no node at index */
+	bool operator()(cmzn_fieldcache& fieldcache, DsLabelIndex index) const
+	{
+		cmzn_node *node = this->feNodeset->getNode(index);
+		if (!node)
+			return false;
+		fieldcache.setNode(node);
+		return true;
+	}
+};
+
+template <class IndexLocation> int FE_domain_evaluate_conditional_labels_group(
+	FE_domain *feDomain, const IndexLocation& indexLocation, cmzn_field *conditionalField,
+	const DsLabelsGroup *sourceLabelsGroup, bool value, int threadsCount,
+	DsLabelsGroup& resultLabelsGroup)
+{
+	cmzn_region *region = conditionalField->getRegion();
+	const DsLabelIndex indexSize = feDomain->getLabels().getIndexSize();
+	if (indexSize == 0)
+		return CMZN_OK;
+	threadsCount = ThreadPool::resolveThreadsCount(threadsCount);
+	const DsLabelIndex chunksCount = (indexSize + conditionalIndexesPerChunk - 1)/conditionalIndexesPerChunk;
+	const int workersCount = (static_cast<DsLabelIndex>(threadsCount) < chunksCount) ?
+		threadsCount : static_cast<int>(chunksCount);
+	// worker 0 is the calling thread and adds directly to the result
+	std::vector<cmzn_fieldcache *> workerCaches(workersCount, nullptr);
+	std::vector<DsLabelsGroup *> workerLabelsGroups(workersCount, nullptr);
+	workerLabelsGroups[0] = &resultLabelsGroup;
+	int return_code = CMZN_OK;
+	for (int w = 0; w < workersCount; ++w)
+	{
+		workerCaches[w] = cmzn_fieldcache::create(region);
+		if (w > 0)
+			workerLabelsGroups[w] = feDomain->createLabelsGroup();
+		if ((!workerCaches[w]) || (!workerLabelsGroups[w]))
+		{
+			return_code = CMZN_ERROR_MEMORY;
+			break;
+		}
+	}
+	// evaluate at indexes in chunk c, adding those matching value to worker's labels group
+	auto evaluateChunk = [&](int workerIndex, DsLabelIndex c) -> int
+	{
+		cmzn_fieldcache& fieldcache = *(workerCaches[workerIndex]);
+		DsLabelsGroup& labelsGroup = *(workerLabelsGroups[workerIndex]);
+		const DsLabelIndex indexEnd = ((c + 1)*conditionalIndexesPerChunk < indexSize) ?
+			(c + 1)*conditionalIndexesPerChunk : indexSize;
+		DsLabelIndex index = c*conditionalIndexesPerChunk - 1;
+		while (true)
+		{
+			if (sourceLabelsGroup)
+			{
+				if (!sourceLabelsGroup->incrementIndex(index))
+					break;
+			}
+			else
+				++index;
+			if (index >= indexEnd)
+				break;
+			if (!indexLocation(fieldcache, index))
+				continue;
+			if (cmzn_field_evaluate_boolean(conditionalField, &fieldcache) != value)
+				continue;
+			const int result = labelsGroup.setIndex(index, true);
+			if ((result != CMZN_OK) && (result != CMZN_ERROR_ALREADY_EXISTS))
+				return result;
+		}
+		return CMZN_OK;
+	};
+	if ((CMZN_OK == return_code) && (workersCount == 1))
+	{
+		for (DsLabelIndex c = 0; (c < chunksCount) && (CMZN_OK == return_code); ++c)
+			return_code = evaluateChunk(0, c);
+	}
+	else if (CMZN_OK == return_code)
+	{
+		// evaluate first chunk in this thread so objects created on demand on first
+		// evaluation (field derivatives, mesh field ranges etc.) exist before workers start
+		return_code = evaluateChunk(0, 0);
+		if (CMZN_OK == return_code)
+		{
+			std::atomic_int failedResult(CMZN_OK);
+			ThreadPool::getShared().executeChunks(workersCount, static_cast<size_t>(chunksCount - 1),
+				[&](int workerIndex, size_t c)
+				{
+					const int result = evaluateChunk(workerIndex, static_cast<DsLabelIndex>(c) + 1);
+					if (CMZN_OK != result)
+						failedResult = result;
+					return (CMZN_OK == result);
+				});
+			return_code = failedResult;
+		}
+		// word-parallel union of indexes found by other workers
+		for (int w = 1; (w < workersCount) && (CMZN_OK == return_code); ++w)
+			return_code = resultLabelsGroup.addGroup(*(workerLabelsGroups[w]));
+	}
+	for (int w = 0; w < workersCount; ++w)
+	{
+		if (workerCaches[w])
+			cmzn_fieldcache::deaccess(workerCaches[w]);
+		if ((w > 0) && (workerLabelsGroups[w]))
+			cmzn::Deaccess(workerLabelsGroups[w]);
+	}
+	return return_code;
+}
+
+}
+
+int FE_mesh_evaluate_conditional_labels_group(FE_mesh *feMesh,
+	cmzn_field *conditionalField, const DsLabelsGroup *sourceLabelsGroup,
+	bool value, int threadsCount, DsLabelsGroup& resultLabelsGroup)
+{
+	if ((!feMesh) || (!conditionalField) || (threadsCount < 0))
+		return CMZN_ERROR_ARGUMENT;
+	return FE_domain_evaluate_conditional_labels_group(feMesh, MeshIndexLocation(feMesh),
+		conditionalField, sourceLabelsGroup, value, threadsCount, resultLabelsGroup);
+}
+
+int FE_nodeset_evaluate_conditional_labels_group(FE_nodeset *feNodeset,
+	cmzn_field *conditionalField, const DsLabelsGroup *sourceLabelsGroup,
+	bool value, int threadsCount, DsLabelsGroup& resultLabelsGroup)
+{
+	if ((!feNodeset) || (!conditionalField) || (threadsCount < 0))
+		return CMZN_ERROR_ARGUMENT;
+	return FE_domain_evaluate_conditional_labels_group(feNodeset, NodesetIndexLocation(feNodeset),
+		conditionalField, sourceLabelsGroup, value, threadsCount, resultLabelsGroup);
+}
@@ -0,0 +1,50 @@
+/**
+ * FILE : group_conditional.hpp
+ *
+ * Batch evaluation of conditional fields over meshes and nodesets for
+ * populating mesh and nodeset groups.
+ */
+/* Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "cmlibs/zinc/types/fieldid.h"
+#include "datastore/labelsgroup.hpp"
+
+class FE_mesh;
+class FE_nodeset;
+
+/**
+ * Evaluate conditional field at elements of mesh, adding the indexes of those
+ * where it equals the required value to the result labels group.
+ * Indexes are evaluated in chunks; with more than 1 thread, chunks are shared
+ * between threads each with their own field cache and labels group, merged
+ * into the result after all are evaluated. The mesh, its groups and fields
+ * must not be modified while evaluating, and the result must not be a group
+ * the conditional field depends on.
+ * @param sourceLabelsGroup  Optional group of elements to evaluate at, or
+ * nullptr to evaluate at all elements of mesh.
+ * @param value  True to add indexes where the conditional is true, false to
+ * add those where it is false.
+ * @param threadsCount  Maximum number of threads to use, or 0 for all
+ * hardware threads.
+ * @param resultLabelsGroup  Group for the mesh's labels to add indexes to.
+ * @return  Result OK on success, ERROR_MEMORY if failed to allocate, or
+ * any other error on failure.
+ */
+int FE_mesh_evaluate_conditional_labels_group(FE_mesh *feMesh,
+	cmzn_field *conditionalField, const DsLabelsGroup *sourceLabelsGroup,
+	bool value, int threadsCount, DsLabelsGroup& resultLabelsGroup);
+
+/**
+ * Evaluate conditional field at nodes of nodeset, adding the indexes of those
+ * where it equals the required value to the result labels group.
+ * @see FE_mesh_evaluate_conditional_labels_group
+ */
+int FE_nodeset_evaluate_conditional_labels_group(FE_nodeset *feNodeset,
+	cmzn_field *conditionalField, const DsLabelsGroup *sourceLabelsGroup,
+	bool value, int threadsCount, DsLabelsGroup& resultLabelsGroup);
@@ -188,6 +188,8 @@ cmzn_element_id cmzn_mesh_create_element(cmzn_mesh_id mesh,
 {
 	if (mesh)
 	{
+		if (!mesh->getRegion()->checkModifiable("cmzn_mesh_create_element"))
+			return nullptr;
 		return mesh->createElement(identifier, element_template);
 	}
 	return nullptr;
@@ -220,6 +222,8 @@ int cmzn_mesh_destroy_all_elements(cmzn_mesh_id mesh)
 {
 	if (mesh)
 	{
+		if (!mesh->getRegion()->checkModifiable("cmzn_mesh_destroy_all_elements"))
+			return CMZN_ERROR_IN_USE;
 		return mesh->destroyAllElements();
 	}
 	return CMZN_ERROR_ARGUMENT;
@@ -229,6 +233,8 @@ int cmzn_mesh_destroy_element(cmzn_mesh_id mesh, cmzn_element_id element)
 {
 	if (mesh && element)
 	{
+		if (!mesh->getRegion()->checkModifiable("cmzn_mesh_destroy_element"))
+			return CMZN_ERROR_IN_USE;
 		return mesh->destroyElement(element);
 	}
 	return CMZN_ERROR_ARGUMENT;
@@ -239,6 +245,8 @@ int cmzn_mesh_destroy_elements_conditional(cmzn_mesh_id mesh,
 {
 	if (mesh)
 	{
+		if (!mesh->getRegion()->checkModifiable("cmzn_mesh_destroy_elements_conditional"))
+			return CMZN_ERROR_IN_USE;
 		return mesh->destroyElementsConditional(conditional_field);
 	}
 	return CMZN_ERROR_ARGUMENT;
@@ -10,6 +10,7 @@
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 #include "computed_field/computed_field_group.hpp"
 #include "general/mystring.h"
+#include "mesh/group_conditional.hpp"
 #include "mesh/mesh_group.hpp"
 #include "mesh/nodeset_group.hpp"
 #include "finite_element/finite_element_region.h"
@@ -546,57 +547,20 @@ int cmzn_mesh_group::addElementsConditional(cmzn_field* conditionalField)
 	{
 		return this->addElementsInLabelsGroup(*(otherMeshGroup->labelsGroup));
 	}
-	const bool handleSubelements =
-		this->getSubelementHandlingMode() == CMZN_FIELD_GROUP_SUBELEMENT_HANDLING_MODE_FULL;
-	if (handleSubelements)
-	{
-		region->beginChangeFields();
-	}
-	cmzn_elementiterator* iter = this->feMesh->createElementiterator();
-	cmzn_fieldcache* fieldcache = cmzn_fieldcache::create(region);
-	int return_code = CMZN_OK;
-	const int oldSize = this->labelsGroup->getSize();
-	if ((iter) && (fieldcache))
+	// evaluate all elements before merging, adding subelements once for all
+	DsLabelsGroup* addLabelsGroup = this->feMesh->createLabelsGroup();
+	if (!addLabelsGroup)
 	{
-		cmzn_element* element = nullptr;
-		while ((element = iter->nextElement()))
-		{
-			fieldcache->setElement(element);
-			if (!cmzn_field_evaluate_boolean(conditionalField, fieldcache))
-			{
-				continue;
-			}
-			const int result = this->labelsGroup->setIndex(element->getIndex(), true);
-			if ((result != CMZN_OK) && (result != CMZN_ERROR_ALREADY_EXISTS))
-			{
-				return_code = result;
-				break;
-			}
-			if (handleSubelements)
-			{
-				int subresult = this->addSubelements(element);
-				if (subresult != CMZN_OK)
-				{
-					return_code = subresult;
-					break;
-				}
-			}
-		}
-	}
-	else
-	{
-		return_code = CMZN_ERROR_MEMORY;
-	}
-	cmzn_fieldcache::deaccess(fieldcache);
-	cmzn::Deaccess(iter);
-	if (this->labelsGroup->getSize() > oldSize)
-	{
-		this->changeAdd();
+		return CMZN_ERROR_MEMORY;
 	}
-	if (handleSubelements)
+	int return_code = FE_mesh_evaluate_conditional_labels_group(this->feMesh, conditionalField,
+		/*sourceLabelsGroup*/nullptr, /*value*/true, this->getGroupCore()->getConditionalThreadsCount(),
+		*addLabelsGroup);
+	if ((CMZN_OK == return_code) && (addLabelsGroup->getSize() > 0))
 	{
-		region->endChangeFields();
+		return_code = this->addElementsInLabelsGroup(*addLabelsGroup);
 	}
+	cmzn::Deaccess(addLabelsGroup);
 	return return_code;
 }
 
@@ -718,57 +682,23 @@ int cmzn_mesh_group::removeElementsConditional(cmzn_field* conditionalField)
 	{
 		return this->removeElementsInLabelsGroup(*(otherMeshGroup->labelsGroup));
 	}
-	int return_code = CMZN_OK;
+	// subelements of matching elements not in this group are also removed, so
+	// only limit evaluation to this group's elements when not handling them
 	const bool handleSubelements =
 		this->getSubelementHandlingMode() == CMZN_FIELD_GROUP_SUBELEMENT_HANDLING_MODE_FULL;
-	if (handleSubelements)
+	DsLabelsGroup* removeLabelsGroup = this->feMesh->createLabelsGroup();
+	if (!removeLabelsGroup)
 	{
-		region->beginChangeFields();
+		return CMZN_ERROR_MEMORY;
 	}
-	cmzn_elementiterator* iter = this->feMesh->createElementiterator();
-	cmzn_fieldcache* fieldcache = cmzn_fieldcache::create(region);
-	const int oldSize = this->labelsGroup->getSize();
-	if ((iter) && (fieldcache))
+	int return_code = FE_mesh_evaluate_conditional_labels_group(this->feMesh, conditionalField,
+		(handleSubelements) ? nullptr : this->labelsGroup, /*value*/true,
+		this->getGroupCore()->getConditionalThreadsCount(), *removeLabelsGroup);
+	if ((CMZN_OK == return_code) && (removeLabelsGroup->getSize() > 0))
 	{
-		cmzn_element* element = nullptr;
-		while ((element = iter->nextElement()))
-		{
-			fieldcache->setElement(element);
-			if (!cmzn_field_evaluate_boolean(conditionalField, fieldcache))
-			{
-				continue;
-			}
-			const int result = this->labelsGroup->setIndex(element->getIndex(), false);
-			if ((result != CMZN_OK) && (result != CMZN_ERROR_NOT_FOUND))
-			{
-				return_code = result;
-				break;
-			}
-			if (handleSubelements)
-			{
-				int subresult = this->removeSubelements(element);
-				if (subresult != CMZN_OK)
-				{
-					return_code = subresult;
-					break;
-				}
-			}
-		}
-	}
-	else
-	{
-		return_code = CMZN_ERROR_MEMORY;
-	}
-	cmzn_fieldcache::deaccess(fieldcache);
-	cmzn::Deaccess(iter);
-	if (this->labelsGroup->getSize() < oldSize)
-	{
-		this->changeRemove();
-	}
-	if (handleSubelements)
-	{
-		region->endChangeFields();
+		return_code = this->removeElementsInLabelsGroup(*removeLabelsGroup);
 	}
+	cmzn::Deaccess(removeLabelsGroup);
 	return return_code;
 }
 
@@ -807,6 +737,89 @@ int cmzn_mesh_group::removeElementsInLabelsGroup(const DsLabelsGroup& removeLabe
 	return CMZN_OK;
 }
 
+int cmzn_mesh_group::retainElementsConditional(cmzn_field* conditionalField)
+{
+	cmzn_region* region = this->getRegion();
+	if ((!region) || (!conditionalField) || (conditionalField->getRegion() != region))
+	{
+		return CMZN_ERROR_ARGUMENT;
+	}
+	if (this->labelsGroup->getSize() == 0)
+	{
+		return CMZN_OK;
+	}
+	bool isEmptyMeshGroup = false;
+	const cmzn_mesh_group* otherMeshGroup = this->getConditionalMeshGroup(conditionalField, isEmptyMeshGroup);
+	if (isEmptyMeshGroup)
+	{
+		return this->removeAllElements();
+	}
+	if (otherMeshGroup)
+	{
+		return this->retainElementsInLabelsGroup(*(otherMeshGroup->labelsGroup));
+	}
+	// gather elements to remove so subelements are handled in one pass
+	DsLabelsGroup* removeLabelsGroup = this->feMesh->createLabelsGroup();
+	if (!removeLabelsGroup)
+	{
+		return CMZN_ERROR_MEMORY;
+	}
+	int return_code = FE_mesh_evaluate_conditional_labels_group(this->feMesh, conditionalField,
+		this->labelsGroup, /*value*/false, this->getGroupCore()->getConditionalThreadsCount(),
+		*removeLabelsGroup);
+	if ((CMZN_OK == return_code) && (removeLabelsGroup->getSize() > 0))
+	{
+		return_code = this->removeElementsInLabelsGroup(*removeLabelsGroup);
+	}
+	cmzn::Deaccess(removeLabelsGroup);
+	return return_code;
+}
+
+int cmzn_mesh_group::retainElementsInLabelsGroup(const DsLabelsGroup& retainLabelsGroup)
+{
+	if (&retainLabelsGroup == this->labelsGroup)
+	{
+		return CMZN_OK;
+	}
+	cmzn_region* region = this->getRegion();
+	if (!region)
+	{
+		return CMZN_ERROR_ARGUMENT;
+	}
+	if (this->getSubelementHandlingMode() != CMZN_FIELD_GROUP_SUBELEMENT_HANDLING_MODE_FULL)
+	{
+		const int oldSize = this->labelsGroup->getSize();
+		const int return_code = this->labelsGroup->intersectGroup(retainLabelsGroup);
+		if (this->labelsGroup->getSize() < oldSize)
+		{
+			this->changeRemove();
+		}
+		return return_code;
+	}
+	// nothing to remove if all elements are retained
+	if (this->labelsGroup->getIntersectionSize(retainLabelsGroup) == this->labelsGroup->getSize())
+	{
+		return CMZN_OK;
+	}
+	// subelements of removed elements must be removed
+	DsLabelsGroup* removeLabelsGroup = DsLabelsGroup::create(this->labelsGroup->getLabels());
+	if (!removeLabelsGroup)
+	{
+		return CMZN_ERROR_MEMORY;
+	}
+	int return_code = removeLabelsGroup->addGroup(*(this->labelsGroup));
+	if (CMZN_OK == return_code)
+	{
+		return_code = removeLabelsGroup->removeGroup(retainLabelsGroup);
+	}
+	if ((CMZN_OK == return_code) && (removeLabelsGroup->getSize() > 0))
+	{
+		return_code = this->removeElementsInLabelsGroup(*removeLabelsGroup);
+	}
+	cmzn::Deaccess(removeLabelsGroup);
+	return return_code;
+}
+
 int cmzn_mesh_group::addElementFaces(cmzn_element* parentElement)
 {
 	if ((!parentElement->getMesh()) || (parentElement->getMesh() != this->feMesh->getParentMesh()))
@@ -1013,6 +1026,16 @@ int cmzn_mesh_group_remove_elements_conditional(cmzn_mesh_group_id mesh_group,
 	return CMZN_ERROR_ARGUMENT;
 }
 
+int cmzn_mesh_group_retain_elements_conditional(cmzn_mesh_group_id mesh_group,
+	cmzn_field_id conditional_field)
+{
+	if (mesh_group)
+	{
+		return mesh_group->retainElementsConditional(conditional_field);
+	}
+	return CMZN_ERROR_ARGUMENT;
+}
+
 int cmzn_mesh_group_add_element_faces(cmzn_mesh_group_id mesh_group, cmzn_element_id element)
 {
 	if (mesh_group)
@@ -169,6 +169,12 @@ public:
 
 	int removeElementsInLabelsGroup(const DsLabelsGroup& removeLabelsGroup);
 
+	int retainElementsConditional(cmzn_field* conditionalField);
+
+	/** Remove elements not in retainLabelsGroup, and their subelements if
+	 * handling subelements. */
+	int retainElementsInLabelsGroup(const DsLabelsGroup& retainLabelsGroup);
+
 	/** @param element  Element from parent master mesh */
 	int addElementFaces(cmzn_element* parentElement);
 
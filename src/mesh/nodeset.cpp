@@ -193,6 +193,8 @@ cmzn_node_id cmzn_nodeset_create_node(cmzn_nodeset_id nodeset,
 {
 	if (nodeset && node_template)
 	{
+		if (!nodeset->getRegion()->checkModifiable("cmzn_nodeset_create_node"))
+			return nullptr;
 		return nodeset->createNode(identifier, node_template);
 	}
 	return nullptr;
@@ -244,6 +246,8 @@ int cmzn_nodeset_destroy_all_nodes(cmzn_nodeset_id nodeset)
 {
 	if (nodeset)
 	{
+		if (!nodeset->getRegion()->checkModifiable("cmzn_nodeset_destroy_all_nodes"))
+			return CMZN_ERROR_IN_USE;
 		return nodeset->destroyAllNodes();
 	}
 	return CMZN_ERROR_ARGUMENT;
@@ -253,6 +257,8 @@ int cmzn_nodeset_destroy_node(cmzn_nodeset_id nodeset, cmzn_node_id node)
 {
 	if (nodeset && node)
 	{
+		if (!nodeset->getRegion()->checkModifiable("cmzn_nodeset_destroy_node"))
+			return CMZN_ERROR_IN_USE;
 		return nodeset->destroyNode(node);
 	}
 	return CMZN_ERROR_ARGUMENT;
@@ -263,6 +269,8 @@ int cmzn_nodeset_destroy_nodes_conditional(cmzn_nodeset_id nodeset,
 {
 	if (nodeset && conditional_field)
 	{
+		if (!nodeset->getRegion()->checkModifiable("cmzn_nodeset_destroy_nodes_conditional"))
+			return CMZN_ERROR_IN_USE;
 		return nodeset->destroyNodesConditional(conditional_field);
 	}
 	return CMZN_ERROR_ARGUMENT;
@@ -10,6 +10,7 @@
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 #include "computed_field/computed_field_group.hpp"
 #include "general/mystring.h"
+#include "mesh/group_conditional.hpp"
 #include "mesh/nodeset_group.hpp"
 #include "finite_element/finite_element_region.h"
 
@@ -158,38 +159,20 @@ int cmzn_nodeset_group::addNodesConditional(cmzn_field* conditionalField)
 	{
 		return this->addNodesInLabelsGroup(*(otherNodesetGroup->labelsGroup));
 	}
-	cmzn_nodeiterator* iter = this->feNodeset->createNodeiterator();
-	cmzn_fieldcache* fieldcache = cmzn_fieldcache::create(region);
-	int return_code = CMZN_OK;
-	const int oldSize = this->labelsGroup->getSize();
-	if ((iter) && (fieldcache))
+	// evaluate all nodes before merging
+	DsLabelsGroup* addLabelsGroup = this->feNodeset->createLabelsGroup();
+	if (!addLabelsGroup)
 	{
-		cmzn_node* node = nullptr;
-		while ((node = iter->nextNode()))
-		{
-			fieldcache->setNode(node);
-			if (!cmzn_field_evaluate_boolean(conditionalField, fieldcache))
-			{
-				continue;
-			}
-			const int result = this->labelsGroup->setIndex(node->getIndex(), true);
-			if ((result != CMZN_OK) && (result != CMZN_ERROR_ALREADY_EXISTS))
-			{
-				return_code = result;
-				break;
-			}
-		}
+		return CMZN_ERROR_MEMORY;
 	}
-	else
+	int return_code = FE_nodeset_evaluate_conditional_labels_group(this->feNodeset, conditionalField,
+		/*sourceLabelsGroup*/nullptr, /*value*/true, this->getGroupCore()->getConditionalThreadsCount(),
+		*addLabelsGroup);
+	if ((CMZN_OK == return_code) && (addLabelsGroup->getSize() > 0))
 	{
-		return_code = CMZN_ERROR_MEMORY;
-	}
-	cmzn_fieldcache::deaccess(fieldcache);
-	cmzn::Deaccess(iter);
-	if (this->labelsGroup->getSize() > oldSize)
-	{
-		this->changeAdd();
+		return_code = this->addNodesInLabelsGroup(*addLabelsGroup);
 	}
+	cmzn::Deaccess(addLabelsGroup);
 	return return_code;
 }
 
@@ -250,49 +233,81 @@ int cmzn_nodeset_group::removeNodesConditional(cmzn_field* conditionalField)
 	{
 		return this->removeNodesInLabelsGroup(*(otherNodesetGroup->labelsGroup));
 	}
-	int return_code = CMZN_OK;
-	cmzn_nodeiterator* iter = this->feNodeset->createNodeiterator();
-	cmzn_fieldcache* fieldcache = cmzn_fieldcache::create(region);
-	cmzn_node* node = nullptr;
-	if ((iter) && (fieldcache))
+	// only need to evaluate nodes in this group
+	DsLabelsGroup* removeLabelsGroup = this->feNodeset->createLabelsGroup();
+	if (!removeLabelsGroup)
 	{
-		while ((node = iter->nextNode()))
-		{
-			fieldcache->setNode(node);
-			if (!cmzn_field_evaluate_boolean(conditionalField, fieldcache))
-			{
-				continue;
-			}
-			const int result = this->labelsGroup->setIndex(node->getIndex(), false);
-			if ((result != CMZN_OK) && (result != CMZN_ERROR_NOT_FOUND))
-			{
-				return_code = result;
-				break;
-			}
-		}
+		return CMZN_ERROR_MEMORY;
 	}
-	else
+	int return_code = FE_nodeset_evaluate_conditional_labels_group(this->feNodeset, conditionalField,
+		this->labelsGroup, /*value*/true, this->getGroupCore()->getConditionalThreadsCount(),
+		*removeLabelsGroup);
+	if ((CMZN_OK == return_code) && (removeLabelsGroup->getSize() > 0))
 	{
-		return_code = CMZN_ERROR_MEMORY;
+		return_code = this->removeNodesInLabelsGroup(*removeLabelsGroup);
 	}
-	cmzn::Deaccess(iter);
-	cmzn_fieldcache::deaccess(fieldcache);
+	cmzn::Deaccess(removeLabelsGroup);
+	return return_code;
+}
+
+int cmzn_nodeset_group::removeNodesInLabelsGroup(const DsLabelsGroup& removeLabelsGroup)
+{
+	const int oldSize = this->labelsGroup->getSize();
+	this->labelsGroup->removeGroup(removeLabelsGroup);
 	if (this->labelsGroup->getSize() < oldSize)
 	{
 		this->changeRemove();
 	}
+	return CMZN_OK;
+}
+
+int cmzn_nodeset_group::retainNodesConditional(cmzn_field* conditionalField)
+{
+	cmzn_region* region = this->getRegion();
+	if ((!region) || (!conditionalField) || (conditionalField->getRegion() != region))
+	{
+		return CMZN_ERROR_ARGUMENT;
+	}
+	if (this->labelsGroup->getSize() == 0)
+	{
+		return CMZN_OK;
+	}
+	bool isEmptyNodesetGroup = false;
+	const cmzn_nodeset_group* otherNodesetGroup = this->getConditionalNodesetGroup(conditionalField, isEmptyNodesetGroup);
+	if (isEmptyNodesetGroup)
+	{
+		return this->removeAllNodes();
+	}
+	if (otherNodesetGroup)
+	{
+		return this->retainNodesInLabelsGroup(*(otherNodesetGroup->labelsGroup));
+	}
+	// gather nodes to remove so group is not modified while evaluating
+	DsLabelsGroup* removeLabelsGroup = this->feNodeset->createLabelsGroup();
+	if (!removeLabelsGroup)
+	{
+		return CMZN_ERROR_MEMORY;
+	}
+	int return_code = FE_nodeset_evaluate_conditional_labels_group(this->feNodeset, conditionalField,
+		this->labelsGroup, /*value*/false, this->getGroupCore()->getConditionalThreadsCount(),
+		*removeLabelsGroup);
+	if ((CMZN_OK == return_code) && (removeLabelsGroup->getSize() > 0))
+	{
+		return_code = this->removeNodesInLabelsGroup(*removeLabelsGroup);
+	}
+	cmzn::Deaccess(removeLabelsGroup);
 	return return_code;
 }
 
-int cmzn_nodeset_group::removeNodesInLabelsGroup(const DsLabelsGroup& removeLabelsGroup)
+int cmzn_nodeset_group::retainNodesInLabelsGroup(const DsLabelsGroup& retainLabelsGroup)
 {
 	const int oldSize = this->labelsGroup->getSize();
-	this->labelsGroup->removeGroup(removeLabelsGroup);
+	const int return_code = this->labelsGroup->intersectGroup(retainLabelsGroup);
 	if (this->labelsGroup->getSize() < oldSize)
 	{
 		this->changeRemove();
 	}
-	return CMZN_OK;
+	return return_code;
 }
 
 int cmzn_nodeset_group::addElementNodes(cmzn_element* element)
@@ -449,6 +464,16 @@ int cmzn_nodeset_group_remove_nodes_conditional(cmzn_nodeset_group_id nodeset_gr
 	return CMZN_ERROR_ARGUMENT;
 }
 
+int cmzn_nodeset_group_retain_nodes_conditional(cmzn_nodeset_group_id nodeset_group,
+	cmzn_field_id conditional_field)
+{
+	if (nodeset_group)
+	{
+		return nodeset_group->retainNodesConditional(conditional_field);
+	}
+	return CMZN_ERROR_ARGUMENT;
+}
+
 int cmzn_nodeset_group_add_element_nodes(
 	cmzn_nodeset_group_id nodeset_group, cmzn_element_id element)
 {
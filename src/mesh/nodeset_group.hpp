@@ -143,6 +143,10 @@ public:
 
 	int removeNodesInLabelsGroup(const DsLabelsGroup& removeLabelsGroup);
 
+	int retainNodesConditional(cmzn_field* conditionalField);
+
+	int retainNodesInLabelsGroup(const DsLabelsGroup& retainLabelsGroup);
+
 	int addElementNodes(cmzn_element* element);
 
 	int removeElementNodes(cmzn_element* element);
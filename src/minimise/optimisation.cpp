@@ -53,6 +53,7 @@
 #include "general/message.h"
 #include "computed_field/computed_field_private.hpp"
 #include "minimise/optimisation.hpp"
+#include "minimise/sparse_symmetric_matrix.hpp"
 #include "general/enumerator_private.hpp"
 #include "computed_field/field_module.hpp"
 #include <iostream>
@@ -672,16 +673,9 @@ int Minimisation::minimise_Newton()
 	}
 	int solveParameterCount = (conditionalFieldInternal) ? conditionalParameterCount : globalParameterCount;
 
-	NEWMAT::ColumnVector globalJacobian(solveParameterCount);
-	globalJacobian = 0.0;
-	NEWMAT::SquareMatrix globalHessian(solveParameterCount);
-	globalHessian = 0.0;
-	std::vector<bool> parameterUsed(solveParameterCount, false);  // set to true if parameter used in element
-
-	std::vector<int> elementParameterIndexes;  // grows to fit maximum elementParametersCount
-	std::vector<double> elementJacobian;  // grows to fit maximum elementParametersCount
-	std::vector<double> elementHessian;  // grows to fit maximum elementParametersCount*elementParametersCount
-
+	// get mesh and scalar objective field for each objective
+	std::vector<Mesh> objectiveMeshes;
+	std::vector<Field> objectiveScalarFields;
 	for (ObjectiveFieldDataVector::iterator fieldIter = this->objectiveFields.begin();
 		fieldIter != this->objectiveFields.end(); ++fieldIter)
 	{
@@ -720,14 +714,68 @@ int Minimisation::minimise_Newton()
 		{
 			objectiveField = fieldmodule.createFieldSumComponents(objectiveField);
 		}
+		objectiveMeshes.push_back(mesh);
+		objectiveScalarFields.push_back(objectiveField);
+	}
+	const size_t objectiveCount = objectiveMeshes.size();
 
+	std::vector<int> elementParameterIndexes;  // grows to fit maximum elementParametersCount
+	std::vector<double> elementJacobian;  // grows to fit maximum elementParametersCount
+	std::vector<double> elementHessian;  // grows to fit maximum elementParametersCount*elementParametersCount
+
+	// first pass: get sparsity of global Hessian from element parameters
+	SparseSymmetricMatrix globalHessian(solveParameterCount);
+	std::vector<bool> parameterUsed(solveParameterCount, false);  // set to true if parameter used in element
+	for (size_t o = 0; o < objectiveCount; ++o)
+	{
 		Element element;
-		Elementiterator elementIter = mesh.createElementiterator();
-		int elementIndex = 0;
+		Elementiterator elementIter = objectiveMeshes[o].createElementiterator();
+		while ((element = elementIter.next()).isValid())
+		{
+			if (conditionalFieldInternal)
+			{
+				fieldcache.setElement(element);
+				if (!cmzn_field_evaluate_boolean(conditionalFieldInternal, fieldcache.getId()))
+				{
+					continue;
+				}
+			}
+			const int elementParametersCount = fieldparameters.getNumberOfElementParameters(element);
+			if (elementParametersCount <= 0)
+			{
+				continue;
+			}
+			if (elementParametersCount > static_cast<int>(elementParameterIndexes.size()))
+			{
+				elementParameterIndexes.resize(elementParametersCount);
+			}
+			fieldparameters.getElementParameterIndexesZero(element, elementParametersCount, elementParameterIndexes.data());
+			for (int i = 0; i < elementParametersCount; ++i)
+			{
+				int& index = elementParameterIndexes[i];
+				if (conditionalFieldInternal)
+				{
+					index = conditionalParameterIndex[index];  // -1 if excluded
+				}
+				if (index >= 0)
+				{
+					parameterUsed[index] = true;
+				}
+			}
+			globalHessian.addStructure(elementParametersCount, elementParameterIndexes.data());
+		}
+	}
+	globalHessian.endStructure();
+
+	// second pass: assemble
+	std::vector<double> globalJacobian(solveParameterCount, 0.0);
+	for (size_t o = 0; o < objectiveCount; ++o)
+	{
+		Field& objectiveField = objectiveScalarFields[o];
+		Element element;
+		Elementiterator elementIter = objectiveMeshes[o].createElementiterator();
 		while ((element = elementIter.next()).isValid())
 		{
-			++elementIndex;
-			//display_message(INFORMATION_MESSAGE, "Element %d (%d/%d)\n", element.getIdentifier(), elementIndex, elementCount);
 			fieldcache.setElement(element);
 			if (conditionalFieldInternal)
 			{
@@ -741,7 +789,7 @@ int Minimisation::minimise_Newton()
 			{
 				continue;  // GRC handle -1 error?
 			}
-			if (elementParametersCount > static_cast<int>(elementParameterIndexes.size()))
+			if (elementParametersCount > static_cast<int>(elementJacobian.size()))
 			{
 				elementParameterIndexes.resize(elementParametersCount);
 				elementJacobian.resize(elementParametersCount);
@@ -764,24 +812,30 @@ int Minimisation::minimise_Newton()
 			}
 
 			// assemble
+			if (conditionalFieldInternal)
+			{
+				for (int i = 0; i < elementParametersCount; ++i)
+				{
+					elementParameterIndexes[i] = conditionalParameterIndex[elementParameterIndexes[i]];
+				}
+			}
 			const double *elementHessianRow = elementHessian.data();
 			for (int i = 0; i < elementParametersCount; ++i)
 			{
-				int row = elementParameterIndexes[i];
-				if ((!conditionalFieldInternal) || ((row = conditionalParameterIndex[row]) >= 0))
+				const int row = elementParameterIndexes[i];
+				if (row >= 0)
 				{
-					parameterUsed[row] = true;
-					globalJacobian.element(row) -= elementJacobian[i];
+					globalJacobian[row] -= elementJacobian[i];
 					for (int j = 0; j < elementParametersCount; ++j)
 					{
-						int col = elementParameterIndexes[j];
-						if ((!conditionalFieldInternal) || ((col = conditionalParameterIndex[col]) >= 0))
+						const int col = elementParameterIndexes[j];
+						if (col >= 0)
 						{
-							globalHessian.element(row, col) += elementHessianRow[j];
+							globalHessian.addValue(row, col, elementHessianRow[j]);
 						}
 					}
-					elementHessianRow += elementParametersCount;
 				}
+				elementHessianRow += elementParametersCount;
 			}
 		}
 	}
@@ -790,7 +844,7 @@ int Minimisation::minimise_Newton()
 	{
 		if (!parameterUsed[i])
 		{
-			globalHessian.element(i, i) = 1.0;
+			globalHessian.setDiagonal(i, 1.0);
 			// warn which parameter is eliminated
 			cmzn_node_value_label valueLabel;
 			int fieldComponent, version;
@@ -801,13 +855,12 @@ int Minimisation::minimise_Newton()
 	}
 
 	// solve
-	NEWMAT::CroutMatrix LUmatrix = globalHessian;
-	if (LUmatrix.IsSingular())
+	std::vector<double> increment;
+	if (!globalHessian.solve(globalJacobian, increment))
 	{
 		display_message(ERROR_MESSAGE, "Optimisation optimise NEWTON:  Solution is singular.");
 		return 0;
 	}
-	NEWMAT::ColumnVector increment = LUmatrix.i()*globalJacobian;
 	const double *incrementData = increment.data();
 	std::vector<double> globalIncrement;
 	if (conditionalFieldInternal)
@@ -0,0 +1,350 @@
+/**
+ * @file sparse_symmetric_matrix.cpp
+ *
+ * Sparse matrix with symmetric non-zero structure, assembled from element
+ * contributions and solved with a profile LDL^T factorisation, or banded LU
+ * factorisation with partial pivoting if LDL^T is unsuitable.
+ */
+/* Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <algorithm>
+#include <cmath>
+#include "general/message.h"
+#include "minimise/sparse_symmetric_matrix.hpp"
+
+namespace {
+
+/** Sort and remove duplicates from indexes */
+void sortUnique(std::vector<int>& indexes)
+{
+	std::sort(indexes.begin(), indexes.end());
+	indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+}
+
+}
+
+SparseSymmetricMatrix::SparseSymmetricMatrix(int sizeIn) :
+	size((sizeIn > 0) ? sizeIn : 0),
+	structureRows(this->size)
+{
+}
+
+void SparseSymmetricMatrix::addStructure(int indexesCount, const int *indexes)
+{
+	for (int i = 0; i < indexesCount; ++i)
+	{
+		const int row = indexes[i];
+		if ((row < 0) || (row >= this->size))
+			continue;
+		std::vector<int>& structureRow = this->structureRows[row];
+		// remove duplicates before row storage would grow, since
+		// neighbouring elements share most indexes
+		if (structureRow.size() + indexesCount > structureRow.capacity())
+			sortUnique(structureRow);
+		for (int j = 0; j < indexesCount; ++j)
+		{
+			if ((indexes[j] >= 0) && (indexes[j] < this->size))
+				structureRow.push_back(indexes[j]);
+		}
+	}
+}
+
+void SparseSymmetricMatrix::endStructure()
+{
+	this->rowStarts.resize(this->size + 1);
+	size_t nonZerosCount = 0;
+	for (int row = 0; row < this->size; ++row)
+	{
+		std::vector<int>& structureRow = this->structureRows[row];
+		// always include diagonal
+		structureRow.push_back(row);
+		sortUnique(structureRow);
+		this->rowStarts[row] = nonZerosCount;
+		nonZerosCount += structureRow.size();
+	}
+	this->rowStarts[this->size] = nonZerosCount;
+	this->columnIndexes.resize(nonZerosCount);
+	for (int row = 0; row < this->size; ++row)
+	{
+		std::vector<int>& structureRow = this->structureRows[row];
+		std::copy(structureRow.begin(), structureRow.end(), this->columnIndexes.begin() + this->rowStarts[row]);
+		std::vector<int>().swap(structureRow);
+	}
+	std::vector<std::vector<int> >().swap(this->structureRows);
+	this->values.assign(nonZerosCount, 0.0);
+}
+
+void SparseSymmetricMatrix::setDiagonal(int index, double value)
+{
+	for (size_t k = this->rowStarts[index]; k < this->rowStarts[index + 1]; ++k)
+	{
+		if (this->columnIndexes[k] == index)
+		{
+			this->values[k] = value;
+			return;
+		}
+	}
+}
+
+/**
+ * Get reverse Cuthill-McKee ordering of rows/columns to reduce profile of
+ * factorised matrix.
+ * @param newToOld  On return, the old index for each new index.
+ */
+void SparseSymmetricMatrix::getBandwidthReducingOrder(std::vector<int>& newToOld) const
+{
+	newToOld.clear();
+	newToOld.reserve(this->size);
+	std::vector<int> degree(this->size);
+	for (int i = 0; i < this->size; ++i)
+		degree[i] = static_cast<int>(this->rowStarts[i + 1] - this->rowStarts[i]);
+	std::vector<bool> visited(this->size, false);
+	std::vector<int> neighbours;
+	// process each connected component from a low degree start
+	std::vector<int> byDegree(this->size);
+	for (int i = 0; i < this->size; ++i)
+		byDegree[i] = i;
+	std::stable_sort(byDegree.begin(), byDegree.end(),
+		[&degree](int a, int b) { return degree[a] < degree[b]; });
+	for (int s = 0; s < this->size; ++s)
+	{
+		const int start = byDegree[s];
+		if (visited[start])
+			continue;
+		size_t levelStart = newToOld.size();
+		newToOld.push_back(start);
+		visited[start] = true;
+		for (size_t n = levelStart; n < newToOld.size(); ++n)
+		{
+			const int index = newToOld[n];
+			neighbours.clear();
+			for (size_t k = this->rowStarts[index]; k < this->rowStarts[index + 1]; ++k)
+			{
+				const int neighbour = this->columnIndexes[k];
+				if (!visited[neighbour])
+				{
+					visited[neighbour] = true;
+					neighbours.push_back(neighbour);
+				}
+			}
+			std::stable_sort(neighbours.begin(), neighbours.end(),
+				[&degree](int a, int b) { return degree[a] < degree[b]; });
+			newToOld.insert(newToOld.end(), neighbours.begin(), neighbours.end());
+		}
+	}
+	std::reverse(newToOld.begin(), newToOld.end());
+}
+
+bool SparseSymmetricMatrix::solve(const std::vector<double>& rhs, std::vector<double>& x) const
+{
+	if ((static_cast<int>(rhs.size()) != this->size) || (this->rowStarts.size() != static_cast<size_t>(this->size + 1)))
+	{
+		display_message(ERROR_MESSAGE, "SparseSymmetricMatrix::solve.  Invalid arguments or structure not ended");
+		return false;
+	}
+	std::vector<int> newToOld;
+	this->getBandwidthReducingOrder(newToOld);
+	std::vector<int> oldToNew(this->size);
+	for (int i = 0; i < this->size; ++i)
+		oldToNew[newToOld[i]] = i;
+
+	// get first column in each reordered row of lower triangle
+	std::vector<int> first(this->size);
+	for (int i = 0; i < this->size; ++i)
+		first[i] = i;
+	for (int oldRow = 0; oldRow < this->size; ++oldRow)
+	{
+		const int i = oldToNew[oldRow];
+		for (size_t k = this->rowStarts[oldRow]; k < this->rowStarts[oldRow + 1]; ++k)
+		{
+			const int j = oldToNew[this->columnIndexes[k]];
+			if (j < first[i])
+				first[i] = j;
+		}
+	}
+	// profile storage: row i holds columns first[i]..i inclusive
+	std::vector<size_t> profileStarts(this->size + 1);
+	size_t profileSize = 0;
+	int bandwidth = 0;
+	for (int i = 0; i < this->size; ++i)
+	{
+		if (i - first[i] > bandwidth)
+			bandwidth = i - first[i];
+		profileStarts[i] = profileSize - first[i];  // so column j is at profileStarts[i] + j
+		profileSize += i - first[i] + 1;
+	}
+	std::vector<double> profile(profileSize, 0.0);
+	// fill lower triangle with symmetric part of matrix
+	double maximumDiagonal = 0.0;
+	for (int oldRow = 0; oldRow < this->size; ++oldRow)
+	{
+		const int i = oldToNew[oldRow];
+		for (size_t k = this->rowStarts[oldRow]; k < this->rowStarts[oldRow + 1]; ++k)
+		{
+			const int j = oldToNew[this->columnIndexes[k]];
+			const double value = this->values[k];
+			if (j < i)
+				profile[profileStarts[i] + j] += 0.5*value;
+			else if (j > i)
+				profile[profileStarts[j] + i] += 0.5*value;
+			else
+			{
+				profile[profileStarts[i] + i] += value;
+				if (fabs(value) > maximumDiagonal)
+					maximumDiagonal = fabs(value);
+			}
+		}
+	}
+
+	// factorise in place: off-diagonals become L, diagonal becomes D.
+	// Without pivoting this is only stable for positive definite matrices
+	const double pivotTolerance = 1.0E-14*((maximumDiagonal > 0.0) ? maximumDiagonal : 1.0);
+	for (int i = 0; i < this->size; ++i)
+	{
+		double *rowI = profile.data() + profileStarts[i];
+		const int firstI = first[i];
+		// compute g_ij = L_ij*D_j
+		for (int j = firstI; j < i; ++j)
+		{
+			const double *rowJ = profile.data() + profileStarts[j];
+			double sum = rowI[j];
+			for (int k = std::max(firstI, first[j]); k < j; ++k)
+				sum -= rowI[k]*rowJ[k];
+			rowI[j] = sum;
+		}
+		double diagonal = rowI[i];
+		for (int k = firstI; k < i; ++k)
+		{
+			const double g = rowI[k];
+			const double l = g/profile[profileStarts[k] + k];
+			diagonal -= l*g;
+			rowI[k] = l;
+		}
+		if ((!std::isfinite(diagonal)) || (diagonal <= pivotTolerance))
+			return this->solveBandLU(newToOld, oldToNew, bandwidth, rhs, x);
+		rowI[i] = diagonal;
+	}
+
+	// solve L.D.L^T.y = P.rhs
+	std::vector<double> y(this->size);
+	for (int i = 0; i < this->size; ++i)
+	{
+		const double *rowI = profile.data() + profileStarts[i];
+		double sum = rhs[newToOld[i]];
+		for (int k = first[i]; k < i; ++k)
+			sum -= rowI[k]*y[k];
+		y[i] = sum;
+	}
+	for (int i = 0; i < this->size; ++i)
+		y[i] /= profile[profileStarts[i] + i];
+	for (int i = this->size - 1; i >= 0; --i)
+	{
+		const double *rowI = profile.data() + profileStarts[i];
+		const double yi = y[i];
+		for (int k = first[i]; k < i; ++k)
+			y[k] -= rowI[k]*yi;
+	}
+	x.resize(this->size);
+	for (int i = 0; i < this->size; ++i)
+		x[newToOld[i]] = y[i];
+	return true;
+}
+
+/**
+ * Solve matrix.x = rhs by LU factorisation with partial pivoting of the
+ * reordered matrix in band storage, as for LAPACK dgbtrf/dgbtrs. Row
+ * interchanges can increase the upper bandwidth to twice the lower bandwidth.
+ * @param newToOld  Old index for each new index from reordering.
+ * @param oldToNew  New index for each old index from reordering.
+ * @param bandwidth  Maximum distance of a non-zero from the diagonal in the
+ * reordered matrix.
+ */
+bool SparseSymmetricMatrix::solveBandLU(const std::vector<int>& newToOld, const std::vector<int>& oldToNew,
+	int bandwidth, const std::vector<double>& rhs, std::vector<double>& x) const
+{
+	const int n = this->size;
+	const int kl = bandwidth;
+	const int kv = 2*bandwidth;  // upper bandwidth of U including fill from row interchanges
+	const size_t ldab = static_cast<size_t>(kl + kv + 1);
+	// entry (i, j) of reordered matrix is at band[kv + i - j + j*ldab]
+	std::vector<double> band(ldab*n, 0.0);
+	double maximumValue = 0.0;
+	for (int oldRow = 0; oldRow < n; ++oldRow)
+	{
+		const int i = oldToNew[oldRow];
+		for (size_t k = this->rowStarts[oldRow]; k < this->rowStarts[oldRow + 1]; ++k)
+		{
+			const int j = oldToNew[this->columnIndexes[k]];
+			const double value = this->values[k];
+			band[kv + i - j + j*ldab] = value;
+			if (fabs(value) > maximumValue)
+				maximumValue = fabs(value);
+		}
+	}
+	const double pivotTolerance = 1.0E-14*((maximumValue > 0.0) ? maximumValue : 1.0);
+	std::vector<int> pivots(n);
+	int lastColumn = 0;  // last column of U with fill so far
+	for (int j = 0; j < n; ++j)
+	{
+		double *columnJ = band.data() + kv + j*ldab;  // columnJ[p] = entry (j + p, j)
+		const int rowsBelow = std::min(kl, n - 1 - j);
+		int pivotOffset = 0;
+		for (int p = 1; p <= rowsBelow; ++p)
+		{
+			if (fabs(columnJ[p]) > fabs(columnJ[pivotOffset]))
+				pivotOffset = p;
+		}
+		pivots[j] = j + pivotOffset;
+		if ((!std::isfinite(columnJ[pivotOffset])) || (fabs(columnJ[pivotOffset]) <= pivotTolerance))
+			return false;
+		lastColumn = std::max(lastColumn, std::min(j + kl + pivotOffset, n - 1));
+		if (pivotOffset != 0)
+		{
+			for (int c = j; c <= lastColumn; ++c)
+				std::swap(band[kv + j - c + c*ldab], band[kv + j + pivotOffset - c + c*ldab]);
+		}
+		const double pivot = columnJ[0];
+		for (int p = 1; p <= rowsBelow; ++p)
+			columnJ[p] /= pivot;
+		for (int c = j + 1; c <= lastColumn; ++c)
+		{
+			double *columnC = band.data() + kv + j - c + c*ldab;  // columnC[p] = entry (j + p, c)
+			const double u = columnC[0];
+			if (u != 0.0)
+			{
+				for (int p = 1; p <= rowsBelow; ++p)
+					columnC[p] -= columnJ[p]*u;
+			}
+		}
+	}
+	// solve L.U.y = P.rhs
+	std::vector<double> y(n);
+	for (int i = 0; i < n; ++i)
+		y[i] = rhs[newToOld[i]];
+	for (int j = 0; j < n; ++j)
+	{
+		if (pivots[j] != j)
+			std::swap(y[j], y[pivots[j]]);
+		const double *columnJ = band.data() + kv + j*ldab;
+		const double yj = y[j];
+		const int rowsBelow = std::min(kl, n - 1 - j);
+		for (int p = 1; p <= rowsBelow; ++p)
+			y[j + p] -= columnJ[p]*yj;
+	}
+	for (int i = n - 1; i >= 0; --i)
+	{
+		double sum = y[i];
+		const int lastC = std::min(n - 1, i + kv);
+		for (int c = i + 1; c <= lastC; ++c)
+			sum -= band[kv + i - c + c*ldab]*y[c];
+		y[i] = sum/band[kv + i*ldab];
+	}
+	x.resize(n);
+	for (int i = 0; i < n; ++i)
+		x[newToOld[i]] = y[i];
+	return true;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file sparse_symmetric_matrix.hpp
+ *
+ * Sparse matrix with symmetric non-zero structure, assembled from element
+ * contributions and solved with a profile LDL^T factorisation, or banded LU
+ * factorisation with partial pivoting if LDL^T is unsuitable.
+ */
+/* Zinc Library
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SPARSE_SYMMETRIC_MATRIX_HPP_
+#define SPARSE_SYMMETRIC_MATRIX_HPP_
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Square sparse matrix in compressed sparse row (CSR) storage with symmetric
+ * non-zero structure, as for a global Hessian assembled from elements.
+ * Usage: add the parameter indexes of each element with addStructure(),
+ * call endStructure(), add values with addValue() then call solve().
+ */
+class SparseSymmetricMatrix
+{
+	int size;
+	// rows of column indexes while defining structure; cleared by endStructure
+	std::vector<std::vector<int> > structureRows;
+	// CSR row start offsets into columnIndexes and values, size + 1 entries
+	std::vector<size_t> rowStarts;
+	// sorted column indexes in each row
+	std::vector<int> columnIndexes;
+	std::vector<double> values;
+
+	void getBandwidthReducingOrder(std::vector<int>& newToOld) const;
+
+	bool solveBandLU(const std::vector<int>& newToOld, const std::vector<int>& oldToNew,
+		int bandwidth, const std::vector<double>& rhs, std::vector<double>& x) const;
+
+public:
+
+	SparseSymmetricMatrix(int sizeIn);
+
+	int getSize() const
+	{
+		return this->size;
+	}
+
+	/** @return  Number of stored entries, available after endStructure(). */
+	size_t getNonZerosCount() const
+	{
+		return this->columnIndexes.size();
+	}
+
+	/** Add non-zero structure coupling all supplied indexes with each other.
+	 * Only valid before endStructure().
+	 * @param indexesCount  Number of indexes.
+	 * @param indexes  Matrix row/column indexes from 0 to size - 1. Negative
+	 * indexes are ignored. */
+	void addStructure(int indexesCount, const int *indexes);
+
+	/** Finish defining structure and allocate zeroed values. */
+	void endStructure();
+
+	/** Add value at row, column which must be in structure.
+	 * @return  True on success, false if not in structure. */
+	bool addValue(int row, int column, double value)
+	{
+		const int *columnsBegin = this->columnIndexes.data() + this->rowStarts[row];
+		const int *columnsEnd = this->columnIndexes.data() + this->rowStarts[row + 1];
+		// binary search sorted columns
+		while (columnsBegin < columnsEnd)
+		{
+			const int *middle = columnsBegin + (columnsEnd - columnsBegin)/2;
+			if (*middle < column)
+				columnsBegin = middle + 1;
+			else
+				columnsEnd = middle;
+		}
+		if ((columnsBegin == this->columnIndexes.data() + this->rowStarts[row + 1]) || (*columnsBegin != column))
+			return false;
+		this->values[columnsBegin - this->columnIndexes.data()] += value;
+		return true;
+	}
+
+	/** Set diagonal entry for index, which must be in structure. */
+	void setDiagonal(int index, double value);
+
+	/** Solve matrix.x = rhs after reordering rows and columns to reduce the
+	 * profile. First tries LDL^T factorisation of the symmetric part of the
+	 * matrix without pivoting, as suits positive definite Hessians near a
+	 * minimum. If any pivot is negative or near zero, as for indefinite or
+	 * nearly singular Hessians away from a minimum, falls back to LU
+	 * factorisation of the matrix with partial pivoting in band storage.
+	 * @param rhs  Right hand side vector of size entries.
+	 * @param x  On success, solution vector of size entries.
+	 * @return  True on success, false if matrix is singular to working precision. */
+	bool solve(const std::vector<double>& rhs, std::vector<double>& x) const;
+};
+
+#endif /* SPARSE_SYMMETRIC_MATRIX_HPP_ */
@@ -443,6 +443,8 @@ int cmzn_nodetemplate::mergeIntoNode(cmzn_node* node)
 	FE_nodeset* target_fe_nodeset = FE_node_get_FE_nodeset(node);
 	if (target_fe_nodeset == this->fe_nodeset)
 	{
+		if (!this->fe_nodeset->getRegion()->checkModifiable("cmzn_node_merge"))
+			return CMZN_ERROR_IN_USE;
 		if (this->validate())
 		{
 			int return_code = CMZN_OK;
@@ -141,6 +141,7 @@ cmzn_region::cmzn_region(cmzn_context* contextIn) :
 	field_cache_size(0),
 	scene(nullptr),
 	fieldModifyCounter(0),
+	frozen(false),
 	change_level(0),
 	hierarchical_change_level(0),
 	regionChanged(false),
@@ -447,6 +448,18 @@ int cmzn_region::endChange()
 	}
 }
 
+void cmzn_region::reportFrozenModify(const char *location) const
+{
+	display_message(ERROR_MESSAGE, "%s.  Cannot modify region %s while it is frozen for concurrent evaluation",
+		(location) ? location : "cmzn_region::setFieldModify", (this->name) ? this->name : "");
+}
+
+int cmzn_region::setFrozen(bool frozenIn)
+{
+	this->frozen = frozenIn;
+	return CMZN_OK;
+}
+
 /**
  * Returns the sum of the hierarchical_change_level members of region and all
  * its ancestors. Equals the number of begin_change calls needed for new
@@ -630,6 +643,7 @@ int cmzn_region::addField(cmzn_field *field)
  */
 void cmzn_region::addFieldDerivative(FieldDerivative *fieldDerivative)
 {
+	const std::lock_guard<std::recursive_mutex> lock(this->sharedObjectsMutex);
 	const int size = static_cast<int>(this->fieldDerivatives.size());
 	for (int i = 0; i < size; ++i)
 		if (!this->fieldDerivatives[i])
@@ -650,6 +664,7 @@ void cmzn_region::removeFieldDerivative(FieldDerivative *fieldDerivative)
 		display_message(ERROR_MESSAGE, "cmzn_region::removeFieldDerivative.  Invalid field derivative");
 		return;
 	}
+	const std::lock_guard<std::recursive_mutex> lock(this->sharedObjectsMutex);
 	const int derivativeCacheIndex = fieldDerivative->getCacheIndex();
 	const int size = static_cast<int>(this->fieldDerivatives.size());
 	if ((fieldDerivative->getRegion() != this) || (derivativeCacheIndex < 0) || (derivativeCacheIndex >= size))
@@ -659,6 +674,7 @@ void cmzn_region::removeFieldDerivative(FieldDerivative *fieldDerivative)
 	}
 	fieldDerivative->setRegionAndCacheIndexPrivate();
 	// remove derivative caches from field caches so index can be recycled
+	const std::lock_guard<std::mutex> cachesLock(this->field_caches_mutex);
 	for (std::list<cmzn_fieldcache_id>::iterator iter = this->field_caches.begin();
 		iter != this->field_caches.end(); ++iter)
 	{
@@ -1510,6 +1526,20 @@ int cmzn_region_end_hierarchical_change(struct cmzn_region *region)
 	return 0;
 }
 
+bool cmzn_region_is_frozen(cmzn_region_id region)
+{
+	if (region)
+		return region->isFrozen();
+	return false;
+}
+
+int cmzn_region_set_frozen(cmzn_region_id region, bool frozen)
+{
+	if (region)
+		return region->setFrozen(frozen);
+	return CMZN_ERROR_ARGUMENT;
+}
+
 cmzn_context_id cmzn_region_get_context(cmzn_region_id region)
 {
 	if (region)
@@ -18,7 +18,9 @@
 #include "cmlibs/zinc/types/regionid.h"
 #include "computed_field/computed_field.h"
 #include "computed_field/field_derivative.hpp"
+#include <atomic>
 #include <list>
+#include <mutex>
 
 
 /*
@@ -156,7 +158,13 @@ private:
 	// all field caches currently in use for this region, for clearing
 	// when fields changed, and adding value caches for new fields.
 	std::list<cmzn_fieldcache_id> field_caches;
+	// guards adding and removing field_caches, which may be done by concurrent evaluations
+	std::mutex field_caches_mutex;
 	std::vector<FieldDerivative *> fieldDerivatives;
+	// guards objects created on demand by evaluations, which may be concurrent
+	// while frozen, e.g. field derivatives and mesh field ranges caches.
+	// Recursive as derivatives are created from lower derivatives.
+	std::recursive_mutex sharedObjectsMutex;
 
 	// Scene gives visualisation of region content
 	cmzn_scene *scene;
@@ -165,6 +173,9 @@ private:
 	// can detect if their values are invalid.
 	int fieldModifyCounter;
 
+	// set while region is frozen for concurrent read-only evaluation
+	bool frozen;
+
 	/* increment/decrement change_level to nest changes. Message sent when zero */
 	int change_level;
 	/* number of hierarchical changes in progress on this region tree. A region's
@@ -180,8 +191,9 @@ private:
 	// list of notifiers which receive field module callbacks
 	cmzn_fieldmodulenotifier_list fieldmodulenotifierList;
 
-	/* number of objects using this region */
-	int access_count;
+	/* number of objects using this region. Atomic as field caches access the
+	 * region, and may be created by concurrent evaluations */
+	std::atomic_int access_count;
 
 	cmzn_region(cmzn_context* contextIn);
 
@@ -254,8 +266,7 @@ public:
 	{
 		if (!region)
 			return CMZN_ERROR_ARGUMENT;
-		--(region->access_count);
-        if (region->access_count <= 0)
+        if (--(region->access_count) <= 0)
         {
             delete region;
         }
@@ -274,11 +285,57 @@ public:
 		region = newRegion;
 	}
 
-	// all code which modifies values of fields must call this to ensure
-	// field caches are recalculated
-	inline void setFieldModify()
+	/** All code which modifies values of fields must call this to ensure
+	 * field caches are recalculated. Modification is refused while frozen.
+	 * @return  Result OK, or ERROR_IN_USE with error reported if region is
+	 * frozen, in which case caller must not record the change. */
+	inline int setFieldModify()
 	{
+		if (this->frozen)
+		{
+			this->reportFrozenModify();
+			return CMZN_ERROR_IN_USE;
+		}
 		++(this->fieldModifyCounter);
+		return CMZN_OK;
+	}
+
+	/** Report error for attempted modification of frozen region.
+	 * @param location  Name of calling function, or nullptr if unknown. */
+	void reportFrozenModify(const char *location = nullptr) const;
+
+	/** @return  True if region is frozen for concurrent read-only evaluation. */
+	bool isFrozen() const
+	{
+		return this->frozen;
+	}
+
+	/** Freeze or unfreeze region for concurrent read-only evaluation.
+	 * @return  Result OK. */
+	int setFrozen(bool frozenIn);
+
+	/** Check region may be modified, reporting an error if it is frozen.
+	 * @param location  Name of calling function for error message.
+	 * @return  True if region is not frozen, otherwise false. */
+	bool checkModifiable(const char *location) const
+	{
+		if (this->frozen)
+		{
+			this->reportFrozenModify(location);
+			return false;
+		}
+		return true;
+	}
+
+	/** Lock to hold while finding or creating objects on demand which are
+	 * shared by evaluations, as they may be concurrent while frozen.
+	 * @param region  Region owning objects. If nullptr, e.g. while region is
+	 * being destroyed, the returned lock does not own a mutex. */
+	static std::unique_lock<std::recursive_mutex> lockSharedObjects(cmzn_region *region)
+	{
+		if (region)
+			return std::unique_lock<std::recursive_mutex>(region->sharedObjectsMutex);
+		return std::unique_lock<std::recursive_mutex>();
 	}
 
 	// field caches store current value when calculating at a new location
@@ -395,7 +452,10 @@ public:
 	void addFieldcache(cmzn_fieldcache *fieldcache)
 	{
 		if (fieldcache)
+		{
+			const std::lock_guard<std::mutex> lock(this->field_caches_mutex);
 			this->field_caches.push_back(fieldcache);
+		}
 	}
 
 	/** Called only by Fieldcache destructor.
@@ -404,7 +464,10 @@ public:
 	void removeFieldcache(cmzn_fieldcache *fieldcache)
 	{
 		if (fieldcache)
+		{
+			const std::lock_guard<std::mutex> lock(this->field_caches_mutex);
 			this->field_caches.remove(fieldcache);
+		}
 	}
 
 	/**
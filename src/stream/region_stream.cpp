@@ -10,6 +10,7 @@
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <vector>
 #include "cmlibs/zinc/streamregion.h"
 #include "cmlibs/zinc/streamregion.h"
 #include "field_io/fieldml_common.hpp"
@@ -18,7 +19,9 @@
 #include "finite_element/export_finite_element.h"
 #include "finite_element/import_finite_element.h"
 #include "general/debug.h"
+#include "general/message.h"
 #include "general/mystring.h"
+#include "general/thread_pool.hpp"
 #include "region/cmiss_region.hpp"
 #include "stream/region_stream.hpp"
 
@@ -52,6 +55,7 @@ int cmzn_region_read_from_memory(struct cmzn_region *region, const void *memory_
 				display_message(WARNING_MESSAGE, "cmzn_region_read.  Cannot read FieldML from memory resource");
 				break;
 			case CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX:
+			case CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX_BINARY:
 			{
 				// We should add a way to define a memory block without requiring specifying a name.
 				IO_stream_package_define_memory_block(io_stream_package,
@@ -105,6 +109,7 @@ int cmzn_region_read_field_file_of_name(struct cmzn_region *region, const char *
 			return_code = parse_fieldml_file(region, file_name) ? CMZN_OK : CMZN_ERROR_GENERAL;
 			break;
 		case CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX:
+		case CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX_BINARY:
 			return_code = read_exregion_file_of_name(region, file_name, io_stream_package, time_index,
 				useData, data_compression_type) ? CMZN_OK : CMZN_ERROR_GENERAL;
 			break;
@@ -116,121 +121,315 @@ int cmzn_region_read_field_file_of_name(struct cmzn_region *region, const char *
 	return return_code;
 }
 
+/** Description of a single resource to read, gathered before reading. */
+struct RegionReadResource
+{
+	char *fileName;  // owned; set for file resources
+	const void *memoryBlock;  // set for memory resources
+	unsigned int bufferSize;
+	FE_import_time_index timeIndexValue;
+	FE_import_time_index *timeIndex;
+	int readData;
+	cmzn_streaminformation_data_compression_type dataCompressionType;
+	cmzn_streaminformation_region_file_format fileFormat;
+	int returnCode;
+
+	RegionReadResource() :
+		fileName(nullptr),
+		memoryBlock(nullptr),
+		bufferSize(0),
+		timeIndex(nullptr),
+		readData(0),
+		dataCompressionType(CMZN_STREAMINFORMATION_DATA_COMPRESSION_TYPE_NONE),
+		fileFormat(CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_AUTOMATIC),
+		returnCode(CMZN_OK)
+	{
+	}
+
+	RegionReadResource(const RegionReadResource&) = delete;
+	RegionReadResource& operator=(const RegionReadResource&) = delete;
+
+	~RegionReadResource()
+	{
+		if (this->fileName)
+			DEALLOCATE(this->fileName);
+	}
+
+	bool isValid() const
+	{
+		return (this->fileName) || (this->memoryBlock);
+	}
+
+	/** @return  True if resource can be read on any thread: EX format only */
+	bool isThreadSafe()
+	{
+		if (this->fileFormat == CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_AUTOMATIC)
+		{
+			if (this->fileName)
+				this->fileFormat = is_FieldML_file(this->fileName) ?
+					CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_FIELDML : CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX;
+			else if (this->memoryBlock)
+				this->fileFormat = is_FieldML_memory_block(this->bufferSize, this->memoryBlock) ?
+					CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_FIELDML : CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX;
+		}
+		return this->isValid() && ((this->fileFormat == CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX) ||
+			(this->fileFormat == CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX_BINARY));
+	}
+
+	/** Read resource into region, setting returnCode.
+	 * @param io_stream_package  Package for reading files, not shared between threads. */
+	void read(cmzn_region *region, IO_stream_package *io_stream_package)
+	{
+		if (this->fileName)
+		{
+			this->returnCode = cmzn_region_read_field_file_of_name(region, this->fileName, io_stream_package, this->timeIndex,
+				this->readData, this->dataCompressionType, this->fileFormat);
+			if (this->returnCode != CMZN_OK)
+				display_message(ERROR_MESSAGE, "cmzn_region_read.  Cannot read file %s", this->fileName);
+		}
+		else if (this->memoryBlock)
+		{
+			this->returnCode = cmzn_region_read_from_memory(region, this->memoryBlock, this->bufferSize, this->timeIndex,
+				this->readData, this->dataCompressionType, this->fileFormat);
+			if (this->returnCode != CMZN_OK)
+				display_message(ERROR_MESSAGE, "cmzn_region_read.  Cannot read memory resource");
+		}
+		else
+		{
+			this->returnCode = CMZN_ERROR_GENERAL;
+			display_message(ERROR_MESSAGE, "cmzn_region_read.  Stream error");
+		}
+	}
+};
+
+/**
+ * Read resources concurrently into separate temporary regions, then merge
+ * them in order into the first temporary region.
+ * @param region  The region being read into, parent of temporary regions.
+ * @param resources  Resources to read, all thread safe.
+ * @param threadsCount  Maximum number of threads to read with, at least 2.
+ * @param memoryMapFiles  If true, read uncompressed files through a memory mapping.
+ * @param mergedRegion  On success set to temporary region containing all
+ * resources, accessed; otherwise set to nullptr.
+ * @return  Result OK on success, result of reading the first resource that
+ * failed, ERROR_INCOMPATIBLE_DATA if resources cannot be merged, or
+ * ERROR_MEMORY if failed to create temporary regions.
+ */
+int cmzn_region_read_resources_threaded(cmzn_region *region,
+	std::vector<RegionReadResource *>& resources, int threadsCount,
+	bool memoryMapFiles, cmzn_region *&mergedRegion)
+{
+	mergedRegion = nullptr;
+	const size_t resourcesCount = resources.size();
+	// create temporary regions on main thread
+	std::vector<cmzn_region *> tempRegions(resourcesCount, nullptr);
+	int return_code = CMZN_OK;
+	for (size_t r = 0; r < resourcesCount; ++r)
+	{
+		tempRegions[r] = cmzn_region_create_region(region);
+		if (!tempRegions[r])
+		{
+			return_code = CMZN_ERROR_MEMORY;
+			break;
+		}
+		tempRegions[r]->beginHierarchicalChange();
+	}
+	if (return_code == CMZN_OK)
+	{
+		const int workersCount = (static_cast<size_t>(threadsCount) < resourcesCount) ?
+			threadsCount : static_cast<int>(resourcesCount);
+		// stream packages are not shared between threads; created on first use by each worker
+		std::vector<IO_stream_package *> workerPackages(workersCount, nullptr);
+		const bool success = ThreadPool::getShared().executeChunks(workersCount, resourcesCount,
+			[&](int workerIndex, size_t r)
+			{
+				IO_stream_package *&io_stream_package = workerPackages[workerIndex];
+				if (!io_stream_package)
+				{
+					io_stream_package = CREATE(IO_stream_package)();
+					if (!io_stream_package)
+						return false;  // resources not read keep OK result
+					IO_stream_package_set_memory_map_files(io_stream_package, memoryMapFiles);
+				}
+				RegionReadResource& resource = *(resources[r]);
+				resource.read(tempRegions[r], io_stream_package);
+				return (resource.returnCode == CMZN_OK);
+			});
+		for (int w = 0; w < workersCount; ++w)
+			if (workerPackages[w])
+				DESTROY(IO_stream_package)(&workerPackages[w]);
+		if (!success)
+		{
+			// report result of first resource in order which failed to read
+			return_code = CMZN_ERROR_MEMORY;
+			for (size_t r = 0; r < resourcesCount; ++r)
+				if (resources[r]->returnCode != CMZN_OK)
+				{
+					return_code = resources[r]->returnCode;
+					break;
+				}
+		}
+	}
+	// end change before merge otherwise there will be callbacks for changes
+	// to half-temporary, half-global objects, leading to errors
+	for (size_t r = 0; r < resourcesCount; ++r)
+		if (tempRegions[r])
+			tempRegions[r]->endHierarchicalChange();
+	if (return_code == CMZN_OK)
+	{
+		mergedRegion = tempRegions[0];
+		tempRegions[0] = nullptr;
+		mergedRegion->beginHierarchicalChange();
+		for (size_t r = 1; r < resourcesCount; ++r)
+		{
+			if (!mergedRegion->canMerge(*tempRegions[r]))
+			{
+				display_message(ERROR_MESSAGE, "cmzn_region_read.  Resource %d is incompatible with earlier resources",
+					static_cast<int>(r + 1));
+				return_code = CMZN_ERROR_INCOMPATIBLE_DATA;
+				break;
+			}
+			return_code = mergedRegion->merge(*tempRegions[r]);
+			if (return_code != CMZN_OK)
+				break;
+		}
+		mergedRegion->endHierarchicalChange();
+		if (return_code != CMZN_OK)
+			cmzn_region::deaccess(mergedRegion);
+	}
+	for (size_t r = 0; r < resourcesCount; ++r)
+		if (tempRegions[r])
+			cmzn_region::deaccess(tempRegions[r]);
+	return return_code;
+}
+
 }
 
 int cmzn_region_read(cmzn_region_id region,
 	cmzn_streaminformation_region_id streaminformation_region)
 {
-	struct FE_import_time_index time_index_value, *time_index = NULL,
-		stream_time_index_value, *stream_time_index = NULL;
 	int return_code = CMZN_OK;
 	if (region && streaminformation_region &&
 		(cmzn_streaminformation_region_get_region_private(streaminformation_region) == region))
 	{
-		enum cmzn_streaminformation_data_compression_type data_compression_type =
-			CMZN_STREAMINFORMATION_DATA_COMPRESSION_TYPE_NONE;
+		if (!region->checkModifiable("cmzn_region_read"))
+			return CMZN_ERROR_IN_USE;
 		const cmzn_stream_properties_list streams_list = streaminformation_region->getResourcesList();
-		struct IO_stream_package *io_stream_package = CREATE(IO_stream_package)();
-		cmzn_region_begin_hierarchical_change(region);
-		struct cmzn_region *temp_region = cmzn_region_create_region(region);
-		if (!(streams_list.empty()) && io_stream_package && temp_region)
+		if (streams_list.empty())
+			return CMZN_OK;
+		FE_import_time_index time_index_value, *time_index = nullptr;
+		if (cmzn_streaminformation_region_has_attribute(streaminformation_region,
+			CMZN_STREAMINFORMATION_REGION_ATTRIBUTE_TIME))
 		{
-			temp_region->beginHierarchicalChange();
-			cmzn_stream_properties_list_const_iterator iter;
-			cmzn_resource_properties *stream_properties = NULL;
-			cmzn_streamresource_id stream = NULL;
-			if (cmzn_streaminformation_region_has_attribute(streaminformation_region,
-				CMZN_STREAMINFORMATION_REGION_ATTRIBUTE_TIME))
+			time_index_value.time = cmzn_streaminformation_region_get_attribute_real(
+				streaminformation_region, CMZN_STREAMINFORMATION_REGION_ATTRIBUTE_TIME);
+			time_index = &time_index_value;
+		}
+		cmzn_streaminformation_id streaminformation = cmzn_streaminformation_region_base_cast(
+			streaminformation_region);
+		const cmzn_streaminformation_region_file_format fileFormat =
+			cmzn_streaminformation_region_get_file_format(streaminformation_region);
+		std::vector<RegionReadResource *> resources;
+		resources.reserve(streams_list.size());
+		for (cmzn_stream_properties_list_const_iterator iter = streams_list.begin(); iter != streams_list.end(); ++iter)
+		{
+			cmzn_streamresource_id stream = (*iter)->getResource();
+			RegionReadResource *resource = new RegionReadResource();
+			if (cmzn_streaminformation_region_has_resource_attribute(
+				streaminformation_region, stream, CMZN_STREAMINFORMATION_REGION_ATTRIBUTE_TIME))
 			{
-				time_index_value.time = cmzn_streaminformation_region_get_attribute_real(
-					streaminformation_region, CMZN_STREAMINFORMATION_REGION_ATTRIBUTE_TIME);
-				time_index = &time_index_value;
+				resource->timeIndexValue.time = cmzn_streaminformation_region_get_resource_attribute_real(
+					streaminformation_region, stream, CMZN_STREAMINFORMATION_REGION_ATTRIBUTE_TIME);
+				resource->timeIndex = &resource->timeIndexValue;
 			}
-			for (iter = streams_list.begin(); (iter != streams_list.end()) && (return_code == CMZN_OK); ++iter)
+			else
 			{
-				data_compression_type = CMZN_STREAMINFORMATION_DATA_COMPRESSION_TYPE_NONE;
-				stream_properties = *iter;
-				stream = stream_properties->getResource();
-				if (cmzn_streaminformation_region_has_resource_attribute(
-					streaminformation_region, stream, CMZN_STREAMINFORMATION_REGION_ATTRIBUTE_TIME))
-				{
-					stream_time_index_value.time = cmzn_streaminformation_region_get_resource_attribute_real(
-						streaminformation_region, stream, CMZN_STREAMINFORMATION_REGION_ATTRIBUTE_TIME);
-					stream_time_index = &stream_time_index_value;
-				}
-				else
-				{
-					stream_time_index = time_index;
-				}
-				cmzn_streaminformation_id streaminformation = cmzn_streaminformation_region_base_cast(
-					streaminformation_region);
-				data_compression_type = cmzn_streaminformation_get_resource_data_compression_type(streaminformation, stream);
-				if (data_compression_type ==	CMZN_STREAMINFORMATION_DATA_COMPRESSION_TYPE_DEFAULT)
-				{
-					data_compression_type = cmzn_streaminformation_get_data_compression_type(streaminformation);
-				}
-				cmzn_streaminformation_region_file_format fileFormat =
-					cmzn_streaminformation_region_get_file_format(streaminformation_region);
-				cmzn_streamresource_file_id file_resource = cmzn_streamresource_cast_file(stream);
-				cmzn_streamresource_memory_id memory_resource = NULL;
-				const void *memory_block = NULL;
-				unsigned int buffer_size = 0;
-				int readData = 0;
-				int domain_type = cmzn_streaminformation_region_get_resource_domain_types(
-					streaminformation_region, stream);
-				if ((domain_type & CMZN_FIELD_DOMAIN_TYPE_DATAPOINTS) && (!(domain_type & CMZN_FIELD_DOMAIN_TYPE_NODES)))
-				{
-					readData = 1;
-				}
-				if (file_resource)
-				{
-					char *file_name = file_resource->getFileName();
-					if (file_name)
-					{
-						return_code = cmzn_region_read_field_file_of_name(temp_region, file_name, io_stream_package, stream_time_index,
-							readData, data_compression_type, fileFormat);
-						if (return_code != CMZN_OK)
-							display_message(ERROR_MESSAGE, "cmzn_region_read.  Cannot read file %s", file_name);
-						DEALLOCATE(file_name);
-					}
-					cmzn_streamresource_file_destroy(&file_resource);
-				}
-				else if (NULL != (memory_resource = cmzn_streamresource_cast_memory(stream)))
-				{
-					memory_resource->getBuffer(&memory_block, &buffer_size);
-					if (memory_block)
-					{
-						return_code = cmzn_region_read_from_memory(temp_region, memory_block, buffer_size, stream_time_index,
-							readData, data_compression_type, fileFormat);
-						if (return_code != CMZN_OK)
-							display_message(ERROR_MESSAGE, "cmzn_region_read.  Cannot read memory resource");
-					}
-					cmzn_streamresource_memory_destroy(&memory_resource);
-				}
-				else
-				{
-					return_code = CMZN_ERROR_GENERAL;
-					display_message(ERROR_MESSAGE, "cmzn_region_read.  Stream error");
-				}
+				resource->timeIndex = time_index;
+			}
+			resource->dataCompressionType = cmzn_streaminformation_get_resource_data_compression_type(streaminformation, stream);
+			if (resource->dataCompressionType == CMZN_STREAMINFORMATION_DATA_COMPRESSION_TYPE_DEFAULT)
+			{
+				resource->dataCompressionType = cmzn_streaminformation_get_data_compression_type(streaminformation);
+			}
+			resource->fileFormat = fileFormat;
+			const int domain_type = cmzn_streaminformation_region_get_resource_domain_types(
+				streaminformation_region, stream);
+			if ((domain_type & CMZN_FIELD_DOMAIN_TYPE_DATAPOINTS) && (!(domain_type & CMZN_FIELD_DOMAIN_TYPE_NODES)))
+			{
+				resource->readData = 1;
 			}
-			// end change before merge otherwise there will be callbacks for changes
-			// to half-temporary, half-global objects, leading to errors
-			temp_region->endHierarchicalChange();
-			if (return_code == CMZN_OK)
+			cmzn_streamresource_file_id file_resource = cmzn_streamresource_cast_file(stream);
+			cmzn_streamresource_memory_id memory_resource = nullptr;
+			if (file_resource)
 			{
-				if (!region->canMerge(*temp_region))
+				resource->fileName = file_resource->getFileName();
+				cmzn_streamresource_file_destroy(&file_resource);
+			}
+			else if (nullptr != (memory_resource = cmzn_streamresource_cast_memory(stream)))
+			{
+				memory_resource->getBuffer(&resource->memoryBlock, &resource->bufferSize);
+				cmzn_streamresource_memory_destroy(&memory_resource);
+			}
+			resources.push_back(resource);
+		}
+		int threadsCount = ThreadPool::resolveThreadsCount(streaminformation_region->getThreadsCount());
+		if ((threadsCount > 1) && (resources.size() > 1))
+		{
+			for (size_t r = 0; r < resources.size(); ++r)
+				if (!resources[r]->isThreadSafe())
 				{
-					return_code = CMZN_ERROR_INCOMPATIBLE_DATA;
+					threadsCount = 1;
+					break;
 				}
-				else
+		}
+		cmzn_region_begin_hierarchical_change(region);
+		cmzn_region *temp_region = nullptr;
+		if ((threadsCount > 1) && (resources.size() > 1))
+		{
+			return_code = cmzn_region_read_resources_threaded(region, resources, threadsCount,
+				streaminformation_region->isMemoryMapFiles(), temp_region);
+		}
+		else
+		{
+			IO_stream_package *io_stream_package = CREATE(IO_stream_package)();
+			temp_region = cmzn_region_create_region(region);
+			if (io_stream_package && temp_region)
+			{
+				IO_stream_package_set_memory_map_files(io_stream_package,
+					streaminformation_region->isMemoryMapFiles());
+				temp_region->beginHierarchicalChange();
+				for (size_t r = 0; (r < resources.size()) && (return_code == CMZN_OK); ++r)
 				{
-					return_code = region->merge(*temp_region);
+					resources[r]->read(temp_region, io_stream_package);
+					return_code = resources[r]->returnCode;
 				}
+				// end change before merge otherwise there will be callbacks for changes
+				// to half-temporary, half-global objects, leading to errors
+				temp_region->endHierarchicalChange();
+			}
+			else
+			{
+				return_code = CMZN_ERROR_MEMORY;
 			}
+			if (io_stream_package)
+				DESTROY(IO_stream_package)(&io_stream_package);
 		}
-		cmzn_region::deaccess(temp_region);
+		if (return_code == CMZN_OK)
+		{
+			if (!region->canMerge(*temp_region))
+			{
+				return_code = CMZN_ERROR_INCOMPATIBLE_DATA;
+			}
+			else
+			{
+				return_code = region->merge(*temp_region);
+			}
+		}
+		if (temp_region)
+			cmzn_region::deaccess(temp_region);
 		cmzn_region_end_hierarchical_change(region);
-		DESTROY(IO_stream_package)(&io_stream_package);
+		for (size_t r = 0; r < resources.size(); ++r)
+			delete resources[r];
 	}
 	else
 	{
@@ -365,11 +564,13 @@ int cmzn_region_write(cmzn_region_id region,
 						switch (fileFormat)
 						{
 							case CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX:
+							case CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX_BINARY:
 								if (!write_exregion_file_of_name(file_name,
 									cmzn_streaminformation_region_get_root_region(streaminformation_region),
 									region, groupName, streamTimeSet, streamTime, writeDomainTypes,
 									writeFieldsMode, numberOfFieldNames, fieldNames,
-									FE_WRITE_COMPLETE_GROUP, local_recursion_mode))
+									FE_WRITE_COMPLETE_GROUP, local_recursion_mode,
+									fileFormat == CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX_BINARY))
 								{
 									return_code = CMZN_ERROR_GENERAL;
 									display_message(ERROR_MESSAGE, "cmzn_region_write.  Failed to write EX file %s", file_name);
@@ -396,11 +597,13 @@ int cmzn_region_write(cmzn_region_id region,
 					switch (fileFormat)
 					{
 						case CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX:
+						case CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX_BINARY:
 							if (!write_exregion_file_to_memory_block(&memory_block, &buffer_size,
 								cmzn_streaminformation_region_get_root_region(streaminformation_region),
 								region, groupName, streamTimeSet, streamTime, writeDomainTypes,
 								writeFieldsMode, numberOfFieldNames, fieldNames,
-								FE_WRITE_COMPLETE_GROUP, local_recursion_mode))
+								FE_WRITE_COMPLETE_GROUP, local_recursion_mode,
+								fileFormat == CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_EX_BINARY))
 							{
 								return_code = CMZN_ERROR_GENERAL;
 								display_message(ERROR_MESSAGE, "cmzn_region_write.  Failed to write EX format to memory block");
@@ -668,6 +871,41 @@ int cmzn_streaminformation_region_set_file_format(
 	return CMZN_ERROR_ARGUMENT;
 }
 
+int cmzn_streaminformation_region_get_threads_count(
+	cmzn_streaminformation_region_id streaminformation)
+{
+	if (streaminformation)
+		return streaminformation->getThreadsCount();
+	return -1;
+}
+
+int cmzn_streaminformation_region_set_threads_count(
+	cmzn_streaminformation_region_id streaminformation, int threads_count)
+{
+	if (streaminformation)
+		return streaminformation->setThreadsCount(threads_count);
+	return CMZN_ERROR_ARGUMENT;
+}
+
+bool cmzn_streaminformation_region_is_memory_map_files(
+	cmzn_streaminformation_region_id streaminformation)
+{
+	if (streaminformation)
+		return streaminformation->isMemoryMapFiles();
+	return false;
+}
+
+int cmzn_streaminformation_region_set_memory_map_files(
+	cmzn_streaminformation_region_id streaminformation, bool value)
+{
+	if (streaminformation)
+	{
+		streaminformation->setMemoryMapFiles(value);
+		return CMZN_OK;
+	}
+	return CMZN_ERROR_ARGUMENT;
+}
+
 int cmzn_streaminformation_region_set_field_names(
 	cmzn_streaminformation_region_id streaminformation,
 	int number_of_names, const char **fieldNames)
@@ -162,7 +162,9 @@ public:
 		root_region(cmzn_region_access(region_in)),
 		fileFormat(CMZN_STREAMINFORMATION_REGION_FILE_FORMAT_AUTOMATIC),
 		recursion_mode(CMZN_STREAMINFORMATION_REGION_RECURSION_MODE_ON),
-		write_no_field(0)
+		write_no_field(0),
+		threadsCount(1),
+		memoryMapFiles(false)
 	{
 	}
 
@@ -475,6 +477,31 @@ public:
 		return CMZN_OK;
 	}
 
+	int getThreadsCount() const
+	{
+		return this->threadsCount;
+	}
+
+	/** @param threadsCountIn  Number of threads to read with, or 0 to use
+	 * hardware concurrency. Must be non-negative. */
+	int setThreadsCount(int threadsCountIn)
+	{
+		if (threadsCountIn < 0)
+			return CMZN_ERROR_ARGUMENT;
+		this->threadsCount = threadsCountIn;
+		return CMZN_OK;
+	}
+
+	bool isMemoryMapFiles() const
+	{
+		return this->memoryMapFiles;
+	}
+
+	void setMemoryMapFiles(bool memoryMapFilesIn)
+	{
+		this->memoryMapFiles = memoryMapFilesIn;
+	}
+
 private:
 	double time;
 	bool time_enabled;
@@ -483,6 +510,8 @@ private:
 	std::vector<std::string> strings_vectors;
 	cmzn_streaminformation_region_recursion_mode recursion_mode;
 	int write_no_field;
+	int threadsCount;  // number of threads to read resources with; 0 = hardware concurrency
+	bool memoryMapFiles;  // if set, read uncompressed files through a memory mapping
 };
 
 cmzn_region_id cmzn_streaminformation_region_get_region_private(
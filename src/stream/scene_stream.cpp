@@ -16,7 +16,9 @@
 #include "general/mystring.h"
 #include "general/message.h"
 #include "general/enumerator_conversion.hpp"
+#include "graphics/graphics_object_lod.hpp"
 #include "graphics/render_stl.hpp"
+#include "graphics/scene_viewer.h"
 #include "graphics/render_wavefront.hpp"
 #include "description_io/scene_json_export.hpp"
 #include "description_io/scene_json_import.hpp"
@@ -41,6 +43,16 @@ int cmzn_scene_write(cmzn_scene_id scene,
 			std::vector<std::string> outputStrings;
 
 			cmzn_scene_id scene = streaminformation_scene->getScene();
+			// levels of detail drawn in scene viewer, if any, are exported
+			GraphicsObjectLodView lodViewData;
+			const GraphicsObjectLodView *lodView = nullptr;
+			cmzn_sceneviewer_id sceneviewer = streaminformation_scene->getSceneviewer();
+			if (sceneviewer)
+			{
+				if (CMZN_OK == Scene_viewer_get_lod_view(sceneviewer, lodViewData))
+					lodView = &lodViewData;
+				cmzn_sceneviewer_destroy(&sceneviewer);
+			}
 			if (streaminformation_scene->getIOFormat() == CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_THREEJS)
 			{
 				const int size = static_cast<int>(streams_list.size());
@@ -66,7 +78,7 @@ int cmzn_scene_write(cmzn_scene_id scene,
 				}
 				cmzn_scenefilter_id scenefilter = streaminformation_scene->getScenefilter();
 				return_code = Scene_render_threejs(scene,
-					scenefilter, /*file_prefix*/"zinc_scene_export",
+					scenefilter, lodView, /*file_prefix*/"zinc_scene_export",
 					streaminformation_scene->getNumberOfTimeSteps(),
 					streaminformation_scene->getInitialTime(),
 					streaminformation_scene->getFinishTime(),
@@ -103,12 +115,32 @@ int cmzn_scene_write(cmzn_scene_id scene,
                 outputStrings = export_to_wavefront(scene, scenefilter, 1);
                 number_of_entries = outputStrings.size();
             }
+			else if (streaminformation_scene->getIOFormat() == CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_GLTF_BINARY)
+			{
+				number_of_entries = 1;
+				outputStrings.push_back(std::string());
+				cmzn_scenefilter_id scenefilter = streaminformation_scene->getScenefilter();
+				return_code = Scene_render_gltf(scene, scenefilter, lodView,
+					streaminformation_scene->getNumberOfTimeSteps(),
+					streaminformation_scene->getInitialTime(),
+					streaminformation_scene->getFinishTime(),
+					streaminformation_scene->getIODataType(),
+					streaminformation_scene->getOutputTimeDependentVertices(),
+					streaminformation_scene->getOutputTimeDependentColours(),
+					streaminformation_scene->getOutputTimeDependentNormals(),
+					streaminformation_scene->getOutputIsQuantised(),
+					outputStrings[0]);
+				cmzn_scenefilter_destroy(&scenefilter);
+			}
 
 			cmzn_scene_destroy(&scene);
 
 			if (return_code != CMZN_OK)
 				return CMZN_ERROR_GENERAL;
 
+			// output sizes are used as binary output may contain null characters
+			const bool binaryOutput = (streaminformation_scene->getIOFormat() ==
+				CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_GLTF_BINARY);
 			cmzn_streamresource_id stream = NULL;
 			int i = 0;
 			for (iter = streams_list.begin(); iter != streams_list.end(); ++iter)
@@ -127,9 +159,17 @@ int cmzn_scene_write(cmzn_scene_id scene,
 							char *file_name = file_resource->getFileName();
 							if (file_name)
 							{	
-								FILE *export_file = fopen(file_name,"w");
-								fprintf(export_file, "%s", outputStrings[i].c_str());
-								fclose(export_file);
+								FILE *export_file = fopen(file_name, binaryOutput ? "wb" : "w");
+								if (export_file)
+								{
+									fwrite(outputStrings[i].data(), 1, outputStrings[i].size(), export_file);
+									fclose(export_file);
+								}
+								else
+								{
+									display_message(ERROR_MESSAGE, "cmzn_scene_write.  Could not open file %s", file_name);
+									return_code = CMZN_ERROR_GENERAL;
+								}
 								DEALLOCATE(file_name);
 							}
 						}
@@ -140,8 +180,17 @@ int cmzn_scene_write(cmzn_scene_id scene,
 					{
 						if (!outputStrings[i].empty())
 						{
-							char *buffer_out = duplicate_string(outputStrings[i].c_str());
-							unsigned int buffer_size = static_cast<unsigned int>(strlen(buffer_out));
+							unsigned int buffer_size = static_cast<unsigned int>(outputStrings[i].size());
+							char *buffer_out = 0;
+							if (ALLOCATE(buffer_out, char, buffer_size + 1))
+							{
+								memcpy(buffer_out, outputStrings[i].data(), buffer_size);
+								buffer_out[buffer_size] = '\0';
+							}
+							else
+							{
+								buffer_size = 0;
+							}
 							memory_resource->setBuffer(buffer_out, buffer_size);
 						}
 						else
@@ -426,6 +475,9 @@ public:
 			case CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_THREEJS:
 				enum_string = "THREEJS";
 				break;
+			case CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_GLTF_BINARY:
+				enum_string = "GLTF_BINARY";
+				break;
 			default:
 				break;
 		}
@@ -455,6 +507,27 @@ int cmzn_streaminformation_scene_set_scenefilter(
 	return CMZN_ERROR_ARGUMENT;
 }
 
+cmzn_sceneviewer_id cmzn_streaminformation_scene_get_sceneviewer(
+	cmzn_streaminformation_scene_id streaminformation)
+{
+	if (streaminformation)
+	{
+		return streaminformation->getSceneviewer();
+	}
+	return 0;
+}
+
+int cmzn_streaminformation_scene_set_sceneviewer(
+	cmzn_streaminformation_scene_id streaminformation,
+	cmzn_sceneviewer_id sceneviewer)
+{
+	if (streaminformation)
+	{
+		return streaminformation->setSceneviewer(sceneviewer);
+	}
+	return CMZN_ERROR_ARGUMENT;
+}
+
 enum cmzn_streaminformation_scene_io_format
 	cmzn_streaminformation_scene_io_format_enum_from_string(
 		const char *name)
@@ -568,3 +641,25 @@ int cmzn_streaminformation_scene_set_output_is_inline(
 	}
 	return CMZN_ERROR_ARGUMENT;
 }
+
+int cmzn_streaminformation_scene_get_output_is_quantised(
+	cmzn_streaminformation_scene_id streaminformation)
+{
+	if (streaminformation)
+	{
+		return streaminformation->getOutputIsQuantised();
+	}
+	return 0;
+}
+
+int cmzn_streaminformation_scene_set_output_is_quantised(
+	cmzn_streaminformation_scene_id streaminformation,
+	int outputIsQuantised)
+{
+	if (streaminformation)
+	{
+		streaminformation->setOutputIsQuantised(outputIsQuantised);
+		return CMZN_OK;
+	}
+	return CMZN_ERROR_ARGUMENT;
+}
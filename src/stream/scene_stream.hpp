@@ -16,6 +16,7 @@
 #include "graphics/scene.hpp"
 #include "cmlibs/zinc/scenefilter.h"
 #include "cmlibs/zinc/scenepicker.h"
+#include "cmlibs/zinc/sceneviewer.h"
 #include "stream/stream_private.hpp"
 
 struct cmzn_streaminformation_scene : cmzn_streaminformation
@@ -23,12 +24,12 @@ struct cmzn_streaminformation_scene : cmzn_streaminformation
 public:
 
 	cmzn_streaminformation_scene(cmzn_scene_id scene_in) : scene(scene_in),
-		scenefilter(0), numberOfTimeSteps(0), initialTime(0.0), finishTime(0.0),
+		scenefilter(0), sceneviewer(0), numberOfTimeSteps(0), initialTime(0.0), finishTime(0.0),
 		format(CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_INVALID),
 		data_type(CMZN_STREAMINFORMATION_SCENE_IO_DATA_TYPE_COLOUR),
 		overwriteSceneGraphics(0),  outputTimeDependentVertices(1),
 		outputTimeDependentColours(0), outputTimeDependentNormals(0),
-		outputIsInline(0)
+		outputIsInline(0), outputIsQuantised(0)
 	{
 		cmzn_scene_access(scene_in);
 	}
@@ -37,6 +38,8 @@ public:
 	{
 		cmzn_scene_destroy(&scene);
 		cmzn_scenefilter_destroy(&scenefilter);
+		if (sceneviewer)
+			cmzn_sceneviewer_destroy(&sceneviewer);
 	}
 
 	cmzn_scene_id getScene()
@@ -88,7 +91,8 @@ public:
 			return numberOfResources;
 		}
         else if (format == CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_DESCRIPTION ||
-                 format == CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_ASCII_STL)
+                 format == CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_ASCII_STL ||
+                 format == CMZN_STREAMINFORMATION_SCENE_IO_FORMAT_GLTF_BINARY)
         {
 			return 1;
         }
@@ -133,6 +137,22 @@ public:
 		return CMZN_OK;
 	}
 
+	cmzn_sceneviewer_id getSceneviewer()
+	{
+		if (sceneviewer)
+			return cmzn_sceneviewer_access(sceneviewer);
+		return 0;
+	}
+
+	int setSceneviewer(cmzn_sceneviewer_id sceneviewer_in)
+	{
+		if (sceneviewer)
+			cmzn_sceneviewer_destroy(&sceneviewer);
+		if (sceneviewer_in)
+			sceneviewer = cmzn_sceneviewer_access(sceneviewer_in);
+		return CMZN_OK;
+	}
+
 	cmzn_streaminformation_scene_io_format getIOFormat()
 	{
 		return format;
@@ -210,16 +230,28 @@ public:
 		return CMZN_OK;
 	}
 
+	int getOutputIsQuantised()
+	{
+		return outputIsQuantised;
+	}
+
+	int setOutputIsQuantised(int outputIsQuantisedIn)
+	{
+		outputIsQuantised = outputIsQuantisedIn;
+		return CMZN_OK;
+	}
+
 private:
 	cmzn_scene_id scene;
 	cmzn_scenefilter_id scenefilter;
+	cmzn_sceneviewer_id sceneviewer;
 	int numberOfTimeSteps;
 	double initialTime, finishTime;
 	enum cmzn_streaminformation_scene_io_format format;
 	enum cmzn_streaminformation_scene_io_data_type data_type;
 	int overwriteSceneGraphics;
 	int outputTimeDependentVertices, outputTimeDependentColours, outputTimeDependentNormals,
-		outputIsInline;
+		outputIsInline, outputIsQuantised;
 };
 
 
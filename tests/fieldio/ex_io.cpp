@@ -8,8 +8,18 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
 #include <cmlibs/zinc/core.h>
+#include <cmlibs/zinc/element.hpp>
+#include <cmlibs/zinc/mesh.hpp>
 #include <cmlibs/zinc/node.hpp>
+#include <cmlibs/zinc/nodeset.hpp>
 #include <cmlibs/zinc/field.hpp>
 #include <cmlibs/zinc/fieldcache.hpp>
 #include <cmlibs/zinc/fieldgroup.hpp>
@@ -457,3 +467,271 @@ TEST(FieldIO, subregionMerge)
     // leading to a crash from writing the null string for CMZN_NODE_VALUE_TYPE_INVALID
     EXPECT_EQ(RESULT_OK, zinc.root_region.write(sir));
 }
+
+// Test reading multiple resources concurrently into temporary regions
+// merges them the same as reading serially
+TEST(FieldIO, readResourcesThreaded)
+{
+    ZincTestSetupCpp zinc;
+
+    StreaminformationRegion sir = zinc.root_region.createStreaminformationRegion();
+    EXPECT_TRUE(sir.isValid());
+    EXPECT_EQ(1, sir.getThreadsCount());
+    EXPECT_EQ(RESULT_ERROR_ARGUMENT, sir.setThreadsCount(-1));
+    EXPECT_EQ(1, sir.getThreadsCount());
+    EXPECT_EQ(RESULT_OK, sir.setThreadsCount(4));
+    EXPECT_EQ(4, sir.getThreadsCount());
+    sir.createStreamresourceFile(resourcePath("fieldio/cube_element.ex2").c_str());
+    StreamresourceFile fr1 = sir.createStreamresourceFile(resourcePath("fieldio/cube_node1.ex2").c_str());
+    EXPECT_EQ(RESULT_OK, sir.setResourceAttributeReal(fr1, StreaminformationRegion::ATTRIBUTE_TIME, 1.0));
+    StreamresourceFile fr3 = sir.createStreamresourceFile(resourcePath("fieldio/cube_node3.ex2").c_str());
+    EXPECT_EQ(RESULT_OK, sir.setResourceAttributeReal(fr3, StreaminformationRegion::ATTRIBUTE_TIME, 3.0));
+    StreamresourceFile fr2 = sir.createStreamresourceFile(resourcePath("fieldio/cube_node2.ex2").c_str());
+    EXPECT_EQ(RESULT_OK, sir.setResourceAttributeReal(fr2, StreaminformationRegion::ATTRIBUTE_TIME, 2.0));
+    const double times[5] = { 1.0, 1.5, 2.0, 2.5, 3.0 };
+    const double xi[3] = { 0.5, 0.5, 0.5 };
+    const double tol = 1.0E-7;
+    double xOut[3];
+    // read with 4 threads, then hardware concurrency into existing model
+    for (int i = 0; i < 2; ++i)
+    {
+        if (i == 1)
+        {
+            EXPECT_EQ(RESULT_OK, sir.setThreadsCount(0));
+        }
+        EXPECT_EQ(RESULT_OK, zinc.root_region.read(sir));
+        Field coordinates = zinc.fm.findFieldByName("coordinates");
+        EXPECT_TRUE(coordinates.isValid());
+        Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+        EXPECT_EQ(1, mesh3d.getSize());
+        EXPECT_EQ(6, zinc.fm.findMeshByDimension(2).getSize());
+        EXPECT_EQ(12, zinc.fm.findMeshByDimension(1).getSize());
+        EXPECT_EQ(8, zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES).getSize());
+        Element element1 = mesh3d.findElementByIdentifier(1);
+        EXPECT_TRUE(element1.isValid());
+        Fieldcache cache = zinc.fm.createFieldcache();
+        EXPECT_EQ(RESULT_OK, cache.setMeshLocation(element1, 3, xi));
+        for (int t = 0; t < 5; ++t)
+        {
+            const double xExpected = 0.5 + 0.25*t;
+            EXPECT_EQ(RESULT_OK, cache.setTime(times[t]));
+            EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(cache, 3, xOut));
+            EXPECT_NEAR(xExpected, xOut[0], tol);
+            EXPECT_NEAR(xExpected, xOut[1], tol);
+            EXPECT_NEAR(xExpected, xOut[2], tol);
+        }
+    }
+}
+
+// Test writing EX binary format and reading it back gives the same model
+TEST(FieldIO, exBinaryRoundTrip)
+{
+    const char *fileNames[] =
+    {
+        "fieldio/block_grid.exfile",
+        "fieldio/compact_groups.exf",
+        "fieldio/node_time_sequence.exf",
+        "fieldio/prolate_heart.exfile",
+        "fieldio/special_node_fields.exnode"
+    };
+    for (const char *fileName : fileNames)
+    {
+        ZincTestSetupCpp zinc;
+        ASSERT_EQ(RESULT_OK, zinc.root_region.readFile(resourcePath(fileName).c_str()));
+
+        StreaminformationRegion sirText = zinc.root_region.createStreaminformationRegion();
+        StreamresourceMemory srmText = sirText.createStreamresourceMemory();
+        EXPECT_EQ(RESULT_OK, sirText.setFileFormat(StreaminformationRegion::FILE_FORMAT_EX));
+        EXPECT_EQ(RESULT_OK, zinc.root_region.write(sirText));
+        const void *textBuffer;
+        unsigned int textBufferLength;
+        EXPECT_EQ(RESULT_OK, srmText.getBuffer(&textBuffer, &textBufferLength));
+
+        StreaminformationRegion sirBinary = zinc.root_region.createStreaminformationRegion();
+        StreamresourceMemory srmBinary = sirBinary.createStreamresourceMemory();
+        EXPECT_EQ(RESULT_OK, sirBinary.setFileFormat(StreaminformationRegion::FILE_FORMAT_EX_BINARY));
+        EXPECT_EQ(StreaminformationRegion::FILE_FORMAT_EX_BINARY, sirBinary.getFileFormat());
+        EXPECT_EQ(RESULT_OK, zinc.root_region.write(sirBinary));
+        const void *binaryBuffer;
+        unsigned int binaryBufferLength;
+        EXPECT_EQ(RESULT_OK, srmBinary.getBuffer(&binaryBuffer, &binaryBufferLength));
+
+        // binary values are detected by the EX reader
+        Region region2 = zinc.context.createRegion();
+        StreaminformationRegion sir2 = region2.createStreaminformationRegion();
+        sir2.createStreamresourceMemoryBuffer(binaryBuffer, binaryBufferLength);
+        EXPECT_EQ(RESULT_OK, region2.read(sir2));
+
+        // re-export as text must match original export exactly
+        StreaminformationRegion sir3 = region2.createStreaminformationRegion();
+        StreamresourceMemory srm3 = sir3.createStreamresourceMemory();
+        EXPECT_EQ(RESULT_OK, region2.write(sir3));
+        const void *buffer3;
+        unsigned int bufferLength3;
+        EXPECT_EQ(RESULT_OK, srm3.getBuffer(&buffer3, &bufferLength3));
+        ASSERT_EQ(textBufferLength, bufferLength3);
+        EXPECT_EQ(0, memcmp(textBuffer, buffer3, textBufferLength));
+    }
+}
+
+namespace {
+
+ManageOutputFolder manageOutputFolderFieldIO("/fieldio");
+
+/**
+ * Get EX text for nodes with a 4 component field containing the supplied
+ * real value strings, padded with zeroes to a multiple of 4.
+ */
+std::string getExValuesText(std::vector<std::string>& valueStrings)
+{
+	while (valueStrings.size() % 4)
+		valueStrings.push_back("0");
+	std::string text =
+		"EX Version: 3\n"
+		"Region: /\n"
+		"!#nodeset nodes\n"
+		"Define node template: node1\n"
+		"Shape. Dimension=0\n"
+		"#Fields=1\n"
+		"1) values, field, rectangular cartesian, real, #Components=4\n"
+		" c1. #Values=1 (value)\n"
+		" c2. #Values=1 (value)\n"
+		" c3. #Values=1 (value)\n"
+		" c4. #Values=1 (value)\n"
+		"Node template: node1\n";
+	char nodeLine[50];
+	for (size_t i = 0; i < valueStrings.size(); i += 4)
+	{
+		sprintf(nodeLine, "Node: %d\n", static_cast<int>(i/4 + 1));
+		text += nodeLine;
+		text += " " + valueStrings[i] + " " + valueStrings[i + 1] + "\n";
+		text += "  " + valueStrings[i + 2] + "\t" + valueStrings[i + 3] + "\n";
+	}
+	return text;
+}
+
+/** Check node values read into region are bit-identical to strtod results. */
+void checkExValues(Region& region, const std::vector<std::string>& valueStrings)
+{
+	Fieldmodule fm = region.getFieldmodule();
+	Field values = fm.findFieldByName("values");
+	ASSERT_TRUE(values.isValid());
+	Nodeset nodes = fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	const int nodesCount = static_cast<int>(valueStrings.size()/4);
+	EXPECT_EQ(nodesCount, nodes.getSize());
+	Fieldcache cache = fm.createFieldcache();
+	double valuesOut[4];
+	for (int n = 0; n < nodesCount; ++n)
+	{
+		EXPECT_EQ(RESULT_OK, cache.setNode(nodes.findNodeByIdentifier(n + 1)));
+		EXPECT_EQ(RESULT_OK, values.evaluateReal(cache, 4, valuesOut));
+		for (int c = 0; c < 4; ++c)
+		{
+			const std::string& valueString = valueStrings[n*4 + c];
+			const double expectedValue = strtod(valueString.c_str(), nullptr);
+			EXPECT_EQ(0, memcmp(&expectedValue, valuesOut + c, sizeof(double))) << "value " << valueString;
+		}
+	}
+}
+
+}
+
+// Test real values read from EX files are bit-identical to strtod, reading
+// from memory, and from files with and without memory mapping
+TEST(FieldIO, exReadRealsExact)
+{
+    std::vector<std::string> valueStrings =
+    {
+        "0", "-0", "0.1", "-0.1", "0.30000000000000004", "1e23", "1.0E+22", "8.0e22",
+        "9007199254740992", "9007199254740993", "9007199254740995", "123456789012345678901234567890",
+        "3.14159265358979323846264338327950288", "2.718281828459045", ".5", "5.",
+        "+7.25", "-2.5E-3", "1e-5", "6.02214076e23",
+        "1.7976931348623157e+308", "2.2250738585072014e-308", "2.2250738585072011e-308",
+        "4.9406564584124654e-324", "1e-320", "1.23456789012345678e-100", "0.000000000000000000001",
+        "1E22", "1E-22", "123.456e-7", "0x1.8p+1", "-1234567890123456"
+    };
+    // add pseudo-random values in the formats used by writers
+    unsigned long long state = 12345;
+    char valueString[40];
+    const char *formats[] = { "%.17g", "%.16g", "%.15g", "%.6g", "%.17e", "%.3f" };
+    for (int i = 0; i < 600; ++i)
+    {
+        state = state*6364136223846793005ULL + 1442695040888963407ULL;
+        const double mantissa = static_cast<double>(state >> 11)/9007199254740992.0;
+        const int exponent = static_cast<int>((state >> 3) % 61) - 30;
+        const double value = ((state & 1) ? -1.0 : 1.0)*ldexp(mantissa, exponent*3);
+        sprintf(valueString, formats[i % 6], value);
+        valueStrings.push_back(valueString);
+    }
+    const std::string text = getExValuesText(valueStrings);
+
+    {
+        ZincTestSetupCpp zinc;
+        StreaminformationRegion sir = zinc.root_region.createStreaminformationRegion();
+        sir.createStreamresourceMemoryBuffer(text.c_str(), static_cast<unsigned int>(text.size()));
+        EXPECT_EQ(RESULT_OK, zinc.root_region.read(sir));
+        checkExValues(zinc.root_region, valueStrings);
+    }
+
+    const std::string fileName = manageOutputFolderFieldIO.getPath("/read_reals_exact.exf");
+    FILE *file = fopen(fileName.c_str(), "wb");
+    ASSERT_TRUE(file != nullptr);
+    EXPECT_EQ(text.size(), fwrite(text.c_str(), 1, text.size(), file));
+    fclose(file);
+    for (int memoryMap = 0; memoryMap < 2; ++memoryMap)
+    {
+        ZincTestSetupCpp zinc;
+        StreaminformationRegion sir = zinc.root_region.createStreaminformationRegion();
+        EXPECT_FALSE(sir.isMemoryMapFiles());
+        if (memoryMap)
+        {
+            EXPECT_EQ(RESULT_OK, sir.setMemoryMapFiles(true));
+            EXPECT_TRUE(sir.isMemoryMapFiles());
+        }
+        sir.createStreamresourceFile(fileName.c_str());
+        EXPECT_EQ(RESULT_OK, zinc.root_region.read(sir));
+        checkExValues(zinc.root_region, valueStrings);
+    }
+}
+
+// Test reading files through a memory mapping, serially and with threads
+TEST(FieldIO, readResourcesMemoryMapped)
+{
+    ZincTestSetupCpp zinc;
+
+    StreaminformationRegion sir = zinc.root_region.createStreaminformationRegion();
+    EXPECT_TRUE(sir.isValid());
+    EXPECT_FALSE(sir.isMemoryMapFiles());
+    EXPECT_EQ(RESULT_OK, sir.setMemoryMapFiles(true));
+    EXPECT_TRUE(sir.isMemoryMapFiles());
+    sir.createStreamresourceFile(resourcePath("fieldio/cube_element.ex2").c_str());
+    StreamresourceFile fr1 = sir.createStreamresourceFile(resourcePath("fieldio/cube_node1.ex2").c_str());
+    EXPECT_EQ(RESULT_OK, sir.setResourceAttributeReal(fr1, StreaminformationRegion::ATTRIBUTE_TIME, 1.0));
+    StreamresourceFile fr2 = sir.createStreamresourceFile(resourcePath("fieldio/cube_node2.ex2").c_str());
+    EXPECT_EQ(RESULT_OK, sir.setResourceAttributeReal(fr2, StreaminformationRegion::ATTRIBUTE_TIME, 2.0));
+    const double xi[3] = { 0.5, 0.5, 0.5 };
+    const double tol = 1.0E-7;
+    double xOut[3];
+    for (int threadsCount = 1; threadsCount <= 2; ++threadsCount)
+    {
+        EXPECT_EQ(RESULT_OK, sir.setThreadsCount(threadsCount));
+        EXPECT_EQ(RESULT_OK, zinc.root_region.read(sir));
+        Field coordinates = zinc.fm.findFieldByName("coordinates");
+        EXPECT_TRUE(coordinates.isValid());
+        Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+        EXPECT_EQ(1, mesh3d.getSize());
+        EXPECT_EQ(8, zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES).getSize());
+        Fieldcache cache = zinc.fm.createFieldcache();
+        EXPECT_EQ(RESULT_OK, cache.setMeshLocation(mesh3d.findElementByIdentifier(1), 3, xi));
+        for (int t = 0; t < 3; ++t)
+        {
+            const double time = 1.0 + 0.5*t;
+            const double xExpected = 0.5 + 0.25*t;
+            EXPECT_EQ(RESULT_OK, cache.setTime(time));
+            EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(cache, 3, xOut));
+            EXPECT_NEAR(xExpected, xOut[0], tol);
+            EXPECT_NEAR(xExpected, xOut[1], tol);
+            EXPECT_NEAR(xExpected, xOut[2], tol);
+        }
+    }
+}
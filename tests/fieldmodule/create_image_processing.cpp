@@ -21,9 +21,13 @@
 #include <cmlibs/zinc/streamimage.h>
 
 #include <cmlibs/zinc/field.hpp>
+#include <cmlibs/zinc/fieldarithmeticoperators.hpp>
+#include <cmlibs/zinc/fieldcache.hpp>
+#include <cmlibs/zinc/fieldconstant.hpp>
 #include <cmlibs/zinc/fieldimage.hpp>
 #include <cmlibs/zinc/fieldimageprocessing.hpp>
 #include <cmlibs/zinc/fieldmodule.hpp>
+#include <cmlibs/zinc/region.hpp>
 #include <cmlibs/zinc/streamimage.hpp>
 
 #include "zinctestsetup.hpp"
@@ -209,3 +213,123 @@ TEST(ZincFieldImagefilterThreshold, api)
 	EXPECT_EQ(CMZN_OK, result = th.setUpperThreshold(0.8));
 	ASSERT_DOUBLE_EQ(0.8, value = th.getUpperThreshold());
 }
+
+// Image field inputs are read from texels while other source fields are
+// evaluated at pixel centres, on multiple threads if region is frozen
+TEST(ZincFieldImagefilterThreshold, sourceFieldInput)
+{
+	ZincTestSetupCpp zinc;
+
+	FieldImage im = zinc.fm.createFieldImage();
+	EXPECT_TRUE(im.isValid());
+	EXPECT_EQ(RESULT_OK, im.readFile(resourcePath("testimage_gray.jpg").c_str()));
+	const double one = 1.0;
+	FieldConstant constOne = zinc.fm.createFieldConstant(1, &one);
+	EXPECT_TRUE(constOne.isValid());
+	Field scaledIm = im*constOne;
+	EXPECT_TRUE(scaledIm.isValid());
+
+	FieldImagefilterThreshold imageThreshold = zinc.fm.createFieldImagefilterThreshold(im);
+	EXPECT_TRUE(imageThreshold.isValid());
+	FieldImagefilterThreshold fieldThreshold = zinc.fm.createFieldImagefilterThreshold(scaledIm);
+	EXPECT_TRUE(fieldThreshold.isValid());
+	FieldImagefilterThreshold frozenThreshold = zinc.fm.createFieldImagefilterThreshold(scaledIm);
+	EXPECT_TRUE(frozenThreshold.isValid());
+	EXPECT_EQ(RESULT_OK, imageThreshold.setCondition(FieldImagefilterThreshold::CONDITION_OUTSIDE));
+	EXPECT_EQ(RESULT_OK, imageThreshold.setLowerThreshold(0.2));
+	EXPECT_EQ(RESULT_OK, imageThreshold.setUpperThreshold(0.8));
+	EXPECT_EQ(RESULT_OK, fieldThreshold.setCondition(FieldImagefilterThreshold::CONDITION_OUTSIDE));
+	EXPECT_EQ(RESULT_OK, fieldThreshold.setLowerThreshold(0.2));
+	EXPECT_EQ(RESULT_OK, fieldThreshold.setUpperThreshold(0.8));
+	EXPECT_EQ(RESULT_OK, frozenThreshold.setCondition(FieldImagefilterThreshold::CONDITION_OUTSIDE));
+	EXPECT_EQ(RESULT_OK, frozenThreshold.setLowerThreshold(0.2));
+	EXPECT_EQ(RESULT_OK, frozenThreshold.setUpperThreshold(0.8));
+
+	Field xi = im.getDomainField();
+	EXPECT_TRUE(xi.isValid());
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	const int locationsCount = 5;
+	double imageValues[locationsCount*locationsCount], fieldValues[locationsCount*locationsCount];
+	for (int j = 0; j < locationsCount; ++j)
+		for (int i = 0; i < locationsCount; ++i)
+		{
+			const double location[2] = { (i + 0.3)/locationsCount, (j + 0.6)/locationsCount };
+			const int n = j*locationsCount + i;
+			EXPECT_EQ(RESULT_OK, fieldcache.setFieldReal(xi, 2, location));
+			EXPECT_EQ(RESULT_OK, imageThreshold.evaluateReal(fieldcache, 1, imageValues + n));
+			EXPECT_EQ(RESULT_OK, fieldThreshold.evaluateReal(fieldcache, 1, fieldValues + n));
+			EXPECT_NEAR(imageValues[n], fieldValues[n], 1.0E-6);
+		}
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.setFrozen(true));
+	for (int j = 0; j < locationsCount; ++j)
+		for (int i = 0; i < locationsCount; ++i)
+		{
+			const double location[2] = { (i + 0.3)/locationsCount, (j + 0.6)/locationsCount };
+			const int n = j*locationsCount + i;
+			double value;
+			EXPECT_EQ(RESULT_OK, fieldcache.setFieldReal(xi, 2, location));
+			EXPECT_EQ(RESULT_OK, frozenThreshold.evaluateReal(fieldcache, 1, &value));
+			EXPECT_NEAR(imageValues[n], value, 1.0E-6);
+		}
+	EXPECT_EQ(RESULT_OK, zinc.root_region.setFrozen(false));
+}
+
+// Filters computed in tiles from their input region give the same values as
+// filtering the whole image
+TEST(ZincFieldImagefilter, tiles)
+{
+	ZincTestSetupCpp zinc;
+
+	FieldImage im = zinc.fm.createFieldImage();
+	EXPECT_TRUE(im.isValid());
+	EXPECT_EQ(RESULT_OK, im.readFile(resourcePath("testimage_gray.jpg").c_str()));
+
+	const int radiusSizes[2] = { 2, 3 };
+	FieldImagefilterMean wholeMean = zinc.fm.createFieldImagefilterMean(im, 2, radiusSizes);
+	EXPECT_TRUE(wholeMean.isValid());
+	FieldImagefilterMean tiledMean = zinc.fm.createFieldImagefilterMean(im, 2, radiusSizes);
+	EXPECT_TRUE(tiledMean.isValid());
+	EXPECT_EQ(0, tiledMean.getTileSize());
+	EXPECT_EQ(256, tiledMean.getTileCacheMemoryLimit());
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, tiledMean.setTileSize(-1));
+	EXPECT_EQ(RESULT_OK, tiledMean.setTileSize(16));
+	EXPECT_EQ(16, tiledMean.getTileSize());
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, tiledMean.setTileCacheMemoryLimit(-1));
+	// only keep the last tile evaluated
+	EXPECT_EQ(RESULT_OK, tiledMean.setTileCacheMemoryLimit(0));
+	EXPECT_EQ(0, tiledMean.getTileCacheMemoryLimit());
+
+	// tiled filter taking input from a tiled filter
+	FieldImagefilterThreshold threshold = zinc.fm.createFieldImagefilterThreshold(tiledMean);
+	EXPECT_TRUE(threshold.isValid());
+	EXPECT_EQ(RESULT_OK, threshold.setCondition(FieldImagefilterThreshold::CONDITION_OUTSIDE));
+	EXPECT_EQ(RESULT_OK, threshold.setLowerThreshold(0.2));
+	EXPECT_EQ(RESULT_OK, threshold.setUpperThreshold(0.8));
+	EXPECT_EQ(RESULT_OK, threshold.setTileSize(8));
+
+	// output depending on the whole image cannot be tiled
+	FieldImagefilterRescaleIntensity rescale = zinc.fm.createFieldImagefilterRescaleIntensity(im, 0.0, 1.0);
+	EXPECT_TRUE(rescale.isValid());
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, rescale.setTileSize(16));
+	EXPECT_EQ(0, rescale.getTileSize());
+	EXPECT_EQ(RESULT_OK, rescale.setTileSize(0));
+
+	Field xi = im.getDomainField();
+	EXPECT_TRUE(xi.isValid());
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	const int locationsCount = 7;
+	for (int j = 0; j < locationsCount; ++j)
+		for (int i = 0; i < locationsCount; ++i)
+		{
+			const double location[2] = { (i + 0.45)/locationsCount, (j + 0.15)/locationsCount };
+			double wholeValue, tiledValue, thresholdValue;
+			EXPECT_EQ(RESULT_OK, fieldcache.setFieldReal(xi, 2, location));
+			EXPECT_EQ(RESULT_OK, wholeMean.evaluateReal(fieldcache, 1, &wholeValue));
+			EXPECT_EQ(RESULT_OK, tiledMean.evaluateReal(fieldcache, 1, &tiledValue));
+			EXPECT_NEAR(wholeValue, tiledValue, 1.0E-6);
+			EXPECT_EQ(RESULT_OK, threshold.evaluateReal(fieldcache, 1, &thresholdValue));
+			const double expectedValue = ((wholeValue < 0.2) || (wholeValue > 0.8)) ? 0.0 : wholeValue;
+			EXPECT_NEAR(expectedValue, thresholdValue, 1.0E-6);
+		}
+}
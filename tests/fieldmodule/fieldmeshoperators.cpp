@@ -7,6 +7,7 @@
  */
 
 #include <cmath>
+#include <vector>
 #include <gtest/gtest.h>
 
 #include <cmlibs/zinc/element.hpp>
@@ -18,6 +19,7 @@
 #include <cmlibs/zinc/fieldgroup.hpp>
 #include <cmlibs/zinc/fieldlogicaloperators.hpp>
 #include <cmlibs/zinc/fieldmeshoperators.hpp>
+#include <cmlibs/zinc/fieldparameters.hpp>
 #include <cmlibs/zinc/fieldtime.hpp>
 #include <cmlibs/zinc/fieldtrigonometry.hpp>
 #include <cmlibs/zinc/fieldvectoroperators.hpp>
@@ -493,3 +495,82 @@ TEST(FieldMeshIntegral, timeLookup)
 	EXPECT_EQ(RESULT_OK, deformedOneVolume.evaluateReal(fieldcache, 1, &volumeOut));
 	EXPECT_NEAR(1.3298844582623588, volumeOut, TOL);
 }
+
+// Test threaded evaluation of mesh integral and its parameter derivatives
+// gives the same results for any number of threads, close to serial results
+TEST(ZincFieldMeshIntegral, threads)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(resourcePath("fieldmodule/allshapes_quadratic_deformed.exf").c_str()));
+
+	Field coordinates = zinc.fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinates.isValid());
+	Field deformed = zinc.fm.findFieldByName("deformed");
+	EXPECT_TRUE(deformed.isValid());
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	Mesh mesh2d = zinc.fm.findMeshByDimension(2);
+	EXPECT_GT(mesh2d.getSize(), 16);  // so more than one chunk of elements
+	Field deformedSquared = zinc.fm.createFieldDotProduct(deformed, deformed);
+	EXPECT_TRUE(deformedSquared.isValid());
+	const int numberOfPoints = 4;
+
+	FieldMeshIntegral surfaceIntegral = zinc.fm.createFieldMeshIntegral(deformedSquared, deformed, mesh2d);
+	EXPECT_TRUE(surfaceIntegral.isValid());
+	EXPECT_EQ(RESULT_OK, surfaceIntegral.setNumbersOfPoints(1, &numberOfPoints));
+	EXPECT_EQ(1, surfaceIntegral.getThreadsCount());
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, surfaceIntegral.setThreadsCount(-1));
+	EXPECT_EQ(1, surfaceIntegral.getThreadsCount());
+
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	double serialValue, threadedValue2, threadedValue4;
+	EXPECT_EQ(RESULT_OK, surfaceIntegral.evaluateReal(fieldcache, 1, &serialValue));
+	EXPECT_EQ(RESULT_OK, surfaceIntegral.setThreadsCount(2));
+	EXPECT_EQ(2, surfaceIntegral.getThreadsCount());
+	EXPECT_EQ(RESULT_OK, surfaceIntegral.evaluateReal(fieldcache, 1, &threadedValue2));
+	EXPECT_EQ(RESULT_OK, surfaceIntegral.setThreadsCount(4));
+	EXPECT_EQ(RESULT_OK, surfaceIntegral.evaluateReal(fieldcache, 1, &threadedValue4));
+	EXPECT_NEAR(serialValue, threadedValue2, 1.0E-12*fabs(serialValue));
+	EXPECT_EQ(threadedValue2, threadedValue4);
+	EXPECT_EQ(RESULT_OK, surfaceIntegral.setThreadsCount(0));
+	EXPECT_EQ(0, surfaceIntegral.getThreadsCount());
+	EXPECT_EQ(RESULT_OK, surfaceIntegral.evaluateReal(fieldcache, 1, &threadedValue4));
+	EXPECT_NEAR(serialValue, threadedValue4, 1.0E-12*fabs(serialValue));
+
+	// parameter derivatives in an element are summed over chunks of points
+	FieldMeshIntegral volumeIntegral = zinc.fm.createFieldMeshIntegral(deformedSquared, coordinates, mesh3d);
+	EXPECT_TRUE(volumeIntegral.isValid());
+	EXPECT_EQ(RESULT_OK, volumeIntegral.setNumbersOfPoints(1, &numberOfPoints));
+	Fieldparameters fieldparameters = deformed.getFieldparameters();
+	EXPECT_TRUE(fieldparameters.isValid());
+	Differentialoperator parameterDerivative1 = fieldparameters.getDerivativeOperator(/*order*/1);
+	Differentialoperator parameterDerivative2 = fieldparameters.getDerivativeOperator(/*order*/2);
+	Element element = mesh3d.findElementByIdentifier(1);
+	EXPECT_TRUE(element.isValid());
+	const int elementParameterCount = fieldparameters.getNumberOfElementParameters(element);
+	EXPECT_GT(elementParameterCount, 0);
+	const int hessianCount = elementParameterCount*elementParameterCount;
+	std::vector<double> serialJacobian(elementParameterCount), serialHessian(hessianCount);
+	std::vector<double> threadedJacobian2(elementParameterCount), threadedHessian2(hessianCount);
+	std::vector<double> threadedJacobian3(elementParameterCount), threadedHessian3(hessianCount);
+	EXPECT_EQ(RESULT_OK, fieldcache.setElement(element));
+	EXPECT_EQ(RESULT_OK, volumeIntegral.evaluateDerivative(parameterDerivative1, fieldcache, elementParameterCount, serialJacobian.data()));
+	EXPECT_EQ(RESULT_OK, volumeIntegral.evaluateDerivative(parameterDerivative2, fieldcache, hessianCount, serialHessian.data()));
+	EXPECT_EQ(RESULT_OK, volumeIntegral.setThreadsCount(2));
+	EXPECT_EQ(RESULT_OK, volumeIntegral.evaluateDerivative(parameterDerivative1, fieldcache, elementParameterCount, threadedJacobian2.data()));
+	EXPECT_EQ(RESULT_OK, volumeIntegral.evaluateDerivative(parameterDerivative2, fieldcache, hessianCount, threadedHessian2.data()));
+	EXPECT_EQ(RESULT_OK, volumeIntegral.setThreadsCount(3));
+	EXPECT_EQ(RESULT_OK, volumeIntegral.evaluateDerivative(parameterDerivative1, fieldcache, elementParameterCount, threadedJacobian3.data()));
+	EXPECT_EQ(RESULT_OK, volumeIntegral.evaluateDerivative(parameterDerivative2, fieldcache, hessianCount, threadedHessian3.data()));
+	const double TOL = 1.0E-12;
+	for (int i = 0; i < elementParameterCount; ++i)
+	{
+		EXPECT_NEAR(serialJacobian[i], threadedJacobian2[i], TOL);
+		EXPECT_EQ(threadedJacobian2[i], threadedJacobian3[i]);
+	}
+	for (int i = 0; i < hessianCount; ++i)
+	{
+		EXPECT_NEAR(serialHessian[i], threadedHessian2[i], TOL);
+		EXPECT_EQ(threadedHessian2[i], threadedHessian3[i]);
+	}
+}
@@ -8,6 +8,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "zinctestsetup.hpp"
 #include <cmlibs/zinc/core.h>
 #include <cmlibs/zinc/element.h>
@@ -24,7 +26,9 @@
 #include <cmlibs/zinc/fieldarithmeticoperators.hpp>
 #include <cmlibs/zinc/fieldderivatives.hpp>
 #include <cmlibs/zinc/fieldcache.hpp>
+#include <cmlibs/zinc/fieldcomposite.hpp>
 #include <cmlibs/zinc/fieldconstant.hpp>
+#include <cmlibs/zinc/fieldcoordinatetransformation.hpp>
 #include <cmlibs/zinc/fieldgroup.hpp>
 #include <cmlibs/zinc/fieldmodule.hpp>
 #include <cmlibs/zinc/fieldfiniteelement.hpp>
@@ -1367,6 +1371,90 @@ TEST(ZincFieldFiniteElement, fieldcacheInvalidation)
 	zinc.fm.endChange();
 }
 
+// Test element evaluation cache capacity, least recently used eviction and statistics
+TEST(ZincFieldFiniteElement, elementEvaluationCache)
+{
+	ZincTestSetupCpp zinc;
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(resourcePath("fieldmodule/cube.exformat").c_str()));
+
+	FieldFiniteElement coordinates = zinc.fm.findFieldByName("coordinates").castFiniteElement();
+	EXPECT_TRUE(coordinates.isValid());
+	Mesh mesh2d = zinc.fm.findMeshByDimension(2);
+	EXPECT_EQ(6, mesh2d.getSize());
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+
+	EXPECT_EQ(1000, coordinates.getElementEvaluationCacheCapacity(fieldcache));
+	EXPECT_EQ(0, coordinates.getElementEvaluationCacheCapacity(Fieldcache()));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.setElementEvaluationCacheCapacity(fieldcache, 0));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.setElementEvaluationCacheCapacity(Fieldcache(), 2));
+	EXPECT_EQ(RESULT_OK, coordinates.setElementEvaluationCacheCapacity(fieldcache, 2));
+	EXPECT_EQ(2, coordinates.getElementEvaluationCacheCapacity(fieldcache));
+	int hitCount = -1, missCount = -1;
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.getElementEvaluationCacheStatistics(fieldcache, nullptr, &missCount));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.getElementEvaluationCacheStatistics(Fieldcache(), &hitCount, &missCount));
+	EXPECT_EQ(RESULT_OK, coordinates.getElementEvaluationCacheStatistics(fieldcache, &hitCount, &missCount));
+	EXPECT_EQ(0, hitCount);
+	EXPECT_EQ(0, missCount);
+
+	// evaluate at a different xi each time so field values are not reused
+	double xi[2] = { 0.5, 0.5 };
+	double xout[3];
+	auto evaluateInFace = [&](int identifier)
+	{
+		xi[0] += 0.01;
+		EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(mesh2d.findElementByIdentifier(identifier), 2, xi));
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache, 3, xout));
+	};
+	// sequence of faces evaluated in, and whether each is expected to hit
+	// in a cache of capacity 2 with least recently used eviction
+	const int faceSequence[] = { 1, 1, 2, 1, 3, 1, 2, 3, 2, 4, 5, 4 };
+	const bool expectedHits[] = { false, true, false, true, false, true, false, false, true, false, false, true };
+	const int evaluationsCount = sizeof(faceSequence)/sizeof(int);
+	int expectedHitCount = 0, expectedMissCount = 0;
+	for (int i = 0; i < evaluationsCount; ++i)
+	{
+		evaluateInFace(faceSequence[i]);
+		if (expectedHits[i])
+			++expectedHitCount;
+		else
+			++expectedMissCount;
+		EXPECT_EQ(RESULT_OK, coordinates.getElementEvaluationCacheStatistics(fieldcache, &hitCount, &missCount));
+		EXPECT_EQ(expectedHitCount, hitCount) << "evaluation " << i;
+		EXPECT_EQ(expectedMissCount, missCount) << "evaluation " << i;
+	}
+
+	EXPECT_EQ(RESULT_OK, coordinates.resetElementEvaluationCacheStatistics(fieldcache));
+	EXPECT_EQ(RESULT_OK, coordinates.getElementEvaluationCacheStatistics(fieldcache, &hitCount, &missCount));
+	EXPECT_EQ(0, hitCount);
+	EXPECT_EQ(0, missCount);
+
+	// increasing capacity keeps all faces once evaluated
+	EXPECT_EQ(RESULT_OK, coordinates.setElementEvaluationCacheCapacity(fieldcache, 6));
+	for (int pass = 0; pass < 2; ++pass)
+		for (int identifier = 1; identifier <= 6; ++identifier)
+			evaluateInFace(identifier);
+	EXPECT_EQ(RESULT_OK, coordinates.getElementEvaluationCacheStatistics(fieldcache, &hitCount, &missCount));
+	// faces 4 and 5 are still cached from the first sequence
+	EXPECT_EQ(8, hitCount);
+	EXPECT_EQ(4, missCount);
+
+	// values evaluated from cached element evaluations are unchanged
+	const double xiCentre[2] = { 0.5, 0.5 };
+	const double tol = 1.0E-12;
+	Fieldcache fieldcache2 = zinc.fm.createFieldcache();
+	double xout2[3];
+	for (int identifier = 1; identifier <= 6; ++identifier)
+	{
+		Element face = mesh2d.findElementByIdentifier(identifier);
+		EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(face, 2, xiCentre));
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache, 3, xout));
+		EXPECT_EQ(RESULT_OK, fieldcache2.setMeshLocation(face, 2, xiCentre));
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache2, 3, xout2));
+		for (int c = 0; c < 3; ++c)
+			EXPECT_NEAR(xout2[c], xout[c], tol);
+	}
+}
+
 TEST(ZincNodetemplate, define_undefineField)
 {
 	ZincTestSetupCpp zinc;
@@ -1430,6 +1518,234 @@ TEST(ZincNodetemplate, define_undefineField)
 	EXPECT_EQ(ERROR_NOT_FOUND, nodetemplate5.setValueNumberOfVersions(feField, -1, Node::VALUE_LABEL_VALUE, 1));
 }
 
+// Test evaluating fields at many mesh locations in an element and at all nodes in a nodeset
+TEST(ZincField, evaluateRealMeshLocationsNodeset)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(resourcePath("fieldmodule/cube.exformat").c_str()));
+	Field coordinates = zinc.fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinates.isValid());
+	Field magnitude = zinc.fm.createFieldMagnitude(coordinates);
+	EXPECT_TRUE(magnitude.isValid());
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	Element element1 = mesh3d.findElementByIdentifier(1);
+	EXPECT_TRUE(element1.isValid());
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	EXPECT_EQ(8, nodes.getSize());
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	EXPECT_TRUE(fieldcache.isValid());
+
+	const int pointsCount = 4;
+	const double xi[pointsCount*3] =
+	{
+		0.0, 0.0, 0.0,
+		0.25, 0.5, 0.75,
+		1.0, 0.2, 0.4,
+		0.6, 0.6, 1.0
+	};
+	double values[pointsCount*3];
+	double magnitudes[pointsCount];
+	double expectedValue;
+	const double TOL = 1.0E-12;
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateRealMeshLocations(fieldcache, element1, pointsCount, pointsCount*3, xi, pointsCount*3, values));
+	EXPECT_EQ(RESULT_OK, magnitude.evaluateRealMeshLocations(fieldcache, element1, pointsCount, pointsCount*3, xi, pointsCount, magnitudes));
+	for (int p = 0; p < pointsCount; ++p)
+	{
+		// cube.exformat coordinates equal xi
+		EXPECT_NEAR(xi[p*3], values[p*3], TOL);
+		EXPECT_NEAR(xi[p*3 + 1], values[p*3 + 1], TOL);
+		EXPECT_NEAR(xi[p*3 + 2], values[p*3 + 2], TOL);
+		EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element1, 3, xi + p*3));
+		EXPECT_EQ(RESULT_OK, magnitude.evaluateReal(fieldcache, 1, &expectedValue));
+		EXPECT_NEAR(expectedValue, magnitudes[p], TOL);
+	}
+
+	// derived fields evaluating source fields for all locations give same values
+	const double constantValues[3] = { 1.5, 2.0, 0.5 };
+	Field constant = zinc.fm.createFieldConstant(3, constantValues);
+	Field shifted = zinc.fm.createFieldAdd(coordinates, constant);
+	Field component = zinc.fm.createFieldComponent(coordinates, 2);
+	const Field concatenateSourceFields[3] = { magnitude, component, constant };
+	Field polar = zinc.fm.createFieldCoordinateTransformation(shifted);
+	EXPECT_EQ(RESULT_OK, polar.setCoordinateSystemType(Field::COORDINATE_SYSTEM_TYPE_CYLINDRICAL_POLAR));
+	const Field derivedFields[] =
+	{
+		constant,
+		shifted,
+		zinc.fm.createFieldIdentity(coordinates),
+		component,
+		zinc.fm.createFieldConcatenate(3, concatenateSourceFields),
+		zinc.fm.createFieldMultiply(coordinates, constant),
+		zinc.fm.createFieldDivide(constant, shifted),
+		zinc.fm.createFieldPower(shifted, coordinates),
+		zinc.fm.createFieldLog(shifted),
+		zinc.fm.createFieldSqrt(shifted),
+		zinc.fm.createFieldExp(coordinates),
+		zinc.fm.createFieldAbs(zinc.fm.createFieldSubtract(coordinates, constant)),
+		polar,
+		zinc.fm.createFieldDotProduct(coordinates, shifted)
+	};
+	for (const Field& derivedField : derivedFields)
+	{
+		EXPECT_TRUE(derivedField.isValid());
+		const int componentsCount = derivedField.getNumberOfComponents();
+		std::vector<double> derivedValues(pointsCount*componentsCount);
+		std::vector<double> expectedValues(componentsCount);
+		EXPECT_EQ(RESULT_OK, derivedField.evaluateRealMeshLocations(fieldcache, element1, pointsCount, pointsCount*3, xi,
+			pointsCount*componentsCount, derivedValues.data()));
+		// cache is left at last location
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache, 3, values));
+		EXPECT_NEAR(xi[(pointsCount - 1)*3], values[0], TOL);
+		EXPECT_NEAR(xi[(pointsCount - 1)*3 + 1], values[1], TOL);
+		EXPECT_NEAR(xi[(pointsCount - 1)*3 + 2], values[2], TOL);
+		for (int p = 0; p < pointsCount; ++p)
+		{
+			EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(element1, 3, xi + p*3));
+			EXPECT_EQ(RESULT_OK, derivedField.evaluateReal(fieldcache, componentsCount, expectedValues.data()));
+			for (int c = 0; c < componentsCount; ++c)
+				EXPECT_DOUBLE_EQ(expectedValues[c], derivedValues[p*componentsCount + c]);
+		}
+	}
+
+	// zero points is OK
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateRealMeshLocations(fieldcache, element1, 0, 0, nullptr, 0, nullptr));
+	// invalid arguments
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.evaluateRealMeshLocations(Fieldcache(), element1, pointsCount, pointsCount*3, xi, pointsCount*3, values));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.evaluateRealMeshLocations(fieldcache, Element(), pointsCount, pointsCount*3, xi, pointsCount*3, values));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.evaluateRealMeshLocations(fieldcache, element1, -1, pointsCount*3, xi, pointsCount*3, values));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.evaluateRealMeshLocations(fieldcache, element1, pointsCount, pointsCount*3 - 1, xi, pointsCount*3, values));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.evaluateRealMeshLocations(fieldcache, element1, pointsCount, pointsCount*3, nullptr, pointsCount*3, values));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.evaluateRealMeshLocations(fieldcache, element1, pointsCount, pointsCount*3, xi, pointsCount*3 - 1, values));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.evaluateRealMeshLocations(fieldcache, element1, pointsCount, pointsCount*3, xi, pointsCount*3, nullptr));
+
+	double nodeValues[8*3];
+	double nodeMagnitudes[8];
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateRealNodeset(fieldcache, nodes, 8*3, nodeValues));
+	EXPECT_EQ(RESULT_OK, magnitude.evaluateRealNodeset(fieldcache, nodes, 8, nodeMagnitudes));
+	Nodeiterator nodeiterator = nodes.createNodeiterator();
+	Node node;
+	int n = 0;
+	double expectedValues[3];
+	while ((node = nodeiterator.next()).isValid())
+	{
+		EXPECT_EQ(RESULT_OK, fieldcache.setNode(node));
+		EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache, 3, expectedValues));
+		EXPECT_DOUBLE_EQ(expectedValues[0], nodeValues[n*3]);
+		EXPECT_DOUBLE_EQ(expectedValues[1], nodeValues[n*3 + 1]);
+		EXPECT_DOUBLE_EQ(expectedValues[2], nodeValues[n*3 + 2]);
+		EXPECT_EQ(RESULT_OK, magnitude.evaluateReal(fieldcache, 1, &expectedValue));
+		EXPECT_DOUBLE_EQ(expectedValue, nodeMagnitudes[n]);
+		++n;
+	}
+	EXPECT_EQ(8, n);
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.evaluateRealNodeset(fieldcache, nodes, 8*3 - 1, nodeValues));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.evaluateRealNodeset(fieldcache, Nodeset(), 8*3, nodeValues));
+
+	// nodeset group and field not defined on all nodes
+	FieldGroup group = zinc.fm.createFieldGroup();
+	NodesetGroup nodesetGroup = group.createNodesetGroup(nodes);
+	EXPECT_TRUE(nodesetGroup.isValid());
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateRealNodeset(fieldcache, nodesetGroup, 0, nullptr));
+	EXPECT_EQ(RESULT_OK, nodesetGroup.addNode(nodes.findNodeByIdentifier(3)));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateRealNodeset(fieldcache, nodesetGroup, 3, nodeValues));
+	EXPECT_EQ(RESULT_OK, fieldcache.setNode(nodes.findNodeByIdentifier(3)));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache, 3, expectedValues));
+	EXPECT_DOUBLE_EQ(expectedValues[0], nodeValues[0]);
+	EXPECT_DOUBLE_EQ(expectedValues[1], nodeValues[1]);
+	EXPECT_DOUBLE_EQ(expectedValues[2], nodeValues[2]);
+	Nodetemplate nodetemplate = nodes.createNodetemplate();
+	Node node9 = nodes.createNode(9, nodetemplate);
+	EXPECT_TRUE(node9.isValid());
+	EXPECT_EQ(RESULT_ERROR_GENERAL, coordinates.evaluateRealNodeset(fieldcache, nodes, 9*3, nodeValues));
+}
+
+// Test batches of mesh locations give identical values to evaluating at each
+// location in turn, for batches larger than the indexed locations kept in the
+// field cache, in elements and faces, and only for elements in the field region
+TEST(ZincField, evaluateRealMeshLocationsBatch)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(resourcePath("fieldmodule/two_cubes_hermite_nocross.ex2").c_str()));
+	FieldFiniteElement coordinates = zinc.fm.findFieldByName("coordinates").castFiniteElement();
+	EXPECT_TRUE(coordinates.isValid());
+	Field magnitude = zinc.fm.createFieldMagnitude(coordinates);
+	EXPECT_TRUE(magnitude.isValid());
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	Fieldcache fieldcache2 = zinc.fm.createFieldcache();
+
+	const int pointsCount = 600;
+	std::vector<double> xi(pointsCount*3);
+	std::vector<double> values(pointsCount*3), magnitudes(pointsCount);
+	double expectedValues[3];
+	for (int dimension = 3; dimension >= 2; --dimension)
+	{
+		// chart coordinates are packed with element dimension values per point
+		for (int p = 0; p < pointsCount; ++p)
+		{
+			xi[p*dimension] = static_cast<double>(p % 10)/9.0;
+			xi[p*dimension + 1] = static_cast<double>((p/10) % 6)/5.0;
+			if (dimension == 3)
+				xi[p*dimension + 2] = static_cast<double>(p/60)/9.0;
+		}
+		Mesh mesh = zinc.fm.findMeshByDimension(dimension);
+		Elementiterator iter = mesh.createElementiterator();
+		Element element;
+		while ((element = iter.next()).isValid())
+		{
+			EXPECT_EQ(RESULT_OK, coordinates.evaluateRealMeshLocations(fieldcache, element,
+				pointsCount, pointsCount*dimension, xi.data(), pointsCount*3, values.data()));
+			EXPECT_EQ(RESULT_OK, magnitude.evaluateRealMeshLocations(fieldcache, element,
+				pointsCount, pointsCount*dimension, xi.data(), pointsCount, magnitudes.data()));
+			for (int p = 0; p < pointsCount; ++p)
+			{
+				EXPECT_EQ(RESULT_OK, fieldcache2.setMeshLocation(element, dimension, xi.data() + p*dimension));
+				EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache2, 3, expectedValues));
+				EXPECT_EQ(expectedValues[0], values[p*3]);
+				EXPECT_EQ(expectedValues[1], values[p*3 + 1]);
+				EXPECT_EQ(expectedValues[2], values[p*3 + 2]);
+				EXPECT_EQ(RESULT_OK, magnitude.evaluateReal(fieldcache2, 1, expectedValues));
+				EXPECT_EQ(expectedValues[0], magnitudes[p]);
+			}
+			// cache is left at last location
+			EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache, 3, expectedValues));
+			EXPECT_EQ(expectedValues[0], values[(pointsCount - 1)*3]);
+			EXPECT_EQ(expectedValues[1], values[(pointsCount - 1)*3 + 1]);
+			EXPECT_EQ(expectedValues[2], values[(pointsCount - 1)*3 + 2]);
+		}
+	}
+
+	// values are updated after node parameters change
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	Element element1 = mesh3d.findElementByIdentifier(1);
+	const double xiCentre[3] = { 0.5, 0.5, 0.5 };
+	double oldValues[3], newValues[3];
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateRealMeshLocations(fieldcache, element1, 1, 3, xiCentre, 3, oldValues));
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	EXPECT_EQ(RESULT_OK, fieldcache2.setNode(nodes.findNodeByIdentifier(1)));
+	const double newX[3] = { -0.1, -0.2, -0.3 };
+	EXPECT_EQ(RESULT_OK, coordinates.setNodeParameters(fieldcache2, -1, Node::VALUE_LABEL_VALUE, 1, 3, newX));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateRealMeshLocations(fieldcache, element1, 1, 3, xiCentre, 3, newValues));
+	EXPECT_EQ(RESULT_OK, fieldcache2.setMeshLocation(element1, 3, xiCentre));
+	EXPECT_EQ(RESULT_OK, coordinates.evaluateReal(fieldcache2, 3, expectedValues));
+	for (int c = 0; c < 3; ++c)
+	{
+		EXPECT_NE(oldValues[c], newValues[c]);
+		EXPECT_EQ(expectedValues[c], newValues[c]);
+	}
+
+	// element must be from the field's region
+	Region childRegion = zinc.root_region.createChild("child");
+	EXPECT_EQ(RESULT_OK, childRegion.readFile(resourcePath("fieldmodule/cube.exformat").c_str()));
+	Element childElement1 = childRegion.getFieldmodule().findMeshByDimension(3).findElementByIdentifier(1);
+	EXPECT_TRUE(childElement1.isValid());
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.evaluateRealMeshLocations(fieldcache, childElement1,
+		pointsCount, pointsCount*3, xi.data(), pointsCount*3, values.data()));
+	EXPECT_EQ(RESULT_ERROR_ARGUMENT, coordinates.evaluateRealMeshLocations(fieldcache, childElement1,
+		0, 0, nullptr, 0, nullptr));
+}
+
 // Find mesh location was caching wrong xi for modified field between begin/end change
 // Also, convergence was difficult for far away points with high curvature elements.
 // This test loads a curved heart surface mesh and finds nearest xi to 4 quite distant points.
@@ -1839,6 +2155,140 @@ TEST(ZincFieldFindMeshLocation, find_nearest_3d)
 	}
 }
 
+// Test find mesh location on a larger grid of elements for which the
+// hierarchy of element ranges is used, including after element destruction
+TEST(ZincFieldFindMeshLocation, grid_ranges_tree)
+{
+	ZincTestSetupCpp zinc;
+
+	FieldFiniteElement coordinates = zinc.fm.createFieldFiniteElement(3);
+	EXPECT_TRUE(coordinates.isValid());
+	EXPECT_EQ(RESULT_OK, coordinates.setName("coordinates"));
+	EXPECT_EQ(RESULT_OK, coordinates.setTypeCoordinate(true));
+	EXPECT_EQ(RESULT_OK, coordinates.setManaged(true));
+
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	EXPECT_TRUE(nodes.isValid());
+	Nodetemplate nodetemplate = nodes.createNodetemplate();
+	EXPECT_TRUE(nodetemplate.isValid());
+	EXPECT_EQ(RESULT_OK, nodetemplate.defineField(coordinates));
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	EXPECT_TRUE(mesh3d.isValid());
+	Elementbasis trilinearBasis = zinc.fm.createElementbasis(3, Elementbasis::FUNCTION_TYPE_LINEAR_LAGRANGE);
+	EXPECT_TRUE(trilinearBasis.isValid());
+	Elementfieldtemplate eft = mesh3d.createElementfieldtemplate(trilinearBasis);
+	EXPECT_TRUE(eft.isValid());
+	Elementtemplate elementtemplate = mesh3d.createElementtemplate();
+	EXPECT_TRUE(elementtemplate.isValid());
+	EXPECT_EQ(RESULT_OK, elementtemplate.setElementShapeType(Element::SHAPE_TYPE_CUBE));
+	EXPECT_EQ(RESULT_OK, elementtemplate.defineField(coordinates, -1, eft));
+
+	const int nx = 8, ny = 7, nz = 6;
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	EXPECT_TRUE(fieldcache.isValid());
+	zinc.fm.beginChange();
+	for (int k = 0; k <= nz; ++k)
+		for (int j = 0; j <= ny; ++j)
+			for (int i = 0; i <= nx; ++i)
+			{
+				Node node = nodes.createNode(1 + i + j*(nx + 1) + k*(nx + 1)*(ny + 1), nodetemplate);
+				EXPECT_TRUE(node.isValid());
+				EXPECT_EQ(RESULT_OK, fieldcache.setNode(node));
+				const double x[3] = { static_cast<double>(i), static_cast<double>(j), static_cast<double>(k) };
+				EXPECT_EQ(RESULT_OK, coordinates.assignReal(fieldcache, 3, x));
+			}
+	int nodeIdentifiers[8];
+	for (int k = 0; k < nz; ++k)
+		for (int j = 0; j < ny; ++j)
+			for (int i = 0; i < nx; ++i)
+			{
+				Element element = mesh3d.createElement(1 + i + j*nx + k*nx*ny, elementtemplate);
+				EXPECT_TRUE(element.isValid());
+				for (int n = 0; n < 8; ++n)
+				{
+					nodeIdentifiers[n] = 1 + (i + n % 2) + (j + n % 4 / 2)*(nx + 1) + (k + n / 4)*(nx + 1)*(ny + 1);
+				}
+				EXPECT_EQ(RESULT_OK, element.setNodesByIdentifier(eft, 8, nodeIdentifiers));
+			}
+	zinc.fm.endChange();
+	EXPECT_EQ(nx*ny*nz, mesh3d.getSize());
+
+	const double zeroValues[3] = { 0.0, 0.0, 0.0 };
+	FieldConstant findCoordinates = zinc.fm.createFieldConstant(3, zeroValues);
+	EXPECT_TRUE(findCoordinates.isValid());
+	FieldFindMeshLocation findMeshLocationExact = zinc.fm.createFieldFindMeshLocation(findCoordinates, coordinates, mesh3d);
+	EXPECT_TRUE(findMeshLocationExact.isValid());
+	FieldFindMeshLocation findMeshLocationNearest = zinc.fm.createFieldFindMeshLocation(findCoordinates, coordinates, mesh3d);
+	EXPECT_TRUE(findMeshLocationNearest.isValid());
+	EXPECT_EQ(RESULT_OK, findMeshLocationNearest.setSearchMode(FieldFindMeshLocation::SEARCH_MODE_NEAREST));
+
+	// nearest in group of lower half of elements in x
+	FieldGroup group = zinc.fm.createFieldGroup();
+	EXPECT_TRUE(group.isValid());
+	MeshGroup meshGroup = group.createMeshGroup(mesh3d);
+	EXPECT_TRUE(meshGroup.isValid());
+	for (int k = 0; k < nz; ++k)
+		for (int j = 0; j < ny; ++j)
+			for (int i = 0; i < nx / 2; ++i)
+			{
+				EXPECT_EQ(RESULT_OK, meshGroup.addElement(mesh3d.findElementByIdentifier(1 + i + j*nx + k*nx*ny)));
+			}
+	FieldFindMeshLocation findMeshLocationGroupNearest = zinc.fm.createFieldFindMeshLocation(findCoordinates, coordinates, mesh3d);
+	EXPECT_TRUE(findMeshLocationGroupNearest.isValid());
+	EXPECT_EQ(RESULT_OK, findMeshLocationGroupNearest.setSearchMesh(meshGroup));
+	EXPECT_EQ(RESULT_OK, findMeshLocationGroupNearest.setSearchMode(FieldFindMeshLocation::SEARCH_MODE_NEAREST));
+
+	const double TOL = 1.0E-6;
+	double xi[3];
+	for (int k = 0; k < nz; ++k)
+		for (int j = 0; j < ny; ++j)
+			for (int i = 0; i < nx; ++i)
+			{
+				const double x[3] = { i + 0.3, j + 0.6, k + 0.2 };
+				EXPECT_EQ(RESULT_OK, findCoordinates.assignReal(fieldcache, 3, x));
+				Element element = findMeshLocationExact.evaluateMeshLocation(fieldcache, 3, xi);
+				EXPECT_EQ(1 + i + j*nx + k*nx*ny, element.getIdentifier());
+				EXPECT_NEAR(0.3, xi[0], TOL);
+				EXPECT_NEAR(0.6, xi[1], TOL);
+				EXPECT_NEAR(0.2, xi[2], TOL);
+				element = findMeshLocationGroupNearest.evaluateMeshLocation(fieldcache, 3, xi);
+				const int gi = (i < nx / 2) ? i : nx / 2 - 1;
+				EXPECT_EQ(1 + gi + j*nx + k*nx*ny, element.getIdentifier());
+				EXPECT_NEAR((i < nx / 2) ? 0.3 : 1.0, xi[0], TOL);
+				EXPECT_NEAR(0.6, xi[1], TOL);
+				EXPECT_NEAR(0.2, xi[2], TOL);
+			}
+
+	// outside mesh: no exact location, nearest is on boundary
+	const double xOutside[3] = { -1.0, 2.5, 3.5 };
+	EXPECT_EQ(RESULT_OK, findCoordinates.assignReal(fieldcache, 3, xOutside));
+	Element element = findMeshLocationExact.evaluateMeshLocation(fieldcache, 3, xi);
+	EXPECT_FALSE(element.isValid());
+	element = findMeshLocationNearest.evaluateMeshLocation(fieldcache, 3, xi);
+	EXPECT_EQ(1 + 2*nx + 3*nx*ny, element.getIdentifier());
+	EXPECT_NEAR(0.0, xi[0], TOL);
+	EXPECT_NEAR(0.5, xi[1], TOL);
+	EXPECT_NEAR(0.5, xi[2], TOL);
+
+	// destroyed elements must not be found
+	const int destroyIdentifier = 1 + 5 + 4*nx + 3*nx*ny;
+	EXPECT_EQ(RESULT_OK, mesh3d.destroyElement(mesh3d.findElementByIdentifier(destroyIdentifier)));
+	const double xDestroyed[3] = { 5.5, 4.5, 3.5 };
+	EXPECT_EQ(RESULT_OK, findCoordinates.assignReal(fieldcache, 3, xDestroyed));
+	element = findMeshLocationExact.evaluateMeshLocation(fieldcache, 3, xi);
+	EXPECT_FALSE(element.isValid());
+	element = findMeshLocationNearest.evaluateMeshLocation(fieldcache, 3, xi);
+	EXPECT_TRUE(element.isValid());
+	EXPECT_NE(destroyIdentifier, element.getIdentifier());
+	const double xOther[3] = { 6.25, 4.5, 3.75 };
+	EXPECT_EQ(RESULT_OK, findCoordinates.assignReal(fieldcache, 3, xOther));
+	element = findMeshLocationExact.evaluateMeshLocation(fieldcache, 3, xi);
+	EXPECT_EQ(destroyIdentifier + 1, element.getIdentifier());
+	EXPECT_NEAR(0.25, xi[0], TOL);
+	EXPECT_NEAR(0.5, xi[1], TOL);
+	EXPECT_NEAR(0.75, xi[2], TOL);
+}
+
 struct FindXiMap
 {
 	double x[3];
@@ -2940,3 +3390,90 @@ TEST(ZincFieldFindMeshLocation, SearchModeEnum)
 	const char *enumNames[3] = { nullptr, "EXACT", "NEAREST" };
 	testEnum(3, enumNames, FieldFindMeshLocation::SearchModeEnumToString, FieldFindMeshLocation::SearchModeEnumFromString);
 }
+
+// Test define faces on a grid of elements larger than the batch of elements
+// whose faces are defined together, so faces and lines are shared between batches
+TEST(ZincFieldFiniteElement, defineAllFacesGrid)
+{
+	ZincTestSetupCpp zinc;
+
+	FieldFiniteElement coordinates = zinc.fm.createFieldFiniteElement(3);
+	EXPECT_TRUE(coordinates.isValid());
+	EXPECT_EQ(RESULT_OK, coordinates.setName("coordinates"));
+	EXPECT_EQ(RESULT_OK, coordinates.setTypeCoordinate(true));
+	EXPECT_EQ(RESULT_OK, coordinates.setManaged(true));
+
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	EXPECT_TRUE(nodes.isValid());
+	Nodetemplate nodetemplate = nodes.createNodetemplate();
+	EXPECT_TRUE(nodetemplate.isValid());
+	EXPECT_EQ(RESULT_OK, nodetemplate.defineField(coordinates));
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	EXPECT_TRUE(mesh3d.isValid());
+	Elementbasis trilinearBasis = zinc.fm.createElementbasis(3, Elementbasis::FUNCTION_TYPE_LINEAR_LAGRANGE);
+	EXPECT_TRUE(trilinearBasis.isValid());
+	Elementfieldtemplate eft = mesh3d.createElementfieldtemplate(trilinearBasis);
+	EXPECT_TRUE(eft.isValid());
+	Elementtemplate elementtemplate = mesh3d.createElementtemplate();
+	EXPECT_TRUE(elementtemplate.isValid());
+	EXPECT_EQ(RESULT_OK, elementtemplate.setElementShapeType(Element::SHAPE_TYPE_CUBE));
+	EXPECT_EQ(RESULT_OK, elementtemplate.defineField(coordinates, -1, eft));
+
+	const int nx = 30, ny = 24, nz = 24;
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	EXPECT_TRUE(fieldcache.isValid());
+	zinc.fm.beginChange();
+	for (int k = 0; k <= nz; ++k)
+		for (int j = 0; j <= ny; ++j)
+			for (int i = 0; i <= nx; ++i)
+			{
+				Node node = nodes.createNode(1 + i + j*(nx + 1) + k*(nx + 1)*(ny + 1), nodetemplate);
+				EXPECT_TRUE(node.isValid());
+				EXPECT_EQ(RESULT_OK, fieldcache.setNode(node));
+				const double x[3] = { static_cast<double>(i), static_cast<double>(j), static_cast<double>(k) };
+				EXPECT_EQ(RESULT_OK, coordinates.assignReal(fieldcache, 3, x));
+			}
+	int nodeIdentifiers[8];
+	for (int k = 0; k < nz; ++k)
+		for (int j = 0; j < ny; ++j)
+			for (int i = 0; i < nx; ++i)
+			{
+				Element element = mesh3d.createElement(1 + i + j*nx + k*nx*ny, elementtemplate);
+				EXPECT_TRUE(element.isValid());
+				for (int n = 0; n < 8; ++n)
+				{
+					nodeIdentifiers[n] = 1 + (i + n % 2) + (j + n % 4 / 2)*(nx + 1) + (k + n / 4)*(nx + 1)*(ny + 1);
+				}
+				EXPECT_EQ(RESULT_OK, element.setNodesByIdentifier(eft, 8, nodeIdentifiers));
+			}
+	zinc.fm.endChange();
+	EXPECT_EQ(nx*ny*nz, mesh3d.getSize());
+
+	EXPECT_EQ(RESULT_OK, zinc.fm.defineAllFaces());
+	Mesh mesh2d = zinc.fm.findMeshByDimension(2);
+	EXPECT_TRUE(mesh2d.isValid());
+	Mesh mesh1d = zinc.fm.findMeshByDimension(1);
+	EXPECT_TRUE(mesh1d.isValid());
+	const int facesCount = (nx + 1)*ny*nz + nx*(ny + 1)*nz + nx*ny*(nz + 1);
+	const int linesCount = nx*(ny + 1)*(nz + 1) + (nx + 1)*ny*(nz + 1) + (nx + 1)*(ny + 1)*nz;
+	EXPECT_EQ(facesCount, mesh2d.getSize());
+	EXPECT_EQ(linesCount, mesh1d.getSize());
+	// new faces and lines are numbered from 1 without gaps
+	EXPECT_TRUE(mesh2d.findElementByIdentifier(facesCount).isValid());
+	EXPECT_TRUE(mesh1d.findElementByIdentifier(linesCount).isValid());
+
+	// faces are not duplicated by defining them again
+	EXPECT_EQ(RESULT_OK, zinc.fm.defineAllFaces());
+	EXPECT_EQ(facesCount, mesh2d.getSize());
+	EXPECT_EQ(linesCount, mesh1d.getSize());
+
+	// exterior faces are only on one element
+	FieldIsExterior isExterior = zinc.fm.createFieldIsExterior();
+	EXPECT_TRUE(isExterior.isValid());
+	FieldGroup group = zinc.fm.createFieldGroup();
+	EXPECT_TRUE(group.isValid());
+	MeshGroup exteriorFaces = group.createMeshGroup(mesh2d);
+	EXPECT_TRUE(exteriorFaces.isValid());
+	EXPECT_EQ(RESULT_OK, exteriorFaces.addElementsConditional(isExterior));
+	EXPECT_EQ(2*(nx*ny + ny*nz + nz*nx), exteriorFaces.getSize());
+}
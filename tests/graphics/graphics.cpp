@@ -917,6 +917,12 @@ TEST(cmzn_graphics_api, point_attributes_glyph_cpp)
 	EXPECT_EQ(OK, pointattr.setGlyphRepeatMode(Glyph::REPEAT_MODE_MIRROR));
 	EXPECT_EQ(Glyph::REPEAT_MODE_MIRROR, pointattr.getGlyphRepeatMode());
 
+	EXPECT_FALSE(pointattr.isRenderInstanced());
+	EXPECT_EQ(OK, pointattr.setRenderInstanced(true));
+	EXPECT_TRUE(pointattr.isRenderInstanced());
+	EXPECT_EQ(OK, pointattr.setRenderInstanced(false));
+	EXPECT_FALSE(pointattr.isRenderInstanced());
+
 	double fieldValues[] = { 0.3, 0.4, 0.5 };
 	Field field = zinc.fm.createFieldConstant(sizeof(fieldValues)/sizeof(double), fieldValues);
 	EXPECT_TRUE(field.isValid());
@@ -1162,6 +1168,7 @@ void check_point_description(const Scene& scene, const Field& labelField)
 	EXPECT_DOUBLE_EQ(0.6, outputGlyphOffset[2]);
 
 	EXPECT_EQ(Glyph::REPEAT_MODE_AXES_2D, pointattr.getGlyphRepeatMode());
+	EXPECT_TRUE(pointattr.isRenderInstanced());
 
 	EXPECT_EQ(labelField, pointattr.getLabelField());
 
@@ -0,0 +1,166 @@
+/*
+ * Zinc Library Unit Tests
+ *
+ * Headless rendering tests, only built with ZINC_USE_OSMESA.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <GL/osmesa.h>
+
+#include <cmlibs/zinc/status.h>
+#include <cmlibs/zinc/field.hpp>
+#include <cmlibs/zinc/glyph.hpp>
+#include <cmlibs/zinc/graphics.hpp>
+#include <cmlibs/zinc/region.hpp>
+#include <cmlibs/zinc/scene.hpp>
+#include <cmlibs/zinc/sceneviewer.hpp>
+#include <cmlibs/zinc/spectrum.hpp>
+
+#include "zinctestsetupcpp.hpp"
+
+#include "test_resources.h"
+
+namespace {
+
+/** Off-screen OSMesa RGBA render target made current for its lifetime. */
+class OSMesaRenderTarget
+{
+	OSMesaContext context;
+	int width, height;
+	std::vector<unsigned char> pixels;
+
+public:
+	/** Create context of at least the given OpenGL version, with compatibility
+	 * profile for Zinc's fixed function rendering. */
+	OSMesaRenderTarget(int widthIn, int heightIn, int majorVersion, int minorVersion) :
+		context(nullptr),
+		width(widthIn),
+		height(heightIn),
+		pixels(static_cast<size_t>(widthIn)*heightIn*4, 0)
+	{
+		const int attributes[] = {
+			OSMESA_FORMAT, OSMESA_RGBA,
+			OSMESA_DEPTH_BITS, 24,
+			OSMESA_PROFILE, OSMESA_COMPAT_PROFILE,
+			OSMESA_CONTEXT_MAJOR_VERSION, majorVersion,
+			OSMESA_CONTEXT_MINOR_VERSION, minorVersion,
+			0 };
+		this->context = OSMesaCreateContextAttribs(attributes, nullptr);
+		if ((this->context) && (!OSMesaMakeCurrent(this->context, this->pixels.data(),
+			GL_UNSIGNED_BYTE, this->width, this->height)))
+		{
+			OSMesaDestroyContext(this->context);
+			this->context = nullptr;
+		}
+	}
+
+	~OSMesaRenderTarget()
+	{
+		if (this->context)
+			OSMesaDestroyContext(this->context);
+	}
+
+	bool isValid() const
+	{
+		return nullptr != this->context;
+	}
+
+	/** Render scene viewer and get copy of pixels. */
+	std::vector<unsigned char> render(Sceneviewer& sceneviewer)
+	{
+		EXPECT_EQ(RESULT_OK, sceneviewer.renderScene());
+		glFinish();
+		return this->pixels;
+	}
+};
+
+/** @return  Number of pixels which have any RGBA component differing by more
+ * than tolerance. */
+int countDifferentPixels(const std::vector<unsigned char>& pixels1,
+	const std::vector<unsigned char>& pixels2, int tolerance)
+{
+	int count = 0;
+	for (size_t i = 0; i < pixels1.size(); i += 4)
+		for (size_t c = 0; c < 4; ++c)
+			if (std::abs(static_cast<int>(pixels1[i + c]) - static_cast<int>(pixels2[i + c])) > tolerance)
+			{
+				++count;
+				break;
+			}
+	return count;
+}
+
+/** @return  Number of pixels not equal to the first pixel, assumed background. */
+int countForegroundPixels(const std::vector<unsigned char>& pixels)
+{
+	int count = 0;
+	for (size_t i = 4; i < pixels.size(); i += 4)
+		if (0 != memcmp(pixels.data(), pixels.data() + i, 4))
+			++count;
+	return count;
+}
+
+}
+
+// Test glyphs drawn instanced with the glyph instance shader look the same as
+// glyphs drawn one at a time, with material and spectrum colours
+TEST(ZincSceneviewer, renderGlyphsInstancedOSMesa)
+{
+	const int width = 160, height = 120;
+	// instanced path needs OpenGL 3.3
+	OSMesaRenderTarget target(width, height, 3, 3);
+	if (!target.isValid())
+		GTEST_SKIP() << "OSMesa OpenGL 3.3 compatibility context not available";
+
+	ZincTestSetupCpp zinc;
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(resourcePath("fieldmodule/cube.exformat").c_str()));
+	Field coordinateField = zinc.fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinateField.isValid());
+
+	GraphicsPoints points = zinc.scene.createGraphicsPoints();
+	EXPECT_TRUE(points.isValid());
+	EXPECT_EQ(RESULT_OK, points.setCoordinateField(coordinateField));
+	EXPECT_EQ(RESULT_OK, points.setFieldDomainType(Field::DOMAIN_TYPE_NODES));
+	Graphicspointattributes pointAttr = points.getGraphicspointattributes();
+	EXPECT_TRUE(pointAttr.isValid());
+	EXPECT_EQ(RESULT_OK, pointAttr.setGlyphShapeType(Glyph::SHAPE_TYPE_SPHERE));
+	// non-uniform size so normals must be transformed correctly
+	const double baseSize[3] = { 0.2, 0.3, 0.4 };
+	EXPECT_EQ(RESULT_OK, pointAttr.setBaseSize(3, baseSize));
+
+	Sceneviewer sceneviewer = zinc.context.getSceneviewermodule().createSceneviewer(
+		Sceneviewer::BUFFERING_MODE_SINGLE, Sceneviewer::STEREO_MODE_MONO);
+	EXPECT_TRUE(sceneviewer.isValid());
+	EXPECT_EQ(RESULT_OK, sceneviewer.setScene(zinc.scene));
+	EXPECT_EQ(RESULT_OK, sceneviewer.setViewportSize(width, height));
+	EXPECT_EQ(RESULT_OK, sceneviewer.viewAll());
+
+	// pixels rounded differently by per-vertex shader lighting
+	const int tolerance = 4;
+	const int maximumDifferentPixels = width*height/100;
+	for (int colouring = 0; colouring < 2; ++colouring)
+	{
+		if (colouring == 1)
+		{
+			// instance colours from spectrum
+			EXPECT_EQ(RESULT_OK, points.setDataField(coordinateField));
+			EXPECT_EQ(RESULT_OK, points.setSpectrum(zinc.context.getSpectrummodule().getDefaultSpectrum()));
+		}
+		EXPECT_EQ(RESULT_OK, pointAttr.setRenderInstanced(false));
+		const std::vector<unsigned char> pixels = target.render(sceneviewer);
+		EXPECT_GT(countForegroundPixels(pixels), width*height/50);
+
+		EXPECT_EQ(RESULT_OK, pointAttr.setRenderInstanced(true));
+		const std::vector<unsigned char> instancedPixels = target.render(sceneviewer);
+		EXPECT_LE(countDifferentPixels(pixels, instancedPixels, tolerance), maximumDifferentPixels);
+	}
+}
@@ -8,6 +8,12 @@
 
 #include <gtest/gtest.h>
 
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include <cmlibs/zinc/status.h>
 #include <cmlibs/zinc/core.h>
 #include <cmlibs/zinc/fieldarithmeticoperators.h>
@@ -27,18 +33,28 @@
 #include <cmlibs/zinc/fieldcomposite.hpp>
 #include <cmlibs/zinc/fieldconstant.hpp>
 #include <cmlibs/zinc/fieldfiniteelement.hpp>
+#include <cmlibs/zinc/fieldgroup.hpp>
 #include <cmlibs/zinc/fieldimage.hpp>
 #include <cmlibs/zinc/fieldtime.hpp>
 #include <cmlibs/zinc/streamimage.hpp>
 #include <cmlibs/zinc/fieldvectoroperators.hpp>
+#include <cmlibs/zinc/elementbasis.hpp>
+#include <cmlibs/zinc/elementfieldtemplate.hpp>
+#include <cmlibs/zinc/element.hpp>
+#include <cmlibs/zinc/elementtemplate.hpp>
 #include <cmlibs/zinc/graphics.hpp>
 #include <cmlibs/zinc/material.hpp>
+#include <cmlibs/zinc/mesh.hpp>
+#include <cmlibs/zinc/node.hpp>
+#include <cmlibs/zinc/nodeset.hpp>
+#include <cmlibs/zinc/nodetemplate.hpp>
 #include <cmlibs/zinc/scene.hpp>
 #include <cmlibs/zinc/types/scenecoordinatesystem.hpp>
 #include <cmlibs/zinc/scenefilter.hpp>
 #include <cmlibs/zinc/sceneviewer.hpp>
 #include <cmlibs/zinc/spectrum.hpp>
 #include <cmlibs/zinc/streamscene.hpp>
+#include <cmlibs/zinc/tessellation.hpp>
 
 #include "test_resources.h"
 #include "utilities/testenum.hpp"
@@ -517,6 +533,76 @@ TEST(cmzn_scene, threejs_export_glyph_cpp)
 
 }
 
+// Test instanced glyph rendering is opt-in and does not change built glyph graphics
+TEST(ZincScene, glyphRenderInstanced)
+{
+    ZincTestSetupCpp zinc;
+
+    EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(resourcePath("fieldmodule/cube.exformat").c_str()));
+    Field coordinateField = zinc.fm.findFieldByName("coordinates");
+    EXPECT_TRUE(coordinateField.isValid());
+
+    GraphicsPoints points = zinc.scene.createGraphicsPoints();
+    EXPECT_TRUE(points.isValid());
+    EXPECT_EQ(RESULT_OK, points.setCoordinateField(coordinateField));
+    EXPECT_EQ(RESULT_OK, points.setFieldDomainType(Field::DOMAIN_TYPE_NODES));
+    Graphicspointattributes pointAttr = points.getGraphicspointattributes();
+    EXPECT_TRUE(pointAttr.isValid());
+    EXPECT_EQ(RESULT_OK, pointAttr.setGlyphShapeType(Glyph::SHAPE_TYPE_SPHERE));
+    const double baseSize[3] = { 0.1, 0.2, 0.3 };
+    EXPECT_EQ(RESULT_OK, pointAttr.setBaseSize(3, baseSize));
+
+    // export glyph vertices and glyph geometry
+    auto exportGlyphs = [&zinc](std::string& vertices, std::string& geometry)
+    {
+        StreaminformationScene si = zinc.scene.createStreaminformationScene();
+        EXPECT_TRUE(si.isValid());
+        EXPECT_EQ(RESULT_OK, si.setIOFormat(si.IO_FORMAT_THREEJS));
+        EXPECT_EQ(3, si.getNumberOfResourcesRequired());
+        StreamresourceMemory memory_sr = si.createStreamresourceMemory();
+        StreamresourceMemory memory_sr2 = si.createStreamresourceMemory();
+        StreamresourceMemory memory_sr3 = si.createStreamresourceMemory();
+        EXPECT_EQ(RESULT_OK, zinc.scene.write(si));
+        const char *memory_buffer = nullptr;
+        unsigned int size = 0;
+        EXPECT_EQ(RESULT_OK, memory_sr2.getBuffer((const void**)&memory_buffer, &size));
+        vertices.assign(memory_buffer, size);
+        EXPECT_EQ(RESULT_OK, memory_sr3.getBuffer((const void**)&memory_buffer, &size));
+        geometry.assign(memory_buffer, size);
+    };
+
+    EXPECT_FALSE(pointAttr.isRenderInstanced());
+    std::string vertices, geometry;
+    exportGlyphs(vertices, geometry);
+    EXPECT_NE(std::string::npos, vertices.find("axis1"));
+    EXPECT_NE(std::string::npos, geometry.find("faces"));
+
+    EXPECT_EQ(RESULT_OK, pointAttr.setRenderInstanced(true));
+    EXPECT_TRUE(pointAttr.isRenderInstanced());
+    EXPECT_EQ(RESULT_OK, pointAttr.setRenderInstanced(true));
+    EXPECT_TRUE(pointAttr.isRenderInstanced());
+    std::string instancedVertices, instancedGeometry;
+    exportGlyphs(instancedVertices, instancedGeometry);
+    EXPECT_EQ(vertices, instancedVertices);
+    EXPECT_EQ(geometry, instancedGeometry);
+
+    // setting is copied with graphics description
+    char *description = zinc.scene.writeDescription();
+    EXPECT_NE(nullptr, description);
+    EXPECT_EQ(RESULT_OK, zinc.scene.removeAllGraphics());
+    EXPECT_EQ(RESULT_OK, zinc.scene.readDescription(description, true));
+    cmzn_deallocate(description);
+    Graphics graphics = zinc.scene.getFirstGraphics();
+    EXPECT_TRUE(graphics.isValid());
+    EXPECT_TRUE(graphics.getGraphicspointattributes().isRenderInstanced());
+
+    EXPECT_EQ(RESULT_OK, graphics.getGraphicspointattributes().setRenderInstanced(false));
+    EXPECT_FALSE(graphics.getGraphicspointattributes().isRenderInstanced());
+    exportGlyphs(instancedVertices, instancedGeometry);
+    EXPECT_EQ(vertices, instancedVertices);
+    EXPECT_EQ(geometry, instancedGeometry);
+}
+
 TEST(cmzn_scene, threejs_export_point_cpp)
 {
     ZincTestSetupCpp zinc;
@@ -1763,3 +1849,629 @@ TEST(cmzn_scene, wavefront_export_text)
     temp_char = strstr(memory_buffer, "f 21 22 23");
     EXPECT_NE(static_cast<char *>(0), temp_char);
 }
+
+namespace {
+
+uint32_t readUint32LittleEndian(const unsigned char *bytes)
+{
+    return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+        (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+/* Export scene to binary glTF, check chunk structure and return JSON chunk */
+std::string exportSceneGltfBinaryJson(Scene& scene, bool quantised)
+{
+    StreaminformationScene si = scene.createStreaminformationScene();
+    EXPECT_EQ(CMZN_OK, si.setIOFormat(si.IO_FORMAT_GLTF_BINARY));
+    EXPECT_EQ(1, si.getNumberOfResourcesRequired());
+    EXPECT_EQ(0, si.getOutputIsQuantised());
+    EXPECT_EQ(CMZN_OK, si.setOutputIsQuantised(quantised ? 1 : 0));
+    EXPECT_EQ(quantised ? 1 : 0, si.getOutputIsQuantised());
+    StreamresourceMemory memory_sr = si.createStreamresourceMemory();
+    EXPECT_EQ(CMZN_OK, scene.write(si));
+    const unsigned char *buffer = nullptr;
+    unsigned int size = 0;
+    EXPECT_EQ(CMZN_OK, memory_sr.getBuffer((const void**)&buffer, &size));
+    if ((!buffer) || (size < 20))
+    {
+        ADD_FAILURE() << "GLB output too small";
+        return std::string();
+    }
+    EXPECT_EQ(0, memcmp(buffer, "glTF", 4));
+    EXPECT_EQ(2u, readUint32LittleEndian(buffer + 4));
+    EXPECT_EQ(size, readUint32LittleEndian(buffer + 8));
+    const uint32_t jsonLength = readUint32LittleEndian(buffer + 12);
+    EXPECT_EQ(0u, jsonLength % 4);
+    EXPECT_EQ(0, memcmp(buffer + 16, "JSON", 4));
+    EXPECT_LE(20 + jsonLength, size);
+    const std::string json(reinterpret_cast<const char *>(buffer + 20), jsonLength);
+    if (20 + jsonLength < size)
+    {
+        const unsigned char *binaryChunk = buffer + 20 + jsonLength;
+        const uint32_t binaryLength = readUint32LittleEndian(binaryChunk);
+        EXPECT_EQ(0, memcmp(binaryChunk + 4, "BIN\0", 4));
+        EXPECT_EQ(size, 20 + jsonLength + 8 + binaryLength);
+        char byteLengthString[50];
+        sprintf(byteLengthString, "\"byteLength\":%u}]", binaryLength);
+        EXPECT_NE(std::string::npos, json.find(byteLengthString));
+    }
+    return json;
+}
+
+}
+
+TEST(cmzn_scene, gltf_binary_export)
+{
+    ZincTestSetupCpp zinc;
+
+    EXPECT_EQ(CMZN_OK, zinc.root_region.readFile(resourcePath("fieldmodule/cube.exformat").c_str()));
+    Field coordinateField = zinc.fm.findFieldByName("coordinates");
+    EXPECT_TRUE(coordinateField.isValid());
+
+    // empty scene gives valid GLB without binary chunk
+    std::string json = exportSceneGltfBinaryJson(zinc.scene, false);
+    EXPECT_NE(std::string::npos, json.find("\"version\":\"2.0\""));
+    EXPECT_EQ(std::string::npos, json.find("\"meshes\""));
+    EXPECT_EQ(std::string::npos, json.find("\"buffers\""));
+
+    zinc.scene.beginChange();
+    GraphicsSurfaces surfaces = zinc.scene.createGraphicsSurfaces();
+    EXPECT_EQ(CMZN_OK, surfaces.setCoordinateField(coordinateField));
+    GraphicsLines lines = zinc.scene.createGraphicsLines();
+    EXPECT_EQ(CMZN_OK, lines.setCoordinateField(coordinateField));
+    GraphicsPoints points = zinc.scene.createGraphicsPoints();
+    EXPECT_EQ(CMZN_OK, points.setFieldDomainType(Field::DOMAIN_TYPE_NODES));
+    EXPECT_EQ(CMZN_OK, points.setCoordinateField(coordinateField));
+    Graphicspointattributes pointattr = points.getGraphicspointattributes();
+    EXPECT_EQ(CMZN_OK, pointattr.setGlyphShapeType(Glyph::SHAPE_TYPE_POINT));
+    zinc.scene.endChange();
+
+    json = exportSceneGltfBinaryJson(zinc.scene, false);
+    EXPECT_NE(std::string::npos, json.find("\"mode\":4"));
+    EXPECT_NE(std::string::npos, json.find("\"mode\":1"));
+    EXPECT_NE(std::string::npos, json.find("\"mode\":0"));
+    EXPECT_NE(std::string::npos, json.find("\"POSITION\""));
+    EXPECT_NE(std::string::npos, json.find("\"NORMAL\""));
+    EXPECT_NE(std::string::npos, json.find("\"indices\""));
+    // cube positions are between 0 and 1
+    EXPECT_NE(std::string::npos, json.find("\"max\":[1,1,1]"));
+    EXPECT_NE(std::string::npos, json.find("\"min\":[0,0,0]"));
+    EXPECT_EQ(std::string::npos, json.find("KHR_mesh_quantization"));
+
+    json = exportSceneGltfBinaryJson(zinc.scene, true);
+    EXPECT_NE(std::string::npos, json.find("\"extensionsRequired\":[\"KHR_mesh_quantization\"]"));
+    EXPECT_NE(std::string::npos, json.find("\"componentType\":5122"));
+    EXPECT_NE(std::string::npos, json.find("\"translation\":[0.5,0.5,0.5]"));
+    EXPECT_NE(std::string::npos, json.find("\"scale\":[0.5,0.5,0.5]"));
+}
+
+namespace {
+
+// build lines, surfaces, contours and points graphics on cube and export as
+// threejs, returning all resources concatenated
+/* Export scene to threejs memory resources and return their concatenation.
+ * If sceneviewer is valid, levels of detail drawn in its view are exported. */
+std::string exportSceneThreejs(Scene& scene, int minimumResourcesCount,
+    const Sceneviewer& sceneviewer = Sceneviewer())
+{
+    StreaminformationScene si = scene.createStreaminformationScene();
+    EXPECT_EQ(CMZN_OK, si.setIOFormat(si.IO_FORMAT_THREEJS));
+    if (sceneviewer.isValid())
+    {
+        EXPECT_EQ(CMZN_OK, si.setSceneviewer(sceneviewer));
+        EXPECT_EQ(sceneviewer.getId(), si.getSceneviewer().getId());
+    }
+    const int resourcesCount = si.getNumberOfResourcesRequired();
+    EXPECT_LE(minimumResourcesCount, resourcesCount);
+    std::vector<StreamresourceMemory> resources;
+    for (int r = 0; r < resourcesCount; ++r)
+        resources.push_back(si.createStreamresourceMemory());
+    EXPECT_EQ(CMZN_OK, scene.write(si));
+    std::string output;
+    for (int r = 0; r < resourcesCount; ++r)
+    {
+        const char *buffer = nullptr;
+        unsigned int size = 0;
+        EXPECT_EQ(CMZN_OK, resources[r].getBuffer((const void**)&buffer, &size));
+        output.append(buffer, size);
+    }
+    return output;
+}
+
+std::string buildAndExportCubeGraphics(int buildThreadsCount)
+{
+    ZincTestSetupCpp zinc;
+
+    EXPECT_EQ(CMZN_OK, zinc.root_region.readFile(resourcePath("fieldmodule/cube.exformat").c_str()));
+    Field coordinateField = zinc.fm.findFieldByName("coordinates");
+    EXPECT_TRUE(coordinateField.isValid());
+    Field x = zinc.fm.createFieldComponent(coordinateField, 1);
+    EXPECT_TRUE(x.isValid());
+
+    EXPECT_EQ(1, zinc.scene.getBuildThreadsCount());
+    EXPECT_EQ(CMZN_OK, zinc.scene.setBuildThreadsCount(buildThreadsCount));
+    EXPECT_EQ(buildThreadsCount, zinc.scene.getBuildThreadsCount());
+
+    zinc.scene.beginChange();
+    GraphicsLines lines = zinc.scene.createGraphicsLines();
+    EXPECT_EQ(CMZN_OK, lines.setCoordinateField(coordinateField));
+    EXPECT_EQ(CMZN_OK, lines.setDataField(x));
+    GraphicsSurfaces surfaces = zinc.scene.createGraphicsSurfaces();
+    EXPECT_EQ(CMZN_OK, surfaces.setCoordinateField(coordinateField));
+    GraphicsContours contours = zinc.scene.createGraphicsContours();
+    EXPECT_EQ(CMZN_OK, contours.setCoordinateField(coordinateField));
+    EXPECT_EQ(CMZN_OK, contours.setIsoscalarField(x));
+    EXPECT_EQ(CMZN_OK, contours.setRangeIsovalues(3, 0.25, 0.75));
+    GraphicsPoints points = zinc.scene.createGraphicsPoints();
+    EXPECT_EQ(CMZN_OK, points.setFieldDomainType(Field::DOMAIN_TYPE_NODES));
+    EXPECT_EQ(CMZN_OK, points.setCoordinateField(coordinateField));
+    zinc.scene.endChange();
+
+    return exportSceneThreejs(zinc.scene, 4);
+}
+
+/* Create lines and surfaces on a grid of 2D elements large enough for
+ * elements of each graphics to be converted in several chunks. Optionally
+ * use cylindrical polar coordinates so elements are curved and refined, and
+ * an adaptive tessellation which also builds coarser levels of detail. */
+void createGridGraphics(ZincTestSetupCpp& zinc, int buildThreadsCount,
+    bool cylindricalPolar, double pixelErrorTolerance)
+{
+    const int elementsCount1 = 24;
+    const int elementsCount2 = 20;
+
+    FieldFiniteElement coordinates = zinc.fm.createFieldFiniteElement(3);
+    EXPECT_EQ(CMZN_OK, coordinates.setName("coordinates"));
+    EXPECT_EQ(CMZN_OK, coordinates.setTypeCoordinate(true));
+    if (cylindricalPolar)
+        EXPECT_EQ(CMZN_OK, coordinates.setCoordinateSystemType(Field::COORDINATE_SYSTEM_TYPE_CYLINDRICAL_POLAR));
+    Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+    Nodetemplate nodetemplate = nodes.createNodetemplate();
+    EXPECT_EQ(CMZN_OK, nodetemplate.defineField(coordinates));
+    Mesh mesh = zinc.fm.findMeshByDimension(2);
+    Elementtemplate elementtemplate = mesh.createElementtemplate();
+    EXPECT_EQ(CMZN_OK, elementtemplate.setElementShapeType(Element::SHAPE_TYPE_SQUARE));
+    Elementbasis bilinearBasis = zinc.fm.createElementbasis(2, Elementbasis::FUNCTION_TYPE_LINEAR_LAGRANGE);
+    Elementfieldtemplate eft = mesh.createElementfieldtemplate(bilinearBasis);
+    EXPECT_EQ(CMZN_OK, elementtemplate.defineField(coordinates, -1, eft));
+
+    zinc.fm.beginChange();
+    Fieldcache cache = zinc.fm.createFieldcache();
+    for (int j = 0; j <= elementsCount2; ++j)
+        for (int i = 0; i <= elementsCount1; ++i)
+        {
+            Node node = nodes.createNode(-1, nodetemplate);
+            EXPECT_EQ(CMZN_OK, cache.setNode(node));
+            const double x[3] = { 0.1*i, 0.1*j, 0.01*i*j };
+            EXPECT_EQ(CMZN_OK, coordinates.assignReal(cache, 3, x));
+        }
+    for (int j = 0; j < elementsCount2; ++j)
+        for (int i = 0; i < elementsCount1; ++i)
+        {
+            const int node1 = j*(elementsCount1 + 1) + i + 1;
+            const int nodeIdentifiers[4] = { node1, node1 + 1, node1 + elementsCount1 + 1, node1 + elementsCount1 + 2 };
+            Element element = mesh.createElement(-1, elementtemplate);
+            EXPECT_EQ(CMZN_OK, element.setNodesByIdentifier(eft, 4, nodeIdentifiers));
+        }
+    EXPECT_EQ(CMZN_OK, zinc.fm.defineAllFaces());
+    zinc.fm.endChange();
+    EXPECT_EQ(elementsCount1*elementsCount2, mesh.getSize());
+
+    Tessellation tessellation = zinc.context.getTessellationmodule().getDefaultTessellation();
+    EXPECT_EQ(CMZN_OK, tessellation.setPixelErrorTolerance(pixelErrorTolerance));
+    EXPECT_EQ(CMZN_OK, zinc.scene.setBuildThreadsCount(buildThreadsCount));
+    zinc.scene.beginChange();
+    GraphicsLines lines = zinc.scene.createGraphicsLines();
+    EXPECT_EQ(CMZN_OK, lines.setCoordinateField(coordinates));
+    GraphicsSurfaces surfaces = zinc.scene.createGraphicsSurfaces();
+    EXPECT_EQ(CMZN_OK, surfaces.setCoordinateField(coordinates));
+    EXPECT_EQ(CMZN_OK, surfaces.setDataField(coordinates));
+    zinc.scene.endChange();
+}
+
+/* Build grid graphics as for createGridGraphics and export them */
+std::string buildAndExportGridGraphics(int buildThreadsCount,
+    bool cylindricalPolar = false, double pixelErrorTolerance = 0.0)
+{
+    ZincTestSetupCpp zinc;
+    createGridGraphics(zinc, buildThreadsCount, cylindricalPolar, pixelErrorTolerance);
+    return exportSceneThreejs(zinc.scene, 2);
+}
+
+/* Create a block of trilinear 3D elements large enough to be converted in
+ * several chunks. Faces are not defined. */
+Field createBlockModel(Fieldmodule& fm, int elementsCount)
+{
+    FieldFiniteElement coordinates = fm.createFieldFiniteElement(3);
+    EXPECT_EQ(CMZN_OK, coordinates.setName("coordinates"));
+    EXPECT_EQ(CMZN_OK, coordinates.setTypeCoordinate(true));
+    Nodeset nodes = fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+    Nodetemplate nodetemplate = nodes.createNodetemplate();
+    EXPECT_EQ(CMZN_OK, nodetemplate.defineField(coordinates));
+    Mesh mesh = fm.findMeshByDimension(3);
+    Elementtemplate elementtemplate = mesh.createElementtemplate();
+    EXPECT_EQ(CMZN_OK, elementtemplate.setElementShapeType(Element::SHAPE_TYPE_CUBE));
+    Elementbasis trilinearBasis = fm.createElementbasis(3, Elementbasis::FUNCTION_TYPE_LINEAR_LAGRANGE);
+    Elementfieldtemplate eft = mesh.createElementfieldtemplate(trilinearBasis);
+    EXPECT_EQ(CMZN_OK, elementtemplate.defineField(coordinates, -1, eft));
+
+    fm.beginChange();
+    Fieldcache cache = fm.createFieldcache();
+    for (int k = 0; k <= elementsCount; ++k)
+        for (int j = 0; j <= elementsCount; ++j)
+            for (int i = 0; i <= elementsCount; ++i)
+            {
+                Node node = nodes.createNode(-1, nodetemplate);
+                EXPECT_EQ(CMZN_OK, cache.setNode(node));
+                const double x[3] = { 0.1*i, 0.1*j, 0.1*k };
+                EXPECT_EQ(CMZN_OK, coordinates.assignReal(cache, 3, x));
+            }
+    const int nodesCount1 = elementsCount + 1;
+    for (int k = 0; k < elementsCount; ++k)
+        for (int j = 0; j < elementsCount; ++j)
+            for (int i = 0; i < elementsCount; ++i)
+            {
+                const int node1 = (k*nodesCount1 + j)*nodesCount1 + i + 1;
+                const int node5 = node1 + nodesCount1*nodesCount1;
+                const int nodeIdentifiers[8] = { node1, node1 + 1, node1 + nodesCount1, node1 + nodesCount1 + 1,
+                    node5, node5 + 1, node5 + nodesCount1, node5 + nodesCount1 + 1 };
+                Element element = mesh.createElement(-1, elementtemplate);
+                EXPECT_EQ(CMZN_OK, element.setNodesByIdentifier(eft, 8, nodeIdentifiers));
+            }
+    fm.endChange();
+    EXPECT_EQ(elementsCount*elementsCount*elementsCount, mesh.getSize());
+    return coordinates;
+}
+
+/* Build iso-surface contours of distance from the origin on a block of 3D
+ * elements large enough to be converted in several chunks, optionally
+ * welding vertices across elements. */
+std::string buildAndExportBlockContours(int buildThreadsCount, bool weldVertices)
+{
+    ZincTestSetupCpp zinc;
+    Field coordinates = createBlockModel(zinc.fm, 7);
+    Field magnitude = zinc.fm.createFieldMagnitude(coordinates);
+    EXPECT_EQ(CMZN_OK, zinc.scene.setBuildThreadsCount(buildThreadsCount));
+    zinc.scene.beginChange();
+    GraphicsContours contours = zinc.scene.createGraphicsContours();
+    EXPECT_EQ(CMZN_OK, contours.setCoordinateField(coordinates));
+    EXPECT_EQ(CMZN_OK, contours.setIsoscalarField(magnitude));
+    const double isovalues[2] = { 0.25, 0.55 };
+    EXPECT_EQ(CMZN_OK, contours.setListIsovalues(2, isovalues));
+    EXPECT_EQ(CMZN_OK, contours.setDataField(magnitude));
+    EXPECT_EQ(CMZN_OK, contours.setWeldVertices(weldVertices));
+    zinc.scene.endChange();
+
+    return exportSceneThreejs(zinc.scene, 1);
+}
+
+/* Export scene triangles as ASCII STL and return the number of edges,
+ * identified by the text of their end vertices, not shared by exactly two
+ * triangles. Zero for closed surfaces without cracks. */
+int countOpenEdgesStl(Scene& scene, int& trianglesCount)
+{
+    StreaminformationScene si = scene.createStreaminformationScene();
+    EXPECT_EQ(CMZN_OK, si.setIOFormat(si.IO_FORMAT_ASCII_STL));
+    StreamresourceMemory memory_sr = si.createStreamresourceMemory();
+    EXPECT_EQ(CMZN_OK, scene.write(si));
+    const char *buffer = nullptr;
+    unsigned int size = 0;
+    EXPECT_EQ(CMZN_OK, memory_sr.getBuffer((const void**)&buffer, &size));
+    std::istringstream stl(std::string(buffer, size));
+    std::vector<std::string> vertices;
+    std::string line;
+    while (std::getline(stl, line))
+    {
+        const size_t pos = line.find("vertex ");
+        if (pos != std::string::npos)
+            vertices.push_back(line.substr(pos + 7));
+    }
+    EXPECT_EQ(0u, vertices.size() % 3);
+    trianglesCount = static_cast<int>(vertices.size()/3);
+    std::map<std::pair<std::string, std::string>, int> edgeUseCounts;
+    for (size_t t = 0; (t + 2) < vertices.size(); t += 3)
+        for (int e = 0; e < 3; ++e)
+        {
+            const std::string& v1 = vertices[t + e];
+            const std::string& v2 = vertices[t + (e + 1) % 3];
+            ++edgeUseCounts[(v1 < v2) ? std::make_pair(v1, v2) : std::make_pair(v2, v1)];
+        }
+    int openEdgesCount = 0;
+    for (auto iter = edgeUseCounts.begin(); iter != edgeUseCounts.end(); ++iter)
+        if (iter->second != 2)
+            ++openEdgesCount;
+    return openEdgesCount;
+}
+
+/* Build radial streamlines in both directions from element centres on a
+ * block of 3D elements without faces, so streamlines continue into
+ * neighbouring elements by search. Checks a streamline from the first
+ * element only crosses into further elements. */
+std::string buildAndExportBlockStreamlines(int buildThreadsCount)
+{
+    ZincTestSetupCpp zinc;
+    Field coordinates = createBlockModel(zinc.fm, 7);
+    FieldGroup group = zinc.fm.createFieldGroup();
+    MeshGroup meshGroup = group.createMeshGroup(zinc.fm.findMeshByDimension(3));
+    EXPECT_EQ(CMZN_OK, meshGroup.addElement(meshGroup.getMasterMesh().findElementByIdentifier(1)));
+    EXPECT_EQ(CMZN_OK, zinc.scene.setBuildThreadsCount(buildThreadsCount));
+    zinc.scene.beginChange();
+    GraphicsStreamlines element1Streamlines = zinc.scene.createGraphicsStreamlines();
+    EXPECT_EQ(CMZN_OK, element1Streamlines.setName("element1"));
+    EXPECT_EQ(CMZN_OK, element1Streamlines.setSubgroupField(group));
+    EXPECT_EQ(CMZN_OK, element1Streamlines.setCoordinateField(coordinates));
+    EXPECT_EQ(CMZN_OK, element1Streamlines.setStreamVectorField(coordinates));
+    EXPECT_EQ(CMZN_OK, element1Streamlines.setTrackLength(0.3));
+    GraphicsStreamlines forwardStreamlines = zinc.scene.createGraphicsStreamlines();
+    EXPECT_EQ(CMZN_OK, forwardStreamlines.setCoordinateField(coordinates));
+    EXPECT_EQ(CMZN_OK, forwardStreamlines.setStreamVectorField(coordinates));
+    EXPECT_EQ(CMZN_OK, forwardStreamlines.setTrackLength(0.3));
+    GraphicsStreamlines reverseStreamlines = zinc.scene.createGraphicsStreamlines();
+    EXPECT_EQ(CMZN_OK, reverseStreamlines.setCoordinateField(coordinates));
+    EXPECT_EQ(CMZN_OK, reverseStreamlines.setStreamVectorField(coordinates));
+    EXPECT_EQ(CMZN_OK, reverseStreamlines.setTrackLength(0.3));
+    EXPECT_EQ(CMZN_OK, reverseStreamlines.setTrackDirection(GraphicsStreamlines::TRACK_DIRECTION_REVERSE));
+    zinc.scene.endChange();
+
+    // streamline from centre of element 1 along (1,1,1) ends near 0.05 + 0.3/sqrt(3)
+    // in each direction, beyond element 1 which extends to 0.1
+    Scenefilter element1Filter = zinc.scene.getScenefiltermodule().createScenefilterGraphicsName("element1");
+    double minimums[3], maximums[3];
+    EXPECT_EQ(CMZN_OK, zinc.scene.getCoordinatesRange(element1Filter, minimums, maximums));
+    for (int c = 0; c < 3; ++c)
+    {
+        EXPECT_NEAR(0.05, minimums[c], 1.0E-6);
+        EXPECT_GT(maximums[c], 0.2);
+    }
+
+    return exportSceneThreejs(zinc.scene, 1);
+}
+
+/* Move node 3 and add node 9 to cube, then optionally add a line element
+ * from node 1 to node 9, each in a single change. */
+void changeCubeModel(Fieldmodule& fm, bool addElement)
+{
+    Field coordinates = fm.findFieldByName("coordinates");
+    Nodeset nodes = fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+    Fieldcache cache = fm.createFieldcache();
+    if (!addElement)
+    {
+        fm.beginChange();
+        EXPECT_EQ(CMZN_OK, cache.setNode(nodes.findNodeByIdentifier(3)));
+        const double x3[3] = { -0.1, 1.2, 0.1 };
+        EXPECT_EQ(CMZN_OK, coordinates.assignReal(cache, 3, x3));
+        Nodetemplate nodetemplate = nodes.createNodetemplate();
+        EXPECT_EQ(CMZN_OK, nodetemplate.defineField(coordinates));
+        Node node = nodes.createNode(9, nodetemplate);
+        EXPECT_TRUE(node.isValid());
+        EXPECT_EQ(CMZN_OK, cache.setNode(node));
+        const double x9[3] = { 1.5, 1.5, 1.5 };
+        EXPECT_EQ(CMZN_OK, coordinates.assignReal(cache, 3, x9));
+        fm.endChange();
+    }
+    else
+    {
+        fm.beginChange();
+        Mesh mesh1d = fm.findMeshByDimension(1);
+        Elementtemplate elementtemplate = mesh1d.createElementtemplate();
+        EXPECT_EQ(CMZN_OK, elementtemplate.setElementShapeType(Element::SHAPE_TYPE_LINE));
+        Elementbasis linearBasis = fm.createElementbasis(1, Elementbasis::FUNCTION_TYPE_LINEAR_LAGRANGE);
+        Elementfieldtemplate eft = mesh1d.createElementfieldtemplate(linearBasis);
+        EXPECT_EQ(CMZN_OK, elementtemplate.defineField(coordinates, -1, eft));
+        Element element = mesh1d.createElement(-1, elementtemplate);
+        EXPECT_TRUE(element.isValid());
+        const int nodeIdentifiers[2] = { 1, 9 };
+        EXPECT_EQ(CMZN_OK, element.setNodesByIdentifier(eft, 2, nodeIdentifiers));
+        fm.endChange();
+    }
+}
+
+/* Create arrow glyphs at nodes and lines on all elements of cube */
+void createCubeNodePointsAndLines(Scene& scene, Field& coordinates)
+{
+    scene.beginChange();
+    GraphicsPoints points = scene.createGraphicsPoints();
+    EXPECT_EQ(CMZN_OK, points.setFieldDomainType(Field::DOMAIN_TYPE_NODES));
+    EXPECT_EQ(CMZN_OK, points.setCoordinateField(coordinates));
+    EXPECT_EQ(CMZN_OK, points.getGraphicspointattributes().setGlyphShapeType(Glyph::SHAPE_TYPE_ARROW_SOLID));
+    GraphicsLines lines = scene.createGraphicsLines();
+    EXPECT_EQ(CMZN_OK, lines.setCoordinateField(coordinates));
+    scene.endChange();
+}
+
+/* Build and export with 1 build thread, then check the same output is
+ * exported when built with 4 threads and with the default threads count 0.
+ * Returns the serially built output. */
+std::string expectSameOutputForBuildThreadsCounts(
+    const std::function<std::string(int buildThreadsCount)>& buildAndExport)
+{
+    const std::string serialOutput = buildAndExport(1);
+    EXPECT_FALSE(serialOutput.empty());
+    EXPECT_EQ(serialOutput, buildAndExport(4));
+    EXPECT_EQ(serialOutput, buildAndExport(0));
+    return serialOutput;
+}
+
+}
+
+TEST(ZincScene, buildThreadsCount)
+{
+    ZincTestSetupCpp zinc;
+
+    EXPECT_EQ(1, zinc.scene.getBuildThreadsCount());
+    EXPECT_EQ(CMZN_ERROR_ARGUMENT, zinc.scene.setBuildThreadsCount(-1));
+    EXPECT_EQ(CMZN_OK, zinc.scene.setBuildThreadsCount(0));
+    EXPECT_EQ(0, zinc.scene.getBuildThreadsCount());
+    EXPECT_EQ(-1, cmzn_scene_get_build_threads_count(nullptr));
+    EXPECT_EQ(CMZN_ERROR_ARGUMENT, cmzn_scene_set_build_threads_count(nullptr, 2));
+}
+
+// graphics objects built concurrently must be identical to serially built graphics
+TEST(ZincScene, buildThreadsGraphicsObjects)
+{
+    expectSameOutputForBuildThreadsCounts(buildAndExportCubeGraphics);
+}
+
+// elements of large lines and surfaces are converted in chunks on several
+// threads and must give identical vertex arrays
+TEST(ZincScene, buildThreadsLinesSurfaces)
+{
+    const std::string gridOutput = expectSameOutputForBuildThreadsCounts(
+        [](int buildThreadsCount) { return buildAndExportGridGraphics(buildThreadsCount); });
+
+    // exported graphics are the finest level of detail, which must be the
+    // same with and without coarser levels of detail for adaptive tessellation
+    const std::string curvedGridOutput = expectSameOutputForBuildThreadsCounts(
+        [](int buildThreadsCount) { return buildAndExportGridGraphics(buildThreadsCount, true); });
+    EXPECT_NE(gridOutput, curvedGridOutput);
+    EXPECT_EQ(curvedGridOutput, expectSameOutputForBuildThreadsCounts(
+        [](int buildThreadsCount) { return buildAndExportGridGraphics(buildThreadsCount, true, 1.0); }));
+}
+
+// iso-surfaces converted in chunks must be identical to serially built
+// iso-surfaces, including when welded after merging
+TEST(ZincScene, buildThreadsContours)
+{
+    expectSameOutputForBuildThreadsCounts(
+        [](int buildThreadsCount) { return buildAndExportBlockContours(buildThreadsCount, false); });
+    expectSameOutputForBuildThreadsCounts(
+        [](int buildThreadsCount) { return buildAndExportBlockContours(buildThreadsCount, true); });
+}
+
+// streamlines traced in chunks of seed elements must be identical
+// to serially traced streamlines
+TEST(ZincScene, buildThreadsStreamlines)
+{
+    expectSameOutputForBuildThreadsCounts(buildAndExportBlockStreamlines);
+}
+
+// test coarser levels of detail are selected for the view of a scene viewer
+TEST(ZincScene, levelOfDetailExport)
+{
+    ZincTestSetupCpp zinc;
+    createGridGraphics(zinc, 1, true, 1.0);
+    // finest level of detail is exported without a scene viewer
+    const std::string finestOutput = exportSceneThreejs(zinc.scene, 2);
+    EXPECT_FALSE(finestOutput.empty());
+
+    Sceneviewer sceneviewer = zinc.context.getSceneviewermodule().createSceneviewer(
+        Sceneviewer::BUFFERING_MODE_DOUBLE, Sceneviewer::STEREO_MODE_DEFAULT);
+    EXPECT_TRUE(sceneviewer.isValid());
+    EXPECT_EQ(CMZN_OK, sceneviewer.setScene(zinc.scene));
+    EXPECT_EQ(CMZN_OK, sceneviewer.setViewportSize(512, 512));
+    EXPECT_EQ(CMZN_OK, sceneviewer.viewAll());
+
+    // zooming in by narrowing the view angle selects finer levels until
+    // the finest level is needed for a pixel error under the tolerance
+    const double viewAngles[] = { 2.0, 0.7, 0.05, 0.001 };
+    const int viewAnglesCount = sizeof(viewAngles) / sizeof(double);
+    std::string lastOutput;
+    for (int i = 0; i < viewAnglesCount; ++i)
+    {
+        EXPECT_EQ(CMZN_OK, sceneviewer.setViewAngle(viewAngles[i]));
+        const std::string output = exportSceneThreejs(zinc.scene, 2, sceneviewer);
+        EXPECT_FALSE(output.empty());
+        if (i == 0)
+            EXPECT_LT(output.size(), finestOutput.size());
+        else
+            EXPECT_GE(output.size(), lastOutput.size());
+        lastOutput = output;
+    }
+    EXPECT_EQ(finestOutput, lastOutput);
+
+    // zero pixel error tolerance has no coarser levels of detail
+    Tessellation tessellation = zinc.context.getTessellationmodule().getDefaultTessellation();
+    EXPECT_EQ(CMZN_OK, tessellation.setPixelErrorTolerance(0.0));
+    EXPECT_EQ(CMZN_OK, sceneviewer.setViewAngle(viewAngles[0]));
+    EXPECT_EQ(finestOutput, exportSceneThreejs(zinc.scene, 2, sceneviewer));
+}
+
+// test welding iso-surface vertices is optional and closes cracks between elements
+TEST(ZincScene, contoursWeldVertices)
+{
+    ZincTestSetupCpp zinc;
+    Field coordinates = createBlockModel(zinc.fm, 7);
+    const double centre[3] = { 0.35, 0.35, 0.35 };
+    Field offsetCoordinates = zinc.fm.createFieldSubtract(coordinates, zinc.fm.createFieldConstant(3, centre));
+    Field distance = zinc.fm.createFieldMagnitude(offsetCoordinates);
+    EXPECT_TRUE(distance.isValid());
+    zinc.scene.beginChange();
+    GraphicsContours contours = zinc.scene.createGraphicsContours();
+    EXPECT_EQ(CMZN_OK, contours.setCoordinateField(coordinates));
+    EXPECT_EQ(CMZN_OK, contours.setIsoscalarField(distance));
+    // closed sphere crossing many elements
+    const double isovalue = 0.22;
+    EXPECT_EQ(CMZN_OK, contours.setListIsovalues(1, &isovalue));
+    zinc.scene.endChange();
+
+    EXPECT_FALSE(contours.isWeldVertices());
+    int trianglesCount = 0;
+    countOpenEdgesStl(zinc.scene, trianglesCount);
+    EXPECT_LT(100, trianglesCount);
+
+    EXPECT_EQ(CMZN_OK, contours.setWeldVertices(true));
+    EXPECT_TRUE(contours.isWeldVertices());
+    int weldedTrianglesCount = 0;
+    EXPECT_EQ(0, countOpenEdgesStl(zinc.scene, weldedTrianglesCount));
+    EXPECT_LT(100, weldedTrianglesCount);
+
+    // partial rebuild after changing a node must also be watertight
+    Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+    Fieldcache cache = zinc.fm.createFieldcache();
+    Node node = nodes.findNodeByIdentifier(4*64 + 3*8 + 3 + 1);
+    EXPECT_EQ(CMZN_OK, cache.setNode(node));
+    const double x[3] = { 0.31, 0.29, 0.42 };
+    EXPECT_EQ(CMZN_OK, coordinates.assignReal(cache, 3, x));
+    EXPECT_EQ(0, countOpenEdgesStl(zinc.scene, weldedTrianglesCount));
+
+    // setting is written to and read from scene description
+    char *description = zinc.scene.writeDescription();
+    EXPECT_NE(nullptr, description);
+    EXPECT_NE(nullptr, strstr(description, "\"WeldVertices\" : true"));
+    EXPECT_EQ(CMZN_OK, zinc.scene.removeAllGraphics());
+    EXPECT_EQ(CMZN_OK, zinc.scene.readDescription(description, true));
+    cmzn_deallocate(description);
+    contours = zinc.scene.getFirstGraphics().castContours();
+    EXPECT_TRUE(contours.isValid());
+    EXPECT_TRUE(contours.isWeldVertices());
+}
+
+// test partial rebuilds of node points and lines give the same graphics as a full build
+TEST(ZincScene, partialRebuildAddNodesElements)
+{
+    ZincTestSetupCpp zinc;
+    EXPECT_EQ(CMZN_OK, zinc.root_region.readFile(resourcePath("fieldmodule/cube.exformat").c_str()));
+    Field coordinates = zinc.fm.findFieldByName("coordinates");
+    EXPECT_TRUE(coordinates.isValid());
+    createCubeNodePointsAndLines(zinc.scene, coordinates);
+    const std::string initialOutput = exportSceneThreejs(zinc.scene, 2);
+    EXPECT_FALSE(initialOutput.empty());
+
+    // move and add nodes: points for changed nodes are updated or appended
+    changeCubeModel(zinc.fm, /*addElement*/false);
+    // glTF export first as it must also compact primitives released by the partial rebuild
+    const std::string nodesChangedGltfJson = exportSceneGltfBinaryJson(zinc.scene, false);
+    const std::string nodesChangedOutput = exportSceneThreejs(zinc.scene, 2);
+    EXPECT_NE(initialOutput, nodesChangedOutput);
+    // add element: lines for new element are appended
+    changeCubeModel(zinc.fm, /*addElement*/true);
+    const std::string elementAddedOutput = exportSceneThreejs(zinc.scene, 2);
+    EXPECT_NE(nodesChangedOutput, elementAddedOutput);
+
+    // compare with full builds of the changed models
+    ZincTestSetupCpp zinc2;
+    EXPECT_EQ(CMZN_OK, zinc2.root_region.readFile(resourcePath("fieldmodule/cube.exformat").c_str()));
+    changeCubeModel(zinc2.fm, /*addElement*/false);
+    Field coordinates2 = zinc2.fm.findFieldByName("coordinates");
+    createCubeNodePointsAndLines(zinc2.scene, coordinates2);
+    EXPECT_EQ(nodesChangedGltfJson, exportSceneGltfBinaryJson(zinc2.scene, false));
+    EXPECT_EQ(nodesChangedOutput, exportSceneThreejs(zinc2.scene, 2));
+
+    ZincTestSetupCpp zinc3;
+    EXPECT_EQ(CMZN_OK, zinc3.root_region.readFile(resourcePath("fieldmodule/cube.exformat").c_str()));
+    changeCubeModel(zinc3.fm, /*addElement*/false);
+    changeCubeModel(zinc3.fm, /*addElement*/true);
+    Field coordinates3 = zinc3.fm.findFieldByName("coordinates");
+    createCubeNodePointsAndLines(zinc3.scene, coordinates3);
+    EXPECT_EQ(elementAddedOutput, exportSceneThreejs(zinc3.scene, 2));
+}
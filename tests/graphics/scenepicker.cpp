@@ -22,7 +22,10 @@
 
 #include "zinctestsetup.hpp"
 #include "zinctestsetupcpp.hpp"
+#include "test_resources.h"
 #include "cmlibs/zinc/element.hpp"
+#include "cmlibs/zinc/fieldgroup.hpp"
+#include "cmlibs/zinc/fieldmodule.hpp"
 #include "cmlibs/zinc/graphics.hpp"
 #include "cmlibs/zinc/node.hpp"
 #include "cmlibs/zinc/scenepicker.hpp"
@@ -174,3 +177,115 @@ TEST(cmzn_scenepicker_api, valid_args_cpp)
 	result = scenePicker.addPickedNodesToFieldGroup(fieldGroup);
 	EXPECT_EQ(CMZN_OK, result);
 }
+
+// Test picking without an OpenGL context: surfaces and node points of a cube
+// viewed along -z after viewAll
+TEST(ZincScenepicker, pickCubeWithoutOpenGL)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(CMZN_OK, zinc.root_region.readFile(resourcePath("fieldmodule/cube.exformat").c_str()));
+	Field coordinates = zinc.fm.findFieldByName("coordinates");
+	EXPECT_TRUE(coordinates.isValid());
+
+	zinc.scene.beginChange();
+	GraphicsSurfaces surfaces = zinc.scene.createGraphicsSurfaces();
+	EXPECT_EQ(CMZN_OK, surfaces.setCoordinateField(coordinates));
+	GraphicsPoints points = zinc.scene.createGraphicsPoints();
+	EXPECT_EQ(CMZN_OK, points.setFieldDomainType(Field::DOMAIN_TYPE_NODES));
+	EXPECT_EQ(CMZN_OK, points.setCoordinateField(coordinates));
+	Graphicspointattributes pointattr = points.getGraphicspointattributes();
+	EXPECT_EQ(CMZN_OK, pointattr.setGlyphShapeType(Glyph::SHAPE_TYPE_SPHERE));
+	const double baseSize = 0.1;
+	EXPECT_EQ(CMZN_OK, pointattr.setBaseSize(1, &baseSize));
+	zinc.scene.endChange();
+
+	Sceneviewer sv = zinc.context.getSceneviewermodule().createSceneviewer(
+		Sceneviewer::BUFFERING_MODE_DOUBLE, Sceneviewer::STEREO_MODE_DEFAULT);
+	EXPECT_EQ(CMZN_OK, sv.setScene(zinc.scene));
+	EXPECT_EQ(CMZN_OK, sv.setViewportSize(512, 512));
+	EXPECT_EQ(CMZN_OK, sv.viewAll());
+
+	Scenepicker scenePicker = zinc.scene.createScenepicker();
+	EXPECT_EQ(CMZN_OK, scenePicker.setScene(zinc.scene));
+
+	// centre of window only hits front and back faces of cube
+	EXPECT_EQ(CMZN_OK, scenePicker.setSceneviewerRectangle(sv,
+		SCENECOORDINATESYSTEM_WINDOW_PIXEL_TOP_LEFT, 254.0, 254.0, 258.0, 258.0));
+	Element element = scenePicker.getNearestElement();
+	EXPECT_TRUE(element.isValid());
+	EXPECT_EQ(2, element.getDimension());
+	// face 6 of the cube element is at xi3 = 1 i.e. z = 1, nearest the viewer
+	EXPECT_EQ(6, element.getIdentifier());
+	EXPECT_EQ(surfaces, scenePicker.getNearestElementGraphics());
+	EXPECT_EQ(surfaces, scenePicker.getNearestGraphics());
+	EXPECT_FALSE(scenePicker.getNearestNode().isValid());
+
+	FieldGroup fieldGroup = zinc.fm.createFieldGroup();
+	EXPECT_EQ(CMZN_OK, scenePicker.addPickedElementsToFieldGroup(fieldGroup));
+	MeshGroup faceGroup = fieldGroup.getMeshGroup(zinc.fm.findMeshByDimension(2));
+	EXPECT_TRUE(faceGroup.isValid());
+	EXPECT_EQ(2, faceGroup.getSize());
+	EXPECT_TRUE(faceGroup.containsElement(zinc.fm.findMeshByDimension(2).findElementByIdentifier(5)));
+	EXPECT_TRUE(faceGroup.containsElement(element));
+
+	// whole window hits all nodes
+	EXPECT_EQ(CMZN_OK, scenePicker.setSceneviewerRectangle(sv,
+		SCENECOORDINATESYSTEM_WINDOW_PIXEL_TOP_LEFT, 0.0, 0.0, 512.0, 512.0));
+	Node node = scenePicker.getNearestNode();
+	EXPECT_TRUE(node.isValid());
+	EXPECT_EQ(points, scenePicker.getNearestNodeGraphics());
+	EXPECT_EQ(CMZN_OK, scenePicker.addPickedNodesToFieldGroup(fieldGroup));
+	NodesetGroup nodeGroup = fieldGroup.getNodesetGroup(zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES));
+	EXPECT_TRUE(nodeGroup.isValid());
+	EXPECT_EQ(8, nodeGroup.getSize());
+
+	// filter out points graphics
+	Scenefilter sf = zinc.context.getScenefiltermodule().createScenefilterGraphicsType(Graphics::TYPE_SURFACES);
+	EXPECT_EQ(CMZN_OK, scenePicker.setScenefilter(sf));
+	EXPECT_FALSE(scenePicker.getNearestNode().isValid());
+	EXPECT_EQ(surfaces, scenePicker.getNearestGraphics());
+}
+
+// Test picking glyphs without an OpenGL context hits the glyph shape, not its
+// bounding box: a sphere glyph of diameter 1 at the origin viewed along -z
+TEST(ZincScenepicker, pickGlyphShapeWithoutOpenGL)
+{
+	ZincTestSetupCpp zinc;
+
+	GraphicsPoints points = zinc.scene.createGraphicsPoints();
+	EXPECT_EQ(CMZN_OK, points.setFieldDomainType(Field::DOMAIN_TYPE_POINT));
+	Graphicspointattributes pointattr = points.getGraphicspointattributes();
+	EXPECT_EQ(CMZN_OK, pointattr.setGlyphShapeType(Glyph::SHAPE_TYPE_SPHERE));
+	const double baseSize = 1.0;
+	EXPECT_EQ(CMZN_OK, pointattr.setBaseSize(1, &baseSize));
+
+	Sceneviewer sv = zinc.context.getSceneviewermodule().createSceneviewer(
+		Sceneviewer::BUFFERING_MODE_DOUBLE, Sceneviewer::STEREO_MODE_DEFAULT);
+	EXPECT_EQ(CMZN_OK, sv.setScene(zinc.scene));
+	EXPECT_EQ(CMZN_OK, sv.setViewportSize(512, 512));
+	EXPECT_EQ(CMZN_OK, sv.viewAll());
+
+	Scenepicker scenePicker = zinc.scene.createScenepicker();
+	EXPECT_EQ(CMZN_OK, scenePicker.setScene(zinc.scene));
+
+	// pick 2 pixels either side of window position of world point on z = 0.5 plane
+	const double worldPoints[3][3] =
+	{
+		{ 0.0, 0.0, 0.5 },  // centre of sphere
+		{ 0.3, 0.0, 0.5 },  // inside sphere outline
+		{ 0.45, 0.45, 0.5 }  // inside bounding box, outside sphere outline
+	};
+	const bool expectHit[3] = { true, true, false };
+	double windowPoint[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		EXPECT_EQ(CMZN_OK, sv.transformCoordinates(SCENECOORDINATESYSTEM_WORLD,
+			SCENECOORDINATESYSTEM_WINDOW_PIXEL_TOP_LEFT, zinc.scene, worldPoints[i], windowPoint));
+		EXPECT_EQ(CMZN_OK, scenePicker.setSceneviewerRectangle(sv, SCENECOORDINATESYSTEM_WINDOW_PIXEL_TOP_LEFT,
+			windowPoint[0] - 2.0, windowPoint[1] - 2.0, windowPoint[0] + 2.0, windowPoint[1] + 2.0));
+		EXPECT_EQ(expectHit[i], scenePicker.getNearestGraphics().isValid());
+		if (expectHit[i])
+			EXPECT_EQ(points, scenePicker.getNearestGraphics());
+	}
+}
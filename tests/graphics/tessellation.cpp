@@ -179,6 +179,12 @@ TEST(cmzn_tessellation_api, valid_args)
 	result = cmzn_tessellation_get_circle_divisions(tessellation);
 	EXPECT_EQ(10, result);
 
+	EXPECT_DOUBLE_EQ(0.0, cmzn_tessellation_get_pixel_error_tolerance(tessellation));
+	EXPECT_EQ(CMZN_ERROR_ARGUMENT, cmzn_tessellation_set_pixel_error_tolerance(static_cast<cmzn_tessellation_id>(0), 1.0));
+	EXPECT_EQ(CMZN_ERROR_ARGUMENT, cmzn_tessellation_set_pixel_error_tolerance(tessellation, -0.5));
+	EXPECT_EQ(CMZN_OK, cmzn_tessellation_set_pixel_error_tolerance(tessellation, 1.5));
+	EXPECT_DOUBLE_EQ(1.5, cmzn_tessellation_get_pixel_error_tolerance(tessellation));
+
 	result = cmzn_tessellation_set_managed(tessellation, 1);
 	EXPECT_EQ(CMZN_OK, result);
 
@@ -233,6 +239,11 @@ TEST(cmzn_tessellation_api, valid_args_cpp)
 	result = tessellation.getCircleDivisions();
 	EXPECT_EQ(10, result);
 
+	EXPECT_DOUBLE_EQ(0.0, tessellation.getPixelErrorTolerance());
+	EXPECT_EQ(CMZN_ERROR_ARGUMENT, tessellation.setPixelErrorTolerance(-0.5));
+	EXPECT_EQ(CMZN_OK, tessellation.setPixelErrorTolerance(1.5));
+	EXPECT_DOUBLE_EQ(1.5, tessellation.getPixelErrorTolerance());
+
 	result = tessellation.setManaged(true);
 	EXPECT_EQ(CMZN_OK, result);
 
@@ -313,6 +324,33 @@ TEST(cmzn_tessellation_api, description_io_cpp)
 	cmzn_deallocate(return_string);
 }
 
+TEST(cmzn_tessellation_api, description_io_pixel_error_tolerance)
+{
+	ZincTestSetupCpp zinc;
+
+	Tessellationmodule tm = zinc.context.getTessellationmodule();
+	Tessellation tessellation = tm.createTessellation();
+	EXPECT_EQ(CMZN_OK, tessellation.setName("adaptive"));
+	EXPECT_EQ(CMZN_OK, tessellation.setManaged(true));
+	EXPECT_EQ(CMZN_OK, tessellation.setPixelErrorTolerance(0.75));
+
+	char *description = tm.writeDescription();
+	EXPECT_NE(static_cast<char *>(0), description);
+	EXPECT_NE(static_cast<char *>(0), strstr(description, "PixelErrorTolerance"));
+
+	ZincTestSetupCpp zinc2;
+	Tessellationmodule tm2 = zinc2.context.getTessellationmodule();
+	EXPECT_EQ(CMZN_OK, tm2.readDescription(description));
+	cmzn_deallocate(description);
+	Tessellation tessellation2 = tm2.findTessellationByName("adaptive");
+	EXPECT_TRUE(tessellation2.isValid());
+	EXPECT_DOUBLE_EQ(0.75, tessellation2.getPixelErrorTolerance());
+	// fixed tessellations do not write the tolerance
+	tessellation2 = tm2.findTessellationByName("default");
+	EXPECT_TRUE(tessellation2.isValid());
+	EXPECT_DOUBLE_EQ(0.0, tessellation2.getPixelErrorTolerance());
+}
+
 
 TEST(ZincTessellationiterator, iteration)
 {
@@ -19,3 +19,9 @@ SET(${CURRENT_TEST}_SRC
     ${CURRENT_TEST}/streamlines.cpp
     ${CURRENT_TEST}/tessellation.cpp
     )
+if(ZINC_USE_OSMESA)
+    # headless rendering tests draw into an OSMesa context
+    LIST(APPEND ${CURRENT_TEST}_SRC ${CURRENT_TEST}/render_osmesa.cpp)
+    SET(${CURRENT_TEST}_INCLUDE_DIRS ${OSMesa_INCLUDE_DIRS})
+    SET(${CURRENT_TEST}_LIBS ${OSMesa_LIBRARIES})
+endif()
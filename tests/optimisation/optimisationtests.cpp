@@ -921,3 +921,118 @@ TEST(ZincOptimisation, NewtonConditionalAndFaceIntegral)
         }
     }
 }
+
+// Test NEWTON solution with conditional field excluding some parameters of
+// elements in the solve, which need correct element Hessian row offsets.
+// Objective is quadratic in the parameters, so one iteration reaches the
+// stationary point where its derivative with respect to every free parameter
+// is zero. A negative displacement weight makes the Hessian indefinite so the
+// solver must pivot.
+TEST(ZincOptimisation, NewtonConditionalPartialElementParameters)
+{
+    const double displacementWeights[2] = { 1.0, -0.01 };
+    for (int w = 0; w < 2; ++w)
+    {
+        ZincTestSetupCpp zinc;
+
+        EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(resourcePath("fieldmodule/two_cubes.exformat").c_str()));
+        FieldFiniteElement referenceCoordinates = zinc.fm.findFieldByName("coordinates").castFiniteElement();
+        EXPECT_EQ(RESULT_OK, referenceCoordinates.setName("reference coordinates"));
+        EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(resourcePath("fieldmodule/two_cubes.exformat").c_str()));
+        FieldFiniteElement coordinates = zinc.fm.findFieldByName("coordinates").castFiniteElement();
+        EXPECT_TRUE(coordinates.isValid());
+
+        Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+        Element element1 = mesh3d.findElementByIdentifier(1);
+        EXPECT_TRUE(element1.isValid());
+        Element element2 = mesh3d.findElementByIdentifier(2);
+        EXPECT_TRUE(element2.isValid());
+        Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+        EXPECT_TRUE(nodes.isValid());
+
+        // both elements are in the conditional group, but only the nodes of
+        // element 1 so end nodes 3, 6, 9 and 12 of element 2 are excluded
+        FieldGroup conditional = zinc.fm.createFieldGroup();
+        EXPECT_TRUE(conditional.isValid());
+        MeshGroup conditionalMesh3d = conditional.createMeshGroup(mesh3d);
+        EXPECT_EQ(RESULT_OK, conditional.setSubelementHandlingMode(FieldGroup::SUBELEMENT_HANDLING_MODE_FULL));
+        EXPECT_EQ(RESULT_OK, conditionalMesh3d.addElement(element1));
+        EXPECT_EQ(RESULT_OK, conditional.setSubelementHandlingMode(FieldGroup::SUBELEMENT_HANDLING_MODE_NONE));
+        EXPECT_EQ(RESULT_OK, conditionalMesh3d.addElement(element2));
+
+        const int numberOfPoints = 4;
+        Field displacement = coordinates - referenceCoordinates;
+        FieldGradient strain = zinc.fm.createFieldGradient(displacement, referenceCoordinates);
+        const double targetStrainValues[9] = { 0.2, 0.05, 0.0, 0.0, -0.1, 0.0, 0.1, 0.0, -0.2 };
+        Field deltaStrain = strain - zinc.fm.createFieldConstant(9, targetStrainValues);
+        FieldMeshIntegral strainObjective = zinc.fm.createFieldMeshIntegral(
+            zinc.fm.createFieldDotProduct(deltaStrain, deltaStrain), referenceCoordinates, mesh3d);
+        EXPECT_EQ(RESULT_OK, strainObjective.setNumbersOfPoints(1, &numberOfPoints));
+        EXPECT_TRUE(strainObjective.isValid());
+        FieldMeshIntegral displacementObjective = zinc.fm.createFieldMeshIntegral(
+            zinc.fm.createFieldDotProduct(displacement, displacement), referenceCoordinates, mesh3d);
+        EXPECT_EQ(RESULT_OK, displacementObjective.setNumbersOfPoints(1, &numberOfPoints));
+        EXPECT_TRUE(displacementObjective.isValid());
+        Field weightedDisplacementObjective = displacementObjective*zinc.fm.createFieldConstant(1, &displacementWeights[w]);
+        Field totalObjective = strainObjective + weightedDisplacementObjective;
+
+        Optimisation optimisation = zinc.fm.createOptimisation();
+        EXPECT_TRUE(optimisation.isValid());
+        EXPECT_EQ(OK, optimisation.setMethod(Optimisation::METHOD_NEWTON));
+        EXPECT_EQ(OK, optimisation.addObjectiveField(strainObjective));
+        EXPECT_EQ(OK, optimisation.addObjectiveField(weightedDisplacementObjective));
+        EXPECT_EQ(OK, optimisation.addDependentField(coordinates));
+        EXPECT_EQ(OK, optimisation.setConditionalField(coordinates, conditional));
+        EXPECT_EQ(OK, optimisation.setAttributeInteger(Optimisation::ATTRIBUTE_MAXIMUM_ITERATIONS, 1));
+        EXPECT_EQ(OK, optimisation.optimise());
+
+        Fieldcache fieldcache = zinc.fm.createFieldcache();
+        EXPECT_TRUE(fieldcache.isValid());
+        const Node::ValueLabel valueLabels[4] = { Node::VALUE_LABEL_VALUE, Node::VALUE_LABEL_D_DS1, Node::VALUE_LABEL_D_DS2, Node::VALUE_LABEL_D2_DS1DS2 };
+
+        // check no change to excluded end nodes
+        const int excludedNodeIdentifiers[4] = { 3, 6, 9, 12 };
+        for (int n = 0; n < 4; ++n)
+        {
+            EXPECT_EQ(RESULT_OK, fieldcache.setNode(nodes.findNodeByIdentifier(excludedNodeIdentifiers[n])));
+            for (int v = 0; v < 4; ++v)
+            {
+                double ux[3], dx[3];
+                EXPECT_EQ(RESULT_OK, referenceCoordinates.getNodeParameters(fieldcache, -1, valueLabels[v], 1, 3, ux));
+                EXPECT_EQ(RESULT_OK, coordinates.getNodeParameters(fieldcache, -1, valueLabels[v], 1, 3, dx));
+                for (int c = 0; c < 3; ++c)
+                    EXPECT_DOUBLE_EQ(ux[c], dx[c]);
+            }
+        }
+
+        // check central difference derivative of objective is zero for all free parameters
+        const int freeNodeIdentifiers[8] = { 1, 2, 4, 5, 7, 8, 10, 11 };
+        const double h = 1.0E-3;
+        const double TOL = 1.0E-7;
+        for (int n = 0; n < 8; ++n)
+        {
+            Node node = nodes.findNodeByIdentifier(freeNodeIdentifiers[n]);
+            for (int v = 0; v < 4; ++v)
+            {
+                for (int c = 1; c <= 3; ++c)
+                {
+                    double value;
+                    EXPECT_EQ(RESULT_OK, fieldcache.setNode(node));
+                    EXPECT_EQ(RESULT_OK, coordinates.getNodeParameters(fieldcache, c, valueLabels[v], 1, 1, &value));
+                    double objectiveValues[2];
+                    for (int s = 0; s < 2; ++s)
+                    {
+                        const double perturbedValue = value + ((s == 0) ? h : -h);
+                        EXPECT_EQ(RESULT_OK, fieldcache.setNode(node));
+                        EXPECT_EQ(RESULT_OK, coordinates.setNodeParameters(fieldcache, c, valueLabels[v], 1, 1, &perturbedValue));
+                        fieldcache.clearLocation();
+                        EXPECT_EQ(RESULT_OK, totalObjective.evaluateReal(fieldcache, 1, &objectiveValues[s]));
+                    }
+                    EXPECT_EQ(RESULT_OK, fieldcache.setNode(node));
+                    EXPECT_EQ(RESULT_OK, coordinates.setNodeParameters(fieldcache, c, valueLabels[v], 1, 1, &value));
+                    EXPECT_NEAR(0.0, (objectiveValues[0] - objectiveValues[1])/(2.0*h), TOL);
+                }
+            }
+        }
+    }
+}
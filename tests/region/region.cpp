@@ -6,14 +6,24 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 
 #include "cmlibs/zinc/core.h"
+#include "cmlibs/zinc/element.hpp"
+#include "cmlibs/zinc/fieldcache.hpp"
 #include "cmlibs/zinc/fieldconstant.hpp"
+#include "cmlibs/zinc/fieldvectoroperators.hpp"
+#include "cmlibs/zinc/mesh.hpp"
+#include "cmlibs/zinc/node.hpp"
+#include "cmlibs/zinc/nodeset.hpp"
 
 #include "zinctestsetup.hpp"
 #include "zinctestsetupcpp.hpp"
 
+#include "test_resources.h"
+
 TEST(cmzn_region, build_tree)
 {
 	ZincTestSetup zinc;
@@ -394,3 +404,91 @@ TEST(ZincRegion, HierarchicalChangeManager)
 	}
 	EXPECT_EQ(Field::CHANGE_FLAG_ADD, change = recordChange.lastEvent.getSummaryFieldChangeFlags());
 }
+
+// Test frozen region can be evaluated from multiple threads, each with its own
+// field cache, giving the same results as serial evaluation
+TEST(ZincRegion, frozenConcurrentEvaluation)
+{
+	ZincTestSetupCpp zinc;
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.readFile(resourcePath("fieldmodule/allshapes_quadratic_deformed.exf").c_str()));
+	Field deformed = zinc.fm.findFieldByName("deformed");
+	EXPECT_TRUE(deformed.isValid());
+	Field magnitude = zinc.fm.createFieldMagnitude(deformed);
+	EXPECT_TRUE(magnitude.isValid());
+	Mesh mesh3d = zinc.fm.findMeshByDimension(3);
+	std::vector<Element> elements;
+	Elementiterator elementiterator = mesh3d.createElementiterator();
+	Element element;
+	while ((element = elementiterator.next()).isValid())
+		elements.push_back(element);
+	EXPECT_GT(elements.size(), 0U);
+	// inside all element shapes including simplex
+	const double xi[3] = { 0.2, 0.25, 0.3 };
+	const size_t valuesCount = elements.size()*4;
+
+	std::vector<double> serialValues(valuesCount);
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	for (size_t e = 0; e < elements.size(); ++e)
+	{
+		EXPECT_EQ(RESULT_OK, fieldcache.setMeshLocation(elements[e], 3, xi));
+		EXPECT_EQ(RESULT_OK, deformed.evaluateReal(fieldcache, 3, serialValues.data() + e*4));
+		EXPECT_EQ(RESULT_OK, magnitude.evaluateReal(fieldcache, 1, serialValues.data() + e*4 + 3));
+	}
+
+	EXPECT_FALSE(zinc.root_region.isFrozen());
+	EXPECT_EQ(RESULT_OK, zinc.root_region.setFrozen(true));
+	EXPECT_TRUE(zinc.root_region.isFrozen());
+
+	// modifications are refused while frozen
+	Nodeset nodes = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	Node node = nodes.findNodeByIdentifier(1);
+	EXPECT_TRUE(node.isValid());
+	double x[3];
+	EXPECT_EQ(RESULT_OK, fieldcache.setNode(node));
+	EXPECT_EQ(RESULT_OK, deformed.evaluateReal(fieldcache, 3, x));
+	EXPECT_EQ(RESULT_ERROR_IN_USE, deformed.assignReal(fieldcache, 3, x));
+	Nodetemplate nodetemplate = nodes.createNodetemplate();
+	EXPECT_FALSE(nodes.createNode(-1, nodetemplate).isValid());
+	EXPECT_EQ(RESULT_ERROR_IN_USE, nodes.destroyNode(node));
+	const double one = 1.0;
+	EXPECT_FALSE(zinc.fm.createFieldConstant(1, &one).isValid());
+	EXPECT_EQ(RESULT_ERROR_IN_USE, magnitude.setName("magnitude"));
+	EXPECT_EQ(RESULT_ERROR_IN_USE, magnitude.setManaged(true));
+	EXPECT_FALSE(magnitude.isManaged());
+	EXPECT_EQ(RESULT_ERROR_IN_USE, deformed.setTypeCoordinate(false));
+	EXPECT_TRUE(deformed.isTypeCoordinate());
+
+	const int threadsCount = 4;
+	const int repeatsCount = 10;
+	std::vector<std::vector<double> > threadValues(threadsCount, std::vector<double>(valuesCount));
+	std::vector<int> threadResults(threadsCount, RESULT_OK);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadsCount; ++t)
+		threads.push_back(std::thread([&, t]()
+		{
+			Fieldcache threadFieldcache = zinc.fm.createFieldcache();
+			double *values = threadValues[t].data();
+			for (int r = 0; r < repeatsCount; ++r)
+				for (size_t e = 0; e < elements.size(); ++e)
+				{
+					// start at different elements in each thread
+					const size_t i = (e + t*elements.size()/threadsCount) % elements.size();
+					if ((RESULT_OK != threadFieldcache.setMeshLocation(elements[i], 3, xi)) ||
+						(RESULT_OK != deformed.evaluateReal(threadFieldcache, 3, values + i*4)) ||
+						(RESULT_OK != magnitude.evaluateReal(threadFieldcache, 1, values + i*4 + 3)))
+						threadResults[t] = RESULT_ERROR_GENERAL;
+				}
+		}));
+	for (int t = 0; t < threadsCount; ++t)
+	{
+		threads[t].join();
+		EXPECT_EQ(RESULT_OK, threadResults[t]);
+		for (size_t i = 0; i < valuesCount; ++i)
+			EXPECT_EQ(serialValues[i], threadValues[t][i]);
+	}
+
+	EXPECT_EQ(RESULT_OK, zinc.root_region.setFrozen(false));
+	EXPECT_FALSE(zinc.root_region.isFrozen());
+	EXPECT_EQ(RESULT_OK, deformed.assignReal(fieldcache, 3, x));
+}
@@ -439,6 +439,7 @@ TEST(ZincFieldGroup, add_remove_elements_conditional)
 
 	EXPECT_EQ(ERROR_ARGUMENT, facesMeshGroup.addElementsConditional(Field()));
 	EXPECT_EQ(ERROR_ARGUMENT, facesMeshGroup.removeElementsConditional(Field()));
+	EXPECT_EQ(ERROR_ARGUMENT, facesMeshGroup.retainElementsConditional(Field()));
 
 	MeshGroup linesMeshGroup = group.createMeshGroup(mesh1d);
 	EXPECT_TRUE(linesMeshGroup.isValid());
@@ -502,6 +503,21 @@ TEST(ZincFieldGroup, add_remove_elements_conditional)
 	EXPECT_FALSE(facesMeshGroup.containsElement(face2));
 	EXPECT_FALSE(facesMeshGroup.containsElement(face3));
 
+	// retain intersection with conditional field or group
+	EXPECT_EQ(RESULT_OK, facesMeshGroup.addElementsConditional(trueField));
+	EXPECT_EQ(RESULT_OK, facesMeshGroup.retainElementsConditional(isOnFaceXi1_0));
+	EXPECT_EQ(2, result = facesMeshGroup.getSize());
+	EXPECT_TRUE(facesMeshGroup.containsElement(face1));
+	EXPECT_TRUE(facesMeshGroup.containsElement(face2));
+	EXPECT_EQ(RESULT_OK, facesMeshGroup.retainElementsConditional(otherGroup));
+	EXPECT_EQ(1, result = facesMeshGroup.getSize());
+	EXPECT_TRUE(facesMeshGroup.containsElement(face2));
+	EXPECT_EQ(RESULT_OK, facesMeshGroup.retainElementsConditional(group));
+	EXPECT_EQ(1, result = facesMeshGroup.getSize());
+	FieldGroup emptyGroup = zinc.fm.createFieldGroup();
+	EXPECT_EQ(RESULT_OK, facesMeshGroup.retainElementsConditional(emptyGroup));
+	EXPECT_EQ(0, result = facesMeshGroup.getSize());
+
 	// check not an error to remove nodes already removed
 	EXPECT_EQ(RESULT_OK, facesMeshGroup.removeAllElements());
 	EXPECT_EQ(0, result = facesMeshGroup.getSize());
@@ -529,6 +545,7 @@ TEST(ZincFieldGroup, add_remove_nodes_conditional)
 
 	EXPECT_EQ(ERROR_ARGUMENT, nodesetGroup.addNodesConditional(Field()));
 	EXPECT_EQ(ERROR_ARGUMENT, nodesetGroup.removeNodesConditional(Field()));
+	EXPECT_EQ(ERROR_ARGUMENT, nodesetGroup.retainNodesConditional(Field()));
 
 	Field coordinates = zinc.fm.findFieldByName("coordinates");
 	EXPECT_TRUE(coordinates.isValid());
@@ -605,12 +622,129 @@ TEST(ZincFieldGroup, add_remove_nodes_conditional)
 		EXPECT_TRUE(nodesetGroup.containsNode(nodeset.findNodeByIdentifier(i)));
 	}
 
+	// retain intersection with conditional field or group
+	EXPECT_EQ(RESULT_OK, nodesetGroup.addNodesConditional(trueField));
+	EXPECT_EQ(RESULT_OK, nodesetGroup.retainNodesConditional(x_lt_15));
+	EXPECT_EQ(8, result = nodesetGroup.getSize());
+	EXPECT_EQ(RESULT_OK, nodesetGroup.retainNodesConditional(otherGroup));
+	EXPECT_EQ(4, result = nodesetGroup.getSize());
+	for (int i = 2; i <= 11; i += 3)
+	{
+		EXPECT_TRUE(nodesetGroup.containsNode(nodeset.findNodeByIdentifier(i)));
+	}
+	EXPECT_EQ(RESULT_OK, nodesetGroup.retainNodesConditional(group));
+	EXPECT_EQ(4, result = nodesetGroup.getSize());
+
 	// check not an error to remove nodes already removed
 	EXPECT_EQ(RESULT_OK, nodesetGroup.removeAllNodes());
 	EXPECT_EQ(0, result = nodesetGroup.getSize());
 	EXPECT_EQ(RESULT_OK, nodesetGroup.removeNodesConditional(otherGroup));
 }
 
+// test union, intersection and difference of groups spanning many blocks of indexes
+TEST(ZincFieldGroup, nodeset_group_set_operations)
+{
+	ZincTestSetupCpp zinc;
+	int result;
+
+	const int nodesCount = 5000;
+	Nodeset nodeset = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	Nodetemplate nodetemplate = nodeset.createNodetemplate();
+	FieldGroup evenGroup = zinc.fm.createFieldGroup();
+	NodesetGroup evenNodesetGroup = evenGroup.createNodesetGroup(nodeset);
+	FieldGroup threesGroup = zinc.fm.createFieldGroup();
+	NodesetGroup threesNodesetGroup = threesGroup.createNodesetGroup(nodeset);
+	int evenCount = 0, threesCount = 0, bothCount = 0;
+	zinc.fm.beginChange();
+	for (int id = 1; id <= nodesCount; ++id)
+	{
+		Node node = nodeset.createNode(id, nodetemplate);
+		EXPECT_TRUE(node.isValid());
+		if ((id % 2) == 0)
+		{
+			EXPECT_EQ(RESULT_OK, evenNodesetGroup.addNode(node));
+			++evenCount;
+		}
+		if ((id % 3) == 0)
+		{
+			EXPECT_EQ(RESULT_OK, threesNodesetGroup.addNode(node));
+			++threesCount;
+			if ((id % 2) == 0)
+				++bothCount;
+		}
+	}
+	zinc.fm.endChange();
+	EXPECT_EQ(evenCount, evenNodesetGroup.getSize());
+	EXPECT_EQ(threesCount, threesNodesetGroup.getSize());
+
+	FieldGroup group = zinc.fm.createFieldGroup();
+	NodesetGroup nodesetGroup = group.createNodesetGroup(nodeset);
+	EXPECT_EQ(RESULT_OK, nodesetGroup.addNodesConditional(evenGroup));
+	EXPECT_EQ(evenCount, result = nodesetGroup.getSize());
+	EXPECT_EQ(RESULT_OK, nodesetGroup.addNodesConditional(threesGroup));
+	EXPECT_EQ(evenCount + threesCount - bothCount, result = nodesetGroup.getSize());
+	EXPECT_EQ(RESULT_OK, nodesetGroup.retainNodesConditional(threesGroup));
+	EXPECT_EQ(threesCount, result = nodesetGroup.getSize());
+	EXPECT_EQ(RESULT_OK, nodesetGroup.removeNodesConditional(evenGroup));
+	EXPECT_EQ(threesCount - bothCount, result = nodesetGroup.getSize());
+	for (int id = 1; id <= nodesCount; ++id)
+	{
+		EXPECT_EQ(((id % 3) == 0) && ((id % 2) != 0),
+			nodesetGroup.containsNode(nodeset.findNodeByIdentifier(id)));
+	}
+	EXPECT_EQ(RESULT_OK, nodesetGroup.retainNodesConditional(evenGroup));
+	EXPECT_EQ(0, result = nodesetGroup.getSize());
+}
+
+// test conditional add, remove and retain give the same results on multiple threads
+TEST(ZincFieldGroup, conditional_threads_count)
+{
+	ZincTestSetupCpp zinc;
+	int result;
+
+	const int nodesCount = 5000;
+	FieldFiniteElement x = zinc.fm.createFieldFiniteElement(1);
+	EXPECT_TRUE(x.isValid());
+	Nodeset nodeset = zinc.fm.findNodesetByFieldDomainType(Field::DOMAIN_TYPE_NODES);
+	Nodetemplate nodetemplate = nodeset.createNodetemplate();
+	EXPECT_EQ(RESULT_OK, nodetemplate.defineField(x));
+	Fieldcache fieldcache = zinc.fm.createFieldcache();
+	zinc.fm.beginChange();
+	for (int id = 1; id <= nodesCount; ++id)
+	{
+		Node node = nodeset.createNode(id, nodetemplate);
+		EXPECT_EQ(RESULT_OK, fieldcache.setNode(node));
+		const double xValue = static_cast<double>(id);
+		EXPECT_EQ(RESULT_OK, x.assignReal(fieldcache, 1, &xValue));
+	}
+	zinc.fm.endChange();
+	const double lowValue = 1000.5, highValue = 4000.5;
+	Field x_gt_low = x > zinc.fm.createFieldConstant(1, &lowValue);
+	Field x_lt_high = x < zinc.fm.createFieldConstant(1, &highValue);
+
+	FieldGroup group = zinc.fm.createFieldGroup();
+	EXPECT_EQ(1, group.getConditionalThreadsCount());
+	EXPECT_EQ(ERROR_ARGUMENT, group.setConditionalThreadsCount(-1));
+	EXPECT_EQ(1, group.getConditionalThreadsCount());
+	NodesetGroup nodesetGroup = group.createNodesetGroup(nodeset);
+	const int threadsCounts[3] = { 1, 3, 0 };
+	for (int t = 0; t < 3; ++t)
+	{
+		EXPECT_EQ(RESULT_OK, group.setConditionalThreadsCount(threadsCounts[t]));
+		EXPECT_EQ(threadsCounts[t], group.getConditionalThreadsCount());
+		EXPECT_EQ(RESULT_OK, nodesetGroup.addNodesConditional(x_gt_low));
+		EXPECT_EQ(4000, result = nodesetGroup.getSize());
+		EXPECT_EQ(RESULT_OK, nodesetGroup.retainNodesConditional(x_lt_high));
+		EXPECT_EQ(3000, result = nodesetGroup.getSize());
+		EXPECT_FALSE(nodesetGroup.containsNode(nodeset.findNodeByIdentifier(1000)));
+		EXPECT_TRUE(nodesetGroup.containsNode(nodeset.findNodeByIdentifier(1001)));
+		EXPECT_TRUE(nodesetGroup.containsNode(nodeset.findNodeByIdentifier(4000)));
+		EXPECT_FALSE(nodesetGroup.containsNode(nodeset.findNodeByIdentifier(4001)));
+		EXPECT_EQ(RESULT_OK, nodesetGroup.removeNodesConditional(x_lt_high));
+		EXPECT_EQ(0, result = nodesetGroup.getSize());
+	}
+}
+
 TEST(ZincFieldGroup, subelementHandlingMode)
 {
 	ZincTestSetupCpp zinc;
@@ -763,6 +897,27 @@ TEST(ZincFieldElementGroup, add_remove_with_subelement_handling)
 	EXPECT_EQ(0, result = linesMeshGroup.getSize());
 	EXPECT_EQ(0, result = nodesetGroup.getSize());
 
+	// retain removes subelements only used by removed faces
+	EXPECT_EQ(RESULT_OK, result = facesMeshGroup.addElementsConditional(trueField));
+	EXPECT_EQ(11, size2 = facesMeshGroup.getSize());
+	EXPECT_EQ(RESULT_OK, result = facesMeshGroup.retainElementsConditional(isOnFaceField));
+	EXPECT_EQ(0, size3 = elementsMeshGroup.getSize());
+	EXPECT_EQ(2, size2 = facesMeshGroup.getSize());
+	EXPECT_EQ(7, size1 = linesMeshGroup.getSize());
+	EXPECT_EQ(6, size0 = nodesetGroup.getSize());
+	// retaining with a group containing all faces changes nothing
+	FieldGroup allFacesGroup = zinc.fm.createFieldGroup();
+	MeshGroup allFacesMeshGroup = allFacesGroup.createMeshGroup(mesh2d);
+	EXPECT_EQ(RESULT_OK, result = allFacesMeshGroup.addElementsConditional(trueField));
+	EXPECT_EQ(RESULT_OK, result = facesMeshGroup.retainElementsConditional(allFacesGroup));
+	EXPECT_EQ(2, size2 = facesMeshGroup.getSize());
+	EXPECT_EQ(7, size1 = linesMeshGroup.getSize());
+	EXPECT_EQ(6, size0 = nodesetGroup.getSize());
+	EXPECT_EQ(RESULT_OK, result = facesMeshGroup.removeElementsConditional(group));
+	EXPECT_EQ(0, result = facesMeshGroup.getSize());
+	EXPECT_EQ(0, result = linesMeshGroup.getSize());
+	EXPECT_EQ(0, result = nodesetGroup.getSize());
+
 	// test removal of lines appropriately leaves nodes behind
 	Element line1 = mesh1d.findElementByIdentifier(1);
 	EXPECT_TRUE(line1.isValid());